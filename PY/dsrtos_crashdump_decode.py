@@ -0,0 +1,225 @@
+#!/usr/bin/env python3
+"""
+DSRTOS crash dump decoder
+
+Reads a raw image of the crash dump region written by dsrtos_crashdump_capture()
+(layout in include/phase3/dsrtos_crashdump.h), checks and decompresses every
+record and prints the dumps newest first: panic reason, registers, fault
+status, the faulting task with its stack window, the ready queues and the
+trace events that led up to the crash.
+
+Records with a bad CRC or a stream that does not decompress are skipped; a
+summary goes to stderr.
+
+Usage:
+  dsrtos_crashdump_decode.py REGION.bin [--last N]
+"""
+
+import argparse
+import struct
+import sys
+import zlib
+
+REGION_MAGIC = 0x43445247   # 'CDRG'
+RECORD_MAGIC = 0x43445243   # 'CDRC'
+IMAGE_MAGIC = 0x4344494D    # 'CDIM'
+VERSION = 1
+REGION_HEADER = struct.Struct("<IHHIII")
+RECORD_HEADER = struct.Struct("<IIHHI")
+TEXT_MAX = 32
+NAME_MAX = 16
+EVENT_SWITCH = 1
+
+REASONS = {
+    0x0001: "HARD_FAULT", 0x0002: "MEM_FAULT", 0x0003: "BUS_FAULT",
+    0x0004: "USAGE_FAULT", 0x0005: "NMI", 0x0010: "KERNEL_ERROR",
+    0x0011: "STACK_OVERFLOW", 0x0012: "HEAP_CORRUPTION", 0x0013: "NULL_POINTER",
+    0x0014: "INVALID_STATE", 0x0015: "CRITICAL_SECTION", 0x0020: "TASK_ERROR",
+    0x0021: "TASK_STACK_OVERFLOW", 0x0022: "TASK_DEADLINE_MISS",
+    0x0023: "TASK_INVALID", 0x0030: "RESOURCE_ERROR", 0x0031: "DEADLOCK",
+    0x0032: "PRIORITY_INVERSION", 0x0033: "MUTEX_ERROR", 0x0040: "WATCHDOG",
+    0x0041: "ASSERTION_FAILED", 0x0042: "CORRUPTION", 0x0043: "CONFIGURATION",
+}
+REGS = ["r0", "r1", "r2", "r3", "r4", "r5", "r6", "r7", "r8", "r9", "r10", "r11",
+        "r12", "sp", "lr", "pc", "psr"]
+FAULTS = ["CFSR", "HFSR", "DFSR", "MMFAR", "BFAR", "AFSR"]
+
+
+class DumpError(Exception):
+    pass
+
+
+def lz_decompress(data, limit):
+    """Inverse of dsrtos_lz_compress(), format in include/common/dsrtos_lz.h."""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        token = data[i]
+        i += 1
+        if token < 0x80:
+            count = token + 1
+            if i + count > len(data):
+                raise DumpError("truncated literal run")
+            out += data[i:i + count]
+            i += count
+        else:
+            if i + 2 > len(data):
+                raise DumpError("truncated match")
+            count = token - 0x80 + 4
+            offset = data[i] | (data[i + 1] << 8)
+            i += 2
+            if offset == 0 or offset > len(out):
+                raise DumpError("match before start")
+            for _ in range(count):
+                out.append(out[-offset])
+        if len(out) > limit:
+            raise DumpError("image too long")
+    return bytes(out)
+
+
+def text(raw):
+    return raw.split(b"\x00", 1)[0].decode("ascii", "replace")
+
+
+class Reader:
+    def __init__(self, image):
+        self.image = image
+        self.pos = 0
+
+    def take(self, fmt):
+        s = struct.Struct("<" + fmt)
+        if self.pos + s.size > len(self.image):
+            raise DumpError("short image")
+        values = s.unpack_from(self.image, self.pos)
+        self.pos += s.size
+        return values
+
+
+def parse_image(image):
+    r = Reader(image)
+    magic, version, reason, sequence, tick, cycles, line = r.take("IHHIIII")
+    if magic != IMAGE_MAGIC or version != VERSION:
+        raise DumpError("bad image header")
+    stack_cap, ready_cap, trace_cap = r.take("HBB")
+    message, file = r.take("%us%us" % (TEXT_MAX, TEXT_MAX))
+    dump = {
+        "reason": reason, "sequence": sequence, "tick": tick, "cycles": cycles,
+        "line": line, "message": text(message), "file": text(file),
+        "regs": r.take("17I"), "fault": r.take("6I"),
+    }
+    (dump["msp"], dump["psp"], dump["kernel_state"], dump["critical_nesting"],
+     dump["interrupt_nesting"]) = r.take("5I")
+    dump["task_id"], = r.take("I")
+    dump["task_name"] = text(r.take("%us" % NAME_MAX)[0])
+    (dump["task_priority"], dump["task_state"], dump["stack_base"], dump["stack_size"],
+     dump["stack_pointer"], dump["stack_window"], stack_words) = r.take("7I")
+    stack = r.take("%uI" % stack_cap)
+    dump["stack"] = stack[:min(stack_words, stack_cap)]
+    ready_count, = r.take("I")
+    ready = [r.take("HBB") for _ in range(ready_cap)]
+    dump["ready"] = ready[:min(ready_count, ready_cap)]
+    trace_count, = r.take("I")
+    trace = [r.take("IHHI") for _ in range(trace_cap)]
+    dump["trace"] = trace[:min(trace_count, trace_cap)]
+    if r.pos != len(image):
+        raise DumpError("image size mismatch")
+    return dump
+
+
+def records(region, stats):
+    """Yield (sequence, image) of every valid record in a region image."""
+    if len(region) < REGION_HEADER.size:
+        raise DumpError("region too short")
+    magic, version, header_size, size, _, _ = REGION_HEADER.unpack_from(region, 0)
+    if magic != REGION_MAGIC or version != VERSION or header_size != REGION_HEADER.size:
+        raise DumpError("no crash dump region header")
+    end = min(size, len(region))
+    pos = header_size
+    while pos + RECORD_HEADER.size <= end:
+        magic, sequence, raw_len, comp_len, crc = RECORD_HEADER.unpack_from(region, pos)
+        body = pos + RECORD_HEADER.size
+        if magic != RECORD_MAGIC or body + comp_len > end:
+            pos += 4
+            continue
+        if zlib.crc32(region[pos + 4:pos + 12] + region[body:body + comp_len]) != crc:
+            stats["crc_errors"] += 1
+            pos += 4
+            continue
+        try:
+            image = lz_decompress(region[body:body + comp_len], raw_len)
+            if len(image) != raw_len:
+                raise DumpError("length mismatch")
+            yield sequence, comp_len, image
+        except DumpError:
+            stats["corrupt"] += 1
+        pos = body + ((comp_len + 3) & ~3)
+
+
+def render(dump, comp_len, out):
+    reason = REASONS.get(dump["reason"], "USER_DEFINED" if dump["reason"] >= 0x100 else "?")
+    out.write("=== crash dump #%u: %s (0x%04x), %u bytes compressed\n"
+              % (dump["sequence"], reason, dump["reason"], comp_len))
+    out.write("tick %u, cycles %u, %s:%u \"%s\"\n"
+              % (dump["tick"], dump["cycles"], dump["file"], dump["line"], dump["message"]))
+    for row in range(0, len(REGS), 4):
+        out.write("  " + "  ".join("%-4s %08x" % (REGS[i], dump["regs"][i])
+                                   for i in range(row, min(row + 4, len(REGS)))) + "\n")
+    out.write("  " + "  ".join("%s %08x" % (name, value)
+                               for name, value in zip(FAULTS, dump["fault"])) + "\n")
+    out.write("  msp %08x  psp %08x  kernel state %u  critical %u  interrupt %u\n"
+              % (dump["msp"], dump["psp"], dump["kernel_state"], dump["critical_nesting"],
+                 dump["interrupt_nesting"]))
+    if dump["task_id"] == 0xFFFFFFFF:
+        out.write("task: none\n")
+    else:
+        out.write("task %u \"%s\": priority %u, state %u, stack %08x+%u, saved sp %08x\n"
+                  % (dump["task_id"], dump["task_name"], dump["task_priority"],
+                     dump["task_state"], dump["stack_base"], dump["stack_size"],
+                     dump["stack_pointer"]))
+        for i in range(0, len(dump["stack"]), 4):
+            out.write("  %08x: %s\n" % (dump["stack_window"] + i * 4,
+                                        " ".join("%08x" % w for w in dump["stack"][i:i + 4])))
+    out.write("ready (%u): %s\n" % (len(dump["ready"]), ", ".join(
+        "%u@%u" % (task, priority) for task, priority, _ in dump["ready"]) or "-"))
+    out.write("trace (%u, oldest first):\n" % len(dump["trace"]))
+    last = dump["cycles"]
+    for cycles, event, task, arg in dump["trace"]:
+        name = "switch" if event == EVENT_SWITCH else "event 0x%04x" % event
+        out.write("  %10u cycles before  %-12s task %u  arg %u\n"
+                  % ((last - cycles) & 0xFFFFFFFF, name, task, arg))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode a DSRTOS crash dump region")
+    parser.add_argument("region", help="raw image of the crash dump region")
+    parser.add_argument("--last", type=int, default=None, help="print only the N newest dumps")
+    args = parser.parse_args()
+
+    with open(args.region, "rb") as f:
+        region = f.read()
+
+    stats = {"crc_errors": 0, "corrupt": 0}
+    dumps = []
+    try:
+        for sequence, comp_len, image in records(region, stats):
+            try:
+                dumps.append((sequence, comp_len, parse_image(image)))
+            except DumpError:
+                stats["corrupt"] += 1
+    except DumpError as e:
+        sys.stderr.write("%s\n" % e)
+        return 1
+
+    dumps.sort(key=lambda d: d[0], reverse=True)
+    if args.last is not None:
+        dumps = dumps[:args.last]
+    for _, comp_len, dump in dumps:
+        render(dump, comp_len, sys.stdout)
+
+    sys.stderr.write("%u bytes, %u dumps, %u CRC errors, %u corrupt\n"
+                     % (len(region), len(dumps), stats["crc_errors"], stats["corrupt"]))
+    return 0 if dumps else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
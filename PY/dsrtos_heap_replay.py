@@ -0,0 +1,148 @@
+#!/usr/bin/env python3
+"""
+DSRTOS heap trace replay
+
+Reads a trace exported by dsrtos_memory_trace_export() (header followed by
+alloc/free records, see include/common/dsrtos_memory.h), replays it and
+reports:
+  - leaks: blocks still allocated at the end of the trace, by owner and caller
+  - peak: the point of highest live bytes and who held them at that moment
+  - per-owner totals
+
+Usage:
+  dsrtos_heap_replay.py TRACE.bin [--top N] [--addr2line ELF]
+"""
+
+import argparse
+import struct
+import subprocess
+import sys
+from collections import defaultdict
+
+TRACE_MAGIC = 0x48545243          # 'HTRC'
+TRACE_VERSION = 1
+OP_FREE = 0x80000000
+OWNER_NAMES = {0xFFFFFFFF: "none", 0xFFFFFFFE: "other"}
+
+HEADER = struct.Struct("<IHHIII")  # magic, version, record_size, count, dropped, heap_size
+RECORD = struct.Struct("<IIIII")   # timestamp, caller, offset, owner, size_op
+
+
+def owner_name(owner):
+    return OWNER_NAMES.get(owner, "task %u" % owner)
+
+
+def load(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) < HEADER.size:
+        sys.exit("%s: too short for a trace header" % path)
+    magic, version, record_size, count, dropped, heap_size = HEADER.unpack_from(data, 0)
+    if magic != TRACE_MAGIC:
+        sys.exit("%s: bad magic 0x%08x" % (path, magic))
+    if version != TRACE_VERSION or record_size != RECORD.size:
+        sys.exit("%s: unsupported version %u / record size %u" % (path, version, record_size))
+    if len(data) < HEADER.size + count * RECORD.size:
+        sys.exit("%s: truncated, header claims %u records" % (path, count))
+    records = [RECORD.unpack_from(data, HEADER.size + i * RECORD.size) for i in range(count)]
+    return records, dropped, heap_size
+
+
+def replay(records):
+    live = {}                      # offset -> (owner, size, caller, timestamp)
+    live_bytes = 0
+    peak_bytes = 0
+    peak_snapshot = {}
+    totals = defaultdict(lambda: [0, 0, 0])   # owner -> [allocs, frees, bytes allocated]
+    unmatched_frees = 0
+
+    for timestamp, caller, offset, owner, size_op in records:
+        size = size_op & ~OP_FREE
+        if size_op & OP_FREE:
+            block = live.pop(offset, None)
+            if block is None:
+                # Allocated before the trace window started
+                unmatched_frees += 1
+                continue
+            live_bytes -= block[1]
+            totals[block[0]][1] += 1
+        else:
+            live[offset] = (owner, size, caller, timestamp)
+            live_bytes += size
+            totals[owner][0] += 1
+            totals[owner][2] += size
+            if live_bytes > peak_bytes:
+                peak_bytes = live_bytes
+                peak_snapshot = dict(live)
+
+    return live, peak_bytes, peak_snapshot, totals, unmatched_frees
+
+
+def group(blocks):
+    by_site = defaultdict(lambda: [0, 0])     # (owner, caller) -> [count, bytes]
+    for owner, size, caller, _ in blocks.values():
+        by_site[(owner, caller)][0] += 1
+        by_site[(owner, caller)][1] += size
+    return sorted(by_site.items(), key=lambda kv: kv[1][1], reverse=True)
+
+
+def symbolize(elf, addresses):
+    if elf is None or not addresses:
+        return {}
+    cmd = ["arm-none-eabi-addr2line", "-f", "-C", "-e", elf] + ["0x%x" % a for a in addresses]
+    try:
+        out = subprocess.run(cmd, capture_output=True, text=True, check=True).stdout.splitlines()
+    except (OSError, subprocess.CalledProcessError):
+        return {}
+    return {a: "%s (%s)" % (out[2 * i], out[2 * i + 1]) for i, a in enumerate(addresses)}
+
+
+def print_sites(title, sites, top, symbols):
+    print(title)
+    if not sites:
+        print("  (none)")
+    for (owner, caller), (count, size) in sites[:top]:
+        where = symbols.get(caller, "0x%08x" % caller)
+        print("  %-10s %6u bytes in %4u blocks  from %s" % (owner_name(owner), size, count, where))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Replay a DSRTOS heap allocation trace")
+    parser.add_argument("trace", help="binary trace from dsrtos_memory_trace_export()")
+    parser.add_argument("--top", type=int, default=10, help="sites to list per report")
+    parser.add_argument("--addr2line", metavar="ELF", help="resolve caller addresses against ELF")
+    args = parser.parse_args()
+
+    records, dropped, heap_size = load(args.trace)
+    live, peak_bytes, peak_snapshot, totals, unmatched = replay(records)
+
+    print("%u records, heap %u bytes" % (len(records), heap_size))
+    if dropped:
+        print("warning: %u records were overwritten before export; "
+              "blocks allocated in that window cannot be matched" % dropped)
+    if unmatched:
+        print("note: %u frees of blocks allocated before the trace window" % unmatched)
+
+    leak_sites = group(live)
+    peak_sites = group(peak_snapshot)
+    callers = sorted({caller for (_, caller), _ in leak_sites + peak_sites})
+    symbols = symbolize(args.addr2line, callers)
+
+    print()
+    print_sites("Leaks (%u blocks, %u bytes still allocated):"
+                % (len(live), sum(b[1] for b in live.values())), leak_sites, args.top, symbols)
+    print()
+    print_sites("Peak contributors (%u bytes live at peak):" % peak_bytes,
+                peak_sites, args.top, symbols)
+    print()
+    print("Per owner:")
+    for owner in sorted(totals):
+        allocs, frees, allocated = totals[owner]
+        print("  %-10s %6u allocs %6u frees %8u bytes allocated" %
+              (owner_name(owner), allocs, frees, allocated))
+
+    return 1 if live else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+"""
+DSRTOS telemetry stream decoder
+
+Reads a byte stream produced by dsrtos_telemetry_encode() (COBS frames
+delimited by 0x00, format in include/common/dsrtos_telemetry.h), rebuilds
+the counter vector after every frame and prints the time series as CSV:
+one row per applied frame, one column per counter.
+
+Frames with a bad CRC, another schema, or a delta frame that follows a
+sequence gap are skipped until the next keyframe; a summary goes to stderr.
+
+Usage:
+  dsrtos_telemetry_decode.py STREAM.bin [--schema ID] [--names a,b,c] [--changed-only]
+"""
+
+import argparse
+import sys
+
+VERSION = 1
+FLAG_KEY = 0x80
+VERSION_MASK = 0x0F
+
+
+class FrameError(Exception):
+    pass
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        i += 1
+        if code == 0 or i + code - 1 > len(data):
+            raise FrameError("bad COBS framing")
+        out += data[i:i + code - 1]
+        i += code - 1
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def varint(data, pos):
+    value = 0
+    shift = 0
+    while True:
+        if pos >= len(data) or shift > 28:
+            raise FrameError("truncated varint")
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value & 0xFFFFFFFF, pos
+
+
+def parse(payload):
+    """Return (keyframe, schema, sequence, body) of a CRC-checked payload."""
+    if len(payload) < 5:
+        raise FrameError("short frame")
+    body, crc = payload[:-2], payload[-2] | (payload[-1] << 8)
+    if crc16(body) != crc:
+        raise FrameError("CRC mismatch")
+    flags = body[0]
+    if flags & VERSION_MASK != VERSION:
+        raise FrameError("unsupported version %u" % (flags & VERSION_MASK))
+    schema, pos = varint(body, 1)
+    sequence, pos = varint(body, pos)
+    return bool(flags & FLAG_KEY), schema, sequence, body, pos
+
+
+class Decoder:
+    def __init__(self, schema):
+        self.schema = schema
+        self.values = None
+        self.sequence = None
+        self.stats = {"frames": 0, "keyframes": 0, "crc_errors": 0, "gaps": 0,
+                      "unsynced": 0, "foreign": 0}
+
+    def apply(self, frame):
+        """Apply one COBS frame; return the sequence number or None if dropped."""
+        try:
+            key, schema, sequence, body, pos = parse(cobs_decode(frame))
+        except FrameError:
+            self.stats["crc_errors"] += 1
+            return None
+        if self.schema is None:
+            self.schema = schema
+        if schema != self.schema:
+            self.stats["foreign"] += 1
+            return None
+        if self.sequence is not None and sequence != (self.sequence + 1) & 0xFFFFFFFF:
+            self.stats["gaps"] += 1
+            self.sequence = None
+        try:
+            if key:
+                count, pos = varint(body, pos)
+                values = []
+                for _ in range(count):
+                    value, pos = varint(body, pos)
+                    values.append(value)
+                self.values = values
+                self.stats["keyframes"] += 1
+            elif self.sequence is None or self.values is None:
+                self.stats["unsynced"] += 1
+                return None
+            else:
+                index = -1
+                while pos < len(body):
+                    gap, pos = varint(body, pos)
+                    zigzag, pos = varint(body, pos)
+                    index += gap + 1
+                    if index >= len(self.values):
+                        raise FrameError("index out of range")
+                    delta = (zigzag >> 1) ^ -(zigzag & 1)
+                    self.values[index] = (self.values[index] + delta) & 0xFFFFFFFF
+            if pos != len(body):
+                raise FrameError("trailing bytes")
+        except FrameError:
+            self.stats["crc_errors"] += 1
+            self.sequence = None
+            return None
+        self.sequence = sequence
+        self.stats["frames"] += 1
+        return sequence
+
+
+def frames(data):
+    """Split a stream at the delimiter; a partial first frame is discarded."""
+    for frame in data.split(b"\x00"):
+        if frame:
+            yield frame
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode a DSRTOS telemetry stream to CSV")
+    parser.add_argument("stream", help="recorded telemetry bytes")
+    parser.add_argument("--schema", type=lambda s: int(s, 0), default=None,
+                        help="expected schema ID (default: the first frame's)")
+    parser.add_argument("--names", default=None,
+                        help="comma-separated counter names for the CSV header")
+    parser.add_argument("--changed-only", action="store_true",
+                        help="print only rows where some counter changed")
+    args = parser.parse_args()
+
+    with open(args.stream, "rb") as f:
+        data = f.read()
+
+    decoder = Decoder(args.schema)
+    names = args.names.split(",") if args.names else None
+    header_done = False
+    previous = None
+    out = sys.stdout
+
+    for frame in frames(data):
+        sequence = decoder.apply(frame)
+        if sequence is None:
+            continue
+        values = decoder.values
+        if not header_done:
+            columns = names if names and len(names) == len(values) else \
+                ["c%u" % i for i in range(len(values))]
+            out.write("sequence," + ",".join(columns) + "\n")
+            header_done = True
+        if args.changed_only and values == previous:
+            continue
+        previous = list(values)
+        out.write("%u,%s\n" % (sequence, ",".join(str(v) for v in values)))
+
+    s = decoder.stats
+    sys.stderr.write("%u bytes, %u frames applied (%u keyframes), %u corrupt, %u gaps, "
+                     "%u skipped unsynced, %u other schema\n"
+                     % (len(data), s["frames"], s["keyframes"], s["crc_errors"], s["gaps"],
+                        s["unsynced"], s["foreign"]))
+    return 0 if s["frames"] else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
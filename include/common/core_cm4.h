@@ -8,6 +8,24 @@
 #define __O     volatile
 #define __IO    volatile
 
+#if defined(DSRTOS_HOST_BUILD)
+/* Host build: PRIMASK is a variable of the host port, the rest no-ops */
+extern volatile uint32_t dsrtos_host_primask;
+
+static inline void __DSB(void) { __asm volatile ("" ::: "memory"); }
+static inline void __ISB(void) { __asm volatile ("" ::: "memory"); }
+static inline void __DMB(void) { __asm volatile ("" ::: "memory"); }
+static inline void __NOP(void) { }
+static inline uint32_t __get_MSP(void) { return 0U; }
+static inline void __set_MSP(uint32_t topOfMainStack) { (void)topOfMainStack; }
+static inline uint32_t __get_PSP(void) { return 0U; }
+static inline void __set_PSP(uint32_t topOfProcStack) { (void)topOfProcStack; }
+static inline void __set_BASEPRI(uint32_t value) { (void)value; }
+static inline void __enable_irq(void) { dsrtos_host_primask = 0U; }
+static inline void __disable_irq(void) { dsrtos_host_primask = 1U; }
+static inline uint32_t __get_PRIMASK(void) { return dsrtos_host_primask; }
+static inline void __set_PRIMASK(uint32_t priMask) { dsrtos_host_primask = priMask; }
+#else
 /* Core intrinsic functions */
 static inline void __DSB(void) {
     __asm volatile ("dsb 0xF":::"memory");
@@ -66,6 +84,7 @@ static inline uint32_t __get_PRIMASK(void) {
 static inline void __set_PRIMASK(uint32_t priMask) {
     __asm volatile ("MSR primask, %0" : : "r" (priMask));
 }
+#endif /* DSRTOS_HOST_BUILD */
 
 /* System Control Block (SCB) - Complete structure */
 typedef struct {
@@ -300,6 +319,7 @@ static inline void SCB_EnableDCache(void) {
     __ISB();
 }
 
+#if !defined(DSRTOS_HOST_BUILD)
 /* Get FPSCR */
 static inline uint32_t __get_FPSCR(void) {
     uint32_t result;
@@ -311,6 +331,7 @@ static inline uint32_t __get_FPSCR(void) {
 static inline void __set_FPSCR(uint32_t fpscr) {
     __asm volatile ("VMSR fpscr, %0" : : "r" (fpscr));
 }
+#endif
 
 /*==============================================================================
  * DWT (Debug Watch and Trace) Unit
@@ -328,7 +349,12 @@ typedef struct {
 
 /* DWT Base Address */
 #define DWT_BASE            (0xE0001000UL)
+#if defined(DSRTOS_HOST_BUILD)
+extern DWT_Type dsrtos_host_dwt;
+#define DWT                 (&dsrtos_host_dwt)
+#else
 #define DWT                 ((DWT_Type*)DWT_BASE)
+#endif
 
 /* DWT Control Register Bit Definitions */
 #define DWT_CTRL_CYCCNTENA_Pos          0U
@@ -357,11 +383,15 @@ typedef struct {
 #define SCB_ICSR_PENDSVSET_Msk          (0x1UL << SCB_ICSR_PENDSVSET_Pos)
 
 /* Additional CMSIS functions */
+#if defined(DSRTOS_HOST_BUILD)
+static inline uint32_t __get_IPSR(void) { return 0U; }
+#else
 __attribute__((always_inline)) static inline uint32_t __get_IPSR(void)
 {
   uint32_t result;
   __asm volatile ("MRS %0, ipsr" : "=r" (result) );
   return(result);
 }
+#endif
 
 #endif /* CORE_CM4_H */
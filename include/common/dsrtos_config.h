@@ -124,6 +124,49 @@ extern "C" {
 #define DSRTOS_CONFIG_MEMORY_ALIGNMENT          8U
 #endif
 
+/**
+ * @brief Heap block guard and canary words
+ * @note Front guard and rear canary are verified on every free
+ * @note Set to 0 to trade corruption detection for allocation speed
+ */
+#ifndef DSRTOS_CONFIG_MEMORY_GUARDS
+#define DSRTOS_CONFIG_MEMORY_GUARDS             1U
+#endif
+
+/**
+ * @brief Log2 of the largest heap block the TLSF index can hold
+ * @note Sizes the first-level index; heap must be smaller than 2^value
+ */
+#ifndef DSRTOS_CONFIG_MEMORY_TLSF_FL_MAX
+#define DSRTOS_CONFIG_MEMORY_TLSF_FL_MAX       17U
+#endif
+
+/**
+ * @brief Heap profiling (per-task accounting, allocation trace)
+ * @note Adds 8 bytes to every block header and a table lookup to every
+ *       allocate/free; set to 0 for production images
+ */
+#ifndef DSRTOS_CONFIG_MEMORY_PROFILE
+#define DSRTOS_CONFIG_MEMORY_PROFILE            0U
+#endif
+
+/**
+ * @brief Owner slots in the heap profile
+ * @note Owners that collide with a busy slot are counted in a shared
+ *       overflow slot
+ */
+#ifndef DSRTOS_CONFIG_MEMORY_PROFILE_OWNERS
+#define DSRTOS_CONFIG_MEMORY_PROFILE_OWNERS    16U
+#endif
+
+/**
+ * @brief Allocation trace ring depth (records, power of 2, 0 = no trace)
+ * @note 20 bytes per record; only used when DSRTOS_CONFIG_MEMORY_PROFILE is set
+ */
+#ifndef DSRTOS_CONFIG_MEMORY_TRACE_DEPTH
+#define DSRTOS_CONFIG_MEMORY_TRACE_DEPTH        0U
+#endif
+
 /**
  * @brief Stack watermark size for overflow detection (bytes)
  * @note Stack usage monitoring for safety analysis
@@ -377,6 +420,38 @@ extern "C" {
 #define DSRTOS_STATS_ENABLED                    1U
 #endif
 
+/**
+ * @brief CPUs that update kernel statistics (one statistics shard each)
+ * @note The STM32F407 has one core; raise only for multi-core ports
+ */
+#ifndef DSRTOS_CONFIG_CPU_COUNT
+#define DSRTOS_CONFIG_CPU_COUNT                 1U
+#endif
+
+/**
+ * @brief Largest statistics shard (bytes)
+ * @note Bounds the stack buffer a statistics snapshot copies through
+ */
+#ifndef DSRTOS_CONFIG_STATS_SHARD_MAX_SIZE
+#define DSRTOS_CONFIG_STATS_SHARD_MAX_SIZE     64U
+#endif
+
+/**
+ * @brief Snapshot attempts per shard before a reader gives up
+ * @note A reader only retries while a writer is inside the shard
+ */
+#ifndef DSRTOS_CONFIG_STATS_READ_RETRIES
+#define DSRTOS_CONFIG_STATS_READ_RETRIES       16U
+#endif
+
+/**
+ * @brief Hook calls per timed hook call (0 disables hook timing)
+ * @note Every call is counted; only one in this many reads the cycle counter
+ */
+#ifndef DSRTOS_CONFIG_HOOK_TIMING_SAMPLE
+#define DSRTOS_CONFIG_HOOK_TIMING_SAMPLE       16U
+#endif
+
 /**
  * @brief Maximum debug log message length (bytes)
  * @note Buffer size for debug string operations
@@ -630,6 +705,71 @@ extern "C" {
 #define DSRTOS_CONFIG_IEC61508_SIL_LEVEL         3U  /* SIL-3 */
 #endif
 
+/*==============================================================================
+ * SAFETY PROFILE
+ *============================================================================*/
+
+/**
+ * @brief Safety profile levels
+ * @note FULL: every check, as certified
+ * @note STANDARD: drops the redundancy against silent memory corruption:
+ *       mirror bitmaps, whole-queue validation on every queue operation,
+ *       periodic revalidation and hot-path cycle measurement
+ * @note MINIMAL: also drops magic number and checksum verification; keeps
+ *       parameter, state and stack checking
+ * @note No level changes the API or the result of a call on an intact
+ *       system. MINIMAL queue nodes also omit the magic and checksum words
+ *       nothing reads in that profile.
+ */
+#define DSRTOS_SAFETY_PROFILE_MINIMAL            0U
+#define DSRTOS_SAFETY_PROFILE_STANDARD           1U
+#define DSRTOS_SAFETY_PROFILE_FULL               2U
+
+/**
+ * @brief Selected safety profile
+ * @note Sets the defaults of the individual switches below
+ */
+#ifndef DSRTOS_CONFIG_SAFETY_PROFILE
+#define DSRTOS_CONFIG_SAFETY_PROFILE             DSRTOS_SAFETY_PROFILE_FULL
+#endif
+
+/**
+ * @brief Redundant state checks
+ * @note Mirror priority bitmaps, validation of the touched list per
+ *       operation and a full revalidation every max(100, task count)
+ *       insertions
+ */
+#ifndef DSRTOS_CONFIG_ENABLE_REDUNDANT_CHECKS
+#if (DSRTOS_CONFIG_SAFETY_PROFILE >= DSRTOS_SAFETY_PROFILE_FULL)
+#define DSRTOS_CONFIG_ENABLE_REDUNDANT_CHECKS    1U
+#else
+#define DSRTOS_CONFIG_ENABLE_REDUNDANT_CHECKS    0U
+#endif
+#endif
+
+/**
+ * @brief Cycle measurement of scheduler hot paths
+ * @note Queue lock time, decision and context switch cycle statistics
+ */
+#ifndef DSRTOS_CONFIG_ENABLE_OP_TIMING
+#if (DSRTOS_CONFIG_SAFETY_PROFILE >= DSRTOS_SAFETY_PROFILE_FULL)
+#define DSRTOS_CONFIG_ENABLE_OP_TIMING           1U
+#else
+#define DSRTOS_CONFIG_ENABLE_OP_TIMING           0U
+#endif
+#endif
+
+/**
+ * @brief Magic number verification of kernel objects
+ */
+#ifndef DSRTOS_CONFIG_ENABLE_MAGIC_CHECKING
+#if (DSRTOS_CONFIG_SAFETY_PROFILE >= DSRTOS_SAFETY_PROFILE_STANDARD)
+#define DSRTOS_CONFIG_ENABLE_MAGIC_CHECKING      1U
+#else
+#define DSRTOS_CONFIG_ENABLE_MAGIC_CHECKING      0U
+#endif
+#endif
+
 /*==============================================================================
  * VALIDATION AND ERROR CHECKING CONFIGURATION
  *============================================================================*/
@@ -670,9 +810,14 @@ extern "C" {
 /**
  * @brief Enable checksum validation
  * @note Data integrity verification using checksums
+ * @note Defaults from DSRTOS_CONFIG_SAFETY_PROFILE
  */
 #ifndef DSRTOS_CONFIG_ENABLE_CHECKSUM_VALIDATION
+#if (DSRTOS_CONFIG_SAFETY_PROFILE >= DSRTOS_SAFETY_PROFILE_STANDARD)
 #define DSRTOS_CONFIG_ENABLE_CHECKSUM_VALIDATION 1U
+#else
+#define DSRTOS_CONFIG_ENABLE_CHECKSUM_VALIDATION 0U
+#endif
 #endif
 
 /*==============================================================================
@@ -741,6 +886,28 @@ extern "C" {
 #error "DSRTOS_CONFIG_MEMORY_ALIGNMENT must be a power of 2"
 #endif
 
+/* Validate the TLSF index covers the whole heap */
+#if (DSRTOS_CONFIG_MEMORY_TLSF_FL_MAX > 30U) || \
+    (DSRTOS_CONFIG_HEAP_SIZE >= (1UL << DSRTOS_CONFIG_MEMORY_TLSF_FL_MAX))
+#error "DSRTOS_CONFIG_HEAP_SIZE must be below 2^DSRTOS_CONFIG_MEMORY_TLSF_FL_MAX"
+#endif
+
+/* Validate heap profile geometry */
+#if (DSRTOS_CONFIG_MEMORY_PROFILE_OWNERS == 0U) || \
+    ((DSRTOS_CONFIG_MEMORY_TRACE_DEPTH & (DSRTOS_CONFIG_MEMORY_TRACE_DEPTH - 1U)) != 0U)
+#error "DSRTOS_CONFIG_MEMORY_PROFILE_OWNERS must be non-zero and DSRTOS_CONFIG_MEMORY_TRACE_DEPTH a power of 2"
+#endif
+
+/* Validate statistics sharding */
+#if (DSRTOS_CONFIG_CPU_COUNT == 0U) || (DSRTOS_CONFIG_STATS_READ_RETRIES == 0U)
+#error "DSRTOS_CONFIG_CPU_COUNT and DSRTOS_CONFIG_STATS_READ_RETRIES must be non-zero"
+#endif
+
+/* Validate hook timing sample rate */
+#if (DSRTOS_CONFIG_HOOK_TIMING_SAMPLE & (DSRTOS_CONFIG_HOOK_TIMING_SAMPLE - 1U)) != 0U
+#error "DSRTOS_CONFIG_HOOK_TIMING_SAMPLE must be 0 or a power of 2"
+#endif
+
 /* Validate timeout values */
 #if DSRTOS_CONFIG_MAX_TIMEOUT_MS == 0U
 #error "DSRTOS_CONFIG_MAX_TIMEOUT_MS must be greater than 0"
@@ -750,6 +917,11 @@ extern "C" {
 #error "DSRTOS_CONFIG_BOOT_TIMEOUT_MS must be greater than 0"
 #endif
 
+/* Validate safety profile */
+#if (DSRTOS_CONFIG_SAFETY_PROFILE > DSRTOS_SAFETY_PROFILE_FULL)
+#error "DSRTOS_CONFIG_SAFETY_PROFILE must be MINIMAL, STANDARD or FULL"
+#endif
+
 /* Validate safety margin */
 #if (DSRTOS_CONFIG_SAFETY_MARGIN_PERCENT < 5U) || (DSRTOS_CONFIG_SAFETY_MARGIN_PERCENT > 50U)
 #error "DSRTOS_CONFIG_SAFETY_MARGIN_PERCENT must be between 5 and 50"
@@ -0,0 +1,216 @@
+/**
+ * @file dsrtos_handle.h
+ * @brief Generation-counted handle tables for DSRTOS kernel objects
+ * @version 1.0.0
+ * @date 2025-08-31
+ *
+ * @copyright Copyright (c) 2025 DSRTOS Project
+ *
+ * CERTIFICATION COMPLIANCE:
+ * - MISRA-C:2012 Compliant (All mandatory and required rules)
+ * - DO-178C Level A Certified (Software Level A - Catastrophic failure)
+ * - IEC 62304 Class C Compliant (Life-threatening medical device software)
+ * - IEC 61508 SIL-3 Certified (Safety Integrity Level 3)
+ *
+ * @note A handle names a kernel object by slot index, object type and the
+ *       slot's generation. Freeing a slot advances its generation, so a
+ *       handle kept past the object's lifetime no longer matches the slot
+ *       and is rejected without reading the object it used to name.
+ * @note Each object type owns one table over caller-provided static slots.
+ *       The slot index is dense and doubles as the object's small integer
+ *       ID, so ID-to-object lookup is the same array load.
+ * @note Tables are not locked. Callers serialize access the same way they
+ *       serialize creation and deletion of the objects.
+ */
+
+#ifndef DSRTOS_HANDLE_H
+#define DSRTOS_HANDLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==============================================================================
+ * INCLUDES (MISRA-C:2012 Rule 20.1)
+ *============================================================================*/
+#include "dsrtos_types.h"
+#include "dsrtos_error.h"
+
+/*==============================================================================
+ * PUBLIC CONSTANTS
+ *============================================================================*/
+
+/** Handle table control block marker ('HNDL') */
+#define DSRTOS_HANDLE_MAGIC            (0x484E444CU)
+
+/** Never a valid handle: type 0 is never issued */
+#define DSRTOS_HANDLE_INVALID          (0U)
+
+/** Object types, carried in the handle and in the slot tag */
+#define DSRTOS_HANDLE_TYPE_NONE        (0U)     /**< Free slot */
+#define DSRTOS_HANDLE_TYPE_TASK        (1U)
+#define DSRTOS_HANDLE_TYPE_MUTEX       (2U)
+#define DSRTOS_HANDLE_TYPE_QUEUE       (3U)
+#define DSRTOS_HANDLE_TYPE_TIMER       (4U)
+#define DSRTOS_HANDLE_TYPE_MAX         (15U)
+
+/** Handle layout: | type:4 | generation:12 | index:16 | */
+#define DSRTOS_HANDLE_INDEX_BITS       (16U)
+#define DSRTOS_HANDLE_GENERATION_BITS  (12U)
+#define DSRTOS_HANDLE_GENERATION_MASK  ((1U << DSRTOS_HANDLE_GENERATION_BITS) - 1U)
+
+/** Largest table; the all-ones index terminates the free list */
+#define DSRTOS_HANDLE_MAX_CAPACITY     (0xFFFFU)
+
+/** Slot index of a handle */
+#define DSRTOS_HANDLE_INDEX(h)         ((uint32_t)(h) & 0xFFFFU)
+
+/** Type and generation of a handle, as stored in a live slot's tag */
+#define DSRTOS_HANDLE_TAG(h)           ((uint16_t)((uint32_t)(h) >> DSRTOS_HANDLE_INDEX_BITS))
+
+/** Object type of a handle */
+#define DSRTOS_HANDLE_TYPE(h)          ((uint32_t)(h) >> (DSRTOS_HANDLE_INDEX_BITS + \
+                                                          DSRTOS_HANDLE_GENERATION_BITS))
+
+/*==============================================================================
+ * PUBLIC TYPES
+ *============================================================================*/
+
+/** Kernel object handle */
+typedef uint32_t dsrtos_handle_t;
+
+/**
+ * @brief Handle slot
+ * @note A live slot's tag is the upper half of the handle it issued. A free
+ *       slot keeps its next generation in the tag with type NONE, which no
+ *       handle carries.
+ */
+typedef struct {
+    void* object;                      /**< Live object, NULL when free */
+    uint16_t tag;                      /**< Type and generation */
+    uint16_t next_free;                /**< Next free slot index */
+} dsrtos_handle_slot_t;
+
+/**
+ * @brief Handle table statistics
+ */
+typedef struct {
+    uint32_t capacity;                 /**< Slots in the table */
+    uint32_t used;                     /**< Live handles */
+    uint32_t high_water;               /**< Most live handles at once */
+    uint32_t alloc_count;              /**< Handles issued */
+    uint32_t free_count;               /**< Handles retired */
+    uint32_t alloc_failures;           /**< Allocations from a full table */
+    uint32_t stale_frees;              /**< Frees of stale or foreign handles */
+} dsrtos_handle_stats_t;
+
+/**
+ * @brief Handle table control block
+ */
+typedef struct {
+    uint32_t magic;                    /**< DSRTOS_HANDLE_MAGIC when initialized */
+    const char* name;                  /**< Table name for diagnostics */
+    dsrtos_handle_slot_t* slots;       /**< Slot storage */
+    uint32_t capacity;                 /**< Number of slots */
+    uint32_t type;                     /**< DSRTOS_HANDLE_TYPE_* issued */
+    uint16_t free_head;                /**< Oldest free slot */
+    uint16_t free_tail;                /**< Most recently freed slot */
+    dsrtos_handle_stats_t stats;       /**< Usage statistics */
+} dsrtos_handle_table_t;
+
+/*==============================================================================
+ * PUBLIC FUNCTION DECLARATIONS (MISRA-C:2012 Rule 8.1)
+ *============================================================================*/
+
+/**
+ * @brief Initialize a handle table over static slots
+ * @param[out] table Table control block
+ * @param[in] name Table name (static string)
+ * @param[in] type DSRTOS_HANDLE_TYPE_* of every object in the table
+ * @param[in] slots Slot storage, capacity entries
+ * @param[in] capacity Number of slots, 1..DSRTOS_HANDLE_MAX_CAPACITY
+ * @return DSRTOS_SUCCESS on success, error code on failure
+ * @note Slots are handed out in ascending index order after init
+ */
+dsrtos_error_t dsrtos_handle_table_init(dsrtos_handle_table_t* table,
+                                        const char* name,
+                                        uint32_t type,
+                                        dsrtos_handle_slot_t* slots,
+                                        uint32_t capacity);
+
+/**
+ * @brief Issue a handle for an object
+ * @param[in,out] table Table
+ * @param[in] object Object to name, not NULL
+ * @return Handle, or DSRTOS_HANDLE_INVALID when the table is full
+ * @note O(1). Freed slots are reused oldest first, so a generation only
+ *       wraps after capacity * 4096 frees rather than 4096 frees of the
+ *       most recently released slot.
+ */
+dsrtos_handle_t dsrtos_handle_alloc(dsrtos_handle_table_t* table, void* object);
+
+/**
+ * @brief Retire a handle
+ * @param[in,out] table Table
+ * @param[in] handle Handle returned by dsrtos_handle_alloc
+ * @return DSRTOS_SUCCESS, or DSRTOS_ERROR_INVALID_HANDLE for a stale,
+ *         foreign or already retired handle
+ * @note O(1). Every copy of the handle is stale afterwards.
+ */
+dsrtos_error_t dsrtos_handle_free(dsrtos_handle_table_t* table, dsrtos_handle_t handle);
+
+/**
+ * @brief Get handle table statistics
+ * @param[in] table Table
+ * @param[out] stats Statistics
+ * @return DSRTOS_SUCCESS on success, error code on failure
+ */
+dsrtos_error_t dsrtos_handle_get_stats(const dsrtos_handle_table_t* table,
+                                       dsrtos_handle_stats_t* stats);
+
+/*==============================================================================
+ * INLINE FUNCTIONS - Performance Critical
+ *============================================================================*/
+
+/**
+ * @brief Resolve a handle
+ * @param[in] table Initialized table
+ * @param[in] handle Handle to resolve
+ * @return Object, or NULL for a stale, foreign or invalid handle
+ * @note One slot load and one compare: the tag holds both type and
+ *       generation, so a handle of another table or an earlier object in
+ *       the slot never matches, and a free slot resolves to NULL
+ */
+static inline void* dsrtos_handle_lookup(const dsrtos_handle_table_t* table,
+                                         dsrtos_handle_t handle)
+{
+    uint32_t index = DSRTOS_HANDLE_INDEX(handle);
+    void* object = NULL;
+
+    if ((index < table->capacity) &&
+        (table->slots[index].tag == DSRTOS_HANDLE_TAG(handle))) {
+        object = table->slots[index].object;
+    }
+
+    return object;
+}
+
+/**
+ * @brief Resolve a slot index (object ID)
+ * @param[in] table Initialized table
+ * @param[in] index Slot index
+ * @return Live object in the slot, or NULL
+ * @note Without a generation a reused ID names the new object; hold the
+ *       handle where that matters
+ */
+static inline void* dsrtos_handle_lookup_index(const dsrtos_handle_table_t* table,
+                                               uint32_t index)
+{
+    return (index < table->capacity) ? table->slots[index].object : NULL;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DSRTOS_HANDLE_H */
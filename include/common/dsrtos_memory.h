@@ -26,6 +26,84 @@ extern "C" {
 #include "dsrtos_types.h"
 #include "dsrtos_error.h"
 
+/*==============================================================================
+ * PUBLIC TYPES
+ *============================================================================*/
+
+/**
+ * @brief Detailed heap statistics
+ * @note Sizes are payload bytes; block headers are not counted
+ */
+typedef struct {
+    dsrtos_size_t total_size;          /**< Usable heap after initial headers */
+    dsrtos_size_t allocated_size;      /**< Bytes held by allocated blocks */
+    dsrtos_size_t peak_usage;          /**< High-water mark of allocated_size */
+    dsrtos_size_t free_size;           /**< Bytes held by free blocks */
+    dsrtos_size_t largest_free_block;  /**< Largest single free block */
+    uint32_t free_blocks;              /**< Number of free blocks */
+    uint32_t allocation_count;         /**< Successful allocations */
+    uint32_t free_count;               /**< Successful frees */
+    uint32_t failed_count;             /**< Allocations that found no block */
+    uint32_t corruption_count;         /**< Guard, canary or magic failures */
+} dsrtos_memory_heap_info_t;
+
+/** Owner reported when no owner hook is installed (startup, ISRs) */
+#define DSRTOS_MEMORY_OWNER_NONE           (0xFFFFFFFFU)
+
+/** Owner of the shared slot for owners that found their slot taken */
+#define DSRTOS_MEMORY_OWNER_OTHER          (0xFFFFFFFEU)
+
+/**
+ * @brief Heap usage attributed to one owner (task)
+ */
+typedef struct {
+    uint32_t owner;                    /**< Task ID, or DSRTOS_MEMORY_OWNER_* */
+    dsrtos_size_t bytes;               /**< Requested bytes currently held */
+    dsrtos_size_t peak_bytes;          /**< High-water mark of bytes */
+    uint32_t objects;                  /**< Blocks currently held */
+    uint32_t alloc_count;              /**< Successful allocations */
+    uint32_t free_count;               /**< Successful frees */
+} dsrtos_memory_owner_stats_t;
+
+/**
+ * @brief Kernel services the heap profiler calls
+ * @note Installed once the scheduler exists; both may be NULL
+ */
+typedef struct {
+    uint32_t (*get_owner)(void);       /**< Current task ID */
+    uint32_t (*get_timestamp)(void);   /**< Free-running cycle or tick count */
+} dsrtos_memory_profile_hooks_t;
+
+/** Set in dsrtos_memory_trace_record_t.size_op for a free */
+#define DSRTOS_MEMORY_TRACE_OP_FREE        (0x80000000U)
+
+/** Trace export marker ('HTRC') and format version */
+#define DSRTOS_MEMORY_TRACE_MAGIC          (0x48545243U)
+#define DSRTOS_MEMORY_TRACE_VERSION        (1U)
+
+/**
+ * @brief One allocation trace record (little-endian words on the wire)
+ */
+typedef struct {
+    uint32_t timestamp;                /**< get_timestamp() at the operation */
+    uint32_t caller;                   /**< Return address into the caller */
+    uint32_t offset;                   /**< Payload offset from the heap start */
+    uint32_t owner;                    /**< Task performing the operation */
+    uint32_t size_op;                  /**< Requested size | DSRTOS_MEMORY_TRACE_OP_FREE */
+} dsrtos_memory_trace_record_t;
+
+/**
+ * @brief Header written in front of exported trace records
+ */
+typedef struct {
+    uint32_t magic;                    /**< DSRTOS_MEMORY_TRACE_MAGIC */
+    uint16_t version;                  /**< DSRTOS_MEMORY_TRACE_VERSION */
+    uint16_t record_size;              /**< sizeof(dsrtos_memory_trace_record_t) */
+    uint32_t record_count;             /**< Records following the header */
+    uint32_t dropped;                  /**< Records overwritten before export */
+    uint32_t heap_size;                /**< DSRTOS_CONFIG_HEAP_SIZE */
+} dsrtos_memory_trace_header_t;
+
 /*==============================================================================
  * PUBLIC FUNCTION DECLARATIONS (MISRA-C:2012 Rule 8.1)
  *============================================================================*/
@@ -68,6 +146,65 @@ dsrtos_error_t dsrtos_memory_get_stats(dsrtos_size_t* total_size,
                                        dsrtos_size_t* allocated_size,
                                        dsrtos_size_t* peak_usage);
 
+/**
+ * @brief Get detailed heap statistics
+ * @param[out] info Heap statistics
+ * @return DSRTOS_SUCCESS on success, error code on failure
+ * @note Bounded time: only the largest non-empty size class is walked
+ */
+dsrtos_error_t dsrtos_memory_get_heap_info(dsrtos_memory_heap_info_t* info);
+
+/**
+ * @brief Get the heap fragmentation index
+ * @param[out] index_permille 1000 * (1 - largest free block / total free);
+ *             0 when all free memory is one block
+ * @return DSRTOS_SUCCESS on success, error code on failure
+ */
+dsrtos_error_t dsrtos_memory_get_fragmentation(uint32_t* index_permille);
+
+/**
+ * @brief Install the owner and timestamp sources for heap profiling
+ * @param[in] hooks Hook table (copied)
+ * @return DSRTOS_SUCCESS, or DSRTOS_ERR_NOT_SUPPORTED when
+ *         DSRTOS_CONFIG_MEMORY_PROFILE is 0
+ */
+dsrtos_error_t dsrtos_memory_profile_set_hooks(const dsrtos_memory_profile_hooks_t* hooks);
+
+/**
+ * @brief Get heap usage of one owner
+ * @param[in] owner Task ID or DSRTOS_MEMORY_OWNER_*
+ * @param[out] stats Owner statistics
+ * @return DSRTOS_SUCCESS, DSRTOS_ERR_NOT_FOUND when the owner has no slot,
+ *         or DSRTOS_ERR_NOT_SUPPORTED when profiling is compiled out
+ */
+dsrtos_error_t dsrtos_memory_profile_get_owner(uint32_t owner,
+                                               dsrtos_memory_owner_stats_t* stats);
+
+/**
+ * @brief Get heap usage of every owner that has allocated
+ * @param[out] stats Array of at least max_count entries
+ * @param[in] max_count Capacity of stats
+ * @param[out] count Entries written
+ * @return DSRTOS_SUCCESS on success, error code on failure
+ */
+dsrtos_error_t dsrtos_memory_profile_get_all(dsrtos_memory_owner_stats_t* stats,
+                                             uint32_t max_count,
+                                             uint32_t* count);
+
+/**
+ * @brief Drain the allocation trace ring in export format
+ * @param[out] buffer Destination for a dsrtos_memory_trace_header_t and
+ *             the oldest records that fit after it
+ * @param[in] size Buffer size in bytes
+ * @param[out] written Bytes written
+ * @return DSRTOS_SUCCESS, or DSRTOS_ERR_NOT_SUPPORTED when the trace ring
+ *         is compiled out
+ * @note Exported records are removed from the ring
+ */
+dsrtos_error_t dsrtos_memory_trace_export(void* buffer,
+                                          dsrtos_size_t size,
+                                          dsrtos_size_t* written);
+
 #ifdef __cplusplus
 }
 #endif
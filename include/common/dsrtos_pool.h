@@ -0,0 +1,153 @@
+/**
+ * @file dsrtos_pool.h
+ * @brief Fixed-block object pool interface for DSRTOS kernel objects
+ * @version 1.0.0
+ * @date 2025-08-31
+ *
+ * @copyright Copyright (c) 2025 DSRTOS Project
+ *
+ * CERTIFICATION COMPLIANCE:
+ * - MISRA-C:2012 Compliant (All mandatory and required rules)
+ * - DO-178C Level A Certified (Software Level A - Catastrophic failure)
+ * - IEC 62304 Class C Compliant (Life-threatening medical device software)
+ * - IEC 61508 SIL-3 Certified (Safety Integrity Level 3)
+ *
+ * @note A pool hands out equally sized blocks from caller-provided static
+ *       storage. Free blocks are linked through their first word into a
+ *       LIFO list, so allocate and free are O(1) and the most recently
+ *       released (cache-warm) block is reused first.
+ * @note Pools are not locked. Callers serialize access the same way they
+ *       serialized the static arrays the pools replace.
+ */
+
+#ifndef DSRTOS_POOL_H
+#define DSRTOS_POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==============================================================================
+ * INCLUDES (MISRA-C:2012 Rule 20.1)
+ *============================================================================*/
+#include "dsrtos_types.h"
+#include "dsrtos_error.h"
+
+/*==============================================================================
+ * PUBLIC CONSTANTS
+ *============================================================================*/
+
+/** Pool control block marker ('POOL') */
+#define DSRTOS_POOL_MAGIC              (0x504F4F4CU)
+
+/** Pool flags */
+#define DSRTOS_POOL_FLAG_NONE          (0x00U)
+#define DSRTOS_POOL_FLAG_POISON        (0x01U)  /**< Poison freed blocks, verify on reuse */
+
+/** Fill pattern for poisoned blocks */
+#define DSRTOS_POOL_POISON_BYTE        (0xAAU)
+
+/*==============================================================================
+ * PUBLIC TYPES
+ *============================================================================*/
+
+/**
+ * @brief Free-list link, overlaid on the first word of a free block
+ */
+typedef struct dsrtos_pool_link {
+    struct dsrtos_pool_link* next;     /**< Next free block */
+} dsrtos_pool_link_t;
+
+/**
+ * @brief Pool statistics
+ */
+typedef struct {
+    uint32_t capacity;                 /**< Blocks in the pool */
+    uint32_t used;                     /**< Blocks currently allocated */
+    uint32_t high_water;               /**< Most blocks ever allocated at once */
+    uint32_t alloc_count;              /**< Successful allocations */
+    uint32_t free_count;               /**< Successful frees */
+    uint32_t alloc_failures;           /**< Allocations from an empty pool */
+    uint32_t invalid_frees;            /**< Foreign, misaligned or double frees */
+    uint32_t poison_errors;            /**< Blocks written to while free */
+} dsrtos_pool_stats_t;
+
+/**
+ * @brief Pool control block
+ */
+typedef struct {
+    uint32_t magic;                    /**< DSRTOS_POOL_MAGIC when initialized */
+    const char* name;                  /**< Pool name for diagnostics */
+    uint8_t* base;                     /**< First block */
+    dsrtos_size_t block_size;          /**< Bytes per block */
+    uint32_t capacity;                 /**< Number of blocks */
+    uint32_t flags;                    /**< DSRTOS_POOL_FLAG_* */
+    dsrtos_pool_link_t* free_list;     /**< LIFO free list */
+    dsrtos_pool_stats_t stats;         /**< Usage statistics */
+} dsrtos_pool_t;
+
+/*==============================================================================
+ * PUBLIC FUNCTION DECLARATIONS (MISRA-C:2012 Rule 8.1)
+ *============================================================================*/
+
+/**
+ * @brief Initialize a pool over static storage
+ * @param[out] pool Pool control block
+ * @param[in] name Pool name (static string)
+ * @param[in] storage Block storage, at least block_size * capacity bytes
+ * @param[in] block_size Bytes per block, pointer-aligned, >= sizeof(void*)
+ * @param[in] capacity Number of blocks
+ * @param[in] flags DSRTOS_POOL_FLAG_* options
+ * @return DSRTOS_SUCCESS on success, error code on failure
+ * @note Blocks are handed out in ascending address order after init
+ */
+dsrtos_error_t dsrtos_pool_init(dsrtos_pool_t* pool,
+                                const char* name,
+                                void* storage,
+                                dsrtos_size_t block_size,
+                                uint32_t capacity,
+                                uint32_t flags);
+
+/**
+ * @brief Allocate one block
+ * @param[in,out] pool Pool
+ * @return Block, or NULL when the pool is empty
+ * @note O(1). Block contents are undefined; callers clear what they use.
+ *       Poisoned pools break the pattern on allocation so that freeing an
+ *       untouched block is not mistaken for a double free.
+ */
+void* dsrtos_pool_alloc(dsrtos_pool_t* pool);
+
+/**
+ * @brief Return a block to its pool
+ * @param[in,out] pool Pool
+ * @param[in] block Block previously returned by dsrtos_pool_alloc
+ * @return DSRTOS_SUCCESS, or DSRTOS_ERROR_INVALID_ADDRESS for a pointer
+ *         outside the pool and DSRTOS_ERROR_INVALID_STATE for a detected
+ *         double free (poisoned pools only)
+ * @note O(1), plus a block-sized fill when poisoning is enabled
+ */
+dsrtos_error_t dsrtos_pool_free(dsrtos_pool_t* pool, void* block);
+
+/**
+ * @brief Check whether a pointer is a block of the pool
+ * @param[in] pool Pool
+ * @param[in] block Pointer to check
+ * @return true if block is the start of one of the pool's blocks
+ */
+bool dsrtos_pool_owns(const dsrtos_pool_t* pool, const void* block);
+
+/**
+ * @brief Get pool statistics
+ * @param[in] pool Pool
+ * @param[out] stats Statistics
+ * @return DSRTOS_SUCCESS on success, error code on failure
+ */
+dsrtos_error_t dsrtos_pool_get_stats(const dsrtos_pool_t* pool,
+                                     dsrtos_pool_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DSRTOS_POOL_H */
@@ -0,0 +1,249 @@
+/**
+ * @file dsrtos_shard_stats.h
+ * @brief Per-CPU statistics shards with sequence-counted snapshots
+ * @version 1.0.0
+ * @date 2025-08-31
+ *
+ * @copyright Copyright (c) 2025 DSRTOS Project
+ *
+ * CERTIFICATION COMPLIANCE:
+ * - MISRA-C:2012 Compliant (All mandatory and required rules)
+ * - DO-178C Level A Certified (Software Level A - Catastrophic failure)
+ * - IEC 62304 Class C Compliant (Life-threatening medical device software)
+ * - IEC 61508 SIL-3 Certified (Safety Integrity Level 3)
+ *
+ * @note Kernel statistics are written on hot paths (context switch,
+ *       scheduling decision, queue walk) and read rarely. Each CPU owns one
+ *       shard and updates it without locks; a reader copies every shard
+ *       under its sequence counter and retries a shard that changed while
+ *       it was copied. Neither side masks interrupts.
+ *
+ *       The sequence counter is a pair of counters rather than a single odd
+ *       or even one, so that an interrupt handler that updates the same
+ *       shard inside a thread-level update still leaves the counter
+ *       consistent. Fields updated from more than one context must use the
+ *       dsrtos_stat_* helpers so that nested writers lose no update.
+ */
+
+#ifndef DSRTOS_SHARD_STATS_H
+#define DSRTOS_SHARD_STATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==============================================================================
+ * INCLUDES (MISRA-C:2012 Rule 20.1)
+ *============================================================================*/
+#include "dsrtos_types.h"
+#include "dsrtos_error.h"
+#include "dsrtos_config.h"
+
+/*==============================================================================
+ * PUBLIC CONSTANTS
+ *============================================================================*/
+
+/** Shards per statistics set: one per CPU */
+#define DSRTOS_STATS_SHARD_COUNT       (DSRTOS_CONFIG_CPU_COUNT)
+
+/** Shard set validity marker */
+#define DSRTOS_SHARD_STATS_MAGIC       (0x53485244U)  /* "SHRD" */
+
+/*==============================================================================
+ * PUBLIC TYPES
+ *============================================================================*/
+
+/**
+ * @brief Sequence counter: data is stable while begin == end
+ */
+typedef struct {
+    volatile uint32_t begin;           /**< Writers that entered */
+    volatile uint32_t end;             /**< Writers that left */
+} dsrtos_seqcount_t;
+
+/**
+ * @brief Set a shard, or the snapshot total, to its empty state
+ */
+typedef void (*dsrtos_shard_reset_fn_t)(void* shard);
+
+/**
+ * @brief Fold one shard into the snapshot total
+ */
+typedef void (*dsrtos_shard_merge_fn_t)(void* total, const void* shard);
+
+/**
+ * @brief Returns the index of the CPU running the caller
+ */
+typedef uint32_t (*dsrtos_shard_cpu_fn_t)(void);
+
+/**
+ * @brief A statistics structure split into one shard per CPU
+ */
+typedef struct {
+    uint32_t magic;                    /**< DSRTOS_SHARD_STATS_MAGIC once initialized */
+    const char* name;                  /**< Name for diagnostics */
+    uint8_t* shards;                   /**< DSRTOS_STATS_SHARD_COUNT shards, back to back */
+    dsrtos_size_t shard_size;          /**< Bytes per shard */
+    dsrtos_shard_reset_fn_t reset;     /**< NULL zero-fills */
+    dsrtos_shard_merge_fn_t merge;     /**< Combines shards into a snapshot */
+    dsrtos_seqcount_t seq[DSRTOS_STATS_SHARD_COUNT];
+    volatile uint32_t read_retries;    /**< Shard copies a reader had to repeat */
+} dsrtos_shard_stats_t;
+
+/**
+ * @brief Static initializer for a shard set over zero-initialized storage
+ * @note For modules without an init function; the shards must start at
+ *       all-zero, which is what reset would produce
+ */
+#define DSRTOS_SHARD_STATS_INITIALIZER(name_, shards_, reset_, merge_) \
+    { DSRTOS_SHARD_STATS_MAGIC, (name_), (uint8_t*)(shards_),         \
+      sizeof((shards_)[0]), (reset_), (merge_), { { 0U, 0U } }, 0U }
+
+/*==============================================================================
+ * INLINE FUNCTIONS
+ *============================================================================*/
+
+/**
+ * @brief Enter a write section
+ * @param[in,out] seq Sequence counter
+ */
+static inline void dsrtos_seqcount_write_begin(dsrtos_seqcount_t* seq)
+{
+    (void)__atomic_fetch_add(&seq->begin, 1U, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Leave a write section
+ * @param[in,out] seq Sequence counter
+ */
+static inline void dsrtos_seqcount_write_end(dsrtos_seqcount_t* seq)
+{
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    (void)__atomic_fetch_add(&seq->end, 1U, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Add to a counter field without losing nested updates
+ * @param[in,out] field Counter
+ * @param[in] value Amount
+ */
+static inline void dsrtos_stat_add(uint32_t* field, uint32_t value)
+{
+    (void)__atomic_fetch_add(field, value, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Raise a maximum field to value if value is larger
+ * @param[in,out] field Maximum
+ * @param[in] value Sample
+ */
+static inline void dsrtos_stat_max(uint32_t* field, uint32_t value)
+{
+    uint32_t seen = __atomic_load_n(field, __ATOMIC_RELAXED);
+
+    while ((value > seen) &&
+           !__atomic_compare_exchange_n(field, &seen, value, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        /* seen was refreshed by the failed exchange */
+    }
+}
+
+/**
+ * @brief Lower a minimum field to value if value is smaller
+ * @param[in,out] field Minimum
+ * @param[in] value Sample
+ */
+static inline void dsrtos_stat_min(uint32_t* field, uint32_t value)
+{
+    uint32_t seen = __atomic_load_n(field, __ATOMIC_RELAXED);
+
+    while ((value < seen) &&
+           !__atomic_compare_exchange_n(field, &seen, value, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        /* seen was refreshed by the failed exchange */
+    }
+}
+
+/*==============================================================================
+ * PUBLIC FUNCTION DECLARATIONS (MISRA-C:2012 Rule 8.1)
+ *============================================================================*/
+
+/**
+ * @brief Copy data published under a sequence counter
+ * @param[in] seq Sequence counter guarding src
+ * @param[out] dst Destination
+ * @param[in] src Published data
+ * @param[in] size Bytes to copy
+ * @return DSRTOS_SUCCESS, or DSRTOS_ERROR_BUSY if a writer was active on
+ *         every one of DSRTOS_CONFIG_STATS_READ_RETRIES attempts
+ * @note dst may hold a torn copy when DSRTOS_ERROR_BUSY is returned
+ */
+dsrtos_error_t dsrtos_seqcount_read(const dsrtos_seqcount_t* seq,
+                                    void* dst,
+                                    const void* src,
+                                    dsrtos_size_t size);
+
+/**
+ * @brief Initialize a shard set and reset every shard
+ * @param[out] set Shard set
+ * @param[in] name Name for diagnostics
+ * @param[in] shards Storage for DSRTOS_STATS_SHARD_COUNT shards
+ * @param[in] shard_size Bytes per shard, at most DSRTOS_CONFIG_STATS_SHARD_MAX_SIZE
+ * @param[in] reset Shard reset function, NULL to zero-fill
+ * @param[in] merge Merge function
+ * @return DSRTOS_SUCCESS on success, error code on failure
+ */
+dsrtos_error_t dsrtos_shard_stats_init(dsrtos_shard_stats_t* set,
+                                       const char* name,
+                                       void* shards,
+                                       dsrtos_size_t shard_size,
+                                       dsrtos_shard_reset_fn_t reset,
+                                       dsrtos_shard_merge_fn_t merge);
+
+/**
+ * @brief Open the calling CPU's shard for update
+ * @param[in,out] set Shard set
+ * @return Shard to update, or NULL if the set is not initialized
+ * @note Every non-NULL return must be paired with dsrtos_shard_stats_write_end()
+ */
+void* dsrtos_shard_stats_write_begin(dsrtos_shard_stats_t* set);
+
+/**
+ * @brief Close a shard opened by dsrtos_shard_stats_write_begin()
+ * @param[in,out] set Shard set
+ * @param[in] shard Shard returned by dsrtos_shard_stats_write_begin()
+ */
+void dsrtos_shard_stats_write_end(dsrtos_shard_stats_t* set, void* shard);
+
+/**
+ * @brief Merge a consistent copy of every shard
+ * @param[in,out] set Shard set
+ * @param[out] total Merged statistics, shard_size bytes
+ * @return DSRTOS_SUCCESS, or DSRTOS_ERROR_BUSY if a shard could not be
+ *         copied consistently
+ * @note Never masks interrupts; each shard is consistent on its own, the
+ *       shards are not copied at one instant
+ */
+dsrtos_error_t dsrtos_shard_stats_snapshot(dsrtos_shard_stats_t* set, void* total);
+
+/**
+ * @brief Reset every shard
+ * @param[in,out] set Shard set
+ * @return DSRTOS_SUCCESS on success, error code on failure
+ * @note An update racing the reset on another CPU may survive it
+ */
+dsrtos_error_t dsrtos_shard_stats_reset(dsrtos_shard_stats_t* set);
+
+/**
+ * @brief Install the function that names the current CPU
+ * @param[in] cpu_fn Returns 0..DSRTOS_STATS_SHARD_COUNT-1, NULL for CPU 0
+ * @note Ports with one core never need this
+ */
+void dsrtos_shard_stats_set_cpu_hook(dsrtos_shard_cpu_fn_t cpu_fn);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DSRTOS_SHARD_STATS_H */
@@ -0,0 +1,182 @@
+/**
+ * @file dsrtos_telemetry.h
+ * @brief Delta-encoded telemetry frames for periodic statistics push
+ * @version 1.0.0
+ * @date 2025-08-31
+ *
+ * @copyright Copyright (c) 2025 DSRTOS Project
+ *
+ * CERTIFICATION COMPLIANCE:
+ * - MISRA-C:2012 Compliant (All mandatory and required rules)
+ * - DO-178C Level A Certified (Software Level A - Catastrophic failure)
+ * - IEC 62304 Class C Compliant (Life-threatening medical device software)
+ * - IEC 61508 SIL-3 Certified (Safety Integrity Level 3)
+ *
+ * @note A telemetry stream carries a fixed vector of 32-bit counters
+ *       identified by a schema ID. A keyframe carries every counter; a delta
+ *       frame carries only the counters that changed since the previous
+ *       frame. Frame payload, before framing:
+ *
+ *         flags      1 byte   bit 7 keyframe, bits 0-3 format version
+ *         schema     varint
+ *         sequence   varint   frame number, +1 per frame
+ *         keyframe:  count varint, then count values as varints
+ *         delta:     (index gap varint, zigzag delta varint) per change
+ *         crc        2 bytes  CRC-16/CCITT-FALSE of the above, little-endian
+ *
+ *       Frames are COBS encoded and terminated by a 0x00 byte, so a
+ *       receiver resynchronizes at the next zero after line noise. A lost
+ *       delta frame shows up as a sequence gap and the decoder waits for
+ *       the next keyframe. PY/dsrtos_telemetry_decode.py decodes a
+ *       recorded stream on the host.
+ */
+
+#ifndef DSRTOS_TELEMETRY_H
+#define DSRTOS_TELEMETRY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==============================================================================
+ * INCLUDES (MISRA-C:2012 Rule 20.1)
+ *============================================================================*/
+#include "dsrtos_types.h"
+#include "dsrtos_error.h"
+#include "dsrtos_config.h"
+
+/*==============================================================================
+ * PUBLIC CONSTANTS
+ *============================================================================*/
+
+/** Payload format version */
+#define DSRTOS_TELEMETRY_VERSION       (1U)
+
+/** Flags byte: keyframe */
+#define DSRTOS_TELEMETRY_FLAG_KEY      (0x80U)
+
+/** Frame delimiter */
+#define DSRTOS_TELEMETRY_DELIMITER     (0x00U)
+
+/** Largest payload for a vector of n counters, CRC included */
+#define DSRTOS_TELEMETRY_PAYLOAD_MAX(n) (1U + 5U + 5U + 5U + ((n) * 10U) + 2U)
+
+/** Output buffer that always holds one framed vector of n counters */
+#define DSRTOS_TELEMETRY_FRAME_MAX(n)                                  \
+    (DSRTOS_TELEMETRY_PAYLOAD_MAX(n) + (DSRTOS_TELEMETRY_PAYLOAD_MAX(n) / 254U) + 2U)
+
+/*==============================================================================
+ * PUBLIC TYPES
+ *============================================================================*/
+
+/**
+ * @brief Encoder state for one telemetry stream
+ */
+typedef struct {
+    uint32_t magic;                    /**< Validity marker */
+    uint16_t schema_id;                /**< Identifies the counter vector */
+    uint16_t counter_count;            /**< Counters per frame */
+    uint32_t* shadow;                  /**< Values sent in the previous frame */
+    uint32_t sequence;                 /**< Number of the next frame */
+    uint32_t keyframe_interval;        /**< Frames per keyframe, 1 = all keyframes */
+    uint32_t since_keyframe;           /**< Frames since the last keyframe */
+    bool force_keyframe;               /**< Next frame is a keyframe */
+    uint32_t frames;                   /**< Frames produced */
+    uint32_t keyframes;                /**< Keyframes produced */
+    uint32_t bytes;                    /**< Framed bytes produced */
+} dsrtos_telemetry_encoder_t;
+
+/**
+ * @brief Decoder state for one telemetry stream
+ */
+typedef struct {
+    uint32_t magic;                    /**< Validity marker */
+    uint16_t schema_id;                /**< Expected schema */
+    uint16_t counter_count;            /**< Counters per frame */
+    uint32_t* values;                  /**< Reconstructed counters */
+    uint32_t sequence;                 /**< Number of the last frame applied */
+    bool synced;                       /**< values are valid */
+    uint32_t frames;                   /**< Frames applied */
+    uint32_t crc_errors;               /**< Frames dropped for a bad CRC or framing */
+    uint32_t gaps;                     /**< Sequence gaps seen */
+    uint32_t unsynced;                 /**< Delta frames dropped while waiting for a keyframe */
+} dsrtos_telemetry_decoder_t;
+
+/*==============================================================================
+ * PUBLIC FUNCTION DECLARATIONS (MISRA-C:2012 Rule 8.1)
+ *============================================================================*/
+
+/**
+ * @brief Initialize an encoder
+ * @param[out] enc Encoder
+ * @param[in] schema_id Schema of the counter vector
+ * @param[in] shadow Caller storage for counter_count values
+ * @param[in] counter_count Counters per frame, at least 1
+ * @param[in] keyframe_interval Frames per keyframe, at least 1
+ * @return DSRTOS_SUCCESS on success, error code on failure
+ * @note The first frame is always a keyframe
+ */
+dsrtos_error_t dsrtos_telemetry_encoder_init(dsrtos_telemetry_encoder_t* enc,
+                                             uint16_t schema_id,
+                                             uint32_t* shadow,
+                                             uint16_t counter_count,
+                                             uint32_t keyframe_interval);
+
+/**
+ * @brief Encode the current counters as one framed telemetry frame
+ * @param[in,out] enc Encoder
+ * @param[in] values counter_count counters, may be live kernel counters
+ * @param[out] out Frame bytes, COBS encoded and delimited
+ * @param[in] out_size Bytes available, DSRTOS_TELEMETRY_FRAME_MAX(counter_count)
+ *            always suffices
+ * @param[out] out_len Frame length
+ * @return DSRTOS_SUCCESS, or DSRTOS_ERROR_OVERFLOW if out is too small
+ *         (no frame is produced, the sequence does not advance and the
+ *         next frame is a keyframe)
+ * @note Each counter is read exactly once
+ */
+dsrtos_error_t dsrtos_telemetry_encode(dsrtos_telemetry_encoder_t* enc,
+                                       const volatile uint32_t* values,
+                                       uint8_t* out,
+                                       dsrtos_size_t out_size,
+                                       dsrtos_size_t* out_len);
+
+/**
+ * @brief Make the next frame a keyframe (e.g. a receiver attached)
+ * @param[in,out] enc Encoder
+ */
+void dsrtos_telemetry_request_keyframe(dsrtos_telemetry_encoder_t* enc);
+
+/**
+ * @brief Initialize a decoder
+ * @param[out] dec Decoder
+ * @param[in] schema_id Expected schema
+ * @param[in] values Caller storage for counter_count values
+ * @param[in] counter_count Counters per frame
+ * @return DSRTOS_SUCCESS on success, error code on failure
+ */
+dsrtos_error_t dsrtos_telemetry_decoder_init(dsrtos_telemetry_decoder_t* dec,
+                                             uint16_t schema_id,
+                                             uint32_t* values,
+                                             uint16_t counter_count);
+
+/**
+ * @brief Decode one frame and apply it
+ * @param[in,out] dec Decoder
+ * @param[in,out] frame COBS bytes of one frame without the delimiter;
+ *                decoded in place
+ * @param[in] len Frame length
+ * @return DSRTOS_SUCCESS when dec->values now holds the sender's counters;
+ *         DSRTOS_ERROR_CRC_MISMATCH for a corrupt frame,
+ *         DSRTOS_ERROR_NOT_SUPPORTED for another schema or version,
+ *         DSRTOS_ERROR_INVALID_STATE for a delta frame while unsynchronized
+ */
+dsrtos_error_t dsrtos_telemetry_decode(dsrtos_telemetry_decoder_t* dec,
+                                       uint8_t* frame,
+                                       dsrtos_size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DSRTOS_TELEMETRY_H */
@@ -396,8 +396,12 @@ typedef enum {
  * @brief Task limits
  * @note System capacity constraints
  * @note DO-178C Level A: Bounded system resources
+ * @note DSRTOS_MAX_TASKS may be overridden by the build, e.g. for host
+ *       scaling runs; every per-task table is sized from it
  */
+#ifndef DSRTOS_MAX_TASKS
 #define DSRTOS_MAX_TASKS                 (64U)      /**< Maximum concurrent tasks */
+#endif
 #define DSRTOS_MAX_TASK_NAME_LENGTH      (16U)      /**< Maximum task name length */
 #define DSRTOS_MAX_MUTEXES               (32U)      /**< Maximum mutex objects */
 #define DSRTOS_MAX_SEMAPHORES            (32U)      /**< Maximum semaphore objects */
@@ -434,8 +438,13 @@ DSRTOS_STATIC_ASSERT(DSRTOS_PRIORITY_IDLE == DSRTOS_PRIORITY_MAX, idle_priority_
 DSRTOS_STATIC_ASSERT(DSRTOS_MIN_STACK_SIZE >= 256U, minimum_stack_validation);
 DSRTOS_STATIC_ASSERT(DSRTOS_DEFAULT_STACK_SIZE >= DSRTOS_MIN_STACK_SIZE, default_stack_validation);
 
-/* Validate system limits are reasonable */
+/* Validate system limits are reasonable; host builds may scale up to the
+ * task ID range */
+#if defined(DSRTOS_HOST_BUILD)
+DSRTOS_STATIC_ASSERT(DSRTOS_MAX_TASKS <= 65535U, max_tasks_validation);
+#else
 DSRTOS_STATIC_ASSERT(DSRTOS_MAX_TASKS <= 255U, max_tasks_validation);
+#endif
 DSRTOS_STATIC_ASSERT(DSRTOS_MAX_TASK_NAME_LENGTH >= 8U, task_name_length_validation);
 
 /* Validate memory alignment is power of 2 */
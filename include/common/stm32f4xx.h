@@ -80,6 +80,7 @@ void SystemCoreClockUpdate(void);
 #define GPIOC_BASE          (AHB1PERIPH_BASE + 0x0800UL)
 #define GPIOD_BASE          (AHB1PERIPH_BASE + 0x0C00UL)
 #define GPIOE_BASE          (AHB1PERIPH_BASE + 0x1000UL)
+#define CRC_BASE            (AHB1PERIPH_BASE + 0x3000UL)
 #define RCC_BASE            (AHB1PERIPH_BASE + 0x3800UL)
 #define FLASH_R_BASE        (AHB1PERIPH_BASE + 0x3C00UL)
 #define DMA1_BASE           (AHB1PERIPH_BASE + 0x6000UL)
@@ -119,6 +120,14 @@ void SystemCoreClockUpdate(void);
 #define MPU_BASE            (SCS_BASE + 0x0D90UL)
 
 /* Peripheral structure definitions */
+typedef struct {
+    __IO uint32_t DR;
+    __IO uint8_t  IDR;
+    uint8_t       RESERVED0;
+    uint16_t      RESERVED1;
+    __IO uint32_t CR;
+} CRC_TypeDef;
+
 typedef struct {
     __IO uint32_t MODER;
     __IO uint32_t OTYPER;
@@ -240,6 +249,7 @@ typedef struct {
 #define GPIOC               ((GPIO_TypeDef *) GPIOC_BASE)
 #define GPIOD               ((GPIO_TypeDef *) GPIOD_BASE)
 #define GPIOE               ((GPIO_TypeDef *) GPIOE_BASE)
+#define CRC                 ((CRC_TypeDef *) CRC_BASE)
 #define RCC                 ((RCC_TypeDef *) RCC_BASE)
 #define FLASH               ((FLASH_TypeDef *) FLASH_R_BASE)
 #define USART2              ((USART_TypeDef *) USART2_BASE)
@@ -275,12 +285,16 @@ typedef struct {
 #define RCC_AHB1ENR_GPIOCEN ((uint32_t)0x00000004)
 #define RCC_AHB1ENR_GPIODEN ((uint32_t)0x00000008)
 #define RCC_AHB1ENR_GPIOEEN ((uint32_t)0x00000010)
+#define RCC_AHB1ENR_CRCEN   ((uint32_t)0x00001000)
 #define RCC_AHB1ENR_SRAM1EN ((uint32_t)0x00010000)
 #define RCC_AHB1ENR_SRAM2EN ((uint32_t)0x00020000)
 #define RCC_AHB1ENR_CCMDATARAMEN ((uint32_t)0x00100000)
 
 #define RCC_APB1ENR_USART2EN ((uint32_t)0x00020000)
 
+/* CRC Bit Definitions */
+#define CRC_CR_RESET        ((uint32_t)0x00000001)
+
 /* RCC Reset flags */
 #define RCC_CSR_LPWRRSTF    ((uint32_t)0x80000000)
 #define RCC_CSR_WWDGRSTF    ((uint32_t)0x40000000)
@@ -65,6 +65,10 @@ typedef enum {
     DSRTOS_HOOK_MAX                    = 0xFFFFU
 } dsrtos_hook_type_t;
 
+/** Dispatch slots; a hook type maps to slot (type % DSRTOS_HOOK_CHAINS) */
+#define DSRTOS_HOOK_CHAINS              64U
+#define DSRTOS_HOOK_INDEX(type)         ((uint32_t)(type) % DSRTOS_HOOK_CHAINS)
+
 /*=============================================================================
  * HOOK FUNCTION TYPES
  *============================================================================*/
@@ -131,8 +135,67 @@ typedef struct {
     uint32_t total_duration_cycles;    /* Total execution time */
     uint32_t max_duration_cycles;      /* Maximum execution time */
     uint32_t min_duration_cycles;      /* Minimum execution time */
+    uint32_t sampled_count;             /* Calls timed, see DSRTOS_CONFIG_HOOK_TIMING_SAMPLE */
 } dsrtos_hook_stats_t;
 
+/*=============================================================================
+ * LINK-TIME HOOK REGISTRATION
+ *============================================================================*/
+
+/**
+ * @brief Hook registered at link time with DSRTOS_HOOK_STATIC
+ *
+ * Each hook type has its own linker section, so the entries of one type
+ * form a const array bounded by the __start_ and __stop_ symbols the
+ * linker provides. Link-time hooks are always enabled, run in link order
+ * before any hook registered at run time, and are dispatched once
+ * dsrtos_hooks_init() has run.
+ */
+typedef struct {
+    dsrtos_hook_type_t type;           /* Hook type */
+    dsrtos_hook_func_t function;       /* Hook function */
+    const char* name;                   /* Hook name for debugging */
+} dsrtos_hook_static_t;
+
+/* Hook types that accept link-time hooks */
+#define DSRTOS_HOOK_STATIC_KERNEL_IDLE       1
+#define DSRTOS_HOOK_STATIC_KERNEL_TICK       1
+#define DSRTOS_HOOK_STATIC_TASK_CREATE       1
+#define DSRTOS_HOOK_STATIC_TASK_DELETE       1
+#define DSRTOS_HOOK_STATIC_TASK_SWITCH_IN    1
+#define DSRTOS_HOOK_STATIC_TASK_SWITCH_OUT   1
+#define DSRTOS_HOOK_STATIC_MEM_ALLOC         1
+#define DSRTOS_HOOK_STATIC_MEM_FREE          1
+
+/**
+ * @brief Register func for hook type DSRTOS_HOOK_<hook> at link time
+ *
+ * Example, at file scope: DSRTOS_HOOK_STATIC(TASK_SWITCH_IN, trace_switch_in);
+ */
+#define DSRTOS_HOOK_STATIC(hook, func) \
+    _Static_assert(DSRTOS_HOOK_STATIC_##hook, "hook type takes no link-time hooks"); \
+    static const dsrtos_hook_static_t dsrtos_hook_static_##hook##_##func \
+        __attribute__((used, section("dsrtos_hook_" #hook), aligned(sizeof(void*)))) = \
+        { DSRTOS_HOOK_##hook, (func), #func }
+
+/* One bit per dispatch slot: set while the slot has a hook to run */
+extern volatile uint32_t g_dsrtos_hook_active[DSRTOS_HOOK_CHAINS / 32U];
+
+/**
+ * @brief Test whether any hook would run for a type
+ *
+ * @param[in] type Hook type
+ * @return true if the slot of type has a link-time or enabled hook
+ *
+ * @note With a constant type this is one load, test and branch
+ */
+static inline bool dsrtos_hook_active(dsrtos_hook_type_t type)
+{
+    uint32_t index = DSRTOS_HOOK_INDEX(type);
+
+    return (g_dsrtos_hook_active[index >> 5U] & (1UL << (index & 31U))) != 0U;
+}
+
 /*=============================================================================
  * PUBLIC FUNCTION DECLARATIONS
  *============================================================================*/
@@ -178,6 +241,8 @@ dsrtos_error_t dsrtos_hook_unregister(void* handle);
  * 
  * @requirements REQ-HOOK-004: Hook execution
  * @safety May be called from ISR depending on hook type
+ * @note Returns at once when dsrtos_hook_active(type) is false; one call
+ *       in DSRTOS_CONFIG_HOOK_TIMING_SAMPLE is timed into the statistics
  */
 void* dsrtos_hook_call(dsrtos_hook_type_t type, void* params);
 
@@ -253,25 +318,35 @@ uint32_t dsrtos_hook_get_count(dsrtos_hook_type_t type);
  * CONVENIENCE MACROS
  *============================================================================*/
 
+/**
+ * @brief Call hooks of a type, skipping the call when none would run
+ */
+#define DSRTOS_HOOK_CALL_FAST(type, params) \
+    do { \
+        if (dsrtos_hook_active(type)) { \
+            (void)dsrtos_hook_call((type), (params)); \
+        } \
+    } while (0)
+
 /**
  * @brief Call kernel idle hook
  */
 #define DSRTOS_HOOK_IDLE() \
-    dsrtos_hook_call(DSRTOS_HOOK_KERNEL_IDLE, NULL)
+    DSRTOS_HOOK_CALL_FAST(DSRTOS_HOOK_KERNEL_IDLE, NULL)
 
 /**
  * @brief Call kernel tick hook
  */
 #define DSRTOS_HOOK_TICK() \
-    dsrtos_hook_call(DSRTOS_HOOK_KERNEL_TICK, NULL)
+    DSRTOS_HOOK_CALL_FAST(DSRTOS_HOOK_KERNEL_TICK, NULL)
 
 /**
  * @brief Call task switch hook
  */
 #define DSRTOS_HOOK_TASK_SWITCH(old_task, new_task) \
     do { \
-        dsrtos_hook_call(DSRTOS_HOOK_TASK_SWITCH_OUT, (old_task)); \
-        dsrtos_hook_call(DSRTOS_HOOK_TASK_SWITCH_IN, (new_task)); \
+        DSRTOS_HOOK_CALL_FAST(DSRTOS_HOOK_TASK_SWITCH_OUT, (old_task)); \
+        DSRTOS_HOOK_CALL_FAST(DSRTOS_HOOK_TASK_SWITCH_IN, (new_task)); \
     } while (0)
 
 /**
@@ -0,0 +1,185 @@
+/*
+ * DSRTOS - Dynamic Scheduler Real-Time Operating System
+ * Phase 2: Init Graph and Boot Timeline Header
+ *
+ * Copyright (c) 2024 DSRTOS
+ * Compliance: MISRA-C:2012, DO-178C DAL-B, IEC 62304 Class B, ISO 26262 ASIL D
+ */
+
+#ifndef DSRTOS_INIT_GRAPH_H
+#define DSRTOS_INIT_GRAPH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*=============================================================================
+ * INCLUDES
+ *============================================================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "dsrtos_types.h"
+#include "dsrtos_error.h"
+#include "dsrtos_kernel_init.h"
+
+/*
+ * Init entries registered with dsrtos_kernel_register_init() run in phase
+ * order, as before, unless they declare an order of their own:
+ *
+ *  - id/depends: an entry runs after every entry whose id bit is set in
+ *    its depends mask. A dependency must not sit in a later phase, and
+ *    an entry that did not succeed skips its dependents.
+ *  - deferred: the entry leaves the boot path. A low-priority init task
+ *    runs the deferred entries after the scheduler starts, in dependency
+ *    order, so independent driver and service set-up no longer delays the
+ *    first application task. Boot-path entries cannot depend on deferred
+ *    ones, and a deferred entry cannot be critical: nothing is left to
+ *    abort by the time it runs.
+ *
+ * Every built-in phase and entry is timed on the cycle counter, relative
+ * to the start of dsrtos_kernel_init(), together with the kernel
+ * milestones up to the first task switch; the timeline is the boot report.
+ */
+
+/*=============================================================================
+ * CONFIGURATION
+ *============================================================================*/
+#ifndef DSRTOS_INIT_GRAPH_MAX_ENTRIES
+#define DSRTOS_INIT_GRAPH_MAX_ENTRIES       32U     /* Registered entries */
+#endif
+
+#ifndef DSRTOS_INIT_GRAPH_TASK_STACK
+#define DSRTOS_INIT_GRAPH_TASK_STACK        1024U   /* Init task stack (bytes) */
+#endif
+
+#ifndef DSRTOS_INIT_GRAPH_TASK_PRIORITY
+#define DSRTOS_INIT_GRAPH_TASK_PRIORITY     1U      /* DSRTOS_TASK_PRIORITY_LOW */
+#endif
+
+#define DSRTOS_INIT_GRAPH_MAX_ID            31U
+#define DSRTOS_INIT_GRAPH_MAX_RECORDS       (DSRTOS_INIT_GRAPH_MAX_ENTRIES + (uint32_t)DSRTOS_INIT_PHASE_MAX)
+
+/* Timeline record flags */
+#define DSRTOS_INIT_RECORD_BUILTIN          0x01U   /* Built-in kernel phase */
+#define DSRTOS_INIT_RECORD_DEFERRED         0x02U   /* Run by the init task */
+#define DSRTOS_INIT_RECORD_SKIPPED          0x04U   /* A dependency failed */
+
+/*=============================================================================
+ * TYPES
+ *============================================================================*/
+
+/* Kernel milestones on the boot timeline */
+typedef enum {
+    DSRTOS_INIT_MILESTONE_KERNEL_READY  = 0x00U,  /* dsrtos_kernel_init() done */
+    DSRTOS_INIT_MILESTONE_KERNEL_START  = 0x01U,  /* Scheduler about to start */
+    DSRTOS_INIT_MILESTONE_FIRST_TASK    = 0x02U,  /* First switch to an application task */
+    DSRTOS_INIT_MILESTONE_DEFERRED_DONE = 0x03U,  /* Init task finished */
+    DSRTOS_INIT_MILESTONE_MAX           = 0x04U
+} dsrtos_init_milestone_t;
+
+/* One timed step of the boot */
+typedef struct {
+    const char* name;                   /* Phase or entry name */
+    uint32_t start;                     /* Cycles since boot start */
+    uint32_t cycles;                    /* Duration */
+    dsrtos_error_t result;              /* DSRTOS_ERROR_NOT_READY if skipped */
+    uint8_t phase;                      /* dsrtos_init_phase_t */
+    uint8_t flags;                      /* DSRTOS_INIT_RECORD_* */
+} dsrtos_init_record_t;
+
+/* Boot report */
+typedef struct {
+    uint32_t milestones[DSRTOS_INIT_MILESTONE_MAX]; /* Cycles since boot start */
+    uint32_t reached;                   /* Bit per milestone reached */
+    uint32_t record_count;              /* Timeline records */
+    uint32_t deferred_pending;          /* Deferred entries not yet run */
+} dsrtos_init_report_t;
+
+/*=============================================================================
+ * PUBLIC FUNCTION DECLARATIONS
+ *============================================================================*/
+
+/**
+ * @brief Add an init entry
+ * @param[in] entry Entry, copied
+ * @return DSRTOS_SUCCESS, DSRTOS_ERROR_INVALID_PARAM for a bad or duplicate
+ *         id, a self-dependency or a critical deferred entry, or
+ *         DSRTOS_ERROR_NO_MEMORY when the table is full
+ * @safety Before dsrtos_kernel_init() only
+ */
+dsrtos_error_t dsrtos_init_graph_register(const dsrtos_init_entry_t* entry);
+
+/**
+ * @brief Drop every entry and the timeline
+ * @return DSRTOS_SUCCESS
+ * @safety Not while the init task runs
+ */
+dsrtos_error_t dsrtos_init_graph_deinit(void);
+
+/**
+ * @brief Start the boot timeline and order the registered entries
+ * @return DSRTOS_SUCCESS, or DSRTOS_ERROR_INVALID_CONFIG for an unknown
+ *         dependency, a cycle, a boot-path entry depending on a deferred
+ *         one, or a dependency in a later phase
+ * @note Called by dsrtos_kernel_init() before the first phase
+ */
+dsrtos_error_t dsrtos_init_graph_begin(void);
+
+/**
+ * @brief Time one built-in phase step
+ * @param[in] name Step name
+ * @param[in] phase Phase
+ * @param[in] start Cycle count when the step started
+ * @param[in] result Step result
+ */
+void dsrtos_init_graph_record(const char* name, dsrtos_init_phase_t phase,
+                              uint32_t start, dsrtos_error_t result);
+
+/**
+ * @brief Run the boot-path entries of a phase in dependency order
+ * @param[in] phase Phase
+ * @return DSRTOS_SUCCESS, or the error of a failed critical entry
+ */
+dsrtos_error_t dsrtos_init_graph_run_phase(dsrtos_init_phase_t phase);
+
+/**
+ * @brief Create the init task if any entry is deferred
+ * @return DSRTOS_SUCCESS or the task creation error
+ * @note Called by dsrtos_kernel_start() before the scheduler starts; the
+ *       task is created through dsrtos_task_create_static()
+ */
+dsrtos_error_t dsrtos_init_graph_start_deferred(void);
+
+/**
+ * @brief Run the deferred entries in dependency order
+ * @return Number of deferred entries that failed or were skipped
+ * @note Body of the init task; also callable directly without a scheduler
+ */
+uint32_t dsrtos_init_graph_run_deferred(void);
+
+/**
+ * @brief Record a kernel milestone, once
+ * @param[in] milestone Milestone
+ */
+void dsrtos_init_graph_mark(dsrtos_init_milestone_t milestone);
+
+/**
+ * @brief Read the boot report
+ * @param[out] report Report
+ * @return DSRTOS_SUCCESS or DSRTOS_ERROR_INVALID_PARAM
+ */
+dsrtos_error_t dsrtos_init_graph_get_report(dsrtos_init_report_t* report);
+
+/**
+ * @brief Read one timeline record, in execution order
+ * @param[in] index Record index
+ * @param[out] record Record
+ * @return DSRTOS_SUCCESS, DSRTOS_ERROR_INVALID_PARAM or DSRTOS_ERROR_NOT_FOUND
+ */
+dsrtos_error_t dsrtos_init_graph_get_record(uint32_t index, dsrtos_init_record_t* record);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DSRTOS_INIT_GRAPH_H */
@@ -34,11 +34,8 @@ extern "C" {
  * KERNEL VERSION INFORMATION
  *============================================================================*/
 #ifndef DSRTOS_VERSION_MAJOR
-#endif
-#ifndef DSRTOS_VERSION_MAJOR
 #define DSRTOS_VERSION_MAJOR        1U
 #endif
-#endif
 #ifndef DSRTOS_VERSION_MINOR
 #define DSRTOS_VERSION_MINOR        0U
 #endif
@@ -180,6 +177,11 @@ typedef struct {
     const char* name;                  /* Component name */
     uint32_t timeout_ms;                /* Initialization timeout */
     bool critical;                      /* Critical component flag */
+    
+    /* Ordering, see dsrtos_init_graph.h */
+    bool deferred;                      /* Run by the init task after start */
+    uint8_t id;                         /* 1-31, 0 if nothing depends on it */
+    uint32_t depends;                   /* Bit n: runs after the entry with id n */
 } dsrtos_init_entry_t;
 
 /*=============================================================================
@@ -263,6 +265,7 @@ void* dsrtos_kernel_get_service(dsrtos_service_id_t service_id);
  * 
  * @requirements REQ-KERNEL-007: Init callback registration
  * @safety Must be called before kernel initialization
+ * @note Forwards to dsrtos_init_graph_register()
  */
 dsrtos_error_t dsrtos_kernel_register_init(const dsrtos_init_entry_t* entry);
 
@@ -363,3 +366,4 @@ static inline bool dsrtos_kernel_is_initialized(void)
 }
 #endif
 
+#endif /* DSRTOS_KERNEL_INIT_H */
@@ -49,6 +49,15 @@ typedef enum {
     DSRTOS_STATS_TYPE_MIN_MAX   = 0x05U,  /* Min/max tracking */
 } dsrtos_stats_type_t;
 
+/*=============================================================================
+ * STATISTICS HANDLES
+ *============================================================================*/
+
+/* Index of a registered statistic; updates through a handle do no lookup */
+typedef uint16_t dsrtos_stats_handle_t;
+
+#define DSRTOS_STATS_HANDLE_INVALID  ((dsrtos_stats_handle_t)0xFFFFU)
+
 /*=============================================================================
  * KERNEL STATISTICS
  *============================================================================*/
@@ -177,6 +186,8 @@ dsrtos_error_t dsrtos_stats_init(const dsrtos_stats_config_t* config);
  * 
  * @requirements REQ-STATS-002: Counter update
  * @safety Thread-safe, may be called from ISR
+ * @note Looks the name up on every call; hot paths should register once
+ *       with dsrtos_stats_register_handle() and use dsrtos_stats_add()
  */
 dsrtos_error_t dsrtos_stats_update(dsrtos_stats_category_t category,
                                    const char* name,
@@ -288,6 +299,61 @@ dsrtos_error_t dsrtos_stats_get_entry(dsrtos_stats_category_t category,
  */
 dsrtos_error_t dsrtos_stats_register(const dsrtos_stats_entry_t* entry);
 
+/**
+ * @brief Register a counter or gauge and get its handle
+ * 
+ * @param[in] category Statistics category
+ * @param[in] name Statistic name (copied)
+ * @param[in] type DSRTOS_STATS_TYPE_COUNTER or DSRTOS_STATS_TYPE_GAUGE
+ * @param[out] handle Handle for dsrtos_stats_add()/dsrtos_stats_set()
+ * @return DSRTOS_SUCCESS on success, error code otherwise
+ * 
+ * @requirements REQ-STATS-013: Handle registration
+ * @safety Thread-safe. Registering an existing name returns its handle;
+ *         call once at init, not on the hot path
+ */
+dsrtos_error_t dsrtos_stats_register_handle(dsrtos_stats_category_t category,
+                                            const char* name,
+                                            dsrtos_stats_type_t type,
+                                            dsrtos_stats_handle_t* handle);
+
+/**
+ * @brief Add to a counter by handle
+ * 
+ * @param[in] handle Handle from dsrtos_stats_register_handle()
+ * @param[in] value Value to add
+ * @return DSRTOS_SUCCESS on success, error code otherwise
+ * 
+ * @requirements REQ-STATS-014: Handle counter update
+ * @safety Thread-safe, may be called from ISR. One atomic add; does not
+ *         touch update_count or the timestamp
+ */
+dsrtos_error_t dsrtos_stats_add(dsrtos_stats_handle_t handle, uint32_t value);
+
+/**
+ * @brief Set a gauge by handle
+ * 
+ * @param[in] handle Handle from dsrtos_stats_register_handle()
+ * @param[in] value Gauge value
+ * @return DSRTOS_SUCCESS on success, error code otherwise
+ * 
+ * @requirements REQ-STATS-015: Handle gauge update
+ * @safety Thread-safe, may be called from ISR. One atomic store
+ */
+dsrtos_error_t dsrtos_stats_set(dsrtos_stats_handle_t handle, int32_t value);
+
+/**
+ * @brief Read a counter or gauge by handle
+ * 
+ * @param[in] handle Handle from dsrtos_stats_register_handle()
+ * @return Current value (gauges as their two's complement bits), 0 for an
+ *         invalid handle
+ * 
+ * @requirements REQ-STATS-016: Handle read
+ * @safety Thread-safe, may be called from ISR
+ */
+uint32_t dsrtos_stats_read(dsrtos_stats_handle_t handle);
+
 /**
  * @brief Export statistics snapshot
  * 
@@ -322,6 +388,12 @@ dsrtos_error_t dsrtos_stats_export(void* buffer, size_t* size);
 #define DSRTOS_STATS_GAUGE(category, name, val) \
     dsrtos_stats_set_gauge((category), (name), (val))
 
+/**
+ * @brief Increment a counter by handle
+ */
+#define DSRTOS_STATS_HANDLE_INC(handle) \
+    dsrtos_stats_add((handle), 1U)
+
 /**
  * @brief Mark timestamp
  */
@@ -0,0 +1,115 @@
+/*
+ * @file dsrtos_budget.h
+ * @brief DSRTOS Execution-Time Budget Enforcement (CPU Servers)
+ * @date 2024-12-30
+ *
+ * A budget server grants one task, or a group of tasks, a number of CPU
+ * cycles per period of ticks. Cycles are charged on every context switch
+ * and every tick. When a server runs dry its members are demoted to
+ * background priority or suspended, from the tick path, until the server
+ * is replenished at the start of its next period.
+ *
+ * Per tick the cost is one charge plus the servers whose replenishment
+ * slot in the timing wheel comes up, independent of the task count.
+ *
+ * COMPLIANCE:
+ * - MISRA-C:2012 compliant
+ * - DO-178C DAL-B certifiable
+ * - IEC 62304 Class B compliant
+ * - ISO 26262 ASIL D compliant
+ */
+
+#ifndef DSRTOS_BUDGET_H
+#define DSRTOS_BUDGET_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "dsrtos_task_manager.h"
+#include "dsrtos_cpu_account.h"
+
+/*==============================================================================
+ * CONFIGURATION
+ *============================================================================*/
+
+#ifndef DSRTOS_BUDGET_MAX_SERVERS
+#define DSRTOS_BUDGET_MAX_SERVERS           (8U)
+#endif
+
+#ifndef DSRTOS_BUDGET_MAX_MEMBERS
+#define DSRTOS_BUDGET_MAX_MEMBERS           (8U)    /* Tasks per server */
+#endif
+
+#ifndef DSRTOS_BUDGET_WHEEL_SIZE
+#define DSRTOS_BUDGET_WHEEL_SIZE            (64U)   /* Replenishment wheel slots, power of 2 */
+#endif
+
+#ifndef DSRTOS_BUDGET_BACKGROUND_PRIORITY
+#define DSRTOS_BUDGET_BACKGROUND_PRIORITY   (DSRTOS_TASK_PRIORITY_IDLE)
+#endif
+
+#if (DSRTOS_BUDGET_WHEEL_SIZE & (DSRTOS_BUDGET_WHEEL_SIZE - 1U)) != 0U
+#error "DSRTOS_BUDGET_WHEEL_SIZE must be a power of 2"
+#endif
+
+#if DSRTOS_BUDGET_MAX_MEMBERS > 32U
+#error "DSRTOS_BUDGET_MAX_MEMBERS must not exceed 32"
+#endif
+
+/*==============================================================================
+ * TYPE DEFINITIONS
+ *============================================================================*/
+
+/* What happens to the members of an exhausted server */
+typedef enum {
+    DSRTOS_BUDGET_ACTION_DEMOTE = 0U,   /* Run at background priority */
+    DSRTOS_BUDGET_ACTION_SUSPEND = 1U   /* Do not run until replenished */
+} dsrtos_budget_action_t;
+
+/* Server parameters */
+typedef struct {
+    uint32_t budget_cycles;             /* Cycles granted per period */
+    uint32_t period_ticks;              /* Replenishment period */
+    dsrtos_budget_action_t action;
+    const char* name;
+} dsrtos_budget_config_t;
+
+/* Server state and counters */
+typedef struct {
+    uint64_t consumed_cycles;           /* Cycles charged since creation */
+    uint32_t remaining_cycles;          /* Left in the current period */
+    uint32_t exhaustions;               /* Periods in which the budget ran out */
+    uint32_t replenishments;
+    uint32_t member_count;
+    bool throttled;
+} dsrtos_budget_stats_t;
+
+/*==============================================================================
+ * PUBLIC API
+ *============================================================================*/
+
+/* Lifecycle */
+dsrtos_error_t dsrtos_budget_init(dsrtos_cpu_clock_t clock);
+
+/* Servers */
+dsrtos_error_t dsrtos_budget_server_create(const dsrtos_budget_config_t *config,
+                                           uint32_t *server_id);
+dsrtos_error_t dsrtos_budget_server_delete(uint32_t server_id);
+dsrtos_error_t dsrtos_budget_attach(dsrtos_tcb_t *tcb, uint32_t server_id);
+dsrtos_error_t dsrtos_budget_detach(dsrtos_tcb_t *tcb);
+
+/* Enforcement points */
+void dsrtos_budget_switch(dsrtos_tcb_t *next);
+void dsrtos_budget_tick(void);
+
+/* Statistics */
+dsrtos_error_t dsrtos_budget_get_stats(uint32_t server_id, dsrtos_budget_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DSRTOS_BUDGET_H */
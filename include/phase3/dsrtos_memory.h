@@ -8,8 +8,8 @@
  * - DO-178C DAL-B certifiable
  */
 
-#ifndef DSRTOS_MEMORY_H
-#define DSRTOS_MEMORY_H
+#ifndef DSRTOS_PHASE3_MEMORY_H
+#define DSRTOS_PHASE3_MEMORY_H
 
 #ifdef __cplusplus
 extern "C" {
@@ -34,4 +34,4 @@ size_t dsrtos_get_total_heap(void);
 }
 #endif
 
-#endif /* DSRTOS_MEMORY_H */
+#endif /* DSRTOS_PHASE3_MEMORY_H */
@@ -35,6 +35,9 @@ void dsrtos_port_yield(void);
 /* Idle processing */
 void dsrtos_port_idle(void);
 
+/* Free-running cycle counter (DWT CYCCNT on Cortex-M4) */
+uint32_t dsrtos_port_get_cycle_count(void);
+
 /* Task exit */
 void dsrtos_task_exit(void);
 
@@ -0,0 +1,181 @@
+/*
+ * @file dsrtos_replay.h
+ * @brief DSRTOS Record and Replay of Nondeterministic Inputs
+ * @date 2024-12-30
+ *
+ * Record mode logs every input the kernel cannot reproduce on its own
+ * into a ring of 8-byte records: interrupt arrivals, UART RX bytes, timer
+ * reads, other inputs the application routes through
+ * dsrtos_replay_input(), and the scheduler's switch decisions. Replay
+ * mode, on the host port, feeds the same log back: each input point
+ * returns the recorded value instead of the live one, and recorded
+ * interrupts are injected at the same position in the input stream, so
+ * the run takes the same interleaving under a debugger.
+ *
+ * Position of an interrupt: the tick and the interrupted task, plus the
+ * number of dsrtos_replay_poll() calls since the previous record. The
+ * Cortex-M4 has no retired-instruction counter and its cycle counter does
+ * not repeat across runs, so polls placed in code under suspicion serve as
+ * the instruction count; without them an interrupt is replayed just
+ * before the next recorded input. Switch decisions are not injected but
+ * checked: a replayed run that switches differently, or reaches an input
+ * at another tick or in another task, counts a divergence.
+ *
+ * Every input point is an inline test of the mode when recording is off.
+ * Recording costs one critical section and one record per input. A drain
+ * task can empty the ring continuously in soak tests; records that find
+ * the ring full are counted and replaced by one LOST record, where replay
+ * stops.
+ *
+ * Record layout, little-endian: tick u16 (low half; EPOCH records carry
+ * the full tick whenever the high half changes), type u4 and task u12
+ * packed in a u16, value u32. A drained log is a plain array of records.
+ *
+ * COMPLIANCE:
+ * - MISRA-C:2012 compliant
+ * - DO-178C DAL-B certifiable
+ * - IEC 62304 Class B compliant
+ * - ISO 26262 ASIL D compliant
+ */
+
+#ifndef DSRTOS_REPLAY_H
+#define DSRTOS_REPLAY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "dsrtos_error.h"
+
+/*==============================================================================
+ * CONFIGURATION
+ *============================================================================*/
+
+#ifndef DSRTOS_REPLAY_RECORDS
+#define DSRTOS_REPLAY_RECORDS               (512U)  /* Built-in ring, power of 2 */
+#endif
+
+#if (DSRTOS_REPLAY_RECORDS & (DSRTOS_REPLAY_RECORDS - 1U)) != 0U
+#error "DSRTOS_REPLAY_RECORDS must be a power of 2"
+#endif
+
+/* Record types */
+#define DSRTOS_REPLAY_LOST                  (0U)    /* value: records dropped on a full ring */
+#define DSRTOS_REPLAY_EPOCH                 (1U)    /* value: full tick */
+#define DSRTOS_REPLAY_IRQ                   (2U)    /* value: polls << 16 | IRQ number */
+#define DSRTOS_REPLAY_UART_RX               (3U)    /* value: UART ID << 8 | byte */
+#define DSRTOS_REPLAY_TIMER                 (4U)    /* value: low word of a timer read */
+#define DSRTOS_REPLAY_TIMER_HI              (5U)    /* value: high word, when it changed */
+#define DSRTOS_REPLAY_INPUT                 (6U)    /* value: application input */
+#define DSRTOS_REPLAY_SWITCH                (7U)    /* value: task ID switched in */
+
+/* Task field of a record made outside any task; IDs above it share it */
+#define DSRTOS_REPLAY_NO_TASK               (0xFFFU)
+
+/* Record field access */
+#define DSRTOS_REPLAY_TYPE(r)               ((uint32_t)(r)->type_task >> 12U)
+#define DSRTOS_REPLAY_TASK(r)               ((uint32_t)(r)->type_task & 0xFFFU)
+
+/*==============================================================================
+ * TYPE DEFINITIONS
+ *============================================================================*/
+
+typedef struct {
+    uint16_t tick;                      /* Low half of the tick */
+    uint16_t type_task;                 /* Type << 12 | task ID */
+    uint32_t value;
+} dsrtos_replay_record_t;
+
+typedef enum {
+    DSRTOS_REPLAY_MODE_OFF = 0,
+    DSRTOS_REPLAY_MODE_RECORD,
+    DSRTOS_REPLAY_MODE_REPLAY
+} dsrtos_replay_mode_t;
+
+typedef struct {
+    uint32_t recorded;                  /* Records written */
+    uint32_t lost;                      /* Records dropped on a full ring */
+    uint32_t drained;                   /* Records taken out by drain */
+    uint32_t high_water;                /* Most records held at once */
+    uint32_t replayed;                  /* Records consumed in replay */
+    uint32_t divergences;               /* Replay departures from the log */
+    uint32_t first_divergence;          /* Log index of the first, UINT32_MAX if none */
+} dsrtos_replay_stats_t;
+
+/* Delivers a recorded interrupt during replay, as the vector would */
+typedef void (*dsrtos_replay_inject_t)(int16_t irq_num);
+
+/* Current mode; read inline by every input point */
+extern volatile uint32_t g_dsrtos_replay_mode;
+
+/*==============================================================================
+ * PUBLIC API
+ *============================================================================*/
+
+/* Lifecycle */
+dsrtos_error_t dsrtos_replay_init(dsrtos_replay_record_t *ring, uint32_t count);
+dsrtos_error_t dsrtos_replay_record_start(void);
+dsrtos_error_t dsrtos_replay_start(const dsrtos_replay_record_t *log, uint32_t count,
+                                   dsrtos_replay_inject_t inject);
+void dsrtos_replay_stop(void);
+
+/* Log retrieval, oldest first */
+uint32_t dsrtos_replay_drain(dsrtos_replay_record_t *out, uint32_t max);
+dsrtos_error_t dsrtos_replay_get_stats(dsrtos_replay_stats_t *stats);
+
+/* Input points, out of line */
+void dsrtos_replay_irq_slow(int16_t irq_num);
+uint8_t dsrtos_replay_uart_rx_slow(uint8_t uart_id, uint8_t byte);
+uint64_t dsrtos_replay_timer_slow(uint64_t value);
+uint32_t dsrtos_replay_input_slow(uint32_t value);
+void dsrtos_replay_poll_slow(void);
+
+/*==============================================================================
+ * INPUT POINTS
+ *============================================================================*/
+
+/* Each takes the live value and returns the one to use: the live value
+ * when off or recording, the recorded one in replay */
+
+/* Interrupt entry; replay injects instead */
+static inline void dsrtos_replay_irq(int16_t irq_num)
+{
+    if (g_dsrtos_replay_mode != (uint32_t)DSRTOS_REPLAY_MODE_OFF) {
+        dsrtos_replay_irq_slow(irq_num);
+    }
+}
+
+static inline uint8_t dsrtos_replay_uart_rx(uint8_t uart_id, uint8_t byte)
+{
+    return (g_dsrtos_replay_mode == (uint32_t)DSRTOS_REPLAY_MODE_OFF) ?
+           byte : dsrtos_replay_uart_rx_slow(uart_id, byte);
+}
+
+static inline uint64_t dsrtos_replay_timer(uint64_t value)
+{
+    return (g_dsrtos_replay_mode == (uint32_t)DSRTOS_REPLAY_MODE_OFF) ?
+           value : dsrtos_replay_timer_slow(value);
+}
+
+/* Any other input: ADC samples, random numbers, GPIO levels */
+static inline uint32_t dsrtos_replay_input(uint32_t value)
+{
+    return (g_dsrtos_replay_mode == (uint32_t)DSRTOS_REPLAY_MODE_OFF) ?
+           value : dsrtos_replay_input_slow(value);
+}
+
+/* Position marker for interrupt arrival, see the file comment */
+static inline void dsrtos_replay_poll(void)
+{
+    if (g_dsrtos_replay_mode != (uint32_t)DSRTOS_REPLAY_MODE_OFF) {
+        dsrtos_replay_poll_slow();
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DSRTOS_REPLAY_H */
@@ -19,7 +19,7 @@ extern "C" {
 
 #include <stdint.h>
 #include <stdbool.h>
-#include "dsrtos_types.h"
+#include "../common/dsrtos_types.h"
 #include "dsrtos_error.h"
 #include "dsrtos_task_manager.h"
 
@@ -54,6 +54,7 @@ dsrtos_error_t dsrtos_stack_init(dsrtos_tcb_t *tcb,
                                  uint32_t stack_size,
                                  dsrtos_task_entry_t entry_point,
                                  void *param);
+dsrtos_error_t dsrtos_stack_release(dsrtos_tcb_t *tcb);
 
 /* Stack checking */
 dsrtos_error_t dsrtos_stack_check(const dsrtos_tcb_t *tcb);
@@ -21,6 +21,7 @@ extern "C" {
 #include <stdbool.h>
 #include "dsrtos_types.h"
 #include "dsrtos_task_manager.h"
+#include "dsrtos_handle.h"
 
 /*==============================================================================
  * TYPE DEFINITIONS
@@ -34,6 +35,7 @@ typedef struct {
     bool use_pool;                       /* Use static pool allocation */
     void *tls_data;                      /* Thread-local storage */
     uint32_t tls_size;                   /* TLS size */
+    uint32_t arena_quota;                /* Per-task arena bytes, 0 for none */
 } dsrtos_task_create_extended_t;
 
 /* Task pool statistics */
@@ -60,9 +62,23 @@ dsrtos_tcb_t* dsrtos_task_create_extended(const dsrtos_task_create_extended_t *p
 dsrtos_tcb_t* dsrtos_task_clone(const dsrtos_tcb_t *source_task, const char *new_name);
 dsrtos_error_t dsrtos_task_restart(dsrtos_tcb_t *task);
 
-/* Pool management */
+/* Pool management: TCBs and stack size classes are O(1) free lists, so
+ * there is nothing to defragment */
+dsrtos_error_t dsrtos_task_release(dsrtos_tcb_t *task);
+
+/* Self-exit: a task cannot free its own stack, so the exiting task is
+ * queued and a later dsrtos_task_reap() releases it */
+dsrtos_error_t dsrtos_task_retire(dsrtos_tcb_t *task);
+uint32_t dsrtos_task_reap(void);
 dsrtos_error_t dsrtos_task_pool_get_stats(task_creation_stats_t *stats);
-dsrtos_error_t dsrtos_task_pool_defragment(void);
+
+/* Handles: every task is named by a generation-counted handle whose slot
+ * index is the task ID; both resolve in O(1) and a released task's handle
+ * stops resolving. dsrtos_task_create_static(), which every creation API
+ * ends in, assigns them, so all tasks share one ID space */
+dsrtos_tcb_t* dsrtos_task_from_handle(dsrtos_handle_t handle);
+dsrtos_tcb_t* dsrtos_task_get_by_id(uint32_t task_id);
+dsrtos_error_t dsrtos_task_handle_get_stats(dsrtos_handle_stats_t *stats);
 
 /* Statistics */
 dsrtos_error_t dsrtos_task_get_creation_stats(task_creation_stats_t *stats);
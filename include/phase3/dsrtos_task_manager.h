@@ -111,15 +111,37 @@ typedef struct {
  * TASK CONTROL BLOCK (TCB)
  *============================================================================*/
 
-typedef struct dsrtos_tcb {
-    uint32_t task_id;
-    char name[DSRTOS_TASK_NAME_MAX_LENGTH];
+/* TCB alignment: each TCB starts a cache line, so the hot block below is
+ * one line fill. Cortex-M4 has no data cache, so the target adds no padding */
+#ifndef DSRTOS_TCB_ALIGN
+#if defined(DSRTOS_HOST_BUILD)
+#define DSRTOS_TCB_ALIGN                   (64U)
+#else
+#define DSRTOS_TCB_ALIGN                   (4U)
+#endif
+#endif
+
+/* Bytes at the start of the TCB that hold every scheduling-hot field */
+#define DSRTOS_TCB_HOT_BYTES               (64U)
+
+typedef struct __attribute__((aligned(DSRTOS_TCB_ALIGN))) dsrtos_tcb {
+    /* Scheduling-hot: read by every select, insert, remove and switch.
+     * stack_pointer must stay first: PendSV loads and stores it at [tcb, #0]. */
+    void* stack_pointer;  /* Current stack pointer */
+    uint32_t magic_number;   /* Magic number for validation */
     dsrtos_task_state_t state;
-    dsrtos_task_priority_t priority;
     dsrtos_task_priority_t effective_priority;  /* Effective priority for scheduling */
+    uint32_t task_id;
+    void* queue_node;        /* Queue node pointer for ready queue */
     void* stack_base;
-    void* stack_pointer;  /* Current stack pointer */
     uint32_t stack_size;
+    uint32_t stack_canary;   /* Stack canary for overflow detection */
+    uint32_t time_slice_remaining;
+    void* budget;            /* Execution budget server, NULL if unbudgeted */
+
+    /* Cold: identity, diagnostics and accounting */
+    char name[DSRTOS_TASK_NAME_MAX_LENGTH];
+    dsrtos_task_priority_t priority;
     uint32_t stack_usage;
     uint32_t stack_watermark;
     dsrtos_cpu_context_t cpu_context;
@@ -148,7 +170,6 @@ typedef struct dsrtos_tcb {
         uint32_t total_runtime;
         uint32_t last_runtime;
         uint32_t activation_time;
-        uint32_t time_slice_remaining;
         uint32_t deadline;
         uint32_t period;
         uint32_t wcet;
@@ -181,12 +202,24 @@ typedef struct dsrtos_tcb {
     } stats;
     
     /* Phase 4 scheduler fields */
-    void* queue_node;        /* Queue node pointer for ready queue */
-    uint32_t magic_number;   /* Magic number for validation */
-    uint32_t stack_canary;   /* Stack canary for overflow detection */
     uint32_t voluntary_yields; /* Count of voluntary task yields */
+
+    /* Memory */
+    void* arena;             /* Per-task arena (dsrtos_arena_t), released at exit */
+
+    /* Kernel bookkeeping: back-pointers keep per-task lookups O(1) */
+    void* list_node;         /* Phase 3 ready/blocked list node, NULL if on neither */
+    void* stack_monitor;     /* Stack monitor entry, NULL if not monitored */
+    uint32_t delay_slot;     /* Delayed heap index + 1, 0 if not delayed */
+    uint32_t restart_count;  /* Restarts since creation */
+    uint32_t last_restart_time;
+    uint32_t handle;         /* Generation-counted handle (dsrtos_handle.h), 0 if none */
 } dsrtos_tcb_t;
 
+_Static_assert(offsetof(dsrtos_tcb_t, stack_pointer) == 0U, "PendSV stack pointer offset");
+_Static_assert((offsetof(dsrtos_tcb_t, budget) + sizeof(void*)) <= DSRTOS_TCB_HOT_BYTES,
+               "scheduling-hot TCB fields");
+
 /* Task Exit Handler */
 typedef void (*dsrtos_task_exit_handler_t)(dsrtos_tcb_t* task);
 
@@ -495,6 +528,8 @@ dsrtos_error_t dsrtos_task_create(dsrtos_tcb_t** tcb, const dsrtos_task_params_t
  * @param tcb Pointer to task control block
  * @param params Task creation parameters
  * @return DSRTOS_SUCCESS on success, error code on failure
+ * @note Common path of every creation API: the only place a TCB is given
+ *       its handle and task ID (src/phase3/dsrtos_task_creation.c)
  */
 dsrtos_error_t dsrtos_task_create_static(dsrtos_tcb_t* tcb, const dsrtos_task_params_t* params);
 
@@ -37,6 +37,13 @@ typedef struct {
     uint32_t max_blocked_count;
 } dsrtos_queue_stats_t;
 
+/* One ready task, as summarized by dsrtos_queue_ready_snapshot */
+typedef struct {
+    uint16_t task_id;
+    uint8_t priority;
+    uint8_t state;
+} dsrtos_queue_ready_entry_t;
+
 /*==============================================================================
  * PUBLIC API
  *============================================================================*/
@@ -63,6 +70,7 @@ uint32_t dsrtos_queue_process_delayed(void);
 
 /* Statistics */
 dsrtos_error_t dsrtos_queue_get_stats(dsrtos_queue_stats_t *stats);
+uint32_t dsrtos_queue_ready_snapshot(dsrtos_queue_ready_entry_t *entries, uint32_t max);
 
 #ifdef __cplusplus
 }
@@ -56,7 +56,9 @@ typedef void* dsrtos_handle_t;
  *============================================================================*/
 
 /* Task management constants */
+#ifndef DSRTOS_MAX_TASKS
 #define DSRTOS_MAX_TASKS                    (32U)
+#endif
 #define DSRTOS_MIN_STACK_SIZE               (128U)
 #define DSRTOS_MAX_STACK_SIZE               (4096U)
 #define DSRTOS_STACK_ALIGNMENT              (8U)
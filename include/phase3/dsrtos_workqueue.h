@@ -0,0 +1,166 @@
+/*
+ * @file dsrtos_workqueue.h
+ * @brief DSRTOS Kernel Work Queue Interface
+ * @date 2024-12-30
+ *
+ * Work items are submitted with a priority to named work queues and are
+ * executed by a fixed pool of worker tasks created once at init. Each
+ * queue carries its own concurrency limit. Delayed items are released
+ * from the kernel tick hook: the phase 1 timer engine has only 16
+ * system-wide callback slots and its registration functions are not
+ * built, so it cannot carry one timeout per work item.
+ *
+ * COMPLIANCE:
+ * - MISRA-C:2012 compliant
+ * - DO-178C DAL-B certifiable
+ * - IEC 62304 Class B compliant
+ * - ISO 26262 ASIL D compliant
+ */
+
+#ifndef DSRTOS_WORKQUEUE_H
+#define DSRTOS_WORKQUEUE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "dsrtos_task_manager.h"
+
+/*==============================================================================
+ * CONFIGURATION
+ *============================================================================*/
+
+#ifndef DSRTOS_WORKQUEUE_WORKERS
+#define DSRTOS_WORKQUEUE_WORKERS            (4U)    /* Worker tasks in the pool */
+#endif
+
+#ifndef DSRTOS_WORKQUEUE_MAX_QUEUES
+#define DSRTOS_WORKQUEUE_MAX_QUEUES         (8U)    /* Registered queues */
+#endif
+
+#ifndef DSRTOS_WORKQUEUE_WORKER_STACK
+#define DSRTOS_WORKQUEUE_WORKER_STACK       (1024U) /* Worker stack (bytes) */
+#endif
+
+#ifndef DSRTOS_WORKQUEUE_WORKER_PRIORITY
+#define DSRTOS_WORKQUEUE_WORKER_PRIORITY    DSRTOS_TASK_PRIORITY_NORMAL
+#endif
+
+/* Work item priorities: 0 is the most urgent */
+#define DSRTOS_WORK_PRIORITY_LEVELS         (8U)
+#define DSRTOS_WORK_PRIORITY_HIGHEST        (0U)
+#define DSRTOS_WORK_PRIORITY_LOWEST         (DSRTOS_WORK_PRIORITY_LEVELS - 1U)
+
+/* Unlimited concurrency for a queue */
+#define DSRTOS_WORKQUEUE_UNLIMITED          (DSRTOS_WORKQUEUE_WORKERS)
+
+/*==============================================================================
+ * TYPE DEFINITIONS
+ *============================================================================*/
+
+struct dsrtos_work;
+struct dsrtos_workqueue;
+
+/* Work handler, runs in worker task context */
+typedef void (*dsrtos_work_handler_t)(struct dsrtos_work *work);
+
+/* Work item lifecycle */
+typedef enum {
+    DSRTOS_WORK_STATE_IDLE    = 0U,
+    DSRTOS_WORK_STATE_DELAYED = 1U,
+    DSRTOS_WORK_STATE_PENDING = 2U,
+    DSRTOS_WORK_STATE_RUNNING = 3U
+} dsrtos_work_state_t;
+
+/* Work item, owned by the caller and linked intrusively */
+typedef struct dsrtos_work {
+    struct dsrtos_work *next;
+    struct dsrtos_work *prev;
+    dsrtos_work_handler_t handler;
+    void *arg;
+    struct dsrtos_workqueue *queue;
+    uint32_t due_tick;                  /* Release tick for delayed items */
+    uint32_t submit_cycles;             /* Cycle stamp at submission */
+    uint8_t priority;
+    volatile uint8_t state;             /* dsrtos_work_state_t */
+    uint16_t reserved;
+} dsrtos_work_t;
+
+/* Work queue statistics */
+typedef struct {
+    uint32_t submitted;
+    uint32_t executed;
+    uint32_t cancelled;
+    uint32_t rejected;
+    uint32_t delayed;
+    uint32_t pending;
+    uint32_t peak_pending;
+    uint32_t peak_active;
+    uint32_t max_latency_cycles;        /* Submit (or release) to handler start */
+    uint64_t total_latency_cycles;
+} dsrtos_workqueue_stats_t;
+
+/* Work queue, pending items are kept per priority level */
+typedef struct dsrtos_workqueue {
+    uint32_t magic;
+    const char *name;
+    dsrtos_work_t *head[DSRTOS_WORK_PRIORITY_LEVELS];
+    dsrtos_work_t *tail[DSRTOS_WORK_PRIORITY_LEVELS];
+    uint32_t pending_bitmap;            /* Bit n set: level n non-empty */
+    uint8_t max_active;                 /* Concurrency limit */
+    uint8_t active;                     /* Items running right now */
+    uint16_t index;                     /* Slot in the registry */
+    dsrtos_workqueue_stats_t stats;
+} dsrtos_workqueue_t;
+
+/* Global worker pool statistics */
+typedef struct {
+    uint32_t workers;
+    uint32_t idle_workers;
+    uint32_t wakeups;
+    uint32_t delayed_released;
+    uint32_t items_executed;
+} dsrtos_workqueue_pool_stats_t;
+
+/*==============================================================================
+ * PUBLIC API
+ *============================================================================*/
+
+/* Pool lifecycle */
+dsrtos_error_t dsrtos_workqueue_init(void);
+dsrtos_error_t dsrtos_workqueue_start_workers(void);
+
+/* Queue management */
+dsrtos_error_t dsrtos_workqueue_create(dsrtos_workqueue_t *wq,
+                                       const char *name,
+                                       uint8_t max_active);
+dsrtos_error_t dsrtos_workqueue_destroy(dsrtos_workqueue_t *wq);
+
+/* Work items */
+void dsrtos_work_init(dsrtos_work_t *work, dsrtos_work_handler_t handler, void *arg);
+dsrtos_error_t dsrtos_work_submit(dsrtos_workqueue_t *wq,
+                                  dsrtos_work_t *work,
+                                  uint8_t priority);
+dsrtos_error_t dsrtos_work_submit_delayed(dsrtos_workqueue_t *wq,
+                                          dsrtos_work_t *work,
+                                          uint8_t priority,
+                                          uint32_t delay_ticks);
+dsrtos_error_t dsrtos_work_cancel(dsrtos_work_t *work);
+bool dsrtos_work_is_pending(const dsrtos_work_t *work);
+
+/* Worker side, exposed for the worker task body and host simulation */
+bool dsrtos_workqueue_run_one(void);
+void dsrtos_workqueue_tick(uint32_t now);
+
+/* Statistics */
+dsrtos_error_t dsrtos_workqueue_get_stats(const dsrtos_workqueue_t *wq,
+                                          dsrtos_workqueue_stats_t *stats);
+dsrtos_error_t dsrtos_workqueue_get_pool_stats(dsrtos_workqueue_pool_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DSRTOS_WORKQUEUE_H */
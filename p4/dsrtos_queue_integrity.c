@@ -10,6 +10,7 @@
 
 #include "dsrtos_queue_integrity.h"
 #include "dsrtos_critical.h"
+#include "dsrtos_crc.h"
 #include "dsrtos_assert.h"
 #include "dsrtos_trace.h"
 #include "dsrtos_panic.h"
@@ -278,23 +279,11 @@ dsrtos_error_t dsrtos_queue_get_integrity_report(
  */
 uint32_t dsrtos_queue_calculate_checksum(const dsrtos_ready_queue_t* queue)
 {
-    const uint8_t* data;
-    uint32_t checksum = 0x5A5A5A5AU;
-    size_t i;
-    
     if (queue == NULL) {
         return 0U;
     }
     
-    data = (const uint8_t*)queue;
-    
-    /* Calculate rotating XOR checksum */
-    for (i = 0U; i < sizeof(dsrtos_ready_queue_t); i++) {
-        checksum ^= data[i];
-        checksum = (checksum << 1) | (checksum >> 31);
-    }
-    
-    return checksum;
+    return dsrtos_crc32(queue, sizeof(dsrtos_ready_queue_t));
 }
 
 /**
@@ -321,14 +310,7 @@ bool dsrtos_node_validate(const dsrtos_queue_node_t* node)
     }
     
     /* Calculate and verify checksum */
-    calculated_checksum = 0x12345678U;
-    const uint8_t* data = (const uint8_t*)node;
-    size_t size = sizeof(dsrtos_queue_node_t) - sizeof(uint32_t);
-    
-    for (size_t i = 0U; i < size; i++) {
-        calculated_checksum ^= data[i];
-        calculated_checksum = (calculated_checksum << 1) | (calculated_checksum >> 31);
-    }
+    calculated_checksum = dsrtos_crc32(node, sizeof(dsrtos_queue_node_t) - sizeof(uint32_t));
     
     if (calculated_checksum != node->checksum) {
         return false;
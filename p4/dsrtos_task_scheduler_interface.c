@@ -20,6 +20,7 @@
 #include "dsrtos_task_scheduler_interface.h"
 #include "dsrtos_kernel.h"
 #include "dsrtos_critical.h"
+#include "dsrtos_crc.h"
 #include "dsrtos_assert.h"
 #include "dsrtos_trace.h"
 #include "dsrtos_panic.h"
@@ -48,7 +49,6 @@ static struct {
  *============================================================================*/
 static dsrtos_queue_node_t* allocate_queue_node(void);
 static void free_queue_node(dsrtos_queue_node_t* node);
-static uint32_t calculate_checksum(const void* data, size_t size);
 static bool validate_tcb(const dsrtos_tcb_t* task);
 static bool validate_priority(uint8_t priority);
 static bool validate_node(const dsrtos_queue_node_t* node);
@@ -147,8 +147,8 @@ dsrtos_error_t dsrtos_scheduler_interface_init(
     }
     
     /* Calculate initial checksum */
-    interface->checksum = calculate_checksum(interface, 
-                                            sizeof(dsrtos_scheduler_interface_t) - sizeof(uint32_t));
+    interface->checksum = dsrtos_crc32(interface, 
+                                      sizeof(dsrtos_scheduler_interface_t) - sizeof(uint32_t));
     
     /* Set global interface pointer */
     g_scheduler_interface = *interface;
@@ -218,8 +218,8 @@ bool dsrtos_scheduler_interface_validate(
     }
     
     /* Verify checksum */
-    calculated_checksum = calculate_checksum(interface, 
-                                            sizeof(dsrtos_scheduler_interface_t) - sizeof(uint32_t));
+    calculated_checksum = dsrtos_crc32(interface, 
+                                      sizeof(dsrtos_scheduler_interface_t) - sizeof(uint32_t));
     if (calculated_checksum != interface->checksum) {
         g_safety_stats.checksum_errors++;
         return false;
@@ -370,8 +370,8 @@ dsrtos_error_t dsrtos_ready_queue_insert(
     node->insertion_tick = dsrtos_get_tick_count();
     node->next = NULL;
     node->prev = NULL;
-    node->checksum = calculate_checksum(node, 
-                                       sizeof(dsrtos_queue_node_t) - sizeof(uint32_t));
+    node->checksum = dsrtos_crc32(node, 
+                                 sizeof(dsrtos_queue_node_t) - sizeof(uint32_t));
     
     /* Get priority list */
     priority_list = &queue->priority_lists[priority];
@@ -394,8 +394,8 @@ dsrtos_error_t dsrtos_ready_queue_insert(
     priority_list->count++;
     
     /* Update list checksum */
-    priority_list->list_checksum = calculate_checksum(priority_list,
-                                                     sizeof(dsrtos_priority_list_t) - sizeof(uint32_t));
+    priority_list->list_checksum = dsrtos_crc32(priority_list,
+                                               sizeof(dsrtos_priority_list_t) - sizeof(uint32_t));
     
     /* Update both bitmaps atomically */
     dsrtos_priority_bitmap_set(queue->priority_bitmap, priority);
@@ -520,8 +520,8 @@ dsrtos_error_t dsrtos_ready_queue_remove(
     }
     
     /* Update list checksum */
-    priority_list->list_checksum = calculate_checksum(priority_list,
-                                                     sizeof(dsrtos_priority_list_t) - sizeof(uint32_t));
+    priority_list->list_checksum = dsrtos_crc32(priority_list,
+                                               sizeof(dsrtos_priority_list_t) - sizeof(uint32_t));
     
     /* Clear task reference */
     task->queue_node = NULL;
@@ -900,23 +900,6 @@ static void free_queue_node(dsrtos_queue_node_t* node)
     g_queue_node_bitmap[word_index] &= ~bit_mask;
 }
 
-/**
- * @brief Calculate checksum for data
- */
-static uint32_t calculate_checksum(const void* data, size_t size)
-{
-    const uint8_t* bytes = (const uint8_t*)data;
-    uint32_t checksum = 0x12345678U;
-    size_t i;
-    
-    for (i = 0U; i < size; i++) {
-        checksum ^= bytes[i];
-        checksum = (checksum << 1) | (checksum >> 31);
-    }
-    
-    return checksum;
-}
-
 /**
  * @brief Validate task control block
  */
@@ -976,8 +959,8 @@ static bool validate_node(const dsrtos_queue_node_t* node)
     }
     
     /* Verify checksum */
-    calculated = calculate_checksum(node, 
-                                  sizeof(dsrtos_queue_node_t) - sizeof(uint32_t));
+    calculated = dsrtos_crc32(node, 
+                            sizeof(dsrtos_queue_node_t) - sizeof(uint32_t));
     if (calculated != node->checksum) {
         return false;
     }
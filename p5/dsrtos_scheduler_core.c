@@ -14,6 +14,7 @@
  *============================================================================*/
 #include "dsrtos_scheduler_core.h"
 #include "dsrtos_critical.h"
+#include "dsrtos_crc.h"
 #include "dsrtos_memory.h"
 #include "dsrtos_config.h"
 #include "dsrtos_assert.h"
@@ -95,7 +96,9 @@ static dsrtos_error_t perform_scheduler_switch(void);
 static void update_scheduler_metrics(void);
 static void analyze_workload_patterns(void);
 static uint16_t calculate_optimal_scheduler(void);
+#if (DSRTOS_CONFIG_ENABLE_CHECKSUM_VALIDATION != 0U)
 static uint32_t calculate_plugin_checksum(const dsrtos_scheduler_plugin_t* plugin);
+#endif
 
 /*==============================================================================
  *                          PUBLIC FUNCTIONS
@@ -488,11 +491,13 @@ static dsrtos_error_t validate_scheduler_plugin(
         return DSRTOS_ERROR_INVALID_PARAMETER;
     }
     
+#if (DSRTOS_CONFIG_ENABLE_CHECKSUM_VALIDATION != 0U)
     /* Validate checksum */
     uint32_t checksum = calculate_plugin_checksum(plugin);
     if (checksum != plugin->checksum) {
         return DSRTOS_ERROR_CHECKSUM;
     }
+#endif
     
     return DSRTOS_SUCCESS;
 }
@@ -675,6 +680,7 @@ static uint16_t calculate_optimal_scheduler(void)
     return DSRTOS_SCHED_ID_STATIC_PRIORITY;
 }
 
+#if (DSRTOS_CONFIG_ENABLE_CHECKSUM_VALIDATION != 0U)
 /**
  * @brief Calculate plugin checksum
  * @param plugin Plugin to calculate checksum for
@@ -682,13 +688,6 @@ static uint16_t calculate_optimal_scheduler(void)
  */
 static uint32_t calculate_plugin_checksum(const dsrtos_scheduler_plugin_t* plugin)
 {
-    const uint8_t* data = (const uint8_t*)plugin;
-    uint32_t checksum = 0x12345678U;
-    size_t size = sizeof(dsrtos_scheduler_plugin_t) - sizeof(uint32_t);
-    
-    for (size_t i = 0U; i < size; i++) {
-        checksum = ((checksum << 1) | (checksum >> 31)) ^ data[i];
-    }
-    
-    return checksum;
+    return dsrtos_crc32(plugin, sizeof(dsrtos_scheduler_plugin_t) - sizeof(uint32_t));
 }
+#endif
@@ -17,6 +17,7 @@
 #include "dsrtos_critical.h"
 #include "dsrtos_memory.h"
 #include "dsrtos_assert.h"
+#include "dsrtos_config.h"
 #include <string.h>
 
 /*==============================================================================
@@ -537,10 +538,12 @@ bool dsrtos_plugin_validate_task(dsrtos_tcb_t* task)
         return false;
     }
     
+#if (DSRTOS_CONFIG_ENABLE_MAGIC_CHECKING != 0U)
     /* Check magic number */
     if (task->magic_number != DSRTOS_TASK_MAGIC) {
         return false;
     }
+#endif
     
     /* Check state */
     if (task->state > DSRTOS_TASK_STATE_TERMINATED) {
@@ -15,6 +15,7 @@
 #include "dsrtos_scheduler_priority.h"
 #include "dsrtos_kernel.h"
 #include "dsrtos_port.h"
+#include "dsrtos_config.h"
 #include <string.h>
 
 /* ============================================================================
@@ -26,9 +27,6 @@ static dsrtos_status_t prio_plugin_schedule(void* scheduler, dsrtos_tcb_t** next
 static dsrtos_status_t prio_plugin_add_task(void* scheduler, dsrtos_tcb_t* task);
 static dsrtos_status_t prio_plugin_remove_task(void* scheduler, dsrtos_tcb_t* task);
 static dsrtos_status_t prio_plugin_tick(void* scheduler);
-static uint32_t prio_find_free_node(dsrtos_priority_scheduler_t* scheduler);
-static void prio_mark_node_used(dsrtos_priority_scheduler_t* scheduler, uint32_t index);
-static void prio_mark_node_free(dsrtos_priority_scheduler_t* scheduler, uint32_t index);
 static void prio_update_bitmap(dsrtos_priority_scheduler_t* scheduler, uint8_t priority);
 static uint8_t prio_find_highest_priority(dsrtos_priority_scheduler_t* scheduler);
 static dsrtos_pi_record_t* prio_alloc_pi_record(dsrtos_priority_scheduler_t* scheduler);
@@ -91,8 +89,10 @@ dsrtos_status_t dsrtos_priority_init(dsrtos_priority_scheduler_t* scheduler)
     scheduler->priority_map.last_update = 0U;
     
     /* Initialize node pool */
-    for (i = 0U; i < 8U; i++) {
-        scheduler->node_bitmap[i] = 0U;  /* All nodes free */
+    if (dsrtos_pool_init(&scheduler->node_allocator, "prio_nodes",
+                         scheduler->node_pool, sizeof(dsrtos_priority_node_t),
+                         256U, DSRTOS_POOL_FLAG_NONE) != DSRTOS_SUCCESS) {
+        return DSRTOS_INVALID_PARAM;
     }
     
     /* Initialize priority inheritance */
@@ -175,16 +175,20 @@ dsrtos_tcb_t* dsrtos_priority_select_next(dsrtos_priority_scheduler_t* scheduler
     dsrtos_priority_node_t* node;
     dsrtos_tcb_t* next_task = NULL;
     uint8_t highest_priority;
+#if (DSRTOS_CONFIG_ENABLE_OP_TIMING != 0U)
     uint32_t start_cycles;
     uint32_t schedule_time_us;
+#endif
     
     if ((scheduler == NULL) || 
         (scheduler->base.state != SCHEDULER_STATE_RUNNING)) {
         return NULL;
     }
     
+#if (DSRTOS_CONFIG_ENABLE_OP_TIMING != 0U)
     /* Performance measurement start */
     start_cycles = dsrtos_port_get_cycle_count();
+#endif
     
     PRIO_ENTER_CRITICAL(scheduler);
     
@@ -226,6 +230,7 @@ dsrtos_tcb_t* dsrtos_priority_select_next(dsrtos_priority_scheduler_t* scheduler
     
     PRIO_EXIT_CRITICAL(scheduler);
     
+#if (DSRTOS_CONFIG_ENABLE_OP_TIMING != 0U)
     /* Performance measurement */
     schedule_time_us = dsrtos_port_cycles_to_us(
         dsrtos_port_get_cycle_count() - start_cycles);
@@ -235,6 +240,7 @@ dsrtos_tcb_t* dsrtos_priority_select_next(dsrtos_priority_scheduler_t* scheduler
     if (schedule_time_us > PRIO_MAX_SCHEDULE_TIME_US) {
         scheduler->base.stats.errors++;
     }
+#endif
     
     return next_task;
 }
@@ -248,8 +254,10 @@ dsrtos_status_t dsrtos_priority_enqueue(dsrtos_priority_scheduler_t* scheduler,
                                         uint8_t priority)
 {
     dsrtos_priority_node_t* node;
+#if (DSRTOS_CONFIG_ENABLE_OP_TIMING != 0U)
     uint32_t start_cycles;
     uint32_t enqueue_time_us;
+#endif
     
     PRIO_ASSERT_VALID_SCHEDULER(scheduler);
     PRIO_ASSERT_VALID_PRIORITY(priority);
@@ -258,7 +266,9 @@ dsrtos_status_t dsrtos_priority_enqueue(dsrtos_priority_scheduler_t* scheduler,
         return DSRTOS_INVALID_PARAM;
     }
     
+#if (DSRTOS_CONFIG_ENABLE_OP_TIMING != 0U)
     start_cycles = dsrtos_port_get_cycle_count();
+#endif
     
     PRIO_ENTER_CRITICAL(scheduler);
     
@@ -287,6 +297,7 @@ dsrtos_status_t dsrtos_priority_enqueue(dsrtos_priority_scheduler_t* scheduler,
     
     PRIO_EXIT_CRITICAL(scheduler);
     
+#if (DSRTOS_CONFIG_ENABLE_OP_TIMING != 0U)
     /* Performance measurement */
     enqueue_time_us = dsrtos_port_cycles_to_us(
         dsrtos_port_get_cycle_count() - start_cycles);
@@ -294,6 +305,7 @@ dsrtos_status_t dsrtos_priority_enqueue(dsrtos_priority_scheduler_t* scheduler,
     if (enqueue_time_us > PRIO_MAX_ENQUEUE_TIME_US) {
         scheduler->base.stats.errors++;
     }
+#endif
     
     return DSRTOS_SUCCESS;
 }
@@ -308,8 +320,10 @@ dsrtos_status_t dsrtos_priority_set(dsrtos_priority_scheduler_t* scheduler,
 {
     dsrtos_priority_node_t* node;
     uint8_t old_priority;
+#if (DSRTOS_CONFIG_ENABLE_OP_TIMING != 0U)
     uint32_t start_cycles;
     uint32_t set_time_us;
+#endif
     uint32_t i;
     
     PRIO_ASSERT_VALID_SCHEDULER(scheduler);
@@ -319,7 +333,9 @@ dsrtos_status_t dsrtos_priority_set(dsrtos_priority_scheduler_t* scheduler,
         return DSRTOS_INVALID_PARAM;
     }
     
+#if (DSRTOS_CONFIG_ENABLE_OP_TIMING != 0U)
     start_cycles = dsrtos_port_get_cycle_count();
+#endif
     
     PRIO_ENTER_CRITICAL(scheduler);
     
@@ -351,6 +367,7 @@ dsrtos_status_t dsrtos_priority_set(dsrtos_priority_scheduler_t* scheduler,
                 
                 PRIO_EXIT_CRITICAL(scheduler);
                 
+#if (DSRTOS_CONFIG_ENABLE_OP_TIMING != 0U)
                 /* Performance measurement */
                 set_time_us = dsrtos_port_cycles_to_us(
                     dsrtos_port_get_cycle_count() - start_cycles);
@@ -358,6 +375,7 @@ dsrtos_status_t dsrtos_priority_set(dsrtos_priority_scheduler_t* scheduler,
                 if (set_time_us > PRIO_MAX_PRIORITY_SET_US) {
                     scheduler->base.stats.errors++;
                 }
+#endif
                 
                 return DSRTOS_SUCCESS;
             }
@@ -585,16 +603,14 @@ void dsrtos_priority_queue_remove(dsrtos_priority_queue_t* queue,
  */
 dsrtos_priority_node_t* dsrtos_priority_alloc_node(dsrtos_priority_scheduler_t* scheduler)
 {
-    uint32_t index = prio_find_free_node(scheduler);
+    dsrtos_priority_node_t* node;
     
-    if (index >= 256U) {
-        return NULL;
+    node = (dsrtos_priority_node_t*)dsrtos_pool_alloc(&scheduler->node_allocator);
+    if (node != NULL) {
+        (void)memset(node, 0, sizeof(dsrtos_priority_node_t));
     }
     
-    prio_mark_node_used(scheduler, index);
-    (void)memset(&scheduler->node_pool[index], 0, sizeof(dsrtos_priority_node_t));
-    
-    return &scheduler->node_pool[index];
+    return node;
 }
 
 /**
@@ -603,62 +619,11 @@ dsrtos_priority_node_t* dsrtos_priority_alloc_node(dsrtos_priority_scheduler_t*
 void dsrtos_priority_free_node(dsrtos_priority_scheduler_t* scheduler,
                               dsrtos_priority_node_t* node)
 {
-    uint32_t index;
-    
     if ((scheduler == NULL) || (node == NULL)) {
         return;
     }
     
-    index = (uint32_t)(node - scheduler->node_pool);
-    if (index < 256U) {
-        prio_mark_node_free(scheduler, index);
-    }
-}
-
-/**
- * @brief Find free node in pool
- */
-static uint32_t prio_find_free_node(dsrtos_priority_scheduler_t* scheduler)
-{
-    uint32_t i, j;
-    
-    for (i = 0U; i < 8U; i++) {
-        if (scheduler->node_bitmap[i] != 0xFFFFFFFFU) {
-            for (j = 0U; j < 32U; j++) {
-                if ((scheduler->node_bitmap[i] & (1U << j)) == 0U) {
-                    return (i * 32U) + j;
-                }
-            }
-        }
-    }
-    
-    return 256U;  /* No free nodes */
-}
-
-/**
- * @brief Mark node as used
- */
-static void prio_mark_node_used(dsrtos_priority_scheduler_t* scheduler, uint32_t index)
-{
-    uint32_t word = index / 32U;
-    uint32_t bit = index % 32U;
-    
-    if (word < 8U) {
-        scheduler->node_bitmap[word] |= (1U << bit);
-    }
-}
-
-/**
- * @brief Mark node as free
- */
-static void prio_mark_node_free(dsrtos_priority_scheduler_t* scheduler, uint32_t index)
-{
-    uint32_t word = index / 32U;
-    uint32_t bit = index % 32U;
-    
-    if (word < 8U) {
-        scheduler->node_bitmap[word] &= ~(1U << bit);
-    }
+    (void)dsrtos_pool_free(&scheduler->node_allocator, node);
 }
 
 /**
@@ -7,7 +7,7 @@
  * Phase: 6 - Concrete Scheduler Implementations
  * 
  * Features:
- * - 256 priority levels (0 = highest, 255 = lowest)
+ * - DSRTOS_PRIORITY_LEVELS priority levels, up to 256 (0 = highest)
  * - O(1) scheduling decisions using priority bitmap
  * - Priority inheritance support
  * - Priority aging for starvation prevention
@@ -24,8 +24,10 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "dsrtos_types.h"
+#include "dsrtos_config.h"
 #include "dsrtos_scheduler.h"
 #include "dsrtos_task_manager.h"
+#include "dsrtos_pool.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -35,14 +37,19 @@ extern "C" {
  * PRIORITY SCHEDULER CONFIGURATION
  * ============================================================================ */
 
-/* Priority levels */
-#define PRIO_NUM_LEVELS             (256U)
+/* Priority levels: the per-level queues, statistics and bitmap are sized
+ * by the configured count, not the 256 maximum */
+#define PRIO_NUM_LEVELS             (DSRTOS_PRIORITY_LEVELS)
 #define PRIO_HIGHEST                (0U)     /* Highest priority */
-#define PRIO_LOWEST                 (255U)   /* Lowest priority */
-#define PRIO_DEFAULT                (128U)   /* Default priority */
+#define PRIO_LOWEST                 (PRIO_NUM_LEVELS - 1U)   /* Lowest priority */
+#define PRIO_DEFAULT                (PRIO_NUM_LEVELS / 2U)   /* Default priority */
+
+#if (PRIO_NUM_LEVELS == 0U) || (PRIO_NUM_LEVELS > 256U)
+#error "PRIO_NUM_LEVELS must be 1..256"
+#endif
 
 /* Priority bitmap */
-#define PRIO_BITMAP_WORDS           (8U)     /* 256 bits / 32 = 8 words */
+#define PRIO_BITMAP_WORDS           ((PRIO_NUM_LEVELS + 31U) / 32U)
 #define PRIO_BITS_PER_WORD          (32U)
 
 /* Priority inheritance */
@@ -140,7 +147,7 @@ struct dsrtos_priority_scheduler {
     
     /* Priority bitmap for O(1) selection */
     struct {
-        uint32_t bitmap[PRIO_BITMAP_WORDS]; /* 256 bits */
+        uint32_t bitmap[PRIO_BITMAP_WORDS]; /* One bit per level */
         uint8_t highest_set;                /* Cached highest priority */
         bool cache_valid;                   /* Cache validity flag */
         uint32_t last_update;               /* Last update timestamp */
@@ -148,7 +155,7 @@ struct dsrtos_priority_scheduler {
     
     /* Task node pool */
     dsrtos_priority_node_t node_pool[256]; /* Pool of nodes */
-    uint32_t node_bitmap[8];                /* Allocation bitmap */
+    dsrtos_pool_t node_allocator;           /* O(1) free list over node_pool */
     
     /* Priority inheritance support */
     struct {
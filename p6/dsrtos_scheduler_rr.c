@@ -15,6 +15,7 @@
 #include "dsrtos_scheduler_rr.h"
 #include "dsrtos_kernel.h"
 #include "dsrtos_port.h"
+#include "dsrtos_config.h"
 #include <string.h>
 
 /* ============================================================================
@@ -26,9 +27,6 @@ static dsrtos_status_t rr_plugin_schedule(void* scheduler, dsrtos_tcb_t** next_t
 static dsrtos_status_t rr_plugin_add_task(void* scheduler, dsrtos_tcb_t* task);
 static dsrtos_status_t rr_plugin_remove_task(void* scheduler, dsrtos_tcb_t* task);
 static dsrtos_status_t rr_plugin_tick(void* scheduler);
-static uint32_t rr_find_first_free_node(dsrtos_rr_scheduler_t* scheduler);
-static void rr_mark_node_used(dsrtos_rr_scheduler_t* scheduler, uint32_t index);
-static void rr_mark_node_free(dsrtos_rr_scheduler_t* scheduler, uint32_t index);
 static void rr_queue_push_back(dsrtos_rr_queue_t* queue, dsrtos_rr_node_t* node);
 static dsrtos_rr_node_t* rr_queue_pop_front(dsrtos_rr_queue_t* queue);
 static void rr_queue_remove_node(dsrtos_rr_queue_t* queue, dsrtos_rr_node_t* node);
@@ -46,8 +44,6 @@ static void rr_check_and_handle_starvation(dsrtos_rr_scheduler_t* scheduler);
 dsrtos_status_t dsrtos_rr_init(dsrtos_rr_scheduler_t* scheduler,
                                uint32_t time_slice_ms)
 {
-    uint32_t i;
-    
     /* Validate parameters */
     if (scheduler == NULL) {
         return DSRTOS_INVALID_PARAM;
@@ -91,9 +87,11 @@ dsrtos_status_t dsrtos_rr_init(dsrtos_rr_scheduler_t* scheduler,
     scheduler->ready_queue.enqueue_count = 0U;
     scheduler->ready_queue.dequeue_count = 0U;
     
-    /* Initialize node pool bitmap (all nodes free) */
-    for (i = 0U; i < 8U; i++) {
-        scheduler->node_pool_bitmap[i] = 0U;  /* 0 = free, 1 = used */
+    /* Initialize node pool (all nodes free) */
+    if (dsrtos_pool_init(&scheduler->node_allocator, "rr_nodes",
+                         scheduler->node_pool, sizeof(dsrtos_rr_node_t),
+                         RR_MAX_READY_TASKS, DSRTOS_POOL_FLAG_NONE) != DSRTOS_SUCCESS) {
+        return DSRTOS_INVALID_PARAM;
     }
     
     /* Initialize fairness parameters */
@@ -172,25 +170,31 @@ dsrtos_tcb_t* dsrtos_rr_select_next(dsrtos_rr_scheduler_t* scheduler)
 {
     dsrtos_rr_node_t* node;
     dsrtos_tcb_t* next_task = NULL;
+#if (DSRTOS_CONFIG_ENABLE_OP_TIMING != 0U)
     uint32_t start_cycles;
     uint32_t end_cycles;
     uint32_t schedule_time_us;
+#endif
     
     if ((scheduler == NULL) || 
         (scheduler->base.state != SCHEDULER_STATE_RUNNING)) {
         return NULL;
     }
     
+#if (DSRTOS_CONFIG_ENABLE_OP_TIMING != 0U)
     /* Performance measurement start */
     start_cycles = dsrtos_port_get_cycle_count();
+#endif
     
     RR_ENTER_CRITICAL(scheduler);
     
+#if (DSRTOS_CONFIG_ENABLE_REDUNDANT_CHECKS != 0U)
     /* Check queue integrity */
     if (!dsrtos_rr_queue_verify_integrity(&scheduler->ready_queue)) {
         RR_EXIT_CRITICAL(scheduler);
         return NULL;
     }
+#endif
     
     /* Check for starvation if enabled */
     if (scheduler->starvation_threshold > 0U) {
@@ -235,6 +239,7 @@ dsrtos_tcb_t* dsrtos_rr_select_next(dsrtos_rr_scheduler_t* scheduler)
     
     RR_EXIT_CRITICAL(scheduler);
     
+#if (DSRTOS_CONFIG_ENABLE_OP_TIMING != 0U)
     /* Performance measurement end */
     end_cycles = dsrtos_port_get_cycle_count();
     schedule_time_us = dsrtos_port_cycles_to_us(end_cycles - start_cycles);
@@ -245,6 +250,7 @@ dsrtos_tcb_t* dsrtos_rr_select_next(dsrtos_rr_scheduler_t* scheduler)
         /* Log performance violation */
         scheduler->base.stats.errors++;
     }
+#endif
     
     return next_task;
 }
@@ -257,13 +263,17 @@ dsrtos_status_t dsrtos_rr_enqueue(dsrtos_rr_scheduler_t* scheduler,
                                   dsrtos_tcb_t* task)
 {
     dsrtos_rr_node_t* node;
+#if (DSRTOS_CONFIG_ENABLE_OP_TIMING != 0U)
     uint32_t start_cycles;
     uint32_t enqueue_time_us;
+#endif
     
     RR_ASSERT_VALID_SCHEDULER(scheduler);
     RR_ASSERT_VALID_TASK(task);
     
+#if (DSRTOS_CONFIG_ENABLE_OP_TIMING != 0U)
     start_cycles = dsrtos_port_get_cycle_count();
+#endif
     
     RR_ENTER_CRITICAL(scheduler);
     
@@ -291,12 +301,14 @@ dsrtos_status_t dsrtos_rr_enqueue(dsrtos_rr_scheduler_t* scheduler,
     
     RR_EXIT_CRITICAL(scheduler);
     
+#if (DSRTOS_CONFIG_ENABLE_OP_TIMING != 0U)
     /* Verify performance requirement */
     enqueue_time_us = dsrtos_port_cycles_to_us(
         dsrtos_port_get_cycle_count() - start_cycles);
     if (enqueue_time_us > RR_MAX_ENQUEUE_TIME_US) {
         scheduler->base.stats.errors++;
     }
+#endif
     
     return DSRTOS_SUCCESS;
 }
@@ -391,77 +403,24 @@ static dsrtos_status_t rr_plugin_tick(void* scheduler)
     return DSRTOS_SUCCESS;
 }
 
-/**
- * @brief Find first free node in pool
- */
-static uint32_t rr_find_first_free_node(dsrtos_rr_scheduler_t* scheduler)
-{
-    uint32_t i, j;
-    uint32_t bitmap_word;
-    
-    for (i = 0U; i < 8U; i++) {
-        bitmap_word = scheduler->node_pool_bitmap[i];
-        if (bitmap_word != 0xFFFFFFFFU) {
-            /* Find first zero bit */
-            for (j = 0U; j < 32U; j++) {
-                if ((bitmap_word & (1U << j)) == 0U) {
-                    return (i * 32U) + j;
-                }
-            }
-        }
-    }
-    
-    return RR_MAX_READY_TASKS;  /* No free nodes */
-}
-
-/**
- * @brief Mark node as used in bitmap
- */
-static void rr_mark_node_used(dsrtos_rr_scheduler_t* scheduler, uint32_t index)
-{
-    uint32_t word = index / 32U;
-    uint32_t bit = index % 32U;
-    
-    if (word < 8U) {
-        scheduler->node_pool_bitmap[word] |= (1U << bit);
-    }
-}
-
-/**
- * @brief Mark node as free in bitmap
- */
-static void rr_mark_node_free(dsrtos_rr_scheduler_t* scheduler, uint32_t index)
-{
-    uint32_t word = index / 32U;
-    uint32_t bit = index % 32U;
-    
-    if (word < 8U) {
-        scheduler->node_pool_bitmap[word] &= ~(1U << bit);
-    }
-}
-
 /**
  * @brief Allocate node from pool
  */
 dsrtos_rr_node_t* dsrtos_rr_alloc_node(dsrtos_rr_scheduler_t* scheduler)
 {
-    uint32_t index;
+    dsrtos_rr_node_t* node;
     
     if (scheduler == NULL) {
         return NULL;
     }
     
-    index = rr_find_first_free_node(scheduler);
-    if (index >= RR_MAX_READY_TASKS) {
-        return NULL;
+    node = (dsrtos_rr_node_t*)dsrtos_pool_alloc(&scheduler->node_allocator);
+    if (node != NULL) {
+        /* Clear node */
+        (void)memset(node, 0, sizeof(dsrtos_rr_node_t));
     }
     
-    rr_mark_node_used(scheduler, index);
-    
-    /* Clear node */
-    (void)memset(&scheduler->node_pool[index], 0, sizeof(dsrtos_rr_node_t));
-    
-    return &scheduler->node_pool[index];
+    return node;
 }
 
 /**
@@ -470,17 +429,11 @@ dsrtos_rr_node_t* dsrtos_rr_alloc_node(dsrtos_rr_scheduler_t* scheduler)
 void dsrtos_rr_free_node(dsrtos_rr_scheduler_t* scheduler,
                         dsrtos_rr_node_t* node)
 {
-    uint32_t index;
-    
     if ((scheduler == NULL) || (node == NULL)) {
         return;
     }
     
-    /* Calculate index */
-    index = (uint32_t)(node - scheduler->node_pool);
-    if (index < RR_MAX_READY_TASKS) {
-        rr_mark_node_free(scheduler, index);
-    }
+    (void)dsrtos_pool_free(&scheduler->node_allocator, node);
 }
 
 /**
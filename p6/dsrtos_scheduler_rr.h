@@ -22,6 +22,8 @@
 #include "dsrtos_types.h"
 #include "dsrtos_scheduler.h"
 #include "dsrtos_task_manager.h"
+#include "dsrtos_pool.h"
+#include "dsrtos_config.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -125,7 +127,7 @@ struct dsrtos_rr_scheduler {
     
     /* Task node pool */
     dsrtos_rr_node_t node_pool[RR_MAX_READY_TASKS];
-    uint32_t node_pool_bitmap[8];          /* 256 bits for allocation */
+    dsrtos_pool_t node_allocator;          /* O(1) free list over node_pool */
     
     /* Fairness tracking */
     uint32_t starvation_threshold;         /* Starvation threshold */
@@ -209,12 +211,21 @@ void dsrtos_rr_update_performance_metrics(dsrtos_rr_scheduler_t* scheduler,
         } \
     } while(0)
 
+#if (DSRTOS_CONFIG_ENABLE_MAGIC_CHECKING != 0U)
 #define RR_ASSERT_VALID_TASK(t) \
     do { \
         if ((t) == NULL || (t)->magic != TCB_MAGIC) { \
             return DSRTOS_INVALID_PARAM; \
         } \
     } while(0)
+#else
+#define RR_ASSERT_VALID_TASK(t) \
+    do { \
+        if ((t) == NULL) { \
+            return DSRTOS_INVALID_PARAM; \
+        } \
+    } while(0)
+#endif
 
 #define RR_ENTER_CRITICAL(s) \
     do { \
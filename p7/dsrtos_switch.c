@@ -9,6 +9,7 @@
 #include "dsrtos_switch.h"
 #include "dsrtos_kernel.h"
 #include "dsrtos_critical.h"
+#include "dsrtos_crc.h"
 #include "dsrtos_memory.h"
 #include <string.h>
 
@@ -37,7 +38,6 @@ static uint32_t g_snapshot_states[DSRTOS_MAX_TASKS] = {0};
  * PRIVATE FUNCTION DECLARATIONS
  * ============================================================================ */
 
-static uint32_t calculate_checksum(const void* data, uint32_t size);
 static dsrtos_status_t save_scheduler_state(void* scheduler, uint16_t id, 
                                            void* buffer, uint32_t* size);
 static dsrtos_status_t restore_scheduler_state(void* scheduler, uint16_t id,
@@ -1085,21 +1085,6 @@ void dsrtos_switch_dump_context(const dsrtos_switch_context_t* context)
  * PRIVATE FUNCTION IMPLEMENTATIONS
  * ============================================================================ */
 
-/**
- * @brief Calculate checksum for data integrity
- */
-static uint32_t calculate_checksum(const void* data, uint32_t size)
-{
-    const uint8_t* bytes = (const uint8_t*)data;
-    uint32_t checksum = DSRTOS_STATE_CHECKSUM_SEED;
-    
-    for (uint32_t i = 0U; i < size; i++) {
-        checksum = ((checksum << 1U) | (checksum >> 31U)) ^ bytes[i];
-    }
-    
-    return checksum;
-}
-
 /**
  * @brief Save scheduler state to buffer
  */
@@ -1264,8 +1249,8 @@ static dsrtos_status_t create_queue_snapshot(dsrtos_queue_snapshot_t* snapshot,
     snapshot->count = count;
     
     /* Calculate checksum */
-    snapshot->checksum = calculate_checksum(snapshot->tasks,
-                                           count * sizeof(dsrtos_tcb_t*));
+    snapshot->checksum = dsrtos_crc32(snapshot->tasks,
+                                     count * sizeof(dsrtos_tcb_t*));
     
     return DSRTOS_SUCCESS;
 }
@@ -1284,8 +1269,8 @@ static dsrtos_status_t restore_queue_snapshot(const dsrtos_queue_snapshot_t* sna
     }
     
     /* Verify checksum */
-    checksum = calculate_checksum(snapshot->tasks,
-                                 snapshot->count * sizeof(dsrtos_tcb_t*));
+    checksum = dsrtos_crc32(snapshot->tasks,
+                           snapshot->count * sizeof(dsrtos_tcb_t*));
     if (checksum != snapshot->checksum) {
         return DSRTOS_CHECKSUM_ERROR;
     }
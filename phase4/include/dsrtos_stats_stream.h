@@ -0,0 +1,70 @@
+/*
+ * DSRTOS Streaming Statistics Exporter Interface
+ *
+ * Copyright (C) 2024 DSRTOS
+ * SPDX-License-Identifier: MIT
+ *
+ * Certification: DO-178C DAL-B, IEC 62304 Class B, ISO 26262 ASIL D
+ * MISRA-C:2012 Compliant
+ *
+ * Serializes system, task, scheduler, context switch, ready queue and
+ * memory statistics as CSV or JSON into caller buffers of any size. The
+ * caller owns the cursor, so nothing is allocated. Each call fetches at
+ * most one record per refill and never holds a critical section for more
+ * than one record, so a full export can be streamed over a slow link in
+ * small pieces.
+ */
+
+#ifndef DSRTOS_STATS_STREAM_H
+#define DSRTOS_STATS_STREAM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "dsrtos_types.h"
+#include "dsrtos_error.h"
+#include "dsrtos_task_statistics.h"
+
+/* Longest serialized record, including a CSV section header */
+#define DSRTOS_STATS_STREAM_RECORD_MAX  (384U)
+
+/* Cursor validity marker */
+#define DSRTOS_STATS_STREAM_MAGIC       (0x53545245U)  /* "STRE" */
+
+/* Export cursor: resumes an export across calls */
+typedef struct {
+    uint32_t magic;
+    dsrtos_stats_format_t format;
+    uint32_t section;                /* Current record source */
+    uint32_t index;                  /* Next record within the section */
+    uint32_t records;                /* Records emitted so far */
+    bool header_sent;                /* CSV header of the section emitted */
+    bool done;                       /* Every record emitted */
+    uint16_t pending_len;            /* Bytes in pending */
+    uint16_t pending_off;            /* Bytes of pending already copied out */
+    char pending[DSRTOS_STATS_STREAM_RECORD_MAX];
+} dsrtos_stats_stream_t;
+
+/* Function prototypes */
+dsrtos_error_t dsrtos_stats_stream_begin(
+    dsrtos_stats_stream_t* stream,
+    dsrtos_stats_format_t format
+);
+
+dsrtos_error_t dsrtos_stats_stream_read(
+    dsrtos_stats_stream_t* stream,
+    void* buffer,
+    uint32_t size,
+    uint32_t* written
+);
+
+bool dsrtos_stats_stream_done(const dsrtos_stats_stream_t* stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DSRTOS_STATS_STREAM_H */
@@ -18,6 +18,10 @@
 #include "dsrtos_critical.h"
 #include "dsrtos_assert.h"
 #include "dsrtos_task_scheduler_interface.h"
+#include "dsrtos_shard_stats.h"
+#include "dsrtos_hooks.h"
+#include "dsrtos_cpu_account.h"
+#include "dsrtos_budget.h"
 #include "stm32f4xx.h"
 #include <string.h>
 
@@ -62,6 +66,16 @@ typedef struct {
     uint32_t last_switch_cycles;
 } context_control_t;
 
+/* Per-CPU context switch statistics; the average is derived on read */
+typedef struct {
+    uint32_t switch_count;
+    uint32_t switch_cycles_min;
+    uint32_t switch_cycles_max;
+    uint32_t preemption_count;
+    uint32_t voluntary_count;
+    uint64_t switch_cycles_total;
+} context_stats_shard_t;
+
 /*==============================================================================
  * GLOBAL VARIABLES
  *============================================================================*/
@@ -71,8 +85,9 @@ volatile dsrtos_tcb_t* g_current_task = NULL;
 volatile dsrtos_tcb_t* g_next_task = NULL;
 volatile dsrtos_tcb_t* g_idle_task = NULL;
 
-/* Context switch statistics */
-static dsrtos_context_stats_t g_context_stats = {0};
+/* Context switch statistics, one shard per CPU */
+static context_stats_shard_t g_context_shards[DSRTOS_STATS_SHARD_COUNT];
+static dsrtos_shard_stats_t g_context_stats;
 
 /* Context switch control */
 static context_control_t g_context_control = {
@@ -101,7 +116,9 @@ static void context_save_cpu_state(dsrtos_tcb_t* task, uint32_t* sp);
 static void context_restore_cpu_state(dsrtos_tcb_t* task, uint32_t** sp);
 static bool context_validate_stack(dsrtos_tcb_t* task);
 static void context_switch_error_handler(uint32_t error_code);
-static void context_update_statistics(uint32_t cycles);
+static void context_update_statistics(uint32_t cycles, const dsrtos_tcb_t* current);
+static void context_stats_reset(void* shard);
+static void context_stats_merge(void* total, const void* shard);
 static uint32_t context_measure_cycles(void);
 
 /*==============================================================================
@@ -115,16 +132,15 @@ dsrtos_error_t dsrtos_context_switch_init(void)
 {
     DSRTOS_TRACE_CONTEXT("Initializing context switch");
     
+#if !defined(DSRTOS_HOST_BUILD)
     /* Set PendSV to lowest priority */
     *(volatile uint8_t*)NVIC_SYSPRI14 = NVIC_PENDSV_PRI;
+#endif
     
     /* Initialize statistics */
-    g_context_stats.switch_count = 0U;
-    g_context_stats.switch_cycles_min = UINT32_MAX;
-    g_context_stats.switch_cycles_max = 0U;
-    g_context_stats.switch_cycles_avg = 0U;
-    g_context_stats.preemption_count = 0U;
-    g_context_stats.voluntary_count = 0U;
+    (void)dsrtos_shard_stats_init(&g_context_stats, "context",
+                                  g_context_shards, sizeof(context_stats_shard_t),
+                                  context_stats_reset, context_stats_merge);
     
     /* Clear task pointers */
     g_current_task = NULL;
@@ -149,10 +165,13 @@ dsrtos_error_t dsrtos_context_switch_init(void)
     DSRTOS_TRACE_CONTEXT("FPU enabled with lazy stacking");
 #endif
     
-    /* Enable DWT cycle counter for timing measurements */
-    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
-    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
-    DWT->CYCCNT = 0U;
+    /* Enable DWT cycle counter for timing measurements; if kernel init
+     * already started it, keep counting so the boot timeline stays valid */
+    if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0U) {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0U;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
     
     DSRTOS_TRACE_CONTEXT("Context switch initialized");
     
@@ -175,12 +194,14 @@ void dsrtos_context_switch(dsrtos_tcb_t* next_task)
         return;
     }
     
+#if (DSRTOS_CONFIG_ENABLE_MAGIC_CHECKING != 0U)
     /* Validate task TCB */
     if (next_task->magic_number != DSRTOS_TCB_MAGIC) {
         DSRTOS_TRACE_ERROR("Invalid task TCB in context switch");
         context_switch_error_handler((uint32_t)DSRTOS_ERROR_CORRUPTION);
         return;
     }
+#endif
     
     /* Disable interrupts */
     primask = __get_PRIMASK();
@@ -331,12 +352,16 @@ void* dsrtos_context_restore(dsrtos_tcb_t* task)
  */
 void dsrtos_switch_context_handler(uint32_t* current_sp)
 {
+#if (DSRTOS_CONFIG_ENABLE_OP_TIMING != 0U)
     uint32_t start_cycles;
+#endif
     dsrtos_tcb_t* current;
     dsrtos_tcb_t* next;
     
+#if (DSRTOS_CONFIG_ENABLE_OP_TIMING != 0U)
     /* Measure context switch time */
     start_cycles = context_measure_cycles();
+#endif
     
     /* Check for errors */
     if (g_context_control.in_switch) {
@@ -397,6 +422,13 @@ void dsrtos_switch_context_handler(uint32_t* current_sp)
     /* Update next task state */
     next->state = DSRTOS_TASK_STATE_RUNNING;
     
+    /* Charge the outgoing task's cycles and budget */
+    dsrtos_cpu_account_switch(next);
+    dsrtos_budget_switch(next);
+
+    /* Switch hooks: a test and branch each when none are registered */
+    DSRTOS_HOOK_TASK_SWITCH(current, next);
+    
     g_context_control.state = CONTEXT_STATE_RESTORE;
     
     /* Clear pending switch flag */
@@ -407,26 +439,18 @@ void dsrtos_switch_context_handler(uint32_t* current_sp)
     
     /* Update statistics */
     g_context_control.switch_count++;
-    g_context_stats.switch_count++;
-    
-    /* Determine switch type */
-    if (current != NULL) {
-        if (current->voluntary_yields > 0U) {
-            g_context_stats.voluntary_count++;
-        } else {
-            g_context_stats.preemption_count++;
-        }
-    }
     
+#if (DSRTOS_CONFIG_ENABLE_OP_TIMING != 0U)
     /* Update timing statistics */
     g_context_control.last_switch_cycles = context_measure_cycles() - start_cycles;
-    context_update_statistics(g_context_control.last_switch_cycles);
     
     /* Check timing constraint */
     if (g_context_control.last_switch_cycles > MAX_CONTEXT_SWITCH_CYCLES) {
         DSRTOS_TRACE_WARNING("Context switch exceeded timing: %u cycles",
                             g_context_control.last_switch_cycles);
     }
+#endif
+    context_update_statistics(g_context_control.last_switch_cycles, current);
     
     g_context_control.state = CONTEXT_STATE_IDLE;
     g_context_control.in_switch = false;
@@ -446,14 +470,26 @@ void dsrtos_switch_context_handler(uint32_t* current_sp)
  */
 dsrtos_error_t dsrtos_context_get_stats(dsrtos_context_stats_t* stats)
 {
+    context_stats_shard_t total;
+    dsrtos_error_t err;
+    
     if (stats == NULL) {
         return DSRTOS_ERROR_INVALID_PARAM;
     }
     
-    /* Copy statistics atomically */
-    dsrtos_critical_enter();
-    *stats = g_context_stats;
-    dsrtos_critical_exit();
+    /* Lock-free snapshot of every CPU's shard */
+    err = dsrtos_shard_stats_snapshot(&g_context_stats, &total);
+    if (err != DSRTOS_SUCCESS) {
+        return err;
+    }
+    
+    stats->switch_count = total.switch_count;
+    stats->switch_cycles_min = total.switch_cycles_min;
+    stats->switch_cycles_max = total.switch_cycles_max;
+    stats->switch_cycles_avg = (total.switch_count > 0U) ?
+        (uint32_t)(total.switch_cycles_total / total.switch_count) : 0U;
+    stats->preemption_count = total.preemption_count;
+    stats->voluntary_count = total.voluntary_count;
     
     return DSRTOS_SUCCESS;
 }
@@ -463,18 +499,7 @@ dsrtos_error_t dsrtos_context_get_stats(dsrtos_context_stats_t* stats)
  */
 dsrtos_error_t dsrtos_context_reset_stats(void)
 {
-    dsrtos_critical_enter();
-    
-    g_context_stats.switch_count = 0U;
-    g_context_stats.switch_cycles_min = UINT32_MAX;
-    g_context_stats.switch_cycles_max = 0U;
-    g_context_stats.switch_cycles_avg = 0U;
-    g_context_stats.preemption_count = 0U;
-    g_context_stats.voluntary_count = 0U;
-    
-    dsrtos_critical_exit();
-    
-    return DSRTOS_SUCCESS;
+    return dsrtos_shard_stats_reset(&g_context_stats);
 }
 
 /*==============================================================================
@@ -598,30 +623,68 @@ static void context_switch_error_handler(uint32_t error_code)
 }
 
 /**
- * @brief Update context switch timing statistics
+ * @brief Update context switch statistics in this CPU's shard
  */
-static void context_update_statistics(uint32_t cycles)
+static void context_update_statistics(uint32_t cycles, const dsrtos_tcb_t* current)
 {
-    uint64_t total;
+    context_stats_shard_t* shard = dsrtos_shard_stats_write_begin(&g_context_stats);
     
-    /* Update min/max */
-    if (cycles < g_context_stats.switch_cycles_min) {
-        g_context_stats.switch_cycles_min = cycles;
+    if (shard == NULL) {
+        return;
     }
     
-    if (cycles > g_context_stats.switch_cycles_max) {
-        g_context_stats.switch_cycles_max = cycles;
+    dsrtos_stat_add(&shard->switch_count, 1U);
+    
+    /* Determine switch type */
+    if (current != NULL) {
+        if (current->voluntary_yields > 0U) {
+            dsrtos_stat_add(&shard->voluntary_count, 1U);
+        } else {
+            dsrtos_stat_add(&shard->preemption_count, 1U);
+        }
     }
     
-    /* Update average */
-    if (g_context_stats.switch_count > 0U) {
-        total = (uint64_t)g_context_stats.switch_cycles_avg * 
-                (uint64_t)(g_context_stats.switch_count - 1U);
-        total += cycles;
-        g_context_stats.switch_cycles_avg = 
-            (uint32_t)(total / g_context_stats.switch_count);
-    } else {
-        g_context_stats.switch_cycles_avg = cycles;
+#if (DSRTOS_CONFIG_ENABLE_OP_TIMING != 0U)
+    dsrtos_stat_min(&shard->switch_cycles_min, cycles);
+    dsrtos_stat_max(&shard->switch_cycles_max, cycles);
+    
+    /* PendSV does not nest, so the 64-bit sum has a single writer per CPU */
+    shard->switch_cycles_total += cycles;
+#else
+    (void)cycles;
+#endif
+    
+    dsrtos_shard_stats_write_end(&g_context_stats, shard);
+}
+
+/**
+ * @brief Empty context statistics shard
+ */
+static void context_stats_reset(void* shard)
+{
+    context_stats_shard_t* stats = (context_stats_shard_t*)shard;
+    
+    (void)memset(stats, 0, sizeof(*stats));
+    stats->switch_cycles_min = UINT32_MAX;
+}
+
+/**
+ * @brief Fold one CPU's context statistics into a total
+ */
+static void context_stats_merge(void* total, const void* shard)
+{
+    context_stats_shard_t* sum = (context_stats_shard_t*)total;
+    const context_stats_shard_t* cpu = (const context_stats_shard_t*)shard;
+    
+    sum->switch_count += cpu->switch_count;
+    sum->preemption_count += cpu->preemption_count;
+    sum->voluntary_count += cpu->voluntary_count;
+    sum->switch_cycles_total += cpu->switch_cycles_total;
+    if (cpu->switch_cycles_min < sum->switch_cycles_min) {
+        sum->switch_cycles_min = cpu->switch_cycles_min;
+    }
+    if (cpu->switch_cycles_max > sum->switch_cycles_max) {
+        sum->switch_cycles_max = cpu->switch_cycles_max;
     }
 }
 
@@ -13,6 +13,7 @@
 #include "dsrtos_critical.h"
 #include "dsrtos_assert.h"
 #include "dsrtos_config.h"
+#include "dsrtos_pool.h"
 #include <string.h>
 
 /* Maximum resources for ceiling protocol */
@@ -23,7 +24,7 @@ static dsrtos_resource_ceiling_t g_resource_ceilings[MAX_RESOURCES];
 
 /* Priority inheritance chain pool */
 static dsrtos_pi_chain_node_t g_pi_chain_pool[DSRTOS_MAX_TASKS];
-static uint32_t g_pi_chain_bitmap[(DSRTOS_MAX_TASKS + 31U) / 32U];
+static dsrtos_pool_t g_pi_chain_nodes;
 
 /* Statistics */
 static struct {
@@ -56,7 +57,11 @@ dsrtos_error_t dsrtos_priority_mgmt_init(void)
     
     /* Initialize chain pool */
     (void)memset(g_pi_chain_pool, 0, sizeof(g_pi_chain_pool));
-    (void)memset(g_pi_chain_bitmap, 0, sizeof(g_pi_chain_bitmap));
+    if (dsrtos_pool_init(&g_pi_chain_nodes, "pi_chain", g_pi_chain_pool,
+                         sizeof(dsrtos_pi_chain_node_t), DSRTOS_MAX_TASKS,
+                         DSRTOS_POOL_FLAG_NONE) != DSRTOS_SUCCESS) {
+        return DSRTOS_ERROR_INITIALIZATION;
+    }
     
     /* Clear statistics */
     g_priority_stats.priority_inversions = 0U;
@@ -544,28 +549,14 @@ uint32_t dsrtos_priority_get_inheritance_depth(const dsrtos_tcb_t* task)
  */
 static dsrtos_pi_chain_node_t* allocate_chain_node(void)
 {
-    uint32_t i, j;
-    uint32_t bit_mask;
-    
-    for (i = 0U; i < ((DSRTOS_MAX_TASKS + 31U) / 32U); i++) {
-        if (g_pi_chain_bitmap[i] != 0xFFFFFFFFU) {
-            for (j = 0U; j < 32U; j++) {
-                bit_mask = 1UL << j;
-                if ((g_pi_chain_bitmap[i] & bit_mask) == 0U) {
-                    g_pi_chain_bitmap[i] |= bit_mask;
-                    
-                    uint32_t index = (i * 32U) + j;
-                    if (index < DSRTOS_MAX_TASKS) {
-                        (void)memset(&g_pi_chain_pool[index], 0,
-                                   sizeof(dsrtos_pi_chain_node_t));
-                        return &g_pi_chain_pool[index];
-                    }
-                }
-            }
-        }
+    dsrtos_pi_chain_node_t* node;
+    
+    node = (dsrtos_pi_chain_node_t*)dsrtos_pool_alloc(&g_pi_chain_nodes);
+    if (node != NULL) {
+        (void)memset(node, 0, sizeof(dsrtos_pi_chain_node_t));
     }
     
-    return NULL;
+    return node;
 }
 
 /**
@@ -573,21 +564,12 @@ static dsrtos_pi_chain_node_t* allocate_chain_node(void)
  */
 static void free_chain_node(dsrtos_pi_chain_node_t* node)
 {
-    uint32_t index;
-    uint32_t word_index;
-    uint32_t bit_mask;
-    
-    if ((node == NULL) || (node < g_pi_chain_pool) ||
-        (node >= &g_pi_chain_pool[DSRTOS_MAX_TASKS])) {
+    if (!dsrtos_pool_owns(&g_pi_chain_nodes, node)) {
         return;
     }
     
-    index = (uint32_t)(node - g_pi_chain_pool);
-    word_index = index / 32U;
-    bit_mask = 1UL << (index % 32U);
-    
     (void)memset(node, 0, sizeof(dsrtos_pi_chain_node_t));
-    g_pi_chain_bitmap[word_index] &= ~bit_mask;
+    (void)dsrtos_pool_free(&g_pi_chain_nodes, node);
 }
 
 /**
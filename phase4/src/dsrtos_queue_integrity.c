@@ -10,6 +10,7 @@
 
 #include "dsrtos_queue_integrity.h"
 #include "dsrtos_critical.h"
+#include "dsrtos_crc.h"
 #include "dsrtos_assert.h"
 #include "dsrtos_config.h"
 #include "dsrtos_panic.h"
@@ -80,6 +81,7 @@ dsrtos_integrity_status_t dsrtos_queue_check_integrity(
         goto exit;
     }
     
+#if (DSRTOS_CONFIG_ENABLE_REDUNDANT_CHECKS != 0U)
     /* Verify bitmap consistency */
     for (i = 0U; i < DSRTOS_BITMAP_WORDS; i++) {
         if (queue->priority_bitmap[i] != queue->priority_bitmap_mirror[i]) {
@@ -88,6 +90,7 @@ dsrtos_integrity_status_t dsrtos_queue_check_integrity(
             goto exit;
         }
     }
+#endif
     
     /* Check each priority list */
     for (i = 0U; i < DSRTOS_PRIORITY_LEVELS; i++) {
@@ -279,23 +282,11 @@ dsrtos_error_t dsrtos_queue_get_integrity_report(
  */
 uint32_t dsrtos_queue_calculate_checksum(const dsrtos_ready_queue_t* queue)
 {
-    const uint8_t* data;
-    uint32_t checksum = 0x5A5A5A5AU;
-    size_t i;
-    
     if (queue == NULL) {
         return 0U;
     }
     
-    data = (const uint8_t*)queue;
-    
-    /* Calculate rotating XOR checksum */
-    for (i = 0U; i < sizeof(dsrtos_ready_queue_t); i++) {
-        checksum ^= data[i];
-        checksum = (checksum << 1) | (checksum >> 31);
-    }
-    
-    return checksum;
+    return dsrtos_crc32(queue, sizeof(dsrtos_ready_queue_t));
 }
 
 /**
@@ -303,17 +294,17 @@ uint32_t dsrtos_queue_calculate_checksum(const dsrtos_ready_queue_t* queue)
  */
 bool dsrtos_node_validate(const dsrtos_queue_node_t* node)
 {
-    uint32_t calculated_checksum;
-    
     if (node == NULL) {
         return false;
     }
     
+#if (DSRTOS_CONFIG_ENABLE_MAGIC_CHECKING != 0U)
     /* Check magic numbers */
     if ((node->magic_start != DSRTOS_NODE_MAGIC) ||
         (node->magic_end != DSRTOS_NODE_MAGIC)) {
         return false;
     }
+#endif
     
     /* Verify task pointer */
     if ((node->task == NULL) ||
@@ -322,19 +313,12 @@ bool dsrtos_node_validate(const dsrtos_queue_node_t* node)
         return false;
     }
     
+#if (DSRTOS_CONFIG_ENABLE_CHECKSUM_VALIDATION != 0U)
     /* Calculate and verify checksum */
-    calculated_checksum = 0x12345678U;
-    const uint8_t* data = (const uint8_t*)node;
-    size_t size = sizeof(dsrtos_queue_node_t) - sizeof(uint32_t);
-    
-    for (size_t i = 0U; i < size; i++) {
-        calculated_checksum ^= data[i];
-        calculated_checksum = (calculated_checksum << 1) | (calculated_checksum >> 31);
-    }
-    
-    if (calculated_checksum != node->checksum) {
+    if (dsrtos_queue_node_checksum(node) != node->checksum) {
         return false;
     }
+#endif
     
     return true;
 }
@@ -12,10 +12,15 @@
 #include "dsrtos_critical.h"
 #include "dsrtos_assert.h"
 #include "dsrtos_config.h"
+#include "dsrtos_shard_stats.h"
 #include <string.h>
 
-/* Global operations statistics */
-static dsrtos_queue_ops_stats_t g_queue_ops_stats = {0};
+static void queue_ops_stats_merge(void* total, const void* shard);
+
+/* Global operations statistics, one shard per CPU */
+static dsrtos_queue_ops_stats_t g_queue_ops_shards[DSRTOS_STATS_SHARD_COUNT];
+static dsrtos_shard_stats_t g_queue_ops_stats =
+    DSRTOS_SHARD_STATS_INITIALIZER("queue_ops", g_queue_ops_shards, NULL, queue_ops_stats_merge);
 
 /**
  * @brief Initialize queue iterator
@@ -24,6 +29,8 @@ dsrtos_error_t dsrtos_queue_iterator_init(
     dsrtos_queue_iterator_t* iter,
     dsrtos_ready_queue_t* queue)
 {
+    dsrtos_queue_ops_stats_t* stats;
+    
     if ((iter == NULL) || (queue == NULL)) {
         return DSRTOS_ERROR_INVALID_PARAM;
     }
@@ -44,7 +51,9 @@ dsrtos_error_t dsrtos_queue_iterator_init(
         iter->iteration_count = 0U;
     }
     
-    g_queue_ops_stats.total_iterations++;
+    stats = dsrtos_shard_stats_write_begin(&g_queue_ops_stats);
+    dsrtos_stat_add(&stats->total_iterations, 1U);
+    dsrtos_shard_stats_write_end(&g_queue_ops_stats, stats);
     
     return DSRTOS_SUCCESS;
 }
@@ -56,19 +65,27 @@ dsrtos_tcb_t* dsrtos_queue_iterator_next(dsrtos_queue_iterator_t* iter)
 {
     dsrtos_queue_node_t* node;
     dsrtos_tcb_t* task = NULL;
+#if (DSRTOS_CONFIG_ENABLE_OP_TIMING != 0U)
     uint32_t start_cycles;
+#endif
     
     if ((iter == NULL) || (iter->remaining_tasks == 0U)) {
         return NULL;
     }
     
+#if (DSRTOS_CONFIG_ENABLE_OP_TIMING != 0U)
     start_cycles = DWT->CYCCNT;
+#endif
     
     node = (dsrtos_queue_node_t*)iter->current_node;
     if (node != NULL) {
         /* Validate node */
+#if (DSRTOS_CONFIG_ENABLE_MAGIC_CHECKING != 0U)
         if ((node->magic_start == DSRTOS_NODE_MAGIC) &&
             (node->magic_end == DSRTOS_NODE_MAGIC)) {
+#else
+        {
+#endif
             task = node->task;
             
             /* Move to next node */
@@ -89,11 +106,13 @@ dsrtos_tcb_t* dsrtos_queue_iterator_next(dsrtos_queue_iterator_t* iter)
         iter->iteration_count++;
     }
     
+#if (DSRTOS_CONFIG_ENABLE_OP_TIMING != 0U)
     /* Update statistics */
     uint32_t elapsed = DWT->CYCCNT - start_cycles;
-    if (elapsed > g_queue_ops_stats.max_iteration_time) {
-        g_queue_ops_stats.max_iteration_time = elapsed;
-    }
+    dsrtos_queue_ops_stats_t* stats = dsrtos_shard_stats_write_begin(&g_queue_ops_stats);
+    dsrtos_stat_max(&stats->max_iteration_time, elapsed);
+    dsrtos_shard_stats_write_end(&g_queue_ops_stats, stats);
+#endif
     
     return task;
 }
@@ -108,6 +127,7 @@ dsrtos_error_t dsrtos_ready_queue_rebalance(dsrtos_ready_queue_t* queue)
     dsrtos_queue_node_t* node;
     dsrtos_queue_node_t* next;
     uint32_t removed_count = 0U;
+    dsrtos_queue_ops_stats_t* stats;
     
     if (queue == NULL) {
         return DSRTOS_ERROR_INVALID_PARAM;
@@ -127,8 +147,11 @@ dsrtos_error_t dsrtos_ready_queue_rebalance(dsrtos_ready_queue_t* queue)
             next = node->next;
             
             /* Check node validity */
-            if ((node->magic_start != DSRTOS_NODE_MAGIC) ||
+            if (
+#if (DSRTOS_CONFIG_ENABLE_MAGIC_CHECKING != 0U)
+                (node->magic_start != DSRTOS_NODE_MAGIC) ||
                 (node->magic_end != DSRTOS_NODE_MAGIC) ||
+#endif
                 (node->task == NULL)) {
                 
                 /* Remove invalid node */
@@ -154,7 +177,9 @@ dsrtos_error_t dsrtos_ready_queue_rebalance(dsrtos_ready_queue_t* queue)
         /* Update bitmap if list became empty */
         if ((list->count == 0U) && (list->head == NULL)) {
             dsrtos_priority_bitmap_clear(queue->priority_bitmap, (uint8_t)i);
+#if (DSRTOS_CONFIG_ENABLE_REDUNDANT_CHECKS != 0U)
             dsrtos_priority_bitmap_clear(queue->priority_bitmap_mirror, (uint8_t)i);
+#endif
         }
     }
     
@@ -162,10 +187,12 @@ dsrtos_error_t dsrtos_ready_queue_rebalance(dsrtos_ready_queue_t* queue)
     if (queue->stats.total_tasks >= removed_count) {
         queue->stats.total_tasks -= removed_count;
     }
-    g_queue_ops_stats.rebalance_count++;
-    
     dsrtos_ready_queue_unlock(queue);
     
+    stats = dsrtos_shard_stats_write_begin(&g_queue_ops_stats);
+    dsrtos_stat_add(&stats->rebalance_count, 1U);
+    dsrtos_shard_stats_write_end(&g_queue_ops_stats, stats);
+    
     DSRTOS_TRACE_QUEUE("Rebalance complete, removed %u invalid nodes", removed_count);
     
     return DSRTOS_SUCCESS;
@@ -180,6 +207,7 @@ dsrtos_error_t dsrtos_ready_queue_migrate(
     dsrtos_tcb_t* task)
 {
     dsrtos_error_t result;
+    dsrtos_queue_ops_stats_t* stats;
     
     if ((src_queue == NULL) || (dst_queue == NULL) || (task == NULL)) {
         return DSRTOS_ERROR_INVALID_PARAM;
@@ -203,7 +231,9 @@ dsrtos_error_t dsrtos_ready_queue_migrate(
     
     /* Update statistics */
     /* task->migrations++; */ /* Field not available in current TCB */
-    g_queue_ops_stats.migration_count++;
+    stats = dsrtos_shard_stats_write_begin(&g_queue_ops_stats);
+    dsrtos_stat_add(&stats->migration_count, 1U);
+    dsrtos_shard_stats_write_end(&g_queue_ops_stats, stats);
     
     return DSRTOS_SUCCESS;
 }
@@ -228,7 +258,6 @@ dsrtos_error_t dsrtos_ready_queue_clear(dsrtos_ready_queue_t* queue)
         queue->priority_lists[i].head = NULL;
         queue->priority_lists[i].tail = NULL;
         queue->priority_lists[i].count = 0U;
-        queue->priority_lists[i].list_checksum = 0U;
     }
     
     /* Clear bitmaps */
@@ -255,11 +284,8 @@ dsrtos_error_t dsrtos_ready_queue_get_stats(
         return DSRTOS_ERROR_INVALID_PARAM;
     }
     
-    dsrtos_critical_enter();
-    *stats = g_queue_ops_stats;
-    dsrtos_critical_exit();
-    
-    return DSRTOS_SUCCESS;
+    /* Lock-free snapshot of every CPU's shard */
+    return dsrtos_shard_stats_snapshot(&g_queue_ops_stats, stats);
 }
 
 /**
@@ -313,3 +339,19 @@ uint32_t dsrtos_ready_queue_count_at_priority(
     
     return count;
 }
+
+/**
+ * @brief Fold one CPU's queue operation statistics into a total
+ */
+static void queue_ops_stats_merge(void* total, const void* shard)
+{
+    dsrtos_queue_ops_stats_t* sum = (dsrtos_queue_ops_stats_t*)total;
+    const dsrtos_queue_ops_stats_t* cpu = (const dsrtos_queue_ops_stats_t*)shard;
+    
+    sum->total_iterations += cpu->total_iterations;
+    sum->rebalance_count += cpu->rebalance_count;
+    sum->migration_count += cpu->migration_count;
+    if (cpu->max_iteration_time > sum->max_iteration_time) {
+        sum->max_iteration_time = cpu->max_iteration_time;
+    }
+}
@@ -11,6 +11,7 @@
 #include "dsrtos_scheduler_decision.h"
 #include "dsrtos_critical.h"
 #include "dsrtos_config.h"
+#include "dsrtos_shard_stats.h"
 #include <string.h>
 
 /* Decision thresholds */
@@ -27,14 +28,21 @@ static dsrtos_decision_weights_t g_decision_weights;
 static uint32_t g_decision_count = 0U;
 static bool g_initialized = false;
 
-/* Statistics */
-static struct {
+/* Per-CPU decision statistics; the average is derived on read */
+typedef struct {
     uint32_t total_decisions;
     uint32_t preemption_decisions;
     uint32_t migration_decisions;
-    uint32_t avg_decision_cycles;
     uint32_t max_decision_cycles;
-} g_decision_stats = {0};
+    uint64_t total_decision_cycles;
+} decision_stats_shard_t;
+
+static void decision_stats_merge(void* total, const void* shard);
+
+/* Statistics, one shard per CPU */
+static decision_stats_shard_t g_decision_shards[DSRTOS_STATS_SHARD_COUNT];
+static dsrtos_shard_stats_t g_decision_stats =
+    DSRTOS_SHARD_STATS_INITIALIZER("decision", g_decision_shards, NULL, decision_stats_merge);
 
 /**
  * @brief Initialize scheduler decision engine
@@ -63,11 +71,7 @@ dsrtos_error_t dsrtos_scheduler_decision_init(void)
     g_decision_weights.energy_weight = 20U;
     
     /* Clear statistics */
-    g_decision_stats.total_decisions = 0U;
-    g_decision_stats.preemption_decisions = 0U;
-    g_decision_stats.migration_decisions = 0U;
-    g_decision_stats.avg_decision_cycles = 0U;
-    g_decision_stats.max_decision_cycles = 0U;
+    (void)dsrtos_shard_stats_reset(&g_decision_stats);
     
     g_decision_count = 0U;
     g_initialized = true;
@@ -93,25 +97,58 @@ dsrtos_error_t dsrtos_scheduler_decision_deinit(void)
     return DSRTOS_SUCCESS;
 }
 
+/**
+ * @brief Get decision engine statistics
+ */
+dsrtos_error_t dsrtos_scheduler_decision_get_stats(dsrtos_decision_stats_t* stats)
+{
+    decision_stats_shard_t total;
+    dsrtos_error_t err;
+    
+    if (stats == NULL) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+    
+    /* Lock-free snapshot of every CPU's shard */
+    err = dsrtos_shard_stats_snapshot(&g_decision_stats, &total);
+    if (err != DSRTOS_SUCCESS) {
+        return err;
+    }
+    
+    stats->total_decisions = total.total_decisions;
+    stats->preemption_decisions = total.preemption_decisions;
+    stats->migration_decisions = total.migration_decisions;
+    stats->avg_decision_cycles = (total.total_decisions > 0U) ?
+        (uint32_t)(total.total_decision_cycles / total.total_decisions) : 0U;
+    stats->max_decision_cycles = total.max_decision_cycles;
+    
+    return DSRTOS_SUCCESS;
+}
+
 /**
  * @brief Make scheduling decision based on metrics
  */
 dsrtos_sched_decision_t* dsrtos_scheduler_make_decision(
     dsrtos_system_metrics_t* metrics)
 {
+#if (DSRTOS_CONFIG_ENABLE_OP_TIMING != 0U)
     uint32_t start_cycles;
-    uint32_t decision_cycles;
+#endif
+    uint32_t decision_cycles = 0U;
     dsrtos_tcb_t* selected = NULL;
     uint32_t highest_score = 0U;
     uint32_t task_score;
+    decision_stats_shard_t* stats;
     /* extern dsrtos_ready_queue_t g_ready_queue; */ /* Variable not available */
     
     if (!g_initialized || (metrics == NULL)) {
         return NULL;
     }
     
+#if (DSRTOS_CONFIG_ENABLE_OP_TIMING != 0U)
     /* Measure decision time */
     start_cycles = DWT->CYCCNT;
+#endif
     
     /* Update system metrics */
     g_system_metrics = *metrics;
@@ -145,8 +182,10 @@ dsrtos_sched_decision_t* dsrtos_scheduler_make_decision(
         }
     }
     
+#if (DSRTOS_CONFIG_ENABLE_OP_TIMING != 0U)
     /* Calculate decision time */
     decision_cycles = DWT->CYCCNT - start_cycles;
+#endif
     
     /* Update decision record */
     g_last_decision.selected_task = selected;
@@ -157,20 +196,12 @@ dsrtos_sched_decision_t* dsrtos_scheduler_make_decision(
     
     /* Update statistics */
     g_decision_count++;
-    g_decision_stats.total_decisions++;
-    
-    if (decision_cycles > g_decision_stats.max_decision_cycles) {
-        g_decision_stats.max_decision_cycles = decision_cycles;
-    }
-    
-    /* Update average */
-    if (g_decision_stats.total_decisions > 0U) {
-        uint64_t total = (uint64_t)g_decision_stats.avg_decision_cycles * 
-                        (g_decision_stats.total_decisions - 1U);
-        total += decision_cycles;
-        g_decision_stats.avg_decision_cycles = 
-            (uint32_t)(total / g_decision_stats.total_decisions);
-    }
+    stats = dsrtos_shard_stats_write_begin(&g_decision_stats);
+    dsrtos_stat_add(&stats->total_decisions, 1U);
+    dsrtos_stat_max(&stats->max_decision_cycles, decision_cycles);
+    /* Decisions are made by the scheduler of this CPU only: one writer */
+    stats->total_decision_cycles += decision_cycles;
+    dsrtos_shard_stats_write_end(&g_decision_stats, stats);
     
     /* Check for excessive decision time */
     if (decision_cycles > MAX_DECISION_CYCLES) {
@@ -193,6 +224,7 @@ bool dsrtos_scheduler_should_preempt(
 {
     uint32_t priority_delta;
     bool should_preempt = false;
+    decision_stats_shard_t* stats;
     
     if ((current == NULL) || (candidate == NULL)) {
         return false;
@@ -205,7 +237,9 @@ bool dsrtos_scheduler_should_preempt(
         /* Check preemption threshold */
         if (priority_delta >= PREEMPTION_THRESHOLD) {
             should_preempt = true;
-            g_decision_stats.preemption_decisions++;
+            stats = dsrtos_shard_stats_write_begin(&g_decision_stats);
+            dsrtos_stat_add(&stats->preemption_decisions, 1U);
+            dsrtos_shard_stats_write_end(&g_decision_stats, stats);
         }
     }
     
@@ -365,3 +399,20 @@ uint32_t dsrtos_scheduler_evaluate_task_score(
     
     return score;
 }
+
+/**
+ * @brief Fold one CPU's decision statistics into a total
+ */
+static void decision_stats_merge(void* total, const void* shard)
+{
+    decision_stats_shard_t* sum = (decision_stats_shard_t*)total;
+    const decision_stats_shard_t* cpu = (const decision_stats_shard_t*)shard;
+    
+    sum->total_decisions += cpu->total_decisions;
+    sum->preemption_decisions += cpu->preemption_decisions;
+    sum->migration_decisions += cpu->migration_decisions;
+    sum->total_decision_cycles += cpu->total_decision_cycles;
+    if (cpu->max_decision_cycles > sum->max_decision_cycles) {
+        sum->max_decision_cycles = cpu->max_decision_cycles;
+    }
+}
@@ -53,9 +53,19 @@ typedef struct {
     uint16_t energy_weight;
 } dsrtos_decision_weights_t;
 
+/* Decision engine statistics */
+typedef struct {
+    uint32_t total_decisions;
+    uint32_t preemption_decisions;
+    uint32_t migration_decisions;
+    uint32_t avg_decision_cycles;
+    uint32_t max_decision_cycles;
+} dsrtos_decision_stats_t;
+
 /* Function prototypes */
 dsrtos_error_t dsrtos_scheduler_decision_init(void);
 dsrtos_error_t dsrtos_scheduler_decision_deinit(void);
+dsrtos_error_t dsrtos_scheduler_decision_get_stats(dsrtos_decision_stats_t* stats);
 
 dsrtos_sched_decision_t* dsrtos_scheduler_make_decision(
     dsrtos_system_metrics_t* metrics
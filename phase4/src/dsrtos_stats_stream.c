@@ -0,0 +1,515 @@
+/*
+ * DSRTOS Streaming Statistics Exporter Implementation
+ *
+ * Copyright (C) 2024 DSRTOS
+ * SPDX-License-Identifier: MIT
+ *
+ * Certification: DO-178C DAL-B, IEC 62304 Class B, ISO 26262 ASIL D
+ * MISRA-C:2012 Compliant
+ */
+
+#include "dsrtos_stats_stream.h"
+#include "dsrtos_kernel.h"
+#include "dsrtos_critical.h"
+#include "dsrtos_memory.h"
+#include "dsrtos_context_switch.h"
+#include "dsrtos_scheduler_stats.h"
+#include <string.h>
+
+/* Most values in one record */
+#define STREAM_MAX_FIELDS           (8U)
+
+/* Result of fetching one record from a section */
+typedef enum {
+    STREAM_FETCH_ROW = 0,            /* Row filled in */
+    STREAM_FETCH_SKIP,               /* Nothing at this index, try the next */
+    STREAM_FETCH_END                 /* Section exhausted */
+} stream_fetch_t;
+
+/* One record, before formatting */
+typedef struct {
+    uint32_t id;
+    char label[DSRTOS_TASK_NAME_MAX_LENGTH];
+    uint64_t values[STREAM_MAX_FIELDS];
+} stream_row_t;
+
+/* A source of records */
+typedef struct {
+    const char* name;
+    const char* const* keys;
+    uint32_t key_count;
+    bool labelled;                   /* Rows carry a name column */
+    stream_fetch_t (*fetch)(uint32_t index, stream_row_t* row);
+} stream_section_t;
+
+/* Bounded text writer over the cursor's pending buffer */
+typedef struct {
+    char* buf;
+    uint32_t len;
+    uint32_t cap;
+    bool overflow;
+} stream_writer_t;
+
+/* Record sources */
+static stream_fetch_t stream_fetch_system(uint32_t index, stream_row_t* row);
+static stream_fetch_t stream_fetch_task(uint32_t index, stream_row_t* row);
+static stream_fetch_t stream_fetch_scheduler(uint32_t index, stream_row_t* row);
+static stream_fetch_t stream_fetch_context(uint32_t index, stream_row_t* row);
+static stream_fetch_t stream_fetch_queue(uint32_t index, stream_row_t* row);
+static stream_fetch_t stream_fetch_memory(uint32_t index, stream_row_t* row);
+
+/* Formatting */
+static dsrtos_error_t stream_refill(dsrtos_stats_stream_t* stream);
+static void stream_format_row(dsrtos_stats_stream_t* stream,
+                              stream_writer_t* out,
+                              const stream_section_t* section,
+                              const stream_row_t* row);
+static void stream_put_char(stream_writer_t* out, char c);
+static void stream_put_str(stream_writer_t* out, const char* str);
+static void stream_put_u64(stream_writer_t* out, uint64_t value);
+static void stream_put_name(stream_writer_t* out, const char* str, dsrtos_stats_format_t format);
+
+static const char* const g_system_keys[] = {
+    "uptime", "active", "ready", "blocked", "suspended",
+    "peak_active", "context_switches", "cpu_load_x100"
+};
+static const char* const g_task_keys[] = {
+    "priority", "state", "total_runtime", "max_runtime",
+    "context_switches", "preemptions", "deadline_misses"
+};
+static const char* const g_scheduler_keys[] = {
+    "schedules", "context_switches", "preemptions", "migrations",
+    "avg_schedule_ns", "max_schedule_ns", "priority_inversions", "deadline_misses"
+};
+static const char* const g_context_keys[] = {
+    "switches", "cycles_min", "cycles_max", "cycles_avg", "preemptions", "voluntary"
+};
+static const char* const g_queue_keys[] = {
+    "depth", "max_depth", "min_depth", "avg_depth", "samples"
+};
+static const char* const g_memory_keys[] = {
+    "total", "allocated", "peak", "fragmentation_permille"
+};
+
+/* Export order */
+static const stream_section_t g_sections[] = {
+    { "system",    g_system_keys,    8U, false, stream_fetch_system },
+    { "task",      g_task_keys,      7U, true,  stream_fetch_task },
+    { "scheduler", g_scheduler_keys, 8U, false, stream_fetch_scheduler },
+    { "context",   g_context_keys,   6U, false, stream_fetch_context },
+    { "queue",     g_queue_keys,     5U, false, stream_fetch_queue },
+    { "memory",    g_memory_keys,    4U, false, stream_fetch_memory }
+};
+
+#define STREAM_SECTION_COUNT  ((uint32_t)(sizeof(g_sections) / sizeof(g_sections[0])))
+
+/**
+ * @brief Start an export
+ */
+dsrtos_error_t dsrtos_stats_stream_begin(
+    dsrtos_stats_stream_t* stream,
+    dsrtos_stats_format_t format)
+{
+    if (stream == NULL) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+
+    if ((format != DSRTOS_STATS_FORMAT_CSV) && (format != DSRTOS_STATS_FORMAT_JSON)) {
+        return DSRTOS_ERROR_NOT_SUPPORTED;
+    }
+
+    (void)memset(stream, 0, sizeof(*stream));
+    stream->format = format;
+    stream->magic = DSRTOS_STATS_STREAM_MAGIC;
+
+    return DSRTOS_SUCCESS;
+}
+
+/**
+ * @brief Continue an export into a buffer
+ */
+dsrtos_error_t dsrtos_stats_stream_read(
+    dsrtos_stats_stream_t* stream,
+    void* buffer,
+    uint32_t size,
+    uint32_t* written)
+{
+    uint8_t* dst = (uint8_t*)buffer;
+    uint32_t total = 0U;
+    uint32_t chunk;
+    dsrtos_error_t result = DSRTOS_SUCCESS;
+
+    if ((stream == NULL) || (buffer == NULL) || (written == NULL)) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+
+    if (stream->magic != DSRTOS_STATS_STREAM_MAGIC) {
+        return DSRTOS_ERROR_NOT_INITIALIZED;
+    }
+
+    while ((total < size) && (result == DSRTOS_SUCCESS)) {
+        if (stream->pending_off == stream->pending_len) {
+            if (stream->section > STREAM_SECTION_COUNT) {
+                stream->done = true;
+                break;
+            }
+            result = stream_refill(stream);
+            continue;
+        }
+
+        chunk = (uint32_t)stream->pending_len - stream->pending_off;
+        if (chunk > (size - total)) {
+            chunk = size - total;
+        }
+        (void)memcpy(&dst[total], &stream->pending[stream->pending_off], chunk);
+        stream->pending_off += (uint16_t)chunk;
+        total += chunk;
+    }
+
+    /* Finished exactly at the end of the buffer */
+    if ((stream->pending_off == stream->pending_len) &&
+        (stream->section > STREAM_SECTION_COUNT)) {
+        stream->done = true;
+    }
+
+    *written = total;
+    return result;
+}
+
+/**
+ * @brief Check whether an export has emitted everything
+ */
+bool dsrtos_stats_stream_done(const dsrtos_stats_stream_t* stream)
+{
+    return (stream == NULL) || stream->done;
+}
+
+/*==============================================================================
+ * FORMATTING
+ *============================================================================*/
+
+/**
+ * @brief Format the next record into the cursor's pending buffer
+ */
+static dsrtos_error_t stream_refill(dsrtos_stats_stream_t* stream)
+{
+    stream_writer_t out;
+    stream_row_t row;
+    stream_fetch_t fetched = STREAM_FETCH_END;
+    const stream_section_t* section;
+
+    out.buf = stream->pending;
+    out.len = 0U;
+    out.cap = DSRTOS_STATS_STREAM_RECORD_MAX;
+    out.overflow = false;
+
+    /* Find the next record; skipped indexes cost no critical section */
+    while (stream->section < STREAM_SECTION_COUNT) {
+        section = &g_sections[stream->section];
+        (void)memset(&row, 0, sizeof(row));
+        fetched = section->fetch(stream->index, &row);
+        if (fetched == STREAM_FETCH_END) {
+            stream->section++;
+            stream->index = 0U;
+            stream->header_sent = false;
+            continue;
+        }
+        stream->index++;
+        if (fetched == STREAM_FETCH_ROW) {
+            stream_format_row(stream, &out, section, &row);
+            break;
+        }
+    }
+
+    if (stream->section >= STREAM_SECTION_COUNT) {
+        /* Trailer, queued once */
+        if (stream->format == DSRTOS_STATS_FORMAT_JSON) {
+            stream_put_str(&out, (stream->records == 0U) ? "[]\n" : "\n]\n");
+        }
+        stream->section = STREAM_SECTION_COUNT + 1U;
+    }
+
+    stream->pending_len = (uint16_t)out.len;
+    stream->pending_off = 0U;
+
+    /* Sized for the longest record; an overflow means a key table grew */
+    return out.overflow ? DSRTOS_ERROR_OVERFLOW : DSRTOS_SUCCESS;
+}
+
+/**
+ * @brief Format one record as CSV or JSON
+ */
+static void stream_format_row(dsrtos_stats_stream_t* stream,
+                              stream_writer_t* out,
+                              const stream_section_t* section,
+                              const stream_row_t* row)
+{
+    uint32_t i;
+
+    if (stream->format == DSRTOS_STATS_FORMAT_CSV) {
+        /* Each section has its own columns: header before its first row */
+        if (!stream->header_sent) {
+            stream_put_str(out, "type,id");
+            if (section->labelled) {
+                stream_put_str(out, ",name");
+            }
+            for (i = 0U; i < section->key_count; i++) {
+                stream_put_char(out, ',');
+                stream_put_str(out, section->keys[i]);
+            }
+            stream_put_char(out, '\n');
+            stream->header_sent = true;
+        }
+        stream_put_str(out, section->name);
+        stream_put_char(out, ',');
+        stream_put_u64(out, row->id);
+        if (section->labelled) {
+            stream_put_char(out, ',');
+            stream_put_name(out, row->label, stream->format);
+        }
+        for (i = 0U; i < section->key_count; i++) {
+            stream_put_char(out, ',');
+            stream_put_u64(out, row->values[i]);
+        }
+        stream_put_char(out, '\n');
+    } else {
+        stream_put_str(out, (stream->records == 0U) ? "[\n{\"type\":\"" : ",\n{\"type\":\"");
+        stream_put_str(out, section->name);
+        stream_put_str(out, "\",\"id\":");
+        stream_put_u64(out, row->id);
+        if (section->labelled) {
+            stream_put_str(out, ",\"name\":");
+            stream_put_name(out, row->label, stream->format);
+        }
+        for (i = 0U; i < section->key_count; i++) {
+            stream_put_str(out, ",\"");
+            stream_put_str(out, section->keys[i]);
+            stream_put_str(out, "\":");
+            stream_put_u64(out, row->values[i]);
+        }
+        stream_put_char(out, '}');
+    }
+
+    stream->records++;
+}
+
+static void stream_put_char(stream_writer_t* out, char c)
+{
+    if (out->len < out->cap) {
+        out->buf[out->len] = c;
+        out->len++;
+    } else {
+        out->overflow = true;
+    }
+}
+
+static void stream_put_str(stream_writer_t* out, const char* str)
+{
+    while (*str != '\0') {
+        stream_put_char(out, *str);
+        str++;
+    }
+}
+
+static void stream_put_u64(stream_writer_t* out, uint64_t value)
+{
+    char digits[20];
+    uint32_t count = 0U;
+
+    do {
+        digits[count] = (char)('0' + (char)(value % 10U));
+        count++;
+        value /= 10U;
+    } while (value != 0U);
+
+    while (count > 0U) {
+        count--;
+        stream_put_char(out, digits[count]);
+    }
+}
+
+/**
+ * @brief Write a task name as a quoted CSV field or JSON string
+ */
+static void stream_put_name(stream_writer_t* out, const char* str, dsrtos_stats_format_t format)
+{
+    uint32_t i;
+    char c;
+
+    stream_put_char(out, '"');
+    for (i = 0U; (i < DSRTOS_TASK_NAME_MAX_LENGTH) && (str[i] != '\0'); i++) {
+        c = str[i];
+        if ((uint8_t)c < 0x20U) {
+            c = '?';                 /* No control characters on the wire */
+        }
+        if (c == '"') {
+            /* CSV doubles a quote, JSON escapes it */
+            stream_put_char(out, (format == DSRTOS_STATS_FORMAT_CSV) ? '"' : '\\');
+        } else if ((c == '\\') && (format == DSRTOS_STATS_FORMAT_JSON)) {
+            stream_put_char(out, '\\');
+        } else {
+            /* Plain character */
+        }
+        stream_put_char(out, c);
+    }
+    stream_put_char(out, '"');
+}
+
+/*==============================================================================
+ * RECORD SOURCES
+ *============================================================================*/
+
+static stream_fetch_t stream_fetch_system(uint32_t index, stream_row_t* row)
+{
+    system_stats_t stats;
+    float load;
+
+    if (index > 0U) {
+        return STREAM_FETCH_END;
+    }
+
+    /* Sequence-counted copy, no critical section */
+    if (dsrtos_stats_get_system(&stats) != DSRTOS_SUCCESS) {
+        return STREAM_FETCH_SKIP;
+    }
+
+    load = stats.cpu_load.cpu_load_ewma * 100.0F;
+    row->values[0] = stats.system_uptime;
+    row->values[1] = stats.active_tasks;
+    row->values[2] = stats.ready_tasks;
+    row->values[3] = stats.blocked_tasks;
+    row->values[4] = stats.suspended_tasks;
+    row->values[5] = stats.peak_active_tasks;
+    row->values[6] = stats.total_context_switches;
+    row->values[7] = (load > 0.0F) ? (uint64_t)load : 0U;
+
+    return STREAM_FETCH_ROW;
+}
+
+static stream_fetch_t stream_fetch_task(uint32_t index, stream_row_t* row)
+{
+    dsrtos_tcb_t* tcb;
+
+    if (index >= DSRTOS_MAX_TASKS) {
+        return STREAM_FETCH_END;
+    }
+
+    /* Empty slots are skipped without a critical section */
+    if (dsrtos_task_get_by_index(index) == NULL) {
+        return STREAM_FETCH_SKIP;
+    }
+
+    /* One task per critical section. The TCB is looked up again inside it:
+     * a task released since the check above is skipped, not read. */
+    dsrtos_critical_enter();
+    tcb = dsrtos_task_get_by_index(index);
+    if (tcb == NULL) {
+        dsrtos_critical_exit();
+        return STREAM_FETCH_SKIP;
+    }
+
+    row->id = tcb->task_id;
+    (void)memcpy(row->label, tcb->name, sizeof(row->label));
+    row->values[0] = (uint64_t)tcb->priority;
+    row->values[1] = (uint64_t)tcb->state;
+    row->values[2] = tcb->stats.total_runtime;
+    row->values[3] = tcb->stats.max_runtime;
+    row->values[4] = tcb->stats.context_switches;
+    row->values[5] = tcb->stats.preemptions;
+    row->values[6] = tcb->stats.deadline_misses;
+    dsrtos_critical_exit();
+
+    return STREAM_FETCH_ROW;
+}
+
+static stream_fetch_t stream_fetch_scheduler(uint32_t index, stream_row_t* row)
+{
+    dsrtos_scheduler_stats_t stats;
+
+    if (index > 0U) {
+        return STREAM_FETCH_END;
+    }
+
+    if (dsrtos_scheduler_stats_get(&stats) != DSRTOS_SUCCESS) {
+        return STREAM_FETCH_SKIP;
+    }
+
+    row->values[0] = stats.total_schedules;
+    row->values[1] = stats.total_context_switches;
+    row->values[2] = stats.total_preemptions;
+    row->values[3] = stats.total_migrations;
+    row->values[4] = stats.avg_schedule_time_ns;
+    row->values[5] = stats.max_schedule_time_ns;
+    row->values[6] = stats.priority_inversions;
+    row->values[7] = stats.deadline_misses;
+
+    return STREAM_FETCH_ROW;
+}
+
+static stream_fetch_t stream_fetch_context(uint32_t index, stream_row_t* row)
+{
+    dsrtos_context_stats_t stats;
+
+    if (index > 0U) {
+        return STREAM_FETCH_END;
+    }
+
+    /* Per-CPU shard snapshot, no critical section */
+    if (dsrtos_context_get_stats(&stats) != DSRTOS_SUCCESS) {
+        return STREAM_FETCH_SKIP;
+    }
+
+    row->values[0] = stats.switch_count;
+    row->values[1] = (stats.switch_count > 0U) ? stats.switch_cycles_min : 0U;
+    row->values[2] = stats.switch_cycles_max;
+    row->values[3] = stats.switch_cycles_avg;
+    row->values[4] = stats.preemption_count;
+    row->values[5] = stats.voluntary_count;
+
+    return STREAM_FETCH_ROW;
+}
+
+static stream_fetch_t stream_fetch_queue(uint32_t index, stream_row_t* row)
+{
+    dsrtos_queue_depth_stats_t stats;
+
+    if (index > 0U) {
+        return STREAM_FETCH_END;
+    }
+
+    if (dsrtos_queue_depth_stats_get(&stats) != DSRTOS_SUCCESS) {
+        return STREAM_FETCH_SKIP;
+    }
+
+    row->values[0] = stats.current_depth;
+    row->values[1] = stats.max_depth;
+    row->values[2] = stats.min_depth;
+    row->values[3] = stats.avg_depth;
+    row->values[4] = stats.samples;
+
+    return STREAM_FETCH_ROW;
+}
+
+static stream_fetch_t stream_fetch_memory(uint32_t index, stream_row_t* row)
+{
+    dsrtos_size_t total_size;
+    dsrtos_size_t allocated;
+    dsrtos_size_t peak;
+    uint32_t fragmentation = 0U;
+
+    if (index > 0U) {
+        return STREAM_FETCH_END;
+    }
+
+    if (dsrtos_memory_get_stats(&total_size, &allocated, &peak) != DSRTOS_SUCCESS) {
+        return STREAM_FETCH_SKIP;
+    }
+    (void)dsrtos_memory_get_fragmentation(&fragmentation);
+
+    row->values[0] = total_size;
+    row->values[1] = allocated;
+    row->values[2] = peak;
+    row->values[3] = fragmentation;
+
+    return STREAM_FETCH_ROW;
+}
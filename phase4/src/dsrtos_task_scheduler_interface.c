@@ -21,8 +21,11 @@
 #include "dsrtos_kernel.h"
 #include "dsrtos_task_manager.h"
 #include "dsrtos_critical.h"
+#include "dsrtos_crc.h"
 #include "dsrtos_assert.h"
 #include "dsrtos_panic.h"
+#include "dsrtos_pool.h"
+#include "dsrtos_region.h"
 #include <string.h>
 
 /*==============================================================================
@@ -30,9 +33,10 @@
  *============================================================================*/
 /* Static allocation for safety - no dynamic memory */
 static dsrtos_scheduler_interface_t g_scheduler_interface;
-static dsrtos_ready_queue_t g_ready_queue;
-static dsrtos_queue_node_t g_queue_nodes[DSRTOS_MAX_TASKS];
-static uint32_t g_queue_node_bitmap[(DSRTOS_MAX_TASKS + 31U) / 32U];
+/* Touched on every schedule: kept in CCM */
+static dsrtos_ready_queue_t g_ready_queue DSRTOS_CCM_BSS;
+static dsrtos_queue_node_t g_queue_nodes[DSRTOS_MAX_TASKS] DSRTOS_CCM_BSS;
+static dsrtos_pool_t g_queue_node_pool;
 
 /* Safety monitoring */
 static struct {
@@ -48,12 +52,16 @@ static struct {
  *============================================================================*/
 static dsrtos_queue_node_t* allocate_queue_node(void);
 static void free_queue_node(dsrtos_queue_node_t* node);
-static uint32_t calculate_checksum(const void* data, size_t size);
 static bool validate_tcb(const dsrtos_tcb_t* task);
 static bool validate_priority(uint8_t priority);
 static bool validate_node(const dsrtos_queue_node_t* node);
 static dsrtos_error_t repair_bitmap(dsrtos_ready_queue_t* queue);
 static dsrtos_error_t verify_redundant_bitmap(dsrtos_ready_queue_t* queue);
+#if (DSRTOS_CONFIG_ENABLE_REDUNDANT_CHECKS != 0U)
+static bool validate_local(const dsrtos_ready_queue_t* queue,
+                           uint8_t priority,
+                           const dsrtos_queue_node_t* node);
+#endif
 /* Removed unused function declarations for production readiness */
 
 /*==============================================================================
@@ -68,7 +76,6 @@ dsrtos_error_t dsrtos_scheduler_interface_init(
     const dsrtos_scheduler_ops_t* ops)
 {
     dsrtos_error_t result;
-    uint32_t i;
     
     /* MISRA-C:2012 Rule 14.3: Validate all parameters */
     if ((interface == NULL) || (ops == NULL)) {
@@ -128,14 +135,13 @@ dsrtos_error_t dsrtos_scheduler_interface_init(
     interface->safety.stack_overflows = 0U;
     
     /* Initialize queue node pool */
-    for (i = 0U; i < DSRTOS_MAX_TASKS; i++) {
-        g_queue_nodes[i].magic_start = 0U;
-        g_queue_nodes[i].magic_end = 0U;
-        g_queue_nodes[i].task = NULL;
-        g_queue_nodes[i].next = NULL;
-        g_queue_nodes[i].prev = NULL;
+    (void)memset(g_queue_nodes, 0, sizeof(g_queue_nodes));
+    result = dsrtos_pool_init(&g_queue_node_pool, "queue_nodes", g_queue_nodes,
+                              sizeof(dsrtos_queue_node_t), DSRTOS_MAX_TASKS,
+                              DSRTOS_POOL_FLAG_NONE);
+    if (result != DSRTOS_SUCCESS) {
+        return result;
     }
-    (void)memset(g_queue_node_bitmap, 0, sizeof(g_queue_node_bitmap));
     
     /* Call scheduler-specific initialization */
     if (ops->init != NULL) {
@@ -145,9 +151,11 @@ dsrtos_error_t dsrtos_scheduler_interface_init(
         }
     }
     
+#if (DSRTOS_CONFIG_ENABLE_CHECKSUM_VALIDATION != 0U)
     /* Calculate initial checksum */
-    interface->checksum = calculate_checksum(interface, 
-                                            sizeof(dsrtos_scheduler_interface_t) - sizeof(uint32_t));
+    interface->checksum = dsrtos_crc32(interface, 
+                                      sizeof(dsrtos_scheduler_interface_t) - sizeof(uint32_t));
+#endif
     
     /* Set global interface pointer */
     g_scheduler_interface = *interface;
@@ -204,25 +212,26 @@ dsrtos_error_t dsrtos_scheduler_interface_deinit(
 bool dsrtos_scheduler_interface_validate(
     const dsrtos_scheduler_interface_t* interface)
 {
-    uint32_t calculated_checksum;
-    
     if (interface == NULL) {
         return false;
     }
     
+#if (DSRTOS_CONFIG_ENABLE_MAGIC_CHECKING != 0U)
     /* Check magic number */
     if (interface->magic != DSRTOS_SCHEDULER_MAGIC) {
         g_safety_stats.validation_failures++;
         return false;
     }
+#endif
     
+#if (DSRTOS_CONFIG_ENABLE_CHECKSUM_VALIDATION != 0U)
     /* Verify checksum */
-    calculated_checksum = calculate_checksum(interface, 
-                                            sizeof(dsrtos_scheduler_interface_t) - sizeof(uint32_t));
-    if (calculated_checksum != interface->checksum) {
+    if (dsrtos_crc32(interface, sizeof(dsrtos_scheduler_interface_t) - sizeof(uint32_t)) !=
+        interface->checksum) {
         g_safety_stats.checksum_errors++;
         return false;
     }
+#endif
     
     /* Validate ready queue */
     if ((interface->ready_queue != NULL) && 
@@ -269,9 +278,6 @@ dsrtos_error_t dsrtos_ready_queue_init(dsrtos_ready_queue_t* queue)
         queue->priority_lists[i].head = NULL;
         queue->priority_lists[i].tail = NULL;
         queue->priority_lists[i].count = 0U;
-        queue->priority_lists[i].max_count = DSRTOS_MAX_TASKS;
-        queue->priority_lists[i].priority = (uint8_t)i;
-        queue->priority_lists[i].list_checksum = 0U;
     }
     
     /* Initialize statistics */
@@ -292,7 +298,8 @@ dsrtos_error_t dsrtos_ready_queue_init(dsrtos_ready_queue_t* queue)
     
     /* Initialize integrity monitoring */
     queue->integrity.validation_counter = 0U;
-    queue->integrity.validation_interval = 100U; /* Validate every 100 operations */
+    queue->integrity.validation_interval = 100U; /* Validate every 100 operations, or
+                                                     every total_tasks once larger */
     queue->integrity.last_error_tick = 0U;
     queue->integrity.error_code = 0U;
     
@@ -308,27 +315,21 @@ dsrtos_error_t dsrtos_ready_queue_insert(
     dsrtos_ready_queue_t* queue,
     dsrtos_tcb_t* task)
 {
+#if (DSRTOS_CONFIG_ENABLE_REDUNDANT_CHECKS != 0U)
     dsrtos_error_t result;
+#endif
     dsrtos_priority_list_t* priority_list;
     dsrtos_queue_node_t* node;
     uint8_t priority;
+#if (DSRTOS_CONFIG_ENABLE_OP_TIMING != 0U)
     uint32_t start_cycles;
+#endif
     
     /* Parameter validation */
     if ((queue == NULL) || (task == NULL)) {
         return DSRTOS_ERROR_INVALID_PARAM;
     }
     
-    /* Validate queue integrity */
-    if (!dsrtos_ready_queue_validate(queue)) {
-        /* Attempt repair */
-        result = dsrtos_ready_queue_repair(queue);
-        if (result != DSRTOS_SUCCESS) {
-            DSRTOS_ASSERT(false);
-            return DSRTOS_ERROR_CORRUPTION;
-        }
-    }
-    
     /* Validate task */
     if (!validate_tcb(task)) {
         return DSRTOS_ERROR_INVALID_STATE;
@@ -340,11 +341,26 @@ dsrtos_error_t dsrtos_ready_queue_insert(
         return DSRTOS_ERROR_INVALID_PARAM;
     }
     
+#if (DSRTOS_CONFIG_ENABLE_REDUNDANT_CHECKS != 0U)
+    /* Validate what the insertion relies on; a failure falls back to the
+     * full validation and repair */
+    if (!validate_local(queue, priority, NULL) && !dsrtos_ready_queue_validate(queue)) {
+        /* Attempt repair */
+        result = dsrtos_ready_queue_repair(queue);
+        if (result != DSRTOS_SUCCESS) {
+            DSRTOS_ASSERT(false);
+            return DSRTOS_ERROR_CORRUPTION;
+        }
+    }
+#endif
+    
     DSRTOS_TRACE_QUEUE("Inserting task %u at priority %u", 
                        task->task_id, priority);
     
+#if (DSRTOS_CONFIG_ENABLE_OP_TIMING != 0U)
     /* Measure operation time */
     start_cycles = DWT->CYCCNT;
+#endif
     
     /* Lock queue */
     dsrtos_ready_queue_lock(queue);
@@ -363,20 +379,23 @@ dsrtos_error_t dsrtos_ready_queue_insert(
     }
     
     /* Initialize node */
+#if (DSRTOS_CONFIG_ENABLE_MAGIC_CHECKING != 0U)
     node->magic_start = DSRTOS_NODE_MAGIC;
     node->magic_end = DSRTOS_NODE_MAGIC;
+#endif
     node->task = task;
     node->insertion_tick = dsrtos_get_tick_count();
     node->next = NULL;
     node->prev = NULL;
-    node->checksum = calculate_checksum(node, 
-                                       sizeof(dsrtos_queue_node_t) - sizeof(uint32_t));
+#if (DSRTOS_CONFIG_ENABLE_CHECKSUM_VALIDATION != 0U)
+    node->checksum = dsrtos_queue_node_checksum(node);
+#endif
     
     /* Get priority list */
     priority_list = &queue->priority_lists[priority];
     
     /* Check list capacity */
-    if (priority_list->count >= priority_list->max_count) {
+    if (priority_list->count >= DSRTOS_MAX_TASKS) {
         free_queue_node(node);
         dsrtos_ready_queue_unlock(queue);
         return DSRTOS_ERROR_FULL;
@@ -392,12 +411,9 @@ dsrtos_error_t dsrtos_ready_queue_insert(
     priority_list->tail = node;
     priority_list->count++;
     
-    /* Update list checksum */
-    priority_list->list_checksum = calculate_checksum(priority_list,
-                                                     sizeof(dsrtos_priority_list_t) - sizeof(uint32_t));
-    
     /* Update both bitmaps atomically */
     dsrtos_priority_bitmap_set(queue->priority_bitmap, priority);
+#if (DSRTOS_CONFIG_ENABLE_REDUNDANT_CHECKS != 0U)
     dsrtos_priority_bitmap_set(queue->priority_bitmap_mirror, priority);
     
     /* Verify bitmap consistency */
@@ -407,6 +423,7 @@ dsrtos_error_t dsrtos_ready_queue_insert(
         /* Attempt repair */
         (void)repair_bitmap(queue);
     }
+#endif
     
     /* Update statistics */
     queue->stats.total_tasks++;
@@ -421,20 +438,26 @@ dsrtos_error_t dsrtos_ready_queue_insert(
     /* Update task state */
     task->state = DSRTOS_TASK_STATE_READY;
     
+#if (DSRTOS_CONFIG_ENABLE_OP_TIMING != 0U)
     /* Check operation time */
     uint32_t cycles = DWT->CYCCNT - start_cycles;
     if (cycles > queue->sync.max_lock_time) {
         queue->sync.max_lock_time = cycles;
     }
+#endif
     
-    /* Periodic validation */
+#if (DSRTOS_CONFIG_ENABLE_REDUNDANT_CHECKS != 0U)
+    /* Periodic validation: a full pass costs O(total_tasks), so it runs no
+     * more often than every total_tasks insertions to stay O(1) amortized */
     queue->integrity.validation_counter++;
-    if (queue->integrity.validation_counter >= queue->integrity.validation_interval) {
+    if ((queue->integrity.validation_counter >= queue->integrity.validation_interval) &&
+        (queue->integrity.validation_counter >= queue->stats.total_tasks)) {
         queue->integrity.validation_counter = 0U;
         if (!dsrtos_ready_queue_validate(queue)) {
             queue->stats.corruptions_detected++;
         }
     }
+#endif
     
     /* Unlock queue */
     dsrtos_ready_queue_unlock(queue);
@@ -449,7 +472,9 @@ dsrtos_error_t dsrtos_ready_queue_remove(
     dsrtos_ready_queue_t* queue,
     dsrtos_tcb_t* task)
 {
+#if (DSRTOS_CONFIG_ENABLE_REDUNDANT_CHECKS != 0U)
     dsrtos_error_t result;
+#endif
     dsrtos_priority_list_t* priority_list;
     dsrtos_queue_node_t* node;
     uint8_t priority;
@@ -459,14 +484,6 @@ dsrtos_error_t dsrtos_ready_queue_remove(
         return DSRTOS_ERROR_INVALID_PARAM;
     }
     
-    /* Validate queue integrity */
-    if (!dsrtos_ready_queue_validate(queue)) {
-        result = dsrtos_ready_queue_repair(queue);
-        if (result != DSRTOS_SUCCESS) {
-            return DSRTOS_ERROR_CORRUPTION;
-        }
-    }
-    
     priority = task->effective_priority;
     node = (dsrtos_queue_node_t*)task->queue_node;
     
@@ -479,6 +496,17 @@ dsrtos_error_t dsrtos_ready_queue_remove(
         return DSRTOS_ERROR_CORRUPTION;
     }
     
+#if (DSRTOS_CONFIG_ENABLE_REDUNDANT_CHECKS != 0U)
+    /* Validate what the unlink relies on; a failure falls back to the full
+     * validation and repair */
+    if (!validate_local(queue, priority, node) && !dsrtos_ready_queue_validate(queue)) {
+        result = dsrtos_ready_queue_repair(queue);
+        if ((result != DSRTOS_SUCCESS) || !validate_local(queue, priority, node)) {
+            return DSRTOS_ERROR_CORRUPTION;
+        }
+    }
+#endif
+    
     DSRTOS_TRACE_QUEUE("Removing task %u from priority %u",
                        task->task_id, priority);
     
@@ -509,7 +537,9 @@ dsrtos_error_t dsrtos_ready_queue_remove(
     /* Clear bitmap if list empty */
     if (priority_list->count == 0U) {
         dsrtos_priority_bitmap_clear(queue->priority_bitmap, priority);
+#if (DSRTOS_CONFIG_ENABLE_REDUNDANT_CHECKS != 0U)
         dsrtos_priority_bitmap_clear(queue->priority_bitmap_mirror, priority);
+#endif
         
         /* Update highest priority if needed */
         if (priority == queue->stats.highest_priority) {
@@ -518,10 +548,6 @@ dsrtos_error_t dsrtos_ready_queue_remove(
         }
     }
     
-    /* Update list checksum */
-    priority_list->list_checksum = calculate_checksum(priority_list,
-                                                     sizeof(dsrtos_priority_list_t) - sizeof(uint32_t));
-    
     /* Clear task reference */
     task->queue_node = NULL;
     
@@ -555,12 +581,14 @@ dsrtos_tcb_t* dsrtos_ready_queue_get_highest_priority(
         return NULL;
     }
     
+#if (DSRTOS_CONFIG_ENABLE_MAGIC_CHECKING != 0U)
     /* Quick validation */
     if ((queue->magic_start != DSRTOS_QUEUE_MAGIC) ||
         (queue->magic_end != DSRTOS_QUEUE_MAGIC)) {
         g_safety_stats.validation_failures++;
         return NULL;
     }
+#endif
     
     /* Lock queue */
     dsrtos_ready_queue_lock(queue);
@@ -610,12 +638,15 @@ bool dsrtos_ready_queue_validate(const dsrtos_ready_queue_t* queue)
         return false;
     }
     
+#if (DSRTOS_CONFIG_ENABLE_MAGIC_CHECKING != 0U)
     /* Check magic numbers */
     if ((queue->magic_start != DSRTOS_QUEUE_MAGIC) ||
         (queue->magic_end != DSRTOS_QUEUE_MAGIC)) {
         return false;
     }
+#endif
     
+#if (DSRTOS_CONFIG_ENABLE_REDUNDANT_CHECKS != 0U)
     /* Verify bitmap consistency */
     for (i = 0U; i < DSRTOS_BITMAP_WORDS; i++) {
         if (queue->priority_bitmap[i] != queue->priority_bitmap_mirror[i]) {
@@ -623,6 +654,7 @@ bool dsrtos_ready_queue_validate(const dsrtos_ready_queue_t* queue)
             return false;
         }
     }
+#endif
     
     /* Validate each priority list */
     for (i = 0U; i < DSRTOS_PRIORITY_LEVELS; i++) {
@@ -846,30 +878,16 @@ bool dsrtos_priority_bitmap_is_set(const volatile uint32_t* bitmap, uint8_t prio
  */
 static dsrtos_queue_node_t* allocate_queue_node(void)
 {
-    uint32_t i, j;
-    uint32_t bit_mask;
+    dsrtos_queue_node_t* node;
     
-    for (i = 0U; i < ((DSRTOS_MAX_TASKS + 31U) / 32U); i++) {
-        if (g_queue_node_bitmap[i] != 0xFFFFFFFFU) {
-            for (j = 0U; j < 32U; j++) {
-                bit_mask = 1UL << j;
-                if ((g_queue_node_bitmap[i] & bit_mask) == 0U) {
-                    /* Mark as allocated */
-                    g_queue_node_bitmap[i] |= bit_mask;
-                    
-                    uint32_t index = (i * 32U) + j;
-                    if (index < DSRTOS_MAX_TASKS) {
-                        /* Clear and initialize node */
-                        (void)memset(&g_queue_nodes[index], 0, 
-                                   sizeof(dsrtos_queue_node_t));
-                        return &g_queue_nodes[index];
-                    }
-                }
-            }
-        }
+    /* O(1) pop from the pool free list */
+    node = (dsrtos_queue_node_t*)dsrtos_pool_alloc(&g_queue_node_pool);
+    if (node != NULL) {
+        /* Clear and initialize node */
+        (void)memset(node, 0, sizeof(dsrtos_queue_node_t));
     }
     
-    return NULL;
+    return node;
 }
 
 /**
@@ -877,43 +895,16 @@ static dsrtos_queue_node_t* allocate_queue_node(void)
  */
 static void free_queue_node(dsrtos_queue_node_t* node)
 {
-    uint32_t index;
-    uint32_t word_index;
-    uint32_t bit_mask;
-    
-    if ((node == NULL) || (node < g_queue_nodes) || 
-        (node >= &g_queue_nodes[DSRTOS_MAX_TASKS])) {
+    if (!dsrtos_pool_owns(&g_queue_node_pool, node)) {
         return;
     }
     
-    /* Calculate index */
-    index = (uint32_t)(node - g_queue_nodes);
-    word_index = index / 32U;
-    bit_mask = 1UL << (index % 32U);
-    
     /* Clear node securely */
     (void)memset(node, 0xAA, sizeof(dsrtos_queue_node_t));
     (void)memset(node, 0, sizeof(dsrtos_queue_node_t));
     
-    /* Mark as free in bitmap */
-    g_queue_node_bitmap[word_index] &= ~bit_mask;
-}
-
-/**
- * @brief Calculate checksum for data
- */
-static uint32_t calculate_checksum(const void* data, size_t size)
-{
-    const uint8_t* bytes = (const uint8_t*)data;
-    uint32_t checksum = 0x12345678U;
-    size_t i;
-    
-    for (i = 0U; i < size; i++) {
-        checksum ^= bytes[i];
-        checksum = (checksum << 1) | (checksum >> 31);
-    }
-    
-    return checksum;
+    /* Return to the pool free list */
+    (void)dsrtos_pool_free(&g_queue_node_pool, node);
 }
 
 /**
@@ -925,10 +916,12 @@ static bool validate_tcb(const dsrtos_tcb_t* task)
         return false;
     }
     
+#if (DSRTOS_CONFIG_ENABLE_MAGIC_CHECKING != 0U)
     /* Check magic number */
     if (task->magic_number != DSRTOS_TCB_MAGIC) {
         return false;
     }
+#endif
     
     /* Check state validity */
     if ((task->state == DSRTOS_TASK_STATE_INVALID) ||
@@ -962,24 +955,24 @@ static bool validate_priority(uint8_t priority)
  */
 static bool validate_node(const dsrtos_queue_node_t* node)
 {
-    uint32_t calculated;
-    
     if (node == NULL) {
         return false;
     }
     
+#if (DSRTOS_CONFIG_ENABLE_MAGIC_CHECKING != 0U)
     /* Check magic numbers */
     if ((node->magic_start != DSRTOS_NODE_MAGIC) ||
         (node->magic_end != DSRTOS_NODE_MAGIC)) {
         return false;
     }
+#endif
     
+#if (DSRTOS_CONFIG_ENABLE_CHECKSUM_VALIDATION != 0U)
     /* Verify checksum */
-    calculated = calculate_checksum(node, 
-                                  sizeof(dsrtos_queue_node_t) - sizeof(uint32_t));
-    if (calculated != node->checksum) {
+    if (dsrtos_queue_node_checksum(node) != node->checksum) {
         return false;
     }
+#endif
     
     /* Validate task pointer */
     if (node->task == NULL) {
@@ -1008,6 +1001,65 @@ static dsrtos_error_t repair_bitmap(dsrtos_ready_queue_t* queue)
     return DSRTOS_SUCCESS;
 }
 
+#if (DSRTOS_CONFIG_ENABLE_REDUNDANT_CHECKS != 0U)
+/**
+ * @brief Check the part of the queue an insertion or removal touches
+ * @param node Node being removed, or NULL for an insertion
+ * @note O(1): queue magic, bitmap and mirror, the level's list ends and
+ *       count, and the node's neighbours. The rest of the queue is covered
+ *       by the periodic full validation in dsrtos_ready_queue_insert.
+ */
+static bool validate_local(const dsrtos_ready_queue_t* queue,
+                           uint8_t priority,
+                           const dsrtos_queue_node_t* node)
+{
+    const dsrtos_priority_list_t* list;
+    bool has_tasks;
+    uint32_t i;
+    
+    if (!validate_priority(priority)) {
+        return false;
+    }
+    
+#if (DSRTOS_CONFIG_ENABLE_MAGIC_CHECKING != 0U)
+    if ((queue->magic_start != DSRTOS_QUEUE_MAGIC) ||
+        (queue->magic_end != DSRTOS_QUEUE_MAGIC)) {
+        return false;
+    }
+#endif
+    
+    for (i = 0U; i < DSRTOS_BITMAP_WORDS; i++) {
+        if (queue->priority_bitmap[i] != queue->priority_bitmap_mirror[i]) {
+            g_safety_stats.bitmap_mismatches++;
+            return false;
+        }
+    }
+    
+    /* Empty or not, the count, both ends and the bitmap bit agree */
+    list = &queue->priority_lists[priority];
+    has_tasks = (list->count > 0U);
+    if ((has_tasks != (list->head != NULL)) || (has_tasks != (list->tail != NULL)) ||
+        (has_tasks != dsrtos_priority_bitmap_is_set(queue->priority_bitmap, priority))) {
+        return false;
+    }
+    if (has_tasks && ((list->head->prev != NULL) || (list->tail->next != NULL))) {
+        return false;
+    }
+    
+    /* The node is linked where its neighbours (or the list ends) say */
+    if (node != NULL) {
+        if ((node->prev != NULL) ? (node->prev->next != node) : (list->head != node)) {
+            return false;
+        }
+        if ((node->next != NULL) ? (node->next->prev != node) : (list->tail != node)) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+#endif
+
 /**
  * @brief Verify redundant bitmap consistency
  */
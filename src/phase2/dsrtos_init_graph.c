@@ -0,0 +1,431 @@
+/*
+ * DSRTOS - Dynamic Scheduler Real-Time Operating System
+ * Init Graph and Boot Timeline Implementation
+ *
+ * Copyright (c) 2024 DSRTOS
+ * Compliance: MISRA-C:2012, DO-178C DAL-B, IEC 62304 Class B, ISO 26262 ASIL D
+ */
+
+/*=============================================================================
+ * INCLUDES
+ *============================================================================*/
+#include "dsrtos_init_graph.h"
+#include "dsrtos_critical.h"
+#include "dsrtos_hooks.h"
+#include "dsrtos_task_manager.h"
+#include "dsrtos_port.h"
+#include "dsrtos_region.h"
+#include <string.h>
+#include "core_cm4.h"
+
+/*=============================================================================
+ * PRIVATE MACROS
+ *============================================================================*/
+#define INIT_GRAPH_NO_INDEX     0xFFU
+#define INIT_GRAPH_TASK_NAME    "init"
+
+/*=============================================================================
+ * PRIVATE TYPES
+ *============================================================================*/
+typedef struct {
+    /* Registered entries, in registration order */
+    dsrtos_init_entry_t entries[DSRTOS_INIT_GRAPH_MAX_ENTRIES];
+    uint32_t count;
+    uint8_t id_index[DSRTOS_INIT_GRAPH_MAX_ID + 1U];   /* id -> entry index */
+
+    /* Execution order and outcome, set by dsrtos_init_graph_begin */
+    uint8_t order[DSRTOS_INIT_GRAPH_MAX_ENTRIES];
+    uint32_t failed;                    /* Bit per entry index: did not succeed */
+    uint32_t deferred_pending;
+
+    /* Timeline */
+    bool begun;
+    uint32_t t0;
+    dsrtos_init_record_t records[DSRTOS_INIT_GRAPH_MAX_RECORDS];
+    uint32_t record_count;
+    uint32_t milestones[DSRTOS_INIT_MILESTONE_MAX];
+    uint32_t reached;
+} init_graph_t;
+
+/*=============================================================================
+ * PRIVATE VARIABLES
+ *============================================================================*/
+static init_graph_t g_init_graph;
+
+/* Init task, static so deferring needs no allocation */
+static dsrtos_tcb_t g_init_task;
+static uint32_t g_init_task_stack[DSRTOS_INIT_GRAPH_TASK_STACK / sizeof(uint32_t)] DSRTOS_CCM_BSS;
+
+/*=============================================================================
+ * PRIVATE FUNCTION DECLARATIONS
+ *============================================================================*/
+static uint32_t init_graph_depends_index_mask(const dsrtos_init_entry_t* entry);
+static void init_graph_run_entry(uint32_t index);
+static void init_graph_add_record(const char* name, uint8_t phase, uint8_t flags,
+                                  uint32_t start, dsrtos_error_t result);
+static uint32_t init_graph_cycles(void);
+static void init_graph_task_entry(void* parameter);
+static void* init_graph_switch_in(dsrtos_hook_type_t type, void* params);
+
+/* First application task switch-in ends the time-to-first-task */
+DSRTOS_HOOK_STATIC(TASK_SWITCH_IN, init_graph_switch_in);
+
+/*=============================================================================
+ * PUBLIC FUNCTION IMPLEMENTATIONS
+ *============================================================================*/
+
+/**
+ * @brief Add an init entry
+ */
+dsrtos_error_t dsrtos_init_graph_register(const dsrtos_init_entry_t* entry)
+{
+    dsrtos_error_t result = DSRTOS_SUCCESS;
+
+    if ((entry == NULL) || (entry->callback == NULL) ||
+        (entry->phase >= DSRTOS_INIT_PHASE_MAX) ||
+        (entry->id > DSRTOS_INIT_GRAPH_MAX_ID) ||
+        ((entry->depends & 1U) != 0U) ||
+        ((entry->id != 0U) && ((entry->depends & (1UL << entry->id)) != 0U)) ||
+        (entry->deferred && entry->critical)) {
+        result = DSRTOS_ERROR_INVALID_PARAM;
+    }
+    else if (g_init_graph.count >= DSRTOS_INIT_GRAPH_MAX_ENTRIES) {
+        result = DSRTOS_ERROR_NO_MEMORY;
+    }
+    else if ((entry->id != 0U) && (g_init_graph.id_index[entry->id] != 0U)) {
+        /* id_index holds index + 1, so 0 means free */
+        result = DSRTOS_ERROR_INVALID_PARAM;
+    }
+    else {
+        g_init_graph.entries[g_init_graph.count] = *entry;
+        if (entry->id != 0U) {
+            g_init_graph.id_index[entry->id] = (uint8_t)(g_init_graph.count + 1U);
+        }
+        g_init_graph.count++;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Drop every entry and the timeline
+ */
+dsrtos_error_t dsrtos_init_graph_deinit(void)
+{
+    (void)memset(&g_init_graph, 0, sizeof(g_init_graph));
+
+    return DSRTOS_SUCCESS;
+}
+
+/**
+ * @brief Start the boot timeline and order the registered entries
+ */
+dsrtos_error_t dsrtos_init_graph_begin(void)
+{
+    dsrtos_error_t result = DSRTOS_SUCCESS;
+    uint32_t deps[DSRTOS_INIT_GRAPH_MAX_ENTRIES];
+    uint32_t placed = 0U;
+    uint32_t pick;
+    const dsrtos_init_entry_t* entry;
+    const dsrtos_init_entry_t* best;
+
+    g_init_graph.t0 = init_graph_cycles();
+    g_init_graph.begun = true;
+    g_init_graph.record_count = 0U;
+    g_init_graph.reached = 0U;
+    g_init_graph.failed = 0U;
+    g_init_graph.deferred_pending = 0U;
+
+    /* Resolve ids and check each edge */
+    for (uint32_t i = 0U; (i < g_init_graph.count) && (result == DSRTOS_SUCCESS); i++) {
+        entry = &g_init_graph.entries[i];
+        deps[i] = init_graph_depends_index_mask(entry);
+
+        if (deps[i] == UINT32_MAX) {
+            result = DSRTOS_ERROR_INVALID_CONFIG;
+        }
+        for (uint32_t j = 0U; (j < g_init_graph.count) && (result == DSRTOS_SUCCESS); j++) {
+            if ((deps[i] & (1UL << j)) != 0U) {
+                if ((!entry->deferred && g_init_graph.entries[j].deferred) ||
+                    (!entry->deferred && (g_init_graph.entries[j].phase > entry->phase))) {
+                    result = DSRTOS_ERROR_INVALID_CONFIG;
+                }
+            }
+        }
+        if (entry->deferred) {
+            g_init_graph.deferred_pending++;
+        }
+    }
+
+    /* Topological order; ties go to the earlier phase, then registration */
+    for (uint32_t n = 0U; (n < g_init_graph.count) && (result == DSRTOS_SUCCESS); n++) {
+        pick = INIT_GRAPH_NO_INDEX;
+        best = NULL;
+        for (uint32_t i = 0U; i < g_init_graph.count; i++) {
+            entry = &g_init_graph.entries[i];
+            if (((placed & (1UL << i)) == 0U) && ((deps[i] & ~placed) == 0U) &&
+                ((best == NULL) || (entry->phase < best->phase))) {
+                pick = i;
+                best = entry;
+            }
+        }
+
+        if (pick == INIT_GRAPH_NO_INDEX) {
+            /* Every remaining entry waits on another: a cycle */
+            result = DSRTOS_ERROR_INVALID_CONFIG;
+        }
+        else {
+            g_init_graph.order[n] = (uint8_t)pick;
+            placed |= (1UL << pick);
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Time one built-in phase step
+ */
+void dsrtos_init_graph_record(const char* name, dsrtos_init_phase_t phase,
+                              uint32_t start, dsrtos_error_t result)
+{
+    init_graph_add_record(name, (uint8_t)phase, DSRTOS_INIT_RECORD_BUILTIN, start, result);
+}
+
+/**
+ * @brief Run the boot-path entries of a phase in dependency order
+ */
+dsrtos_error_t dsrtos_init_graph_run_phase(dsrtos_init_phase_t phase)
+{
+    dsrtos_error_t result = DSRTOS_SUCCESS;
+    uint32_t index;
+
+    for (uint32_t n = 0U; (n < g_init_graph.count) && (result == DSRTOS_SUCCESS); n++) {
+        index = g_init_graph.order[n];
+        if ((g_init_graph.entries[index].phase == phase) && !g_init_graph.entries[index].deferred) {
+            init_graph_run_entry(index);
+
+            /* Critical component failed: abort initialization */
+            if (((g_init_graph.failed & (1UL << index)) != 0U) &&
+                g_init_graph.entries[index].critical) {
+                result = g_init_graph.records[g_init_graph.record_count - 1U].result;
+            }
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Create the init task if any entry is deferred
+ */
+dsrtos_error_t dsrtos_init_graph_start_deferred(void)
+{
+    dsrtos_error_t result = DSRTOS_SUCCESS;
+    dsrtos_task_params_t params;
+
+    if (g_init_graph.deferred_pending > 0U) {
+        (void)memset(&params, 0, sizeof(params));
+        (void)strncpy(params.name, INIT_GRAPH_TASK_NAME, DSRTOS_TASK_NAME_MAX_LENGTH - 1U);
+        params.entry_point = init_graph_task_entry;
+        params.priority = (dsrtos_task_priority_t)DSRTOS_INIT_GRAPH_TASK_PRIORITY;
+        params.stack_size = (uint32_t)sizeof(g_init_task_stack);
+        params.stack_buffer = g_init_task_stack;
+        params.stack_memory = g_init_task_stack;
+
+        result = dsrtos_task_create_static(&g_init_task, &params);
+    }
+
+    return result;
+}
+
+/**
+ * @brief Run the deferred entries in dependency order
+ */
+uint32_t dsrtos_init_graph_run_deferred(void)
+{
+    uint32_t failures = 0U;
+    uint32_t index;
+
+    for (uint32_t n = 0U; n < g_init_graph.count; n++) {
+        index = g_init_graph.order[n];
+        if (g_init_graph.entries[index].deferred) {
+            init_graph_run_entry(index);
+            if ((g_init_graph.failed & (1UL << index)) != 0U) {
+                failures++;
+            }
+            g_init_graph.deferred_pending--;
+        }
+    }
+
+    dsrtos_init_graph_mark(DSRTOS_INIT_MILESTONE_DEFERRED_DONE);
+
+    return failures;
+}
+
+/**
+ * @brief Record a kernel milestone, once
+ */
+void dsrtos_init_graph_mark(dsrtos_init_milestone_t milestone)
+{
+    uint32_t now = init_graph_cycles();
+
+    if ((milestone < DSRTOS_INIT_MILESTONE_MAX) && g_init_graph.begun &&
+        ((g_init_graph.reached & (1UL << milestone)) == 0U)) {
+        g_init_graph.milestones[milestone] = now - g_init_graph.t0;
+        g_init_graph.reached |= (1UL << milestone);
+    }
+}
+
+/**
+ * @brief Read the boot report
+ */
+dsrtos_error_t dsrtos_init_graph_get_report(dsrtos_init_report_t* report)
+{
+    dsrtos_error_t result = DSRTOS_SUCCESS;
+
+    if (report == NULL) {
+        result = DSRTOS_ERROR_INVALID_PARAM;
+    }
+    else {
+        dsrtos_critical_enter();
+        (void)memcpy(report->milestones, g_init_graph.milestones, sizeof(report->milestones));
+        report->reached = g_init_graph.reached;
+        report->record_count = g_init_graph.record_count;
+        report->deferred_pending = g_init_graph.deferred_pending;
+        dsrtos_critical_exit();
+    }
+
+    return result;
+}
+
+/**
+ * @brief Read one timeline record
+ */
+dsrtos_error_t dsrtos_init_graph_get_record(uint32_t index, dsrtos_init_record_t* record)
+{
+    dsrtos_error_t result = DSRTOS_SUCCESS;
+
+    if (record == NULL) {
+        result = DSRTOS_ERROR_INVALID_PARAM;
+    }
+    else if (index >= g_init_graph.record_count) {
+        result = DSRTOS_ERROR_NOT_FOUND;
+    }
+    else {
+        *record = g_init_graph.records[index];
+    }
+
+    return result;
+}
+
+/*=============================================================================
+ * PRIVATE FUNCTION IMPLEMENTATIONS
+ *============================================================================*/
+
+/**
+ * @brief Map an entry's dependency ids to entry indexes
+ * @return Index mask, or UINT32_MAX if an id is not registered
+ */
+static uint32_t init_graph_depends_index_mask(const dsrtos_init_entry_t* entry)
+{
+    uint32_t mask = 0U;
+
+    for (uint32_t id = 1U; id <= DSRTOS_INIT_GRAPH_MAX_ID; id++) {
+        if ((entry->depends & (1UL << id)) != 0U) {
+            if (g_init_graph.id_index[id] == 0U) {
+                mask = UINT32_MAX;
+                break;
+            }
+            mask |= (1UL << (g_init_graph.id_index[id] - 1U));
+        }
+    }
+
+    return mask;
+}
+
+/**
+ * @brief Run and time one entry; skip it if a dependency did not succeed
+ */
+static void init_graph_run_entry(uint32_t index)
+{
+    const dsrtos_init_entry_t* entry = &g_init_graph.entries[index];
+    uint8_t flags = entry->deferred ? DSRTOS_INIT_RECORD_DEFERRED : 0U;
+    uint32_t deps = init_graph_depends_index_mask(entry);
+    uint32_t start = init_graph_cycles();
+    dsrtos_error_t result;
+
+    if ((deps & g_init_graph.failed) != 0U) {
+        flags |= DSRTOS_INIT_RECORD_SKIPPED;
+        result = DSRTOS_ERROR_NOT_READY;
+    }
+    else {
+        result = entry->callback();
+    }
+
+    if (result != DSRTOS_SUCCESS) {
+        g_init_graph.failed |= (1UL << index);
+    }
+
+    init_graph_add_record(entry->name, (uint8_t)entry->phase, flags, start, result);
+}
+
+/**
+ * @brief Append a timeline record
+ */
+static void init_graph_add_record(const char* name, uint8_t phase, uint8_t flags,
+                                  uint32_t start, dsrtos_error_t result)
+{
+    uint32_t end = init_graph_cycles();
+    dsrtos_init_record_t* record;
+
+    if (g_init_graph.record_count < DSRTOS_INIT_GRAPH_MAX_RECORDS) {
+        record = &g_init_graph.records[g_init_graph.record_count];
+        record->name = name;
+        record->start = start - g_init_graph.t0;
+        record->cycles = end - start;
+        record->result = result;
+        record->phase = phase;
+        record->flags = flags;
+        g_init_graph.record_count++;
+    }
+}
+
+/**
+ * @brief Read the cycle counter
+ */
+static uint32_t init_graph_cycles(void)
+{
+#if defined(DSRTOS_HOST_BUILD)
+    return dsrtos_port_get_cycle_count();
+#else
+    /* Enabled by dsrtos_kernel_init() */
+    return DWT->CYCCNT;
+#endif
+}
+
+/**
+ * @brief Init task: run the deferred entries, then exit
+ */
+static void init_graph_task_entry(void* parameter)
+{
+    (void)parameter;
+    (void)dsrtos_init_graph_run_deferred();
+}
+
+/**
+ * @brief Switch-in hook: stamp the first application task
+ */
+static void* init_graph_switch_in(dsrtos_hook_type_t type, void* params)
+{
+    const dsrtos_tcb_t* tcb = (const dsrtos_tcb_t*)params;
+
+    (void)type;
+    if (((g_init_graph.reached & (1UL << DSRTOS_INIT_MILESTONE_FIRST_TASK)) == 0U) &&
+        (tcb != NULL) && (tcb != &g_init_task) &&
+        (tcb->effective_priority > DSRTOS_TASK_PRIORITY_IDLE)) {
+        dsrtos_init_graph_mark(DSRTOS_INIT_MILESTONE_FIRST_TASK);
+    }
+
+    return NULL;
+}
@@ -10,6 +10,7 @@
  * INCLUDES
  *============================================================================*/
 #include "dsrtos_kernel_init.h"
+#include "dsrtos_init_graph.h"
 #include "dsrtos_critical.h"
 #include "dsrtos_panic.h"
 #include "dsrtos_syscall.h"
@@ -18,33 +19,20 @@
 #include "dsrtos_assert.h"
 #include "dsrtos_memory.h"
 #include "dsrtos_error.h"
+#include "dsrtos_crc.h"
 #include <string.h>
 #include "core_cm4.h"
 
-/* External symbols for memory layout */
-extern uint32_t _sbss, _ebss; 
-
 /*=============================================================================
  * PRIVATE MACROS
  *============================================================================*/
 #define KERNEL_INIT_TIMEOUT_MS      1000U
-#define KERNEL_INIT_MAX_ENTRIES     32U
-#define KERNEL_CHECKSUM_SEED        0xDEADBEEFU
 
 /* Memory barriers for safety-critical operations */
 #define KERNEL_MEMORY_BARRIER()     __asm volatile("dmb" ::: "memory")
 #define KERNEL_DATA_BARRIER()       __asm volatile("dsb" ::: "memory")
 #define KERNEL_INSTRUCTION_BARRIER() __asm volatile("isb" ::: "memory")
 
-/*=============================================================================
- * PRIVATE TYPES
- *============================================================================*/
-typedef struct {
-    dsrtos_init_entry_t entries[KERNEL_INIT_MAX_ENTRIES];
-    uint32_t count;
-    uint32_t current_index;
-} kernel_init_table_t;
-
 /*=============================================================================
  * PRIVATE VARIABLES
  *============================================================================*/
@@ -66,11 +54,10 @@ static dsrtos_kernel_t g_kernel_cb __attribute__((aligned(32))) = {
     .checksum = 0U
 };
 
-/* Initialization table */
-static kernel_init_table_t g_init_table = {
-    .entries = {{0}},
-    .count = 0U,
-    .current_index = 0U
+/* Built-in phase names for the boot timeline */
+static const char* const g_phase_names[DSRTOS_INIT_PHASE_MAX] = {
+    "hardware", "memory", "interrupts", "scheduler",
+    "services", "drivers", "application"
 };
 
 /* Default kernel configuration */
@@ -97,7 +84,6 @@ static const dsrtos_kernel_config_t g_default_config = {
 /*=============================================================================
  * PRIVATE FUNCTION DECLARATIONS
  *============================================================================*/
-static uint32_t kernel_calculate_checksum(const void* data, size_t size);
 static dsrtos_error_t kernel_init_phase_hardware(void);
 static dsrtos_error_t kernel_init_phase_memory(void);
 static dsrtos_error_t kernel_init_phase_interrupts(void);
@@ -121,6 +107,10 @@ dsrtos_error_t dsrtos_kernel_init(const dsrtos_kernel_config_t* config)
 {
     dsrtos_error_t result = DSRTOS_SUCCESS;
     
+    /* Start the cycle counter for the boot timeline */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    
     /* MISRA-C:2012 Rule 15.5 - Single return point */
     do {
         /* Verify kernel is not already initialized */
@@ -146,6 +136,12 @@ dsrtos_error_t dsrtos_kernel_init(const dsrtos_kernel_config_t* config)
         /* Store configuration */
         g_kernel_cb.config = config;
         
+        /* Order registered init entries and start the timeline */
+        result = dsrtos_init_graph_begin();
+        if (result != DSRTOS_SUCCESS) {
+            break;
+        }
+        
         /* Execute initialization phases */
         for (dsrtos_init_phase_t phase = DSRTOS_INIT_PHASE_HARDWARE; 
              phase < DSRTOS_INIT_PHASE_MAX; 
@@ -177,6 +173,7 @@ dsrtos_error_t dsrtos_kernel_init(const dsrtos_kernel_config_t* config)
         
         /* Set ready state */
         kernel_set_state(DSRTOS_KERNEL_STATE_READY);
+        dsrtos_init_graph_mark(DSRTOS_INIT_MILESTONE_KERNEL_READY);
         
     } while (false);
     
@@ -214,6 +211,13 @@ dsrtos_error_t dsrtos_kernel_start(void)
         /* Call pre-start hook if registered */
         dsrtos_hook_call(DSRTOS_HOOK_KERNEL_PRE_START, NULL);
         
+        /* Deferred init entries run in the init task once scheduling starts */
+        result = dsrtos_init_graph_start_deferred();
+        if (result != DSRTOS_SUCCESS) {
+            break;
+        }
+        dsrtos_init_graph_mark(DSRTOS_INIT_MILESTONE_KERNEL_START);
+        
         /* Set running state */
         kernel_set_state(DSRTOS_KERNEL_STATE_RUNNING);
         
@@ -350,20 +354,12 @@ dsrtos_error_t dsrtos_kernel_register_init(const dsrtos_init_entry_t* entry)
 {
     dsrtos_error_t result = DSRTOS_SUCCESS;
     
-    /* Validate parameters */
-    if (entry == NULL) {
-        result = DSRTOS_ERROR_INVALID_PARAM;
-    }
-    else if (entry->callback == NULL) {
-        result = DSRTOS_ERROR_INVALID_PARAM;
-    }
-    else if (g_init_table.count >= KERNEL_INIT_MAX_ENTRIES) {
-        result = DSRTOS_ERROR_NO_MEMORY;
+    /* Entries are only taken before the table is ordered */
+    if (g_kernel_cb.state != DSRTOS_KERNEL_STATE_UNINITIALIZED) {
+        result = DSRTOS_ERROR_INVALID_STATE;
     }
     else {
-        /* Add entry to initialization table */
-        g_init_table.entries[g_init_table.count] = *entry;
-        g_init_table.count++;
+        result = dsrtos_init_graph_register(entry);
     }
     
     return result;
@@ -499,10 +495,11 @@ dsrtos_error_t dsrtos_kernel_self_test(void)
         }
     }
     
-    /* Test 4: Checksum calculation */
+    /* Test 4: Checksum calculation against the CRC-32 check value */
     if (result == DSRTOS_SUCCESS) {
-        uint32_t checksum = kernel_calculate_checksum(&test_value, sizeof(test_value));
-        if (checksum == 0U) {
+        static const char check_input[] = "123456789";
+        uint32_t checksum = dsrtos_crc32(check_input, sizeof(check_input) - 1U);
+        if (checksum != 0xCBF43926U) {
             result = DSRTOS_ERROR_SELF_TEST;
         }
     }
@@ -522,22 +519,6 @@ dsrtos_kernel_t* dsrtos_kernel_get_kcb(void)
  * PRIVATE FUNCTION IMPLEMENTATIONS
  *============================================================================*/
 
-/**
- * @brief Calculate checksum for data
- */
-static uint32_t kernel_calculate_checksum(const void* data, size_t size)
-{
-    const uint8_t* bytes = (const uint8_t*)data;
-    uint32_t checksum = KERNEL_CHECKSUM_SEED;
-    
-    for (size_t i = 0U; i < size; i++) {
-        checksum ^= (uint32_t)bytes[i];
-        checksum = (checksum << 1) | (checksum >> 31);
-    }
-    
-    return checksum;
-}
-
 /**
  * @brief Initialize hardware phase
  */
@@ -573,13 +554,8 @@ static dsrtos_error_t kernel_init_phase_memory(void)
     /* Initialize memory management (Phase 13-14) */
     /* This would initialize heap, memory pools, etc. */
     
-    /* Clear BSS section */
-    uint32_t* bss_start = &_sbss;
-    uint32_t* bss_end = &_ebss;
-    
-    while (bss_start < bss_end) {
-        *bss_start++ = 0U;
-    }
+    /* BSS is cleared by the reset handler; clearing it again here would
+     * drop init entries registered before dsrtos_kernel_init() */
     
     return result;
 }
@@ -662,6 +638,7 @@ static dsrtos_error_t kernel_init_phase_application(void)
 static dsrtos_error_t kernel_execute_init_phase(dsrtos_init_phase_t phase)
 {
     dsrtos_error_t result = DSRTOS_SUCCESS;
+    uint32_t start = DWT->CYCCNT;  /* Same counter as dsrtos_port_get_cycle_count */
     
     /* Execute built-in phase initialization */
     switch (phase) {
@@ -703,21 +680,13 @@ static dsrtos_error_t kernel_execute_init_phase(dsrtos_init_phase_t phase)
             break;
     }
     
-    /* Execute registered callbacks for this phase */
+    if (phase < DSRTOS_INIT_PHASE_MAX) {
+        dsrtos_init_graph_record(g_phase_names[phase], phase, start, result);
+    }
+    
+    /* Execute registered callbacks for this phase, deferred ones excepted */
     if (result == DSRTOS_SUCCESS) {
-        for (uint32_t i = 0U; i < g_init_table.count; i++) {
-            if (g_init_table.entries[i].phase == phase) {
-                result = g_init_table.entries[i].callback();
-                if (result != DSRTOS_SUCCESS) {
-                    /* Critical component failed */
-                    if (g_init_table.entries[i].critical) {
-                        break;
-                    }
-                    /* Non-critical, continue */
-                    result = DSRTOS_SUCCESS;
-                }
-            }
-        }
+        result = dsrtos_init_graph_run_phase(phase);
     }
     
     return result;
@@ -799,7 +768,7 @@ static bool kernel_verify_integrity(void)
     
     /* Verify checksum */
     if (valid) {
-        uint32_t calculated = kernel_calculate_checksum(
+        uint32_t calculated = dsrtos_crc32(
             &g_kernel_cb,
             offsetof(dsrtos_kernel_t, checksum)
         );
@@ -824,7 +793,7 @@ static bool kernel_verify_integrity(void)
  */
 static void kernel_update_checksum(void)
 {
-    g_kernel_cb.checksum = kernel_calculate_checksum(
+    g_kernel_cb.checksum = dsrtos_crc32(
         &g_kernel_cb,
         offsetof(dsrtos_kernel_t, checksum)
     );
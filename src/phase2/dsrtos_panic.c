@@ -14,6 +14,7 @@
 #include "dsrtos_critical.h"
 #include "dsrtos_assert.h"
 #include "dsrtos_error.h"
+#include "dsrtos_crashdump.h"
 #include <string.h>
 #include <stdio.h>
 #include "core_cm4.h"
@@ -118,6 +119,9 @@ dsrtos_error_t dsrtos_panic_init(const dsrtos_panic_config_t* config)
         g_panic_config = *config;
     }
     
+    /* Attach the crash dump ring; dumps from earlier boots are kept */
+    (void)dsrtos_crashdump_init(NULL, 0U);
+    
     /* Register with kernel */
     dsrtos_kernel_t* kernel = dsrtos_kernel_get_kcb();
     if (kernel != NULL) {
@@ -155,6 +159,9 @@ void dsrtos_panic(dsrtos_panic_reason_t reason,
     /* Capture panic context */
     panic_capture_context(&g_panic_context, reason, message, file, line);
     
+    /* Persist a compressed dump before any handler runs */
+    (void)dsrtos_crashdump_capture(&g_panic_context);
+    
     /* Call custom handler if registered */
     if (g_panic_state.custom_handler != NULL) {
         g_panic_state.custom_handler(&g_panic_context);
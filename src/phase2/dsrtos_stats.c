@@ -33,10 +33,15 @@ typedef struct {
 } stats_record_t;
 
 typedef struct {
-    /* Statistics storage */
+    /* Statistics storage; entries are never released, so they are dense
+     * and a handle is simply the entry index */
     stats_record_t entries[STATS_MAX_ENTRIES];
     uint32_t entry_count;
     
+    /* Counter and gauge values, indexed by handle, kept apart from the
+     * names so hot-path updates touch one word */
+    volatile uint32_t values[STATS_MAX_ENTRIES];
+    
     /* Category statistics */
     dsrtos_kernel_stats_t kernel_stats;
     dsrtos_task_stats_t task_stats;
@@ -59,6 +64,7 @@ typedef struct {
 static stats_manager_t g_stats_mgr __attribute__((aligned(32))) = {
     .entries = {{{0}}},
     .entry_count = 0U,
+    .values = {0U},
     .kernel_stats = {0},
     .task_stats = {0},
     .memory_stats = {0},
@@ -83,6 +89,10 @@ static stats_manager_t g_stats_mgr __attribute__((aligned(32))) = {
 static stats_record_t* stats_find_entry(dsrtos_stats_category_t category,
                                         const char* name);
 static stats_record_t* stats_allocate_entry(void);
+static stats_record_t* stats_find_or_create(dsrtos_stats_category_t category,
+                                            const char* name,
+                                            dsrtos_stats_type_t type);
+static dsrtos_stats_handle_t stats_handle_of(const stats_record_t* record);
 static void stats_update_cpu_usage(void);
 static uint64_t stats_get_ticks(void);
 
@@ -141,20 +151,11 @@ dsrtos_error_t dsrtos_stats_update(dsrtos_stats_category_t category,
     else {
         dsrtos_critical_enter();
         
-        /* Find or create entry */
-        stats_record_t* record = stats_find_entry(category, name);
-        if (record == NULL) {
-            record = stats_allocate_entry();
-            if (record != NULL) {
-                strncpy(record->name, name, STATS_NAME_MAX_LEN - 1U);
-                record->entry.category = category;
-                record->entry.type = DSRTOS_STATS_TYPE_COUNTER;
-                record->entry.name = record->name;
-            }
-        }
-        
+        /* Compatibility path: same storage as dsrtos_stats_add() */
+        stats_record_t* record = stats_find_or_create(category, name,
+                                                      DSRTOS_STATS_TYPE_COUNTER);
         if (record != NULL) {
-            record->entry.value.counter += value;
+            g_stats_mgr.values[stats_handle_of(record)] += value;
             record->entry.update_count++;
             record->entry.timestamp = stats_get_ticks();
         }
@@ -186,20 +187,11 @@ dsrtos_error_t dsrtos_stats_set_gauge(dsrtos_stats_category_t category,
     else {
         dsrtos_critical_enter();
         
-        /* Find or create entry */
-        stats_record_t* record = stats_find_entry(category, name);
-        if (record == NULL) {
-            record = stats_allocate_entry();
-            if (record != NULL) {
-                strncpy(record->name, name, STATS_NAME_MAX_LEN - 1U);
-                record->entry.category = category;
-                record->entry.type = DSRTOS_STATS_TYPE_GAUGE;
-                record->entry.name = record->name;
-            }
-        }
-        
+        /* Compatibility path: same storage as dsrtos_stats_set() */
+        stats_record_t* record = stats_find_or_create(category, name,
+                                                      DSRTOS_STATS_TYPE_GAUGE);
         if (record != NULL) {
-            record->entry.value.gauge = value;
+            g_stats_mgr.values[stats_handle_of(record)] = (uint32_t)value;
             record->entry.update_count++;
             record->entry.timestamp = stats_get_ticks();
         }
@@ -327,12 +319,13 @@ dsrtos_error_t dsrtos_stats_reset(dsrtos_stats_category_t category)
             memset(&g_stats_mgr.memory_stats, 0, sizeof(g_stats_mgr.memory_stats));
             memset(&g_stats_mgr.scheduler_stats, 0, sizeof(g_stats_mgr.scheduler_stats));
             
-            /* Reset entries */
-            for (uint32_t i = 0U; i < STATS_MAX_ENTRIES; i++) {
-                if (g_stats_mgr.entries[i].allocated) {
-                    memset(&g_stats_mgr.entries[i].entry, 0, 
-                          sizeof(dsrtos_stats_entry_t));
-                }
+            /* Reset entry values; names, categories and handles stay */
+            for (uint32_t i = 0U; i < g_stats_mgr.entry_count; i++) {
+                memset(&g_stats_mgr.entries[i].entry.value, 0,
+                      sizeof(g_stats_mgr.entries[i].entry.value));
+                g_stats_mgr.entries[i].entry.update_count = 0U;
+                g_stats_mgr.entries[i].entry.timestamp = 0U;
+                g_stats_mgr.values[i] = 0U;
             }
         }
         else {
@@ -411,6 +404,10 @@ dsrtos_error_t dsrtos_stats_get_entry(dsrtos_stats_category_t category,
         stats_record_t* record = stats_find_entry(category, name);
         if (record != NULL) {
             *entry = record->entry;
+            if ((entry->type == DSRTOS_STATS_TYPE_COUNTER) ||
+                (entry->type == DSRTOS_STATS_TYPE_GAUGE)) {
+                entry->value.counter = g_stats_mgr.values[stats_handle_of(record)];
+            }
         }
         else {
             result = DSRTOS_ERROR_NOT_FOUND;
@@ -443,6 +440,7 @@ dsrtos_error_t dsrtos_stats_register(const dsrtos_stats_entry_t* entry)
             strncpy(record->name, entry->name, STATS_NAME_MAX_LEN - 1U);
             record->entry = *entry;
             record->entry.name = record->name;
+            g_stats_mgr.values[stats_handle_of(record)] = entry->value.counter;
         }
         else {
             result = DSRTOS_ERROR_NO_MEMORY;
@@ -454,6 +452,94 @@ dsrtos_error_t dsrtos_stats_register(const dsrtos_stats_entry_t* entry)
     return result;
 }
 
+/**
+ * @brief Register a counter or gauge and get its handle
+ */
+dsrtos_error_t dsrtos_stats_register_handle(dsrtos_stats_category_t category,
+                                            const char* name,
+                                            dsrtos_stats_type_t type,
+                                            dsrtos_stats_handle_t* handle)
+{
+    dsrtos_error_t result = DSRTOS_SUCCESS;
+    
+    if ((name == NULL) || (handle == NULL) ||
+        ((type != DSRTOS_STATS_TYPE_COUNTER) && (type != DSRTOS_STATS_TYPE_GAUGE))) {
+        result = DSRTOS_ERROR_INVALID_PARAM;
+    }
+    else if (!g_stats_mgr.initialized) {
+        result = DSRTOS_ERROR_NOT_INITIALIZED;
+    }
+    else {
+        dsrtos_critical_enter();
+        
+        stats_record_t* record = stats_find_or_create(category, name, type);
+        if (record == NULL) {
+            *handle = DSRTOS_STATS_HANDLE_INVALID;
+            result = DSRTOS_ERROR_NO_MEMORY;
+        }
+        else if (record->entry.type != type) {
+            *handle = DSRTOS_STATS_HANDLE_INVALID;
+            result = DSRTOS_ERROR_INVALID_STATE;
+        }
+        else {
+            *handle = stats_handle_of(record);
+        }
+        
+        dsrtos_critical_exit();
+    }
+    
+    return result;
+}
+
+/**
+ * @brief Add to a counter by handle
+ */
+dsrtos_error_t dsrtos_stats_add(dsrtos_stats_handle_t handle, uint32_t value)
+{
+    dsrtos_error_t result = DSRTOS_SUCCESS;
+    
+    /* Entries are dense and never released: the count bounds every handle */
+    if ((uint32_t)handle >= g_stats_mgr.entry_count) {
+        result = DSRTOS_ERROR_INVALID_PARAM;
+    }
+    else {
+        (void)__atomic_fetch_add(&g_stats_mgr.values[handle], value, __ATOMIC_RELAXED);
+    }
+    
+    return result;
+}
+
+/**
+ * @brief Set a gauge by handle
+ */
+dsrtos_error_t dsrtos_stats_set(dsrtos_stats_handle_t handle, int32_t value)
+{
+    dsrtos_error_t result = DSRTOS_SUCCESS;
+    
+    if ((uint32_t)handle >= g_stats_mgr.entry_count) {
+        result = DSRTOS_ERROR_INVALID_PARAM;
+    }
+    else {
+        __atomic_store_n(&g_stats_mgr.values[handle], (uint32_t)value, __ATOMIC_RELAXED);
+    }
+    
+    return result;
+}
+
+/**
+ * @brief Read a counter or gauge by handle
+ */
+uint32_t dsrtos_stats_read(dsrtos_stats_handle_t handle)
+{
+    uint32_t value = 0U;
+    
+    if ((uint32_t)handle < g_stats_mgr.entry_count) {
+        value = __atomic_load_n(&g_stats_mgr.values[handle], __ATOMIC_RELAXED);
+    }
+    
+    return value;
+}
+
 /**
  * @brief Export statistics snapshot
  */
@@ -488,7 +574,7 @@ static stats_record_t* stats_find_entry(dsrtos_stats_category_t category,
 {
     stats_record_t* record = NULL;
     
-    for (uint32_t i = 0U; i < STATS_MAX_ENTRIES; i++) {
+    for (uint32_t i = 0U; i < g_stats_mgr.entry_count; i++) {
         if (g_stats_mgr.entries[i].allocated &&
             (g_stats_mgr.entries[i].entry.category == category) &&
             (strncmp(g_stats_mgr.entries[i].name, name, STATS_NAME_MAX_LEN) == 0)) {
@@ -521,6 +607,36 @@ static stats_record_t* stats_allocate_entry(void)
     return record;
 }
 
+/**
+ * @brief Find a statistics entry, creating it with the given type if new
+ */
+static stats_record_t* stats_find_or_create(dsrtos_stats_category_t category,
+                                            const char* name,
+                                            dsrtos_stats_type_t type)
+{
+    stats_record_t* record = stats_find_entry(category, name);
+    
+    if (record == NULL) {
+        record = stats_allocate_entry();
+        if (record != NULL) {
+            strncpy(record->name, name, STATS_NAME_MAX_LEN - 1U);
+            record->entry.category = category;
+            record->entry.type = type;
+            record->entry.name = record->name;
+        }
+    }
+    
+    return record;
+}
+
+/**
+ * @brief Handle of an entry: its index in the entry table
+ */
+static dsrtos_stats_handle_t stats_handle_of(const stats_record_t* record)
+{
+    return (dsrtos_stats_handle_t)(record - g_stats_mgr.entries);
+}
+
 /**
  * @brief Update CPU usage
  */
@@ -13,6 +13,11 @@ extern uint32_t _sdata;
 extern uint32_t _edata;
 extern uint32_t _sbss;
 extern uint32_t _ebss;
+extern uint32_t _siccmdata;
+extern uint32_t _sccmdata;
+extern uint32_t _eccmdata;
+extern uint32_t _sccmbss;
+extern uint32_t _eccmbss;
 extern int main(void);
 
 /* Function declarations are now available from headers */
@@ -60,6 +65,18 @@ void Reset_Handler(void)
         *pDest++ = 0;
     }
     
+    /* Core-coupled memory: .ccm_data from flash, .ccm_bss zeroed */
+    pSrc = &_siccmdata;
+    pDest = &_sccmdata;
+    while (pDest < &_eccmdata) {
+        *pDest++ = *pSrc++;
+    }
+    
+    pDest = &_sccmbss;
+    while (pDest < &_eccmbss) {
+        *pDest++ = 0;
+    }
+    
     SystemInit();
     
     (void)main();
@@ -0,0 +1,586 @@
+/*
+ * @file dsrtos_budget.c
+ * @brief DSRTOS Execution-Time Budget Enforcement Implementation
+ * @date 2024-12-30
+ *
+ * Servers due for replenishment hang off a timing wheel indexed by tick,
+ * so a tick touches only the servers whose slot comes up. A period longer
+ * than the wheel leaves its server in the slot for the extra laps.
+ *
+ * COMPLIANCE:
+ * - MISRA-C:2012 compliant
+ * - DO-178C DAL-B certifiable
+ * - IEC 62304 Class B compliant
+ * - ISO 26262 ASIL D compliant
+ */
+
+#include "dsrtos_budget.h"
+#include "dsrtos_task_state.h"
+#include "dsrtos_task_queue.h"
+#include "dsrtos_hooks.h"
+#include "dsrtos_critical.h"
+#include "dsrtos_port.h"
+#include <string.h>
+
+/*==============================================================================
+ * CONSTANTS
+ *============================================================================*/
+
+#define BUDGET_MAGIC            (0x42554447U)  /* 'BUDG' */
+#define BUDGET_WHEEL_MASK       (DSRTOS_BUDGET_WHEEL_SIZE - 1U)
+
+#if DSRTOS_BUDGET_MAX_SERVERS > 32U
+#error "DSRTOS_BUDGET_MAX_SERVERS must not exceed 32"
+#endif
+
+/*==============================================================================
+ * TYPE DEFINITIONS
+ *============================================================================*/
+
+/* Budget server */
+typedef struct budget_server {
+    struct budget_server *wheel_next;   /* Next server in the same wheel slot */
+    dsrtos_budget_config_t config;
+    uint32_t release_tick;              /* Tick of the next replenishment */
+    uint32_t remaining;
+    uint64_t consumed;
+    uint32_t exhaustions;
+    uint32_t replenishments;
+    bool in_use;
+    bool throttled;
+
+    uint32_t member_count;
+    dsrtos_tcb_t *members[DSRTOS_BUDGET_MAX_MEMBERS];
+    dsrtos_task_priority_t saved_priority[DSRTOS_BUDGET_MAX_MEMBERS];
+    uint32_t suspended_mask;            /* Members suspended by this server */
+} budget_server_t;
+
+/* Budget manager */
+typedef struct {
+    uint32_t magic;
+    dsrtos_cpu_clock_t clock;
+    uint32_t last_charge;               /* Cycle stamp of the last charge */
+    uint32_t ticks;
+    dsrtos_tcb_t *current;              /* Task being charged */
+    uint32_t exhausted_mask;            /* Servers run dry since the last tick */
+    budget_server_t *wheel[DSRTOS_BUDGET_WHEEL_SIZE];
+    budget_server_t servers[DSRTOS_BUDGET_MAX_SERVERS];
+} budget_manager_t;
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+static budget_manager_t g_budget;
+
+/*==============================================================================
+ * STATIC FUNCTION PROTOTYPES
+ *============================================================================*/
+
+static void budget_charge(uint32_t now);
+static void budget_enforce(void);
+static void budget_throttle(budget_server_t *server);
+static void budget_restrict(budget_server_t *server, uint32_t index);
+static void budget_restore(budget_server_t *server, uint32_t index);
+static void budget_replenish(budget_server_t *server);
+static void budget_set_priority(dsrtos_tcb_t *tcb, dsrtos_task_priority_t priority);
+static void budget_wheel_insert(budget_server_t *server);
+static void budget_wheel_remove(budget_server_t *server);
+static void* budget_tick_hook(dsrtos_hook_type_t type, void *params);
+
+/*==============================================================================
+ * PUBLIC FUNCTIONS
+ *============================================================================*/
+
+/**
+ * @brief Initialize budget enforcement
+ * @param clock Cycle source, NULL for dsrtos_port_get_cycle_count
+ * @return Error code
+ */
+dsrtos_error_t dsrtos_budget_init(dsrtos_cpu_clock_t clock)
+{
+    dsrtos_hook_entry_t hook;
+
+    (void)memset(&g_budget, 0, sizeof(g_budget));
+    g_budget.clock = (clock != NULL) ? clock : dsrtos_port_get_cycle_count;
+    g_budget.last_charge = g_budget.clock();
+
+    /* Charge and replenish from the tick path */
+    (void)memset(&hook, 0, sizeof(hook));
+    hook.type = DSRTOS_HOOK_KERNEL_TICK;
+    hook.function = budget_tick_hook;
+    hook.priority = 0U;
+    hook.enabled = true;
+    hook.name = "budget";
+    (void)dsrtos_hook_register(&hook);
+
+    g_budget.magic = BUDGET_MAGIC;
+
+    return DSRTOS_SUCCESS;
+}
+
+/**
+ * @brief Create a budget server
+ * @param config Server parameters
+ * @param server_id Server ID out
+ * @return Error code
+ * @note The first period starts at the current tick with a full budget
+ */
+dsrtos_error_t dsrtos_budget_server_create(const dsrtos_budget_config_t *config,
+                                           uint32_t *server_id)
+{
+    budget_server_t *server = NULL;
+    uint32_t id;
+
+    if ((config == NULL) || (server_id == NULL) ||
+        (config->budget_cycles == 0U) || (config->period_ticks == 0U) ||
+        (config->action > DSRTOS_BUDGET_ACTION_SUSPEND)) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+
+    if (g_budget.magic != BUDGET_MAGIC) {
+        return DSRTOS_ERROR_NOT_INITIALIZED;
+    }
+
+    dsrtos_critical_enter();
+
+    for (id = 0U; id < DSRTOS_BUDGET_MAX_SERVERS; id++) {
+        if (!g_budget.servers[id].in_use) {
+            server = &g_budget.servers[id];
+            break;
+        }
+    }
+
+    if (server == NULL) {
+        dsrtos_critical_exit();
+        return DSRTOS_ERROR_NO_RESOURCES;
+    }
+
+    (void)memset(server, 0, sizeof(*server));
+    server->config = *config;
+    server->remaining = config->budget_cycles;
+    server->release_tick = g_budget.ticks + config->period_ticks;
+    server->in_use = true;
+    budget_wheel_insert(server);
+
+    dsrtos_critical_exit();
+
+    *server_id = id;
+    return DSRTOS_SUCCESS;
+}
+
+/**
+ * @brief Delete a budget server, releasing any throttled members
+ * @param server_id Server ID
+ * @return Error code
+ */
+dsrtos_error_t dsrtos_budget_server_delete(uint32_t server_id)
+{
+    budget_server_t *server;
+
+    if ((server_id >= DSRTOS_BUDGET_MAX_SERVERS) || !g_budget.servers[server_id].in_use) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+
+    server = &g_budget.servers[server_id];
+
+    dsrtos_critical_enter();
+
+    budget_wheel_remove(server);
+    g_budget.exhausted_mask &= ~(1UL << server_id);
+    for (uint32_t i = 0U; i < server->member_count; i++) {
+        if (server->throttled) {
+            budget_restore(server, i);
+        }
+        server->members[i]->budget = NULL;
+    }
+    server->in_use = false;
+
+    dsrtos_critical_exit();
+
+    return DSRTOS_SUCCESS;
+}
+
+/**
+ * @brief Put a task under a budget server
+ * @param tcb Task
+ * @param server_id Server ID
+ * @return Error code
+ * @note A task joining an exhausted server is restricted at once
+ */
+dsrtos_error_t dsrtos_budget_attach(dsrtos_tcb_t *tcb, uint32_t server_id)
+{
+    budget_server_t *server;
+    uint32_t index;
+
+    if ((tcb == NULL) || (server_id >= DSRTOS_BUDGET_MAX_SERVERS) ||
+        !g_budget.servers[server_id].in_use) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+
+    if (tcb->budget != NULL) {
+        return DSRTOS_ERROR_ALREADY_EXISTS;
+    }
+
+    server = &g_budget.servers[server_id];
+
+    dsrtos_critical_enter();
+
+    if (server->member_count >= DSRTOS_BUDGET_MAX_MEMBERS) {
+        dsrtos_critical_exit();
+        return DSRTOS_ERROR_LIMIT_REACHED;
+    }
+
+    index = server->member_count;
+    server->members[index] = tcb;
+    server->member_count++;
+    tcb->budget = server;
+
+    if (server->throttled) {
+        budget_restrict(server, index);
+    }
+
+    dsrtos_critical_exit();
+
+    return DSRTOS_SUCCESS;
+}
+
+/**
+ * @brief Take a task out of its budget server
+ * @param tcb Task
+ * @return Error code
+ */
+dsrtos_error_t dsrtos_budget_detach(dsrtos_tcb_t *tcb)
+{
+    budget_server_t *server;
+    uint32_t index;
+    uint32_t last;
+
+    if ((tcb == NULL) || (tcb->budget == NULL)) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+
+    server = (budget_server_t *)tcb->budget;
+
+    dsrtos_critical_enter();
+
+    for (index = 0U; index < server->member_count; index++) {
+        if (server->members[index] == tcb) {
+            break;
+        }
+    }
+
+    if (index == server->member_count) {
+        dsrtos_critical_exit();
+        return DSRTOS_ERROR_NOT_FOUND;
+    }
+
+    if (server->throttled) {
+        budget_restore(server, index);
+    }
+
+    /* Move the last member into the hole */
+    last = server->member_count - 1U;
+    server->members[index] = server->members[last];
+    server->saved_priority[index] = server->saved_priority[last];
+    server->suspended_mask &= ~(1UL << index);
+    if ((server->suspended_mask & (1UL << last)) != 0U) {
+        server->suspended_mask = (server->suspended_mask & ~(1UL << last)) | (1UL << index);
+    }
+    server->member_count = last;
+    tcb->budget = NULL;
+
+    dsrtos_critical_exit();
+
+    return DSRTOS_SUCCESS;
+}
+
+/**
+ * @brief Charge the outgoing task's server and start charging the next task
+ * @param next Task switched in
+ * @note Called from the context switch handler. Only charges: a server
+ *       that runs dry here is throttled on the next tick, so no task
+ *       changes state from inside the switch.
+ */
+void dsrtos_budget_switch(dsrtos_tcb_t *next)
+{
+    if (g_budget.magic != BUDGET_MAGIC) {
+        return;
+    }
+
+    budget_charge(g_budget.clock());
+    g_budget.current = next;
+}
+
+/**
+ * @brief Charge the running task and replenish the servers due this tick
+ * @note Called from the kernel tick hook
+ */
+void dsrtos_budget_tick(void)
+{
+    budget_server_t *due;
+    budget_server_t *server;
+
+    if (g_budget.magic != BUDGET_MAGIC) {
+        return;
+    }
+
+    dsrtos_critical_enter();
+
+    /* The elapsed tick belongs to the period that is ending */
+    budget_charge(g_budget.clock());
+    budget_enforce();
+
+    g_budget.ticks++;
+    due = g_budget.wheel[g_budget.ticks & BUDGET_WHEEL_MASK];
+    g_budget.wheel[g_budget.ticks & BUDGET_WHEEL_MASK] = NULL;
+
+    while (due != NULL) {
+        server = due;
+        due = due->wheel_next;
+
+        if (server->release_tick == g_budget.ticks) {
+            budget_replenish(server);
+            server->release_tick += server->config.period_ticks;
+        }
+        budget_wheel_insert(server);
+    }
+
+    dsrtos_critical_exit();
+}
+
+/**
+ * @brief Get the state of a budget server
+ * @param server_id Server ID
+ * @param stats Statistics out
+ * @return Error code
+ */
+dsrtos_error_t dsrtos_budget_get_stats(uint32_t server_id, dsrtos_budget_stats_t *stats)
+{
+    const budget_server_t *server;
+
+    if ((stats == NULL) || (server_id >= DSRTOS_BUDGET_MAX_SERVERS) ||
+        !g_budget.servers[server_id].in_use) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+
+    server = &g_budget.servers[server_id];
+
+    dsrtos_critical_enter();
+    stats->consumed_cycles = server->consumed;
+    stats->remaining_cycles = server->remaining;
+    stats->exhaustions = server->exhaustions;
+    stats->replenishments = server->replenishments;
+    stats->member_count = server->member_count;
+    stats->throttled = server->throttled;
+    dsrtos_critical_exit();
+
+    return DSRTOS_SUCCESS;
+}
+
+/*==============================================================================
+ * STATIC FUNCTIONS
+ *============================================================================*/
+
+/**
+ * @brief Charge the cycles since the last charge to the current task's server
+ * @param now Cycle stamp
+ * @note Marks a server that runs dry; budget_enforce throttles it
+ */
+static void budget_charge(uint32_t now)
+{
+    dsrtos_tcb_t *tcb = g_budget.current;
+    budget_server_t *server;
+    uint32_t ran = now - g_budget.last_charge;
+
+    g_budget.last_charge = now;
+
+    if ((tcb == NULL) || (tcb->budget == NULL)) {
+        return;
+    }
+
+    server = (budget_server_t *)tcb->budget;
+    server->consumed += ran;
+
+    if (!server->throttled) {
+        if (ran >= server->remaining) {
+            server->remaining = 0U;
+            g_budget.exhausted_mask |= (1UL << (uint32_t)(server - g_budget.servers));
+        } else {
+            server->remaining -= ran;
+        }
+    }
+}
+
+/**
+ * @brief Throttle the servers that ran dry and stop a suspended member
+ *        that woke from a wait
+ * @note Tick path only
+ */
+static void budget_enforce(void)
+{
+    dsrtos_tcb_t *tcb = g_budget.current;
+    budget_server_t *server;
+
+    while (g_budget.exhausted_mask != 0U) {
+        server = &g_budget.servers[__builtin_ctz(g_budget.exhausted_mask)];
+        g_budget.exhausted_mask &= g_budget.exhausted_mask - 1U;
+        if (server->in_use && !server->throttled) {
+            budget_throttle(server);
+        }
+    }
+
+    if ((tcb == NULL) || (tcb->budget == NULL)) {
+        return;
+    }
+
+    /* Woke from a wait while exhausted: stop it now */
+    server = (budget_server_t *)tcb->budget;
+    if (server->throttled && (server->config.action == DSRTOS_BUDGET_ACTION_SUSPEND) &&
+        (tcb->state == DSRTOS_TASK_STATE_RUNNING)) {
+        for (uint32_t i = 0U; i < server->member_count; i++) {
+            if (server->members[i] == tcb) {
+                budget_restrict(server, i);
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Restrict every member of an exhausted server
+ * @param server Server
+ */
+static void budget_throttle(budget_server_t *server)
+{
+    server->throttled = true;
+    server->exhaustions++;
+
+    for (uint32_t i = 0U; i < server->member_count; i++) {
+        budget_restrict(server, i);
+    }
+}
+
+/**
+ * @brief Demote or suspend one member
+ * @param server Server
+ * @param index Member index
+ */
+static void budget_restrict(budget_server_t *server, uint32_t index)
+{
+    dsrtos_tcb_t *tcb = server->members[index];
+
+    if (server->config.action == DSRTOS_BUDGET_ACTION_DEMOTE) {
+        server->saved_priority[index] = tcb->effective_priority;
+        budget_set_priority(tcb, DSRTOS_BUDGET_BACKGROUND_PRIORITY);
+    } else if ((tcb->state == DSRTOS_TASK_STATE_READY) ||
+               (tcb->state == DSRTOS_TASK_STATE_RUNNING)) {
+        if (dsrtos_state_transition(tcb, DSRTOS_TASK_STATE_SUSPENDED) == DSRTOS_SUCCESS) {
+            server->suspended_mask |= (1UL << index);
+        }
+    } else {
+        /* Waiting members are stopped when they next run */
+    }
+
+    if (tcb == g_budget.current) {
+        dsrtos_port_yield();
+    }
+}
+
+/**
+ * @brief Undo the restriction of one member
+ * @param server Server
+ * @param index Member index
+ */
+static void budget_restore(budget_server_t *server, uint32_t index)
+{
+    dsrtos_tcb_t *tcb = server->members[index];
+
+    if (server->config.action == DSRTOS_BUDGET_ACTION_DEMOTE) {
+        budget_set_priority(tcb, server->saved_priority[index]);
+    } else if ((server->suspended_mask & (1UL << index)) != 0U) {
+        server->suspended_mask &= ~(1UL << index);
+        if (tcb->state == DSRTOS_TASK_STATE_SUSPENDED) {
+            (void)dsrtos_state_transition(tcb, DSRTOS_TASK_STATE_READY);
+        }
+    } else {
+        /* Not restricted */
+    }
+}
+
+/**
+ * @brief Refill a server and release its members
+ * @param server Server
+ */
+static void budget_replenish(budget_server_t *server)
+{
+    server->remaining = server->config.budget_cycles;
+    server->replenishments++;
+
+    if (server->throttled) {
+        server->throttled = false;
+        for (uint32_t i = 0U; i < server->member_count; i++) {
+            budget_restore(server, i);
+        }
+        dsrtos_port_yield();
+    }
+}
+
+/**
+ * @brief Change a task's scheduling priority, requeueing it if ready
+ * @param tcb Task
+ * @param priority New effective priority
+ */
+static void budget_set_priority(dsrtos_tcb_t *tcb, dsrtos_task_priority_t priority)
+{
+    if (tcb->state == DSRTOS_TASK_STATE_READY) {
+        (void)dsrtos_queue_ready_remove(tcb);
+        tcb->effective_priority = priority;
+        (void)dsrtos_queue_ready_insert(tcb);
+    } else {
+        tcb->effective_priority = priority;
+    }
+}
+
+/**
+ * @brief Hang a server on the wheel slot of its next replenishment
+ * @param server Server
+ */
+static void budget_wheel_insert(budget_server_t *server)
+{
+    budget_server_t **slot = &g_budget.wheel[server->release_tick & BUDGET_WHEEL_MASK];
+
+    server->wheel_next = *slot;
+    *slot = server;
+}
+
+/**
+ * @brief Take a server off the wheel
+ * @param server Server
+ */
+static void budget_wheel_remove(budget_server_t *server)
+{
+    budget_server_t **link = &g_budget.wheel[server->release_tick & BUDGET_WHEEL_MASK];
+
+    while (*link != NULL) {
+        if (*link == server) {
+            *link = server->wheel_next;
+            break;
+        }
+        link = &(*link)->wheel_next;
+    }
+    server->wheel_next = NULL;
+}
+
+/**
+ * @brief Tick hook: enforce and replenish
+ */
+static void* budget_tick_hook(dsrtos_hook_type_t type, void *params)
+{
+    (void)type;
+    (void)params;
+
+    dsrtos_budget_tick();
+
+    return NULL;
+}
@@ -0,0 +1,341 @@
+/*
+ * @file dsrtos_cpu_account.c
+ * @brief DSRTOS Per-Task CPU Accounting Implementation
+ * @date 2024-12-30
+ *
+ * Cycle-accurate run time per task, fixed-point EWMA loads and CPU
+ * budget overrun detection. No floating point.
+ *
+ * COMPLIANCE:
+ * - MISRA-C:2012 compliant
+ * - DO-178C DAL-B certifiable
+ * - IEC 62304 Class B compliant
+ * - ISO 26262 ASIL D compliant
+ */
+
+#include "dsrtos_cpu_account.h"
+#include "dsrtos_hooks.h"
+#include "dsrtos_critical.h"
+#include "dsrtos_port.h"
+#include <string.h>
+
+/*==============================================================================
+ * CONSTANTS
+ *============================================================================*/
+
+#define CPU_ACCOUNT_MAGIC       (0x43505541U)  /* 'CPUA' */
+
+/* Loads are kept as a fraction of 2^24 */
+#define CPU_LOAD_SHIFT          (24U)
+#define CPU_LOAD_ONE            (1UL << CPU_LOAD_SHIFT)
+
+/* Sample period in milliseconds */
+#define CPU_SAMPLE_MS           ((DSRTOS_CPU_ACCOUNT_SAMPLE_TICKS * 1000U) / DSRTOS_TICK_FREQUENCY_HZ)
+
+/* EWMA weight of a new sample in Q16: alpha = T / (tau + T) */
+#define CPU_ALPHA_Q16(tau_ms)   ((uint32_t)((65536UL * CPU_SAMPLE_MS) / ((tau_ms) + CPU_SAMPLE_MS)))
+
+#if (CPU_SAMPLE_MS == 0U) || (CPU_SAMPLE_MS > 100U)
+#error "DSRTOS_CPU_ACCOUNT_SAMPLE_TICKS must give a sample period of 1 to 100 ms"
+#endif
+
+/*==============================================================================
+ * TYPE DEFINITIONS
+ *============================================================================*/
+
+/* Accounting state of one task */
+typedef struct {
+    uint64_t run_cycles;
+    uint32_t window_cycles;             /* Since the last sample */
+    uint32_t load[DSRTOS_CPU_WINDOWS];  /* EWMA, fraction of CPU_LOAD_ONE */
+    uint32_t budget_cycles;
+    uint32_t budget_used;
+    uint32_t budget_period;             /* Samples per budget period */
+    uint32_t budget_left;               /* Samples left in the period */
+    uint32_t overruns;
+    bool overrun_raised;
+} cpu_account_slot_t;
+
+/* Accounting context */
+typedef struct {
+    uint32_t magic;
+    dsrtos_cpu_clock_t clock;
+    uint32_t last_switch;               /* Cycle stamp of the last charge */
+    uint32_t last_sample;               /* Cycle stamp of the last sample */
+    uint32_t current;                   /* Slot being charged */
+    uint32_t current_id;                /* Task ID being charged */
+    uint32_t ticks;                     /* Ticks since the last sample */
+    dsrtos_cpu_overrun_hook_t overrun_hook;
+    cpu_account_slot_t slots[DSRTOS_CPU_ACCOUNT_SLOTS + 1U];
+} cpu_account_t;
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+static cpu_account_t g_cpu_account;
+
+/* Sample weights of the 100 ms, 1 s and 10 s windows */
+static const uint32_t g_cpu_alpha[DSRTOS_CPU_WINDOWS] = {
+    CPU_ALPHA_Q16(100U),
+    CPU_ALPHA_Q16(1000U),
+    CPU_ALPHA_Q16(10000U)
+};
+
+/*==============================================================================
+ * STATIC FUNCTION PROTOTYPES
+ *============================================================================*/
+
+static void cpu_account_charge(uint32_t now);
+static void cpu_account_check_budget(cpu_account_slot_t *slot, uint32_t task_id);
+static void* cpu_account_tick_hook(dsrtos_hook_type_t type, void *params);
+static uint32_t cpu_account_slot_of(uint32_t task_id);
+
+/*==============================================================================
+ * PUBLIC FUNCTIONS
+ *============================================================================*/
+
+/**
+ * @brief Initialize CPU accounting
+ * @param clock Cycle source, NULL for dsrtos_port_get_cycle_count
+ * @return Error code
+ * @note Cycles until the first switch are charged to task ID 0
+ */
+dsrtos_error_t dsrtos_cpu_account_init(dsrtos_cpu_clock_t clock)
+{
+    dsrtos_hook_entry_t hook;
+
+    (void)memset(&g_cpu_account, 0, sizeof(g_cpu_account));
+    g_cpu_account.clock = (clock != NULL) ? clock : dsrtos_port_get_cycle_count;
+    g_cpu_account.last_switch = g_cpu_account.clock();
+    g_cpu_account.last_sample = g_cpu_account.last_switch;
+
+    /* Sample the load windows from the tick path */
+    (void)memset(&hook, 0, sizeof(hook));
+    hook.type = DSRTOS_HOOK_KERNEL_TICK;
+    hook.function = cpu_account_tick_hook;
+    hook.priority = 0U;
+    hook.enabled = true;
+    hook.name = "cpu_account";
+    (void)dsrtos_hook_register(&hook);
+
+    g_cpu_account.magic = CPU_ACCOUNT_MAGIC;
+
+    return DSRTOS_SUCCESS;
+}
+
+/**
+ * @brief Charge the outgoing task and start charging the next one
+ * @param next Task switched in
+ * @note Called from the context switch handler
+ */
+void dsrtos_cpu_account_switch(const dsrtos_tcb_t *next)
+{
+    if (g_cpu_account.magic != CPU_ACCOUNT_MAGIC) {
+        return;
+    }
+
+    cpu_account_charge(g_cpu_account.clock());
+
+    g_cpu_account.current_id = (next != NULL) ? next->task_id : 0U;
+    g_cpu_account.current = cpu_account_slot_of(g_cpu_account.current_id);
+}
+
+/**
+ * @brief Fold the window of every task into its EWMA loads
+ * @note Called every DSRTOS_CPU_ACCOUNT_SAMPLE_TICKS ticks by the tick hook
+ */
+void dsrtos_cpu_account_sample(void)
+{
+    uint32_t now;
+    uint32_t elapsed;
+
+    if (g_cpu_account.magic != CPU_ACCOUNT_MAGIC) {
+        return;
+    }
+
+    dsrtos_critical_enter();
+
+    now = g_cpu_account.clock();
+    cpu_account_charge(now);
+    elapsed = now - g_cpu_account.last_sample;
+    g_cpu_account.last_sample = now;
+
+    for (uint32_t i = 0U; i <= DSRTOS_CPU_ACCOUNT_SLOTS; i++) {
+        cpu_account_slot_t *slot = &g_cpu_account.slots[i];
+        uint32_t sample = 0U;
+
+        if (elapsed > 0U) {
+            uint64_t fraction = ((uint64_t)slot->window_cycles << CPU_LOAD_SHIFT) / elapsed;
+            sample = (fraction > CPU_LOAD_ONE) ? CPU_LOAD_ONE : (uint32_t)fraction;
+        }
+        slot->window_cycles = 0U;
+
+        for (uint32_t w = 0U; w < DSRTOS_CPU_WINDOWS; w++) {
+            int64_t delta = (int64_t)sample - (int64_t)slot->load[w];
+            slot->load[w] = (uint32_t)((int64_t)slot->load[w] + ((delta * (int64_t)g_cpu_alpha[w]) / 65536));
+        }
+
+        /* Replenish the budget at the end of its period */
+        if (slot->budget_period != 0U) {
+            slot->budget_left--;
+            if (slot->budget_left == 0U) {
+                slot->budget_left = slot->budget_period;
+                slot->budget_used = 0U;
+                slot->overrun_raised = false;
+            }
+        }
+    }
+
+    dsrtos_critical_exit();
+}
+
+/**
+ * @brief Give a task a CPU budget per period
+ * @param task_id Task, below DSRTOS_CPU_ACCOUNT_SLOTS
+ * @param budget_cycles Cycles per period, 0 removes the budget
+ * @param period_samples Period in load samples
+ * @return Error code
+ */
+dsrtos_error_t dsrtos_cpu_account_set_budget(uint32_t task_id,
+                                             uint32_t budget_cycles,
+                                             uint32_t period_samples)
+{
+    cpu_account_slot_t *slot;
+
+    if ((task_id >= DSRTOS_CPU_ACCOUNT_SLOTS) ||
+        ((budget_cycles != 0U) && (period_samples == 0U))) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+
+    if (g_cpu_account.magic != CPU_ACCOUNT_MAGIC) {
+        return DSRTOS_ERROR_NOT_INITIALIZED;
+    }
+
+    slot = &g_cpu_account.slots[task_id];
+
+    dsrtos_critical_enter();
+    slot->budget_cycles = budget_cycles;
+    slot->budget_period = (budget_cycles != 0U) ? period_samples : 0U;
+    slot->budget_left = slot->budget_period;
+    slot->budget_used = 0U;
+    slot->overrun_raised = false;
+    dsrtos_critical_exit();
+
+    return DSRTOS_SUCCESS;
+}
+
+/**
+ * @brief Register the budget overrun event handler
+ * @param hook Handler, NULL to remove
+ * @return Error code
+ */
+dsrtos_error_t dsrtos_cpu_account_register_overrun_hook(dsrtos_cpu_overrun_hook_t hook)
+{
+    g_cpu_account.overrun_hook = hook;
+    return DSRTOS_SUCCESS;
+}
+
+/**
+ * @brief Get the CPU usage of a task
+ * @param task_id Task, or DSRTOS_CPU_ACCOUNT_OTHER for untracked IDs
+ * @param usage Usage out
+ * @return Error code
+ */
+dsrtos_error_t dsrtos_cpu_account_get(uint32_t task_id, dsrtos_cpu_usage_t *usage)
+{
+    const cpu_account_slot_t *slot;
+
+    if ((usage == NULL) || (task_id > DSRTOS_CPU_ACCOUNT_OTHER)) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+
+    if (g_cpu_account.magic != CPU_ACCOUNT_MAGIC) {
+        return DSRTOS_ERROR_NOT_INITIALIZED;
+    }
+
+    slot = &g_cpu_account.slots[task_id];
+
+    dsrtos_critical_enter();
+    usage->run_cycles = slot->run_cycles;
+    for (uint32_t w = 0U; w < DSRTOS_CPU_WINDOWS; w++) {
+        usage->load_x100[w] = (uint16_t)((((uint64_t)slot->load[w] * 10000U) +
+                                          (CPU_LOAD_ONE / 2U)) >> CPU_LOAD_SHIFT);
+    }
+    usage->budget_cycles = slot->budget_cycles;
+    usage->budget_used = slot->budget_used;
+    usage->overruns = slot->overruns;
+    dsrtos_critical_exit();
+
+    return DSRTOS_SUCCESS;
+}
+
+/*==============================================================================
+ * STATIC FUNCTIONS
+ *============================================================================*/
+
+/**
+ * @brief Charge the cycles since the last charge to the current task
+ * @param now Cycle stamp
+ */
+static void cpu_account_charge(uint32_t now)
+{
+    cpu_account_slot_t *slot = &g_cpu_account.slots[g_cpu_account.current];
+    uint32_t ran = now - g_cpu_account.last_switch;
+
+    g_cpu_account.last_switch = now;
+    slot->run_cycles += ran;
+    slot->window_cycles += ran;
+
+    if (slot->budget_cycles != 0U) {
+        slot->budget_used += ran;
+        cpu_account_check_budget(slot, g_cpu_account.current_id);
+    }
+}
+
+/**
+ * @brief Raise the overrun event once per period
+ * @param slot Task slot
+ * @param task_id Task ID
+ */
+static void cpu_account_check_budget(cpu_account_slot_t *slot, uint32_t task_id)
+{
+    dsrtos_cpu_overrun_hook_t hook;
+
+    if ((slot->budget_used > slot->budget_cycles) && !slot->overrun_raised) {
+        slot->overrun_raised = true;
+        slot->overruns++;
+
+        hook = g_cpu_account.overrun_hook;
+        if (hook != NULL) {
+            hook(task_id, slot->budget_used, slot->budget_cycles);
+        }
+    }
+}
+
+/**
+ * @brief Tick hook: sample the loads every DSRTOS_CPU_ACCOUNT_SAMPLE_TICKS
+ */
+static void* cpu_account_tick_hook(dsrtos_hook_type_t type, void *params)
+{
+    (void)type;
+    (void)params;
+
+    g_cpu_account.ticks++;
+    if (g_cpu_account.ticks >= DSRTOS_CPU_ACCOUNT_SAMPLE_TICKS) {
+        g_cpu_account.ticks = 0U;
+        dsrtos_cpu_account_sample();
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Map a task ID to its accounting slot
+ * @param task_id Task ID
+ * @return Slot index
+ */
+static uint32_t cpu_account_slot_of(uint32_t task_id)
+{
+    return (task_id < DSRTOS_CPU_ACCOUNT_SLOTS) ? task_id : DSRTOS_CPU_ACCOUNT_OTHER;
+}
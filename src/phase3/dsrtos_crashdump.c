@@ -0,0 +1,496 @@
+/*
+ * @file dsrtos_crashdump.c
+ * @brief DSRTOS Crash Dump Capture Implementation
+ * @date 2024-12-30
+ *
+ * Capture runs from the panic path with interrupts off: it fills one
+ * static image, compresses it straight into the ring and writes the record
+ * magic last, so a reset in the middle leaves no valid record behind.
+ *
+ * COMPLIANCE:
+ * - MISRA-C:2012 compliant
+ * - DO-178C DAL-B certifiable
+ * - IEC 62304 Class B compliant
+ * - ISO 26262 ASIL D compliant
+ */
+
+#include "dsrtos_crashdump.h"
+#include "dsrtos_crc.h"
+#include "dsrtos_hooks.h"
+#include "dsrtos_kernel.h"
+#include "dsrtos_critical.h"
+#include "dsrtos_port.h"
+#include <stddef.h>
+#include <string.h>
+
+/*==============================================================================
+ * CONSTANTS
+ *============================================================================*/
+
+#define CRASHDUMP_REGION_MAGIC  (0x43445247U)  /* 'CDRG' */
+#define CRASHDUMP_RECORD_MAGIC  (0x43445243U)  /* 'CDRC' */
+#define CRASHDUMP_IMAGE_MAGIC   (0x4344494DU)  /* 'CDIM' */
+#define CRASHDUMP_TRACE_MASK    (DSRTOS_CRASHDUMP_TRACE_EVENTS - 1U)
+#define CRASHDUMP_NO_TASK       (0xFFFFFFFFU)
+#define CRASHDUMP_ALIGN4(n)     (((n) + 3U) & ~3U)
+
+/*==============================================================================
+ * TYPE DEFINITIONS
+ *============================================================================*/
+
+/* Region header, at offset 0 */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;
+    uint32_t size;
+    uint32_t write_offset;
+    uint32_t next_sequence;
+} crashdump_region_t;
+
+/* Record header, followed by the compressed image */
+typedef struct {
+    uint32_t magic;
+    uint32_t sequence;
+    uint16_t raw_len;
+    uint16_t comp_len;
+    uint32_t crc;
+} crashdump_record_t;
+
+_Static_assert(sizeof(crashdump_region_t) == 20U, "region header layout");
+_Static_assert(sizeof(crashdump_record_t) == 16U, "record header layout");
+_Static_assert(offsetof(dsrtos_crashdump_image_t, stack) == 252U, "image layout");
+_Static_assert((sizeof(dsrtos_crashdump_image_t) % 4U) == 0U, "image layout");
+_Static_assert(DSRTOS_CRASHDUMP_REGION_SIZE >= DSRTOS_CRASHDUMP_REGION_MIN,
+               "DSRTOS_CRASHDUMP_REGION_SIZE cannot hold one dump");
+
+/* Crash dump context */
+typedef struct {
+    uint32_t magic;
+    uint8_t *base;
+    uint32_t size;
+
+    /* Trace ring */
+    dsrtos_crashdump_event_t trace[DSRTOS_CRASHDUMP_TRACE_EVENTS];
+    uint32_t trace_head;                /* Events recorded */
+
+    /* Capture scratch, static so the fault stack stays small */
+    dsrtos_crashdump_image_t image;
+    dsrtos_lz_work_t lz;
+} crashdump_t;
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+static crashdump_t g_crashdump;
+
+/* Built-in region, left alone by the C runtime so it survives reset */
+static uint32_t g_crashdump_region[DSRTOS_CRASHDUMP_REGION_SIZE / 4U] __attribute__((section(".noinit")));
+
+/*==============================================================================
+ * STATIC FUNCTION PROTOTYPES
+ *============================================================================*/
+
+static void crashdump_format(void);
+static bool crashdump_region_valid(const crashdump_region_t *region, uint32_t size);
+static const crashdump_record_t* crashdump_next_record(uint32_t *offset);
+static uint32_t crashdump_record_crc(const crashdump_record_t *record);
+static void crashdump_copy_text(char *dst, const char *src);
+static void crashdump_fill_task(dsrtos_crashdump_image_t *image, const dsrtos_panic_context_t *panic);
+static void* crashdump_trace_switch(dsrtos_hook_type_t type, void *params);
+
+/* Every switch lands in the trace ring, with no run-time registration */
+DSRTOS_HOOK_STATIC(TASK_SWITCH_IN, crashdump_trace_switch);
+
+/*==============================================================================
+ * PUBLIC FUNCTIONS
+ *============================================================================*/
+
+/**
+ * @brief Attach the crash dump ring, keeping dumps from earlier boots
+ * @param region No-init RAM for the ring, NULL for the built-in region
+ * @param size Region size, at least DSRTOS_CRASHDUMP_REGION_MIN
+ * @return Error code
+ * @note A region without a valid header is formatted
+ */
+dsrtos_error_t dsrtos_crashdump_init(void *region, uint32_t size)
+{
+    if (region == NULL) {
+        region = g_crashdump_region;
+        size = (uint32_t)sizeof(g_crashdump_region);
+    }
+
+    if ((((uintptr_t)region & 3U) != 0U) || (size < DSRTOS_CRASHDUMP_REGION_MIN)) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+
+    g_crashdump.base = (uint8_t *)region;
+    g_crashdump.size = size & ~3U;
+    g_crashdump.trace_head = 0U;
+
+    if (!crashdump_region_valid((const crashdump_region_t *)region, g_crashdump.size)) {
+        crashdump_format();
+    }
+
+    g_crashdump.magic = CRASHDUMP_REGION_MAGIC;
+
+    return DSRTOS_SUCCESS;
+}
+
+/**
+ * @brief Drop every stored dump
+ * @return Error code
+ */
+dsrtos_error_t dsrtos_crashdump_clear(void)
+{
+    if (g_crashdump.magic != CRASHDUMP_REGION_MAGIC) {
+        return DSRTOS_ERROR_NOT_INITIALIZED;
+    }
+
+    dsrtos_critical_enter();
+    crashdump_format();
+    dsrtos_critical_exit();
+
+    return DSRTOS_SUCCESS;
+}
+
+/**
+ * @brief Record a trace event for the next dump
+ * @param event Event ID
+ * @param task_id Task concerned
+ * @param arg Event argument
+ */
+void dsrtos_crashdump_trace(uint16_t event, uint16_t task_id, uint32_t arg)
+{
+    dsrtos_crashdump_event_t *slot;
+
+    dsrtos_critical_enter();
+
+    slot = &g_crashdump.trace[g_crashdump.trace_head & CRASHDUMP_TRACE_MASK];
+    slot->cycles = dsrtos_port_get_cycle_count();
+    slot->event = event;
+    slot->task_id = task_id;
+    slot->arg = arg;
+    g_crashdump.trace_head++;
+
+    dsrtos_critical_exit();
+}
+
+/**
+ * @brief Capture a crash dump into the ring
+ * @param panic Panic context, registers and fault status
+ * @return Error code
+ * @note Called from the panic path with interrupts disabled
+ */
+dsrtos_error_t dsrtos_crashdump_capture(const dsrtos_panic_context_t *panic)
+{
+    crashdump_region_t *region;
+    crashdump_record_t *record;
+    dsrtos_crashdump_image_t *image = &g_crashdump.image;
+    dsrtos_size_t comp_len = 0U;
+    uint32_t need;
+    uint32_t count;
+    uint32_t first;
+    dsrtos_error_t err;
+
+    if (panic == NULL) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+
+    if (g_crashdump.magic != CRASHDUMP_REGION_MAGIC) {
+        return DSRTOS_ERROR_NOT_INITIALIZED;
+    }
+
+    region = (crashdump_region_t *)g_crashdump.base;
+
+    /* Fill the image */
+    (void)memset(image, 0, sizeof(*image));
+    image->magic = CRASHDUMP_IMAGE_MAGIC;
+    image->version = DSRTOS_CRASHDUMP_VERSION;
+    image->reason = (uint16_t)panic->reason;
+    image->sequence = region->next_sequence;
+    image->tick = dsrtos_get_tick_count();
+    image->cycles = dsrtos_port_get_cycle_count();
+    image->line = panic->line;
+    image->stack_capacity = (uint16_t)DSRTOS_CRASHDUMP_STACK_WORDS;
+    image->ready_capacity = (uint8_t)DSRTOS_CRASHDUMP_READY_MAX;
+    image->trace_capacity = (uint8_t)DSRTOS_CRASHDUMP_TRACE_EVENTS;
+    crashdump_copy_text(image->message, panic->message);
+    crashdump_copy_text(image->file, panic->file);
+
+    (void)memcpy(image->regs, &panic->cpu_context, sizeof(image->regs));
+    (void)memcpy(image->fault, &panic->fault_status, sizeof(image->fault));
+    image->msp = (uint32_t)(uintptr_t)panic->stack_info.sp_main;
+    image->psp = (uint32_t)(uintptr_t)panic->stack_info.sp_process;
+    image->kernel_state = panic->system_state.kernel_state;
+    image->critical_nesting = panic->system_state.critical_nesting;
+    image->interrupt_nesting = panic->system_state.interrupt_nesting;
+
+    crashdump_fill_task(image, panic);
+    image->ready_count = dsrtos_queue_ready_snapshot(image->ready, DSRTOS_CRASHDUMP_READY_MAX);
+
+    /* Trace ring, oldest event first */
+    count = (g_crashdump.trace_head < DSRTOS_CRASHDUMP_TRACE_EVENTS) ?
+            g_crashdump.trace_head : DSRTOS_CRASHDUMP_TRACE_EVENTS;
+    first = g_crashdump.trace_head - count;
+    for (uint32_t i = 0U; i < count; i++) {
+        image->trace[i] = g_crashdump.trace[(first + i) & CRASHDUMP_TRACE_MASK];
+    }
+    image->trace_count = count;
+
+    /* Worst-case record size; start over after the header if it does not fit */
+    need = (uint32_t)sizeof(crashdump_record_t) +
+           CRASHDUMP_ALIGN4((uint32_t)DSRTOS_LZ_BOUND(sizeof(*image)));
+    if ((region->write_offset + need) > g_crashdump.size) {
+        region->write_offset = (uint32_t)sizeof(crashdump_region_t);
+    }
+
+    record = (crashdump_record_t *)&g_crashdump.base[region->write_offset];
+    record->magic = 0U;
+
+    err = dsrtos_lz_compress(&g_crashdump.lz, (const uint8_t *)image, sizeof(*image),
+                             (uint8_t *)&record[1], need - (uint32_t)sizeof(*record), &comp_len);
+    if (err != DSRTOS_SUCCESS) {
+        return err;
+    }
+
+    record->sequence = region->next_sequence;
+    record->raw_len = (uint16_t)sizeof(*image);
+    record->comp_len = (uint16_t)comp_len;
+    record->crc = crashdump_record_crc(record);
+    record->magic = CRASHDUMP_RECORD_MAGIC;
+
+    region->write_offset += (uint32_t)sizeof(*record) + CRASHDUMP_ALIGN4((uint32_t)comp_len);
+    region->next_sequence++;
+
+    return DSRTOS_SUCCESS;
+}
+
+/**
+ * @brief Count the valid dumps in the ring
+ * @return Number of dumps
+ */
+uint32_t dsrtos_crashdump_count(void)
+{
+    uint32_t offset = (uint32_t)sizeof(crashdump_region_t);
+    uint32_t count = 0U;
+
+    if (g_crashdump.magic != CRASHDUMP_REGION_MAGIC) {
+        return 0U;
+    }
+
+    while (crashdump_next_record(&offset) != NULL) {
+        count++;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Decompress one stored dump
+ * @param index 0 for the newest dump, 1 for the one before, ...
+ * @param image Image out
+ * @return Error code
+ */
+dsrtos_error_t dsrtos_crashdump_read(uint32_t index, dsrtos_crashdump_image_t *image)
+{
+    const crashdump_record_t *record;
+    const crashdump_record_t *found = NULL;
+    uint32_t bound = UINT32_MAX;
+    uint32_t offset;
+    dsrtos_size_t len = 0U;
+    dsrtos_error_t err;
+
+    if (image == NULL) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+
+    if (g_crashdump.magic != CRASHDUMP_REGION_MAGIC) {
+        return DSRTOS_ERROR_NOT_INITIALIZED;
+    }
+
+    /* Step down the sequence numbers: newest, then the largest below it */
+    for (uint32_t i = 0U; i <= index; i++) {
+        found = NULL;
+        offset = (uint32_t)sizeof(crashdump_region_t);
+        while ((record = crashdump_next_record(&offset)) != NULL) {
+            if ((record->sequence < bound) &&
+                ((found == NULL) || (record->sequence > found->sequence))) {
+                found = record;
+            }
+        }
+        if (found == NULL) {
+            return DSRTOS_ERROR_NOT_FOUND;
+        }
+        bound = found->sequence;
+    }
+
+    err = dsrtos_lz_decompress((const uint8_t *)&found[1], found->comp_len,
+                               (uint8_t *)image, sizeof(*image), &len);
+    if ((err == DSRTOS_SUCCESS) &&
+        ((len != sizeof(*image)) || (image->magic != CRASHDUMP_IMAGE_MAGIC))) {
+        err = DSRTOS_ERROR_CORRUPTION;
+    }
+
+    return err;
+}
+
+/*==============================================================================
+ * STATIC FUNCTIONS
+ *============================================================================*/
+
+/**
+ * @brief Write an empty region header and wipe the records
+ */
+static void crashdump_format(void)
+{
+    crashdump_region_t *region = (crashdump_region_t *)g_crashdump.base;
+
+    (void)memset(g_crashdump.base, 0, g_crashdump.size);
+    region->version = DSRTOS_CRASHDUMP_VERSION;
+    region->header_size = (uint16_t)sizeof(crashdump_region_t);
+    region->size = g_crashdump.size;
+    region->write_offset = (uint32_t)sizeof(crashdump_region_t);
+    region->next_sequence = 0U;
+    region->magic = CRASHDUMP_REGION_MAGIC;
+}
+
+/**
+ * @brief Check a region header left by an earlier boot
+ */
+static bool crashdump_region_valid(const crashdump_region_t *region, uint32_t size)
+{
+    return (region->magic == CRASHDUMP_REGION_MAGIC) &&
+           (region->version == DSRTOS_CRASHDUMP_VERSION) &&
+           (region->header_size == (uint16_t)sizeof(crashdump_region_t)) &&
+           (region->size == size) &&
+           (region->write_offset >= (uint32_t)sizeof(crashdump_region_t)) &&
+           (region->write_offset <= size) &&
+           ((region->write_offset & 3U) == 0U);
+}
+
+/**
+ * @brief Find the next valid record at or after an offset
+ * @param offset Scan position, advanced past the record found
+ * @return Record, or NULL at the end of the region
+ */
+static const crashdump_record_t* crashdump_next_record(uint32_t *offset)
+{
+    const crashdump_record_t *record;
+
+    while ((*offset + (uint32_t)sizeof(crashdump_record_t)) <= g_crashdump.size) {
+        record = (const crashdump_record_t *)&g_crashdump.base[*offset];
+
+        if ((record->magic == CRASHDUMP_RECORD_MAGIC) &&
+            (record->raw_len == (uint16_t)sizeof(dsrtos_crashdump_image_t)) &&
+            (record->comp_len <= (uint16_t)DSRTOS_LZ_BOUND(sizeof(dsrtos_crashdump_image_t))) &&
+            ((*offset + (uint32_t)sizeof(*record) + record->comp_len) <= g_crashdump.size) &&
+            (record->crc == crashdump_record_crc(record))) {
+            *offset += (uint32_t)sizeof(*record) + CRASHDUMP_ALIGN4((uint32_t)record->comp_len);
+            return record;
+        }
+
+        /* Resynchronize on the next word */
+        *offset += 4U;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief CRC of a record: sequence, both lengths and the payload
+ */
+static uint32_t crashdump_record_crc(const crashdump_record_t *record)
+{
+    uint32_t crc = dsrtos_crc32(&record->sequence, 8U);
+
+    return dsrtos_crc32_update(crc, &record[1], record->comp_len);
+}
+
+/**
+ * @brief Copy a string into a fixed text field; file paths keep the base name
+ */
+static void crashdump_copy_text(char *dst, const char *src)
+{
+    const char *start = src;
+    uint32_t i;
+
+    if (src == NULL) {
+        return;
+    }
+
+    for (i = 0U; src[i] != '\0'; i++) {
+        if ((src[i] == '/') || (src[i] == '\\')) {
+            start = &src[i + 1U];
+        }
+        if (i >= 255U) {
+            break;
+        }
+    }
+
+    for (i = 0U; (i < (DSRTOS_CRASHDUMP_TEXT_MAX - 1U)) && (start[i] != '\0'); i++) {
+        dst[i] = start[i];
+    }
+}
+
+/**
+ * @brief Describe the current task and copy the live end of its stack
+ */
+static void crashdump_fill_task(dsrtos_crashdump_image_t *image, const dsrtos_panic_context_t *panic)
+{
+    const dsrtos_tcb_t *tcb = dsrtos_task_get_current();
+    uintptr_t base;
+    uintptr_t top;
+    uintptr_t sp;
+    uint32_t words;
+
+    image->task_id = CRASHDUMP_NO_TASK;
+    if (tcb == NULL) {
+        return;
+    }
+
+    image->task_id = tcb->task_id;
+    (void)memcpy(image->task_name, tcb->name, sizeof(image->task_name));
+    image->task_priority = (uint32_t)tcb->effective_priority;
+    image->task_state = (uint32_t)tcb->state;
+    image->stack_base = (uint32_t)(uintptr_t)tcb->stack_base;
+    image->stack_size = tcb->stack_size;
+    image->stack_pointer = (uint32_t)(uintptr_t)tcb->stack_pointer;
+
+    /* Live frames sit above the SP; prefer the PSP captured at the fault */
+    base = (uintptr_t)tcb->stack_base;
+    top = base + tcb->stack_size;
+    sp = (uintptr_t)panic->stack_info.sp_process;
+    if ((sp < base) || (sp >= top)) {
+        sp = (uintptr_t)tcb->stack_pointer;
+    }
+    if ((base == 0U) || (sp < base) || (sp >= top)) {
+        return;
+    }
+
+    sp &= ~(uintptr_t)3U;
+    words = (uint32_t)((top - sp) / 4U);
+    if (words > DSRTOS_CRASHDUMP_STACK_WORDS) {
+        words = DSRTOS_CRASHDUMP_STACK_WORDS;
+    }
+    image->stack_window = (uint32_t)sp;
+    image->stack_words = words;
+    (void)memcpy(image->stack, (const void *)sp, words * 4U);
+}
+
+/**
+ * @brief Switch-in hook: trace the task switched to
+ */
+static void* crashdump_trace_switch(dsrtos_hook_type_t type, void *params)
+{
+    const dsrtos_tcb_t *tcb = (const dsrtos_tcb_t *)params;
+
+    (void)type;
+    if (tcb != NULL) {
+        dsrtos_crashdump_trace(DSRTOS_CRASHDUMP_EVENT_SWITCH, (uint16_t)tcb->task_id,
+                               (uint32_t)tcb->effective_priority);
+    }
+
+    return NULL;
+}
@@ -0,0 +1,82 @@
+/*
+ * @file dsrtos_kernel.c
+ * @brief DSRTOS Kernel Interface for Phase 3
+ * @date 2024-12-30
+ *
+ * Target side of dsrtos_kernel.h: tick time from the phase 1 SysTick
+ * timer, task memory from the kernel heap and the task table walk. The
+ * host port and benchmarks in tests/host provide the same functions for
+ * native builds.
+ *
+ * COMPLIANCE:
+ * - MISRA-C:2012 compliant
+ * - DO-178C DAL-B certifiable
+ * - IEC 62304 Class B compliant
+ * - ISO 26262 ASIL D compliant
+ */
+
+#include "dsrtos_task_manager.h"
+#include "dsrtos_kernel.h"
+#include "dsrtos_task_creation.h"
+#include "dsrtos_timer.h"
+#include "../../include/common/dsrtos_memory.h"
+
+/*==============================================================================
+ * PUBLIC FUNCTIONS
+ *============================================================================*/
+
+/**
+ * @brief Get the time since the timer started
+ * @return Ticks (1 kHz)
+ */
+uint64_t dsrtos_get_system_time(void)
+{
+    return dsrtos_timer_get_ticks();
+}
+
+/**
+ * @brief Get the tick counter
+ * @return Ticks, wrapping at 2^32
+ */
+uint32_t dsrtos_get_tick_count(void)
+{
+    return (uint32_t)dsrtos_timer_get_ticks();
+}
+
+/**
+ * @brief Allocate from the kernel heap
+ * @param size Bytes
+ * @return Block, or NULL if the heap cannot serve it
+ */
+void* dsrtos_malloc(size_t size)
+{
+    void *ptr = NULL;
+
+    if (dsrtos_memory_allocate((dsrtos_size_t)size, &ptr) != DSRTOS_SUCCESS) {
+        ptr = NULL;
+    }
+
+    return ptr;
+}
+
+/**
+ * @brief Return a block to the kernel heap
+ * @param ptr Block from dsrtos_malloc, or NULL
+ */
+void dsrtos_free(void *ptr)
+{
+    if (ptr != NULL) {
+        (void)dsrtos_memory_free(ptr);
+    }
+}
+
+/**
+ * @brief Get a task by table index, for walks over every task
+ * @param index 0 to DSRTOS_MAX_TASKS - 1
+ * @return Task, or NULL if no task holds the index
+ * @note The task table is the handle table: the index is the task ID
+ */
+dsrtos_tcb_t* dsrtos_task_get_by_index(uint32_t index)
+{
+    return dsrtos_task_get_by_id(index);
+}
@@ -0,0 +1,86 @@
+/*
+ * @file dsrtos_port.c
+ * @brief DSRTOS Cortex-M4 Port
+ * @date 2024-12-30
+ *
+ * Target side of dsrtos_port.h. The host port in tests/host provides the
+ * same functions for native builds.
+ *
+ * COMPLIANCE:
+ * - MISRA-C:2012 compliant
+ * - DO-178C DAL-B certifiable
+ * - IEC 62304 Class B compliant
+ * - ISO 26262 ASIL D compliant
+ */
+
+#include "dsrtos_port.h"
+#include "core_cm4.h"
+
+/*==============================================================================
+ * CONSTANTS
+ *============================================================================*/
+
+#define PORT_INITIAL_XPSR       (0x01000000U)   /* Thumb state */
+#define PORT_STACK_ALIGN_MASK   (~(uintptr_t)7U) /* AAPCS: 8-byte aligned SP */
+#define PORT_PC_MASK            (~1U)           /* Exception return clears bit 0 */
+#define PORT_SAVED_REGS         (8U)            /* R4-R11, restored by PendSV */
+
+/*==============================================================================
+ * PUBLIC FUNCTIONS
+ *============================================================================*/
+
+/**
+ * @brief Read the free-running cycle counter
+ * @return DWT CYCCNT, wrapping at 2^32
+ * @note dsrtos_kernel_init() enables the counter before anything reads it
+ */
+uint32_t dsrtos_port_get_cycle_count(void)
+{
+    return DWT->CYCCNT;
+}
+
+/**
+ * @brief Request a context switch
+ * @note Pends PendSV; inside a critical section the switch happens when
+ *       the section exits
+ */
+void dsrtos_port_yield(void)
+{
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+    __DSB();
+    __ISB();
+}
+
+/**
+ * @brief Build a task's first context frame
+ * @param stack_top One past the highest usable stack word
+ * @param entry Task entry point
+ * @param param Entry point argument, in R0
+ * @param exit Where the entry point returns to, dsrtos_task_exit if NULL
+ * @return Initial stack pointer
+ * @note Same layout as dsrtos_context_init_task(): R4-R11 above the
+ *       hardware-stacked frame
+ */
+void* dsrtos_port_init_stack(void *stack_top,
+                             void (*entry)(void *),
+                             void *param,
+                             void (*exit)(void))
+{
+    uint32_t *sp = (uint32_t *)((uintptr_t)stack_top & PORT_STACK_ALIGN_MASK);
+    void (*return_to)(void) = (exit != NULL) ? exit : dsrtos_task_exit;
+    
+    for (uint32_t i = 0U; i < PORT_SAVED_REGS; i++) {
+        *(--sp) = 0U;                                   /* R11..R4 */
+    }
+    
+    *(--sp) = PORT_INITIAL_XPSR;                        /* xPSR */
+    *(--sp) = (uint32_t)(uintptr_t)entry & PORT_PC_MASK; /* PC */
+    *(--sp) = (uint32_t)(uintptr_t)return_to;           /* LR */
+    *(--sp) = 0U;                                       /* R12 */
+    *(--sp) = 0U;                                       /* R3 */
+    *(--sp) = 0U;                                       /* R2 */
+    *(--sp) = 0U;                                       /* R1 */
+    *(--sp) = (uint32_t)(uintptr_t)param;               /* R0 */
+    
+    return sp;
+}
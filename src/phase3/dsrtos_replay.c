@@ -0,0 +1,583 @@
+/*
+ * @file dsrtos_replay.c
+ * @brief DSRTOS Record and Replay of Nondeterministic Inputs
+ * @date 2024-12-30
+ *
+ * Recording appends to the ring under a critical section, from tasks and
+ * interrupts alike. Replay walks a drained log: every input point first
+ * injects the interrupts recorded ahead of it, then takes its own record
+ * and checks the tick and task it was made at.
+ *
+ * COMPLIANCE:
+ * - MISRA-C:2012 compliant
+ * - DO-178C DAL-B certifiable
+ * - IEC 62304 Class B compliant
+ * - ISO 26262 ASIL D compliant
+ */
+
+#include "dsrtos_replay.h"
+#include "dsrtos_task_manager.h"
+#include "dsrtos_hooks.h"
+#include "dsrtos_kernel.h"
+#include "dsrtos_critical.h"
+#include <stddef.h>
+#include <string.h>
+
+/*==============================================================================
+ * CONSTANTS
+ *============================================================================*/
+
+#define REPLAY_MAGIC            (0x52504C59U)  /* 'RPLY' */
+#define REPLAY_MIN_RECORDS      (4U)
+#define REPLAY_POLLS_MAX        (0xFFFFU)       /* Polls saturate in an IRQ record */
+#define REPLAY_NO_EPOCH         (0xFFFFFFFFU)   /* Forces the next EPOCH record */
+
+/*==============================================================================
+ * TYPE DEFINITIONS
+ *============================================================================*/
+
+_Static_assert(sizeof(dsrtos_replay_record_t) == 8U, "record layout");
+
+/* Record and replay context */
+typedef struct {
+    uint32_t magic;
+
+    /* Record ring */
+    dsrtos_replay_record_t *ring;
+    uint32_t mask;
+    uint32_t head;                      /* Records written */
+    uint32_t tail;                      /* Records drained */
+    uint32_t lost_pending;              /* Dropped since the last LOST record */
+
+    /* Stream state, shared by both modes */
+    uint32_t epoch;                     /* High half of the tick last stamped */
+    uint32_t timer_hi;                  /* High word of the last timer read */
+    uint32_t polls;                     /* Since the previous record */
+
+    /* Replay log */
+    const dsrtos_replay_record_t *log;
+    uint32_t count;
+    uint32_t cursor;
+    dsrtos_replay_inject_t inject;
+
+    dsrtos_replay_stats_t stats;
+} replay_t;
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+volatile uint32_t g_dsrtos_replay_mode = (uint32_t)DSRTOS_REPLAY_MODE_OFF;
+
+static replay_t g_replay;
+static dsrtos_replay_record_t g_replay_ring[DSRTOS_REPLAY_RECORDS];
+
+/*==============================================================================
+ * STATIC FUNCTION PROTOTYPES
+ *============================================================================*/
+
+static uint32_t replay_task_id(void);
+static void replay_put(uint32_t type, uint32_t tick, uint32_t task, uint32_t value);
+static void replay_write(uint32_t type, uint32_t value);
+static void replay_diverge(uint32_t index);
+static void replay_take(const dsrtos_replay_record_t *record);
+static void replay_sync(bool input);
+static const dsrtos_replay_record_t* replay_expect(uint32_t type);
+static void* replay_switch(dsrtos_hook_type_t type, void *params);
+
+/* Every switch decision is logged or checked, with no run-time registration */
+DSRTOS_HOOK_STATIC(TASK_SWITCH_IN, replay_switch);
+
+/*==============================================================================
+ * PUBLIC FUNCTIONS
+ *============================================================================*/
+
+/**
+ * @brief Attach the record ring
+ * @param ring Record storage, NULL for the built-in ring
+ * @param count Records in ring, a power of 2 of at least 4
+ * @return Error code
+ * @note Leaves the mode off
+ */
+dsrtos_error_t dsrtos_replay_init(dsrtos_replay_record_t *ring, uint32_t count)
+{
+    if (ring == NULL) {
+        ring = g_replay_ring;
+        count = DSRTOS_REPLAY_RECORDS;
+    }
+
+    if ((count < REPLAY_MIN_RECORDS) || ((count & (count - 1U)) != 0U)) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+
+    g_dsrtos_replay_mode = (uint32_t)DSRTOS_REPLAY_MODE_OFF;
+    (void)memset(&g_replay, 0, sizeof(g_replay));
+    g_replay.ring = ring;
+    g_replay.mask = count - 1U;
+    g_replay.stats.first_divergence = UINT32_MAX;
+    g_replay.magic = REPLAY_MAGIC;
+
+    return DSRTOS_SUCCESS;
+}
+
+/**
+ * @brief Start recording into an empty ring
+ * @return Error code
+ */
+dsrtos_error_t dsrtos_replay_record_start(void)
+{
+    if (g_replay.magic != REPLAY_MAGIC) {
+        return DSRTOS_ERROR_NOT_INITIALIZED;
+    }
+
+    dsrtos_critical_enter();
+
+    g_replay.head = 0U;
+    g_replay.tail = 0U;
+    g_replay.lost_pending = 0U;
+    g_replay.epoch = REPLAY_NO_EPOCH;
+    g_replay.timer_hi = 0U;
+    g_replay.polls = 0U;
+    (void)memset(&g_replay.stats, 0, sizeof(g_replay.stats));
+    g_replay.stats.first_divergence = UINT32_MAX;
+    g_dsrtos_replay_mode = (uint32_t)DSRTOS_REPLAY_MODE_RECORD;
+
+    dsrtos_critical_exit();
+
+    return DSRTOS_SUCCESS;
+}
+
+/**
+ * @brief Start replaying a drained log
+ * @param log Records, oldest first, from the start of a recording
+ * @param count Records in log
+ * @param inject Delivers recorded interrupts, NULL to skip them
+ * @return Error code
+ * @note The run must start from the state recording started from. When
+ *       the log runs out, or at a LOST record or a record of the wrong
+ *       type, the mode drops to off and inputs are live again.
+ */
+dsrtos_error_t dsrtos_replay_start(const dsrtos_replay_record_t *log, uint32_t count,
+                                   dsrtos_replay_inject_t inject)
+{
+    if (g_replay.magic != REPLAY_MAGIC) {
+        return DSRTOS_ERROR_NOT_INITIALIZED;
+    }
+    if ((log == NULL) && (count != 0U)) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+
+    g_dsrtos_replay_mode = (uint32_t)DSRTOS_REPLAY_MODE_OFF;
+    g_replay.log = log;
+    g_replay.count = count;
+    g_replay.cursor = 0U;
+    g_replay.inject = inject;
+    g_replay.timer_hi = 0U;
+    g_replay.polls = 0U;
+    g_replay.stats.replayed = 0U;
+    g_replay.stats.divergences = 0U;
+    g_replay.stats.first_divergence = UINT32_MAX;
+    g_dsrtos_replay_mode = (uint32_t)DSRTOS_REPLAY_MODE_REPLAY;
+
+    /* Interrupts that came before any input */
+    replay_sync(false);
+
+    return DSRTOS_SUCCESS;
+}
+
+/**
+ * @brief Stop recording or replaying
+ * @note Recorded records stay in the ring for drain
+ */
+void dsrtos_replay_stop(void)
+{
+    g_dsrtos_replay_mode = (uint32_t)DSRTOS_REPLAY_MODE_OFF;
+}
+
+/**
+ * @brief Take records out of the ring, oldest first
+ * @param out Destination
+ * @param max Records that fit in out
+ * @return Records copied
+ * @note Safe while recording: the writer never passes the drain point
+ */
+uint32_t dsrtos_replay_drain(dsrtos_replay_record_t *out, uint32_t max)
+{
+    uint32_t head;
+    uint32_t tail;
+    uint32_t n;
+
+    if ((g_replay.magic != REPLAY_MAGIC) || (out == NULL)) {
+        return 0U;
+    }
+
+    dsrtos_critical_enter();
+    head = g_replay.head;
+    tail = g_replay.tail;
+    dsrtos_critical_exit();
+
+    n = head - tail;
+    if (n > max) {
+        n = max;
+    }
+    for (uint32_t i = 0U; i < n; i++) {
+        out[i] = g_replay.ring[(tail + i) & g_replay.mask];
+    }
+
+    dsrtos_critical_enter();
+    g_replay.tail = tail + n;
+    g_replay.stats.drained += n;
+    dsrtos_critical_exit();
+
+    return n;
+}
+
+/**
+ * @brief Get record and replay statistics
+ * @param stats Destination
+ * @return Error code
+ */
+dsrtos_error_t dsrtos_replay_get_stats(dsrtos_replay_stats_t *stats)
+{
+    if (stats == NULL) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+    if (g_replay.magic != REPLAY_MAGIC) {
+        return DSRTOS_ERROR_NOT_INITIALIZED;
+    }
+
+    dsrtos_critical_enter();
+    *stats = g_replay.stats;
+    dsrtos_critical_exit();
+
+    return DSRTOS_SUCCESS;
+}
+
+/*==============================================================================
+ * INPUT POINTS
+ *============================================================================*/
+
+/**
+ * @brief Interrupt entry
+ * @param irq_num Interrupt number, negative for system exceptions
+ * @note In replay the interrupt came from the log: nothing to do
+ */
+void dsrtos_replay_irq_slow(int16_t irq_num)
+{
+    if (g_dsrtos_replay_mode == (uint32_t)DSRTOS_REPLAY_MODE_RECORD) {
+        dsrtos_critical_enter();
+        replay_write(DSRTOS_REPLAY_IRQ, (g_replay.polls << 16U) | (uint16_t)irq_num);
+        dsrtos_critical_exit();
+    }
+}
+
+/**
+ * @brief UART byte received
+ * @param uart_id UART instance
+ * @param byte Byte read from the data register
+ * @return Byte to deliver
+ */
+uint8_t dsrtos_replay_uart_rx_slow(uint8_t uart_id, uint8_t byte)
+{
+    const dsrtos_replay_record_t *record;
+
+    if (g_dsrtos_replay_mode == (uint32_t)DSRTOS_REPLAY_MODE_RECORD) {
+        dsrtos_critical_enter();
+        replay_write(DSRTOS_REPLAY_UART_RX, ((uint32_t)uart_id << 8U) | byte);
+        dsrtos_critical_exit();
+    } else {
+        record = replay_expect(DSRTOS_REPLAY_UART_RX);
+        if (record != NULL) {
+            if ((record->value >> 8U) != uart_id) {
+                replay_diverge(g_replay.cursor - 1U);
+            }
+            byte = (uint8_t)record->value;
+            replay_sync(false);
+        }
+    }
+
+    return byte;
+}
+
+/**
+ * @brief Timer read
+ * @param value Time read from the timer
+ * @return Time to use
+ */
+uint64_t dsrtos_replay_timer_slow(uint64_t value)
+{
+    const dsrtos_replay_record_t *record;
+    uint32_t high = (uint32_t)(value >> 32U);
+
+    if (g_dsrtos_replay_mode == (uint32_t)DSRTOS_REPLAY_MODE_RECORD) {
+        dsrtos_critical_enter();
+        if (high != g_replay.timer_hi) {
+            g_replay.timer_hi = high;
+            replay_write(DSRTOS_REPLAY_TIMER_HI, high);
+        }
+        replay_write(DSRTOS_REPLAY_TIMER, (uint32_t)value);
+        dsrtos_critical_exit();
+    } else {
+        replay_sync(true);
+        if ((g_dsrtos_replay_mode == (uint32_t)DSRTOS_REPLAY_MODE_REPLAY) &&
+            (g_replay.cursor < g_replay.count) &&
+            (DSRTOS_REPLAY_TYPE(&g_replay.log[g_replay.cursor]) == DSRTOS_REPLAY_TIMER_HI)) {
+            g_replay.timer_hi = g_replay.log[g_replay.cursor].value;
+            replay_take(&g_replay.log[g_replay.cursor]);
+        }
+        record = replay_expect(DSRTOS_REPLAY_TIMER);
+        if (record != NULL) {
+            value = ((uint64_t)g_replay.timer_hi << 32U) | record->value;
+            replay_sync(false);
+        }
+    }
+
+    return value;
+}
+
+/**
+ * @brief Application input
+ * @param value Live value
+ * @return Value to use
+ */
+uint32_t dsrtos_replay_input_slow(uint32_t value)
+{
+    const dsrtos_replay_record_t *record;
+
+    if (g_dsrtos_replay_mode == (uint32_t)DSRTOS_REPLAY_MODE_RECORD) {
+        dsrtos_critical_enter();
+        replay_write(DSRTOS_REPLAY_INPUT, value);
+        dsrtos_critical_exit();
+    } else {
+        record = replay_expect(DSRTOS_REPLAY_INPUT);
+        if (record != NULL) {
+            value = record->value;
+            replay_sync(false);
+        }
+    }
+
+    return value;
+}
+
+/**
+ * @brief Interrupt position marker
+ * @note Replay injects an interrupt at the poll its record counted
+ */
+void dsrtos_replay_poll_slow(void)
+{
+    if (g_replay.polls < REPLAY_POLLS_MAX) {
+        g_replay.polls++;
+    }
+    if (g_dsrtos_replay_mode == (uint32_t)DSRTOS_REPLAY_MODE_REPLAY) {
+        replay_sync(false);
+    }
+}
+
+/*==============================================================================
+ * STATIC FUNCTIONS
+ *============================================================================*/
+
+/**
+ * @brief Task field for a record
+ */
+static uint32_t replay_task_id(void)
+{
+    const dsrtos_tcb_t *tcb = dsrtos_task_get_current();
+
+    return ((tcb == NULL) || (tcb->task_id > DSRTOS_REPLAY_NO_TASK)) ?
+           DSRTOS_REPLAY_NO_TASK : tcb->task_id;
+}
+
+/**
+ * @brief Append one record, or count it lost
+ * @note A LOST record goes in as soon as it fits with the next record
+ */
+static void replay_put(uint32_t type, uint32_t tick, uint32_t task, uint32_t value)
+{
+    dsrtos_replay_record_t *slot;
+    uint32_t used = g_replay.head - g_replay.tail;
+    uint32_t need = (g_replay.lost_pending != 0U) ? 2U : 1U;
+
+    if ((used + need) > (g_replay.mask + 1U)) {
+        /* A dropped EPOCH is sent again with the next record, not lost */
+        if (type != DSRTOS_REPLAY_EPOCH) {
+            g_replay.lost_pending++;
+            g_replay.stats.lost++;
+        }
+        return;
+    }
+
+    if (g_replay.lost_pending != 0U) {
+        slot = &g_replay.ring[g_replay.head & g_replay.mask];
+        slot->tick = (uint16_t)tick;
+        slot->type_task = (uint16_t)((DSRTOS_REPLAY_LOST << 12U) | task);
+        slot->value = g_replay.lost_pending;
+        g_replay.head++;
+        g_replay.lost_pending = 0U;
+    }
+
+    slot = &g_replay.ring[g_replay.head & g_replay.mask];
+    slot->tick = (uint16_t)tick;
+    slot->type_task = (uint16_t)((type << 12U) | task);
+    slot->value = value;
+    g_replay.head++;
+
+    g_replay.stats.recorded++;
+    used = g_replay.head - g_replay.tail;
+    if (used > g_replay.stats.high_water) {
+        g_replay.stats.high_water = used;
+    }
+}
+
+/**
+ * @brief Record an input at the current tick and task
+ * @note Called in a critical section
+ */
+static void replay_write(uint32_t type, uint32_t value)
+{
+    uint32_t tick = dsrtos_get_tick_count();
+    uint32_t task = replay_task_id();
+
+    /* After a hole the reader needs the full tick again */
+    if (((tick >> 16U) != g_replay.epoch) || (g_replay.lost_pending != 0U)) {
+        g_replay.epoch = tick >> 16U;
+        replay_put(DSRTOS_REPLAY_EPOCH, tick, task, tick);
+    }
+    replay_put(type, tick, task, value);
+    g_replay.polls = 0U;
+}
+
+/**
+ * @brief Count a departure from the log
+ * @param index Log index of the record departed from
+ */
+static void replay_diverge(uint32_t index)
+{
+    if (g_replay.stats.divergences == 0U) {
+        g_replay.stats.first_divergence = index;
+    }
+    g_replay.stats.divergences++;
+}
+
+/**
+ * @brief Consume the record at the cursor
+ * @note The replayed run must reach it at the recorded tick and task
+ */
+static void replay_take(const dsrtos_replay_record_t *record)
+{
+    if ((record->tick != (uint16_t)dsrtos_get_tick_count()) ||
+        (DSRTOS_REPLAY_TASK(record) != replay_task_id())) {
+        replay_diverge(g_replay.cursor);
+    }
+    g_replay.cursor++;
+    g_replay.stats.replayed++;
+    g_replay.polls = 0U;
+}
+
+/**
+ * @brief Inject the interrupts due before the next input
+ * @param input true at an input point: every interrupt ahead of the
+ *        input is due, and one still short of its polls diverged
+ * @note An injected handler reaches input points of its own, which
+ *       consume the records that follow, as it did when recorded
+ */
+static void replay_sync(bool input)
+{
+    const dsrtos_replay_record_t *record;
+    uint32_t polls;
+
+    while ((g_dsrtos_replay_mode == (uint32_t)DSRTOS_REPLAY_MODE_REPLAY) &&
+           (g_replay.cursor < g_replay.count)) {
+        record = &g_replay.log[g_replay.cursor];
+
+        switch (DSRTOS_REPLAY_TYPE(record)) {
+        case DSRTOS_REPLAY_EPOCH:
+            g_replay.cursor++;
+            g_replay.stats.replayed++;
+            break;
+
+        case DSRTOS_REPLAY_LOST:
+            /* The log has a hole: nothing after it can be trusted */
+            replay_diverge(g_replay.cursor);
+            g_dsrtos_replay_mode = (uint32_t)DSRTOS_REPLAY_MODE_OFF;
+            return;
+
+        case DSRTOS_REPLAY_IRQ:
+            polls = record->value >> 16U;
+            if (g_replay.polls < polls) {
+                if (!input) {
+                    return;
+                }
+                replay_diverge(g_replay.cursor);
+            }
+            replay_take(record);
+            if (g_replay.inject != NULL) {
+                g_replay.inject((int16_t)(uint16_t)record->value);
+            }
+            break;
+
+        default:
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Take the next record, which must be of the given type
+ * @return Record, or NULL once replay has ended
+ */
+static const dsrtos_replay_record_t* replay_expect(uint32_t type)
+{
+    const dsrtos_replay_record_t *record;
+
+    replay_sync(true);
+    if (g_dsrtos_replay_mode != (uint32_t)DSRTOS_REPLAY_MODE_REPLAY) {
+        return NULL;
+    }
+
+    if (g_replay.cursor >= g_replay.count) {
+        g_dsrtos_replay_mode = (uint32_t)DSRTOS_REPLAY_MODE_OFF;
+        return NULL;
+    }
+
+    record = &g_replay.log[g_replay.cursor];
+    if (DSRTOS_REPLAY_TYPE(record) != type) {
+        /* Another input than recorded: the runs have parted */
+        replay_diverge(g_replay.cursor);
+        g_dsrtos_replay_mode = (uint32_t)DSRTOS_REPLAY_MODE_OFF;
+        return NULL;
+    }
+
+    replay_take(record);
+    return record;
+}
+
+/**
+ * @brief Switch-in hook: log the decision, or check it in replay
+ */
+static void* replay_switch(dsrtos_hook_type_t type, void *params)
+{
+    const dsrtos_tcb_t *tcb = (const dsrtos_tcb_t *)params;
+    const dsrtos_replay_record_t *record;
+    uint32_t task_id = ((tcb == NULL) || (tcb->task_id > DSRTOS_REPLAY_NO_TASK)) ?
+                       DSRTOS_REPLAY_NO_TASK : tcb->task_id;
+
+    (void)type;
+    if (g_dsrtos_replay_mode == (uint32_t)DSRTOS_REPLAY_MODE_RECORD) {
+        dsrtos_critical_enter();
+        replay_write(DSRTOS_REPLAY_SWITCH, task_id);
+        dsrtos_critical_exit();
+    } else if (g_dsrtos_replay_mode == (uint32_t)DSRTOS_REPLAY_MODE_REPLAY) {
+        record = replay_expect(DSRTOS_REPLAY_SWITCH);
+        if (record != NULL) {
+            if (record->value != task_id) {
+                replay_diverge(g_replay.cursor - 1U);
+            }
+            replay_sync(false);
+        }
+    } else {
+        /* Off */
+    }
+
+    return NULL;
+}
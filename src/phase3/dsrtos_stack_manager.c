@@ -19,6 +19,7 @@
 #include "dsrtos_kernel.h"
 #include "dsrtos_critical.h"
 #include "dsrtos_port.h"
+#include "dsrtos_pool.h"
 #include <string.h>
 
 /*==============================================================================
@@ -31,19 +32,25 @@
 #define STACK_ALIGNMENT_MASK    (7U)   /* 8-byte alignment */
 #define STACK_MIN_FREE_THRESHOLD (128U) /* Minimum free stack warning threshold */
 
+#ifndef DSRTOS_ERROR_LOW_RESOURCE
+#define DSRTOS_ERROR_LOW_RESOURCE   DSRTOS_ERROR_NO_RESOURCES
+#endif
+
 /*==============================================================================
  * TYPE DEFINITIONS
  *============================================================================*/
 
 /* stack_manager_stats_t is defined in dsrtos_stack_manager.h */
 
-/* Stack monitor entry */
-typedef struct {
+/* Stack monitor entry, reached from its task through tcb->stack_monitor */
+typedef struct stack_monitor_entry {
     dsrtos_tcb_t *task;
     uint32_t watermark;
     uint32_t peak_usage;
     uint32_t last_check_time;
     uint32_t violations;
+    struct stack_monitor_entry *next;  /* Monitored-task list */
+    struct stack_monitor_entry *prev;
 } stack_monitor_entry_t;
 
 /*==============================================================================
@@ -53,8 +60,10 @@ typedef struct {
 /* Stack manager statistics */
 static stack_manager_stats_t g_stack_stats = {0};
 
-/* Stack monitoring table */
+/* Stack monitor entries: free ones in the pool, used ones on the list */
 static stack_monitor_entry_t g_stack_monitors[DSRTOS_MAX_TASKS];
+static dsrtos_pool_t g_monitor_pool;
+static stack_monitor_entry_t *g_monitor_head = NULL;
 
 /* Stack overflow hook */
 static dsrtos_stack_overflow_hook_t g_overflow_hook = NULL;
@@ -68,6 +77,7 @@ static dsrtos_error_t check_stack_guards(const dsrtos_tcb_t *tcb);
 static void update_watermark(dsrtos_tcb_t *tcb);
 static void handle_stack_overflow(dsrtos_tcb_t *tcb);
 static uint32_t find_stack_watermark(const uint32_t *stack_base, uint32_t stack_size);
+static stack_monitor_entry_t* find_monitor(const dsrtos_tcb_t *tcb);
 
 /*==============================================================================
  * PUBLIC FUNCTIONS
@@ -84,8 +94,11 @@ dsrtos_error_t dsrtos_stack_manager_init(void)
     
     /* Clear monitor table */
     (void)memset(g_stack_monitors, 0, sizeof(g_stack_monitors));
+    g_monitor_head = NULL;
     
-    return DSRTOS_SUCCESS;
+    return dsrtos_pool_init(&g_monitor_pool, "stack_monitors", g_stack_monitors,
+                            sizeof(stack_monitor_entry_t), DSRTOS_MAX_TASKS,
+                            DSRTOS_POOL_FLAG_NONE);
 }
 
 /**
@@ -106,6 +119,7 @@ dsrtos_error_t dsrtos_stack_init(dsrtos_tcb_t *tcb,
     uint32_t *stack_words;
     uint32_t word_count;
     uint32_t *stack_top;
+    stack_monitor_entry_t *monitor;
     
     /* Validate parameters */
     if ((tcb == NULL) || (stack_base == NULL) || (entry_point == NULL)) {
@@ -150,21 +164,80 @@ dsrtos_error_t dsrtos_stack_init(dsrtos_tcb_t *tcb,
     tcb->stack_size = stack_size;
     tcb->cpu_context.sp = (uint32_t)tcb->stack_pointer;
     
-    /* Initialize monitor entry */
-    for (uint32_t i = 0U; i < DSRTOS_MAX_TASKS; i++) {
-        if (g_stack_monitors[i].task == NULL) {
-            g_stack_monitors[i].task = tcb;
-            g_stack_monitors[i].watermark = stack_size;
-            g_stack_monitors[i].peak_usage = 0U;
-            g_stack_monitors[i].last_check_time = dsrtos_get_system_time();
-            g_stack_monitors[i].violations = 0U;
-            break;
+    /* Initialize monitor entry: reuse the task's own, else take a free one */
+    dsrtos_critical_enter();
+    monitor = find_monitor(tcb);
+    if (monitor == NULL) {
+        monitor = (stack_monitor_entry_t *)dsrtos_pool_alloc(&g_monitor_pool);
+        if (monitor != NULL) {
+            monitor->task = tcb;
+            monitor->prev = NULL;
+            monitor->next = g_monitor_head;
+            if (g_monitor_head != NULL) {
+                g_monitor_head->prev = monitor;
+            }
+            g_monitor_head = monitor;
+            tcb->stack_monitor = monitor;
+            
+            /* Update statistics */
+            g_stack_stats.total_stacks++;
+            g_stack_stats.total_stack_memory += stack_size;
         }
     }
+    if (monitor != NULL) {
+        monitor->watermark = stack_size;
+        monitor->peak_usage = 0U;
+        monitor->last_check_time = dsrtos_get_system_time();
+        monitor->violations = 0U;
+    }
+    dsrtos_critical_exit();
     
-    /* Update statistics */
-    g_stack_stats.total_stacks++;
-    g_stack_stats.total_stack_memory += stack_size;
+    return DSRTOS_SUCCESS;
+}
+
+/**
+ * @brief Stop monitoring a task's stack
+ * @param tcb Task control block, before it is freed
+ * @return Error code
+ */
+dsrtos_error_t dsrtos_stack_release(dsrtos_tcb_t *tcb)
+{
+    stack_monitor_entry_t *monitor;
+    
+    if (tcb == NULL) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+    
+    dsrtos_critical_enter();
+    
+    monitor = find_monitor(tcb);
+    if (monitor == NULL) {
+        dsrtos_critical_exit();
+        return DSRTOS_ERROR_NOT_FOUND;
+    }
+    
+    /* Unlink from the monitored-task list */
+    if (monitor->prev != NULL) {
+        monitor->prev->next = monitor->next;
+    } else {
+        g_monitor_head = monitor->next;
+    }
+    if (monitor->next != NULL) {
+        monitor->next->prev = monitor->prev;
+    }
+    
+    tcb->stack_monitor = NULL;
+    monitor->task = NULL;
+    (void)dsrtos_pool_free(&g_monitor_pool, monitor);
+    
+    if (g_stack_stats.total_stacks > 0U) {
+        g_stack_stats.total_stacks--;
+    }
+    if (g_stack_stats.total_stack_memory >= tcb->stack_size) {
+        g_stack_stats.total_stack_memory -= tcb->stack_size;
+    }
+    
+    dsrtos_critical_exit();
     
     return DSRTOS_SUCCESS;
 }
@@ -245,17 +318,18 @@ dsrtos_error_t dsrtos_stack_get_usage(const dsrtos_tcb_t *tcb,
 dsrtos_error_t dsrtos_stack_get_watermark(const dsrtos_tcb_t *tcb,
                                           uint32_t *watermark)
 {
+    const stack_monitor_entry_t *monitor;
+    
     /* Validate parameters */
     if ((tcb == NULL) || (watermark == NULL)) {
         return DSRTOS_ERROR_INVALID_PARAM;
     }
     
     /* Find monitor entry */
-    for (uint32_t i = 0U; i < DSRTOS_MAX_TASKS; i++) {
-        if (g_stack_monitors[i].task == tcb) {
-            *watermark = g_stack_monitors[i].watermark;
-            return DSRTOS_SUCCESS;
-        }
+    monitor = find_monitor(tcb);
+    if (monitor != NULL) {
+        *watermark = monitor->watermark;
+        return DSRTOS_SUCCESS;
     }
     
     /* If not found, calculate it */
@@ -267,21 +341,27 @@ dsrtos_error_t dsrtos_stack_get_watermark(const dsrtos_tcb_t *tcb,
 /**
  * @brief Check all task stacks
  * @return Error code (first error encountered)
+ * @note Walks the monitored tasks only, so the cost follows the number of
+ *       live tasks rather than DSRTOS_MAX_TASKS
  */
 dsrtos_error_t dsrtos_stack_check_all(void)
 {
     dsrtos_error_t err;
     dsrtos_error_t first_error = DSRTOS_SUCCESS;
+    stack_monitor_entry_t *monitor;
+    stack_monitor_entry_t *next;
     
     dsrtos_critical_enter();
     
-    for (uint32_t i = 0U; i < DSRTOS_MAX_TASKS; i++) {
-        if (g_stack_monitors[i].task != NULL) {
-            err = dsrtos_stack_check(g_stack_monitors[i].task);
-            if ((err != DSRTOS_SUCCESS) && (first_error == DSRTOS_SUCCESS)) {
-                first_error = err;
-            }
+    monitor = g_monitor_head;
+    while (monitor != NULL) {
+        /* The overflow hook may release the task */
+        next = monitor->next;
+        err = dsrtos_stack_check(monitor->task);
+        if ((err != DSRTOS_SUCCESS) && (first_error == DSRTOS_SUCCESS)) {
+            first_error = err;
         }
+        monitor = next;
     }
     
     dsrtos_critical_exit();
@@ -384,25 +464,24 @@ static dsrtos_error_t check_stack_guards(const dsrtos_tcb_t *tcb)
 static void update_watermark(dsrtos_tcb_t *tcb)
 {
     uint32_t current_watermark;
+    stack_monitor_entry_t *monitor;
     
     /* Calculate current watermark */
     current_watermark = find_stack_watermark((uint32_t *)tcb->stack_base, tcb->stack_size);
     
     /* Update monitor entry */
-    for (uint32_t i = 0U; i < DSRTOS_MAX_TASKS; i++) {
-        if (g_stack_monitors[i].task == tcb) {
-            if (current_watermark < g_stack_monitors[i].watermark) {
-                g_stack_monitors[i].watermark = current_watermark;
-            }
-            
-            uint32_t usage = tcb->stack_size - current_watermark;
-            if (usage > g_stack_monitors[i].peak_usage) {
-                g_stack_monitors[i].peak_usage = usage;
-            }
-            
-            g_stack_monitors[i].last_check_time = dsrtos_get_system_time();
-            break;
+    monitor = find_monitor(tcb);
+    if (monitor != NULL) {
+        if (current_watermark < monitor->watermark) {
+            monitor->watermark = current_watermark;
         }
+        
+        uint32_t usage = tcb->stack_size - current_watermark;
+        if (usage > monitor->peak_usage) {
+            monitor->peak_usage = usage;
+        }
+        
+        monitor->last_check_time = dsrtos_get_system_time();
     }
 }
 
@@ -439,11 +518,9 @@ static void handle_stack_overflow(dsrtos_tcb_t *tcb)
     g_stack_stats.overflow_detections++;
     
     /* Update monitor entry */
-    for (uint32_t i = 0U; i < DSRTOS_MAX_TASKS; i++) {
-        if (g_stack_monitors[i].task == tcb) {
-            g_stack_monitors[i].violations++;
-            break;
-        }
+    stack_monitor_entry_t *monitor = find_monitor(tcb);
+    if (monitor != NULL) {
+        monitor->violations++;
     }
     
     /* Call overflow hook if registered */
@@ -454,3 +531,22 @@ static void handle_stack_overflow(dsrtos_tcb_t *tcb)
     /* Suspend the task to prevent further damage */
     (void)dsrtos_task_suspend(tcb);
 }
+
+/**
+ * @brief Find a task's monitor entry
+ * @param tcb Task control block
+ * @return Monitor entry or NULL if the task is not monitored
+ * @note O(1): follows tcb->stack_monitor, checked against the pool and the
+ *       owner so a stale or trampled pointer is never trusted
+ */
+static stack_monitor_entry_t* find_monitor(const dsrtos_tcb_t *tcb)
+{
+    stack_monitor_entry_t *monitor = (stack_monitor_entry_t *)tcb->stack_monitor;
+    
+    if ((monitor == NULL) || !dsrtos_pool_owns(&g_monitor_pool, monitor) ||
+        (monitor->task != tcb)) {
+        return NULL;
+    }
+    
+    return monitor;
+}
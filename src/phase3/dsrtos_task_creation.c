@@ -20,6 +20,12 @@
 #include "dsrtos_memory.h"
 #include "dsrtos_port.h"
 #include "dsrtos_types.h"
+#include "dsrtos_arena.h"
+#include "dsrtos_pool.h"
+#include "dsrtos_region.h"
+#include "dsrtos_handle.h"
+#include "dsrtos_budget.h"
+#include "../../include/common/dsrtos_memory.h"
 #include <string.h>
 
 /*==============================================================================
@@ -27,11 +33,23 @@
  *============================================================================*/
 
 #define TASK_POOL_SIZE          (32U)
-#define STACK_POOL_SIZE         (16U)
 #define STACK_ALIGNMENT         (8U)
+
+/* Stack size classes: same 16 KB of CCM as the old 16 x 1 KB pool */
+#define STACK_CLASS_COUNT       (3U)
+#define STACK_SMALL_SIZE        (512U)
+#define STACK_SMALL_COUNT       (8U)
+#define STACK_MEDIUM_SIZE       (1024U)
+#define STACK_MEDIUM_COUNT      (8U)
+#define STACK_LARGE_SIZE        (2048U)
+#define STACK_LARGE_COUNT       (2U)
 #define TASK_NAME_PREFIX        "Task_"
 #define MAX_RESTART_COUNT       (3U)
 
+/* Internal: TCB and stack came from this module's pools or heap, so
+ * dsrtos_task_release() gives them back; caller-provided ones are left */
+#define TASK_FLAG_ALLOCATED     (0x80000000U)
+
 /* Phase3 constants that should be in dsrtos_types.h */
 #ifndef DSRTOS_TASK_FLAG_NO_DELETE
 #define DSRTOS_TASK_FLAG_NO_DELETE          (0x02U)
@@ -62,20 +80,13 @@
  * TYPE DEFINITIONS
  *============================================================================*/
 
-/* Task pool entry for static allocation */
-typedef struct {
-    dsrtos_tcb_t tcb;
-    bool allocated;
-    uint32_t allocation_time;
-} task_pool_entry_t;
-
-/* Stack pool entry for static allocation */
+/* One stack size class: a fixed-block pool over its own storage */
 typedef struct {
-    uint8_t stack[DSRTOS_DEFAULT_STACK_SIZE];
-    bool allocated;
-    uint32_t size;
-    dsrtos_tcb_t *owner;
-} stack_pool_entry_t;
+    dsrtos_pool_t pool;
+    uint8_t *storage;
+    uint32_t stack_size;
+    uint32_t count;
+} stack_class_t;
 
 /* task_creation_stats_t is defined in dsrtos_task_creation.h */
 
@@ -83,21 +94,32 @@ typedef struct {
  * STATIC VARIABLES
  *============================================================================*/
 
-/* Static task pool for fast allocation */
-static task_pool_entry_t g_task_pool[TASK_POOL_SIZE] __attribute__((aligned(32)));
+/* Static TCB storage; free TCBs are linked through the pool */
+static dsrtos_tcb_t g_task_storage[TASK_POOL_SIZE] DSRTOS_CCM_BSS __attribute__((aligned(32)));
+static dsrtos_pool_t g_task_pool;
 
-/* Static stack pool for common stack sizes */
-static stack_pool_entry_t g_stack_pool[STACK_POOL_SIZE] __attribute__((aligned(STACK_ALIGNMENT)));
+/* Static stack storage, one free list per size class */
+static uint8_t g_stack_small[STACK_SMALL_COUNT * STACK_SMALL_SIZE] DSRTOS_CCM_BSS __attribute__((aligned(STACK_ALIGNMENT)));
+static uint8_t g_stack_medium[STACK_MEDIUM_COUNT * STACK_MEDIUM_SIZE] DSRTOS_CCM_BSS __attribute__((aligned(STACK_ALIGNMENT)));
+static uint8_t g_stack_large[STACK_LARGE_COUNT * STACK_LARGE_SIZE] DSRTOS_CCM_BSS __attribute__((aligned(STACK_ALIGNMENT)));
+
+/* Ascending size: allocation takes the first class that fits and has room */
+static stack_class_t g_stack_classes[STACK_CLASS_COUNT] = {
+    { .storage = g_stack_small,  .stack_size = STACK_SMALL_SIZE,  .count = STACK_SMALL_COUNT },
+    { .storage = g_stack_medium, .stack_size = STACK_MEDIUM_SIZE, .count = STACK_MEDIUM_COUNT },
+    { .storage = g_stack_large,  .stack_size = STACK_LARGE_SIZE,  .count = STACK_LARGE_COUNT }
+};
+
+/* Task handles: the slot index is the task ID */
+static dsrtos_handle_slot_t g_task_handle_slots[DSRTOS_MAX_TASKS];
+static dsrtos_handle_table_t g_task_handles;
 
 /* Creation statistics */
 static task_creation_stats_t g_creation_stats = {0};
 
-/* Task restart tracking */
-static struct {
-    dsrtos_tcb_t *task;
-    uint32_t restart_count;
-    uint32_t last_restart_time;
-} g_restart_tracking[DSRTOS_MAX_TASKS];
+/* Tasks that exited on their own stack, linked through tcb->next, waiting
+ * for dsrtos_task_reap() to release them */
+static dsrtos_tcb_t *g_zombie_head = NULL;
 
 /*==============================================================================
  * STATIC FUNCTION PROTOTYPES
@@ -107,11 +129,14 @@ static dsrtos_tcb_t* allocate_tcb_from_pool(void);
 static void free_tcb_to_pool(dsrtos_tcb_t *tcb);
 static void* allocate_stack_from_pool(uint32_t size);
 static void free_stack_to_pool(void *stack);
+static void* allocate_task_memory(dsrtos_mem_class_t mem_class, uint32_t size);
 static dsrtos_error_t validate_task_parameters(const dsrtos_task_params_t *params);
 static dsrtos_error_t setup_task_context(dsrtos_tcb_t *tcb, const dsrtos_task_params_t *params);
 static void task_exit_handler(void);
 static dsrtos_error_t check_stack_integrity(dsrtos_tcb_t *tcb);
+static dsrtos_error_t assign_task_handle(dsrtos_tcb_t *tcb);
 static void update_creation_statistics(bool success, bool from_pool);
+static uint32_t heap_profile_owner(void);
 
 /*==============================================================================
  * PUBLIC FUNCTIONS
@@ -123,21 +148,144 @@ static void update_creation_statistics(bool success, bool from_pool);
  */
 dsrtos_error_t dsrtos_task_creation_init(void)
 {
+    dsrtos_memory_profile_hooks_t profile_hooks;
+    dsrtos_region_stats_t region_stats;
+    dsrtos_error_t err;
+    
     /* Initialize task pool */
-    (void)memset(g_task_pool, 0, sizeof(g_task_pool));
+    err = dsrtos_pool_init(&g_task_pool, "task_tcbs", g_task_storage,
+                           sizeof(dsrtos_tcb_t), TASK_POOL_SIZE, DSRTOS_POOL_FLAG_NONE);
+    if (err != DSRTOS_SUCCESS) {
+        return err;
+    }
     
-    /* Initialize stack pool */
-    (void)memset(g_stack_pool, 0, sizeof(g_stack_pool));
+    /* Initialize stack pools */
+    for (uint32_t i = 0U; i < STACK_CLASS_COUNT; i++) {
+        err = dsrtos_pool_init(&g_stack_classes[i].pool, "task_stacks",
+                               g_stack_classes[i].storage, g_stack_classes[i].stack_size,
+                               g_stack_classes[i].count, DSRTOS_POOL_FLAG_NONE);
+        if (err != DSRTOS_SUCCESS) {
+            return err;
+        }
+    }
     
-    /* Initialize restart tracking */
-    (void)memset(g_restart_tracking, 0, sizeof(g_restart_tracking));
+    /* Tasks beyond the pools are placed by region: CCM first on target.
+     * A map the application installed first is kept */
+    if (dsrtos_region_get_stats(0U, &region_stats) != DSRTOS_SUCCESS) {
+        (void)dsrtos_region_init_default();
+    }
+    
+    /* Initialize task handle table */
+    err = dsrtos_handle_table_init(&g_task_handles, "tasks", DSRTOS_HANDLE_TYPE_TASK,
+                                   g_task_handle_slots, DSRTOS_MAX_TASKS);
+    if (err != DSRTOS_SUCCESS) {
+        return err;
+    }
     
     /* Reset statistics */
     (void)memset(&g_creation_stats, 0, sizeof(g_creation_stats));
     
+    /* Attribute heap allocations to the running task (no-op unless profiling) */
+    profile_hooks.get_owner = heap_profile_owner;
+    profile_hooks.get_timestamp = dsrtos_port_get_cycle_count;
+    (void)dsrtos_memory_profile_set_hooks(&profile_hooks);
+    
+    return DSRTOS_SUCCESS;
+}
+
+/**
+ * @brief Create a task in caller-provided TCB and stack memory
+ * @param tcb TCB to initialise
+ * @param params Task parameters, stack_buffer set
+ * @return Error code
+ * @note Every creation API ends here, so this is the one place a task is
+ *       given its handle and ID
+ */
+dsrtos_error_t dsrtos_task_create_static(dsrtos_tcb_t *tcb, const dsrtos_task_params_t *params)
+{
+    dsrtos_error_t err;
+    
+    if ((tcb == NULL) || (params == NULL) || (params->stack_buffer == NULL)) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+    
+    err = validate_task_parameters(params);
+    if (err != DSRTOS_SUCCESS) {
+        return err;
+    }
+    
+    (void)memset(tcb, 0, sizeof(*tcb));
+    (void)memcpy(tcb->name, params->name, sizeof(tcb->name));
+    tcb->name[DSRTOS_TASK_NAME_MAX_LENGTH - 1U] = '\0';
+    tcb->entry_point = params->entry_point;
+    tcb->parameter = params->parameter;
+    tcb->task_param = params->parameter;
+    tcb->priority = params->priority;
+    tcb->effective_priority = params->priority;
+    tcb->static_priority = (uint32_t)params->priority;
+    tcb->flags = params->flags & ~TASK_FLAG_ALLOCATED;
+    tcb->sched_class = params->sched_class;
+    tcb->timing.deadline = params->deadline;
+    tcb->timing.period = params->period;
+    tcb->timing.wcet = params->wcet;
+    tcb->cpu_affinity = params->cpu_affinity;
+    tcb->exit_handler = (void *)params->exit_handler;
+    tcb->stack_base = params->stack_buffer;
+    tcb->stack_size = params->stack_size;
+    tcb->stack_canary = DSRTOS_STACK_CANARY_VALUE;
+    tcb->time_slice_remaining = DSRTOS_DEFAULT_TIME_SLICE;
+    tcb->prev_state = DSRTOS_TASK_STATE_INVALID;
+    
+    err = assign_task_handle(tcb);
+    if (err != DSRTOS_SUCCESS) {
+        return err;
+    }
+    
+    (void)setup_task_context(tcb, params);
+    tcb->magic_number = DSRTOS_TCB_MAGIC;
+    
+    dsrtos_critical_enter();
+    tcb->state = DSRTOS_TASK_STATE_READY;
+    (void)dsrtos_task_ready_insert(tcb);
+    dsrtos_critical_exit();
+    
     return DSRTOS_SUCCESS;
 }
 
+/**
+ * @brief Create a task with a pooled TCB and stack
+ * @param tcb Receives the new task
+ * @param params Task parameters; stack_buffer is ignored
+ * @return Error code
+ * @note Falls back to region memory when the pools are exhausted, as
+ *       dsrtos_task_create_extended() does
+ */
+dsrtos_error_t dsrtos_task_create(dsrtos_tcb_t **tcb, const dsrtos_task_params_t *params)
+{
+    dsrtos_task_create_extended_t ext;
+    dsrtos_error_t err;
+    
+    if ((tcb == NULL) || (params == NULL)) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+    
+    err = validate_task_parameters(params);
+    if (err != DSRTOS_SUCCESS) {
+        return err;
+    }
+    
+    (void)memset(&ext, 0, sizeof(ext));
+    ext.base = *params;
+    ext.base.param = params->parameter;
+    ext.base.stack_buffer = NULL;
+    ext.exit_handler = params->exit_handler;
+    ext.use_pool = true;
+    
+    *tcb = dsrtos_task_create_extended(&ext);
+    
+    return (*tcb != NULL) ? DSRTOS_SUCCESS : DSRTOS_ERROR_NO_RESOURCES;
+}
+
 /**
  * @brief Create task with extended options
  * @param params Extended task parameters
@@ -147,6 +295,7 @@ dsrtos_tcb_t* dsrtos_task_create_extended(const dsrtos_task_create_extended_t *p
 {
     dsrtos_tcb_t *tcb = NULL;
     void *stack = NULL;
+    dsrtos_arena_t *arena = NULL;
     dsrtos_error_t err;
     bool from_pool = false;
     
@@ -156,6 +305,9 @@ dsrtos_tcb_t* dsrtos_task_create_extended(const dsrtos_task_create_extended_t *p
         return NULL;
     }
     
+    /* Blocks of tasks that have exited since the last creation are free */
+    (void)dsrtos_task_reap();
+    
     /* Convert to standard parameters */
     dsrtos_task_params_t std_params;
     (void)memset(&std_params, 0, sizeof(std_params));
@@ -179,56 +331,73 @@ dsrtos_tcb_t* dsrtos_task_create_extended(const dsrtos_task_create_extended_t *p
         return NULL;
     }
     
+    /* Carve the task arena first so a quota the heap cannot meet fails early */
+    if (params->arena_quota > 0U) {
+        if (dsrtos_arena_create(std_params.name, params->arena_quota, &arena) != DSRTOS_SUCCESS) {
+            g_creation_stats.create_failures++;
+            return NULL;
+        }
+    }
+    
     /* Try to allocate from pool first if requested */
     if (params->use_pool) {
-        tcb = allocate_tcb_from_pool();
-        if (tcb != NULL) {
-            stack = allocate_stack_from_pool(std_params.stack_size);
-            if (stack != NULL) {
+        stack = allocate_stack_from_pool(std_params.stack_size);
+        if (stack != NULL) {
+            tcb = allocate_tcb_from_pool();
+            if (tcb != NULL) {
                 from_pool = true;
-                g_creation_stats.pool_allocations++;
             } else {
-                free_tcb_to_pool(tcb);
-                tcb = NULL;
+                free_stack_to_pool(stack);
+                stack = NULL;
             }
         }
     }
     
-    /* Fall back to dynamic allocation */
+    /* Fall back to dynamic allocation, placed by object class */
     if (tcb == NULL) {
-        tcb = (dsrtos_tcb_t *)dsrtos_malloc(sizeof(dsrtos_tcb_t));
+        tcb = (dsrtos_tcb_t *)allocate_task_memory(DSRTOS_MEM_CLASS_TCB, (uint32_t)sizeof(dsrtos_tcb_t));
         if (tcb == NULL) {
+            if (arena != NULL) {
+                (void)dsrtos_arena_destroy(arena);
+            }
             g_creation_stats.create_failures++;
             return NULL;
         }
         
-        stack = dsrtos_malloc(std_params.stack_size);
+        stack = allocate_task_memory(DSRTOS_MEM_CLASS_STACK, std_params.stack_size);
         if (stack == NULL) {
-            dsrtos_free(tcb);
+            (void)dsrtos_region_free(tcb);
+            if (arena != NULL) {
+                (void)dsrtos_arena_destroy(arena);
+            }
             g_creation_stats.create_failures++;
             return NULL;
         }
-        
-        g_creation_stats.dynamic_allocations++;
     }
     
     /* Setup standard parameters with allocated stack */
     std_params.stack_buffer = stack;
     
-    /* Initialize TCB */
+    /* Initialize TCB, handle and ID included */
     err = dsrtos_task_create_static(tcb, &std_params);
     if (err != DSRTOS_SUCCESS) {
         if (from_pool) {
             free_stack_to_pool(stack);
             free_tcb_to_pool(tcb);
         } else {
-            dsrtos_free(stack);
-            dsrtos_free(tcb);
+            (void)dsrtos_region_free(stack);
+            (void)dsrtos_region_free(tcb);
+        }
+        if (arena != NULL) {
+            (void)dsrtos_arena_destroy(arena);
         }
         g_creation_stats.create_failures++;
         return NULL;
     }
     
+    tcb->arena = arena;
+    tcb->flags |= TASK_FLAG_ALLOCATED;
+    
     /* Apply extended parameters */
     if (params->exit_handler != NULL) {
         tcb->exit_handler = (dsrtos_task_exit_handler_t)params->exit_handler;
@@ -277,7 +446,7 @@ dsrtos_tcb_t* dsrtos_task_clone(const dsrtos_tcb_t *source_task, const char *new
     params.wcet = source_task->timing.wcet;
     params.cpu_affinity = source_task->cpu_affinity;
     
-    /* Create new task */
+    /* Create new task, handle and ID included */
     dsrtos_error_t err = dsrtos_task_create(&new_task, &params);
     if (err != DSRTOS_SUCCESS) {
         return NULL;
@@ -293,9 +462,6 @@ dsrtos_tcb_t* dsrtos_task_clone(const dsrtos_tcb_t *source_task, const char *new
  */
 dsrtos_error_t dsrtos_task_restart(dsrtos_tcb_t *task)
 {
-    uint32_t restart_index = 0U;
-    bool found = false;
-    
     /* Validate task */
     if ((task == NULL) || 
         (dsrtos_task_validate_tcb(task) != DSRTOS_SUCCESS)) {
@@ -307,29 +473,13 @@ dsrtos_error_t dsrtos_task_restart(dsrtos_tcb_t *task)
         return DSRTOS_ERROR_NOT_PERMITTED;
     }
     
-    /* Find restart tracking entry */
-    for (uint32_t i = 0U; i < DSRTOS_MAX_TASKS; i++) {
-        if (g_restart_tracking[i].task == task) {
-            restart_index = i;
-            found = true;
-            break;
-        } else if (!found && (g_restart_tracking[i].task == NULL)) {
-            restart_index = i;
-        }
+    /* Check restart count limit: tracked in the TCB, so it starts from zero
+     * with every new task and needs no table lookup */
+    if (task->restart_count >= MAX_RESTART_COUNT) {
+        return DSRTOS_ERROR_LIMIT_EXCEEDED;
     }
-    
-    /* Check restart count limit */
-    if (found) {
-        if (g_restart_tracking[restart_index].restart_count >= MAX_RESTART_COUNT) {
-            return DSRTOS_ERROR_LIMIT_EXCEEDED;
-        }
-        g_restart_tracking[restart_index].restart_count++;
-    } else {
-        g_restart_tracking[restart_index].task = task;
-        g_restart_tracking[restart_index].restart_count = 1U;
-    }
-    
-    g_restart_tracking[restart_index].last_restart_time = dsrtos_get_system_time();
+    task->restart_count++;
+    task->last_restart_time = dsrtos_get_system_time();
     
     /* Reset task state */
     dsrtos_critical_enter();
@@ -341,7 +491,7 @@ dsrtos_error_t dsrtos_task_restart(dsrtos_tcb_t *task)
     task->timing.total_runtime = 0U;
     task->timing.last_runtime = 0U;
     task->timing.activation_time = 0U;
-    task->timing.time_slice_remaining = DSRTOS_DEFAULT_TIME_SLICE;
+    task->time_slice_remaining = DSRTOS_DEFAULT_TIME_SLICE;
     
     /* Reset resources */
     task->resources.resource_mask = 0U;
@@ -390,36 +540,227 @@ dsrtos_error_t dsrtos_task_get_creation_stats(task_creation_stats_t *stats)
     return DSRTOS_SUCCESS;
 }
 
+/**
+ * @brief Return a task's TCB, stack and arena to where they came from
+ * @param task Deleted task, not the running one
+ * @return Error code
+ * @note A TCB and stack the caller gave dsrtos_task_create_static() stay
+ *       with the caller; only the handle, budget and arena are dropped
+ */
+dsrtos_error_t dsrtos_task_release(dsrtos_tcb_t *task)
+{
+    void *stack;
+    
+    if ((task == NULL) || (task == dsrtos_task_get_current())) {
+        g_creation_stats.delete_failures++;
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+    
+    /* Retire the handle first: lookups stop finding the task before its
+     * memory is reused */
+    dsrtos_critical_enter();
+    if (dsrtos_handle_lookup(&g_task_handles, task->handle) == task) {
+        (void)dsrtos_handle_free(&g_task_handles, task->handle);
+    }
+    task->handle = DSRTOS_HANDLE_INVALID;
+    dsrtos_critical_exit();
+    
+    /* A budget server must not keep charging a TCB the pool hands out again */
+    if (task->budget != NULL) {
+        (void)dsrtos_budget_detach(task);
+    }
+    
+    if (task->arena != NULL) {
+        (void)dsrtos_arena_destroy((dsrtos_arena_t *)task->arena);
+        task->arena = NULL;
+    }
+    
+    if ((task->flags & TASK_FLAG_ALLOCATED) == 0U) {
+        return DSRTOS_SUCCESS;
+    }
+    
+    stack = task->stack_base;
+    task->stack_base = NULL;
+    task->flags &= ~TASK_FLAG_ALLOCATED;
+    if (dsrtos_pool_owns(&g_task_pool, task)) {
+        free_stack_to_pool(stack);
+        free_tcb_to_pool(task);
+    } else {
+        (void)dsrtos_region_free(stack);
+        (void)dsrtos_region_free(task);
+    }
+    
+    g_creation_stats.total_deleted++;
+    
+    return DSRTOS_SUCCESS;
+}
+
+/**
+ * @brief End the running task and queue it for release
+ * @param task Running task
+ * @return Error code; does not return when the scheduler is running
+ * @note A task cannot free the stack it is running on, so its TCB, stack
+ *       and handle wait on the zombie list for dsrtos_task_reap(). Its
+ *       exit handler, budget and arena are dealt with here.
+ */
+dsrtos_error_t dsrtos_task_retire(dsrtos_tcb_t *task)
+{
+    if (task == NULL) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+    
+    /* Call custom exit handler if set */
+    if (task->exit_handler != NULL) {
+        ((dsrtos_task_exit_handler_t)task->exit_handler)(task);
+    }
+    
+    if (task->budget != NULL) {
+        (void)dsrtos_budget_detach(task);
+    }
+    
+    /* Everything the task allocated from its arena goes back in one free */
+    if (task->arena != NULL) {
+        (void)dsrtos_arena_destroy((dsrtos_arena_t *)task->arena);
+        task->arena = NULL;
+    }
+    
+    /* Queued before the delete: deleting the running task switches away */
+    dsrtos_critical_enter();
+    task->next = g_zombie_head;
+    g_zombie_head = task;
+    dsrtos_critical_exit();
+    
+    return dsrtos_task_delete(task);
+}
+
+/**
+ * @brief Release every task that has exited since the last call
+ * @return Number of tasks released
+ * @note Call from the idle task or a housekeeping work item;
+ *       dsrtos_task_create_extended() also reaps before allocating. A
+ *       task still running on its stack is left for the next call.
+ */
+uint32_t dsrtos_task_reap(void)
+{
+    dsrtos_tcb_t *list;
+    dsrtos_tcb_t *task;
+    dsrtos_tcb_t *current = dsrtos_task_get_current();
+    uint32_t released = 0U;
+    
+    dsrtos_critical_enter();
+    list = g_zombie_head;
+    g_zombie_head = NULL;
+    dsrtos_critical_exit();
+    
+    while (list != NULL) {
+        task = list;
+        list = task->next;
+        task->next = NULL;
+        
+        if (task == current) {
+            dsrtos_critical_enter();
+            task->next = g_zombie_head;
+            g_zombie_head = task;
+            dsrtos_critical_exit();
+        } else if (dsrtos_task_release(task) == DSRTOS_SUCCESS) {
+            released++;
+        } else {
+            /* Counted as a delete failure by dsrtos_task_release() */
+        }
+    }
+    
+    return released;
+}
+
+/**
+ * @brief Resolve a task handle
+ * @param handle Handle from the task's creation
+ * @return Task, or NULL once it has been released
+ * @note O(1): one handle slot load, the TCB is not read
+ */
+dsrtos_tcb_t* dsrtos_task_from_handle(dsrtos_handle_t handle)
+{
+    return (dsrtos_tcb_t *)dsrtos_handle_lookup(&g_task_handles, handle);
+}
+
+/**
+ * @brief Find a live task by ID
+ * @param task_id Task ID (handle slot index)
+ * @return Task, or NULL if no task holds the ID
+ * @note O(1). IDs are reused; callers holding a task across a release
+ *       keep its handle instead.
+ */
+dsrtos_tcb_t* dsrtos_task_get_by_id(uint32_t task_id)
+{
+    return (dsrtos_tcb_t *)dsrtos_handle_lookup_index(&g_task_handles, task_id);
+}
+
+/**
+ * @brief Get task handle table statistics
+ * @param stats Buffer to store statistics
+ * @return Error code
+ */
+dsrtos_error_t dsrtos_task_handle_get_stats(dsrtos_handle_stats_t *stats)
+{
+    return dsrtos_handle_get_stats(&g_task_handles, stats);
+}
+
+/**
+ * @brief Get task pool statistics
+ * @param stats Buffer to store statistics
+ * @return Error code
+ */
+dsrtos_error_t dsrtos_task_pool_get_stats(task_creation_stats_t *stats)
+{
+    return dsrtos_task_get_creation_stats(stats);
+}
+
 /*==============================================================================
  * STATIC FUNCTIONS
  *============================================================================*/
 
+/**
+ * @brief Give a new task its handle and ID
+ * @param tcb Task being initialised by dsrtos_task_create_static()
+ * @return Error code
+ * @note The ID is the handle's slot index: dense, below DSRTOS_MAX_TASKS,
+ *       and resolvable in O(1)
+ */
+static dsrtos_error_t assign_task_handle(dsrtos_tcb_t *tcb)
+{
+    dsrtos_handle_t handle;
+    
+    dsrtos_critical_enter();
+    handle = dsrtos_handle_alloc(&g_task_handles, tcb);
+    dsrtos_critical_exit();
+    
+    if (handle == DSRTOS_HANDLE_INVALID) {
+        return DSRTOS_ERROR_NO_RESOURCES;
+    }
+    
+    tcb->handle = handle;
+    tcb->task_id = DSRTOS_HANDLE_INDEX(handle);
+    
+    return DSRTOS_SUCCESS;
+}
+
 /**
  * @brief Allocate TCB from static pool
  * @return TCB pointer or NULL
+ * @note O(1): pops the pool's free list
  */
 static dsrtos_tcb_t* allocate_tcb_from_pool(void)
 {
-    for (uint32_t i = 0U; i < TASK_POOL_SIZE; i++) {
-        if (!g_task_pool[i].allocated) {
-            g_task_pool[i].allocated = true;
-            g_task_pool[i].allocation_time = dsrtos_get_system_time();
-            
-            /* Update peak usage */
-            uint32_t used_count = 0U;
-            for (uint32_t j = 0U; j < TASK_POOL_SIZE; j++) {
-                if (g_task_pool[j].allocated) {
-                    used_count++;
-                }
-            }
-            if (used_count > g_creation_stats.peak_pool_usage) {
-                g_creation_stats.peak_pool_usage = used_count;
-            }
-            
-            return &g_task_pool[i].tcb;
-        }
+    dsrtos_tcb_t *tcb;
+    
+    dsrtos_critical_enter();
+    tcb = (dsrtos_tcb_t *)dsrtos_pool_alloc(&g_task_pool);
+    if ((tcb != NULL) && (g_task_pool.stats.high_water > g_creation_stats.peak_pool_usage)) {
+        g_creation_stats.peak_pool_usage = g_task_pool.stats.high_water;
     }
-    return NULL;
+    dsrtos_critical_exit();
+    
+    return tcb;
 }
 
 /**
@@ -428,34 +769,31 @@ static dsrtos_tcb_t* allocate_tcb_from_pool(void)
  */
 static void free_tcb_to_pool(dsrtos_tcb_t *tcb)
 {
-    for (uint32_t i = 0U; i < TASK_POOL_SIZE; i++) {
-        if (&g_task_pool[i].tcb == tcb) {
-            g_task_pool[i].allocated = false;
-            g_task_pool[i].allocation_time = 0U;
-            break;
-        }
-    }
+    dsrtos_critical_enter();
+    (void)dsrtos_pool_free(&g_task_pool, tcb);
+    dsrtos_critical_exit();
 }
 
 /**
  * @brief Allocate stack from static pool
  * @param size Required stack size
  * @return Stack pointer or NULL
+ * @note O(classes): the smallest class that fits, or the next larger one
+ *       when it is exhausted
  */
 static void* allocate_stack_from_pool(uint32_t size)
 {
-    if (size > DSRTOS_DEFAULT_STACK_SIZE) {
-        return NULL;
-    }
+    void *stack = NULL;
     
-    for (uint32_t i = 0U; i < STACK_POOL_SIZE; i++) {
-        if (!g_stack_pool[i].allocated) {
-            g_stack_pool[i].allocated = true;
-            g_stack_pool[i].size = size;
-            return g_stack_pool[i].stack;
+    dsrtos_critical_enter();
+    for (uint32_t i = 0U; (i < STACK_CLASS_COUNT) && (stack == NULL); i++) {
+        if (size <= g_stack_classes[i].stack_size) {
+            stack = dsrtos_pool_alloc(&g_stack_classes[i].pool);
         }
     }
-    return NULL;
+    dsrtos_critical_exit();
+    
+    return stack;
 }
 
 /**
@@ -464,14 +802,35 @@ static void* allocate_stack_from_pool(uint32_t size)
  */
 static void free_stack_to_pool(void *stack)
 {
-    for (uint32_t i = 0U; i < STACK_POOL_SIZE; i++) {
-        if (g_stack_pool[i].stack == stack) {
-            g_stack_pool[i].allocated = false;
-            g_stack_pool[i].size = 0U;
-            g_stack_pool[i].owner = NULL;
+    dsrtos_critical_enter();
+    for (uint32_t i = 0U; i < STACK_CLASS_COUNT; i++) {
+        if (dsrtos_pool_owns(&g_stack_classes[i].pool, stack)) {
+            (void)dsrtos_pool_free(&g_stack_classes[i].pool, stack);
             break;
         }
     }
+    dsrtos_critical_exit();
+}
+
+/**
+ * @brief Allocate a TCB or stack outside the pools
+ * @param mem_class DSRTOS_MEM_CLASS_TCB or DSRTOS_MEM_CLASS_STACK
+ * @param size Bytes required
+ * @return Memory or NULL
+ * @note Before a region map is installed this is the kernel heap, which
+ *       dsrtos_region_free() also returns memory to
+ */
+static void* allocate_task_memory(dsrtos_mem_class_t mem_class, uint32_t size)
+{
+    void *block = NULL;
+    
+    if (dsrtos_region_alloc(mem_class, size, &block) == DSRTOS_ERROR_NOT_INITIALIZED) {
+        if (dsrtos_memory_allocate(size, &block) != DSRTOS_SUCCESS) {
+            block = NULL;
+        }
+    }
+    
+    return block;
 }
 
 /**
@@ -537,8 +896,8 @@ static dsrtos_error_t setup_task_context(dsrtos_tcb_t *tcb, const dsrtos_task_pa
     stack_ptr[0] = DSRTOS_STACK_CANARY_VALUE;
     stack_ptr[(tcb->stack_size / sizeof(uint32_t)) - 1U] = DSRTOS_STACK_CANARY_VALUE;
     
-    /* Initialize stack for context switch */
-    stack_top = (uint32_t *)((uint8_t *)tcb->stack_base + tcb->stack_size);
+    /* Initial frame goes below the top canary */
+    stack_top = &stack_ptr[(tcb->stack_size / sizeof(uint32_t)) - 1U];
     
     /* Port-specific stack initialization */
     tcb->stack_pointer = dsrtos_port_init_stack(stack_top,
@@ -560,13 +919,8 @@ static void task_exit_handler(void)
     dsrtos_tcb_t *current = dsrtos_task_get_current();
     
     if (current != NULL) {
-        /* Call custom exit handler if set */
-        if (current->exit_handler != NULL) {
-            ((dsrtos_task_exit_handler_t)current->exit_handler)(current);
-        }
-        
-        /* Delete self */
-        (void)dsrtos_task_delete(current);
+        /* Delete self; the reaper gives back the TCB and stack */
+        (void)dsrtos_task_retire(current);
     }
     
     /* Should never reach here */
@@ -618,3 +972,14 @@ static void update_creation_statistics(bool success, bool from_pool)
         g_creation_stats.create_failures++;
     }
 }
+
+/**
+ * @brief Heap profile owner: the running task, or none before the scheduler
+ * @return Task ID
+ */
+static uint32_t heap_profile_owner(void)
+{
+    const dsrtos_tcb_t *current = dsrtos_task_get_current();
+    
+    return (current != NULL) ? current->task_id : DSRTOS_MEMORY_OWNER_NONE;
+}
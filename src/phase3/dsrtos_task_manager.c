@@ -0,0 +1,128 @@
+/*
+ * @file dsrtos_task_manager.c
+ * @brief DSRTOS Task Manager - target task entry points
+ * @date 2024-12-30
+ *
+ * The task calls the creation path (dsrtos_task_creation.c), the state
+ * machine and the budget servers make on the target: current task, TCB
+ * validation, ready queue insertion, suspend, delete and task exit. The
+ * host port in tests/host provides the same functions for native builds.
+ *
+ * COMPLIANCE:
+ * - MISRA-C:2012 compliant
+ * - DO-178C DAL-B certifiable
+ * - IEC 62304 Class B compliant
+ * - ISO 26262 ASIL D compliant
+ */
+
+#include "dsrtos_task_manager.h"
+#include "dsrtos_task_state.h"
+#include "dsrtos_task_queue.h"
+#include "dsrtos_critical.h"
+#include "dsrtos_port.h"
+
+/*==============================================================================
+ * EXTERNAL VARIABLES
+ *============================================================================*/
+
+/* Running task, owned by the context switch (phase4/src/dsrtos_context_switch.c) */
+extern volatile dsrtos_tcb_t* g_current_task;
+
+/*==============================================================================
+ * PUBLIC FUNCTIONS
+ *============================================================================*/
+
+/**
+ * @brief Get the running task
+ * @return Task, or NULL before the scheduler starts
+ */
+dsrtos_tcb_t* dsrtos_task_get_current(void)
+{
+    return (dsrtos_tcb_t *)(volatile void *)g_current_task;
+}
+
+/**
+ * @brief Validate a TCB
+ * @param tcb Task control block
+ * @return DSRTOS_SUCCESS if tcb is a created task
+ */
+dsrtos_error_t dsrtos_task_validate_tcb(const dsrtos_tcb_t *tcb)
+{
+    if ((tcb == NULL) || (tcb->magic_number != DSRTOS_TCB_MAGIC)) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+
+    return DSRTOS_SUCCESS;
+}
+
+/**
+ * @brief Queue a new task as ready
+ * @param tcb Task control block
+ * @return Error code
+ * @note Creation path only; later state changes go through
+ *       dsrtos_state_transition()
+ */
+dsrtos_error_t dsrtos_task_ready_insert(dsrtos_tcb_t *tcb)
+{
+    dsrtos_error_t err;
+
+    if (dsrtos_task_validate_tcb(tcb) != DSRTOS_SUCCESS) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+
+    dsrtos_critical_enter();
+    tcb->state = DSRTOS_TASK_STATE_READY;
+    err = dsrtos_queue_ready_insert(tcb);
+    dsrtos_critical_exit();
+
+    return err;
+}
+
+/**
+ * @brief Suspend a task
+ * @param tcb Task control block
+ * @return Error code
+ */
+dsrtos_error_t dsrtos_task_suspend(dsrtos_tcb_t *tcb)
+{
+    dsrtos_error_t err;
+
+    err = dsrtos_state_transition(tcb, DSRTOS_TASK_STATE_SUSPENDED);
+    if ((err == DSRTOS_SUCCESS) && (tcb == dsrtos_task_get_current())) {
+        dsrtos_port_yield();
+    }
+
+    return err;
+}
+
+/**
+ * @brief Terminate a task
+ * @param tcb Task control block
+ * @return Error code
+ * @note Takes the task off its queue; dsrtos_task_release() gives its
+ *       memory back. A task deleting itself stops at its next switch.
+ */
+dsrtos_error_t dsrtos_task_delete(dsrtos_tcb_t *tcb)
+{
+    dsrtos_error_t err;
+
+    err = dsrtos_state_transition(tcb, DSRTOS_TASK_STATE_TERMINATED);
+    if ((err == DSRTOS_SUCCESS) && (tcb == dsrtos_task_get_current())) {
+        dsrtos_port_yield();
+    }
+
+    return err;
+}
+
+/**
+ * @brief Default return address of a task entry point
+ * @note Tasks from the creation path return to its exit handler instead
+ */
+void dsrtos_task_exit(void)
+{
+    (void)dsrtos_task_delete(dsrtos_task_get_current());
+
+    for (;;) {
+        /* Switched out by the pending PendSV */
+    }
+}
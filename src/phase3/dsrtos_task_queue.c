@@ -4,7 +4,10 @@
  * @date 2024-12-30
  * 
  * Implements priority-based ready queues and blocked/suspended lists
- * with O(1) insertion and removal for safety-critical scheduling.
+ * with O(1) insertion and removal for safety-critical scheduling. Each
+ * task points at its own list node, so removal never searches a list,
+ * and timeouts are kept in a binary min-heap: O(log n) to add or cancel,
+ * O(1) to find the next one due.
  * 
  * COMPLIANCE:
  * - MISRA-C:2012 compliant
@@ -17,6 +20,7 @@
 #include "dsrtos_task_manager.h"
 #include "dsrtos_kernel.h"
 #include "dsrtos_critical.h"
+#include "dsrtos_pool.h"
 #include <string.h>
 
 /*==============================================================================
@@ -25,7 +29,9 @@
 
 #define QUEUE_MAGIC         (0x51554555U)  /* 'QUEU' */
 #define MAX_QUEUE_DEPTH     (256U)
-#define BITMAP_WORDS        ((DSRTOS_MAX_PRIORITY + 31U) / 32U)
+#define BITMAP_WORDS        ((DSRTOS_MAX_PRIORITY + 32U) / 32U)  /* Levels 0..MAX */
+#define LIST_BLOCKED        (0xFFFFFFFFU)  /* queue_node_t.list of a blocked node */
+#define LIST_SUSPENDED      (0xFFFFFFFEU)  /* queue_node_t.list of a suspended node */
 
 /* Missing error code */
 #ifndef DSRTOS_ERROR_NO_RESOURCE
@@ -41,13 +47,20 @@
  * TYPE DEFINITIONS
  *============================================================================*/
 
-/* Queue node for double-linked list */
+/* Queue node for double-linked list, reached from its task via tcb->list_node */
 typedef struct queue_node {
     dsrtos_tcb_t *tcb;
     struct queue_node *next;
     struct queue_node *prev;
+    uint32_t list;              /* Ready priority it is queued at, or LIST_BLOCKED/SUSPENDED */
 } queue_node_t;
 
+/* Pending timeout; tcb->delay_slot is its heap index + 1 */
+typedef struct {
+    uint64_t wake_time;
+    dsrtos_tcb_t *tcb;
+} delayed_entry_t;
+
 /* Priority queue structure */
 typedef struct {
     queue_node_t *head;
@@ -74,8 +87,7 @@ typedef struct {
     queue_node_t *suspended_tail;
     uint32_t suspended_count;
     
-    /* Delayed queue (sorted by wake time) */
-    queue_node_t *delayed_head;
+    /* Delayed queue: min-heap on wake time in g_delayed_heap */
     uint32_t delayed_count;
     
     /* Statistics */
@@ -100,7 +112,10 @@ static task_queue_manager_t g_queue_manager = {
 
 /* Pre-allocated queue nodes for static allocation */
 static queue_node_t g_queue_nodes[DSRTOS_MAX_TASKS];
-static uint32_t g_node_bitmap[(DSRTOS_MAX_TASKS + 31U) / 32U];
+static dsrtos_pool_t g_node_pool;
+
+/* Timeouts, earliest first at index 0 */
+static delayed_entry_t g_delayed_heap[DSRTOS_MAX_TASKS];
 
 /*==============================================================================
  * STATIC FUNCTION PROTOTYPES
@@ -108,9 +123,15 @@ static uint32_t g_node_bitmap[(DSRTOS_MAX_TASKS + 31U) / 32U];
 
 static queue_node_t* allocate_node(void);
 static void free_node(queue_node_t *node);
-static void insert_ready_queue(dsrtos_tcb_t *tcb, uint8_t priority);
-static void remove_ready_queue(dsrtos_tcb_t *tcb, uint8_t priority);
+static queue_node_t* find_node(const dsrtos_tcb_t *tcb);
+static bool insert_ready_queue(dsrtos_tcb_t *tcb, uint8_t priority);
+static void remove_ready_queue(queue_node_t *node);
+static void remove_blocked_queue(queue_node_t *node);
 static void insert_delayed_sorted(dsrtos_tcb_t *tcb, uint64_t wake_time);
+static void remove_delayed(dsrtos_tcb_t *tcb);
+static void delayed_place(uint32_t index, delayed_entry_t entry);
+static void delayed_sift_up(uint32_t index, delayed_entry_t entry);
+static void delayed_sift_down(uint32_t index, delayed_entry_t entry);
 static uint8_t find_highest_ready_priority(void);
 static void update_ready_bitmap(uint8_t priority, bool set);
 
@@ -139,12 +160,14 @@ dsrtos_error_t dsrtos_queue_init(void)
     
     /* Clear bitmaps */
     (void)memset(g_queue_manager.ready_bitmap, 0, sizeof(g_queue_manager.ready_bitmap));
-    (void)memset(g_node_bitmap, 0, sizeof(g_node_bitmap));
     
     /* Initialize queue nodes */
     (void)memset(g_queue_nodes, 0, sizeof(g_queue_nodes));
+    (void)memset(g_delayed_heap, 0, sizeof(g_delayed_heap));
     
-    return DSRTOS_SUCCESS;
+    return dsrtos_pool_init(&g_node_pool, "task_queue_nodes", g_queue_nodes,
+                            sizeof(queue_node_t), DSRTOS_MAX_TASKS,
+                            DSRTOS_POOL_FLAG_NONE);
 }
 
 /**
@@ -173,8 +196,17 @@ dsrtos_error_t dsrtos_queue_ready_insert(dsrtos_tcb_t *tcb)
     
     dsrtos_critical_enter();
     
+    /* One list at a time: the node back-pointer is the membership */
+    if (find_node(tcb) != NULL) {
+        dsrtos_critical_exit();
+        return DSRTOS_ERROR_ALREADY_EXISTS;
+    }
+    
     /* Insert into priority queue */
-    insert_ready_queue(tcb, priority);
+    if (!insert_ready_queue(tcb, priority)) {
+        dsrtos_critical_exit();
+        return DSRTOS_ERROR_NO_RESOURCE;
+    }
     
     /* Update bitmap */
     update_ready_bitmap(priority, true);
@@ -198,6 +230,7 @@ dsrtos_error_t dsrtos_queue_ready_insert(dsrtos_tcb_t *tcb)
  */
 dsrtos_error_t dsrtos_queue_ready_remove(dsrtos_tcb_t *tcb)
 {
+    queue_node_t *node;
     uint8_t priority;
     
     /* Validate parameters */
@@ -205,12 +238,20 @@ dsrtos_error_t dsrtos_queue_ready_remove(dsrtos_tcb_t *tcb)
         return DSRTOS_ERROR_INVALID_PARAM;
     }
     
-    priority = tcb->effective_priority;
-    
     dsrtos_critical_enter();
     
+    /* Not queued as ready: nothing to do */
+    node = find_node(tcb);
+    if ((node == NULL) || (node->list > DSRTOS_MAX_PRIORITY)) {
+        dsrtos_critical_exit();
+        return DSRTOS_SUCCESS;
+    }
+    
+    /* The level it was queued at, even if its priority changed since */
+    priority = (uint8_t)node->list;
+    
     /* Remove from priority queue */
-    remove_ready_queue(tcb, priority);
+    remove_ready_queue(node);
     
     /* Update bitmap if queue is empty */
     if (g_queue_manager.ready_queues[priority].count == 0U) {
@@ -271,6 +312,12 @@ dsrtos_error_t dsrtos_queue_blocked_insert(dsrtos_tcb_t *tcb, uint32_t timeout)
     
     dsrtos_critical_enter();
     
+    /* One list at a time: the node back-pointer is the membership */
+    if (find_node(tcb) != NULL) {
+        dsrtos_critical_exit();
+        return DSRTOS_ERROR_ALREADY_EXISTS;
+    }
+    
     /* Allocate queue node */
     node = allocate_node();
     if (node == NULL) {
@@ -279,8 +326,10 @@ dsrtos_error_t dsrtos_queue_blocked_insert(dsrtos_tcb_t *tcb, uint32_t timeout)
     }
     
     node->tcb = tcb;
+    node->list = LIST_BLOCKED;
     node->next = NULL;
     node->prev = g_queue_manager.blocked_tail;
+    tcb->list_node = node;
     
     /* Add to blocked queue */
     if (g_queue_manager.blocked_tail != NULL) {
@@ -323,34 +372,101 @@ dsrtos_error_t dsrtos_queue_blocked_remove(dsrtos_tcb_t *tcb)
     
     dsrtos_critical_enter();
     
-    /* Find and remove from blocked queue */
-    node = g_queue_manager.blocked_head;
-    while (node != NULL) {
-        if (node->tcb == tcb) {
-            /* Remove from list */
-            if (node->prev != NULL) {
-                node->prev->next = node->next;
-            } else {
-                g_queue_manager.blocked_head = node->next;
-            }
-            
-            if (node->next != NULL) {
-                node->next->prev = node->prev;
-            } else {
-                g_queue_manager.blocked_tail = node->prev;
-            }
-            
-            /* Free node */
-            free_node(node);
-            
-            /* Update count */
-            if (g_queue_manager.blocked_count > 0U) {
-                g_queue_manager.blocked_count--;
-            }
-            
-            break;
+    /* Remove from blocked queue, and cancel its timeout */
+    node = find_node(tcb);
+    if ((node != NULL) && (node->list == LIST_BLOCKED)) {
+        remove_blocked_queue(node);
+    }
+    remove_delayed(tcb);
+    
+    dsrtos_critical_exit();
+    
+    return DSRTOS_SUCCESS;
+}
+
+/**
+ * @brief Insert task into suspended queue
+ * @param tcb Task control block
+ * @return Error code
+ */
+dsrtos_error_t dsrtos_queue_suspended_insert(dsrtos_tcb_t *tcb)
+{
+    queue_node_t *node;
+    
+    /* Validate parameters */
+    if (tcb == NULL) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+    
+    dsrtos_critical_enter();
+    
+    /* One list at a time: the node back-pointer is the membership */
+    if (find_node(tcb) != NULL) {
+        dsrtos_critical_exit();
+        return DSRTOS_ERROR_ALREADY_EXISTS;
+    }
+    
+    node = allocate_node();
+    if (node == NULL) {
+        dsrtos_critical_exit();
+        return DSRTOS_ERROR_NO_RESOURCE;
+    }
+    
+    node->tcb = tcb;
+    node->list = LIST_SUSPENDED;
+    node->next = NULL;
+    node->prev = g_queue_manager.suspended_tail;
+    tcb->list_node = node;
+    
+    if (g_queue_manager.suspended_tail != NULL) {
+        g_queue_manager.suspended_tail->next = node;
+    } else {
+        g_queue_manager.suspended_head = node;
+    }
+    g_queue_manager.suspended_tail = node;
+    g_queue_manager.suspended_count++;
+    
+    dsrtos_critical_exit();
+    
+    return DSRTOS_SUCCESS;
+}
+
+/**
+ * @brief Remove task from suspended queue
+ * @param tcb Task control block
+ * @return Error code
+ */
+dsrtos_error_t dsrtos_queue_suspended_remove(dsrtos_tcb_t *tcb)
+{
+    queue_node_t *node;
+    
+    /* Validate parameters */
+    if (tcb == NULL) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+    
+    dsrtos_critical_enter();
+    
+    node = find_node(tcb);
+    if ((node != NULL) && (node->list == LIST_SUSPENDED)) {
+        if (node->prev != NULL) {
+            node->prev->next = node->next;
+        } else {
+            g_queue_manager.suspended_head = node->next;
+        }
+        
+        if (node->next != NULL) {
+            node->next->prev = node->prev;
+        } else {
+            g_queue_manager.suspended_tail = node->prev;
         }
-        node = node->next;
+        
+        if (g_queue_manager.suspended_count > 0U) {
+            g_queue_manager.suspended_count--;
+        }
+        
+        tcb->list_node = NULL;
+        free_node(node);
     }
     
     dsrtos_critical_exit();
@@ -366,45 +482,27 @@ uint32_t dsrtos_queue_process_delayed(void)
 {
     uint32_t count = 0U;
     uint64_t current_time;
+    dsrtos_tcb_t *tcb;
     queue_node_t *node;
-    queue_node_t *next;
     
     current_time = dsrtos_get_system_time();
     
     dsrtos_critical_enter();
     
-    /* Check delayed queue for tasks to wake */
-    node = g_queue_manager.delayed_head;
-    while (node != NULL) {
-        next = node->next;
+    /* Wake every task whose timeout is due; the earliest is at the root */
+    while ((g_queue_manager.delayed_count > 0U) &&
+           (g_delayed_heap[0].wake_time <= current_time)) {
+        tcb = g_delayed_heap[0].tcb;
+        remove_delayed(tcb);
         
-        /* Check if task should wake (assuming wake_time stored in param) */
-        if ((uint64_t)(uintptr_t)node->tcb->task_param <= current_time) {
-            /* Remove from delayed queue */
-            if (node->prev != NULL) {
-                node->prev->next = node->next;
-            } else {
-                g_queue_manager.delayed_head = node->next;
-            }
-            
-            if (node->next != NULL) {
-                node->next->prev = node->prev;
-            }
-            
-            /* Make task ready */
-            dsrtos_queue_ready_insert(node->tcb);
-            
-            /* Free node */
-            free_node(node);
-            
-            g_queue_manager.delayed_count--;
-            count++;
-        } else {
-            /* List is sorted, so we can stop here */
-            break;
+        /* Timed out: off the blocked queue and onto the ready queue */
+        node = find_node(tcb);
+        if ((node != NULL) && (node->list == LIST_BLOCKED)) {
+            remove_blocked_queue(node);
         }
+        (void)dsrtos_queue_ready_insert(tcb);
         
-        node = next;
+        count++;
     }
     
     dsrtos_critical_exit();
@@ -439,6 +537,52 @@ dsrtos_error_t dsrtos_queue_get_stats(dsrtos_queue_stats_t *stats)
     return DSRTOS_SUCCESS;
 }
 
+/**
+ * @brief Copy a summary of the ready queues, in scheduling order
+ * @param entries Summary out
+ * @param max Entries available
+ * @return Entries written
+ * @note Bounded by max and DSRTOS_MAX_TASKS, so a corrupted list cannot
+ *       hold up a caller in a fault handler
+ */
+uint32_t dsrtos_queue_ready_snapshot(dsrtos_queue_ready_entry_t *entries, uint32_t max)
+{
+    uint32_t count = 0U;
+    uint32_t steps = 0U;
+
+    if ((entries == NULL) || (g_queue_manager.magic != QUEUE_MAGIC)) {
+        return 0U;
+    }
+
+    dsrtos_critical_enter();
+
+    for (uint32_t word = 0U; word < BITMAP_WORDS; word++) {
+        for (uint32_t bit = 32U; bit > 0U; bit--) {
+            uint32_t priority = (word * 32U) + (bit - 1U);
+            const queue_node_t *node;
+
+            if ((priority > DSRTOS_MAX_PRIORITY) ||
+                ((g_queue_manager.ready_bitmap[word] & (1UL << (bit - 1U))) == 0U)) {
+                continue;
+            }
+
+            node = g_queue_manager.ready_queues[priority].head;
+            while ((node != NULL) && (count < max) && (steps < DSRTOS_MAX_TASKS)) {
+                entries[count].task_id = (uint16_t)node->tcb->task_id;
+                entries[count].priority = (uint8_t)priority;
+                entries[count].state = (uint8_t)node->tcb->state;
+                count++;
+                steps++;
+                node = node->next;
+            }
+        }
+    }
+
+    dsrtos_critical_exit();
+
+    return count;
+}
+
 /*==============================================================================
  * STATIC FUNCTIONS
  *============================================================================*/
@@ -449,16 +593,7 @@ dsrtos_error_t dsrtos_queue_get_stats(dsrtos_queue_stats_t *stats)
  */
 static queue_node_t* allocate_node(void)
 {
-    for (uint32_t i = 0U; i < DSRTOS_MAX_TASKS; i++) {
-        uint32_t word = i / 32U;
-        uint32_t bit = i % 32U;
-        
-        if ((g_node_bitmap[word] & (1U << bit)) == 0U) {
-            g_node_bitmap[word] |= (1U << bit);
-            return &g_queue_nodes[i];
-        }
-    }
-    return NULL;
+    return (queue_node_t *)dsrtos_pool_alloc(&g_node_pool);
 }
 
 /**
@@ -467,25 +602,40 @@ static queue_node_t* allocate_node(void)
  */
 static void free_node(queue_node_t *node)
 {
-    if (node != NULL) {
-        uint32_t index = (uint32_t)(node - g_queue_nodes);
-        if (index < DSRTOS_MAX_TASKS) {
-            uint32_t word = index / 32U;
-            uint32_t bit = index % 32U;
-            g_node_bitmap[word] &= ~(1U << bit);
-            node->tcb = NULL;
-            node->next = NULL;
-            node->prev = NULL;
-        }
+    if (dsrtos_pool_owns(&g_node_pool, node)) {
+        node->tcb = NULL;
+        node->next = NULL;
+        node->prev = NULL;
+        (void)dsrtos_pool_free(&g_node_pool, node);
     }
 }
 
+/**
+ * @brief Find a task's list node
+ * @param tcb Task control block
+ * @return Node or NULL if the task is on no list
+ * @note O(1): follows tcb->list_node, checked against the pool and the
+ *       owner so a stale pointer is never trusted
+ */
+static queue_node_t* find_node(const dsrtos_tcb_t *tcb)
+{
+    queue_node_t *node = (queue_node_t *)tcb->list_node;
+    
+    if ((node == NULL) || !dsrtos_pool_owns(&g_node_pool, node) ||
+        (node->tcb != tcb)) {
+        return NULL;
+    }
+    
+    return node;
+}
+
 /**
  * @brief Insert task into ready queue at priority level
  * @param tcb Task control block
  * @param priority Priority level
+ * @return False if no node was free
  */
-static void insert_ready_queue(dsrtos_tcb_t *tcb, uint8_t priority)
+static bool insert_ready_queue(dsrtos_tcb_t *tcb, uint8_t priority)
 {
     priority_queue_t *queue = &g_queue_manager.ready_queues[priority];
     queue_node_t *node;
@@ -493,10 +643,11 @@ static void insert_ready_queue(dsrtos_tcb_t *tcb, uint8_t priority)
     /* Allocate node */
     node = allocate_node();
     if (node == NULL) {
-        return; /* Critical error - should not happen */
+        return false;
     }
     
     node->tcb = tcb;
+    node->list = priority;
     node->next = NULL;
     node->prev = queue->tail;
     
@@ -509,92 +660,184 @@ static void insert_ready_queue(dsrtos_tcb_t *tcb, uint8_t priority)
     queue->tail = node;
     
     queue->count++;
+    tcb->list_node = node;
+    
+    return true;
 }
 
 /**
- * @brief Remove task from ready queue at priority level
- * @param tcb Task control block
- * @param priority Priority level
+ * @brief Remove a node from the ready queue it is on
+ * @param node Ready node of the task
  */
-static void remove_ready_queue(dsrtos_tcb_t *tcb, uint8_t priority)
+static void remove_ready_queue(queue_node_t *node)
 {
-    priority_queue_t *queue = &g_queue_manager.ready_queues[priority];
-    queue_node_t *node = queue->head;
-    
-    while (node != NULL) {
-        if (node->tcb == tcb) {
-            /* Remove from list */
-            if (node->prev != NULL) {
-                node->prev->next = node->next;
-            } else {
-                queue->head = node->next;
-            }
-            
-            if (node->next != NULL) {
-                node->next->prev = node->prev;
-            } else {
-                queue->tail = node->prev;
-            }
-            
-            /* Free node */
-            free_node(node);
-            
-            if (queue->count > 0U) {
-                queue->count--;
-            }
-            
-            break;
-        }
-        node = node->next;
+    priority_queue_t *queue = &g_queue_manager.ready_queues[node->list];
+    
+    /* Remove from list */
+    if (node->prev != NULL) {
+        node->prev->next = node->next;
+    } else {
+        queue->head = node->next;
+    }
+    
+    if (node->next != NULL) {
+        node->next->prev = node->prev;
+    } else {
+        queue->tail = node->prev;
     }
+    
+    if (queue->count > 0U) {
+        queue->count--;
+    }
+    
+    /* Free node */
+    node->tcb->list_node = NULL;
+    free_node(node);
 }
 
 /**
- * @brief Insert task into delayed queue (sorted by wake time)
+ * @brief Remove a node from the blocked queue
+ * @param node Blocked node of the task
+ */
+static void remove_blocked_queue(queue_node_t *node)
+{
+    /* Remove from list */
+    if (node->prev != NULL) {
+        node->prev->next = node->next;
+    } else {
+        g_queue_manager.blocked_head = node->next;
+    }
+    
+    if (node->next != NULL) {
+        node->next->prev = node->prev;
+    } else {
+        g_queue_manager.blocked_tail = node->prev;
+    }
+    
+    /* Update count */
+    if (g_queue_manager.blocked_count > 0U) {
+        g_queue_manager.blocked_count--;
+    }
+    
+    /* Free node */
+    node->tcb->list_node = NULL;
+    free_node(node);
+}
+
+/**
+ * @brief Add a task's timeout to the delayed heap
  * @param tcb Task control block
  * @param wake_time Wake time
+ * @note O(log n). A task already waiting has its timeout replaced.
  */
 static void insert_delayed_sorted(dsrtos_tcb_t *tcb, uint64_t wake_time)
 {
-    queue_node_t *node;
-    queue_node_t *current;
-    queue_node_t *prev = NULL;
+    delayed_entry_t entry;
     
-    /* Allocate node */
-    node = allocate_node();
-    if (node == NULL) {
+    remove_delayed(tcb);
+    
+    if (g_queue_manager.delayed_count >= DSRTOS_MAX_TASKS) {
         return;
     }
     
-    node->tcb = tcb;
-    /* Store wake time in task param (simplified) */
-    tcb->task_param = (void *)(uintptr_t)wake_time;
+    entry.wake_time = wake_time;
+    entry.tcb = tcb;
     
-    /* Find insertion point (sorted by wake time) */
-    current = g_queue_manager.delayed_head;
-    while (current != NULL) {
-        if ((uint64_t)(uintptr_t)current->tcb->task_param > wake_time) {
-            break;
-        }
-        prev = current;
-        current = current->next;
+    g_queue_manager.delayed_count++;
+    delayed_sift_up(g_queue_manager.delayed_count - 1U, entry);
+}
+
+/**
+ * @brief Cancel a task's timeout, if it has one
+ * @param tcb Task control block
+ * @note O(log n): the task's slot is known, the last entry takes its place
+ */
+static void remove_delayed(dsrtos_tcb_t *tcb)
+{
+    uint32_t index;
+    delayed_entry_t last;
+    
+    if ((tcb->delay_slot == 0U) || (tcb->delay_slot > g_queue_manager.delayed_count) ||
+        (g_delayed_heap[tcb->delay_slot - 1U].tcb != tcb)) {
+        return;
     }
     
-    /* Insert node */
-    node->next = current;
-    node->prev = prev;
+    index = tcb->delay_slot - 1U;
+    tcb->delay_slot = 0U;
+    g_queue_manager.delayed_count--;
+    
+    if (index == g_queue_manager.delayed_count) {
+        return;
+    }
     
-    if (prev != NULL) {
-        prev->next = node;
+    /* Refill the hole with the last entry, then restore heap order */
+    last = g_delayed_heap[g_queue_manager.delayed_count];
+    if ((index > 0U) && (last.wake_time < g_delayed_heap[(index - 1U) / 2U].wake_time)) {
+        delayed_sift_up(index, last);
     } else {
-        g_queue_manager.delayed_head = node;
+        delayed_sift_down(index, last);
+    }
+}
+
+/**
+ * @brief Store a heap entry and record its slot in the task
+ * @param index Heap index
+ * @param entry Entry to store
+ */
+static void delayed_place(uint32_t index, delayed_entry_t entry)
+{
+    g_delayed_heap[index] = entry;
+    entry.tcb->delay_slot = index + 1U;
+}
+
+/**
+ * @brief Move an entry towards the root until its parent is not later
+ * @param index Hole to start from
+ * @param entry Entry to place
+ */
+static void delayed_sift_up(uint32_t index, delayed_entry_t entry)
+{
+    uint32_t parent;
+    
+    while (index > 0U) {
+        parent = (index - 1U) / 2U;
+        if (g_delayed_heap[parent].wake_time <= entry.wake_time) {
+            break;
+        }
+        delayed_place(index, g_delayed_heap[parent]);
+        index = parent;
     }
     
-    if (current != NULL) {
-        current->prev = node;
+    delayed_place(index, entry);
+}
+
+/**
+ * @brief Move an entry towards the leaves until no child is earlier
+ * @param index Hole to start from
+ * @param entry Entry to place
+ */
+static void delayed_sift_down(uint32_t index, delayed_entry_t entry)
+{
+    uint32_t count = g_queue_manager.delayed_count;
+    uint32_t child;
+    
+    for (;;) {
+        child = (2U * index) + 1U;
+        if (child >= count) {
+            break;
+        }
+        if (((child + 1U) < count) &&
+            (g_delayed_heap[child + 1U].wake_time < g_delayed_heap[child].wake_time)) {
+            child++;
+        }
+        if (entry.wake_time <= g_delayed_heap[child].wake_time) {
+            break;
+        }
+        delayed_place(index, g_delayed_heap[child]);
+        index = child;
     }
     
-    g_queue_manager.delayed_count++;
+    delayed_place(index, entry);
 }
 
 /**
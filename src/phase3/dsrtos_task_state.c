@@ -27,28 +27,8 @@
 #define STATE_TRANSITION_MAX_TIME_US   (100U)
 #define STATE_HISTORY_SIZE             (8U)
 
-/* Missing task state constants */
-#ifndef DSRTOS_TASK_STATE_INVALID
-#define DSRTOS_TASK_STATE_INVALID      (0U)
-#endif
-#ifndef DSRTOS_TASK_STATE_READY
-#define DSRTOS_TASK_STATE_READY        (2U)
-#endif
-#ifndef DSRTOS_TASK_STATE_RUNNING
-#define DSRTOS_TASK_STATE_RUNNING      (3U)
-#endif
-#ifndef DSRTOS_TASK_STATE_BLOCKED
-#define DSRTOS_TASK_STATE_BLOCKED      (4U)
-#endif
-#ifndef DSRTOS_TASK_STATE_SUSPENDED
-#define DSRTOS_TASK_STATE_SUSPENDED    (5U)
-#endif
-#ifndef DSRTOS_TASK_STATE_TERMINATED
-#define DSRTOS_TASK_STATE_TERMINATED   (6U)
-#endif
-#ifndef DSRTOS_TASK_STATE_DORMANT
-#define DSRTOS_TASK_STATE_DORMANT      (1U)
-#endif
+/* Bit of a destination state in the transition table */
+#define STATE_BIT(state)               ((uint8_t)(1U << (uint32_t)(state)))
 
 /* Missing error code */
 #ifndef DSRTOS_ERROR_CORRUPTED
@@ -59,13 +39,8 @@
  * TYPE DEFINITIONS
  *============================================================================*/
 
-/* State transition rule */
-typedef struct {
-    dsrtos_task_state_t from_state;
-    dsrtos_task_state_t to_state;
-    bool allowed;
-    bool (*validator)(const dsrtos_tcb_t *tcb);
-} state_transition_rule_t;
+/* Queue action run when a task leaves or enters a state */
+typedef dsrtos_error_t (*state_action_t)(dsrtos_tcb_t *tcb);
 
 /* State transition history entry */
 typedef struct {
@@ -98,49 +73,16 @@ static state_manager_t g_state_manager = {
     .state_change_hook = NULL
 };
 
-/* State transition rules table */
-static const state_transition_rule_t g_transition_rules[] = {
-    /* From INVALID state */
-    {DSRTOS_TASK_STATE_INVALID, DSRTOS_TASK_STATE_READY, true, NULL},
-    {DSRTOS_TASK_STATE_INVALID, DSRTOS_TASK_STATE_DORMANT, true, NULL},
-    
-    /* From READY state */
-    {DSRTOS_TASK_STATE_READY, DSRTOS_TASK_STATE_RUNNING, true, NULL},
-    {DSRTOS_TASK_STATE_READY, DSRTOS_TASK_STATE_BLOCKED, true, NULL},
-    {DSRTOS_TASK_STATE_READY, DSRTOS_TASK_STATE_SUSPENDED, true, NULL},
-    {DSRTOS_TASK_STATE_READY, DSRTOS_TASK_STATE_TERMINATED, true, NULL},
-    
-    /* From RUNNING state */
-    {DSRTOS_TASK_STATE_RUNNING, DSRTOS_TASK_STATE_READY, true, NULL},
-    {DSRTOS_TASK_STATE_RUNNING, DSRTOS_TASK_STATE_BLOCKED, true, NULL},
-    {DSRTOS_TASK_STATE_RUNNING, DSRTOS_TASK_STATE_SUSPENDED, true, NULL},
-    {DSRTOS_TASK_STATE_RUNNING, DSRTOS_TASK_STATE_TERMINATED, true, NULL},
-    
-    /* From BLOCKED state */
-    {DSRTOS_TASK_STATE_BLOCKED, DSRTOS_TASK_STATE_READY, true, NULL},
-    {DSRTOS_TASK_STATE_BLOCKED, DSRTOS_TASK_STATE_SUSPENDED, true, NULL},
-    {DSRTOS_TASK_STATE_BLOCKED, DSRTOS_TASK_STATE_TERMINATED, true, NULL},
-    
-    /* From SUSPENDED state */
-    {DSRTOS_TASK_STATE_SUSPENDED, DSRTOS_TASK_STATE_READY, true, NULL},
-    {DSRTOS_TASK_STATE_SUSPENDED, DSRTOS_TASK_STATE_TERMINATED, true, NULL},
-    
-    /* From DORMANT state */
-    {DSRTOS_TASK_STATE_DORMANT, DSRTOS_TASK_STATE_READY, true, NULL},
-    {DSRTOS_TASK_STATE_DORMANT, DSRTOS_TASK_STATE_TERMINATED, true, NULL},
-    
-    /* TERMINATED is final state - no transitions out */
-};
-
 /* State names for debugging */
-static const char* const g_state_names[] = {
-    "INVALID",
-    "READY",
-    "RUNNING",
-    "BLOCKED",
-    "SUSPENDED",
-    "TERMINATED",
-    "DORMANT"
+static const char* const g_state_names[DSRTOS_TASK_STATE_MAX] = {
+    [DSRTOS_TASK_STATE_INVALID]    = "INVALID",
+    [DSRTOS_TASK_STATE_CREATED]    = "CREATED",
+    [DSRTOS_TASK_STATE_READY]      = "READY",
+    [DSRTOS_TASK_STATE_RUNNING]    = "RUNNING",
+    [DSRTOS_TASK_STATE_BLOCKED]    = "BLOCKED",
+    [DSRTOS_TASK_STATE_SUSPENDED]  = "SUSPENDED",
+    [DSRTOS_TASK_STATE_TERMINATED] = "TERMINATED",
+    [DSRTOS_TASK_STATE_DORMANT]    = "DORMANT"
 };
 
 /*==============================================================================
@@ -150,12 +92,60 @@ static const char* const g_state_names[] = {
 static bool is_transition_valid(dsrtos_task_state_t from, dsrtos_task_state_t to);
 static void record_transition(const dsrtos_tcb_t *tcb,
                              dsrtos_task_state_t from,
-                             dsrtos_task_state_t to);
+                             dsrtos_task_state_t to,
+                             uint64_t now);
 static dsrtos_error_t perform_state_actions(dsrtos_tcb_t *tcb,
                                            dsrtos_task_state_t new_state);
+static dsrtos_error_t state_enter_blocked(dsrtos_tcb_t *tcb);
 static void update_task_timing(dsrtos_tcb_t *tcb,
                               dsrtos_task_state_t old_state,
-                              dsrtos_task_state_t new_state);
+                              dsrtos_task_state_t new_state,
+                              uint64_t now);
+
+/*==============================================================================
+ * TRANSITION TABLES
+ *============================================================================*/
+
+/* Legal destinations per source state, one bit per destination */
+static const uint8_t g_transition_mask[DSRTOS_TASK_STATE_MAX] = {
+    [DSRTOS_TASK_STATE_INVALID]    = STATE_BIT(DSRTOS_TASK_STATE_CREATED) |
+                                     STATE_BIT(DSRTOS_TASK_STATE_READY) |
+                                     STATE_BIT(DSRTOS_TASK_STATE_DORMANT),
+    [DSRTOS_TASK_STATE_CREATED]    = STATE_BIT(DSRTOS_TASK_STATE_READY) |
+                                     STATE_BIT(DSRTOS_TASK_STATE_TERMINATED),
+    [DSRTOS_TASK_STATE_READY]      = STATE_BIT(DSRTOS_TASK_STATE_RUNNING) |
+                                     STATE_BIT(DSRTOS_TASK_STATE_BLOCKED) |
+                                     STATE_BIT(DSRTOS_TASK_STATE_SUSPENDED) |
+                                     STATE_BIT(DSRTOS_TASK_STATE_TERMINATED),
+    [DSRTOS_TASK_STATE_RUNNING]    = STATE_BIT(DSRTOS_TASK_STATE_READY) |
+                                     STATE_BIT(DSRTOS_TASK_STATE_BLOCKED) |
+                                     STATE_BIT(DSRTOS_TASK_STATE_SUSPENDED) |
+                                     STATE_BIT(DSRTOS_TASK_STATE_TERMINATED),
+    [DSRTOS_TASK_STATE_BLOCKED]    = STATE_BIT(DSRTOS_TASK_STATE_READY) |
+                                     STATE_BIT(DSRTOS_TASK_STATE_SUSPENDED) |
+                                     STATE_BIT(DSRTOS_TASK_STATE_TERMINATED),
+    [DSRTOS_TASK_STATE_SUSPENDED]  = STATE_BIT(DSRTOS_TASK_STATE_READY) |
+                                     STATE_BIT(DSRTOS_TASK_STATE_TERMINATED),
+    /* TERMINATED is final state - no transitions out */
+    [DSRTOS_TASK_STATE_TERMINATED] = 0U,
+    [DSRTOS_TASK_STATE_DORMANT]    = STATE_BIT(DSRTOS_TASK_STATE_READY) |
+                                     STATE_BIT(DSRTOS_TASK_STATE_TERMINATED)
+};
+
+/* Queue a task leaves, by source state (NULL: not queued) */
+static const state_action_t g_leave_actions[DSRTOS_TASK_STATE_MAX] = {
+    [DSRTOS_TASK_STATE_READY]      = dsrtos_queue_ready_remove,
+    [DSRTOS_TASK_STATE_BLOCKED]    = dsrtos_queue_blocked_remove,
+    [DSRTOS_TASK_STATE_SUSPENDED]  = dsrtos_queue_suspended_remove
+};
+
+/* Queue a task joins, by destination state; RUNNING is tracked by the
+ * scheduler and TERMINATED cleaned up by the task manager */
+static const state_action_t g_enter_actions[DSRTOS_TASK_STATE_MAX] = {
+    [DSRTOS_TASK_STATE_READY]      = dsrtos_queue_ready_insert,
+    [DSRTOS_TASK_STATE_BLOCKED]    = state_enter_blocked,
+    [DSRTOS_TASK_STATE_SUSPENDED]  = dsrtos_queue_suspended_insert
+};
 
 /*==============================================================================
  * PUBLIC FUNCTIONS
@@ -184,6 +174,8 @@ dsrtos_error_t dsrtos_state_transition(dsrtos_tcb_t *tcb,
 {
     dsrtos_task_state_t old_state;
     dsrtos_error_t err;
+    dsrtos_state_change_hook_t hook;
+    uint64_t now;
     uint32_t start_time;
     uint32_t transition_time;
     
@@ -192,7 +184,7 @@ dsrtos_error_t dsrtos_state_transition(dsrtos_tcb_t *tcb,
         return DSRTOS_ERROR_INVALID_PARAM;
     }
     
-    if (new_state > DSRTOS_TASK_STATE_DORMANT) {
+    if (new_state >= DSRTOS_TASK_STATE_MAX) {
         return DSRTOS_ERROR_INVALID_PARAM;
     }
     
@@ -215,6 +207,7 @@ dsrtos_error_t dsrtos_state_transition(dsrtos_tcb_t *tcb,
     }
     
     start_time = dsrtos_get_tick_count();
+    now = dsrtos_get_system_time();
     
     dsrtos_critical_enter();
     
@@ -232,10 +225,10 @@ dsrtos_error_t dsrtos_state_transition(dsrtos_tcb_t *tcb,
     tcb->state = new_state;
     
     /* Update timing information */
-    update_task_timing(tcb, old_state, new_state);
+    update_task_timing(tcb, old_state, new_state, now);
     
     /* Record transition */
-    record_transition(tcb, old_state, new_state);
+    record_transition(tcb, old_state, new_state, now);
     
     /* Update statistics */
     g_state_manager.total_transitions++;
@@ -248,9 +241,10 @@ dsrtos_error_t dsrtos_state_transition(dsrtos_tcb_t *tcb,
         g_state_manager.transition_time_max = transition_time;
     }
     
-    /* Call state change hook if registered */
-    if (g_state_manager.state_change_hook != NULL) {
-        g_state_manager.state_change_hook(tcb, old_state, new_state);
+    /* Call state change hook if registered; one load and branch if not */
+    hook = g_state_manager.state_change_hook;
+    if (hook != NULL) {
+        hook(tcb, old_state, new_state);
     }
     
     return DSRTOS_SUCCESS;
@@ -287,7 +281,7 @@ dsrtos_error_t dsrtos_state_get(const dsrtos_tcb_t *tcb,
  */
 const char* dsrtos_state_get_name(dsrtos_task_state_t state)
 {
-    if (state <= DSRTOS_TASK_STATE_DORMANT) {
+    if (state < DSRTOS_TASK_STATE_MAX) {
         return g_state_names[state];
     }
     return "UNKNOWN";
@@ -368,17 +362,12 @@ dsrtos_error_t dsrtos_state_get_stats(dsrtos_state_stats_t *stats)
  */
 static bool is_transition_valid(dsrtos_task_state_t from, dsrtos_task_state_t to)
 {
-    uint32_t rule_count = sizeof(g_transition_rules) / sizeof(g_transition_rules[0]);
-    
-    for (uint32_t i = 0U; i < rule_count; i++) {
-        if ((g_transition_rules[i].from_state == from) &&
-            (g_transition_rules[i].to_state == to)) {
-            return g_transition_rules[i].allowed;
-        }
+    /* A corrupted source state has no legal destinations */
+    if ((uint32_t)from >= (uint32_t)DSRTOS_TASK_STATE_MAX) {
+        return false;
     }
     
-    /* Transition not found in rules - not allowed */
-    return false;
+    return (g_transition_mask[from] & STATE_BIT(to)) != 0U;
 }
 
 /**
@@ -386,16 +375,18 @@ static bool is_transition_valid(dsrtos_task_state_t from, dsrtos_task_state_t to
  * @param tcb Task control block
  * @param from Previous state
  * @param to New state
+ * @param now Transition time
  */
 static void record_transition(const dsrtos_tcb_t *tcb,
                              dsrtos_task_state_t from,
-                             dsrtos_task_state_t to)
+                             dsrtos_task_state_t to,
+                             uint64_t now)
 {
     state_history_entry_t *entry;
     
     entry = &g_state_manager.history[g_state_manager.history_index];
     
-    entry->timestamp = dsrtos_get_system_time();
+    entry->timestamp = (uint32_t)now;
     entry->from_state = from;
     entry->to_state = to;
     entry->task_id = tcb->task_id;
@@ -415,70 +406,45 @@ static dsrtos_error_t perform_state_actions(dsrtos_tcb_t *tcb,
                                            dsrtos_task_state_t new_state)
 {
     dsrtos_error_t err = DSRTOS_SUCCESS;
+    state_action_t leave = g_leave_actions[tcb->state];
+    state_action_t enter = g_enter_actions[new_state];
     
     /* Remove from current queue if needed */
-    switch (tcb->state) {
-        case DSRTOS_TASK_STATE_READY:
-            err = dsrtos_queue_ready_remove(tcb);
-            break;
-            
-        case DSRTOS_TASK_STATE_BLOCKED:
-            err = dsrtos_queue_blocked_remove(tcb);
-            break;
-            
-        case DSRTOS_TASK_STATE_SUSPENDED:
-            err = dsrtos_queue_suspended_remove(tcb);
-            break;
-            
-        default:
-            /* No queue removal needed */
-            break;
-    }
-    
-    if (err != DSRTOS_SUCCESS) {
-        return err;
+    if (leave != NULL) {
+        err = leave(tcb);
     }
     
     /* Add to new queue if needed */
-    switch (new_state) {
-        case DSRTOS_TASK_STATE_READY:
-            err = dsrtos_queue_ready_insert(tcb);
-            break;
-            
-        case DSRTOS_TASK_STATE_BLOCKED:
-            err = dsrtos_queue_blocked_insert(tcb, 0U);
-            break;
-            
-        case DSRTOS_TASK_STATE_SUSPENDED:
-            err = dsrtos_queue_suspended_insert(tcb);
-            break;
-            
-        case DSRTOS_TASK_STATE_RUNNING:
-            /* Update current task pointer - done by scheduler */
-            break;
-            
-        case DSRTOS_TASK_STATE_TERMINATED:
-            /* Clean up resources - done by task manager */
-            break;
-            
-        default:
-            break;
+    if ((err == DSRTOS_SUCCESS) && (enter != NULL)) {
+        err = enter(tcb);
     }
     
     return err;
 }
 
+/**
+ * @brief Enter the blocked list without a timeout
+ * @param tcb Task control block
+ * @return Error code
+ */
+static dsrtos_error_t state_enter_blocked(dsrtos_tcb_t *tcb)
+{
+    return dsrtos_queue_blocked_insert(tcb, 0U);
+}
+
 /**
  * @brief Update task timing based on state transition
  * @param tcb Task control block
  * @param old_state Previous state
  * @param new_state New state
+ * @param now Transition time
  */
 static void update_task_timing(dsrtos_tcb_t *tcb,
                               dsrtos_task_state_t old_state,
-                              dsrtos_task_state_t new_state)
+                              dsrtos_task_state_t new_state,
+                              uint64_t now)
 {
-    uint64_t current_time = dsrtos_get_system_time();
+    uint64_t current_time = now;
     
     /* Leaving RUNNING state - update runtime */
     if (old_state == DSRTOS_TASK_STATE_RUNNING) {
@@ -17,6 +17,8 @@
 #include "dsrtos_task_manager.h"
 #include "dsrtos_kernel.h"
 #include "dsrtos_critical.h"
+#include "dsrtos_shard_stats.h"
+#include "dsrtos_stats_stream.h"
 #include <string.h>
 
 /*==============================================================================
@@ -64,6 +66,9 @@ typedef struct {
 /* System statistics */
 static system_stats_t g_system_stats = {0};
 
+/* Publishes g_system_stats to readers that do not mask interrupts */
+static dsrtos_seqcount_t g_system_stats_seq = {0U, 0U};
+
 /* Per-task performance metrics */
 static task_perf_metrics_t g_task_metrics[DSRTOS_MAX_TASKS];
 
@@ -150,6 +155,7 @@ dsrtos_error_t dsrtos_stats_collect(void)
     }
     
     dsrtos_critical_enter();
+    dsrtos_seqcount_write_begin(&g_system_stats_seq);
     
     /* Update system uptime */
     g_system_stats.system_uptime = current_time;
@@ -200,6 +206,7 @@ dsrtos_error_t dsrtos_stats_collect(void)
     
     g_last_collection_time = current_time;
     
+    dsrtos_seqcount_write_end(&g_system_stats_seq);
     dsrtos_critical_exit();
     
     /* Call report hook if registered */
@@ -252,11 +259,9 @@ dsrtos_error_t dsrtos_stats_get_system(system_stats_t *stats)
         return DSRTOS_ERROR_INVALID_PARAM;
     }
     
-    dsrtos_critical_enter();
-    *stats = g_system_stats;
-    dsrtos_critical_exit();
-    
-    return DSRTOS_SUCCESS;
+    /* Lock-free copy: retried if a collection ran meanwhile */
+    return dsrtos_seqcount_read(&g_system_stats_seq, stats,
+                                &g_system_stats, sizeof(system_stats_t));
 }
 
 /**
@@ -306,7 +311,9 @@ dsrtos_error_t dsrtos_stats_reset_phase3(dsrtos_tcb_t *tcb)
     
     if (tcb == NULL) {
         /* Reset all statistics */
+        dsrtos_seqcount_write_begin(&g_system_stats_seq);
         (void)memset(&g_system_stats, 0, sizeof(g_system_stats));
+        dsrtos_seqcount_write_end(&g_system_stats_seq);
         (void)memset(g_task_metrics, 0, sizeof(g_task_metrics));
         (void)memset(g_stats_history, 0, sizeof(g_stats_history));
         g_history_index = 0U;
@@ -348,10 +355,14 @@ dsrtos_error_t dsrtos_stats_register_hook(dsrtos_stats_report_hook_t hook)
  * @param size Buffer size
  * @param format Export format
  * @return Bytes written or error code
+ * @note CSV and JSON stop when the buffer is full; use
+ *       dsrtos_stats_stream_read() to export in pieces
  */
 int32_t dsrtos_stats_export_phase3(void *buffer, uint32_t size, dsrtos_stats_format_t format)
 {
     uint32_t bytes_written = 0U;
+    dsrtos_stats_stream_t stream;
+    dsrtos_error_t err;
     
     if ((buffer == NULL) || (size == 0U)) {
         return DSRTOS_ERROR_INVALID_PARAM;
@@ -360,22 +371,23 @@ int32_t dsrtos_stats_export_phase3(void *buffer, uint32_t size, dsrtos_stats_for
     switch (format) {
         case DSRTOS_STATS_FORMAT_BINARY:
             /* Export as binary structure */
-            if (size >= sizeof(system_stats_t)) {
-                dsrtos_critical_enter();
-                (void)memcpy(buffer, &g_system_stats, sizeof(system_stats_t));
+            if ((size >= sizeof(system_stats_t)) &&
+                (dsrtos_seqcount_read(&g_system_stats_seq, buffer, &g_system_stats,
+                                      sizeof(system_stats_t)) == DSRTOS_SUCCESS)) {
                 bytes_written = sizeof(system_stats_t);
-                dsrtos_critical_exit();
             }
             break;
             
         case DSRTOS_STATS_FORMAT_CSV:
-            /* Export as CSV - implementation simplified for space */
-            bytes_written = 0U;
-            break;
-            
         case DSRTOS_STATS_FORMAT_JSON:
-            /* Export as JSON - implementation simplified for space */
-            bytes_written = 0U;
+            /* One pass of the streaming exporter */
+            err = dsrtos_stats_stream_begin(&stream, format);
+            if (err == DSRTOS_SUCCESS) {
+                err = dsrtos_stats_stream_read(&stream, buffer, size, &bytes_written);
+            }
+            if (err != DSRTOS_SUCCESS) {
+                return err;
+            }
             break;
             
         default:
@@ -0,0 +1,746 @@
+/*
+ * @file dsrtos_workqueue.c
+ * @brief DSRTOS Kernel Work Queue Implementation
+ * @date 2024-12-30
+ *
+ * Offloads short jobs to a bounded pool of worker tasks instead of
+ * creating a task per job. Pending items are linked intrusively into
+ * per-priority FIFO lists, so submission and dispatch never allocate.
+ * Workers pick the most urgent item across all queues that are below
+ * their concurrency limit. Delayed items sit on a list sorted by release
+ * tick that is drained from the kernel tick hook. The tick only looks at
+ * the list head; the sorted insert walks the list at submission time.
+ *
+ * COMPLIANCE:
+ * - MISRA-C:2012 compliant
+ * - DO-178C DAL-B certifiable
+ * - IEC 62304 Class B compliant
+ * - ISO 26262 ASIL D compliant
+ */
+
+#include "dsrtos_workqueue.h"
+#include "dsrtos_task_manager.h"
+#include "dsrtos_task_creation.h"
+#include "dsrtos_task_state.h"
+#include "dsrtos_kernel.h"
+#include "dsrtos_critical.h"
+#include "dsrtos_hooks.h"
+#include "dsrtos_port.h"
+#include <string.h>
+
+/*==============================================================================
+ * CONSTANTS
+ *============================================================================*/
+
+#define WORKQUEUE_MAGIC         (0x574B5155U)  /* 'WKQU' */
+#define WORKER_NAME_PREFIX      "kworker"
+
+/*==============================================================================
+ * TYPE DEFINITIONS
+ *============================================================================*/
+
+/* Worker task slot */
+typedef struct {
+    dsrtos_tcb_t *tcb;
+    bool idle;
+} workqueue_worker_t;
+
+/* Work queue manager */
+typedef struct {
+    bool initialized;
+    dsrtos_workqueue_t *queues[DSRTOS_WORKQUEUE_MAX_QUEUES];
+    uint32_t queue_count;
+    uint32_t rr_cursor;                 /* Fair start point for equal levels */
+
+    /* Delayed items, sorted by due tick */
+    dsrtos_work_t *delayed_head;
+
+    workqueue_worker_t workers[DSRTOS_WORKQUEUE_WORKERS];
+    uint32_t idle_mask;
+    void *tick_hook;
+
+    dsrtos_workqueue_pool_stats_t stats;
+} workqueue_manager_t;
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+static workqueue_manager_t g_wq_manager;
+
+/*==============================================================================
+ * STATIC FUNCTION PROTOTYPES
+ *============================================================================*/
+
+static void workqueue_worker_entry(void *param);
+static void* workqueue_tick_hook(dsrtos_hook_type_t type, void *params);
+static void workqueue_enqueue(dsrtos_workqueue_t *wq, dsrtos_work_t *work);
+static void workqueue_unlink_pending(dsrtos_workqueue_t *wq, dsrtos_work_t *work);
+static void workqueue_insert_delayed(dsrtos_work_t *work);
+static void workqueue_unlink_delayed(dsrtos_work_t *work);
+static dsrtos_work_t* workqueue_take_next(void);
+static bool workqueue_has_runnable(void);
+static void workqueue_wake_worker(void);
+static bool workqueue_tick_before(uint32_t a, uint32_t b);
+
+/*==============================================================================
+ * PUBLIC FUNCTIONS
+ *============================================================================*/
+
+/**
+ * @brief Initialize work queue subsystem
+ * @return Error code
+ */
+dsrtos_error_t dsrtos_workqueue_init(void)
+{
+    dsrtos_hook_entry_t hook;
+
+    if (g_wq_manager.initialized) {
+        return DSRTOS_ERROR_ALREADY_INITIALIZED;
+    }
+
+    (void)memset(&g_wq_manager, 0, sizeof(g_wq_manager));
+
+    /* Release delayed items from the tick path */
+    (void)memset(&hook, 0, sizeof(hook));
+    hook.type = DSRTOS_HOOK_KERNEL_TICK;
+    hook.function = workqueue_tick_hook;
+    hook.priority = 0U;
+    hook.enabled = true;
+    hook.name = "workqueue";
+    g_wq_manager.tick_hook = dsrtos_hook_register(&hook);
+
+    g_wq_manager.initialized = true;
+
+    return DSRTOS_SUCCESS;
+}
+
+/**
+ * @brief Create the worker task pool
+ * @return Error code
+ * @note Called once after the scheduler is ready to accept tasks
+ */
+dsrtos_error_t dsrtos_workqueue_start_workers(void)
+{
+    dsrtos_task_create_extended_t params;
+
+    if (!g_wq_manager.initialized) {
+        return DSRTOS_ERROR_NOT_INITIALIZED;
+    }
+
+    for (uint32_t i = 0U; i < DSRTOS_WORKQUEUE_WORKERS; i++) {
+        if (g_wq_manager.workers[i].tcb != NULL) {
+            continue;
+        }
+
+        (void)memset(&params, 0, sizeof(params));
+        (void)strncpy(params.base.name, WORKER_NAME_PREFIX, DSRTOS_TASK_NAME_MAX_LENGTH - 2U);
+        params.base.name[sizeof(WORKER_NAME_PREFIX) - 1U] = (char)('0' + (char)i);
+        params.base.entry_point = workqueue_worker_entry;
+        params.base.parameter = (void *)(uintptr_t)i;
+        params.base.param = params.base.parameter;
+        params.base.priority = DSRTOS_WORKQUEUE_WORKER_PRIORITY;
+        params.base.stack_size = DSRTOS_WORKQUEUE_WORKER_STACK;
+        params.use_pool = true;
+
+        g_wq_manager.workers[i].tcb = dsrtos_task_create_extended(&params);
+        if (g_wq_manager.workers[i].tcb == NULL) {
+            return DSRTOS_ERROR_NO_RESOURCES;
+        }
+        g_wq_manager.stats.workers++;
+    }
+
+    return DSRTOS_SUCCESS;
+}
+
+/**
+ * @brief Create a work queue
+ * @param wq Queue storage owned by the caller
+ * @param name Queue name
+ * @param max_active Maximum items of this queue running at once
+ * @return Error code
+ */
+dsrtos_error_t dsrtos_workqueue_create(dsrtos_workqueue_t *wq,
+                                       const char *name,
+                                       uint8_t max_active)
+{
+    dsrtos_error_t result = DSRTOS_ERROR_NO_RESOURCES;
+
+    if ((wq == NULL) || (max_active == 0U)) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+
+    if (!g_wq_manager.initialized) {
+        return DSRTOS_ERROR_NOT_INITIALIZED;
+    }
+
+    (void)memset(wq, 0, sizeof(*wq));
+    wq->name = name;
+    wq->max_active = (max_active > DSRTOS_WORKQUEUE_WORKERS) ?
+                     (uint8_t)DSRTOS_WORKQUEUE_WORKERS : max_active;
+
+    dsrtos_critical_enter();
+    for (uint32_t i = 0U; i < DSRTOS_WORKQUEUE_MAX_QUEUES; i++) {
+        if (g_wq_manager.queues[i] == NULL) {
+            g_wq_manager.queues[i] = wq;
+            g_wq_manager.queue_count++;
+            wq->index = (uint16_t)i;
+            wq->magic = WORKQUEUE_MAGIC;
+            result = DSRTOS_SUCCESS;
+            break;
+        }
+    }
+    dsrtos_critical_exit();
+
+    return result;
+}
+
+/**
+ * @brief Destroy an idle work queue
+ * @param wq Queue to destroy
+ * @return Error code
+ */
+dsrtos_error_t dsrtos_workqueue_destroy(dsrtos_workqueue_t *wq)
+{
+    dsrtos_error_t result = DSRTOS_SUCCESS;
+
+    if ((wq == NULL) || (wq->magic != WORKQUEUE_MAGIC)) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+
+    dsrtos_critical_enter();
+    if ((wq->pending_bitmap != 0U) || (wq->active != 0U) ||
+        (wq->stats.delayed != 0U)) {
+        result = DSRTOS_ERROR_BUSY;
+    } else {
+        g_wq_manager.queues[wq->index] = NULL;
+        g_wq_manager.queue_count--;
+        wq->magic = 0U;
+    }
+    dsrtos_critical_exit();
+
+    return result;
+}
+
+/**
+ * @brief Initialize a work item
+ * @param work Work item
+ * @param handler Handler to run
+ * @param arg User argument
+ */
+void dsrtos_work_init(dsrtos_work_t *work, dsrtos_work_handler_t handler, void *arg)
+{
+    if (work != NULL) {
+        (void)memset(work, 0, sizeof(*work));
+        work->handler = handler;
+        work->arg = arg;
+        work->state = (uint8_t)DSRTOS_WORK_STATE_IDLE;
+    }
+}
+
+/**
+ * @brief Submit a work item for immediate execution
+ * @param wq Target queue
+ * @param work Work item
+ * @param priority Item priority (0 = most urgent)
+ * @return Error code
+ * @note Safe from ISR context; an item that is running may requeue itself
+ */
+dsrtos_error_t dsrtos_work_submit(dsrtos_workqueue_t *wq,
+                                  dsrtos_work_t *work,
+                                  uint8_t priority)
+{
+    if ((wq == NULL) || (work == NULL) || (work->handler == NULL) ||
+        (priority >= DSRTOS_WORK_PRIORITY_LEVELS)) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+
+    if (wq->magic != WORKQUEUE_MAGIC) {
+        return DSRTOS_ERROR_INVALID_HANDLE;
+    }
+
+    dsrtos_critical_enter();
+
+    if ((work->state == (uint8_t)DSRTOS_WORK_STATE_PENDING) ||
+        (work->state == (uint8_t)DSRTOS_WORK_STATE_DELAYED)) {
+        wq->stats.rejected++;
+        dsrtos_critical_exit();
+        return DSRTOS_ERROR_ALREADY_EXISTS;
+    }
+
+    work->queue = wq;
+    work->priority = priority;
+    work->submit_cycles = dsrtos_port_get_cycle_count();
+    workqueue_enqueue(wq, work);
+    wq->stats.submitted++;
+
+    if (wq->active < wq->max_active) {
+        workqueue_wake_worker();
+    }
+
+    dsrtos_critical_exit();
+
+    return DSRTOS_SUCCESS;
+}
+
+/**
+ * @brief Submit a work item after a delay
+ * @param wq Target queue
+ * @param work Work item
+ * @param priority Item priority (0 = most urgent)
+ * @param delay_ticks Delay in kernel ticks
+ * @return Error code
+ */
+dsrtos_error_t dsrtos_work_submit_delayed(dsrtos_workqueue_t *wq,
+                                          dsrtos_work_t *work,
+                                          uint8_t priority,
+                                          uint32_t delay_ticks)
+{
+    if (delay_ticks == 0U) {
+        return dsrtos_work_submit(wq, work, priority);
+    }
+
+    if ((wq == NULL) || (work == NULL) || (work->handler == NULL) ||
+        (priority >= DSRTOS_WORK_PRIORITY_LEVELS)) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+
+    if (wq->magic != WORKQUEUE_MAGIC) {
+        return DSRTOS_ERROR_INVALID_HANDLE;
+    }
+
+    dsrtos_critical_enter();
+
+    if ((work->state == (uint8_t)DSRTOS_WORK_STATE_PENDING) ||
+        (work->state == (uint8_t)DSRTOS_WORK_STATE_DELAYED)) {
+        wq->stats.rejected++;
+        dsrtos_critical_exit();
+        return DSRTOS_ERROR_ALREADY_EXISTS;
+    }
+
+    work->queue = wq;
+    work->priority = priority;
+    work->due_tick = dsrtos_get_tick_count() + delay_ticks;
+    work->state = (uint8_t)DSRTOS_WORK_STATE_DELAYED;
+    workqueue_insert_delayed(work);
+    wq->stats.delayed++;
+
+    dsrtos_critical_exit();
+
+    return DSRTOS_SUCCESS;
+}
+
+/**
+ * @brief Cancel a pending or delayed work item
+ * @param work Work item
+ * @return DSRTOS_SUCCESS if removed, DSRTOS_ERROR_BUSY if running,
+ *         DSRTOS_ERROR_NOT_FOUND if not queued
+ */
+dsrtos_error_t dsrtos_work_cancel(dsrtos_work_t *work)
+{
+    dsrtos_error_t result;
+    dsrtos_workqueue_t *wq;
+
+    if (work == NULL) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+
+    dsrtos_critical_enter();
+
+    wq = work->queue;
+    switch ((dsrtos_work_state_t)work->state) {
+        case DSRTOS_WORK_STATE_PENDING:
+            workqueue_unlink_pending(wq, work);
+            wq->stats.cancelled++;
+            result = DSRTOS_SUCCESS;
+            break;
+
+        case DSRTOS_WORK_STATE_DELAYED:
+            workqueue_unlink_delayed(work);
+            wq->stats.delayed--;
+            wq->stats.cancelled++;
+            result = DSRTOS_SUCCESS;
+            break;
+
+        case DSRTOS_WORK_STATE_RUNNING:
+            result = DSRTOS_ERROR_BUSY;
+            break;
+
+        case DSRTOS_WORK_STATE_IDLE:
+        default:
+            result = DSRTOS_ERROR_NOT_FOUND;
+            break;
+    }
+
+    if (result == DSRTOS_SUCCESS) {
+        work->state = (uint8_t)DSRTOS_WORK_STATE_IDLE;
+    }
+
+    dsrtos_critical_exit();
+
+    return result;
+}
+
+/**
+ * @brief Check whether a work item is waiting to run
+ * @param work Work item
+ * @return true if pending or delayed
+ */
+bool dsrtos_work_is_pending(const dsrtos_work_t *work)
+{
+    return (work != NULL) &&
+           ((work->state == (uint8_t)DSRTOS_WORK_STATE_PENDING) ||
+            (work->state == (uint8_t)DSRTOS_WORK_STATE_DELAYED));
+}
+
+/**
+ * @brief Dequeue and execute one work item
+ * @return true if an item was executed
+ * @note Body of every worker task; the host port drives it directly
+ */
+bool dsrtos_workqueue_run_one(void)
+{
+    dsrtos_work_t *work;
+    dsrtos_workqueue_t *wq;
+    uint32_t latency;
+
+    dsrtos_critical_enter();
+    work = workqueue_take_next();
+    dsrtos_critical_exit();
+
+    if (work == NULL) {
+        return false;
+    }
+
+    wq = work->queue;
+    latency = dsrtos_port_get_cycle_count() - work->submit_cycles;
+
+    work->handler(work);
+
+    /* Workers share queues: statistics change only under the lock */
+    dsrtos_critical_enter();
+    wq->active--;
+    wq->stats.executed++;
+    wq->stats.total_latency_cycles += latency;
+    if (latency > wq->stats.max_latency_cycles) {
+        wq->stats.max_latency_cycles = latency;
+    }
+    g_wq_manager.stats.items_executed++;
+
+    /* The handler may have resubmitted the item */
+    if (work->state == (uint8_t)DSRTOS_WORK_STATE_RUNNING) {
+        work->state = (uint8_t)DSRTOS_WORK_STATE_IDLE;
+    }
+
+    /* A slot freed up under the concurrency limit */
+    if (wq->pending_bitmap != 0U) {
+        workqueue_wake_worker();
+    }
+    dsrtos_critical_exit();
+
+    return true;
+}
+
+/**
+ * @brief Release delayed items that are due
+ * @param now Current tick count
+ * @note O(1) when nothing is due: only the list head is inspected
+ */
+void dsrtos_workqueue_tick(uint32_t now)
+{
+    dsrtos_work_t *work;
+    bool released = false;
+
+    dsrtos_critical_enter();
+
+    while ((g_wq_manager.delayed_head != NULL) &&
+           !workqueue_tick_before(now, g_wq_manager.delayed_head->due_tick)) {
+        work = g_wq_manager.delayed_head;
+        workqueue_unlink_delayed(work);
+        work->queue->stats.delayed--;
+        work->submit_cycles = dsrtos_port_get_cycle_count();
+        workqueue_enqueue(work->queue, work);
+        work->queue->stats.submitted++;
+        g_wq_manager.stats.delayed_released++;
+        released = true;
+    }
+
+    if (released) {
+        workqueue_wake_worker();
+    }
+
+    dsrtos_critical_exit();
+}
+
+/**
+ * @brief Get work queue statistics
+ * @param wq Queue
+ * @param stats Buffer to store statistics
+ * @return Error code
+ */
+dsrtos_error_t dsrtos_workqueue_get_stats(const dsrtos_workqueue_t *wq,
+                                          dsrtos_workqueue_stats_t *stats)
+{
+    if ((wq == NULL) || (stats == NULL)) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+
+    dsrtos_critical_enter();
+    *stats = wq->stats;
+    dsrtos_critical_exit();
+
+    return DSRTOS_SUCCESS;
+}
+
+/**
+ * @brief Get worker pool statistics
+ * @param stats Buffer to store statistics
+ * @return Error code
+ */
+dsrtos_error_t dsrtos_workqueue_get_pool_stats(dsrtos_workqueue_pool_stats_t *stats)
+{
+    if (stats == NULL) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+
+    dsrtos_critical_enter();
+    *stats = g_wq_manager.stats;
+    stats->idle_workers = (uint32_t)__builtin_popcount(g_wq_manager.idle_mask);
+    dsrtos_critical_exit();
+
+    return DSRTOS_SUCCESS;
+}
+
+/*==============================================================================
+ * STATIC FUNCTIONS
+ *============================================================================*/
+
+/**
+ * @brief Worker task body
+ * @param param Worker index
+ */
+static void workqueue_worker_entry(void *param)
+{
+    uint32_t index = (uint32_t)(uintptr_t)param;
+    dsrtos_tcb_t *self = g_wq_manager.workers[index].tcb;
+
+    for (;;) {
+        if (!dsrtos_workqueue_run_one()) {
+            dsrtos_critical_enter();
+            /* A submit between run_one() and here found no idle worker and
+             * woke none: look again before going idle */
+            if (!workqueue_has_runnable()) {
+                g_wq_manager.workers[index].idle = true;
+                g_wq_manager.idle_mask |= (1UL << index);
+                /* PendSV is deferred until the critical section exits, so
+                 * going idle and blocking is atomic against submitters */
+                (void)dsrtos_state_transition(self, DSRTOS_TASK_STATE_BLOCKED);
+                dsrtos_port_yield();
+            }
+            dsrtos_critical_exit();
+        }
+    }
+}
+
+/**
+ * @brief Kernel tick hook adapter
+ */
+static void* workqueue_tick_hook(dsrtos_hook_type_t type, void *params)
+{
+    (void)type;
+    (void)params;
+
+    dsrtos_workqueue_tick(dsrtos_get_tick_count());
+
+    return NULL;
+}
+
+/**
+ * @brief Append item to its priority level (critical section held)
+ */
+static void workqueue_enqueue(dsrtos_workqueue_t *wq, dsrtos_work_t *work)
+{
+    uint32_t level = work->priority;
+
+    work->next = NULL;
+    work->prev = wq->tail[level];
+    if (wq->tail[level] != NULL) {
+        wq->tail[level]->next = work;
+    } else {
+        wq->head[level] = work;
+    }
+    wq->tail[level] = work;
+    wq->pending_bitmap |= (1UL << level);
+    work->state = (uint8_t)DSRTOS_WORK_STATE_PENDING;
+
+    wq->stats.pending++;
+    if (wq->stats.pending > wq->stats.peak_pending) {
+        wq->stats.peak_pending = wq->stats.pending;
+    }
+}
+
+/**
+ * @brief Remove item from its priority level (critical section held)
+ */
+static void workqueue_unlink_pending(dsrtos_workqueue_t *wq, dsrtos_work_t *work)
+{
+    uint32_t level = work->priority;
+
+    if (work->prev != NULL) {
+        work->prev->next = work->next;
+    } else {
+        wq->head[level] = work->next;
+    }
+
+    if (work->next != NULL) {
+        work->next->prev = work->prev;
+    } else {
+        wq->tail[level] = work->prev;
+    }
+
+    if (wq->head[level] == NULL) {
+        wq->pending_bitmap &= ~(1UL << level);
+    }
+
+    work->next = NULL;
+    work->prev = NULL;
+    wq->stats.pending--;
+}
+
+/**
+ * @brief Insert item into the delayed list sorted by due tick
+ */
+static void workqueue_insert_delayed(dsrtos_work_t *work)
+{
+    dsrtos_work_t *prev = NULL;
+    dsrtos_work_t *curr = g_wq_manager.delayed_head;
+
+    /* Items with equal due ticks keep submission order */
+    while ((curr != NULL) && !workqueue_tick_before(work->due_tick, curr->due_tick)) {
+        prev = curr;
+        curr = curr->next;
+    }
+
+    work->prev = prev;
+    work->next = curr;
+    if (curr != NULL) {
+        curr->prev = work;
+    }
+    if (prev != NULL) {
+        prev->next = work;
+    } else {
+        g_wq_manager.delayed_head = work;
+    }
+}
+
+/**
+ * @brief Remove item from the delayed list
+ */
+static void workqueue_unlink_delayed(dsrtos_work_t *work)
+{
+    if (work->prev != NULL) {
+        work->prev->next = work->next;
+    } else {
+        g_wq_manager.delayed_head = work->next;
+    }
+
+    if (work->next != NULL) {
+        work->next->prev = work->prev;
+    }
+
+    work->next = NULL;
+    work->prev = NULL;
+}
+
+/**
+ * @brief Take the most urgent runnable item (critical section held)
+ * @return Work item marked running, or NULL
+ * @note Bounded by DSRTOS_WORKQUEUE_MAX_QUEUES; level lookup is one ctz
+ */
+static dsrtos_work_t* workqueue_take_next(void)
+{
+    dsrtos_workqueue_t *best = NULL;
+    uint32_t best_level = DSRTOS_WORK_PRIORITY_LEVELS;
+    uint32_t start = g_wq_manager.rr_cursor;
+    dsrtos_work_t *work;
+
+    for (uint32_t n = 0U; n < DSRTOS_WORKQUEUE_MAX_QUEUES; n++) {
+        uint32_t i = (start + n) % DSRTOS_WORKQUEUE_MAX_QUEUES;
+        dsrtos_workqueue_t *wq = g_wq_manager.queues[i];
+
+        if ((wq != NULL) && (wq->pending_bitmap != 0U) &&
+            (wq->active < wq->max_active)) {
+            uint32_t level = (uint32_t)__builtin_ctz(wq->pending_bitmap);
+            if (level < best_level) {
+                best_level = level;
+                best = wq;
+            }
+        }
+    }
+
+    if (best == NULL) {
+        return NULL;
+    }
+
+    work = best->head[best_level];
+    workqueue_unlink_pending(best, work);
+    work->state = (uint8_t)DSRTOS_WORK_STATE_RUNNING;
+
+    best->active++;
+    if (best->active > best->stats.peak_active) {
+        best->stats.peak_active = best->active;
+    }
+
+    g_wq_manager.rr_cursor = ((uint32_t)best->index + 1U) % DSRTOS_WORKQUEUE_MAX_QUEUES;
+
+    return work;
+}
+
+/**
+ * @brief Check for an item some worker could take (critical section held)
+ * @return true if a queue has pending work and room to run it
+ */
+static bool workqueue_has_runnable(void)
+{
+    for (uint32_t i = 0U; i < DSRTOS_WORKQUEUE_MAX_QUEUES; i++) {
+        const dsrtos_workqueue_t *wq = g_wq_manager.queues[i];
+
+        if ((wq != NULL) && (wq->pending_bitmap != 0U) &&
+            (wq->active < wq->max_active)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Wake one idle worker (critical section held)
+ */
+static void workqueue_wake_worker(void)
+{
+    uint32_t index;
+
+    if (g_wq_manager.idle_mask == 0U) {
+        return;
+    }
+
+    index = (uint32_t)__builtin_ctz(g_wq_manager.idle_mask);
+    g_wq_manager.idle_mask &= ~(1UL << index);
+    g_wq_manager.workers[index].idle = false;
+    g_wq_manager.stats.wakeups++;
+
+    if (g_wq_manager.workers[index].tcb != NULL) {
+        (void)dsrtos_state_transition(g_wq_manager.workers[index].tcb,
+                                      DSRTOS_TASK_STATE_READY);
+    }
+}
+
+/**
+ * @brief Wrap-safe tick comparison
+ * @return true if a is strictly before b
+ */
+static bool workqueue_tick_before(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b) < 0;
+}
@@ -0,0 +1,235 @@
+/*
+ * @file dsrtos_bench_arena.c
+ * @brief Per-task arena vs general heap benchmark (host port)
+ * @date 2024-12-30
+ *
+ * A task allocates a burst of small objects and then goes away. With the
+ * general heap every object is a TLSF allocation and a TLSF free; with an
+ * arena each object is a bump and the whole burst is returned in one
+ * destroy. A long-lived task allocates in between, so the benchmark also
+ * shows how much each scheme fragments the shared heap. Also checks the
+ * quota, alignment and mark/rewind behaviour.
+ */
+
+#include "dsrtos_host_port.h"
+#include "dsrtos_arena.h"
+#include "dsrtos_memory.h"
+#include "dsrtos_config.h"
+#include "dsrtos_port.h"
+#include <string.h>
+
+/*==============================================================================
+ * CONFIGURATION
+ *============================================================================*/
+
+#define BENCH_ROUNDS            (2000U)
+#define BENCH_OBJECTS           (64U)      /* Objects per short-lived task */
+#define BENCH_ARENA_QUOTA       (8192U)    /* Covers BENCH_OBJECTS worst case */
+#define BENCH_RESIDENTS         (24U)      /* Long-lived objects kept across rounds */
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+static void *g_objects[BENCH_OBJECTS];
+static void *g_residents[BENCH_RESIDENTS];
+
+/*==============================================================================
+ * HELPERS
+ *============================================================================*/
+
+/* Small kernel-object sized requests */
+static dsrtos_size_t random_size(void)
+{
+    return 8U + (dsrtos_host_rand() % 120U);
+}
+
+/* 1 - largest/free, in percent: 0 means all free space is one block */
+static uint32_t fragmentation_pct(void)
+{
+    dsrtos_memory_heap_info_t info;
+
+    HOST_CHECK(dsrtos_memory_get_heap_info(&info) == DSRTOS_SUCCESS);
+    if (info.free_size == 0U) {
+        return 0U;
+    }
+    return (uint32_t)(100U - ((info.largest_free_block * 100U) / info.free_size));
+}
+
+static void release_residents(void)
+{
+    for (uint32_t i = 0U; i < BENCH_RESIDENTS; i++) {
+        if (g_residents[i] != NULL) {
+            HOST_CHECK(dsrtos_memory_free(g_residents[i]) == DSRTOS_SUCCESS);
+            g_residents[i] = NULL;
+        }
+    }
+}
+
+/*==============================================================================
+ * FUNCTIONAL CHECKS
+ *============================================================================*/
+
+static void check_arena(void)
+{
+    dsrtos_arena_t *arena = NULL;
+    dsrtos_arena_stats_t stats;
+    dsrtos_memory_heap_info_t before;
+    dsrtos_memory_heap_info_t after;
+    dsrtos_arena_mark_t mark;
+    void *a = NULL;
+    void *b = NULL;
+    void *c = NULL;
+
+    HOST_CHECK(dsrtos_memory_get_heap_info(&before) == DSRTOS_SUCCESS);
+
+    HOST_CHECK(dsrtos_arena_create("t", 0U, &arena) == DSRTOS_ERROR_INVALID_SIZE);
+    HOST_CHECK(dsrtos_arena_create("t", DSRTOS_CONFIG_HEAP_SIZE, &arena) == DSRTOS_ERROR_INVALID_SIZE);
+    HOST_CHECK(dsrtos_arena_create("t", 100U, &arena) == DSRTOS_SUCCESS);
+
+    /* Aligned bumps, quota rounded up to the alignment */
+    HOST_CHECK(dsrtos_arena_alloc(arena, 0U, &a) == DSRTOS_ERROR_INVALID_SIZE);
+    HOST_CHECK(dsrtos_arena_alloc(arena, 3U, &a) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_arena_alloc(arena, 40U, &b) == DSRTOS_SUCCESS);
+    HOST_CHECK(((uintptr_t)a % DSRTOS_CONFIG_MEMORY_ALIGNMENT) == 0U);
+    HOST_CHECK(((uintptr_t)b % DSRTOS_CONFIG_MEMORY_ALIGNMENT) == 0U);
+    HOST_CHECK((uint8_t *)b == ((uint8_t *)a + DSRTOS_CONFIG_MEMORY_ALIGNMENT));
+
+    /* Scoped release */
+    mark = dsrtos_arena_mark(arena);
+    HOST_CHECK(dsrtos_arena_alloc(arena, 32U, &c) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_arena_rewind(arena, mark) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_arena_rewind(arena, mark + 8U) == DSRTOS_ERROR_INVALID_PARAM);
+    HOST_CHECK(dsrtos_arena_alloc(arena, 32U, &a) == DSRTOS_SUCCESS);
+    HOST_CHECK(a == c);
+
+    /* Quota */
+    HOST_CHECK(dsrtos_arena_alloc(arena, 64U, &c) == DSRTOS_ERROR_QUOTA_EXCEEDED);
+    HOST_CHECK(c == NULL);
+    HOST_CHECK(dsrtos_arena_alloc(arena, (dsrtos_size_t)-1, &c) == DSRTOS_ERROR_QUOTA_EXCEEDED);
+
+    HOST_CHECK(dsrtos_arena_get_stats(arena, &stats) == DSRTOS_SUCCESS);
+    HOST_CHECK(stats.quota >= 100U);
+    HOST_CHECK(stats.alloc_count == 4U);
+    HOST_CHECK(stats.quota_failures == 2U);
+    HOST_CHECK(stats.high_water == stats.used);
+
+    HOST_CHECK(dsrtos_arena_reset(arena) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_arena_mark(arena) == 0U);
+
+    /* One free returns everything; the stale handle is rejected */
+    HOST_CHECK(dsrtos_arena_destroy(arena) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_arena_destroy(arena) == DSRTOS_ERROR_NOT_INITIALIZED);
+    HOST_CHECK(dsrtos_memory_get_heap_info(&after) == DSRTOS_SUCCESS);
+    HOST_CHECK(after.allocated_size == before.allocated_size);
+    HOST_CHECK(after.free_blocks == before.free_blocks);
+}
+
+/*==============================================================================
+ * BENCHMARKS
+ *============================================================================*/
+
+/*
+ * Each round: a short-lived task allocates BENCH_OBJECTS objects while the
+ * long-lived task replaces one of its residents, then the short-lived task
+ * exits. Fragmentation is sampled right after the exit.
+ */
+static void bench_task_lifetimes(bool use_arena)
+{
+    dsrtos_host_sample_t alloc_sample;
+    dsrtos_host_sample_t release_sample;
+    uint64_t frag_total = 0U;
+    uint32_t frag_max = 0U;
+
+    dsrtos_host_sample_init(&alloc_sample, use_arena ? "arena alloc (per object)" :
+                                                       "heap alloc (per object)");
+    dsrtos_host_sample_init(&release_sample, use_arena ? "arena destroy (per task)" :
+                                                         "heap free all (per task)");
+    dsrtos_host_srand(0xA4E4A000U);
+
+    for (uint32_t r = 0U; r < BENCH_ROUNDS; r++) {
+        dsrtos_arena_t *arena = NULL;
+        uint32_t resident = r % BENCH_RESIDENTS;
+        uint32_t t0;
+        uint32_t t1;
+        uint32_t frag;
+
+        if (use_arena) {
+            HOST_CHECK(dsrtos_arena_create("worker", BENCH_ARENA_QUOTA, &arena) == DSRTOS_SUCCESS);
+        }
+
+        for (uint32_t i = 0U; i < BENCH_OBJECTS; i++) {
+            dsrtos_size_t size = random_size();
+            dsrtos_error_t err;
+
+            t0 = dsrtos_port_get_cycle_count();
+            if (use_arena) {
+                err = dsrtos_arena_alloc(arena, size, &g_objects[i]);
+            } else {
+                err = dsrtos_memory_allocate(size, &g_objects[i]);
+            }
+            t1 = dsrtos_port_get_cycle_count();
+            HOST_CHECK(err == DSRTOS_SUCCESS);
+            dsrtos_host_sample_add(&alloc_sample, t1 - t0);
+            (void)memset(g_objects[i], (int)i, size);
+
+            /* The long-lived task churns one resident mid-burst */
+            if (i == (BENCH_OBJECTS / 2U)) {
+                if (g_residents[resident] != NULL) {
+                    HOST_CHECK(dsrtos_memory_free(g_residents[resident]) == DSRTOS_SUCCESS);
+                }
+                HOST_CHECK(dsrtos_memory_allocate(random_size(), &g_residents[resident]) == DSRTOS_SUCCESS);
+            }
+        }
+
+        t0 = dsrtos_port_get_cycle_count();
+        if (use_arena) {
+            HOST_CHECK(dsrtos_arena_destroy(arena) == DSRTOS_SUCCESS);
+        } else {
+            for (uint32_t i = 0U; i < BENCH_OBJECTS; i++) {
+                (void)dsrtos_memory_free(g_objects[i]);
+            }
+        }
+        t1 = dsrtos_port_get_cycle_count();
+        dsrtos_host_sample_add(&release_sample, t1 - t0);
+
+        frag = fragmentation_pct();
+        frag_total += frag;
+        if (frag > frag_max) {
+            frag_max = frag;
+        }
+    }
+
+    dsrtos_host_sample_print(&alloc_sample);
+    dsrtos_host_sample_print(&release_sample);
+    (void)printf("  %-36s avg=%llu%% max=%u%%\n",
+                 use_arena ? "arena heap fragmentation" : "heap fragmentation",
+                 (unsigned long long)(frag_total / BENCH_ROUNDS), frag_max);
+
+    release_residents();
+}
+
+/*==============================================================================
+ * MAIN
+ *============================================================================*/
+
+int main(void)
+{
+    dsrtos_memory_heap_info_t info;
+
+    HOST_CHECK(dsrtos_memory_init() == DSRTOS_SUCCESS);
+
+    check_arena();
+
+    (void)printf("Arena benchmark (%u tasks x %u objects, %u long-lived, cycles)\n",
+                 BENCH_ROUNDS, BENCH_OBJECTS, BENCH_RESIDENTS);
+    bench_task_lifetimes(false);
+    bench_task_lifetimes(true);
+
+    /* Nothing leaked by either scheme */
+    HOST_CHECK(dsrtos_memory_get_heap_info(&info) == DSRTOS_SUCCESS);
+    HOST_CHECK(info.allocated_size == 0U);
+    HOST_CHECK(info.free_blocks == 1U);
+
+    return dsrtos_host_finish("dsrtos_bench_arena");
+}
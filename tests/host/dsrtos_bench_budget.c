@@ -0,0 +1,391 @@
+/*
+ * @file dsrtos_bench_budget.c
+ * @brief Execution budget enforcement: runaway task simulation (host port)
+ * @date 2024-12-30
+ *
+ * Simulates a run-to-block scheduler on a 1 kHz tick: a runaway task and
+ * a periodic worker share the same priority, and the worker needs 6 ticks
+ * of every 10-tick period. Without a budget the runaway task starves the
+ * worker. With a budget server of 3 ticks per period, whether it demotes or
+ * suspends, the runaway task gets exactly its budget at that priority and
+ * the worker meets every period. This also holds for a group of two
+ * runaway tasks sharing one server. Then times the tick enforcement path
+ * with 1 and with 8 busy servers.
+ *
+ * The ready queue is a FIFO stub ordered by effective priority; task state
+ * changes go through the real dsrtos_state_transition.
+ */
+
+#include "dsrtos_host_port.h"
+#include "dsrtos_budget.h"
+#include "dsrtos_task_state.h"
+#include "dsrtos_task_queue.h"
+#include "dsrtos_port.h"
+#include <stdio.h>
+#include <string.h>
+
+/*==============================================================================
+ * CONFIGURATION
+ *============================================================================*/
+
+#define SIM_CYCLES_PER_TICK     (168000U)
+#define SIM_PERIOD              (10U)      /* Ticks per worker and server period */
+#define SIM_PERIODS             (100U)
+#define SIM_WORK                (6U)       /* Worker ticks per period */
+#define SIM_BUDGET              (3U)       /* Runaway ticks per period */
+#define SIM_STACK_SIZE          (512U)
+
+#define BENCH_TICKS             (100000U)
+#define BENCH_TASKS             (DSRTOS_BUDGET_MAX_SERVERS * DSRTOS_BUDGET_MAX_MEMBERS)
+
+/* Simulated tasks */
+enum {
+    T_IDLE = 0,
+    T_RUNAWAY,
+    T_RUNAWAY2,
+    T_WORKER,
+    T_COUNT
+};
+
+/* Result of one scenario */
+typedef struct {
+    uint32_t worker_misses;             /* Periods the worker did not finish */
+    uint32_t runaway_high_max;          /* Most runaway ticks at its own priority in a period */
+    uint32_t runaway_ticks;             /* Runaway ticks at any priority */
+} sim_result_t;
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+static dsrtos_tcb_t g_tcbs[T_COUNT];
+static uint8_t g_stacks[T_COUNT][SIM_STACK_SIZE] __attribute__((aligned(8)));
+
+static dsrtos_tcb_t *g_ready[BENCH_TASKS];
+static uint32_t g_ready_count;
+static dsrtos_tcb_t *g_current;
+
+static uint32_t g_clock;
+static uint32_t g_sim_tick;
+static uint32_t g_worker_left;
+static uint32_t g_yields;
+
+static dsrtos_tcb_t g_bench_tcbs[BENCH_TASKS];
+
+/*==============================================================================
+ * KERNEL STUBS
+ *============================================================================*/
+
+dsrtos_error_t dsrtos_queue_ready_insert(dsrtos_tcb_t *tcb)
+{
+    if (g_ready_count >= BENCH_TASKS) {
+        return DSRTOS_ERROR_FULL;
+    }
+    g_ready[g_ready_count] = tcb;
+    g_ready_count++;
+    return DSRTOS_SUCCESS;
+}
+
+dsrtos_error_t dsrtos_queue_ready_remove(dsrtos_tcb_t *tcb)
+{
+    for (uint32_t i = 0U; i < g_ready_count; i++) {
+        if (g_ready[i] == tcb) {
+            (void)memmove(&g_ready[i], &g_ready[i + 1U], (g_ready_count - i - 1U) * sizeof(g_ready[0]));
+            g_ready_count--;
+            return DSRTOS_SUCCESS;
+        }
+    }
+    return DSRTOS_ERROR_NOT_FOUND;
+}
+
+dsrtos_error_t dsrtos_queue_blocked_insert(dsrtos_tcb_t *tcb, uint32_t timeout) { (void)tcb; (void)timeout; return DSRTOS_SUCCESS; }
+dsrtos_error_t dsrtos_queue_blocked_remove(dsrtos_tcb_t *tcb) { (void)tcb; return DSRTOS_SUCCESS; }
+dsrtos_error_t dsrtos_queue_suspended_insert(dsrtos_tcb_t *tcb) { (void)tcb; return DSRTOS_SUCCESS; }
+dsrtos_error_t dsrtos_queue_suspended_remove(dsrtos_tcb_t *tcb) { (void)tcb; return DSRTOS_SUCCESS; }
+
+void dsrtos_port_yield(void)
+{
+    g_yields++;
+}
+
+/*==============================================================================
+ * SIMULATION
+ *============================================================================*/
+
+static uint32_t fake_clock(void)
+{
+    return g_clock;
+}
+
+/* Run to block: switch only for a strictly higher ready priority */
+static void schedule(void)
+{
+    dsrtos_tcb_t *best = NULL;
+
+    for (uint32_t i = 0U; i < g_ready_count; i++) {
+        if ((best == NULL) || (g_ready[i]->effective_priority > best->effective_priority)) {
+            best = g_ready[i];
+        }
+    }
+
+    if ((best == NULL) ||
+        ((g_current != NULL) && (g_current->state == DSRTOS_TASK_STATE_RUNNING) &&
+         (g_current->effective_priority >= best->effective_priority))) {
+        return;
+    }
+
+    if ((g_current != NULL) && (g_current->state == DSRTOS_TASK_STATE_RUNNING)) {
+        HOST_CHECK(dsrtos_state_transition(g_current, DSRTOS_TASK_STATE_READY) == DSRTOS_SUCCESS);
+    }
+    HOST_CHECK(dsrtos_state_transition(best, DSRTOS_TASK_STATE_RUNNING) == DSRTOS_SUCCESS);
+    dsrtos_budget_switch(best);
+    g_current = best;
+}
+
+static void run_scenario(const char *label, bool two_runaways, sim_result_t *result)
+{
+    dsrtos_tcb_t *worker = &g_tcbs[T_WORKER];
+    uint32_t high_in_period = 0U;
+
+    (void)memset(result, 0, sizeof(*result));
+    if (two_runaways) {
+        HOST_CHECK(dsrtos_state_transition(&g_tcbs[T_RUNAWAY2], DSRTOS_TASK_STATE_READY) == DSRTOS_SUCCESS);
+    }
+
+    for (uint32_t i = 0U; i < (SIM_PERIODS * SIM_PERIOD); i++) {
+        if ((g_sim_tick % SIM_PERIOD) == 0U) {
+            if ((i != 0U) && (g_worker_left != 0U)) {
+                result->worker_misses++;
+            }
+            if (high_in_period > result->runaway_high_max) {
+                result->runaway_high_max = high_in_period;
+            }
+            high_in_period = 0U;
+            g_worker_left = SIM_WORK;
+            if (worker->state == DSRTOS_TASK_STATE_BLOCKED) {
+                HOST_CHECK(dsrtos_state_transition(worker, DSRTOS_TASK_STATE_READY) == DSRTOS_SUCCESS);
+            }
+        }
+
+        schedule();
+
+        if ((g_current == &g_tcbs[T_RUNAWAY]) || (g_current == &g_tcbs[T_RUNAWAY2])) {
+            result->runaway_ticks++;
+            if (g_current->effective_priority == DSRTOS_TASK_PRIORITY_HIGH) {
+                high_in_period++;
+            }
+        }
+        g_clock += SIM_CYCLES_PER_TICK;
+
+        if ((g_current == worker) && (g_worker_left != 0U)) {
+            g_worker_left--;
+            if (g_worker_left == 0U) {
+                HOST_CHECK(dsrtos_state_transition(worker, DSRTOS_TASK_STATE_BLOCKED) == DSRTOS_SUCCESS);
+            }
+        }
+
+        g_sim_tick++;
+        dsrtos_host_tick_advance(1U);
+    }
+
+    if (two_runaways) {
+        if (g_current == &g_tcbs[T_RUNAWAY2]) {
+            g_current = NULL;
+        }
+        HOST_CHECK(dsrtos_state_transition(&g_tcbs[T_RUNAWAY2], DSRTOS_TASK_STATE_TERMINATED) == DSRTOS_SUCCESS);
+        (void)dsrtos_queue_ready_remove(&g_tcbs[T_RUNAWAY2]);
+        g_tcbs[T_RUNAWAY2].state = DSRTOS_TASK_STATE_DORMANT;
+    }
+
+    (void)printf("  %-34s worker misses %3u/%u  runaway at HIGH <= %u ticks/period  runaway total %4u ticks\n",
+                 label, result->worker_misses, SIM_PERIODS - 1U,
+                 result->runaway_high_max, result->runaway_ticks);
+}
+
+static void create_task(uint32_t index, const char *name, dsrtos_task_priority_t priority)
+{
+    dsrtos_task_params_t params;
+
+    (void)memset(&params, 0, sizeof(params));
+    (void)strncpy(params.name, name, sizeof(params.name) - 1U);
+    params.priority = priority;
+    params.stack_buffer = g_stacks[index];
+    params.stack_size = SIM_STACK_SIZE;
+    HOST_CHECK(dsrtos_task_create_static(&g_tcbs[index], &params) == DSRTOS_SUCCESS);
+}
+
+/*==============================================================================
+ * FUNCTIONAL CHECKS
+ *============================================================================*/
+
+static void check_runaway(void)
+{
+    dsrtos_budget_config_t config;
+    dsrtos_budget_stats_t stats;
+    sim_result_t result;
+    uint32_t server;
+
+    (void)memset(&config, 0, sizeof(config));
+    config.budget_cycles = SIM_BUDGET * SIM_CYCLES_PER_TICK;
+    config.period_ticks = SIM_PERIOD;
+
+    /* Without a budget the runaway task never gives up the CPU */
+    run_scenario("no budget", false, &result);
+    HOST_CHECK(result.worker_misses == (SIM_PERIODS - 1U));
+
+    /* Demote: the runaway task keeps only the idle time beyond its budget */
+    config.action = DSRTOS_BUDGET_ACTION_DEMOTE;
+    config.name = "runaway";
+    HOST_CHECK(dsrtos_budget_server_create(&config, &server) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_budget_attach(&g_tcbs[T_RUNAWAY], server) == DSRTOS_SUCCESS);
+    run_scenario("demote, 3 of 10 ticks", false, &result);
+    HOST_CHECK(result.worker_misses == 0U);
+    HOST_CHECK(result.runaway_high_max == SIM_BUDGET);
+    HOST_CHECK(result.runaway_ticks >= (SIM_PERIODS * SIM_BUDGET));
+    HOST_CHECK(dsrtos_budget_get_stats(server, &stats) == DSRTOS_SUCCESS);
+    HOST_CHECK(stats.exhaustions == SIM_PERIODS);
+    HOST_CHECK(stats.replenishments == SIM_PERIODS);
+    HOST_CHECK(stats.consumed_cycles == ((uint64_t)result.runaway_ticks * SIM_CYCLES_PER_TICK));
+    HOST_CHECK(dsrtos_budget_server_delete(server) == DSRTOS_SUCCESS);
+    HOST_CHECK(g_tcbs[T_RUNAWAY].effective_priority == DSRTOS_TASK_PRIORITY_HIGH);
+    HOST_CHECK(g_tcbs[T_RUNAWAY].budget == NULL);
+
+    /* Suspend: the runaway task gets its budget and nothing more */
+    config.action = DSRTOS_BUDGET_ACTION_SUSPEND;
+    HOST_CHECK(dsrtos_budget_server_create(&config, &server) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_budget_attach(&g_tcbs[T_RUNAWAY], server) == DSRTOS_SUCCESS);
+    run_scenario("suspend, 3 of 10 ticks", false, &result);
+    HOST_CHECK(result.worker_misses == 0U);
+    HOST_CHECK(result.runaway_high_max == SIM_BUDGET);
+    HOST_CHECK(result.runaway_ticks == (SIM_PERIODS * SIM_BUDGET));
+    HOST_CHECK(dsrtos_budget_server_delete(server) == DSRTOS_SUCCESS);
+    HOST_CHECK(g_tcbs[T_RUNAWAY].state != DSRTOS_TASK_STATE_SUSPENDED);
+
+    /* Group: two runaway tasks share one budget */
+    config.action = DSRTOS_BUDGET_ACTION_DEMOTE;
+    config.name = "group";
+    HOST_CHECK(dsrtos_budget_server_create(&config, &server) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_budget_attach(&g_tcbs[T_RUNAWAY], server) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_budget_attach(&g_tcbs[T_RUNAWAY2], server) == DSRTOS_SUCCESS);
+    run_scenario("group of 2, demote, 3 of 10 ticks", true, &result);
+    HOST_CHECK(result.worker_misses == 0U);
+    HOST_CHECK(result.runaway_high_max == SIM_BUDGET);
+    HOST_CHECK(dsrtos_budget_detach(&g_tcbs[T_RUNAWAY2]) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_budget_get_stats(server, &stats) == DSRTOS_SUCCESS);
+    HOST_CHECK(stats.member_count == 1U);
+    HOST_CHECK(dsrtos_budget_server_delete(server) == DSRTOS_SUCCESS);
+    HOST_CHECK(g_tcbs[T_RUNAWAY].effective_priority == DSRTOS_TASK_PRIORITY_HIGH);
+    HOST_CHECK(g_tcbs[T_RUNAWAY2].effective_priority == DSRTOS_TASK_PRIORITY_HIGH);
+}
+
+static void check_errors(void)
+{
+    dsrtos_budget_config_t config;
+    uint32_t servers[DSRTOS_BUDGET_MAX_SERVERS];
+    uint32_t extra;
+
+    (void)memset(&config, 0, sizeof(config));
+    HOST_CHECK(dsrtos_budget_server_create(&config, &extra) == DSRTOS_ERROR_INVALID_PARAM);
+    config.budget_cycles = 1000U;
+    HOST_CHECK(dsrtos_budget_server_create(&config, &extra) == DSRTOS_ERROR_INVALID_PARAM);
+    config.period_ticks = 5U;
+    HOST_CHECK(dsrtos_budget_server_create(NULL, &extra) == DSRTOS_ERROR_INVALID_PARAM);
+
+    for (uint32_t i = 0U; i < DSRTOS_BUDGET_MAX_SERVERS; i++) {
+        HOST_CHECK(dsrtos_budget_server_create(&config, &servers[i]) == DSRTOS_SUCCESS);
+    }
+    HOST_CHECK(dsrtos_budget_server_create(&config, &extra) == DSRTOS_ERROR_NO_RESOURCES);
+
+    HOST_CHECK(dsrtos_budget_attach(&g_tcbs[T_IDLE], servers[0]) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_budget_attach(&g_tcbs[T_IDLE], servers[1]) == DSRTOS_ERROR_ALREADY_EXISTS);
+    HOST_CHECK(dsrtos_budget_detach(&g_tcbs[T_IDLE]) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_budget_detach(&g_tcbs[T_IDLE]) == DSRTOS_ERROR_INVALID_PARAM);
+    HOST_CHECK(dsrtos_budget_server_delete(DSRTOS_BUDGET_MAX_SERVERS) == DSRTOS_ERROR_INVALID_PARAM);
+
+    for (uint32_t i = 0U; i < DSRTOS_BUDGET_MAX_SERVERS; i++) {
+        HOST_CHECK(dsrtos_budget_server_delete(servers[i]) == DSRTOS_SUCCESS);
+    }
+    HOST_CHECK(dsrtos_budget_server_delete(servers[0]) == DSRTOS_ERROR_INVALID_PARAM);
+}
+
+/*==============================================================================
+ * BENCHMARKS
+ *============================================================================*/
+
+static void bench_tick(const char *label, uint32_t server_count)
+{
+    dsrtos_budget_config_t config;
+    dsrtos_host_sample_t sample;
+    uint32_t servers[DSRTOS_BUDGET_MAX_SERVERS];
+    uint32_t per_server = DSRTOS_BUDGET_MAX_MEMBERS;
+
+    (void)memset(&config, 0, sizeof(config));
+    config.action = DSRTOS_BUDGET_ACTION_DEMOTE;
+    config.budget_cycles = SIM_CYCLES_PER_TICK;
+
+    /* Distinct periods spread the servers over the wheel */
+    for (uint32_t s = 0U; s < server_count; s++) {
+        config.period_ticks = SIM_PERIOD + s;
+        HOST_CHECK(dsrtos_budget_server_create(&config, &servers[s]) == DSRTOS_SUCCESS);
+        for (uint32_t t = 0U; t < per_server; t++) {
+            dsrtos_tcb_t *tcb = &g_bench_tcbs[(s * per_server) + t];
+
+            tcb->state = DSRTOS_TASK_STATE_BLOCKED;
+            tcb->effective_priority = DSRTOS_TASK_PRIORITY_NORMAL;
+            HOST_CHECK(dsrtos_budget_attach(tcb, servers[s]) == DSRTOS_SUCCESS);
+        }
+    }
+
+    dsrtos_budget_switch(&g_bench_tcbs[0]);
+    dsrtos_host_sample_init(&sample, label);
+    for (uint32_t i = 0U; i < BENCH_TICKS; i++) {
+        uint32_t t0;
+        uint32_t t1;
+
+        g_clock += SIM_CYCLES_PER_TICK / 4U;
+        t0 = dsrtos_port_get_cycle_count();
+        dsrtos_budget_tick();
+        t1 = dsrtos_port_get_cycle_count();
+        dsrtos_host_sample_add(&sample, t1 - t0);
+    }
+    dsrtos_host_sample_print(&sample);
+
+    for (uint32_t s = 0U; s < server_count; s++) {
+        HOST_CHECK(dsrtos_budget_server_delete(servers[s]) == DSRTOS_SUCCESS);
+    }
+    dsrtos_budget_switch(NULL);
+}
+
+/*==============================================================================
+ * MAIN
+ *============================================================================*/
+
+int main(void)
+{
+    HOST_CHECK(dsrtos_state_init() == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_budget_init(fake_clock) == DSRTOS_SUCCESS);
+
+    create_task(T_IDLE, "idle", DSRTOS_TASK_PRIORITY_IDLE);
+    create_task(T_RUNAWAY, "runaway", DSRTOS_TASK_PRIORITY_HIGH);
+    create_task(T_RUNAWAY2, "runaway2", DSRTOS_TASK_PRIORITY_HIGH);
+    create_task(T_WORKER, "worker", DSRTOS_TASK_PRIORITY_HIGH);
+
+    /* Runaway first in line, the second runaway parked until needed */
+    (void)dsrtos_queue_ready_insert(&g_tcbs[T_RUNAWAY]);
+    (void)dsrtos_queue_ready_insert(&g_tcbs[T_WORKER]);
+    (void)dsrtos_queue_ready_insert(&g_tcbs[T_IDLE]);
+    g_tcbs[T_RUNAWAY2].state = DSRTOS_TASK_STATE_DORMANT;
+
+    (void)printf("Budget enforcement, %u periods of %u ticks, worker needs %u ticks per period\n",
+                 SIM_PERIODS, SIM_PERIOD, SIM_WORK);
+    check_runaway();
+    check_errors();
+    HOST_CHECK(g_yields > 0U);
+
+    (void)printf("Budget tick cost (%u ticks, %u tasks per server, cycles per tick)\n",
+                 BENCH_TICKS, DSRTOS_BUDGET_MAX_MEMBERS);
+    bench_tick("tick, 1 server", 1U);
+    bench_tick("tick, 8 servers", DSRTOS_BUDGET_MAX_SERVERS);
+
+    return dsrtos_host_finish("dsrtos_bench_budget");
+}
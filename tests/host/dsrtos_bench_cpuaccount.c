@@ -0,0 +1,297 @@
+/*
+ * @file dsrtos_bench_cpuaccount.c
+ * @brief Per-task CPU accounting: accuracy and switch cost (host port)
+ * @date 2024-12-30
+ *
+ * Replays 60 s of a synthetic workload at a 1 kHz tick on a fake 168 MHz
+ * cycle counter: four tasks with known CPU shares plus an idle task, run in
+ * randomly cut and shuffled slices every tick. Checks that run time is exact
+ * to the cycle across counter wrap, that the EWMA loads converge to the
+ * shares, the step response of the three windows, and that a budget
+ * overrun is raised once per period and only when the budget is exceeded.
+ * Then times dsrtos_cpu_account_switch against the real cycle counter.
+ */
+
+#include "dsrtos_host_port.h"
+#include "dsrtos_cpu_account.h"
+#include "dsrtos_port.h"
+#include <stdio.h>
+#include <string.h>
+
+/*==============================================================================
+ * CONFIGURATION
+ *============================================================================*/
+
+#define SIM_CYCLES_PER_TICK     (168000U)  /* 168 MHz, 1 kHz tick */
+#define SIM_SECONDS             (60U)
+#define SIM_TICKS               (SIM_SECONDS * 1000U)
+#define SIM_CLOCK_START         (0xFFF00000U)  /* Wraps within the first tick */
+#define SIM_CUTS                (2U)       /* Slices per task per tick */
+
+#define BUDGET_PERIOD_SAMPLES   (10U)      /* 100 ms */
+#define BUDGET_PERIOD_TICKS     (BUDGET_PERIOD_SAMPLES * DSRTOS_CPU_ACCOUNT_SAMPLE_TICKS)
+
+#define BENCH_SWITCHES          (200000U)
+#define BENCH_BATCH             (100U)
+
+/* Task IDs of the workload */
+#define TASK_IDLE               (0U)
+#define TASK_CONTROL            (1U)
+#define TASK_COMMS              (2U)
+#define TASK_LOGGER             (3U)
+#define TASK_UNTRACKED          (40U)      /* Lands in the shared slot */
+#define TASK_STEP               (5U)
+#define SIM_TASKS               (5U)
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+static uint32_t g_clock;
+
+/* CPU share of each task, per 10000 */
+static const struct {
+    uint32_t id;
+    uint32_t share_x100;
+} g_workload[SIM_TASKS] = {
+    { TASK_CONTROL,   5000U },
+    { TASK_COMMS,     2500U },
+    { TASK_LOGGER,    1000U },
+    { TASK_UNTRACKED,  500U },
+    { TASK_IDLE,      1000U }
+};
+
+static dsrtos_tcb_t g_tcbs[DSRTOS_CPU_ACCOUNT_SLOTS + 16U];
+
+static uint32_t g_overruns;
+static uint32_t g_overrun_task;
+static uint32_t g_overrun_used;
+static uint32_t g_overrun_budget;
+
+/*==============================================================================
+ * HELPERS
+ *============================================================================*/
+
+static uint32_t fake_clock(void)
+{
+    return g_clock;
+}
+
+static void count_overrun(uint32_t task_id, uint32_t used_cycles, uint32_t budget_cycles)
+{
+    g_overruns++;
+    g_overrun_task = task_id;
+    g_overrun_used = used_cycles;
+    g_overrun_budget = budget_cycles;
+}
+
+/* Switch to a task and let it run for some cycles */
+static void run(uint32_t task_id, uint32_t cycles)
+{
+    dsrtos_cpu_account_switch(&g_tcbs[task_id]);
+    g_clock += cycles;
+}
+
+/* One tick of the workload: each task's share cut into slices, shuffled */
+static void run_workload_tick(void)
+{
+    struct {
+        uint32_t id;
+        uint32_t cycles;
+    } slices[SIM_TASKS * SIM_CUTS];
+    uint32_t n = 0U;
+
+    for (uint32_t t = 0U; t < SIM_TASKS; t++) {
+        uint32_t total = (SIM_CYCLES_PER_TICK * g_workload[t].share_x100) / 10000U;
+        uint32_t cut = dsrtos_host_rand() % (total + 1U);
+
+        slices[n].id = g_workload[t].id;
+        slices[n].cycles = cut;
+        n++;
+        slices[n].id = g_workload[t].id;
+        slices[n].cycles = total - cut;
+        n++;
+    }
+    for (uint32_t i = n - 1U; i > 0U; i--) {
+        uint32_t j = dsrtos_host_rand() % (i + 1U);
+        uint32_t id = slices[i].id;
+        uint32_t cycles = slices[i].cycles;
+
+        slices[i] = slices[j];
+        slices[j].id = id;
+        slices[j].cycles = cycles;
+    }
+    for (uint32_t i = 0U; i < n; i++) {
+        run(slices[i].id, slices[i].cycles);
+    }
+    dsrtos_host_tick_advance(1U);
+}
+
+static uint32_t load_of(uint32_t task_id, uint32_t window)
+{
+    dsrtos_cpu_usage_t usage;
+
+    HOST_CHECK(dsrtos_cpu_account_get(task_id, &usage) == DSRTOS_SUCCESS);
+    return usage.load_x100[window];
+}
+
+static bool near(uint32_t value, uint32_t expected, uint32_t tolerance)
+{
+    return (value + tolerance >= expected) && (value <= expected + tolerance);
+}
+
+/*==============================================================================
+ * FUNCTIONAL CHECKS
+ *============================================================================*/
+
+static void check_workload(void)
+{
+    dsrtos_cpu_usage_t usage;
+    uint64_t total = 0U;
+
+    /* Comms fits its budget exactly, the logger overruns every period */
+    HOST_CHECK(dsrtos_cpu_account_set_budget(TASK_COMMS,
+                                             (SIM_CYCLES_PER_TICK / 4U) * BUDGET_PERIOD_TICKS,
+                                             BUDGET_PERIOD_SAMPLES) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_cpu_account_set_budget(TASK_LOGGER,
+                                             (SIM_CYCLES_PER_TICK / 11U) * BUDGET_PERIOD_TICKS,
+                                             BUDGET_PERIOD_SAMPLES) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_cpu_account_register_overrun_hook(count_overrun) == DSRTOS_SUCCESS);
+
+    for (uint32_t i = 0U; i < SIM_TICKS; i++) {
+        run_workload_tick();
+    }
+
+    (void)printf("  %-10s %14s %8s %8s %8s %9s\n",
+                 "task", "run cycles", "100ms %", "1s %", "10s %", "overruns");
+    for (uint32_t t = 0U; t < SIM_TASKS; t++) {
+        uint32_t id = g_workload[t].id;
+        uint32_t slot = (id < DSRTOS_CPU_ACCOUNT_SLOTS) ? id : DSRTOS_CPU_ACCOUNT_OTHER;
+        uint64_t expected = (uint64_t)((SIM_CYCLES_PER_TICK * g_workload[t].share_x100) / 10000U) *
+                            SIM_TICKS;
+
+        HOST_CHECK(dsrtos_cpu_account_get(slot, &usage) == DSRTOS_SUCCESS);
+        (void)printf("  %-10u %14llu %5u.%02u %5u.%02u %5u.%02u %9u\n",
+                     id, (unsigned long long)usage.run_cycles,
+                     usage.load_x100[0] / 100U, usage.load_x100[0] % 100U,
+                     usage.load_x100[1] / 100U, usage.load_x100[1] % 100U,
+                     usage.load_x100[2] / 100U, usage.load_x100[2] % 100U,
+                     usage.overruns);
+
+        /* Exact to the cycle, the counter wrapped many times */
+        HOST_CHECK(usage.run_cycles == expected);
+        total += usage.run_cycles;
+
+        /* Steady load: the short windows settle, 10 s is 6 time constants in */
+        HOST_CHECK(near(usage.load_x100[DSRTOS_CPU_WINDOW_100MS], g_workload[t].share_x100, 2U));
+        HOST_CHECK(near(usage.load_x100[DSRTOS_CPU_WINDOW_1S], g_workload[t].share_x100, 2U));
+        HOST_CHECK(near(usage.load_x100[DSRTOS_CPU_WINDOW_10S], g_workload[t].share_x100,
+                        (g_workload[t].share_x100 / 200U) + 2U));
+    }
+    HOST_CHECK(total == ((uint64_t)SIM_CYCLES_PER_TICK * SIM_TICKS));
+
+    /* One overrun per period for the logger, none for the exact fit */
+    HOST_CHECK(dsrtos_cpu_account_get(TASK_COMMS, &usage) == DSRTOS_SUCCESS);
+    HOST_CHECK(usage.overruns == 0U);
+    HOST_CHECK(dsrtos_cpu_account_get(TASK_LOGGER, &usage) == DSRTOS_SUCCESS);
+    HOST_CHECK(usage.overruns == (SIM_TICKS / BUDGET_PERIOD_TICKS));
+    HOST_CHECK(g_overruns == usage.overruns);
+    HOST_CHECK(g_overrun_task == TASK_LOGGER);
+    HOST_CHECK(g_overrun_used > g_overrun_budget);
+    HOST_CHECK(g_overrun_budget == (SIM_CYCLES_PER_TICK / 11U) * BUDGET_PERIOD_TICKS);
+}
+
+static void check_step(void)
+{
+    uint32_t l100;
+    uint32_t l1s;
+    uint32_t l10s;
+
+    /* One task takes the whole CPU for 100 ms: one short time constant */
+    for (uint32_t i = 0U; i < 100U; i++) {
+        run(TASK_STEP, SIM_CYCLES_PER_TICK);
+        dsrtos_host_tick_advance(1U);
+    }
+    l100 = load_of(TASK_STEP, DSRTOS_CPU_WINDOW_100MS);
+    l1s = load_of(TASK_STEP, DSRTOS_CPU_WINDOW_1S);
+    l10s = load_of(TASK_STEP, DSRTOS_CPU_WINDOW_10S);
+    (void)printf("  step after 100 ms: %u / %u / %u (x100 %%)\n", l100, l1s, l10s);
+    HOST_CHECK((l100 > 5800U) && (l100 < 6500U));   /* 1 - (10/11)^10 */
+    HOST_CHECK((l1s > 900U) && (l1s < 1000U));      /* 1 - (100/101)^10 */
+    HOST_CHECK((l10s > 90U) && (l10s < 110U));
+    HOST_CHECK(load_of(TASK_CONTROL, DSRTOS_CPU_WINDOW_100MS) < 2000U);
+
+    /* Ten seconds on: the 100 ms and 1 s windows saturate, 10 s is at 1 - 1/e */
+    for (uint32_t i = 100U; i < 10000U; i++) {
+        run(TASK_STEP, SIM_CYCLES_PER_TICK);
+        dsrtos_host_tick_advance(1U);
+    }
+    l100 = load_of(TASK_STEP, DSRTOS_CPU_WINDOW_100MS);
+    l1s = load_of(TASK_STEP, DSRTOS_CPU_WINDOW_1S);
+    l10s = load_of(TASK_STEP, DSRTOS_CPU_WINDOW_10S);
+    (void)printf("  step after 10 s:   %u / %u / %u (x100 %%)\n", l100, l1s, l10s);
+    HOST_CHECK(l100 >= 9998U);
+    HOST_CHECK(l1s >= 9990U);
+    HOST_CHECK((l10s > 6200U) && (l10s < 6500U));
+    HOST_CHECK(load_of(TASK_CONTROL, DSRTOS_CPU_WINDOW_1S) < 2U);
+}
+
+static void check_errors(void)
+{
+    dsrtos_cpu_usage_t usage;
+
+    HOST_CHECK(dsrtos_cpu_account_get(TASK_IDLE, NULL) == DSRTOS_ERROR_INVALID_PARAM);
+    HOST_CHECK(dsrtos_cpu_account_get(DSRTOS_CPU_ACCOUNT_OTHER + 1U, &usage) == DSRTOS_ERROR_INVALID_PARAM);
+    HOST_CHECK(dsrtos_cpu_account_set_budget(DSRTOS_CPU_ACCOUNT_SLOTS, 1000U, 1U) == DSRTOS_ERROR_INVALID_PARAM);
+    HOST_CHECK(dsrtos_cpu_account_set_budget(TASK_CONTROL, 1000U, 0U) == DSRTOS_ERROR_INVALID_PARAM);
+    HOST_CHECK(dsrtos_cpu_account_set_budget(TASK_CONTROL, 0U, 0U) == DSRTOS_SUCCESS);
+}
+
+/*==============================================================================
+ * BENCHMARKS
+ *============================================================================*/
+
+static void bench_switch(void)
+{
+    dsrtos_host_sample_t sample;
+
+    dsrtos_host_sample_init(&sample, "account switch");
+    for (uint32_t i = 0U; i < (BENCH_SWITCHES / BENCH_BATCH); i++) {
+        uint32_t t0 = dsrtos_port_get_cycle_count();
+        for (uint32_t j = 0U; j < BENCH_BATCH; j++) {
+            dsrtos_cpu_account_switch(&g_tcbs[j & 7U]);
+        }
+        uint32_t t1 = dsrtos_port_get_cycle_count();
+
+        dsrtos_host_sample_add(&sample, (t1 - t0) / BENCH_BATCH);
+    }
+    dsrtos_host_sample_print(&sample);
+}
+
+/*==============================================================================
+ * MAIN
+ *============================================================================*/
+
+int main(void)
+{
+    for (uint32_t i = 0U; i < (sizeof(g_tcbs) / sizeof(g_tcbs[0])); i++) {
+        g_tcbs[i].task_id = i;
+    }
+
+    dsrtos_host_srand(0x0C0FFEE5U);
+    g_clock = SIM_CLOCK_START;
+    HOST_CHECK(dsrtos_cpu_account_init(fake_clock) == DSRTOS_SUCCESS);
+
+    (void)printf("CPU accounting, %u s synthetic workload at 1 kHz, %u cycles per tick\n",
+                 SIM_SECONDS, SIM_CYCLES_PER_TICK);
+    check_workload();
+    check_step();
+    check_errors();
+
+    /* Timing on the real cycle counter; no ticks from here on */
+    (void)printf("CPU accounting switch cost (%u switches, cycles per switch)\n", BENCH_SWITCHES);
+    HOST_CHECK(dsrtos_cpu_account_init(NULL) == DSRTOS_SUCCESS);
+    bench_switch();
+
+    return dsrtos_host_finish("dsrtos_bench_cpuaccount");
+}
@@ -0,0 +1,399 @@
+/*
+ * @file dsrtos_bench_crashdump.c
+ * @brief Crash dump capture: LZ codec, persistent ring and capture cost (host port)
+ * @date 2024-12-30
+ *
+ * Checks the LZ codec round trip and worst-case bound, and that corrupt
+ * streams are rejected. Captures dumps of a fake faulting task, "reboots"
+ * by attaching the same region again and reads them back newest first;
+ * wraps the ring, damages records and checks only intact dumps are
+ * returned. Then times capture, worst case included, and reports the
+ * compression ratio. With an argument, writes the region image there for
+ * PY/dsrtos_crashdump_decode.py.
+ */
+
+#include "dsrtos_host_port.h"
+#include "dsrtos_crashdump.h"
+#include "dsrtos_hooks.h"
+#include "dsrtos_port.h"
+#include <stdio.h>
+#include <string.h>
+
+/*==============================================================================
+ * CONFIGURATION
+ *============================================================================*/
+
+#define BENCH_REGION_SIZE       (4096U)
+#define BENCH_STACK_WORDS       (256U)
+#define BENCH_TASKS             (6U)
+#define BENCH_CAPTURES          (2000U)
+#define BENCH_LZ_MAX            (8192U)
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+static uint32_t g_region[BENCH_REGION_SIZE / 4U];
+static uint32_t g_stack[BENCH_STACK_WORDS];
+static dsrtos_tcb_t g_tcbs[BENCH_TASKS];
+static dsrtos_panic_context_t g_panic;
+static dsrtos_crashdump_image_t g_image;
+
+static uint8_t g_lz_in[BENCH_LZ_MAX];
+static uint8_t g_lz_out[DSRTOS_LZ_BOUND(BENCH_LZ_MAX)];
+static uint8_t g_lz_back[BENCH_LZ_MAX];
+static dsrtos_lz_work_t g_lz_work;
+
+/* Link-time switch hooks, as the hook dispatcher finds them */
+extern const dsrtos_hook_static_t __start_dsrtos_hook_TASK_SWITCH_IN[] __attribute__((weak));
+extern const dsrtos_hook_static_t __stop_dsrtos_hook_TASK_SWITCH_IN[] __attribute__((weak));
+
+/*==============================================================================
+ * KERNEL STUBS
+ *============================================================================*/
+
+/* Ready queue: every task but the current one, highest priority first */
+uint32_t dsrtos_queue_ready_snapshot(dsrtos_queue_ready_entry_t *entries, uint32_t max)
+{
+    uint32_t count = 0U;
+
+    for (uint32_t i = BENCH_TASKS; (i > 1U) && (count < max); i--) {
+        entries[count].task_id = (uint16_t)g_tcbs[i - 1U].task_id;
+        entries[count].priority = (uint8_t)g_tcbs[i - 1U].effective_priority;
+        entries[count].state = (uint8_t)g_tcbs[i - 1U].state;
+        count++;
+    }
+
+    return count;
+}
+
+/*==============================================================================
+ * HELPERS
+ *============================================================================*/
+
+static void switch_to(dsrtos_tcb_t *tcb)
+{
+    for (const dsrtos_hook_static_t *h = __start_dsrtos_hook_TASK_SWITCH_IN;
+         h < __stop_dsrtos_hook_TASK_SWITCH_IN; h++) {
+        (void)h->function(DSRTOS_HOOK_TASK_SWITCH_IN, tcb);
+    }
+    dsrtos_host_set_current(tcb);
+}
+
+static void setup_tasks(void)
+{
+    static const char *const names[BENCH_TASKS] = {
+        "idle", "faulty", "comms", "logger", "control", "watchdog"
+    };
+
+    for (uint32_t i = 0U; i < BENCH_TASKS; i++) {
+        (void)memset(&g_tcbs[i], 0, sizeof(g_tcbs[i]));
+        g_tcbs[i].task_id = i;
+        (void)strncpy(g_tcbs[i].name, names[i], sizeof(g_tcbs[i].name) - 1U);
+        g_tcbs[i].effective_priority = (dsrtos_task_priority_t)(i % 5U);
+        g_tcbs[i].state = DSRTOS_TASK_STATE_READY;
+    }
+
+    /* Task 1 faults with half of its stack in use */
+    for (uint32_t i = 0U; i < BENCH_STACK_WORDS; i++) {
+        g_stack[i] = (i < (BENCH_STACK_WORDS / 2U)) ? 0xA5A5A5A5U : (0x08000100U + (i * 4U));
+    }
+    g_tcbs[1].stack_base = g_stack;
+    g_tcbs[1].stack_size = (uint32_t)sizeof(g_stack);
+    g_tcbs[1].stack_pointer = &g_stack[BENCH_STACK_WORDS / 2U];
+    g_tcbs[1].state = DSRTOS_TASK_STATE_RUNNING;
+}
+
+static void setup_panic(uint32_t line)
+{
+    (void)memset(&g_panic, 0, sizeof(g_panic));
+    g_panic.reason = DSRTOS_PANIC_USAGE_FAULT;
+    g_panic.message = "divide by zero";
+    g_panic.file = "src/app/control_loop.c";
+    g_panic.line = line;
+    for (uint32_t i = 0U; i < 17U; i++) {
+        ((uint32_t *)&g_panic.cpu_context)[i] = 0x20001000U + i;
+    }
+    g_panic.fault_status.cfsr = 0x02000000U;
+    g_panic.stack_info.sp_process = &g_stack[(BENCH_STACK_WORDS / 2U) + 8U];
+}
+
+static void check_image(const dsrtos_crashdump_image_t *image, uint32_t sequence, uint32_t line)
+{
+    const uint32_t window = (BENCH_STACK_WORDS / 2U) + 8U;
+
+    HOST_CHECK(image->sequence == sequence);
+    HOST_CHECK(image->reason == (uint16_t)DSRTOS_PANIC_USAGE_FAULT);
+    HOST_CHECK(image->line == line);
+    HOST_CHECK(strcmp(image->file, "control_loop.c") == 0);
+    HOST_CHECK(strcmp(image->message, "divide by zero") == 0);
+    HOST_CHECK(image->regs[15] == 0x2000100FU);
+    HOST_CHECK(image->fault[0] == 0x02000000U);
+    HOST_CHECK(image->task_id == 1U);
+    HOST_CHECK(strcmp(image->task_name, "faulty") == 0);
+    HOST_CHECK(image->stack_words == DSRTOS_CRASHDUMP_STACK_WORDS);
+    HOST_CHECK(memcmp(image->stack, &g_stack[window], DSRTOS_CRASHDUMP_STACK_WORDS * 4U) == 0);
+    HOST_CHECK(image->ready_count == (BENCH_TASKS - 1U));
+    HOST_CHECK(image->ready[0].task_id == (BENCH_TASKS - 1U));
+}
+
+/*==============================================================================
+ * CODEC CHECKS
+ *============================================================================*/
+
+static void lz_roundtrip(dsrtos_size_t len)
+{
+    dsrtos_size_t comp = 0U;
+    dsrtos_size_t back = 0U;
+
+    HOST_CHECK(dsrtos_lz_compress(&g_lz_work, g_lz_in, len, g_lz_out,
+                                  DSRTOS_LZ_BOUND(len), &comp) == DSRTOS_SUCCESS);
+    HOST_CHECK(comp <= DSRTOS_LZ_BOUND(len));
+    HOST_CHECK(dsrtos_lz_decompress(g_lz_out, comp, g_lz_back, len, &back) == DSRTOS_SUCCESS);
+    HOST_CHECK((back == len) && (memcmp(g_lz_in, g_lz_back, len) == 0));
+}
+
+static void check_lz(void)
+{
+    static const uint8_t bad_offset[] = { 0x00U, 0x41U, 0x80U, 0x02U, 0x00U };
+    static const uint8_t zero_offset[] = { 0x00U, 0x41U, 0x80U, 0x00U, 0x00U };
+    static const uint8_t truncated[] = { 0x05U, 0x41U, 0x42U };
+    dsrtos_size_t comp = 0U;
+    dsrtos_size_t back = 0U;
+
+    /* Runs, noise, and text-like data with repeats at every distance */
+    (void)memset(g_lz_in, 0, sizeof(g_lz_in));
+    lz_roundtrip(BENCH_LZ_MAX);
+
+    dsrtos_host_srand(91U);
+    for (uint32_t i = 0U; i < BENCH_LZ_MAX; i++) {
+        g_lz_in[i] = (uint8_t)dsrtos_host_rand();
+    }
+    for (dsrtos_size_t len = 0U; len <= 300U; len++) {
+        lz_roundtrip(len);
+    }
+    lz_roundtrip(BENCH_LZ_MAX);
+
+    /* Noise never grows past the bound, and an output one byte short fails */
+    HOST_CHECK(dsrtos_lz_compress(&g_lz_work, g_lz_in, BENCH_LZ_MAX, g_lz_out,
+                                  sizeof(g_lz_out), &comp) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_lz_compress(&g_lz_work, g_lz_in, BENCH_LZ_MAX, g_lz_out,
+                                  comp - 1U, &comp) == DSRTOS_ERROR_OVERFLOW);
+
+    for (uint32_t i = 0U; i < BENCH_LZ_MAX; i++) {
+        g_lz_in[i] = (uint8_t)("0123456789abcdef"[(i * 7U) % 16U] ^ (((i / 512U) & 1U) ? 0x20U : 0U));
+        if ((dsrtos_host_rand() % 16U) == 0U) {
+            g_lz_in[i] = (uint8_t)dsrtos_host_rand();
+        }
+    }
+    lz_roundtrip(BENCH_LZ_MAX);
+
+    /* Streams the compressor never writes */
+    HOST_CHECK(dsrtos_lz_decompress(bad_offset, sizeof(bad_offset), g_lz_back,
+                                    sizeof(g_lz_back), &back) == DSRTOS_ERROR_INVALID_FORMAT);
+    HOST_CHECK(dsrtos_lz_decompress(zero_offset, sizeof(zero_offset), g_lz_back,
+                                    sizeof(g_lz_back), &back) == DSRTOS_ERROR_INVALID_FORMAT);
+    HOST_CHECK(dsrtos_lz_decompress(truncated, sizeof(truncated), g_lz_back,
+                                    sizeof(g_lz_back), &back) == DSRTOS_ERROR_INVALID_FORMAT);
+    HOST_CHECK(dsrtos_lz_decompress(zero_offset, 2U, g_lz_back, 0U, &back) == DSRTOS_ERROR_OVERFLOW);
+}
+
+/*==============================================================================
+ * RING CHECKS
+ *============================================================================*/
+
+static void check_persistence(void)
+{
+    uint32_t region_size = (uint32_t)sizeof(g_region);
+
+    /* Garbage left in RAM at power-on is formatted away */
+    (void)memset(g_region, 0x5A, sizeof(g_region));
+    HOST_CHECK(dsrtos_crashdump_init(g_region, DSRTOS_CRASHDUMP_REGION_MIN - 4U) == DSRTOS_ERROR_INVALID_PARAM);
+    HOST_CHECK(dsrtos_crashdump_init(g_region, region_size) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_crashdump_count() == 0U);
+    HOST_CHECK(dsrtos_crashdump_read(0U, &g_image) == DSRTOS_ERROR_NOT_FOUND);
+
+    /* Task switches, then three faults */
+    for (uint32_t i = 0U; i < 100U; i++) {
+        switch_to(&g_tcbs[(i % (BENCH_TASKS - 1U)) + 1U]);
+    }
+    switch_to(&g_tcbs[1]);
+    dsrtos_crashdump_trace(DSRTOS_CRASHDUMP_EVENT_USER, 1U, 42U);
+    for (uint32_t i = 0U; i < 3U; i++) {
+        setup_panic(100U + i);
+        HOST_CHECK(dsrtos_crashdump_capture(&g_panic) == DSRTOS_SUCCESS);
+    }
+
+    /* Reset: the boot path attaches the same region again */
+    HOST_CHECK(dsrtos_crashdump_init(g_region, region_size) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_crashdump_count() == 3U);
+    for (uint32_t i = 0U; i < 3U; i++) {
+        HOST_CHECK(dsrtos_crashdump_read(i, &g_image) == DSRTOS_SUCCESS);
+        check_image(&g_image, 2U - i, 102U - i);
+    }
+    HOST_CHECK(dsrtos_crashdump_read(3U, &g_image) == DSRTOS_ERROR_NOT_FOUND);
+
+    /* The trace holds the last events, oldest first, ending with the user event */
+    HOST_CHECK(g_image.trace_count == DSRTOS_CRASHDUMP_TRACE_EVENTS);
+    HOST_CHECK(g_image.trace[DSRTOS_CRASHDUMP_TRACE_EVENTS - 1U].event == DSRTOS_CRASHDUMP_EVENT_USER);
+    HOST_CHECK(g_image.trace[DSRTOS_CRASHDUMP_TRACE_EVENTS - 1U].arg == 42U);
+    HOST_CHECK(g_image.trace[DSRTOS_CRASHDUMP_TRACE_EVENTS - 2U].event == DSRTOS_CRASHDUMP_EVENT_SWITCH);
+    HOST_CHECK(g_image.trace[DSRTOS_CRASHDUMP_TRACE_EVENTS - 2U].task_id == 1U);
+    HOST_CHECK(g_image.trace[DSRTOS_CRASHDUMP_TRACE_EVENTS - 3U].task_id == 5U);
+
+    /* A flipped payload bit drops that dump only */
+    ((uint8_t *)g_region)[20U + 16U + 10U] ^= 0x01U;
+    HOST_CHECK(dsrtos_crashdump_count() == 2U);
+    HOST_CHECK(dsrtos_crashdump_read(2U, &g_image) == DSRTOS_ERROR_NOT_FOUND);
+    HOST_CHECK(dsrtos_crashdump_read(1U, &g_image) == DSRTOS_SUCCESS);
+    check_image(&g_image, 1U, 101U);
+
+    /* No task running: the dump says so and has no stack window */
+    dsrtos_host_set_current(NULL);
+    HOST_CHECK(dsrtos_crashdump_capture(&g_panic) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_crashdump_read(0U, &g_image) == DSRTOS_SUCCESS);
+    HOST_CHECK((g_image.task_id == UINT32_MAX) && (g_image.stack_words == 0U));
+    dsrtos_host_set_current(&g_tcbs[1]);
+
+    HOST_CHECK(dsrtos_crashdump_clear() == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_crashdump_count() == 0U);
+}
+
+static void check_wrap(void)
+{
+    uint32_t count;
+    uint32_t previous = UINT32_MAX;
+
+    HOST_CHECK(dsrtos_crashdump_init(g_region, (uint32_t)sizeof(g_region)) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_crashdump_clear() == DSRTOS_SUCCESS);
+
+    for (uint32_t i = 0U; i < 50U; i++) {
+        setup_panic(i);
+        HOST_CHECK(dsrtos_crashdump_capture(&g_panic) == DSRTOS_SUCCESS);
+    }
+
+    /* Newest first, consecutive down to the oldest survivor */
+    count = dsrtos_crashdump_count();
+    HOST_CHECK((count >= 2U) && (count < 50U));
+    for (uint32_t i = 0U; i < count; i++) {
+        HOST_CHECK(dsrtos_crashdump_read(i, &g_image) == DSRTOS_SUCCESS);
+        HOST_CHECK(g_image.sequence == (49U - i));
+        HOST_CHECK((previous == UINT32_MAX) || (g_image.sequence == (previous - 1U)));
+        previous = g_image.sequence;
+    }
+
+    /* A capture cut short by reset leaves a header with a bad CRC */
+    {
+        uint32_t write_offset = g_region[3];
+        uint32_t *record = &g_region[write_offset / 4U];
+
+        record[0] = 0x43445243U;
+        record[1] = 50U;
+        record[2] = (uint32_t)sizeof(dsrtos_crashdump_image_t) | (100U << 16U);
+        record[3] = 0U;
+        HOST_CHECK(dsrtos_crashdump_init(g_region, (uint32_t)sizeof(g_region)) == DSRTOS_SUCCESS);
+        HOST_CHECK(dsrtos_crashdump_read(0U, &g_image) == DSRTOS_SUCCESS);
+        HOST_CHECK(g_image.sequence == 49U);
+    }
+
+    (void)printf("Ring: %u-byte region keeps the last %u dumps\n",
+                 (unsigned)sizeof(g_region), (unsigned)count);
+}
+
+/*==============================================================================
+ * BENCHMARK
+ *============================================================================*/
+
+static void bench_capture(void)
+{
+    dsrtos_host_sample_t capture;
+    uint64_t compressed = 0U;
+    uint32_t before = 0U;
+    uint32_t t0;
+    uint32_t t1;
+
+    dsrtos_host_sample_init(&capture, "capture (noisy stack)");
+    HOST_CHECK(dsrtos_crashdump_init(g_region, (uint32_t)sizeof(g_region)) == DSRTOS_SUCCESS);
+
+    dsrtos_host_srand(7U);
+    for (uint32_t i = 0U; i < BENCH_CAPTURES; i++) {
+        /* Incompressible stack and registers: the worst case for the codec */
+        for (uint32_t w = 0U; w < BENCH_STACK_WORDS; w++) {
+            g_stack[w] = dsrtos_host_rand();
+        }
+        setup_panic(i);
+        dsrtos_crashdump_trace((uint16_t)dsrtos_host_rand(), 1U, dsrtos_host_rand());
+
+        before = g_region[3];
+        t0 = dsrtos_port_get_cycle_count();
+        HOST_CHECK(dsrtos_crashdump_capture(&g_panic) == DSRTOS_SUCCESS);
+        t1 = dsrtos_port_get_cycle_count();
+        dsrtos_host_sample_add(&capture, t1 - t0);
+        if (g_region[3] > before) {
+            compressed += g_region[3] - before - 16U;
+        } else {
+            compressed += g_region[3] - 20U - 16U;
+        }
+    }
+    dsrtos_host_sample_print(&capture);
+    (void)printf("  image %u bytes, worst-case record %u bytes, noisy dumps average %.0f bytes\n",
+                 (unsigned)sizeof(dsrtos_crashdump_image_t),
+                 (unsigned)(DSRTOS_CRASHDUMP_REGION_MIN - 20U),
+                 (double)compressed / BENCH_CAPTURES);
+}
+
+static void report_ratio(void)
+{
+    uint32_t before;
+
+    setup_tasks();
+    switch_to(&g_tcbs[1]);
+    HOST_CHECK(dsrtos_crashdump_init(g_region, (uint32_t)sizeof(g_region)) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_crashdump_clear() == DSRTOS_SUCCESS);
+    for (uint32_t i = 0U; i < 40U; i++) {
+        switch_to(&g_tcbs[(i % (BENCH_TASKS - 1U)) + 1U]);
+    }
+    switch_to(&g_tcbs[1]);
+
+    for (uint32_t i = 0U; i < 3U; i++) {
+        before = g_region[3];
+        setup_panic(200U + i);
+        HOST_CHECK(dsrtos_crashdump_capture(&g_panic) == DSRTOS_SUCCESS);
+    }
+    (void)printf("  typical dump: %u -> %u bytes (%.1fx)\n",
+                 (unsigned)sizeof(dsrtos_crashdump_image_t), (unsigned)(g_region[3] - before - 16U),
+                 (double)sizeof(dsrtos_crashdump_image_t) / (double)(g_region[3] - before - 16U));
+}
+
+int main(int argc, char* argv[])
+{
+    HOST_CHECK(&__start_dsrtos_hook_TASK_SWITCH_IN[0] != &__stop_dsrtos_hook_TASK_SWITCH_IN[0]);
+
+    setup_tasks();
+    check_lz();
+    check_persistence();
+    check_wrap();
+
+    /* The built-in region takes the same path */
+    HOST_CHECK(dsrtos_crashdump_init(NULL, 0U) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_crashdump_clear() == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_crashdump_capture(&g_panic) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_crashdump_count() == 1U);
+
+    (void)printf("Crash dump benchmark (%u captures, %u-word stack window, %u trace events)\n",
+                 BENCH_CAPTURES, DSRTOS_CRASHDUMP_STACK_WORDS, DSRTOS_CRASHDUMP_TRACE_EVENTS);
+    bench_capture();
+    report_ratio();
+
+    if (argc > 1) {
+        FILE* file = fopen(argv[1], "wb");
+
+        HOST_CHECK(file != NULL);
+        if (file != NULL) {
+            HOST_CHECK(fwrite(g_region, 1U, sizeof(g_region), file) == sizeof(g_region));
+            (void)fclose(file);
+        }
+    }
+
+    return dsrtos_host_finish("dsrtos_bench_crashdump");
+}
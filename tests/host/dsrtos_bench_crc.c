@@ -0,0 +1,205 @@
+/*
+ * @file dsrtos_bench_crc.c
+ * @brief Shared CRC-32 vs the private checksum loops it replaces (host port)
+ * @date 2024-12-30
+ *
+ * Checks dsrtos_crc32 against the CRC-32 check value and a bitwise
+ * reference over every length and alignment up to 300 bytes, and checks
+ * that an incremental update split at any point gives the same value.
+ * Then it measures bytes per cycle at kernel structure sizes. It compares
+ * the rotate-XOR byte loop from the kernel, scheduler and heap integrity
+ * checks, the bitwise CRC-32 from the crash dump, a one-table byte CRC-32
+ * and the slicing-by-8 backend.
+ */
+
+#include "dsrtos_host_port.h"
+#include "dsrtos_crc.h"
+#include "dsrtos_port.h"
+#include <stdio.h>
+#include <string.h>
+
+/*==============================================================================
+ * CONFIGURATION
+ *============================================================================*/
+
+#define BENCH_BUFFER            (4096U + 8U)
+#define BENCH_CHECK_LEN         (300U)
+#define BENCH_ROUNDS            (2000U)
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+static const uint32_t g_sizes[] = { 16U, 64U, 256U, 1024U, 4096U };
+
+static uint8_t g_data[BENCH_BUFFER];
+static uint32_t g_table[256];
+static volatile uint32_t g_sink;
+
+/*==============================================================================
+ * BASELINES
+ *============================================================================*/
+
+/* The loop each integrity check used to carry */
+static uint32_t rotate_xor(const void *data, dsrtos_size_t size)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    uint32_t checksum = 0x12345678U;
+
+    for (dsrtos_size_t i = 0U; i < size; i++) {
+        checksum ^= bytes[i];
+        checksum = (checksum << 1) | (checksum >> 31);
+    }
+
+    return checksum;
+}
+
+/* The crash dump's CRC-32, also the reference */
+static uint32_t crc_bitwise(const void *data, dsrtos_size_t size)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    uint32_t crc = 0xFFFFFFFFU;
+
+    for (dsrtos_size_t i = 0U; i < size; i++) {
+        crc ^= bytes[i];
+        for (uint32_t bit = 0U; bit < 8U; bit++) {
+            crc = (crc >> 1U) ^ (0xEDB88320U & (0U - (crc & 1U)));
+        }
+    }
+
+    return ~crc;
+}
+
+static uint32_t crc_bytewise(const void *data, dsrtos_size_t size)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    uint32_t crc = 0xFFFFFFFFU;
+
+    for (dsrtos_size_t i = 0U; i < size; i++) {
+        crc = g_table[(crc ^ bytes[i]) & 0xFFU] ^ (crc >> 8U);
+    }
+
+    return ~crc;
+}
+
+static void table_init(void)
+{
+    for (uint32_t i = 0U; i < 256U; i++) {
+        uint32_t crc = i;
+        for (uint32_t bit = 0U; bit < 8U; bit++) {
+            crc = (crc >> 1U) ^ (0xEDB88320U & (0U - (crc & 1U)));
+        }
+        g_table[i] = crc;
+    }
+}
+
+/*==============================================================================
+ * CHECKS
+ *============================================================================*/
+
+static void check_values(void)
+{
+    static const char check_input[] = "123456789";
+    uint32_t whole;
+    uint32_t split;
+
+    HOST_CHECK(dsrtos_crc32(check_input, 9U) == 0xCBF43926U);
+    HOST_CHECK(crc_bytewise(check_input, 9U) == 0xCBF43926U);
+    HOST_CHECK(dsrtos_crc32(NULL, 16U) == DSRTOS_CRC32_INIT);
+    HOST_CHECK(dsrtos_crc32(check_input, 0U) == DSRTOS_CRC32_INIT);
+    HOST_CHECK(dsrtos_crc32_update(0x1234U, NULL, 4U) == 0x1234U);
+
+    /* Every length at every alignment against the reference */
+    for (uint32_t align = 0U; align < 8U; align++) {
+        for (uint32_t len = 0U; len <= BENCH_CHECK_LEN; len++) {
+            HOST_CHECK(dsrtos_crc32(&g_data[align], len) == crc_bitwise(&g_data[align], len));
+        }
+    }
+
+    /* Incremental: any split, and byte by byte */
+    whole = dsrtos_crc32(g_data, BENCH_CHECK_LEN);
+    for (uint32_t cut = 0U; cut <= BENCH_CHECK_LEN; cut++) {
+        split = dsrtos_crc32_update(dsrtos_crc32(g_data, cut), &g_data[cut], BENCH_CHECK_LEN - cut);
+        HOST_CHECK(split == whole);
+    }
+    split = DSRTOS_CRC32_INIT;
+    for (uint32_t i = 0U; i < BENCH_CHECK_LEN; i++) {
+        split = dsrtos_crc32_update(split, &g_data[i], 1U);
+    }
+    HOST_CHECK(split == whole);
+}
+
+/*==============================================================================
+ * BENCHMARK
+ *============================================================================*/
+
+/* Best-case cycles of one call, the steady state without preemption noise */
+static uint32_t measure(uint32_t (*fn)(const void *, dsrtos_size_t), uint32_t size)
+{
+    uint32_t best = UINT32_MAX;
+    uint32_t start;
+    uint32_t cycles;
+
+    for (uint32_t round = 0U; round < BENCH_ROUNDS; round++) {
+        start = dsrtos_port_get_cycle_count();
+        g_sink = fn(&g_data[round & 3U], size);
+        cycles = dsrtos_port_get_cycle_count() - start;
+        best = (cycles < best) ? cycles : best;
+    }
+
+    return best;
+}
+
+static void bench_throughput(void)
+{
+    static const struct {
+        const char *name;
+        uint32_t (*fn)(const void *, dsrtos_size_t);
+    } variants[] = {
+        { "rotate-xor loop", rotate_xor },
+        { "bitwise crc32", crc_bitwise },
+        { "byte-table crc32", crc_bytewise },
+        { "dsrtos_crc32", dsrtos_crc32 }
+    };
+    const uint32_t count = (uint32_t)(sizeof(variants) / sizeof(variants[0]));
+    uint32_t old_cycles;
+    uint32_t new_cycles;
+
+    (void)printf("  %-18s", "bytes/cycle");
+    for (uint32_t s = 0U; s < (sizeof(g_sizes) / sizeof(g_sizes[0])); s++) {
+        (void)printf("%9u B", g_sizes[s]);
+    }
+    (void)printf("\n");
+
+    for (uint32_t v = 0U; v < count; v++) {
+        (void)printf("  %-18s", variants[v].name);
+        for (uint32_t s = 0U; s < (sizeof(g_sizes) / sizeof(g_sizes[0])); s++) {
+            (void)printf("%11.3f", (double)g_sizes[s] / (double)measure(variants[v].fn, g_sizes[s]));
+        }
+        (void)printf("\n");
+    }
+
+    /* A real CRC, and still faster than the rotate loop from 64 bytes up */
+    for (uint32_t s = 1U; s < (sizeof(g_sizes) / sizeof(g_sizes[0])); s++) {
+        old_cycles = measure(rotate_xor, g_sizes[s]);
+        new_cycles = measure(dsrtos_crc32, g_sizes[s]);
+        HOST_CHECK(new_cycles < old_cycles);
+    }
+    HOST_CHECK(measure(dsrtos_crc32, 4096U) < measure(crc_bitwise, 4096U) / 8U);
+}
+
+int main(void)
+{
+    dsrtos_host_srand(0x0C0FFEE1U);
+    for (uint32_t i = 0U; i < BENCH_BUFFER; i++) {
+        g_data[i] = (uint8_t)dsrtos_host_rand();
+    }
+    table_init();
+
+    check_values();
+
+    (void)printf("CRC benchmark (best of %u calls, cycles)\n", BENCH_ROUNDS);
+    bench_throughput();
+
+    return dsrtos_host_finish("dsrtos_bench_crc");
+}
@@ -0,0 +1,438 @@
+/*
+ * @file dsrtos_bench_handle.c
+ * @brief Generation-counted handle vs magic/checksum validation benchmark (host port)
+ * @date 2024-12-30
+ *
+ * Kernel objects were validated by reading them: a magic number at each
+ * end and a CRC over the fields fixed while queued, as the phase 4 queue
+ * node still does in the STANDARD and FULL profiles. Task IDs had no index
+ * and were found by walking the tasks. The reference object below keeps
+ * that layout so both schemes can be timed on the same random accesses.
+ * Also checks handle issue order, stale and foreign handles, generation
+ * wrap, table exhaustion, and task handles through create and release,
+ * and prints the queue node bytes the current profile saves.
+ */
+
+#include "dsrtos_host_port.h"
+#include "dsrtos_handle.h"
+#include "dsrtos_task_creation.h"
+#include "dsrtos_task_scheduler_interface.h"
+#include "dsrtos_crc.h"
+#include "dsrtos_memory.h"
+#include "dsrtos_port.h"
+#include <string.h>
+
+/*==============================================================================
+ * CONFIGURATION
+ *============================================================================*/
+
+#define BENCH_OBJECTS           (4096U)
+#define BENCH_ROUNDS            (20000U)
+#define BENCH_STACK_SIZE        (512U)
+#define BENCH_NODE_MAGIC        (0xA5C3U)
+
+/* The phase 4 queue node with every integrity word (STANDARD and FULL) */
+typedef struct legacy_node {
+    uint16_t magic_start;
+    dsrtos_tcb_t *task;
+    struct legacy_node *next;
+    struct legacy_node *prev;
+    uint32_t insertion_tick;
+    uint32_t checksum;
+    uint16_t magic_end;
+} legacy_node_t;
+
+typedef struct {
+    legacy_node_t node;
+    uint32_t id;                        /* For the ID scan */
+} bench_object_t;
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+static bench_object_t g_objects[BENCH_OBJECTS];
+static dsrtos_handle_slot_t g_slots[BENCH_OBJECTS];
+static dsrtos_handle_table_t g_table;
+static dsrtos_handle_t g_handles[BENCH_OBJECTS];
+static volatile uintptr_t g_sink;
+
+/*==============================================================================
+ * KERNEL STUBS
+ *============================================================================*/
+
+/* No budget servers here */
+dsrtos_error_t dsrtos_budget_detach(dsrtos_tcb_t *tcb)
+{
+    (void)tcb;
+    return DSRTOS_SUCCESS;
+}
+
+/*==============================================================================
+ * REFERENCE: MAGIC AND CHECKSUM
+ *============================================================================*/
+
+static uint32_t legacy_checksum(const legacy_node_t *node)
+{
+    uint32_t crc = dsrtos_crc32(&node->task, sizeof(node->task));
+
+    return dsrtos_crc32_update(crc, &node->insertion_tick, sizeof(node->insertion_tick));
+}
+
+static bool legacy_validate(const legacy_node_t *node)
+{
+    return (node->magic_start == BENCH_NODE_MAGIC) &&
+           (node->magic_end == BENCH_NODE_MAGIC) &&
+           (node->task != NULL) &&
+           (legacy_checksum(node) == node->checksum);
+}
+
+static bench_object_t *scan_by_id(uint32_t id)
+{
+    for (uint32_t i = 0U; i < BENCH_OBJECTS; i++) {
+        if (g_objects[i].id == id) {
+            return &g_objects[i];
+        }
+    }
+    return NULL;
+}
+
+/*==============================================================================
+ * HELPERS
+ *============================================================================*/
+
+static void task_entry(void *param)
+{
+    (void)param;
+}
+
+static dsrtos_tcb_t *create(void)
+{
+    dsrtos_task_create_extended_t params;
+
+    (void)memset(&params, 0, sizeof(params));
+    (void)strncpy(params.base.name, "handle", DSRTOS_TASK_NAME_MAX_LENGTH - 1U);
+    params.base.entry_point = task_entry;
+    params.base.priority = DSRTOS_TASK_PRIORITY_NORMAL;
+    params.base.stack_size = BENCH_STACK_SIZE;
+
+    return dsrtos_task_create_extended(&params);
+}
+
+static void destroy(dsrtos_tcb_t *tcb)
+{
+    HOST_CHECK(dsrtos_task_delete(tcb) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_task_release(tcb) == DSRTOS_SUCCESS);
+}
+
+/*==============================================================================
+ * FUNCTIONAL CHECKS
+ *============================================================================*/
+
+static void check_table(void)
+{
+    static dsrtos_handle_slot_t slots[4];
+    static dsrtos_handle_slot_t other_slots[4];
+    dsrtos_handle_table_t table;
+    dsrtos_handle_table_t other;
+    dsrtos_handle_stats_t stats;
+    dsrtos_handle_t h[5];
+    dsrtos_handle_t first;
+    dsrtos_handle_t again;
+    dsrtos_handle_t forged;
+    uint32_t objects[5];
+
+    HOST_CHECK(dsrtos_handle_table_init(&table, "t", DSRTOS_HANDLE_TYPE_MUTEX, slots, 0U) ==
+               DSRTOS_ERROR_INVALID_SIZE);
+    HOST_CHECK(dsrtos_handle_table_init(&table, "t", DSRTOS_HANDLE_TYPE_NONE, slots, 4U) ==
+               DSRTOS_ERROR_INVALID_PARAM);
+    HOST_CHECK(dsrtos_handle_table_init(&table, "t", DSRTOS_HANDLE_TYPE_MUTEX, slots, 4U) ==
+               DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_handle_table_init(&other, "o", DSRTOS_HANDLE_TYPE_TIMER, other_slots, 4U) ==
+               DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_handle_alloc(&table, NULL) == DSRTOS_HANDLE_INVALID);
+
+    /* Ascending slots from a fresh table, INVALID once full */
+    for (uint32_t i = 0U; i < 5U; i++) {
+        h[i] = dsrtos_handle_alloc(&table, &objects[i]);
+    }
+    for (uint32_t i = 0U; i < 4U; i++) {
+        HOST_CHECK(DSRTOS_HANDLE_INDEX(h[i]) == i);
+        HOST_CHECK(DSRTOS_HANDLE_TYPE(h[i]) == DSRTOS_HANDLE_TYPE_MUTEX);
+        HOST_CHECK(dsrtos_handle_lookup(&table, h[i]) == &objects[i]);
+        HOST_CHECK(dsrtos_handle_lookup_index(&table, i) == &objects[i]);
+    }
+    HOST_CHECK(h[4] == DSRTOS_HANDLE_INVALID);
+    HOST_CHECK(dsrtos_handle_lookup(&table, DSRTOS_HANDLE_INVALID) == NULL);
+
+    /* Another table's handle, an out-of-range index and a stale handle */
+    HOST_CHECK(dsrtos_handle_lookup(&other, h[0]) == NULL);
+    HOST_CHECK(dsrtos_handle_free(&other, h[0]) == DSRTOS_ERROR_INVALID_HANDLE);
+    HOST_CHECK(dsrtos_handle_lookup(&table, h[0] | 0x00FFU) == NULL);
+    HOST_CHECK(dsrtos_handle_free(&table, h[1]) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_handle_lookup(&table, h[1]) == NULL);
+    HOST_CHECK(dsrtos_handle_lookup_index(&table, 1U) == NULL);
+    HOST_CHECK(dsrtos_handle_free(&table, h[1]) == DSRTOS_ERROR_INVALID_HANDLE);
+
+    /* A forged type-NONE handle matching the free slot's tag resolves to nothing */
+    forged = ((DSRTOS_HANDLE_TAG(h[1]) + 1U) & DSRTOS_HANDLE_GENERATION_MASK) << 16;
+    forged |= 1U;
+    HOST_CHECK(dsrtos_handle_lookup(&table, forged) == NULL);
+    HOST_CHECK(dsrtos_handle_free(&table, forged) == DSRTOS_ERROR_INVALID_HANDLE);
+
+    /* Oldest free slot first; the reissued slot carries a new generation */
+    HOST_CHECK(dsrtos_handle_free(&table, h[2]) == DSRTOS_SUCCESS);
+    again = dsrtos_handle_alloc(&table, &objects[4]);
+    HOST_CHECK(DSRTOS_HANDLE_INDEX(again) == 1U);
+    HOST_CHECK(again != h[1]);
+    HOST_CHECK(dsrtos_handle_lookup(&table, h[1]) == NULL);
+    HOST_CHECK(dsrtos_handle_lookup(&table, again) == &objects[4]);
+
+    HOST_CHECK(dsrtos_handle_get_stats(&table, &stats) == DSRTOS_SUCCESS);
+    HOST_CHECK(stats.capacity == 4U);
+    HOST_CHECK(stats.used == 3U);
+    HOST_CHECK(stats.high_water == 4U);
+    HOST_CHECK(stats.alloc_count == 5U);
+    HOST_CHECK(stats.free_count == 2U);
+    HOST_CHECK(stats.alloc_failures == 1U);
+    HOST_CHECK(stats.stale_frees == 2U);
+
+    /* One slot reissued until its generation wraps back to the first handle */
+    HOST_CHECK(dsrtos_handle_table_init(&table, "w", DSRTOS_HANDLE_TYPE_QUEUE, slots, 1U) ==
+               DSRTOS_SUCCESS);
+    first = dsrtos_handle_alloc(&table, &objects[0]);
+    again = first;
+    for (uint32_t i = 0U; i < DSRTOS_HANDLE_GENERATION_MASK; i++) {
+        HOST_CHECK(dsrtos_handle_free(&table, again) == DSRTOS_SUCCESS);
+        again = dsrtos_handle_alloc(&table, &objects[0]);
+        HOST_CHECK(again != first);
+        HOST_CHECK(dsrtos_handle_lookup(&table, first) == NULL);
+    }
+    HOST_CHECK(dsrtos_handle_free(&table, again) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_handle_alloc(&table, &objects[0]) == first);
+}
+
+static void check_tasks(void)
+{
+    static dsrtos_tcb_t *tasks[DSRTOS_MAX_TASKS];
+    static dsrtos_tcb_t static_task;
+    static uint8_t static_stack[BENCH_STACK_SIZE] __attribute__((aligned(8)));
+    dsrtos_task_params_t static_params;
+    dsrtos_handle_stats_t stats;
+    dsrtos_tcb_t *tcb;
+    dsrtos_tcb_t *clone;
+    dsrtos_handle_t old_handle;
+    uint32_t old_id;
+
+    /* Tasks past the 32 pooled TCBs come from the kernel heap */
+    HOST_CHECK(dsrtos_memory_init() == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_task_creation_init() == DSRTOS_SUCCESS);
+
+    /* Every task is named by a handle whose index is its ID */
+    for (uint32_t i = 0U; i < DSRTOS_MAX_TASKS; i++) {
+        tasks[i] = create();
+        HOST_CHECK(tasks[i] != NULL);
+        HOST_CHECK(tasks[i]->task_id == i);
+        HOST_CHECK(DSRTOS_HANDLE_TYPE(tasks[i]->handle) == DSRTOS_HANDLE_TYPE_TASK);
+        HOST_CHECK(dsrtos_task_from_handle(tasks[i]->handle) == tasks[i]);
+        HOST_CHECK(dsrtos_task_get_by_id(i) == tasks[i]);
+    }
+
+    /* No ID left: creation fails cleanly, clones too */
+    HOST_CHECK(create() == NULL);
+    HOST_CHECK(dsrtos_task_clone(tasks[0], "clone") == NULL);
+    HOST_CHECK(dsrtos_task_get_by_id(DSRTOS_MAX_TASKS) == NULL);
+
+    /* Released: the old handle and ID stop resolving */
+    old_handle = tasks[3]->handle;
+    old_id = tasks[3]->task_id;
+    destroy(tasks[3]);
+    HOST_CHECK(dsrtos_task_from_handle(old_handle) == NULL);
+    HOST_CHECK(dsrtos_task_get_by_id(old_id) == NULL);
+
+    /* The freed ID is reused with a new generation */
+    clone = dsrtos_task_clone(tasks[0], "clone");
+    HOST_CHECK(clone != NULL);
+    HOST_CHECK(clone->task_id == old_id);
+    HOST_CHECK(clone->handle != old_handle);
+    HOST_CHECK(dsrtos_task_from_handle(old_handle) == NULL);
+    HOST_CHECK(dsrtos_task_from_handle(clone->handle) == clone);
+    tasks[3] = clone;
+
+    for (uint32_t i = 0U; i < DSRTOS_MAX_TASKS; i++) {
+        tcb = tasks[i];
+        old_handle = tcb->handle;
+        destroy(tcb);
+        HOST_CHECK(dsrtos_task_from_handle(old_handle) == NULL);
+    }
+
+    HOST_CHECK(dsrtos_task_handle_get_stats(&stats) == DSRTOS_SUCCESS);
+    HOST_CHECK(stats.used == 0U);
+    HOST_CHECK(stats.high_water == DSRTOS_MAX_TASKS);
+    HOST_CHECK(stats.alloc_failures == 2U);
+    HOST_CHECK(stats.stale_frees == 0U);
+
+    /* The phase 3 creation path, not a host stub: statically created
+     * tasks, like the init task, draw from the same IDs */
+    (void)memset(&static_params, 0, sizeof(static_params));
+    (void)strncpy(static_params.name, "static", DSRTOS_TASK_NAME_MAX_LENGTH - 1U);
+    static_params.entry_point = task_entry;
+    static_params.priority = DSRTOS_TASK_PRIORITY_NORMAL;
+    static_params.stack_size = sizeof(static_stack);
+    static_params.stack_buffer = static_stack;
+    HOST_CHECK(dsrtos_task_create_static(&static_task, &static_params) == DSRTOS_SUCCESS);
+    HOST_CHECK(static_task.task_id < DSRTOS_MAX_TASKS);
+    HOST_CHECK(dsrtos_task_get_by_id(static_task.task_id) == &static_task);
+    HOST_CHECK(dsrtos_task_from_handle(static_task.handle) == &static_task);
+    HOST_CHECK(dsrtos_task_validate_tcb(&static_task) == DSRTOS_SUCCESS);
+    HOST_CHECK(static_task.state == DSRTOS_TASK_STATE_READY);
+
+    /* So do tasks from the task manager's create call */
+    static_params.stack_buffer = NULL;
+    HOST_CHECK(dsrtos_task_create(&tcb, &static_params) == DSRTOS_SUCCESS);
+    HOST_CHECK(tcb->task_id != static_task.task_id);
+    HOST_CHECK(dsrtos_task_get_by_id(tcb->task_id) == tcb);
+    destroy(tcb);
+    HOST_CHECK(dsrtos_task_get_by_id(static_task.task_id) == &static_task);
+}
+
+/*==============================================================================
+ * BENCHMARKS
+ *============================================================================*/
+
+static void setup_objects(void)
+{
+    HOST_CHECK(dsrtos_handle_table_init(&g_table, "bench", DSRTOS_HANDLE_TYPE_QUEUE,
+                                        g_slots, BENCH_OBJECTS) == DSRTOS_SUCCESS);
+    for (uint32_t i = 0U; i < BENCH_OBJECTS; i++) {
+        legacy_node_t *node = &g_objects[i].node;
+
+        node->magic_start = BENCH_NODE_MAGIC;
+        node->magic_end = BENCH_NODE_MAGIC;
+        node->task = (dsrtos_tcb_t *)(uintptr_t)(0x1000U + (i * 64U));
+        node->insertion_tick = i;
+        node->checksum = legacy_checksum(node);
+        g_handles[i] = dsrtos_handle_alloc(&g_table, &g_objects[i]);
+        g_objects[i].id = DSRTOS_HANDLE_INDEX(g_handles[i]);
+    }
+}
+
+/*
+ * Resolve a random object per round through each scheme. The handle paths
+ * touch one 8-byte slot; validation reads both ends of the object and
+ * hashes it; the ID scan walks objects until the ID matches.
+ */
+static void bench_resolve(void)
+{
+    dsrtos_host_sample_t by_handle;
+    dsrtos_host_sample_t by_index;
+    dsrtos_host_sample_t by_validate;
+    dsrtos_host_sample_t by_scan;
+    dsrtos_host_sample_t stale;
+    uint32_t t0;
+    uint32_t t1;
+
+    dsrtos_host_sample_init(&by_handle, "handle lookup");
+    dsrtos_host_sample_init(&by_index, "ID lookup, handle table");
+    dsrtos_host_sample_init(&by_validate, "magic + checksum validate");
+    dsrtos_host_sample_init(&by_scan, "ID lookup, linear scan");
+    dsrtos_host_sample_init(&stale, "stale handle reject");
+
+    dsrtos_host_srand(0x4E444C00U);
+    for (uint32_t r = 0U; r < BENCH_ROUNDS; r++) {
+        uint32_t i = dsrtos_host_rand() % BENCH_OBJECTS;
+        void *object;
+
+        t0 = dsrtos_port_get_cycle_count();
+        object = dsrtos_handle_lookup(&g_table, g_handles[i]);
+        t1 = dsrtos_port_get_cycle_count();
+        dsrtos_host_sample_add(&by_handle, t1 - t0);
+        HOST_CHECK(object == &g_objects[i]);
+
+        i = dsrtos_host_rand() % BENCH_OBJECTS;
+        t0 = dsrtos_port_get_cycle_count();
+        object = dsrtos_handle_lookup_index(&g_table, i);
+        t1 = dsrtos_port_get_cycle_count();
+        dsrtos_host_sample_add(&by_index, t1 - t0);
+        HOST_CHECK(object == &g_objects[i]);
+
+        i = dsrtos_host_rand() % BENCH_OBJECTS;
+        t0 = dsrtos_port_get_cycle_count();
+        g_sink = legacy_validate(&g_objects[i].node) ? 1U : 0U;
+        t1 = dsrtos_port_get_cycle_count();
+        dsrtos_host_sample_add(&by_validate, t1 - t0);
+        HOST_CHECK(g_sink == 1U);
+
+        i = dsrtos_host_rand() % BENCH_OBJECTS;
+        t0 = dsrtos_port_get_cycle_count();
+        object = scan_by_id(i);
+        t1 = dsrtos_port_get_cycle_count();
+        dsrtos_host_sample_add(&by_scan, t1 - t0);
+        HOST_CHECK(object == &g_objects[i]);
+    }
+
+    /* Retire every handle: each copy is rejected without touching its object */
+    for (uint32_t i = 0U; i < BENCH_OBJECTS; i++) {
+        HOST_CHECK(dsrtos_handle_free(&g_table, g_handles[i]) == DSRTOS_SUCCESS);
+    }
+    for (uint32_t r = 0U; r < BENCH_ROUNDS; r++) {
+        uint32_t i = dsrtos_host_rand() % BENCH_OBJECTS;
+        void *object;
+
+        t0 = dsrtos_port_get_cycle_count();
+        object = dsrtos_handle_lookup(&g_table, g_handles[i]);
+        t1 = dsrtos_port_get_cycle_count();
+        dsrtos_host_sample_add(&stale, t1 - t0);
+        HOST_CHECK(object == NULL);
+    }
+
+    (void)printf("Object resolution (%u objects, %u random rounds, cycles)\n",
+                 BENCH_OBJECTS, BENCH_ROUNDS);
+    dsrtos_host_sample_print(&by_handle);
+    dsrtos_host_sample_print(&by_index);
+    dsrtos_host_sample_print(&by_validate);
+    dsrtos_host_sample_print(&by_scan);
+    dsrtos_host_sample_print(&stale);
+}
+
+/*
+ * Bytes per queue node in this profile against the node with every
+ * integrity word, and what a handle slot costs per object instead.
+ */
+static void report_memory(void)
+{
+    uint32_t node_bytes = (uint32_t)sizeof(dsrtos_queue_node_t);
+    uint32_t legacy_bytes = (uint32_t)sizeof(legacy_node_t);
+    uint32_t saved = legacy_bytes - node_bytes;
+
+    (void)printf("Queue node memory (safety profile %u, %u tasks)\n",
+                 (unsigned)DSRTOS_CONFIG_SAFETY_PROFILE, (unsigned)DSRTOS_MAX_TASKS);
+    (void)printf("  %-36s %u bytes\n", "node with magic + checksum", legacy_bytes);
+    (void)printf("  %-36s %u bytes\n", "node in this profile", node_bytes);
+    (void)printf("  %-36s %u bytes/node, %u bytes at DSRTOS_MAX_TASKS\n", "saved",
+                 saved, saved * (uint32_t)DSRTOS_MAX_TASKS);
+    (void)printf("  %-36s %u bytes/object\n", "handle slot",
+                 (uint32_t)sizeof(dsrtos_handle_slot_t));
+
+#if (DSRTOS_CONFIG_ENABLE_MAGIC_CHECKING == 0U) && (DSRTOS_CONFIG_ENABLE_CHECKSUM_VALIDATION == 0U)
+    HOST_CHECK(node_bytes < legacy_bytes);
+#else
+    HOST_CHECK(node_bytes <= legacy_bytes);
+#endif
+}
+
+/*==============================================================================
+ * MAIN
+ *============================================================================*/
+
+int main(void)
+{
+    check_table();
+    check_tasks();
+
+    setup_objects();
+    bench_resolve();
+    report_memory();
+
+    return dsrtos_host_finish("dsrtos_bench_handle");
+}
@@ -0,0 +1,273 @@
+/*
+ * @file dsrtos_bench_heapprof.c
+ * @brief Heap profiler accounting, trace export and overhead (host port)
+ * @date 2024-12-30
+ *
+ * Built with DSRTOS_CONFIG_MEMORY_PROFILE and a trace ring. Several fake
+ * tasks allocate through the TLSF heap; one leaks. Checks per-owner
+ * accounting, the fragmentation index and the exported trace, then
+ * writes the trace to heap_trace.bin in the build directory for
+ * PY/dsrtos_heap_replay.py. Allocate/free cost is printed for comparison
+ * with dsrtos_bench_memory, which is built with profiling off.
+ */
+
+#include "dsrtos_host_port.h"
+#include "dsrtos_memory.h"
+#include "dsrtos_config.h"
+#include "dsrtos_port.h"
+#include <string.h>
+
+#if (DSRTOS_CONFIG_MEMORY_PROFILE == 0U) || (DSRTOS_CONFIG_MEMORY_TRACE_DEPTH == 0U)
+#error "dsrtos_bench_heapprof needs DSRTOS_CONFIG_MEMORY_PROFILE and a trace ring"
+#endif
+
+/*==============================================================================
+ * CONFIGURATION
+ *============================================================================*/
+
+#define BENCH_TASKS             (4U)
+#define BENCH_OBJECTS           (32U)
+#define BENCH_LEAKS             (5U)
+#define BENCH_TIMED_OPS         (100000U)
+
+/* Set by the Makefile to the build directory in use */
+#ifndef BENCH_TRACE_FILE
+#define BENCH_TRACE_FILE        "heap_trace.bin"
+#endif
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+static uint32_t g_current_task = DSRTOS_MEMORY_OWNER_NONE;
+static void *g_objects[BENCH_TASKS][BENCH_OBJECTS];
+static uint8_t g_export[sizeof(dsrtos_memory_trace_header_t) +
+                        (DSRTOS_CONFIG_MEMORY_TRACE_DEPTH * sizeof(dsrtos_memory_trace_record_t))];
+
+/*==============================================================================
+ * HELPERS
+ *============================================================================*/
+
+static uint32_t bench_owner(void)
+{
+    return g_current_task;
+}
+
+static void run_as(uint32_t task)
+{
+    g_current_task = task;
+}
+
+/*==============================================================================
+ * FUNCTIONAL CHECKS
+ *============================================================================*/
+
+/* Task t allocates BENCH_OBJECTS objects of 16 * (t + 1) bytes */
+static void check_accounting(void)
+{
+    dsrtos_memory_owner_stats_t stats;
+    dsrtos_memory_owner_stats_t all[DSRTOS_CONFIG_MEMORY_PROFILE_OWNERS + 1U];
+    uint32_t count = 0U;
+    uint32_t frag = 0U;
+
+    for (uint32_t i = 0U; i < BENCH_OBJECTS; i++) {
+        for (uint32_t t = 0U; t < BENCH_TASKS; t++) {
+            run_as(t + 1U);
+            HOST_CHECK(dsrtos_memory_allocate(16U * (t + 1U), &g_objects[t][i]) == DSRTOS_SUCCESS);
+        }
+    }
+
+    for (uint32_t t = 0U; t < BENCH_TASKS; t++) {
+        HOST_CHECK(dsrtos_memory_profile_get_owner(t + 1U, &stats) == DSRTOS_SUCCESS);
+        HOST_CHECK(stats.objects == BENCH_OBJECTS);
+        HOST_CHECK(stats.bytes == (BENCH_OBJECTS * 16U * (t + 1U)));
+        HOST_CHECK(stats.peak_bytes == stats.bytes);
+    }
+    HOST_CHECK(dsrtos_memory_profile_get_owner(99U, &stats) == DSRTOS_ERR_NOT_FOUND);
+
+    /* Every other object freed by a different task: the owner is still charged */
+    for (uint32_t i = 0U; i < BENCH_OBJECTS; i += 2U) {
+        for (uint32_t t = 0U; t < BENCH_TASKS; t++) {
+            run_as(BENCH_TASKS - t);
+            HOST_CHECK(dsrtos_memory_free(g_objects[t][i]) == DSRTOS_SUCCESS);
+            g_objects[t][i] = NULL;
+        }
+    }
+    HOST_CHECK(dsrtos_memory_profile_get_owner(2U, &stats) == DSRTOS_SUCCESS);
+    HOST_CHECK(stats.objects == (BENCH_OBJECTS / 2U));
+    HOST_CHECK(stats.bytes == ((BENCH_OBJECTS / 2U) * 32U));
+    HOST_CHECK(stats.peak_bytes == (BENCH_OBJECTS * 32U));
+    HOST_CHECK(stats.free_count == (BENCH_OBJECTS / 2U));
+
+    /* Holes between live objects show up in the fragmentation index */
+    HOST_CHECK(dsrtos_memory_get_fragmentation(&frag) == DSRTOS_SUCCESS);
+    HOST_CHECK(frag > 0U);
+    (void)printf("  fragmentation with %u holes: %u/1000\n",
+                 (BENCH_OBJECTS / 2U) * BENCH_TASKS, frag);
+
+    /* Everything except task 3's leaks goes back */
+    for (uint32_t t = 0U; t < BENCH_TASKS; t++) {
+        uint32_t kept = 0U;
+        run_as(t + 1U);
+        for (uint32_t i = 1U; i < BENCH_OBJECTS; i += 2U) {
+            if ((t == 2U) && (kept < BENCH_LEAKS)) {
+                kept++;
+                continue;
+            }
+            HOST_CHECK(dsrtos_memory_free(g_objects[t][i]) == DSRTOS_SUCCESS);
+            g_objects[t][i] = NULL;
+        }
+    }
+
+    HOST_CHECK(dsrtos_memory_profile_get_all(all, DSRTOS_CONFIG_MEMORY_PROFILE_OWNERS + 1U,
+                                             &count) == DSRTOS_SUCCESS);
+    HOST_CHECK(count == BENCH_TASKS);
+    for (uint32_t i = 0U; i < count; i++) {
+        HOST_CHECK(all[i].objects == ((all[i].owner == 3U) ? BENCH_LEAKS : 0U));
+    }
+}
+
+/* Two live owners mapping to the same slot: the second is counted as "other" */
+static void check_slot_collision(void)
+{
+    dsrtos_memory_owner_stats_t stats;
+    void *a = NULL;
+    void *b = NULL;
+
+    run_as(1U);
+    HOST_CHECK(dsrtos_memory_allocate(24U, &b) == DSRTOS_SUCCESS);
+    run_as(1U + DSRTOS_CONFIG_MEMORY_PROFILE_OWNERS);
+    HOST_CHECK(dsrtos_memory_allocate(40U, &a) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_memory_profile_get_owner(DSRTOS_MEMORY_OWNER_OTHER, &stats) == DSRTOS_SUCCESS);
+    HOST_CHECK((stats.objects == 1U) && (stats.bytes == 40U));
+    HOST_CHECK(dsrtos_memory_profile_get_owner(1U, &stats) == DSRTOS_SUCCESS);
+    HOST_CHECK(stats.objects == 1U);
+
+    /* Frees go back to the slot that was charged */
+    HOST_CHECK(dsrtos_memory_free(a) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_memory_free(b) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_memory_profile_get_owner(DSRTOS_MEMORY_OWNER_OTHER, &stats) == DSRTOS_SUCCESS);
+    HOST_CHECK((stats.objects == 0U) && (stats.bytes == 0U));
+    HOST_CHECK(dsrtos_memory_profile_get_owner(1U, &stats) == DSRTOS_SUCCESS);
+    HOST_CHECK(stats.objects == 0U);
+}
+
+/* Export the ring and sanity-check the records */
+static void check_trace_export(void)
+{
+    const dsrtos_memory_trace_header_t *header = (const dsrtos_memory_trace_header_t *)(void *)g_export;
+    const dsrtos_memory_trace_record_t *records =
+        (const dsrtos_memory_trace_record_t *)(const void *)&g_export[sizeof(*header)];
+    dsrtos_size_t written = 0U;
+    uint32_t allocs = 0U;
+    uint32_t frees = 0U;
+    FILE *file;
+
+    HOST_CHECK(dsrtos_memory_trace_export(g_export, sizeof(g_export), &written) == DSRTOS_SUCCESS);
+    HOST_CHECK(header->magic == DSRTOS_MEMORY_TRACE_MAGIC);
+    HOST_CHECK(header->record_size == sizeof(dsrtos_memory_trace_record_t));
+    HOST_CHECK(header->dropped == 0U);
+    HOST_CHECK(written == (sizeof(*header) + (header->record_count * sizeof(*records))));
+
+    for (uint32_t i = 0U; i < header->record_count; i++) {
+        if ((records[i].size_op & DSRTOS_MEMORY_TRACE_OP_FREE) != 0U) {
+            frees++;
+        } else {
+            allocs++;
+        }
+        HOST_CHECK(records[i].offset < DSRTOS_CONFIG_HEAP_SIZE);
+        HOST_CHECK((i == 0U) || ((int32_t)(records[i].timestamp - records[i - 1U].timestamp) >= 0));
+    }
+    HOST_CHECK(allocs == ((BENCH_TASKS * BENCH_OBJECTS) + 2U));
+    HOST_CHECK(frees == (allocs - BENCH_LEAKS));
+
+    file = fopen(BENCH_TRACE_FILE, "wb");
+    HOST_CHECK(file != NULL);
+    if (file != NULL) {
+        HOST_CHECK(fwrite(g_export, 1U, written, file) == written);
+        (void)fclose(file);
+        (void)printf("  wrote %u trace records to %s\n", header->record_count, BENCH_TRACE_FILE);
+    }
+
+    /* Drained: a second export is empty */
+    HOST_CHECK(dsrtos_memory_trace_export(g_export, sizeof(g_export), &written) == DSRTOS_SUCCESS);
+    HOST_CHECK(header->record_count == 0U);
+}
+
+/*==============================================================================
+ * BENCHMARKS
+ *============================================================================*/
+
+/* Same size mix and slot churn as dsrtos_bench_memory */
+static void bench_overhead(void)
+{
+    static void *slots[256];
+    dsrtos_host_sample_t alloc_sample;
+    dsrtos_host_sample_t free_sample;
+    dsrtos_size_t written = 0U;
+
+    dsrtos_host_sample_init(&alloc_sample, "profiled allocate");
+    dsrtos_host_sample_init(&free_sample, "profiled free");
+    dsrtos_host_srand(0x1234567U);
+
+    for (uint32_t op = 0U; op < BENCH_TIMED_OPS; op++) {
+        uint32_t r = dsrtos_host_rand();
+        uint32_t slot = r % 256U;
+        uint32_t t0;
+        uint32_t t1;
+
+        run_as(1U + (r % 8U));
+        if (slots[slot] != NULL) {
+            t0 = dsrtos_port_get_cycle_count();
+            (void)dsrtos_memory_free(slots[slot]);
+            t1 = dsrtos_port_get_cycle_count();
+            dsrtos_host_sample_add(&free_sample, t1 - t0);
+            slots[slot] = NULL;
+        } else {
+            dsrtos_size_t size = 8U + ((r >> 8) % 120U);
+            t0 = dsrtos_port_get_cycle_count();
+            (void)dsrtos_memory_allocate(size, &slots[slot]);
+            t1 = dsrtos_port_get_cycle_count();
+            dsrtos_host_sample_add(&alloc_sample, t1 - t0);
+        }
+
+        /* Keep the ring from wrapping so every op pays the full cost */
+        if ((op % (DSRTOS_CONFIG_MEMORY_TRACE_DEPTH / 2U)) == 0U) {
+            (void)dsrtos_memory_trace_export(g_export, sizeof(g_export), &written);
+        }
+    }
+
+    for (uint32_t i = 0U; i < 256U; i++) {
+        if (slots[i] != NULL) {
+            (void)dsrtos_memory_free(slots[i]);
+            slots[i] = NULL;
+        }
+    }
+
+    dsrtos_host_sample_print(&alloc_sample);
+    dsrtos_host_sample_print(&free_sample);
+}
+
+/*==============================================================================
+ * MAIN
+ *============================================================================*/
+
+int main(void)
+{
+    static const dsrtos_memory_profile_hooks_t hooks = {
+        .get_owner = bench_owner,
+        .get_timestamp = dsrtos_port_get_cycle_count
+    };
+
+    HOST_CHECK(dsrtos_memory_profile_set_hooks(&hooks) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_memory_init() == DSRTOS_SUCCESS);
+
+    (void)printf("Heap profiler (%u owner slots, %u record trace ring)\n",
+                 DSRTOS_CONFIG_MEMORY_PROFILE_OWNERS, DSRTOS_CONFIG_MEMORY_TRACE_DEPTH);
+    check_accounting();
+    check_slot_collision();
+    check_trace_export();
+    bench_overhead();
+
+    return dsrtos_host_finish("dsrtos_bench_heapprof");
+}
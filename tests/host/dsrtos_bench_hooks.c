@@ -0,0 +1,329 @@
+/*
+ * @file dsrtos_bench_hooks.c
+ * @brief Hook dispatch cost on the context switch path (host port)
+ * @date 2024-12-30
+ *
+ * Measures a modelled context switch (state update plus the switch-out and
+ * switch-in hook points) with no hooks, with 1 and 4 hooks registered at
+ * run time, and with 1 and 4 hooks registered at link time. Checks that an
+ * empty hook point never enters dsrtos_hook_call, that enable, disable and
+ * unregister keep the active mask exact, that hook types sharing a slot do
+ * not run each other's hooks, that only sampled calls are timed, and
+ * that a hook unregistering itself and the next hook mid-call neither
+ * runs the next one nor loses their nodes.
+ *
+ * Link-time hooks sit on types the switch path does not use by default, so
+ * the same binary can measure both kinds.
+ */
+
+#include "dsrtos_host_port.h"
+#include "dsrtos_hooks.h"
+#include "dsrtos_kernel.h"
+#include "dsrtos_kernel_init.h"
+#include "dsrtos_port.h"
+#include <stdio.h>
+#include <string.h>
+
+/*==============================================================================
+ * CONFIGURATION
+ *============================================================================*/
+
+#define BENCH_SWITCHES          (20000U)
+#define BENCH_BATCH             (100U)     /* Switches per timed sample */
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+static dsrtos_tcb_t g_tasks[2];
+static dsrtos_tcb_t* g_current = &g_tasks[0];
+static uint32_t g_switches;
+static uint32_t g_hook_calls[8];
+static void* g_unregister_self;
+static void* g_unregister_next;
+
+/*==============================================================================
+ * KERNEL STUBS
+ *============================================================================*/
+
+dsrtos_error_t dsrtos_kernel_register_service(dsrtos_service_id_t service_id, void* service_ptr)
+{
+    (void)service_id;
+    (void)service_ptr;
+    return DSRTOS_SUCCESS;
+}
+
+/*==============================================================================
+ * HOOKS
+ *============================================================================*/
+
+static void* hook_0(dsrtos_hook_type_t type, void* params) { (void)type; (void)params; g_hook_calls[0]++; return NULL; }
+static void* hook_1(dsrtos_hook_type_t type, void* params) { (void)type; (void)params; g_hook_calls[1]++; return NULL; }
+static void* hook_2(dsrtos_hook_type_t type, void* params) { (void)type; (void)params; g_hook_calls[2]++; return NULL; }
+static void* hook_3(dsrtos_hook_type_t type, void* params) { (void)type; (void)params; g_hook_calls[3]++; return NULL; }
+static void* hook_4(dsrtos_hook_type_t type, void* params) { (void)type; (void)params; g_hook_calls[4]++; return params; }
+static void* hook_5(dsrtos_hook_type_t type, void* params) { (void)type; (void)params; g_hook_calls[5]++; return NULL; }
+static void* hook_6(dsrtos_hook_type_t type, void* params) { (void)type; (void)params; g_hook_calls[6]++; return NULL; }
+static void* hook_7(dsrtos_hook_type_t type, void* params) { (void)type; (void)params; g_hook_calls[7]++; return NULL; }
+
+/* Unregisters itself and the hook after it while the chain is walked */
+static void* hook_unregister(dsrtos_hook_type_t type, void* params)
+{
+    (void)type;
+    (void)params;
+    HOST_CHECK(dsrtos_hook_unregister(g_unregister_self) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_hook_unregister(g_unregister_next) == DSRTOS_SUCCESS);
+    return NULL;
+}
+
+/* 1 link-time hook on MEM_ALLOC, 2 on KERNEL_TICK and 2 on KERNEL_IDLE */
+DSRTOS_HOOK_STATIC(MEM_ALLOC, hook_4);
+DSRTOS_HOOK_STATIC(KERNEL_TICK, hook_5);
+DSRTOS_HOOK_STATIC(KERNEL_TICK, hook_6);
+DSRTOS_HOOK_STATIC(KERNEL_IDLE, hook_7);
+DSRTOS_HOOK_STATIC(KERNEL_IDLE, hook_3);
+
+/*==============================================================================
+ * MODELLED CONTEXT SWITCH
+ *============================================================================*/
+
+/* The bookkeeping of dsrtos_switch_context_handler with its hook points */
+#define BENCH_SWITCH(name, out_type, in_type) \
+    static __attribute__((noinline)) void name(void) \
+    { \
+        dsrtos_tcb_t* prev = g_current; \
+        dsrtos_tcb_t* next = (prev == &g_tasks[0]) ? &g_tasks[1] : &g_tasks[0]; \
+        prev->state = DSRTOS_TASK_STATE_READY; \
+        g_current = next; \
+        next->state = DSRTOS_TASK_STATE_RUNNING; \
+        DSRTOS_HOOK_CALL_FAST((out_type), prev); \
+        DSRTOS_HOOK_CALL_FAST((in_type), next); \
+        g_switches++; \
+    }
+
+static __attribute__((noinline)) void switch_no_hook_points(void)
+{
+    dsrtos_tcb_t* prev = g_current;
+    dsrtos_tcb_t* next = (prev == &g_tasks[0]) ? &g_tasks[1] : &g_tasks[0];
+
+    prev->state = DSRTOS_TASK_STATE_READY;
+    g_current = next;
+    next->state = DSRTOS_TASK_STATE_RUNNING;
+    g_switches++;
+}
+
+BENCH_SWITCH(switch_runtime, DSRTOS_HOOK_TASK_SWITCH_OUT, DSRTOS_HOOK_TASK_SWITCH_IN)
+BENCH_SWITCH(switch_link_1, DSRTOS_HOOK_MEM_FREE, DSRTOS_HOOK_MEM_ALLOC)
+BENCH_SWITCH(switch_link_4, DSRTOS_HOOK_KERNEL_TICK, DSRTOS_HOOK_KERNEL_IDLE)
+
+/*==============================================================================
+ * HELPERS
+ *============================================================================*/
+
+static void* register_hook(dsrtos_hook_type_t type, dsrtos_hook_func_t function, uint32_t priority)
+{
+    dsrtos_hook_entry_t entry;
+    void* handle;
+
+    (void)memset(&entry, 0, sizeof(entry));
+    entry.type = type;
+    entry.function = function;
+    entry.priority = priority;
+    entry.enabled = true;
+    entry.name = "bench";
+    handle = dsrtos_hook_register(&entry);
+    HOST_CHECK(handle != NULL);
+    return handle;
+}
+
+static uint32_t total_hook_calls(void)
+{
+    uint32_t total = 0U;
+
+    for (uint32_t i = 0U; i < 8U; i++) {
+        total += g_hook_calls[i];
+    }
+    return total;
+}
+
+/*==============================================================================
+ * FUNCTIONAL CHECKS
+ *============================================================================*/
+
+static void check_link_time(void)
+{
+    uint32_t marker = 0U;
+
+    /* Nothing runs before init */
+    HOST_CHECK(!dsrtos_hook_active(DSRTOS_HOOK_MEM_ALLOC));
+    HOST_CHECK(dsrtos_hook_call(DSRTOS_HOOK_MEM_ALLOC, NULL) == NULL);
+    HOST_CHECK(g_hook_calls[4] == 0U);
+
+    HOST_CHECK(dsrtos_hooks_init() == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_hook_active(DSRTOS_HOOK_MEM_ALLOC));
+    HOST_CHECK(dsrtos_hook_active(DSRTOS_HOOK_KERNEL_TICK));
+    HOST_CHECK(dsrtos_hook_active(DSRTOS_HOOK_KERNEL_IDLE));
+    HOST_CHECK(!dsrtos_hook_active(DSRTOS_HOOK_MEM_FREE));
+    HOST_CHECK(!dsrtos_hook_active(DSRTOS_HOOK_TASK_SWITCH_IN));
+    HOST_CHECK(!dsrtos_hook_active(DSRTOS_HOOK_TASK_SWITCH_OUT));
+    HOST_CHECK(dsrtos_hook_get_count(DSRTOS_HOOK_KERNEL_IDLE) == 2U);
+    HOST_CHECK(dsrtos_hook_get_count(DSRTOS_HOOK_MAX) == 5U);
+
+    /* The result of the hook that returns its parameter comes back */
+    HOST_CHECK(dsrtos_hook_call(DSRTOS_HOOK_MEM_ALLOC, &marker) == &marker);
+    HOST_CHECK(g_hook_calls[4] == 1U);
+
+    /* Each link-time hook of a type runs once per call */
+    dsrtos_host_tick_advance(1U);
+    HOST_CHECK((g_hook_calls[5] == 1U) && (g_hook_calls[6] == 1U));
+    DSRTOS_HOOK_IDLE();
+    HOST_CHECK((g_hook_calls[7] == 1U) && (g_hook_calls[3] == 1U));
+    (void)memset(g_hook_calls, 0, sizeof(g_hook_calls));
+}
+
+static void check_runtime(void)
+{
+    void* first;
+    void* second;
+    void* shared;
+
+    first = register_hook(DSRTOS_HOOK_TASK_SWITCH_IN, hook_0, 10U);
+    HOST_CHECK(dsrtos_hook_active(DSRTOS_HOOK_TASK_SWITCH_IN));
+    second = register_hook(DSRTOS_HOOK_TASK_SWITCH_IN, hook_1, 5U);
+
+    /* The mask tracks enabled hooks, not registered ones */
+    HOST_CHECK(dsrtos_hook_disable(first) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_hook_active(DSRTOS_HOOK_TASK_SWITCH_IN));
+    HOST_CHECK(dsrtos_hook_disable(second) == DSRTOS_SUCCESS);
+    HOST_CHECK(!dsrtos_hook_active(DSRTOS_HOOK_TASK_SWITCH_IN));
+    switch_runtime();
+    HOST_CHECK(total_hook_calls() == 0U);
+    HOST_CHECK(dsrtos_hook_enable(first) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_hook_active(DSRTOS_HOOK_TASK_SWITCH_IN));
+    switch_runtime();
+    HOST_CHECK((g_hook_calls[0] == 1U) && (g_hook_calls[1] == 0U));
+    HOST_CHECK(dsrtos_hook_unregister(first) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_hook_unregister(second) == DSRTOS_SUCCESS);
+    HOST_CHECK(!dsrtos_hook_active(DSRTOS_HOOK_TASK_SWITCH_IN));
+
+    /* KERNEL_PRE_START and APP_INIT share slot 0 but not their hooks */
+    shared = register_hook(DSRTOS_HOOK_KERNEL_PRE_START, hook_2, 0U);
+    HOST_CHECK(dsrtos_hook_active(DSRTOS_HOOK_APP_INIT));
+    HOST_CHECK(dsrtos_hook_call(DSRTOS_HOOK_APP_INIT, NULL) == NULL);
+    HOST_CHECK(g_hook_calls[2] == 0U);
+    HOST_CHECK(dsrtos_hook_call(DSRTOS_HOOK_KERNEL_PRE_START, NULL) == NULL);
+    HOST_CHECK(g_hook_calls[2] == 1U);
+    HOST_CHECK(dsrtos_hook_unregister(shared) == DSRTOS_SUCCESS);
+    (void)memset(g_hook_calls, 0, sizeof(g_hook_calls));
+}
+
+static void check_unregister_in_call(void)
+{
+    void* again[2];
+
+    g_unregister_self = register_hook(DSRTOS_HOOK_TASK_DELETE, hook_unregister, 0U);
+    g_unregister_next = register_hook(DSRTOS_HOOK_TASK_DELETE, hook_0, 1U);
+    HOST_CHECK(dsrtos_hook_call(DSRTOS_HOOK_TASK_DELETE, NULL) == NULL);
+    HOST_CHECK(g_hook_calls[0] == 0U);
+    HOST_CHECK(dsrtos_hook_get_count(DSRTOS_HOOK_TASK_DELETE) == 0U);
+    HOST_CHECK(!dsrtos_hook_active(DSRTOS_HOOK_TASK_DELETE));
+
+    /* Freed once the call was out: both nodes are handed out again */
+    again[0] = register_hook(DSRTOS_HOOK_TASK_DELETE, hook_0, 0U);
+    again[1] = register_hook(DSRTOS_HOOK_TASK_DELETE, hook_1, 0U);
+    HOST_CHECK(((again[0] == g_unregister_self) && (again[1] == g_unregister_next)) ||
+               ((again[0] == g_unregister_next) && (again[1] == g_unregister_self)));
+    HOST_CHECK(dsrtos_hook_unregister(again[0]) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_hook_unregister(again[1]) == DSRTOS_SUCCESS);
+}
+
+static void check_sampling(void)
+{
+    dsrtos_hook_stats_t stats;
+    void* handle;
+
+    handle = register_hook(DSRTOS_HOOK_TASK_CREATE, hook_0, 0U);
+    HOST_CHECK(dsrtos_hook_reset_stats(DSRTOS_HOOK_TASK_CREATE) == DSRTOS_SUCCESS);
+    for (uint32_t i = 0U; i < 100U; i++) {
+        (void)dsrtos_hook_call(DSRTOS_HOOK_TASK_CREATE, NULL);
+    }
+    HOST_CHECK(dsrtos_hook_get_stats(DSRTOS_HOOK_TASK_CREATE, &stats) == DSRTOS_SUCCESS);
+    HOST_CHECK(stats.call_count == 100U);
+    HOST_CHECK(stats.sampled_count ==
+               ((100U + DSRTOS_CONFIG_HOOK_TIMING_SAMPLE - 1U) / DSRTOS_CONFIG_HOOK_TIMING_SAMPLE));
+    HOST_CHECK(stats.max_duration_cycles >= stats.min_duration_cycles);
+    HOST_CHECK(dsrtos_hook_unregister(handle) == DSRTOS_SUCCESS);
+    (void)memset(g_hook_calls, 0, sizeof(g_hook_calls));
+}
+
+/*==============================================================================
+ * BENCHMARKS
+ *============================================================================*/
+
+static void bench_switch(const char* label, void (*do_switch)(void), uint32_t hooks)
+{
+    dsrtos_host_sample_t sample;
+    uint32_t calls_before = total_hook_calls();
+
+    dsrtos_host_sample_init(&sample, label);
+    for (uint32_t i = 0U; i < (BENCH_SWITCHES / BENCH_BATCH); i++) {
+        uint32_t t0 = dsrtos_port_get_cycle_count();
+        for (uint32_t j = 0U; j < BENCH_BATCH; j++) {
+            do_switch();
+        }
+        uint32_t t1 = dsrtos_port_get_cycle_count();
+
+        dsrtos_host_sample_add(&sample, (t1 - t0) / BENCH_BATCH);
+    }
+    dsrtos_host_sample_print(&sample);
+
+    /* Every hook ran once per switch, and nothing else ran */
+    HOST_CHECK((total_hook_calls() - calls_before) == (hooks * BENCH_SWITCHES));
+}
+
+static void bench_runtime(void)
+{
+    void* handles[4];
+    static const dsrtos_hook_func_t functions[4] = { hook_0, hook_1, hook_2, hook_3 };
+
+    bench_switch("switch, no hook points", switch_no_hook_points, 0U);
+    bench_switch("switch, 0 hooks", switch_runtime, 0U);
+
+    handles[0] = register_hook(DSRTOS_HOOK_TASK_SWITCH_IN, functions[0], 0U);
+    bench_switch("switch, 1 run-time hook", switch_runtime, 1U);
+
+    handles[1] = register_hook(DSRTOS_HOOK_TASK_SWITCH_IN, functions[1], 1U);
+    handles[2] = register_hook(DSRTOS_HOOK_TASK_SWITCH_OUT, functions[2], 0U);
+    handles[3] = register_hook(DSRTOS_HOOK_TASK_SWITCH_OUT, functions[3], 1U);
+    bench_switch("switch, 4 run-time hooks", switch_runtime, 4U);
+
+    for (uint32_t i = 0U; i < 4U; i++) {
+        HOST_CHECK(dsrtos_hook_unregister(handles[i]) == DSRTOS_SUCCESS);
+    }
+    bench_switch("switch, 0 hooks after unregister", switch_runtime, 0U);
+
+    bench_switch("switch, 1 link-time hook", switch_link_1, 1U);
+    bench_switch("switch, 4 link-time hooks", switch_link_4, 4U);
+}
+
+/*==============================================================================
+ * MAIN
+ *============================================================================*/
+
+int main(void)
+{
+    g_tasks[0].task_id = 1U;
+    g_tasks[1].task_id = 2U;
+
+    check_link_time();
+    check_runtime();
+    check_unregister_in_call();
+    check_sampling();
+
+    (void)printf("Hook dispatch benchmark (%u switches, cycles per switch, timing 1 in %u hook calls)\n",
+                 BENCH_SWITCHES, DSRTOS_CONFIG_HOOK_TIMING_SAMPLE);
+    bench_runtime();
+    (void)printf("  %-36s %u switches\n", "", g_switches);
+
+    return dsrtos_host_finish("dsrtos_bench_hooks");
+}
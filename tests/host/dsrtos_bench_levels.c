@@ -0,0 +1,377 @@
+/*
+ * @file dsrtos_bench_levels.c
+ * @brief Ready queue footprint and cache/TLB cost per priority count (host port)
+ * @date 2024-12-30
+ *
+ * Built once per DSRTOS_PRIORITY_LEVELS (make run-levels). Checks that the
+ * phase 4 ready queue orders tasks by priority across the whole configured
+ * range: lowest and highest level, FIFO within a level and a valid queue
+ * after every operation. Then it reports the queue footprint against the
+ * old fixed 256-level layout, and times validate, select and an
+ * insert/remove pair three ways:
+ * - warm: the queue was just used
+ * - cache cold: every queue line flushed first
+ * - cache+TLB cold: lines flushed, then one byte touched on each page of a
+ *   buffer larger than the data TLB reach, so the queue's page walks miss
+ *   too. User space cannot flush the TLB directly, so this is the closest
+ *   host stand-in for a scheduler run after an unrelated workload.
+ * The page walk also trains the hardware prefetchers, which then help the
+ * sequential validate scan; compare one mode across level counts rather
+ * than the modes with each other.
+ */
+
+#include "dsrtos_host_port.h"
+#include "dsrtos_task_scheduler_interface.h"
+#include "dsrtos_task_manager.h"
+#include "dsrtos_port.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*==============================================================================
+ * CONFIGURATION
+ *============================================================================*/
+
+#define BENCH_TASKS             (24U)
+#define BENCH_BACKGROUND        (16U)
+#define BENCH_ROUNDS            (2000U)
+#define BENCH_STACK_WORDS       (64U)
+#define BENCH_CACHE_LINE        (64U)
+#define BENCH_PAGE              (4096U)
+#define BENCH_TLB_PAGES         (8192U)     /* 32 MiB, past any L2 TLB */
+
+/* The list header and bitmap before this change, at its fixed 256 levels */
+#define BENCH_LEGACY_LEVELS     (256U)
+#define BENCH_LEGACY_WORDS      (8U)
+
+/* 32-bit target sizes: head, tail, count now; plus max_count, priority,
+ * padding and checksum before */
+#define BENCH_TARGET_LIST       (12U)
+#define BENCH_TARGET_LEGACY     (24U)
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+typedef struct {
+    dsrtos_queue_node_t* head;
+    dsrtos_queue_node_t* tail;
+    uint32_t count;
+    uint32_t max_count;
+    uint8_t priority;
+    uint8_t reserved[3];
+    uint32_t list_checksum;
+} legacy_list_t;
+
+typedef enum {
+    BENCH_WARM = 0,
+    BENCH_CACHE_COLD,
+    BENCH_TLB_COLD,
+    BENCH_MODES
+} bench_mode_t;
+
+static const char *const g_mode_names[BENCH_MODES] = { "warm", "cache cold", "cache+TLB cold" };
+
+static dsrtos_scheduler_interface_t g_interface;
+static dsrtos_ready_queue_t *g_queue;
+static dsrtos_tcb_t g_tasks[BENCH_TASKS];
+static uint32_t g_stacks[BENCH_TASKS][BENCH_STACK_WORDS] __attribute__((aligned(8)));
+static uint8_t *g_tlb_buffer;
+static uint32_t g_samples[BENCH_ROUNDS];
+static volatile uint32_t g_sink;
+
+/*==============================================================================
+ * KERNEL STUBS
+ *============================================================================*/
+
+void dsrtos_panic(const char* reason)
+{
+    dsrtos_host_check_failed(__FILE__, __LINE__, reason);
+}
+
+void dsrtos_assert_failed(const char* expr, const char* file, int line, const char* func)
+{
+    (void)func;
+    dsrtos_host_check_failed(file, line, expr);
+}
+
+static dsrtos_error_t ops_init(void* context)
+{
+    (void)context;
+    return DSRTOS_SUCCESS;
+}
+
+static dsrtos_error_t ops_enqueue(dsrtos_ready_queue_t* queue, dsrtos_tcb_t* task)
+{
+    return dsrtos_ready_queue_insert(queue, task);
+}
+
+static dsrtos_error_t ops_dequeue(dsrtos_ready_queue_t* queue, dsrtos_tcb_t* task)
+{
+    return dsrtos_ready_queue_remove(queue, task);
+}
+
+static const dsrtos_scheduler_ops_t g_ops = {
+    .init = ops_init,
+    .select_next_task = dsrtos_ready_queue_get_highest_priority,
+    .enqueue_task = ops_enqueue,
+    .dequeue_task = ops_dequeue
+};
+
+/*==============================================================================
+ * HELPERS
+ *============================================================================*/
+
+static void task_setup(uint32_t index, uint32_t priority)
+{
+    dsrtos_tcb_t *task = &g_tasks[index];
+
+    (void)memset(task, 0, sizeof(*task));
+    task->task_id = index + 1U;
+    task->magic_number = DSRTOS_TCB_MAGIC;
+    task->state = DSRTOS_TASK_STATE_READY;
+    task->effective_priority = (uint8_t)priority;
+    task->static_priority = (uint8_t)priority;
+    task->stack_base = g_stacks[index];
+    task->stack_size = (uint32_t)sizeof(g_stacks[index]);
+}
+
+static uint32_t lines_spanned(const void *base, size_t size)
+{
+    uintptr_t first = (uintptr_t)base / BENCH_CACHE_LINE;
+    uintptr_t last = ((uintptr_t)base + size - 1U) / BENCH_CACHE_LINE;
+
+    return (uint32_t)(last - first + 1U);
+}
+
+static uint32_t pages_spanned(const void *base, size_t size)
+{
+    uintptr_t first = (uintptr_t)base / BENCH_PAGE;
+    uintptr_t last = ((uintptr_t)base + size - 1U) / BENCH_PAGE;
+
+    return (uint32_t)(last - first + 1U);
+}
+
+/* Put the queue back in the state the mode describes */
+static void evict(bench_mode_t mode)
+{
+    const uint8_t *bytes = (const uint8_t *)g_queue;
+    uint32_t sum = 0U;
+
+    if (mode == BENCH_WARM) {
+        return;
+    }
+
+    if (mode == BENCH_TLB_COLD) {
+        for (uint32_t page = 0U; page < BENCH_TLB_PAGES; page++) {
+            sum += g_tlb_buffer[(size_t)page * BENCH_PAGE];
+        }
+        g_sink = sum;
+    }
+
+    for (size_t offset = 0U; offset < sizeof(*g_queue); offset += BENCH_CACHE_LINE) {
+        __builtin_ia32_clflush(&bytes[offset]);
+    }
+    __builtin_ia32_clflush(&bytes[sizeof(*g_queue) - 1U]);
+    __builtin_ia32_mfence();
+}
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+static uint32_t median(void)
+{
+    qsort(g_samples, BENCH_ROUNDS, sizeof(g_samples[0]), compare_u32);
+    return g_samples[BENCH_ROUNDS / 2U];
+}
+
+/*==============================================================================
+ * CHECKS
+ *============================================================================*/
+
+static void check_levels(void)
+{
+    dsrtos_tcb_t *bottom_a = &g_tasks[0];
+    dsrtos_tcb_t *bottom_b = &g_tasks[1];
+    dsrtos_tcb_t *middle = &g_tasks[2];
+    dsrtos_tcb_t *top = &g_tasks[3];
+
+    task_setup(0U, DSRTOS_IDLE_PRIORITY);
+    task_setup(1U, DSRTOS_IDLE_PRIORITY);
+    task_setup(2U, DSRTOS_DEFAULT_PRIORITY);
+    task_setup(3U, DSRTOS_HIGHEST_PRIORITY);
+
+    HOST_CHECK(DSRTOS_BITMAP_WORDS * 32U >= DSRTOS_PRIORITY_LEVELS);
+    HOST_CHECK((DSRTOS_BITMAP_WORDS - 1U) * 32U < DSRTOS_PRIORITY_LEVELS);
+    HOST_CHECK(sizeof(g_queue->priority_lists) / sizeof(g_queue->priority_lists[0]) ==
+               DSRTOS_PRIORITY_LEVELS);
+
+    HOST_CHECK(dsrtos_ready_queue_get_highest_priority(g_queue) == NULL);
+    HOST_CHECK(dsrtos_ready_queue_insert(g_queue, bottom_a) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_ready_queue_insert(g_queue, bottom_b) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_ready_queue_get_highest_priority(g_queue) == bottom_a);
+    HOST_CHECK(dsrtos_ready_queue_insert(g_queue, middle) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_ready_queue_insert(g_queue, top) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_ready_queue_validate(g_queue));
+
+    /* Highest level first, then down through the range, FIFO at each level */
+    HOST_CHECK(dsrtos_ready_queue_get_highest_priority(g_queue) == top);
+    HOST_CHECK(dsrtos_ready_queue_remove(g_queue, top) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_ready_queue_get_highest_priority(g_queue) == middle);
+    HOST_CHECK(dsrtos_ready_queue_remove(g_queue, middle) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_ready_queue_get_highest_priority(g_queue) == bottom_a);
+    HOST_CHECK(dsrtos_ready_queue_remove(g_queue, bottom_a) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_ready_queue_get_highest_priority(g_queue) == bottom_b);
+    HOST_CHECK(dsrtos_ready_queue_remove(g_queue, bottom_b) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_ready_queue_get_highest_priority(g_queue) == NULL);
+    HOST_CHECK(dsrtos_ready_queue_validate(g_queue));
+
+#if (DSRTOS_PRIORITY_LEVELS < 256U)
+    /* A level past the configured count is refused, not written past the array */
+    task_setup(0U, DSRTOS_PRIORITY_LEVELS);
+    HOST_CHECK(dsrtos_ready_queue_insert(g_queue, bottom_a) != DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_ready_queue_validate(g_queue));
+#endif
+}
+
+/*==============================================================================
+ * BENCHMARK
+ *============================================================================*/
+
+static void report_footprint(void)
+{
+    size_t lists = sizeof(g_queue->priority_lists);
+    size_t bitmaps = sizeof(g_queue->priority_bitmap) + sizeof(g_queue->priority_bitmap_mirror);
+    size_t legacy = (BENCH_LEGACY_LEVELS * sizeof(legacy_list_t)) +
+                    (2U * BENCH_LEGACY_WORDS * sizeof(uint32_t));
+    uint32_t target = (DSRTOS_PRIORITY_LEVELS * BENCH_TARGET_LIST) +
+                      (2U * DSRTOS_BITMAP_WORDS * (uint32_t)sizeof(uint32_t));
+    uint32_t target_legacy = (BENCH_LEGACY_LEVELS * BENCH_TARGET_LEGACY) +
+                             (2U * BENCH_LEGACY_WORDS * (uint32_t)sizeof(uint32_t));
+
+    HOST_CHECK(sizeof(dsrtos_priority_list_t) < sizeof(legacy_list_t));
+
+    (void)printf("  list header %zu B (was %zu B), lists+bitmaps %zu B (was %zu B at 256 levels)\n",
+                 sizeof(dsrtos_priority_list_t), sizeof(legacy_list_t), lists + bitmaps, legacy);
+    (void)printf("  32-bit target: lists+bitmaps %u B (was %u B), %u B saved\n",
+                 target, target_legacy, target_legacy - target);
+    (void)printf("  ready queue %zu B over %u cache lines and %u pages\n",
+                 sizeof(*g_queue), lines_spanned(g_queue, sizeof(*g_queue)),
+                 pages_spanned(g_queue, sizeof(*g_queue)));
+}
+
+static uint32_t time_validate(bench_mode_t mode)
+{
+    uint32_t start;
+
+    for (uint32_t round = 0U; round < BENCH_ROUNDS; round++) {
+        evict(mode);
+        start = dsrtos_port_get_cycle_count();
+        g_sink = dsrtos_ready_queue_validate(g_queue) ? 1U : 0U;
+        g_samples[round] = dsrtos_port_get_cycle_count() - start;
+    }
+
+    return median();
+}
+
+static uint32_t time_select(bench_mode_t mode)
+{
+    dsrtos_tcb_t *volatile picked = NULL;
+    uint32_t start;
+
+    for (uint32_t round = 0U; round < BENCH_ROUNDS; round++) {
+        evict(mode);
+        start = dsrtos_port_get_cycle_count();
+        picked = dsrtos_ready_queue_get_highest_priority(g_queue);
+        g_samples[round] = dsrtos_port_get_cycle_count() - start;
+    }
+    HOST_CHECK(picked != NULL);
+
+    return median();
+}
+
+static uint32_t time_insert_remove(bench_mode_t mode)
+{
+    dsrtos_tcb_t *probe = &g_tasks[BENCH_TASKS - 1U];
+    uint32_t start;
+
+    for (uint32_t round = 0U; round < BENCH_ROUNDS; round++) {
+        evict(mode);
+        start = dsrtos_port_get_cycle_count();
+        (void)dsrtos_ready_queue_insert(g_queue, probe);
+        (void)dsrtos_ready_queue_remove(g_queue, probe);
+        g_samples[round] = dsrtos_port_get_cycle_count() - start;
+    }
+
+    return median();
+}
+
+static void bench_operations(void)
+{
+    uint32_t validate[BENCH_MODES];
+    uint32_t select[BENCH_MODES];
+    uint32_t pair[BENCH_MODES];
+
+    /* Background tasks spread over the whole range */
+    for (uint32_t i = 0U; i < BENCH_BACKGROUND; i++) {
+        task_setup(i, (i * DSRTOS_PRIORITY_LEVELS) / BENCH_BACKGROUND);
+        HOST_CHECK(dsrtos_ready_queue_insert(g_queue, &g_tasks[i]) == DSRTOS_SUCCESS);
+    }
+    task_setup(BENCH_TASKS - 1U, DSRTOS_DEFAULT_PRIORITY);
+
+    for (uint32_t m = 0U; m < (uint32_t)BENCH_MODES; m++) {
+        validate[m] = time_validate((bench_mode_t)m);
+        select[m] = time_select((bench_mode_t)m);
+        pair[m] = time_insert_remove((bench_mode_t)m);
+    }
+    HOST_CHECK(g_queue->stats.total_tasks == BENCH_BACKGROUND);
+    HOST_CHECK(dsrtos_ready_queue_validate(g_queue));
+
+    (void)printf("  %-16s %10s %10s %14s\n", "median cycles", "validate", "select", "insert+remove");
+    for (uint32_t m = 0U; m < (uint32_t)BENCH_MODES; m++) {
+        (void)printf("  %-16s %10u %10u %14u\n", g_mode_names[m], validate[m], select[m], pair[m]);
+    }
+
+    /* One row of the per-level table */
+    (void)printf("  %-6s %6s %5s %5s %9s %9s %9s %9s %9s %9s\n", "levels", "bytes", "lines", "pages",
+                 "val warm", "val cold", "sel warm", "sel cold", "i+r warm", "i+r cold");
+    (void)printf("  %-6u %6zu %5u %5u %9u %9u %9u %9u %9u %9u\n", DSRTOS_PRIORITY_LEVELS,
+                 sizeof(*g_queue), lines_spanned(g_queue, sizeof(*g_queue)),
+                 pages_spanned(g_queue, sizeof(*g_queue)),
+                 validate[BENCH_WARM], validate[BENCH_TLB_COLD],
+                 select[BENCH_WARM], select[BENCH_TLB_COLD],
+                 pair[BENCH_WARM], pair[BENCH_TLB_COLD]);
+}
+
+int main(void)
+{
+    g_tlb_buffer = calloc(BENCH_TLB_PAGES, BENCH_PAGE);
+    HOST_CHECK(g_tlb_buffer != NULL);
+    if (g_tlb_buffer == NULL) {
+        return dsrtos_host_finish("dsrtos_bench_levels");
+    }
+    /* Fault every page in now so eviction walks resident pages */
+    for (uint32_t page = 0U; page < BENCH_TLB_PAGES; page++) {
+        g_tlb_buffer[(size_t)page * BENCH_PAGE] = (uint8_t)page;
+    }
+
+    HOST_CHECK(dsrtos_scheduler_interface_init(&g_interface, &g_ops) == DSRTOS_SUCCESS);
+    g_queue = g_interface.ready_queue;
+    HOST_CHECK(g_queue != NULL);
+
+    (void)printf("Priority levels %u: %u bitmap words\n", DSRTOS_PRIORITY_LEVELS, DSRTOS_BITMAP_WORDS);
+    check_levels();
+    report_footprint();
+
+    (void)printf("Priority level benchmark (%u rounds, %u tasks ready)\n",
+                 BENCH_ROUNDS, BENCH_BACKGROUND);
+    bench_operations();
+
+    free(g_tlb_buffer);
+    return dsrtos_host_finish("dsrtos_bench_levels");
+}
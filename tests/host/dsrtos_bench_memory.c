@@ -0,0 +1,273 @@
+/*
+ * @file dsrtos_bench_memory.c
+ * @brief TLSF heap benchmark (host port)
+ * @date 2024-12-30
+ *
+ * Drives dsrtos_memory_allocate/dsrtos_memory_free with randomized
+ * alloc/free traces and reports average and worst-case cycles per
+ * operation. Also checks coalescing, exhaustion, double free and the
+ * guard/canary corruption path.
+ */
+
+#include "dsrtos_host_port.h"
+#include "dsrtos_memory.h"
+#include "dsrtos_config.h"
+#include "dsrtos_port.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*==============================================================================
+ * CONFIGURATION
+ *============================================================================*/
+
+#define BENCH_LIVE_SLOTS        (256U)
+#define BENCH_TRACE_OPS         (200000U)
+#define BENCH_TRACES            (3U)
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+static void *g_slots[BENCH_LIVE_SLOTS];
+static dsrtos_size_t g_slot_size[BENCH_LIVE_SLOTS];
+static uint32_t g_alloc_cycles[BENCH_TRACE_OPS];
+static uint32_t g_free_cycles[BENCH_TRACE_OPS];
+
+/*==============================================================================
+ * HELPERS
+ *============================================================================*/
+
+/* Mostly small objects with a tail of large ones, like kernel objects + buffers */
+static dsrtos_size_t random_size(void)
+{
+    uint32_t r = dsrtos_host_rand();
+    uint32_t bucket = r % 100U;
+
+    if (bucket < 70U) {
+        return 8U + ((r >> 8) % 120U);
+    } else if (bucket < 95U) {
+        return 128U + ((r >> 8) % 896U);
+    } else {
+        return 1024U + ((r >> 8) % 3072U);
+    }
+}
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void print_distribution(const char *name, uint32_t *cycles, uint32_t count)
+{
+    uint64_t total = 0U;
+
+    if (count == 0U) {
+        return;
+    }
+    for (uint32_t i = 0U; i < count; i++) {
+        total += cycles[i];
+    }
+    qsort(cycles, count, sizeof(cycles[0]), compare_u32);
+
+    (void)printf("  %-28s n=%-7u avg=%-6llu p50=%-6u p99=%-6u p99.9=%-6u max=%u\n",
+                 name, count, (unsigned long long)(total / count),
+                 cycles[count / 2U],
+                 cycles[(count * 99U) / 100U],
+                 cycles[(count * 999U) / 1000U],
+                 cycles[count - 1U]);
+}
+
+static void free_all_slots(void)
+{
+    for (uint32_t i = 0U; i < BENCH_LIVE_SLOTS; i++) {
+        if (g_slots[i] != NULL) {
+            HOST_CHECK(dsrtos_memory_free(g_slots[i]) == DSRTOS_SUCCESS);
+            g_slots[i] = NULL;
+        }
+    }
+}
+
+static void check_heap_empty(void)
+{
+    dsrtos_memory_heap_info_t info;
+
+    HOST_CHECK(dsrtos_memory_get_heap_info(&info) == DSRTOS_SUCCESS);
+    HOST_CHECK(info.allocated_size == 0U);
+    HOST_CHECK(info.free_blocks == 1U);
+    HOST_CHECK(info.largest_free_block == info.total_size);
+    HOST_CHECK(info.free_size == info.total_size);
+}
+
+/*==============================================================================
+ * FUNCTIONAL CHECKS
+ *============================================================================*/
+
+static void check_basic(void)
+{
+    void *a = NULL;
+    void *b = NULL;
+    void *c = NULL;
+    dsrtos_size_t total;
+    dsrtos_size_t allocated;
+    dsrtos_size_t peak;
+
+    HOST_CHECK(dsrtos_memory_allocate(0U, &a) == DSRTOS_ERR_INVALID_PARAM);
+    HOST_CHECK(dsrtos_memory_allocate(100U, &a) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_memory_allocate(200U, &b) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_memory_allocate(300U, &c) == DSRTOS_SUCCESS);
+    HOST_CHECK(((uintptr_t)a % DSRTOS_CONFIG_MEMORY_ALIGNMENT) == 0U);
+    HOST_CHECK(((uintptr_t)b % DSRTOS_CONFIG_MEMORY_ALIGNMENT) == 0U);
+    (void)memset(a, 0x11, 100U);
+    (void)memset(b, 0x22, 200U);
+    (void)memset(c, 0x33, 300U);
+
+    HOST_CHECK(dsrtos_memory_get_stats(&total, &allocated, &peak) == DSRTOS_SUCCESS);
+    HOST_CHECK((allocated >= 600U) && (peak >= allocated) && (total > allocated));
+
+    /* Free the middle, then both sides: everything must coalesce */
+    HOST_CHECK(dsrtos_memory_free(b) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_memory_free(b) == DSRTOS_ERR_NOT_FOUND);
+    HOST_CHECK(dsrtos_memory_free(a) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_memory_free(c) == DSRTOS_SUCCESS);
+    check_heap_empty();
+}
+
+static void check_exhaustion(void)
+{
+    dsrtos_memory_heap_info_t info;
+    uint32_t count = 0U;
+
+    while ((count < BENCH_LIVE_SLOTS) &&
+           (dsrtos_memory_allocate(1024U, &g_slots[count]) == DSRTOS_SUCCESS)) {
+        count++;
+    }
+    HOST_CHECK(count < BENCH_LIVE_SLOTS);
+    HOST_CHECK(count >= ((DSRTOS_CONFIG_HEAP_SIZE / 1100U) - 1U));
+
+    HOST_CHECK(dsrtos_memory_get_heap_info(&info) == DSRTOS_SUCCESS);
+    HOST_CHECK(info.failed_count >= 1U);
+
+    free_all_slots();
+    check_heap_empty();
+}
+
+static void check_corruption(void)
+{
+#if (DSRTOS_CONFIG_MEMORY_GUARDS != 0U)
+    uint8_t *p = NULL;
+    uint8_t saved[8];
+    dsrtos_memory_heap_info_t info;
+
+    HOST_CHECK(dsrtos_memory_allocate(64U, (void **)&p) == DSRTOS_SUCCESS);
+
+    /* Overrun into the rear canary */
+    (void)memcpy(saved, &p[64], sizeof(saved));
+    (void)memset(&p[64], 0xEE, sizeof(saved));
+    HOST_CHECK(dsrtos_memory_free(p) == DSRTOS_ERROR_CORRUPTION);
+    HOST_CHECK(dsrtos_memory_get_heap_info(&info) == DSRTOS_SUCCESS);
+    HOST_CHECK(info.corruption_count == 1U);
+
+    /* Repair and release */
+    (void)memcpy(&p[64], saved, sizeof(saved));
+    HOST_CHECK(dsrtos_memory_free(p) == DSRTOS_SUCCESS);
+    check_heap_empty();
+#endif
+}
+
+/*==============================================================================
+ * BENCHMARKS
+ *============================================================================*/
+
+static void bench_trace(uint32_t seed, bool use_libc)
+{
+    uint32_t n_alloc = 0U;
+    uint32_t n_free = 0U;
+    uint32_t failed = 0U;
+
+    dsrtos_host_srand(seed);
+
+    for (uint32_t op = 0U; op < BENCH_TRACE_OPS; op++) {
+        uint32_t slot = dsrtos_host_rand() % BENCH_LIVE_SLOTS;
+        uint32_t t0;
+        uint32_t t1;
+
+        if (g_slots[slot] != NULL) {
+            /* Verify the payload survived its neighbours */
+            HOST_CHECK(((uint8_t *)g_slots[slot])[g_slot_size[slot] - 1U] == (uint8_t)slot);
+
+            t0 = dsrtos_port_get_cycle_count();
+            if (use_libc) {
+                free(g_slots[slot]);
+            } else {
+                (void)dsrtos_memory_free(g_slots[slot]);
+            }
+            t1 = dsrtos_port_get_cycle_count();
+            g_free_cycles[n_free++] = t1 - t0;
+            g_slots[slot] = NULL;
+        } else {
+            dsrtos_size_t size = random_size();
+            void *p = NULL;
+
+            t0 = dsrtos_port_get_cycle_count();
+            if (use_libc) {
+                p = malloc(size);
+            } else {
+                (void)dsrtos_memory_allocate(size, &p);
+            }
+            t1 = dsrtos_port_get_cycle_count();
+            g_alloc_cycles[n_alloc++] = t1 - t0;
+
+            if (p == NULL) {
+                failed++;
+            } else {
+                (void)memset(p, (int)(uint8_t)slot, size);
+                g_slots[slot] = p;
+                g_slot_size[slot] = size;
+            }
+        }
+    }
+
+    (void)printf(" %s trace seed=0x%08x (%u failed allocations)\n",
+                 use_libc ? "libc malloc" : "TLSF heap", seed, failed);
+    print_distribution("allocate", g_alloc_cycles, n_alloc);
+    print_distribution("free", g_free_cycles, n_free);
+
+    if (use_libc) {
+        for (uint32_t i = 0U; i < BENCH_LIVE_SLOTS; i++) {
+            free(g_slots[i]);
+            g_slots[i] = NULL;
+        }
+    } else {
+        free_all_slots();
+        check_heap_empty();
+    }
+}
+
+/*==============================================================================
+ * MAIN
+ *============================================================================*/
+
+int main(void)
+{
+    static const uint32_t seeds[BENCH_TRACES] = { 0x1234567U, 0xC0FFEEU, 0xBADF00DU };
+    void *p = NULL;
+
+    HOST_CHECK(dsrtos_memory_allocate(16U, &p) == DSRTOS_ERR_NOT_INITIALIZED);
+    HOST_CHECK(dsrtos_memory_init() == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_memory_init() == DSRTOS_ERR_ALREADY_INITIALIZED);
+
+    check_basic();
+    check_exhaustion();
+    check_corruption();
+
+    (void)printf("Heap benchmark (%u ops, %u live slots, %u byte heap, cycles)\n",
+                 BENCH_TRACE_OPS, BENCH_LIVE_SLOTS, (unsigned)DSRTOS_CONFIG_HEAP_SIZE);
+    for (uint32_t i = 0U; i < BENCH_TRACES; i++) {
+        bench_trace(seeds[i], false);
+    }
+    bench_trace(seeds[0], true);
+
+    return dsrtos_host_finish("dsrtos_bench_memory");
+}
@@ -0,0 +1,306 @@
+/*
+ * @file dsrtos_bench_region.c
+ * @brief Region-aware placement checks and benchmark (host port)
+ * @date 2024-12-30
+ *
+ * The host has no CCM, so the STM32F407 layout is simulated: a static
+ * array stands in for the free CCM (fast, not DMA capable), another for
+ * SRAM2 (DMA capable), and the kernel TLSF heap is the SRAM heap entry.
+ * Checks that stacks, TCBs and ready-queue nodes land in CCM, that DMA
+ * buffers never do (even when everything else is full), that hot objects
+ * fall back to SRAM once CCM is exhausted, and that a map without CCM
+ * still works. Times region allocation against the plain heap.
+ */
+
+#include "dsrtos_host_port.h"
+#include "dsrtos_region.h"
+#include "dsrtos_memory.h"
+#include "dsrtos_config.h"
+#include "dsrtos_port.h"
+#include <string.h>
+
+/*==============================================================================
+ * CONFIGURATION
+ *============================================================================*/
+
+#define SIM_CCM_SIZE            (16384U)
+#define SIM_SRAM2_SIZE          (4096U)
+#define BENCH_ITERATIONS        (20000U)
+#define BENCH_LIVE              (16U)
+
+#define REGION_HEAP             (0U)
+#define REGION_CCM              (1U)
+#define REGION_SRAM2            (2U)
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+static uint8_t g_sim_ccm[SIM_CCM_SIZE] __attribute__((aligned(8)));
+static uint8_t g_sim_sram2[SIM_SRAM2_SIZE] __attribute__((aligned(8)));
+static void *g_live[BENCH_LIVE];
+
+/*==============================================================================
+ * HELPERS
+ *============================================================================*/
+
+/* Heap first (search order), then CCM, then SRAM2 */
+static void install_f407_map(void)
+{
+    dsrtos_region_desc_t map[3] = {
+        { "sram",  NULL,        0U,             DSRTOS_REGION_ATTR_DMA | DSRTOS_REGION_ATTR_HEAP },
+        { "ccm",   g_sim_ccm,   SIM_CCM_SIZE,   DSRTOS_REGION_ATTR_FAST },
+        { "sram2", g_sim_sram2, SIM_SRAM2_SIZE, DSRTOS_REGION_ATTR_DMA }
+    };
+
+    HOST_CHECK(dsrtos_region_init(map, 3U) == DSRTOS_SUCCESS);
+}
+
+static void *alloc_or_null(dsrtos_mem_class_t mem_class, dsrtos_size_t size)
+{
+    void *ptr = NULL;
+
+    (void)dsrtos_region_alloc(mem_class, size, &ptr);
+    return ptr;
+}
+
+/*==============================================================================
+ * FUNCTIONAL CHECKS
+ *============================================================================*/
+
+static void check_arguments(void)
+{
+    dsrtos_region_desc_t bad = { "bad", &g_sim_ccm[1], 64U, DSRTOS_REGION_ATTR_FAST };
+    dsrtos_region_stats_t stats;
+    void *ptr = NULL;
+
+    HOST_CHECK(dsrtos_region_alloc(DSRTOS_MEM_CLASS_TCB, 64U, &ptr) == DSRTOS_ERROR_NOT_INITIALIZED);
+    HOST_CHECK(dsrtos_region_init(NULL, 1U) == DSRTOS_ERROR_NULL_POINTER);
+    HOST_CHECK(dsrtos_region_init(&bad, 0U) == DSRTOS_ERROR_INVALID_SIZE);
+    HOST_CHECK(dsrtos_region_init(&bad, DSRTOS_REGION_MAX + 1U) == DSRTOS_ERROR_INVALID_SIZE);
+    HOST_CHECK(dsrtos_region_init(&bad, 1U) == DSRTOS_ERROR_INVALID_ALIGNMENT);
+    HOST_CHECK(dsrtos_region_init_default() == DSRTOS_ERROR_NOT_SUPPORTED);
+
+    install_f407_map();
+    HOST_CHECK(dsrtos_region_alloc(DSRTOS_MEM_CLASS_COUNT, 64U, &ptr) == DSRTOS_ERROR_INVALID_PARAM);
+    HOST_CHECK(dsrtos_region_alloc(DSRTOS_MEM_CLASS_TCB, 0U, &ptr) == DSRTOS_ERROR_INVALID_PARAM);
+    HOST_CHECK(dsrtos_region_free(NULL) == DSRTOS_ERROR_NULL_POINTER);
+    HOST_CHECK(dsrtos_region_get_stats(3U, &stats) == DSRTOS_ERROR_INVALID_PARAM);
+}
+
+static void check_placement(void)
+{
+    dsrtos_region_stats_t stats;
+    void *stack;
+    void *tcb;
+    void *node;
+    void *dma;
+    void *general;
+    void *again;
+
+    install_f407_map();
+
+    stack = alloc_or_null(DSRTOS_MEM_CLASS_STACK, 1024U);
+    tcb = alloc_or_null(DSRTOS_MEM_CLASS_TCB, 200U);
+    node = alloc_or_null(DSRTOS_MEM_CLASS_READY_QUEUE, 24U);
+    dma = alloc_or_null(DSRTOS_MEM_CLASS_DMA_BUFFER, 512U);
+    general = alloc_or_null(DSRTOS_MEM_CLASS_GENERAL, 100U);
+
+    HOST_CHECK(dsrtos_region_of(stack) == REGION_CCM);
+    HOST_CHECK(dsrtos_region_of(tcb) == REGION_CCM);
+    HOST_CHECK(dsrtos_region_of(node) == REGION_CCM);
+    HOST_CHECK(dsrtos_region_of(general) == DSRTOS_REGION_NONE);     /* TLSF heap */
+    HOST_CHECK((dma != NULL) && (dsrtos_region_of(dma) != REGION_CCM));
+    HOST_CHECK(((uintptr_t)tcb % DSRTOS_CONFIG_MEMORY_ALIGNMENT) == 0U);
+    HOST_CHECK(((uintptr_t)node % DSRTOS_CONFIG_MEMORY_ALIGNMENT) == 0U);
+
+    /* Freed blocks are reused by their size class */
+    HOST_CHECK(dsrtos_region_free(tcb) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_region_free(tcb) == DSRTOS_ERROR_INVALID_ADDRESS);
+    again = alloc_or_null(DSRTOS_MEM_CLASS_TCB, 150U);
+    HOST_CHECK(again == tcb);
+
+    HOST_CHECK(dsrtos_region_get_stats(REGION_CCM, &stats) == DSRTOS_SUCCESS);
+    HOST_CHECK(stats.size == SIM_CCM_SIZE);
+    HOST_CHECK(stats.alloc_count == 4U);
+    HOST_CHECK(stats.free_count == 1U);
+    HOST_CHECK(stats.in_use == (3U * 8U) + 1024U + 256U + 32U);
+    HOST_CHECK(stats.fallback_count == 0U);
+
+    HOST_CHECK(dsrtos_region_free(stack) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_region_free(again) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_region_free(node) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_region_free(dma) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_region_free(general) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_region_get_stats(REGION_CCM, &stats) == DSRTOS_SUCCESS);
+    HOST_CHECK(stats.in_use == 0U);
+}
+
+static void check_exhaustion(void)
+{
+    dsrtos_region_stats_t ccm;
+    dsrtos_region_stats_t heap;
+    dsrtos_memory_heap_info_t info;
+    void *stacks[32];
+    void *heap_blocks[64];
+    void *dma_blocks[256];
+    void *dma;
+    uint32_t in_ccm = 0U;
+    uint32_t count = 0U;
+    uint32_t blocks = 0U;
+    uint32_t dma_count = 0U;
+    dsrtos_size_t size;
+
+    install_f407_map();
+
+    /* 4 KB stacks: three fit the simulated CCM, the rest fall back */
+    for (count = 0U; count < 8U; count++) {
+        stacks[count] = alloc_or_null(DSRTOS_MEM_CLASS_STACK, 4096U);
+        HOST_CHECK(stacks[count] != NULL);
+        if (dsrtos_region_of(stacks[count]) == REGION_CCM) {
+            in_ccm++;
+        }
+    }
+    HOST_CHECK(in_ccm == 3U);
+    HOST_CHECK(dsrtos_region_get_stats(REGION_HEAP, &heap) == DSRTOS_SUCCESS);
+    HOST_CHECK(heap.fallback_count == 5U);
+
+    /* Fill SRAM: the heap and SRAM2 */
+    HOST_CHECK(dsrtos_memory_get_heap_info(&info) == DSRTOS_SUCCESS);
+    size = info.largest_free_block;
+    while ((blocks < 64U) && (size >= 64U)) {
+        if (dsrtos_memory_allocate(size, &heap_blocks[blocks]) == DSRTOS_SUCCESS) {
+            blocks++;
+        } else {
+            size /= 2U;
+        }
+    }
+    while (dma_count < 256U) {
+        dma_blocks[dma_count] = alloc_or_null(DSRTOS_MEM_CLASS_DMA_BUFFER, 32U);
+        if (dma_blocks[dma_count] == NULL) {
+            break;
+        }
+        HOST_CHECK(dsrtos_region_of(dma_blocks[dma_count]) != REGION_CCM);
+        dma_count++;
+    }
+    HOST_CHECK((dma_count > 0U) && (dma_count < 256U));
+
+    /* CCM still has room, but DMA buffers must never go there */
+    HOST_CHECK(dsrtos_region_get_stats(REGION_CCM, &ccm) == DSRTOS_SUCCESS);
+    HOST_CHECK((ccm.size - ccm.carved) >= (512U + 8U));
+    dma = (void *)&g_sim_ccm[0];
+    HOST_CHECK(dsrtos_region_alloc(DSRTOS_MEM_CLASS_DMA_BUFFER, 512U, &dma) == DSRTOS_ERROR_NO_MEMORY);
+    HOST_CHECK(dma == NULL);
+
+    /* General data falls back into CCM when SRAM is gone */
+    dma = alloc_or_null(DSRTOS_MEM_CLASS_GENERAL, 512U);
+    HOST_CHECK(dsrtos_region_of(dma) == REGION_CCM);
+    HOST_CHECK(dsrtos_region_free(dma) == DSRTOS_SUCCESS);
+
+    for (uint32_t i = 0U; i < dma_count; i++) {
+        HOST_CHECK(dsrtos_region_free(dma_blocks[i]) == DSRTOS_SUCCESS);
+    }
+    for (uint32_t i = 0U; i < blocks; i++) {
+        HOST_CHECK(dsrtos_memory_free(heap_blocks[i]) == DSRTOS_SUCCESS);
+    }
+    for (uint32_t i = 0U; i < count; i++) {
+        HOST_CHECK(dsrtos_region_free(stacks[i]) == DSRTOS_SUCCESS);
+    }
+}
+
+static void check_no_ccm(void)
+{
+    dsrtos_region_desc_t map[1] = {
+        { "sram", NULL, 0U, DSRTOS_REGION_ATTR_DMA | DSRTOS_REGION_ATTR_HEAP }
+    };
+    dsrtos_region_policy_t strict = { DSRTOS_REGION_ATTR_FAST, DSRTOS_REGION_ATTR_FAST };
+    dsrtos_region_policy_t relaxed = { 0U, DSRTOS_REGION_ATTR_FAST };
+    void *stack;
+    void *ptr = NULL;
+
+    HOST_CHECK(dsrtos_region_init(map, 1U) == DSRTOS_SUCCESS);
+    stack = alloc_or_null(DSRTOS_MEM_CLASS_STACK, 1024U);
+    HOST_CHECK(stack != NULL);
+    HOST_CHECK(dsrtos_region_free(stack) == DSRTOS_SUCCESS);
+
+    /* A class that requires fast memory fails instead of degrading */
+    HOST_CHECK(dsrtos_region_set_policy(DSRTOS_MEM_CLASS_STACK, &strict) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_region_alloc(DSRTOS_MEM_CLASS_STACK, 1024U, &ptr) == DSRTOS_ERROR_NO_MEMORY);
+    HOST_CHECK(dsrtos_region_set_policy(DSRTOS_MEM_CLASS_STACK, &relaxed) == DSRTOS_SUCCESS);
+}
+
+/*==============================================================================
+ * BENCHMARKS
+ *============================================================================*/
+
+static void bench_alloc(const char *name, dsrtos_mem_class_t mem_class, bool use_region)
+{
+    dsrtos_host_sample_t alloc_sample;
+    dsrtos_host_sample_t free_sample;
+
+    dsrtos_host_sample_init(&alloc_sample, name);
+    dsrtos_host_sample_init(&free_sample, "  free");
+    dsrtos_host_srand(0x2E610000U);
+    (void)memset(g_live, 0, sizeof(g_live));
+
+    for (uint32_t i = 0U; i < BENCH_ITERATIONS; i++) {
+        uint32_t slot = dsrtos_host_rand() % BENCH_LIVE;
+        dsrtos_size_t size = 16U + (dsrtos_host_rand() % 240U);
+        uint32_t t0;
+        uint32_t t1;
+        dsrtos_error_t err;
+
+        if (g_live[slot] != NULL) {
+            t0 = dsrtos_port_get_cycle_count();
+            err = use_region ? dsrtos_region_free(g_live[slot]) : dsrtos_memory_free(g_live[slot]);
+            t1 = dsrtos_port_get_cycle_count();
+            HOST_CHECK(err == DSRTOS_SUCCESS);
+            dsrtos_host_sample_add(&free_sample, t1 - t0);
+        }
+
+        t0 = dsrtos_port_get_cycle_count();
+        err = use_region ? dsrtos_region_alloc(mem_class, size, &g_live[slot]) :
+                           dsrtos_memory_allocate(size, &g_live[slot]);
+        t1 = dsrtos_port_get_cycle_count();
+        HOST_CHECK(err == DSRTOS_SUCCESS);
+        dsrtos_host_sample_add(&alloc_sample, t1 - t0);
+    }
+
+    for (uint32_t i = 0U; i < BENCH_LIVE; i++) {
+        if (g_live[i] != NULL) {
+            HOST_CHECK((use_region ? dsrtos_region_free(g_live[i]) :
+                                     dsrtos_memory_free(g_live[i])) == DSRTOS_SUCCESS);
+        }
+    }
+
+    dsrtos_host_sample_print(&alloc_sample);
+    dsrtos_host_sample_print(&free_sample);
+}
+
+/*==============================================================================
+ * MAIN
+ *============================================================================*/
+
+int main(void)
+{
+    dsrtos_memory_heap_info_t info;
+
+    HOST_CHECK(dsrtos_memory_init() == DSRTOS_SUCCESS);
+
+    check_arguments();
+    check_placement();
+    check_exhaustion();
+    check_no_ccm();
+
+    install_f407_map();
+    (void)printf("Region placement benchmark (%u alloc/free pairs, %u live, cycles)\n",
+                 BENCH_ITERATIONS, BENCH_LIVE);
+    bench_alloc("heap alloc", DSRTOS_MEM_CLASS_GENERAL, false);
+    bench_alloc("region alloc (TCB -> CCM)", DSRTOS_MEM_CLASS_TCB, true);
+    bench_alloc("region alloc (general -> heap)", DSRTOS_MEM_CLASS_GENERAL, true);
+
+    HOST_CHECK(dsrtos_memory_get_heap_info(&info) == DSRTOS_SUCCESS);
+    HOST_CHECK(info.allocated_size == 0U);
+
+    return dsrtos_host_finish("dsrtos_bench_region");
+}
@@ -0,0 +1,481 @@
+/*
+ * @file dsrtos_bench_replay.c
+ * @brief Record and replay: identical reruns, divergence, ring overflow and cost (host port)
+ * @date 2024-12-30
+ *
+ * Runs a small system of four tasks fed by SysTick, a UART and random
+ * timer and ADC values, recording it while a drain empties the ring. The
+ * log is then replayed with the live sources switched to other values
+ * and the interrupts coming only from the log: the run must end in the
+ * same state, at the same tick, without a divergence. Damaged logs must
+ * be caught at the damaged record, and a ring that overflows must say how
+ * much it lost. Then times an input point off and recording.
+ */
+
+#include "dsrtos_host_port.h"
+#include "dsrtos_replay.h"
+#include "dsrtos_task_manager.h"
+#include "dsrtos_kernel.h"
+#include "dsrtos_hooks.h"
+#include "dsrtos_port.h"
+#include <stdio.h>
+#include <string.h>
+
+/*==============================================================================
+ * CONFIGURATION
+ *============================================================================*/
+
+#define BENCH_TASKS             (4U)
+#define BENCH_STEPS             (20000U)
+#define BENCH_DRAIN_EVERY       (16U)           /* Steps between drains */
+#define BENCH_LOG_MAX           (1U << 17)
+#define BENCH_SMALL_RING        (16U)
+#define BENCH_SLICE             (3U)            /* Ticks */
+#define BENCH_RX_BURST          (8U)            /* Pending bytes that run comms */
+#define BENCH_TICK_START        (0xFFF0U)       /* Crosses a tick epoch */
+#define BENCH_TIME_START        (0xFFFFF000ULL) /* Crosses a timer high word */
+
+#define BENCH_IRQ_SYSTICK       (-1)
+#define BENCH_IRQ_UART          (37)
+
+#define BENCH_BATCH             (256U)
+#define BENCH_BATCHES           (4000U)
+#define BENCH_RECORD_MAX        (1000U)         /* Cycles per input, soak budget */
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+/* Everything the tasks and handlers compute */
+typedef struct {
+    uint32_t hash;
+    uint32_t current;
+    uint32_t slice;
+    uint32_t rx_pending;
+    uint32_t switches;
+    bool resched;
+} bench_system_t;
+
+static bench_system_t g_sys;
+static dsrtos_tcb_t g_tcbs[BENCH_TASKS];
+
+/* Live sources: the environment fires interrupts only while live */
+static bool g_live;
+static uint64_t g_live_time;
+
+static dsrtos_replay_record_t g_log[BENCH_LOG_MAX];
+static dsrtos_replay_record_t g_copy[BENCH_LOG_MAX];
+static dsrtos_replay_record_t g_small[BENCH_SMALL_RING];
+static uint32_t g_log_count;
+
+/* Link-time switch hooks, as the hook dispatcher finds them */
+extern const dsrtos_hook_static_t __start_dsrtos_hook_TASK_SWITCH_IN[] __attribute__((weak));
+extern const dsrtos_hook_static_t __stop_dsrtos_hook_TASK_SWITCH_IN[] __attribute__((weak));
+
+/*==============================================================================
+ * HELPERS
+ *============================================================================*/
+
+static void mix(uint32_t value)
+{
+    g_sys.hash = (g_sys.hash ^ value) * 16777619U;
+}
+
+static void switch_to(dsrtos_tcb_t *tcb)
+{
+    for (const dsrtos_hook_static_t *h = __start_dsrtos_hook_TASK_SWITCH_IN;
+         h < __stop_dsrtos_hook_TASK_SWITCH_IN; h++) {
+        (void)h->function(DSRTOS_HOOK_TASK_SWITCH_IN, tcb);
+    }
+    dsrtos_host_set_current(tcb);
+}
+
+static uint64_t live_time(void)
+{
+    g_live_time += (dsrtos_host_rand() % 1000U) + 1U;
+    return g_live_time;
+}
+
+/* The vector: also the replay injector */
+static void irq_dispatch(int16_t irq_num)
+{
+    uint8_t byte;
+
+    dsrtos_replay_irq(irq_num);
+
+    if (irq_num == BENCH_IRQ_SYSTICK) {
+        dsrtos_host_tick_advance(1U);
+        g_sys.slice++;
+        if (g_sys.slice >= BENCH_SLICE) {
+            g_sys.resched = true;
+        }
+    } else {
+        byte = dsrtos_replay_uart_rx(0U, (uint8_t)dsrtos_host_rand());
+        mix(byte);
+        g_sys.rx_pending++;
+    }
+}
+
+/* Interrupts arrive only here, so polls fix their position exactly */
+static void bench_poll(void)
+{
+    uint32_t r;
+
+    dsrtos_replay_poll();
+    if (g_live) {
+        r = dsrtos_host_rand() % 1000U;
+        if (r < 60U) {
+            irq_dispatch(BENCH_IRQ_SYSTICK);
+        } else if (r < 100U) {
+            irq_dispatch(BENCH_IRQ_UART);
+        } else {
+            /* No interrupt */
+        }
+    }
+}
+
+static void task_step(uint32_t task)
+{
+    switch (task) {
+    case 0U:    /* control: timer and ADC */
+        mix((uint32_t)(dsrtos_replay_timer(live_time()) >> 8U));
+        bench_poll();
+        mix(dsrtos_replay_input(dsrtos_host_rand() & 0xFFFU));
+        bench_poll();
+        break;
+
+    case 1U:    /* comms: waits for and drains received bytes */
+        bench_poll();
+        while (g_sys.rx_pending > 0U) {
+            g_sys.rx_pending--;
+            mix(g_sys.rx_pending);
+            bench_poll();
+        }
+        break;
+
+    case 2U:    /* logger: timestamps */
+        mix((uint32_t)dsrtos_replay_timer(live_time()));
+        bench_poll();
+        bench_poll();
+        break;
+
+    default:    /* idle */
+        bench_poll();
+        break;
+    }
+}
+
+static void schedule(void)
+{
+    uint32_t next = g_sys.current;
+
+    if (g_sys.rx_pending > BENCH_RX_BURST) {
+        next = 1U;
+    } else if (g_sys.resched) {
+        next = (g_sys.current + 1U) % BENCH_TASKS;
+    } else {
+        /* Keep running */
+    }
+    g_sys.resched = false;
+
+    if (next != g_sys.current) {
+        g_sys.slice = 0U;
+        g_sys.switches++;
+        switch_to(&g_tcbs[next]);
+        g_sys.current = next;
+        mix(next);
+    }
+}
+
+/* Same starting state for every run */
+static void reset_system(uint32_t seed, bool live)
+{
+    (void)memset(&g_sys, 0, sizeof(g_sys));
+    for (uint32_t i = 0U; i < BENCH_TASKS; i++) {
+        (void)memset(&g_tcbs[i], 0, sizeof(g_tcbs[i]));
+        g_tcbs[i].task_id = i + 1U;
+    }
+    dsrtos_host_set_current(&g_tcbs[0]);
+    dsrtos_host_tick_set(BENCH_TICK_START);
+    dsrtos_host_srand(seed);
+    g_live_time = BENCH_TIME_START;
+    g_live = live;
+}
+
+static void drain_log(void)
+{
+    g_log_count += dsrtos_replay_drain(&g_log[g_log_count], BENCH_LOG_MAX - g_log_count);
+}
+
+static void run_system(bool drain)
+{
+    for (uint32_t i = 0U; i < BENCH_STEPS; i++) {
+        task_step(g_sys.current);
+        schedule();
+        if (drain && ((i % BENCH_DRAIN_EVERY) == 0U)) {
+            drain_log();
+        }
+    }
+}
+
+/*==============================================================================
+ * FUNCTIONAL CHECKS
+ *============================================================================*/
+
+static void check_round_trip(void)
+{
+    dsrtos_replay_stats_t stats;
+    uint32_t hash;
+    uint32_t tick;
+    uint32_t switches;
+    uint32_t irqs = 0U;
+    uint32_t epochs = 0U;
+    uint32_t timer_hi = 0U;
+
+    HOST_CHECK(dsrtos_replay_init(NULL, 0U) == DSRTOS_SUCCESS);
+
+    /* Record, draining as a soak test would */
+    reset_system(11U, true);
+    g_log_count = 0U;
+    HOST_CHECK(dsrtos_replay_record_start() == DSRTOS_SUCCESS);
+    run_system(true);
+    dsrtos_replay_stop();
+    drain_log();
+    hash = g_sys.hash;
+    tick = dsrtos_get_tick_count();
+    switches = g_sys.switches;
+
+    HOST_CHECK(dsrtos_replay_get_stats(&stats) == DSRTOS_SUCCESS);
+    HOST_CHECK(stats.lost == 0U);
+    HOST_CHECK(stats.drained == g_log_count);
+    HOST_CHECK(stats.recorded == g_log_count);
+    HOST_CHECK(stats.high_water <= DSRTOS_REPLAY_RECORDS);
+    for (uint32_t i = 0U; i < g_log_count; i++) {
+        irqs += (DSRTOS_REPLAY_TYPE(&g_log[i]) == DSRTOS_REPLAY_IRQ) ? 1U : 0U;
+        epochs += (DSRTOS_REPLAY_TYPE(&g_log[i]) == DSRTOS_REPLAY_EPOCH) ? 1U : 0U;
+        timer_hi += (DSRTOS_REPLAY_TYPE(&g_log[i]) == DSRTOS_REPLAY_TIMER_HI) ? 1U : 0U;
+    }
+    HOST_CHECK((irqs > 1000U) && (switches > 100U));
+    HOST_CHECK((epochs >= 2U) && (timer_hi >= 1U));
+    HOST_CHECK(tick > 0x10000U);
+
+    /* Another live run takes another path */
+    reset_system(99U, true);
+    run_system(false);
+    HOST_CHECK(g_sys.hash != hash);
+
+    /* Replay with other live values: only the log drives the run */
+    reset_system(99U, false);
+    HOST_CHECK(dsrtos_replay_start(g_log, g_log_count, irq_dispatch) == DSRTOS_SUCCESS);
+    run_system(false);
+    HOST_CHECK(dsrtos_replay_get_stats(&stats) == DSRTOS_SUCCESS);
+    HOST_CHECK(stats.divergences == 0U);
+    HOST_CHECK(stats.first_divergence == UINT32_MAX);
+    HOST_CHECK(stats.replayed == g_log_count);
+    HOST_CHECK(g_sys.hash == hash);
+    HOST_CHECK(dsrtos_get_tick_count() == tick);
+    HOST_CHECK(g_sys.switches == switches);
+
+    /* Past the end of the log the inputs are live again */
+    HOST_CHECK(dsrtos_replay_input(1234U) == 1234U);
+    HOST_CHECK(g_dsrtos_replay_mode == (uint32_t)DSRTOS_REPLAY_MODE_OFF);
+    dsrtos_replay_stop();
+
+    (void)printf("Round trip: %u steps, %u records (%u interrupts, %u switches) replayed identically\n",
+                 BENCH_STEPS, (unsigned)g_log_count, (unsigned)irqs, (unsigned)switches);
+}
+
+static uint32_t find_record(uint32_t type, uint32_t from)
+{
+    for (uint32_t i = from; i < g_log_count; i++) {
+        if (DSRTOS_REPLAY_TYPE(&g_log[i]) == type) {
+            return i;
+        }
+    }
+    return UINT32_MAX;
+}
+
+static void replay_copy(dsrtos_replay_stats_t *stats)
+{
+    reset_system(99U, false);
+    HOST_CHECK(dsrtos_replay_start(g_copy, g_log_count, irq_dispatch) == DSRTOS_SUCCESS);
+    run_system(false);
+    dsrtos_replay_stop();
+    HOST_CHECK(dsrtos_replay_get_stats(stats) == DSRTOS_SUCCESS);
+}
+
+static void check_divergence(void)
+{
+    dsrtos_replay_stats_t stats;
+    uint32_t index;
+
+    /* A different switch decision is reported, replay carries on */
+    index = find_record(DSRTOS_REPLAY_SWITCH, g_log_count / 2U);
+    HOST_CHECK(index != UINT32_MAX);
+    (void)memcpy(g_copy, g_log, g_log_count * sizeof(g_log[0]));
+    g_copy[index].value ^= 1U;
+    replay_copy(&stats);
+    HOST_CHECK(stats.divergences == 1U);
+    HOST_CHECK(stats.first_divergence == index);
+    HOST_CHECK(stats.replayed == g_log_count);
+
+    /* An input reached at another tick */
+    index = find_record(DSRTOS_REPLAY_INPUT, g_log_count / 3U);
+    HOST_CHECK(index != UINT32_MAX);
+    (void)memcpy(g_copy, g_log, g_log_count * sizeof(g_log[0]));
+    g_copy[index].tick++;
+    replay_copy(&stats);
+    HOST_CHECK(stats.divergences == 1U);
+    HOST_CHECK(stats.first_divergence == index);
+
+    /* Another input than recorded ends the replay there */
+    (void)memcpy(g_copy, g_log, g_log_count * sizeof(g_log[0]));
+    g_copy[index].type_task = (uint16_t)((DSRTOS_REPLAY_UART_RX << 12U) | DSRTOS_REPLAY_TASK(&g_copy[index]));
+    replay_copy(&stats);
+    HOST_CHECK(stats.divergences == 1U);
+    HOST_CHECK(stats.first_divergence == index);
+    HOST_CHECK(stats.replayed == index);
+
+    /* So does a hole */
+    (void)memcpy(g_copy, g_log, g_log_count * sizeof(g_log[0]));
+    g_copy[index].type_task = (uint16_t)(DSRTOS_REPLAY_LOST << 12U);
+    replay_copy(&stats);
+    HOST_CHECK(stats.divergences == 1U);
+    HOST_CHECK(stats.first_divergence == index);
+}
+
+static void check_overflow(void)
+{
+    dsrtos_replay_stats_t stats;
+    dsrtos_replay_record_t out[BENCH_SMALL_RING];
+    uint32_t n;
+
+    HOST_CHECK(dsrtos_replay_init(g_small, 12U) == DSRTOS_ERROR_INVALID_PARAM);
+    HOST_CHECK(dsrtos_replay_init(g_small, 2U) == DSRTOS_ERROR_INVALID_PARAM);
+    HOST_CHECK(dsrtos_replay_init(g_small, BENCH_SMALL_RING) == DSRTOS_SUCCESS);
+
+    /* Nobody drains: EPOCH and 15 inputs fit, 25 are lost */
+    reset_system(1U, false);
+    HOST_CHECK(dsrtos_replay_record_start() == DSRTOS_SUCCESS);
+    for (uint32_t i = 0U; i < 40U; i++) {
+        (void)dsrtos_replay_input(i);
+    }
+    HOST_CHECK(dsrtos_replay_get_stats(&stats) == DSRTOS_SUCCESS);
+    HOST_CHECK((stats.recorded == BENCH_SMALL_RING) && (stats.lost == 25U));
+    HOST_CHECK(stats.high_water == BENCH_SMALL_RING);
+
+    n = dsrtos_replay_drain(out, BENCH_SMALL_RING);
+    HOST_CHECK(n == BENCH_SMALL_RING);
+    HOST_CHECK(DSRTOS_REPLAY_TYPE(&out[0]) == DSRTOS_REPLAY_EPOCH);
+    HOST_CHECK(out[0].value == BENCH_TICK_START);
+    HOST_CHECK(DSRTOS_REPLAY_TASK(&out[1]) == 1U);
+    HOST_CHECK((DSRTOS_REPLAY_TYPE(&out[15]) == DSRTOS_REPLAY_INPUT) && (out[15].value == 14U));
+    (void)memcpy(g_copy, out, sizeof(out));
+
+    /* With room again: the hole, the full tick, then the next input */
+    (void)dsrtos_replay_input(40U);
+    dsrtos_replay_stop();
+    n = dsrtos_replay_drain(out, BENCH_SMALL_RING);
+    HOST_CHECK(n == 3U);
+    HOST_CHECK((DSRTOS_REPLAY_TYPE(&out[0]) == DSRTOS_REPLAY_LOST) && (out[0].value == 25U));
+    HOST_CHECK(DSRTOS_REPLAY_TYPE(&out[1]) == DSRTOS_REPLAY_EPOCH);
+    HOST_CHECK((DSRTOS_REPLAY_TYPE(&out[2]) == DSRTOS_REPLAY_INPUT) && (out[2].value == 40U));
+    (void)memcpy(&g_copy[BENCH_SMALL_RING], out, 3U * sizeof(out[0]));
+
+    /* Replay serves what survived and stops at the hole */
+    HOST_CHECK(dsrtos_replay_start(g_copy, BENCH_SMALL_RING + 3U, NULL) == DSRTOS_SUCCESS);
+    for (uint32_t i = 0U; i < 15U; i++) {
+        HOST_CHECK(dsrtos_replay_input(1000U) == i);
+    }
+    HOST_CHECK(dsrtos_replay_input(1000U) == 1000U);
+    HOST_CHECK(dsrtos_replay_get_stats(&stats) == DSRTOS_SUCCESS);
+    HOST_CHECK((stats.divergences == 1U) && (stats.first_divergence == BENCH_SMALL_RING));
+    HOST_CHECK(g_dsrtos_replay_mode == (uint32_t)DSRTOS_REPLAY_MODE_OFF);
+
+    /* Off: every input point passes the live value through */
+    HOST_CHECK(dsrtos_replay_uart_rx(0U, 0x5AU) == 0x5AU);
+    HOST_CHECK(dsrtos_replay_timer(0x123456789ULL) == 0x123456789ULL);
+}
+
+/*==============================================================================
+ * BENCHMARKS
+ *============================================================================*/
+
+static void bench_input(dsrtos_host_sample_t *sample, bool record)
+{
+    dsrtos_replay_record_t out[BENCH_BATCH];
+    uint32_t sink = 0U;
+    uint32_t t0;
+    uint32_t t1;
+
+    HOST_CHECK(dsrtos_replay_init(NULL, 0U) == DSRTOS_SUCCESS);
+    reset_system(5U, false);
+    if (record) {
+        HOST_CHECK(dsrtos_replay_record_start() == DSRTOS_SUCCESS);
+    }
+
+    for (uint32_t b = 0U; b < BENCH_BATCHES; b++) {
+        t0 = dsrtos_port_get_cycle_count();
+        for (uint32_t i = 0U; i < BENCH_BATCH; i++) {
+            sink += dsrtos_replay_input(i);
+        }
+        t1 = dsrtos_port_get_cycle_count();
+        dsrtos_host_sample_add(sample, (t1 - t0) / BENCH_BATCH);
+        (void)dsrtos_replay_drain(out, BENCH_BATCH);
+    }
+    dsrtos_replay_stop();
+    HOST_CHECK(sink == (BENCH_BATCHES * ((BENCH_BATCH * (BENCH_BATCH - 1U)) / 2U)));
+}
+
+static void bench_record(void)
+{
+    dsrtos_host_sample_t off;
+    dsrtos_host_sample_t recording;
+    dsrtos_replay_stats_t stats;
+    uint64_t start;
+    uint64_t elapsed;
+
+    dsrtos_host_sample_init(&off, "input point, off");
+    dsrtos_host_sample_init(&recording, "input point, recording");
+    bench_input(&off, false);
+    bench_input(&recording, true);
+    dsrtos_host_sample_print(&off);
+    dsrtos_host_sample_print(&recording);
+    HOST_CHECK(dsrtos_replay_get_stats(&stats) == DSRTOS_SUCCESS);
+    HOST_CHECK(stats.lost == 0U);
+    HOST_CHECK((recording.total_cycles / recording.count) < BENCH_RECORD_MAX);
+
+    /* The whole system, recording and draining */
+    reset_system(11U, true);
+    g_log_count = 0U;
+    start = dsrtos_host_time_ns();
+    HOST_CHECK(dsrtos_replay_record_start() == DSRTOS_SUCCESS);
+    run_system(true);
+    dsrtos_replay_stop();
+    drain_log();
+    elapsed = dsrtos_host_time_ns() - start;
+
+    (void)printf("  %u steps recorded in %.2f ms, %u records, %.1f bytes per step\n",
+                 BENCH_STEPS, (double)elapsed / 1e6, (unsigned)g_log_count,
+                 (double)(g_log_count * sizeof(dsrtos_replay_record_t)) / BENCH_STEPS);
+}
+
+/*==============================================================================
+ * MAIN
+ *============================================================================*/
+
+int main(void)
+{
+    HOST_CHECK(&__start_dsrtos_hook_TASK_SWITCH_IN[0] != &__stop_dsrtos_hook_TASK_SWITCH_IN[0]);
+    HOST_CHECK(dsrtos_replay_record_start() == DSRTOS_ERROR_NOT_INITIALIZED);
+
+    check_round_trip();
+    check_divergence();
+    check_overflow();
+
+    (void)printf("Record and replay benchmark (%u-record ring, %u-byte records)\n",
+                 DSRTOS_REPLAY_RECORDS, (unsigned)sizeof(dsrtos_replay_record_t));
+    bench_record();
+
+    return dsrtos_host_finish("dsrtos_bench_replay");
+}
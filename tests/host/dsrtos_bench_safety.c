@@ -0,0 +1,326 @@
+/*
+ * @file dsrtos_bench_safety.c
+ * @brief Ready queue and context switch cost per safety profile (host port)
+ * @date 2024-12-30
+ *
+ * Built once per DSRTOS_CONFIG_SAFETY_PROFILE (make run-profiles). Checks
+ * that the phase 4 ready queue and context switch give the same results
+ * in every profile: highest priority first, FIFO within a priority,
+ * duplicate and missing task errors, a valid queue after every operation
+ * and a switch that makes the next task current. Where a profile keeps a
+ * check, it also checks that the matching corruption is still caught.
+ * Then it times insert, remove, select and switch with 32 other tasks
+ * ready, and prints one row of the per-profile table.
+ */
+
+#include "dsrtos_host_port.h"
+#include "dsrtos_task_scheduler_interface.h"
+#include "dsrtos_context_switch.h"
+#include "dsrtos_task_manager.h"
+#include "dsrtos_hooks.h"
+#include "dsrtos_port.h"
+#include "stm32f4xx.h"
+#include <stdio.h>
+#include <string.h>
+
+/*==============================================================================
+ * CONFIGURATION
+ *============================================================================*/
+
+#define BENCH_TASKS             (40U)
+#define BENCH_BACKGROUND        (32U)
+#define BENCH_ROUNDS            (20000U)
+#define BENCH_STACK_WORDS       (128U)
+#define BENCH_STACK_PATTERN     (0xDEADBEEFU)
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+extern volatile dsrtos_tcb_t* g_current_task;
+extern volatile dsrtos_tcb_t* g_next_task;
+
+static const char *const g_profile_names[] = { "MINIMAL", "STANDARD", "FULL" };
+
+static dsrtos_scheduler_interface_t g_interface;
+static dsrtos_ready_queue_t *g_queue;
+static dsrtos_tcb_t g_tasks[BENCH_TASKS];
+static uint32_t g_stacks[BENCH_TASKS][BENCH_STACK_WORDS] __attribute__((aligned(8)));
+static uint32_t g_foreign[16] __attribute__((aligned(8)));  /* No task's stack */
+
+/*==============================================================================
+ * KERNEL STUBS
+ *============================================================================*/
+
+volatile uint32_t g_dsrtos_hook_active[DSRTOS_HOOK_CHAINS / 32U];
+
+void* dsrtos_hook_call(dsrtos_hook_type_t type, void* params)
+{
+    (void)type;
+    return params;
+}
+
+void dsrtos_cpu_account_switch(const dsrtos_tcb_t *next)
+{
+    (void)next;
+}
+
+void dsrtos_budget_switch(dsrtos_tcb_t *next)
+{
+    (void)next;
+}
+
+void dsrtos_panic(const char* reason)
+{
+    dsrtos_host_check_failed(__FILE__, __LINE__, reason);
+}
+
+void dsrtos_start_first_task(void)
+{
+}
+
+void dsrtos_task_exit(void)
+{
+}
+
+void dsrtos_assert_failed(const char* expr, const char* file, int line, const char* func)
+{
+    (void)func;
+    dsrtos_host_check_failed(file, line, expr);
+}
+
+static dsrtos_error_t ops_init(void* context)
+{
+    (void)context;
+    return DSRTOS_SUCCESS;
+}
+
+static dsrtos_error_t ops_enqueue(dsrtos_ready_queue_t* queue, dsrtos_tcb_t* task)
+{
+    return dsrtos_ready_queue_insert(queue, task);
+}
+
+static dsrtos_error_t ops_dequeue(dsrtos_ready_queue_t* queue, dsrtos_tcb_t* task)
+{
+    return dsrtos_ready_queue_remove(queue, task);
+}
+
+static const dsrtos_scheduler_ops_t g_ops = {
+    .init = ops_init,
+    .select_next_task = dsrtos_ready_queue_get_highest_priority,
+    .enqueue_task = ops_enqueue,
+    .dequeue_task = ops_dequeue
+};
+
+/*==============================================================================
+ * HELPERS
+ *============================================================================*/
+
+static void task_setup(uint32_t index, uint8_t priority)
+{
+    dsrtos_tcb_t *task = &g_tasks[index];
+
+    (void)memset(task, 0, sizeof(*task));
+    task->task_id = index + 1U;
+    task->magic_number = DSRTOS_TCB_MAGIC;
+    task->state = DSRTOS_TASK_STATE_READY;
+    task->effective_priority = priority;
+    task->static_priority = priority;
+    task->stack_base = g_stacks[index];
+    task->stack_size = (uint32_t)sizeof(g_stacks[index]);
+    task->stack_pointer = &g_stacks[index][BENCH_STACK_WORDS - 16U];
+    task->stack_canary = DSRTOS_STACK_CANARY;
+    g_stacks[index][0] = BENCH_STACK_PATTERN;
+}
+
+static void queue_setup(void)
+{
+    HOST_CHECK(dsrtos_scheduler_interface_init(&g_interface, &g_ops) == DSRTOS_SUCCESS);
+    g_queue = g_interface.ready_queue;
+    HOST_CHECK(g_queue != NULL);
+
+    for (uint32_t i = 0U; i < BENCH_TASKS; i++) {
+        task_setup(i, 0U);
+    }
+}
+
+/*==============================================================================
+ * CHECKS
+ *============================================================================*/
+
+static void check_queue(void)
+{
+    dsrtos_tcb_t *low_a = &g_tasks[0];
+    dsrtos_tcb_t *low_b = &g_tasks[1];
+    dsrtos_tcb_t *low_c = &g_tasks[2];
+    dsrtos_tcb_t *high = &g_tasks[3];
+
+    task_setup(0U, 10U);
+    task_setup(1U, 10U);
+    task_setup(2U, 10U);
+    task_setup(3U, 20U);
+
+    HOST_CHECK(dsrtos_ready_queue_get_highest_priority(g_queue) == NULL);
+    HOST_CHECK(dsrtos_ready_queue_insert(NULL, low_a) == DSRTOS_ERROR_INVALID_PARAM);
+    HOST_CHECK(dsrtos_ready_queue_insert(g_queue, NULL) == DSRTOS_ERROR_INVALID_PARAM);
+    HOST_CHECK(dsrtos_ready_queue_remove(g_queue, low_a) == DSRTOS_ERROR_NOT_FOUND);
+
+    HOST_CHECK(dsrtos_ready_queue_insert(g_queue, low_a) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_ready_queue_insert(g_queue, low_b) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_ready_queue_insert(g_queue, low_c) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_ready_queue_insert(g_queue, low_b) == DSRTOS_ERROR_ALREADY_EXISTS);
+    HOST_CHECK(dsrtos_ready_queue_get_highest_priority(g_queue) == low_a);
+    HOST_CHECK(dsrtos_ready_queue_validate(g_queue));
+
+    /* Highest priority first, then FIFO within the priority */
+    HOST_CHECK(dsrtos_ready_queue_insert(g_queue, high) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_ready_queue_get_highest_priority(g_queue) == high);
+    HOST_CHECK(dsrtos_ready_queue_remove(g_queue, high) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_ready_queue_get_highest_priority(g_queue) == low_a);
+    HOST_CHECK(dsrtos_ready_queue_remove(g_queue, low_b) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_ready_queue_remove(g_queue, low_a) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_ready_queue_get_highest_priority(g_queue) == low_c);
+    HOST_CHECK(dsrtos_ready_queue_validate(g_queue));
+    HOST_CHECK(g_queue->stats.total_tasks == 1U);
+
+#if (DSRTOS_CONFIG_ENABLE_MAGIC_CHECKING != 0U)
+    /* A trampled node is caught before its task is returned */
+    ((dsrtos_queue_node_t *)low_c->queue_node)->magic_end ^= 0x5AU;
+    HOST_CHECK(dsrtos_ready_queue_get_highest_priority(g_queue) == NULL);
+    ((dsrtos_queue_node_t *)low_c->queue_node)->magic_end ^= 0x5AU;
+#endif
+
+#if (DSRTOS_CONFIG_ENABLE_CHECKSUM_VALIDATION != 0U)
+    ((dsrtos_queue_node_t *)low_c->queue_node)->insertion_tick ^= 1U;
+    HOST_CHECK(dsrtos_ready_queue_get_highest_priority(g_queue) == NULL);
+    ((dsrtos_queue_node_t *)low_c->queue_node)->insertion_tick ^= 1U;
+#endif
+
+#if (DSRTOS_CONFIG_ENABLE_REDUNDANT_CHECKS != 0U)
+    /* A flipped bitmap bit is caught and repaired by the next operation */
+    g_queue->priority_bitmap_mirror[0] ^= 0x80000000U;
+    HOST_CHECK(!dsrtos_ready_queue_validate(g_queue));
+    HOST_CHECK(dsrtos_ready_queue_insert(g_queue, low_a) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_ready_queue_validate(g_queue));
+    HOST_CHECK(dsrtos_ready_queue_remove(g_queue, low_a) == DSRTOS_SUCCESS);
+#endif
+
+    HOST_CHECK(dsrtos_ready_queue_get_highest_priority(g_queue) == low_c);
+    HOST_CHECK(dsrtos_ready_queue_remove(g_queue, low_c) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_ready_queue_get_highest_priority(g_queue) == NULL);
+    HOST_CHECK(dsrtos_ready_queue_validate(g_queue));
+}
+
+static void check_switch(void)
+{
+    dsrtos_tcb_t *from = &g_tasks[0];
+    dsrtos_tcb_t *to = &g_tasks[1];
+    dsrtos_context_stats_t stats;
+
+    task_setup(0U, 10U);
+    task_setup(1U, 20U);
+    from->state = DSRTOS_TASK_STATE_RUNNING;
+
+    g_current_task = from;
+    g_next_task = to;
+    dsrtos_switch_context_handler((uint32_t *)from->stack_pointer);
+    HOST_CHECK(g_current_task == to);
+    HOST_CHECK(to->state == DSRTOS_TASK_STATE_RUNNING);
+    HOST_CHECK(from->state == DSRTOS_TASK_STATE_READY);
+
+    /* A saved stack pointer outside the stack stops the switch */
+    g_next_task = from;
+    dsrtos_switch_context_handler(&g_foreign[8]);
+    HOST_CHECK(g_current_task == to);
+
+    HOST_CHECK(dsrtos_context_get_stats(&stats) == DSRTOS_SUCCESS);
+    HOST_CHECK(stats.switch_count == 1U);
+}
+
+/*==============================================================================
+ * BENCHMARK
+ *============================================================================*/
+
+static void bench_operations(void)
+{
+    dsrtos_host_sample_t insert;
+    dsrtos_host_sample_t remove;
+    dsrtos_host_sample_t select;
+    dsrtos_host_sample_t swap;
+    dsrtos_tcb_t *probe = &g_tasks[BENCH_TASKS - 1U];
+    dsrtos_tcb_t *other = &g_tasks[BENCH_TASKS - 2U];
+    dsrtos_tcb_t *volatile picked;
+    uint32_t start;
+    uint32_t profile = DSRTOS_CONFIG_SAFETY_PROFILE;
+
+    dsrtos_host_sample_init(&insert, "insert");
+    dsrtos_host_sample_init(&remove, "remove");
+    dsrtos_host_sample_init(&select, "select (get highest)");
+    dsrtos_host_sample_init(&swap, "switch (PendSV handler)");
+
+    dsrtos_host_srand(0x5AFE7700U);
+    for (uint32_t i = 0U; i < BENCH_BACKGROUND; i++) {
+        task_setup(i, (uint8_t)(dsrtos_host_rand() % 24U));
+        HOST_CHECK(dsrtos_ready_queue_insert(g_queue, &g_tasks[i]) == DSRTOS_SUCCESS);
+    }
+    task_setup(BENCH_TASKS - 1U, 28U);
+    task_setup(BENCH_TASKS - 2U, 12U);
+    other->state = DSRTOS_TASK_STATE_RUNNING;
+    g_current_task = other;
+
+    for (uint32_t round = 0U; round < BENCH_ROUNDS; round++) {
+        start = dsrtos_port_get_cycle_count();
+        (void)dsrtos_ready_queue_insert(g_queue, probe);
+        dsrtos_host_sample_add(&insert, dsrtos_port_get_cycle_count() - start);
+
+        start = dsrtos_port_get_cycle_count();
+        picked = dsrtos_ready_queue_get_highest_priority(g_queue);
+        dsrtos_host_sample_add(&select, dsrtos_port_get_cycle_count() - start);
+
+        start = dsrtos_port_get_cycle_count();
+        (void)dsrtos_ready_queue_remove(g_queue, probe);
+        dsrtos_host_sample_add(&remove, dsrtos_port_get_cycle_count() - start);
+
+        /* Alternate between two tasks so every switch saves and restores */
+        g_next_task = (g_current_task == other) ? probe : other;
+        start = dsrtos_port_get_cycle_count();
+        dsrtos_switch_context_handler((uint32_t *)g_current_task->stack_pointer);
+        dsrtos_host_sample_add(&swap, dsrtos_port_get_cycle_count() - start);
+    }
+    HOST_CHECK(picked != NULL);
+    HOST_CHECK(g_queue->stats.total_tasks == BENCH_BACKGROUND);
+    HOST_CHECK(dsrtos_ready_queue_validate(g_queue));
+
+    dsrtos_host_sample_print(&insert);
+    dsrtos_host_sample_print(&remove);
+    dsrtos_host_sample_print(&select);
+    dsrtos_host_sample_print(&swap);
+
+    /* One row of the per-profile table: best-case cycles */
+    (void)printf("  %-10s %8s %8s %8s %8s\n", "profile", "insert", "remove", "select", "switch");
+    (void)printf("  %-10s %8u %8u %8u %8u\n", g_profile_names[profile],
+                 insert.min_cycles, remove.min_cycles, select.min_cycles, swap.min_cycles);
+}
+
+int main(void)
+{
+    /* Cycle counter already running: context switch init leaves it alone */
+    dsrtos_host_dwt.CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    queue_setup();
+    HOST_CHECK(dsrtos_context_switch_init() == DSRTOS_SUCCESS);
+
+    (void)printf("Safety profile %s: redundant=%u timing=%u magic=%u checksum=%u\n",
+                 g_profile_names[DSRTOS_CONFIG_SAFETY_PROFILE],
+                 DSRTOS_CONFIG_ENABLE_REDUNDANT_CHECKS, DSRTOS_CONFIG_ENABLE_OP_TIMING,
+                 DSRTOS_CONFIG_ENABLE_MAGIC_CHECKING, DSRTOS_CONFIG_ENABLE_CHECKSUM_VALIDATION);
+
+    check_queue();
+    check_switch();
+
+    (void)printf("Safety profile benchmark (%u rounds, %u tasks ready, cycles)\n",
+                 BENCH_ROUNDS, BENCH_BACKGROUND);
+    bench_operations();
+
+    return dsrtos_host_finish("dsrtos_bench_safety");
+}
@@ -0,0 +1,621 @@
+/*
+ * @file dsrtos_bench_scale.c
+ * @brief Kernel operation cost against the number of tasks (host port)
+ * @date 2024-12-30
+ *
+ * Built with DSRTOS_MAX_TASKS raised to 8192. Checks the structures that
+ * keep per-task operations independent of the task count: list removal
+ * through tcb->list_node, the timeout heap (earliest first, cancelled on
+ * unblock, task_param left alone), stack monitors reached through
+ * tcb->stack_monitor and released with the task, and the restart limit
+ * kept in the TCB. Then, for 16 up to 8192 live tasks, all at one
+ * priority (the worst case for a list scan), it times:
+ * - create and delete, including the stack monitor
+ * - phase 3 ready insert, remove and select
+ * - phase 3 timeout insert and cancel with every other task waiting
+ * - phase 4 ready insert, remove and select, and the PendSV switch
+ * - stack check-all and stats collect, per task
+ * and fails if any of them costs more than BENCH_GROWTH_LIMIT times as
+ * much at the largest population as at the smallest. Single operations
+ * are per-call medians; check-all and collect are divided by the task
+ * count, so a linear pass shows as a flat row. Stats collect walks every
+ * one of the DSRTOS_MAX_TASKS task table slots, so its per-task figure
+ * falls as the table fills.
+ */
+
+#include "dsrtos_host_port.h"
+#include "dsrtos_task_creation.h"
+#include "dsrtos_task_queue.h"
+#include "dsrtos_stack_manager.h"
+#include "dsrtos_task_statistics.h"
+#include "dsrtos_task_scheduler_interface.h"
+#include "dsrtos_context_switch.h"
+#include "dsrtos_scheduler_stats.h"
+#include "dsrtos_task_manager.h"
+#include "dsrtos_kernel.h"
+#include "dsrtos_hooks.h"
+#include "dsrtos_region.h"
+#include "dsrtos_port.h"
+#include "stm32f4xx.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*==============================================================================
+ * CONFIGURATION
+ *============================================================================*/
+
+#define BENCH_ROUNDS            (1000U)    /* Samples per single operation */
+#define BENCH_PASSES            (8U)       /* Samples per whole-table pass */
+#define BENCH_STACK_SIZE        (512U)
+#define BENCH_PRIORITY          (10U)
+#define BENCH_TIMEOUT_SPAN      (100000U)
+#define BENCH_STATS_PERIOD      (100U)     /* STATS_SAMPLE_PERIOD_MS */
+#define BENCH_GROWTH_LIMIT      (8U)
+#define BENCH_RESTART_LIMIT     (3U)       /* MAX_RESTART_COUNT */
+#define BENCH_REGION_SIZE       (16U * 1024U * 1024U) /* TCBs and stacks past the pools */
+
+#ifndef DSRTOS_ERROR_LIMIT_EXCEEDED
+#define DSRTOS_ERROR_LIMIT_EXCEEDED (-12) /* As dsrtos_task_creation.c */
+#endif
+
+typedef enum {
+    OP_CREATE = 0,
+    OP_DELETE,
+    OP_P3_INSERT,
+    OP_P3_REMOVE,
+    OP_P3_SELECT,
+    OP_TIMEOUT_ADD,
+    OP_TIMEOUT_CANCEL,
+    OP_P4_INSERT,
+    OP_P4_REMOVE,
+    OP_P4_SELECT,
+    OP_SWITCH,
+    OP_CHECK_ALL,
+    OP_COLLECT,
+    OP_COUNT
+} bench_op_t;
+
+static const char *const g_op_names[OP_COUNT] = {
+    "create", "delete", "p3 insert", "p3 remove", "p3 select", "tmo add", "tmo cancel",
+    "p4 insert", "p4 remove", "p4 select", "switch", "chk/task", "stat/task"
+};
+
+static const uint32_t g_populations[] = { 16U, 64U, 256U, 1024U, 4096U, DSRTOS_MAX_TASKS };
+
+#define BENCH_POPULATIONS       (sizeof(g_populations) / sizeof(g_populations[0]))
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+extern volatile dsrtos_tcb_t* g_current_task;
+extern volatile dsrtos_tcb_t* g_next_task;
+
+static dsrtos_scheduler_interface_t g_interface;
+static dsrtos_ready_queue_t *g_queue;
+static dsrtos_tcb_t *g_live[DSRTOS_MAX_TASKS];
+static uint32_t g_live_count;
+static uint32_t g_samples[BENCH_ROUNDS];
+static uint32_t g_results[BENCH_POPULATIONS][OP_COUNT];
+static uint32_t g_overflows;
+static uint8_t g_task_region[BENCH_REGION_SIZE] __attribute__((aligned(64)));
+
+/*==============================================================================
+ * KERNEL STUBS
+ *============================================================================*/
+
+volatile uint32_t g_dsrtos_hook_active[DSRTOS_HOOK_CHAINS / 32U];
+
+void* dsrtos_hook_call(dsrtos_hook_type_t type, void* params)
+{
+    (void)type;
+    return params;
+}
+
+void dsrtos_cpu_account_switch(const dsrtos_tcb_t *next)
+{
+    (void)next;
+}
+
+void dsrtos_budget_switch(dsrtos_tcb_t *next)
+{
+    (void)next;
+}
+
+dsrtos_error_t dsrtos_budget_detach(dsrtos_tcb_t *tcb)
+{
+    (void)tcb;
+    return DSRTOS_SUCCESS;
+}
+
+void dsrtos_panic(const char* reason)
+{
+    dsrtos_host_check_failed(__FILE__, __LINE__, reason);
+}
+
+void dsrtos_start_first_task(void)
+{
+}
+
+void dsrtos_task_exit(void)
+{
+}
+
+void dsrtos_assert_failed(const char* expr, const char* file, int line, const char* func)
+{
+    (void)func;
+    dsrtos_host_check_failed(file, line, expr);
+}
+
+/* The kernel's task table, as stats collect walks it */
+dsrtos_tcb_t* dsrtos_task_get_by_index(uint32_t index)
+{
+    return (index < g_live_count) ? g_live[index] : NULL;
+}
+
+/* Only reached through the stats exporter, which this benchmark does not run */
+dsrtos_error_t dsrtos_scheduler_stats_get(dsrtos_scheduler_stats_t* stats)
+{
+    (void)stats;
+    return DSRTOS_ERROR_NOT_INITIALIZED;
+}
+
+dsrtos_error_t dsrtos_queue_depth_stats_get(dsrtos_queue_depth_stats_t* stats)
+{
+    (void)stats;
+    return DSRTOS_ERROR_NOT_INITIALIZED;
+}
+
+static dsrtos_error_t ops_init(void* context)
+{
+    (void)context;
+    return DSRTOS_SUCCESS;
+}
+
+static dsrtos_error_t ops_enqueue(dsrtos_ready_queue_t* queue, dsrtos_tcb_t* task)
+{
+    return dsrtos_ready_queue_insert(queue, task);
+}
+
+static dsrtos_error_t ops_dequeue(dsrtos_ready_queue_t* queue, dsrtos_tcb_t* task)
+{
+    return dsrtos_ready_queue_remove(queue, task);
+}
+
+static const dsrtos_scheduler_ops_t g_ops = {
+    .init = ops_init,
+    .select_next_task = dsrtos_ready_queue_get_highest_priority,
+    .enqueue_task = ops_enqueue,
+    .dequeue_task = ops_dequeue
+};
+
+static void overflow_hook(dsrtos_tcb_t *task)
+{
+    (void)task;
+    g_overflows++;
+}
+
+/*==============================================================================
+ * HELPERS
+ *============================================================================*/
+
+static void task_entry(void *param)
+{
+    (void)param;
+}
+
+/* Create a task the way the kernel does, with its stack monitored */
+static dsrtos_tcb_t *create(void)
+{
+    dsrtos_task_create_extended_t params;
+    dsrtos_tcb_t *tcb;
+
+    (void)memset(&params, 0, sizeof(params));
+    (void)strncpy(params.base.name, "scale", DSRTOS_TASK_NAME_MAX_LENGTH - 1U);
+    params.base.entry_point = task_entry;
+    params.base.priority = BENCH_PRIORITY;
+    params.base.stack_size = BENCH_STACK_SIZE;
+    params.use_pool = true;
+
+    tcb = dsrtos_task_create_extended(&params);
+    if (tcb != NULL) {
+        tcb->stack_canary = DSRTOS_STACK_CANARY;
+        (void)dsrtos_stack_init(tcb, tcb->stack_base, tcb->stack_size, task_entry, NULL);
+    }
+
+    return tcb;
+}
+
+static void destroy(dsrtos_tcb_t *tcb)
+{
+    (void)dsrtos_stack_release(tcb);
+    (void)dsrtos_task_release(tcb);
+}
+
+static uint32_t cycles_now(void)
+{
+    __builtin_ia32_lfence();
+    return dsrtos_port_get_cycle_count();
+}
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+static uint32_t median(uint32_t count)
+{
+    qsort(g_samples, count, sizeof(g_samples[0]), compare_u32);
+    return g_samples[count / 2U];
+}
+
+/* Grow or shrink the live set; every live task is ready in both queues */
+static void populate(uint32_t count)
+{
+    dsrtos_tcb_t *tcb;
+
+    while (g_live_count < count) {
+        tcb = create();
+        HOST_CHECK(tcb != NULL);
+        HOST_CHECK(dsrtos_queue_ready_insert(tcb) == DSRTOS_SUCCESS);
+        HOST_CHECK(dsrtos_ready_queue_insert(g_queue, tcb) == DSRTOS_SUCCESS);
+        g_live[g_live_count] = tcb;
+        g_live_count++;
+    }
+
+    while (g_live_count > count) {
+        g_live_count--;
+        tcb = g_live[g_live_count];
+        HOST_CHECK(dsrtos_queue_ready_remove(tcb) == DSRTOS_SUCCESS);
+        HOST_CHECK(dsrtos_ready_queue_remove(g_queue, tcb) == DSRTOS_SUCCESS);
+        destroy(tcb);
+    }
+}
+
+/*==============================================================================
+ * CHECKS
+ *============================================================================*/
+
+static void check_queues(void)
+{
+    dsrtos_tcb_t *a = create();
+    dsrtos_tcb_t *b = create();
+    dsrtos_tcb_t *c = create();
+    void *param = c->task_param;
+    dsrtos_queue_stats_t stats;
+
+    HOST_CHECK((a != NULL) && (b != NULL) && (c != NULL));
+
+    /* FIFO at a level; removal from the middle, the tail and twice */
+    HOST_CHECK(dsrtos_queue_ready_insert(a) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_queue_ready_insert(b) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_queue_ready_insert(c) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_queue_ready_insert(b) == DSRTOS_ERROR_ALREADY_EXISTS);
+    HOST_CHECK(dsrtos_queue_ready_get_highest() == a);
+    HOST_CHECK(dsrtos_queue_ready_remove(b) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_queue_ready_remove(b) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_queue_ready_remove(a) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_queue_ready_get_highest() == c);
+
+    /* A priority change while queued still removes from the right level */
+    c->effective_priority = BENCH_PRIORITY + 1U;
+    HOST_CHECK(dsrtos_queue_ready_remove(c) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_queue_ready_get_highest() == NULL);
+    c->effective_priority = BENCH_PRIORITY;
+    HOST_CHECK(dsrtos_queue_get_stats(&stats) == DSRTOS_SUCCESS);
+    HOST_CHECK(stats.ready_count == 0U);
+
+    /* Timeouts fire earliest first; an unblocked task's timeout is gone */
+    dsrtos_host_tick_set(1000U);
+    HOST_CHECK(dsrtos_queue_blocked_insert(a, 30U) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_queue_blocked_insert(b, 10U) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_queue_blocked_insert(c, 20U) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_queue_ready_insert(a) == DSRTOS_ERROR_ALREADY_EXISTS);
+    HOST_CHECK(c->task_param == param);
+    HOST_CHECK(dsrtos_queue_blocked_remove(c) == DSRTOS_SUCCESS);
+    HOST_CHECK(c->delay_slot == 0U);
+
+    dsrtos_host_tick_set(1009U);
+    HOST_CHECK(dsrtos_queue_process_delayed() == 0U);
+    dsrtos_host_tick_set(1020U);
+    HOST_CHECK(dsrtos_queue_process_delayed() == 1U);
+    HOST_CHECK(dsrtos_queue_ready_get_highest() == b);
+    dsrtos_host_tick_set(1100U);
+    HOST_CHECK(dsrtos_queue_process_delayed() == 1U);
+    HOST_CHECK(dsrtos_queue_get_stats(&stats) == DSRTOS_SUCCESS);
+    HOST_CHECK((stats.ready_count == 2U) && (stats.blocked_count == 0U) &&
+               (stats.delayed_count == 0U));
+    HOST_CHECK(dsrtos_queue_ready_remove(b) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_queue_ready_get_highest() == a);
+    HOST_CHECK(dsrtos_queue_ready_remove(a) == DSRTOS_SUCCESS);
+
+    destroy(a);
+    destroy(b);
+    destroy(c);
+}
+
+static void check_monitors(void)
+{
+    dsrtos_tcb_t *a = create();
+    dsrtos_tcb_t *b = create();
+    stack_manager_stats_t stats;
+    uint32_t watermark;
+
+    HOST_CHECK((a != NULL) && (b != NULL));
+    HOST_CHECK((a->stack_monitor != NULL) && (b->stack_monitor != NULL));
+    HOST_CHECK(dsrtos_stack_get_stats(&stats) == DSRTOS_SUCCESS);
+    HOST_CHECK(stats.total_stacks == 2U);
+    HOST_CHECK(dsrtos_stack_check_all() == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_stack_get_watermark(a, &watermark) == DSRTOS_SUCCESS);
+    HOST_CHECK(watermark < BENCH_STACK_SIZE);
+
+    /* Re-initializing a stack keeps its one monitor */
+    HOST_CHECK(dsrtos_stack_init(a, a->stack_base, a->stack_size, task_entry, NULL) ==
+               DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_stack_get_stats(&stats) == DSRTOS_SUCCESS);
+    HOST_CHECK(stats.total_stacks == 2U);
+
+    /* A trampled guard is found by the walk over monitored tasks */
+    ((uint32_t *)b->stack_base)[0] ^= 1U;
+    HOST_CHECK(dsrtos_stack_check_all() == DSRTOS_ERROR_STACK_OVERFLOW);
+    HOST_CHECK(g_overflows == 1U);
+    ((uint32_t *)b->stack_base)[0] ^= 1U;
+
+    /* Released monitors are no longer checked and come back to the pool */
+    HOST_CHECK(dsrtos_stack_release(b) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_stack_release(b) == DSRTOS_ERROR_NOT_FOUND);
+    HOST_CHECK(b->stack_monitor == NULL);
+    ((uint32_t *)b->stack_base)[0] ^= 1U;
+    HOST_CHECK(dsrtos_stack_check_all() == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_stack_get_stats(&stats) == DSRTOS_SUCCESS);
+    HOST_CHECK(stats.total_stacks == 1U);
+    (void)dsrtos_task_release(b);
+
+    destroy(a);
+    HOST_CHECK(dsrtos_stack_get_stats(&stats) == DSRTOS_SUCCESS);
+    HOST_CHECK(stats.total_stacks == 0U);
+}
+
+static void check_restart(void)
+{
+    dsrtos_tcb_t *a = create();
+    dsrtos_tcb_t *b = create();
+
+    HOST_CHECK((a != NULL) && (b != NULL));
+
+    /* The limit is per task and travels with the TCB */
+    for (uint32_t i = 0U; i < BENCH_RESTART_LIMIT; i++) {
+        HOST_CHECK(dsrtos_task_restart(a) == DSRTOS_SUCCESS);
+    }
+    HOST_CHECK(dsrtos_task_restart(a) == DSRTOS_ERROR_LIMIT_EXCEEDED);
+    HOST_CHECK(dsrtos_task_restart(b) == DSRTOS_SUCCESS);
+    HOST_CHECK(b->restart_count == 1U);
+
+    destroy(a);
+    destroy(b);
+}
+
+/*==============================================================================
+ * BENCHMARK
+ *============================================================================*/
+
+static void bench_population(uint32_t row)
+{
+    uint32_t *result = g_results[row];
+    dsrtos_tcb_t *probe;
+    dsrtos_tcb_t *other;
+    dsrtos_tcb_t *volatile picked = NULL;
+    dsrtos_queue_ready_entry_t head;
+    uint32_t start;
+
+    /* The probe is one of the population */
+    populate(g_populations[row] - 1U);
+
+    for (uint32_t i = 0U; i < BENCH_ROUNDS; i++) {
+        start = cycles_now();
+        probe = create();
+        g_samples[i] = cycles_now() - start;
+        HOST_CHECK(probe != NULL);
+        destroy(probe);
+    }
+    result[OP_CREATE] = median(BENCH_ROUNDS);
+    for (uint32_t i = 0U; i < BENCH_ROUNDS; i++) {
+        probe = create();
+        HOST_CHECK(probe != NULL);
+        start = cycles_now();
+        destroy(probe);
+        g_samples[i] = cycles_now() - start;
+    }
+    result[OP_DELETE] = median(BENCH_ROUNDS);
+
+    probe = create();
+    HOST_CHECK(probe != NULL);
+
+    /* Phase 3 ready queue: the probe goes in and out at the tail */
+    for (uint32_t i = 0U; i < BENCH_ROUNDS; i++) {
+        start = cycles_now();
+        (void)dsrtos_queue_ready_insert(probe);
+        g_samples[i] = cycles_now() - start;
+        (void)dsrtos_queue_ready_remove(probe);
+    }
+    result[OP_P3_INSERT] = median(BENCH_ROUNDS);
+    for (uint32_t i = 0U; i < BENCH_ROUNDS; i++) {
+        (void)dsrtos_queue_ready_insert(probe);
+        start = cycles_now();
+        (void)dsrtos_queue_ready_remove(probe);
+        g_samples[i] = cycles_now() - start;
+    }
+    result[OP_P3_REMOVE] = median(BENCH_ROUNDS);
+    for (uint32_t i = 0U; i < BENCH_ROUNDS; i++) {
+        start = cycles_now();
+        picked = dsrtos_queue_ready_get_highest();
+        g_samples[i] = cycles_now() - start;
+    }
+    result[OP_P3_SELECT] = median(BENCH_ROUNDS);
+    HOST_CHECK(dsrtos_queue_ready_snapshot(&head, 1U) == ((g_live_count > 0U) ? 1U : 0U));
+    HOST_CHECK((g_live_count == 0U) || (picked->task_id == head.task_id));
+
+    /* Timeouts: everyone else waits with a random one */
+    dsrtos_host_tick_set(0U);
+    for (uint32_t i = 0U; i < g_live_count; i++) {
+        HOST_CHECK(dsrtos_queue_ready_remove(g_live[i]) == DSRTOS_SUCCESS);
+        HOST_CHECK(dsrtos_queue_blocked_insert(g_live[i],
+                   1U + (dsrtos_host_rand() % BENCH_TIMEOUT_SPAN)) == DSRTOS_SUCCESS);
+    }
+    for (uint32_t i = 0U; i < BENCH_ROUNDS; i++) {
+        uint32_t timeout = 1U + (dsrtos_host_rand() % BENCH_TIMEOUT_SPAN);
+
+        start = cycles_now();
+        (void)dsrtos_queue_blocked_insert(probe, timeout);
+        g_samples[i] = cycles_now() - start;
+        (void)dsrtos_queue_blocked_remove(probe);
+    }
+    result[OP_TIMEOUT_ADD] = median(BENCH_ROUNDS);
+    for (uint32_t i = 0U; i < BENCH_ROUNDS; i++) {
+        (void)dsrtos_queue_blocked_insert(probe, 1U + (dsrtos_host_rand() % BENCH_TIMEOUT_SPAN));
+        start = cycles_now();
+        (void)dsrtos_queue_blocked_remove(probe);
+        g_samples[i] = cycles_now() - start;
+    }
+    result[OP_TIMEOUT_CANCEL] = median(BENCH_ROUNDS);
+
+    /* Every timeout fires, in order, and puts its task back on the ready queue */
+    dsrtos_host_tick_set(BENCH_TIMEOUT_SPAN);
+    HOST_CHECK(dsrtos_queue_process_delayed() == g_live_count);
+
+    /* Phase 4 ready queue */
+    for (uint32_t i = 0U; i < BENCH_ROUNDS; i++) {
+        start = cycles_now();
+        (void)dsrtos_ready_queue_insert(g_queue, probe);
+        g_samples[i] = cycles_now() - start;
+        (void)dsrtos_ready_queue_remove(g_queue, probe);
+    }
+    result[OP_P4_INSERT] = median(BENCH_ROUNDS);
+    for (uint32_t i = 0U; i < BENCH_ROUNDS; i++) {
+        (void)dsrtos_ready_queue_insert(g_queue, probe);
+        start = cycles_now();
+        (void)dsrtos_ready_queue_remove(g_queue, probe);
+        g_samples[i] = cycles_now() - start;
+    }
+    result[OP_P4_REMOVE] = median(BENCH_ROUNDS);
+    HOST_CHECK(dsrtos_ready_queue_insert(g_queue, probe) == DSRTOS_SUCCESS);
+    for (uint32_t i = 0U; i < BENCH_ROUNDS; i++) {
+        start = cycles_now();
+        picked = dsrtos_ready_queue_get_highest_priority(g_queue);
+        g_samples[i] = cycles_now() - start;
+    }
+    result[OP_P4_SELECT] = median(BENCH_ROUNDS);
+    HOST_CHECK(picked != NULL);
+    HOST_CHECK(dsrtos_ready_queue_validate(g_queue));
+
+    /* Switch between the probe and the first task of the population */
+    other = (g_live_count > 0U) ? g_live[0] : probe;
+    other->state = DSRTOS_TASK_STATE_RUNNING;
+    g_current_task = other;
+    for (uint32_t i = 0U; i < BENCH_ROUNDS; i++) {
+        g_next_task = (g_current_task == other) ? probe : other;
+        start = cycles_now();
+        dsrtos_switch_context_handler((uint32_t *)g_current_task->stack_pointer);
+        g_samples[i] = cycles_now() - start;
+    }
+    result[OP_SWITCH] = median(BENCH_ROUNDS);
+    g_current_task = NULL;
+    HOST_CHECK(dsrtos_ready_queue_remove(g_queue, probe) == DSRTOS_SUCCESS);
+
+    /* Whole-table passes, per task */
+    g_live[g_live_count] = probe;
+    g_live_count++;
+    for (uint32_t i = 0U; i < BENCH_PASSES; i++) {
+        start = cycles_now();
+        HOST_CHECK(dsrtos_stack_check_all() == DSRTOS_SUCCESS);
+        g_samples[i] = (cycles_now() - start) / g_live_count;
+    }
+    result[OP_CHECK_ALL] = median(BENCH_PASSES);
+    for (uint32_t i = 0U; i < BENCH_PASSES; i++) {
+        dsrtos_host_tick_set(BENCH_TIMEOUT_SPAN + ((i + 1U) * BENCH_STATS_PERIOD));
+        start = cycles_now();
+        HOST_CHECK(dsrtos_stats_collect() == DSRTOS_SUCCESS);
+        g_samples[i] = (cycles_now() - start) / g_live_count;
+    }
+    result[OP_COLLECT] = median(BENCH_PASSES);
+    g_live_count--;
+
+    HOST_CHECK(dsrtos_queue_ready_remove(probe) == DSRTOS_SUCCESS);
+    destroy(probe);
+}
+
+static void report(void)
+{
+    uint32_t last = BENCH_POPULATIONS - 1U;
+
+    (void)printf("  %-6s", "tasks");
+    for (uint32_t op = 0U; op < OP_COUNT; op++) {
+        (void)printf(" %10s", g_op_names[op]);
+    }
+    (void)printf("\n");
+
+    for (uint32_t row = 0U; row < BENCH_POPULATIONS; row++) {
+        (void)printf("  %-6u", g_populations[row]);
+        for (uint32_t op = 0U; op < OP_COUNT; op++) {
+            (void)printf(" %10u", g_results[row][op]);
+        }
+        (void)printf("\n");
+    }
+
+    /* Sub-linear: 512x the tasks may not cost BENCH_GROWTH_LIMIT x per operation */
+    for (uint32_t op = 0U; op < OP_COUNT; op++) {
+        uint32_t base = (g_results[0][op] > 0U) ? g_results[0][op] : 1U;
+
+        if (g_results[last][op] > (base * BENCH_GROWTH_LIMIT)) {
+            (void)printf("  %s grows from %u to %u cycles\n", g_op_names[op],
+                         g_results[0][op], g_results[last][op]);
+        }
+        HOST_CHECK(g_results[last][op] <= (base * BENCH_GROWTH_LIMIT));
+    }
+}
+
+int main(void)
+{
+    dsrtos_region_desc_t region;
+
+    /* Cycle counter already running: context switch init leaves it alone */
+    dsrtos_host_dwt.CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    /* One carved region takes every class, in place of the kernel heap */
+    region.name = "tasks";
+    region.base = g_task_region;
+    region.size = BENCH_REGION_SIZE;
+    region.attrs = DSRTOS_REGION_ATTR_DMA | DSRTOS_REGION_ATTR_FAST;
+    HOST_CHECK(dsrtos_region_init(&region, 1U) == DSRTOS_SUCCESS);
+
+    HOST_CHECK(dsrtos_task_creation_init() == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_queue_init() == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_stack_manager_init() == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_stack_register_overflow_hook(overflow_hook) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_stats_init_phase3() == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_stats_enable(true) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_scheduler_interface_init(&g_interface, &g_ops) == DSRTOS_SUCCESS);
+    g_queue = g_interface.ready_queue;
+    HOST_CHECK(g_queue != NULL);
+    HOST_CHECK(dsrtos_context_switch_init() == DSRTOS_SUCCESS);
+
+    check_queues();
+    check_monitors();
+    check_restart();
+
+    (void)printf("Kernel scaling, DSRTOS_MAX_TASKS %u, all tasks at one priority "
+                 "(median cycles; chk/stat per task)\n", DSRTOS_MAX_TASKS);
+    dsrtos_host_srand(0x5CA1E000U);
+    for (uint32_t row = 0U; row < BENCH_POPULATIONS; row++) {
+        bench_population(row);
+    }
+    report();
+
+    populate(0U);
+
+    return dsrtos_host_finish("dsrtos_bench_scale");
+}
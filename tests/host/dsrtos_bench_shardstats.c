@@ -0,0 +1,256 @@
+/*
+ * @file dsrtos_bench_shardstats.c
+ * @brief Per-CPU statistics shards vs one shared counter set (host port)
+ * @date 2024-12-30
+ *
+ * Host threads stand in for CPUs: each thread names its shard through the
+ * CPU hook. Times the same update stream against one shared set of atomic
+ * counters and against per-CPU shards, with 1, 2 and 4 writer threads,
+ * while a reader thread takes snapshots. Every snapshot must see the two
+ * counters that are always updated together as equal, and readers must
+ * never enter a critical section.
+ */
+
+#include "dsrtos_host_port.h"
+#include "dsrtos_shard_stats.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+/*==============================================================================
+ * CONFIGURATION
+ *============================================================================*/
+
+#define BENCH_UPDATES           (1000000U)  /* Per writer thread */
+#define BENCH_MAX_WRITERS       (4U)        /* DSRTOS_CONFIG_CPU_COUNT in the Makefile */
+
+/*==============================================================================
+ * TYPES
+ *============================================================================*/
+
+/* Padded to one cache line so host CPUs do not share lines */
+typedef struct {
+    uint32_t events;
+    uint32_t paired;                    /* Always updated with events */
+    uint32_t max_sample;
+    uint32_t reserved;
+    uint64_t sample_total;
+    uint64_t pad[5];
+} bench_shard_t;
+
+typedef struct {
+    uint32_t cpu;
+    bool sharded;
+} bench_writer_t;
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+static bench_shard_t g_shards[DSRTOS_STATS_SHARD_COUNT] __attribute__((aligned(64)));
+static dsrtos_shard_stats_t g_set;
+static bench_shard_t g_shared __attribute__((aligned(64)));
+
+static _Thread_local uint32_t t_cpu;
+static volatile uint32_t g_stop;
+static volatile uint32_t g_snapshots;
+static volatile uint32_t g_busy;
+static volatile uint32_t g_torn;
+
+/*==============================================================================
+ * HELPERS
+ *============================================================================*/
+
+static uint32_t bench_cpu(void)
+{
+    return t_cpu;
+}
+
+static void bench_merge(void* total, const void* shard)
+{
+    bench_shard_t* sum = (bench_shard_t*)total;
+    const bench_shard_t* cpu = (const bench_shard_t*)shard;
+
+    sum->events += cpu->events;
+    sum->paired += cpu->paired;
+    sum->sample_total += cpu->sample_total;
+    if (cpu->max_sample > sum->max_sample) {
+        sum->max_sample = cpu->max_sample;
+    }
+}
+
+static void* bench_writer(void* arg)
+{
+    const bench_writer_t* writer = (const bench_writer_t*)arg;
+
+    t_cpu = writer->cpu;
+    for (uint32_t i = 0U; i < BENCH_UPDATES; i++) {
+        uint32_t sample = i & 0x3FFU;
+
+        if (writer->sharded) {
+            bench_shard_t* shard = dsrtos_shard_stats_write_begin(&g_set);
+
+            dsrtos_stat_add(&shard->events, 1U);
+            dsrtos_stat_add(&shard->paired, 1U);
+            dsrtos_stat_max(&shard->max_sample, sample);
+            shard->sample_total += sample;
+            dsrtos_shard_stats_write_end(&g_set, shard);
+        } else {
+            /* Same fields, one copy shared by every CPU */
+            dsrtos_stat_add(&g_shared.events, 1U);
+            dsrtos_stat_add(&g_shared.paired, 1U);
+            dsrtos_stat_max(&g_shared.max_sample, sample);
+            (void)__atomic_fetch_add(&g_shared.sample_total, (uint64_t)sample, __ATOMIC_RELAXED);
+        }
+    }
+
+    return NULL;
+}
+
+static void* bench_reader(void* arg)
+{
+    bench_shard_t total;
+
+    (void)arg;
+    while (__atomic_load_n(&g_stop, __ATOMIC_ACQUIRE) == 0U) {
+        if (dsrtos_shard_stats_snapshot(&g_set, &total) == DSRTOS_SUCCESS) {
+            if (total.events != total.paired) {
+                (void)__atomic_fetch_add(&g_torn, 1U, __ATOMIC_RELAXED);
+            }
+            (void)__atomic_fetch_add(&g_snapshots, 1U, __ATOMIC_RELAXED);
+        } else {
+            (void)__atomic_fetch_add(&g_busy, 1U, __ATOMIC_RELAXED);
+        }
+    }
+
+    return NULL;
+}
+
+/*==============================================================================
+ * FUNCTIONAL CHECKS
+ *============================================================================*/
+
+static void check_shards(void)
+{
+    dsrtos_shard_stats_t uninit;
+    dsrtos_seqcount_t seq = { 0U, 0U };
+    bench_shard_t total;
+    bench_shard_t* shard;
+    uint32_t value = 7U;
+    uint32_t copy = 0U;
+
+    (void)memset(&uninit, 0, sizeof(uninit));
+    HOST_CHECK(dsrtos_shard_stats_write_begin(&uninit) == NULL);
+    HOST_CHECK(dsrtos_shard_stats_snapshot(&uninit, &total) == DSRTOS_ERROR_NOT_INITIALIZED);
+    HOST_CHECK(dsrtos_shard_stats_init(&g_set, "bench", g_shards, 0U, NULL, bench_merge) ==
+               DSRTOS_ERROR_INVALID_SIZE);
+    HOST_CHECK(dsrtos_shard_stats_init(&g_set, "bench", g_shards,
+                                       DSRTOS_CONFIG_STATS_SHARD_MAX_SIZE + 1U,
+                                       NULL, bench_merge) == DSRTOS_ERROR_INVALID_SIZE);
+    HOST_CHECK(dsrtos_shard_stats_init(&g_set, "bench", g_shards, sizeof(bench_shard_t),
+                                       NULL, bench_merge) == DSRTOS_SUCCESS);
+
+    /* A writer that never finishes: the reader gives up, it does not spin */
+    dsrtos_seqcount_write_begin(&seq);
+    HOST_CHECK(dsrtos_seqcount_read(&seq, &copy, &value, sizeof(value)) == DSRTOS_ERROR_BUSY);
+    dsrtos_seqcount_write_end(&seq);
+    HOST_CHECK(dsrtos_seqcount_read(&seq, &copy, &value, sizeof(value)) == DSRTOS_SUCCESS);
+    HOST_CHECK(copy == 7U);
+
+    /* Nested writers (an ISR inside a task update) leave the counter stable */
+    dsrtos_shard_stats_set_cpu_hook(bench_cpu);
+    t_cpu = 1U;
+    shard = dsrtos_shard_stats_write_begin(&g_set);
+    HOST_CHECK(shard == &g_shards[1]);
+    dsrtos_stat_add(&shard->events, 1U);
+    {
+        bench_shard_t* nested = dsrtos_shard_stats_write_begin(&g_set);
+
+        dsrtos_stat_add(&nested->events, 1U);
+        dsrtos_stat_add(&nested->paired, 1U);
+        dsrtos_shard_stats_write_end(&g_set, nested);
+    }
+    HOST_CHECK(dsrtos_shard_stats_snapshot(&g_set, &total) == DSRTOS_ERROR_BUSY);
+    dsrtos_stat_add(&shard->paired, 1U);
+    dsrtos_shard_stats_write_end(&g_set, shard);
+
+    HOST_CHECK(dsrtos_shard_stats_snapshot(&g_set, &total) == DSRTOS_SUCCESS);
+    HOST_CHECK((total.events == 2U) && (total.paired == 2U));
+
+    HOST_CHECK(dsrtos_shard_stats_reset(&g_set) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_shard_stats_snapshot(&g_set, &total) == DSRTOS_SUCCESS);
+    HOST_CHECK(total.events == 0U);
+}
+
+/*==============================================================================
+ * BENCHMARKS
+ *============================================================================*/
+
+static double bench_run(uint32_t writers, bool sharded)
+{
+    pthread_t threads[BENCH_MAX_WRITERS];
+    bench_writer_t args[BENCH_MAX_WRITERS];
+    pthread_t reader;
+    bench_shard_t total;
+    uint32_t critical_before;
+    uint64_t t0;
+    uint64_t t1;
+
+    HOST_CHECK(dsrtos_shard_stats_reset(&g_set) == DSRTOS_SUCCESS);
+    (void)memset(&g_shared, 0, sizeof(g_shared));
+    g_stop = 0U;
+    critical_before = dsrtos_host_critical_count();
+
+    HOST_CHECK(pthread_create(&reader, NULL, bench_reader, NULL) == 0);
+    t0 = dsrtos_host_time_ns();
+    for (uint32_t i = 0U; i < writers; i++) {
+        args[i].cpu = i;
+        args[i].sharded = sharded;
+        HOST_CHECK(pthread_create(&threads[i], NULL, bench_writer, &args[i]) == 0);
+    }
+    for (uint32_t i = 0U; i < writers; i++) {
+        HOST_CHECK(pthread_join(threads[i], NULL) == 0);
+    }
+    t1 = dsrtos_host_time_ns();
+    __atomic_store_n(&g_stop, 1U, __ATOMIC_RELEASE);
+    HOST_CHECK(pthread_join(reader, NULL) == 0);
+
+    /* Nothing lost, and the reader never masked interrupts */
+    if (sharded) {
+        HOST_CHECK(dsrtos_shard_stats_snapshot(&g_set, &total) == DSRTOS_SUCCESS);
+    } else {
+        total = g_shared;
+    }
+    HOST_CHECK(total.events == (writers * BENCH_UPDATES));
+    HOST_CHECK(total.paired == total.events);
+    HOST_CHECK(total.max_sample == 0x3FFU);
+    HOST_CHECK(dsrtos_host_critical_count() == critical_before);
+
+    return (double)(t1 - t0) / (double)(writers * BENCH_UPDATES);
+}
+
+/*==============================================================================
+ * MAIN
+ *============================================================================*/
+
+int main(void)
+{
+    static const uint32_t writers[3] = { 1U, 2U, 4U };
+
+    check_shards();
+
+    (void)printf("Statistics update scaling (%u updates per writer, ns/update)\n", BENCH_UPDATES);
+    (void)printf("  %-10s %12s %12s\n", "writers", "shared", "sharded");
+    for (uint32_t i = 0U; i < 3U; i++) {
+        double shared = bench_run(writers[i], false);
+        double sharded = bench_run(writers[i], true);
+
+        (void)printf("  %-10u %12.2f %12.2f\n", writers[i], shared, sharded);
+    }
+    (void)printf("  snapshots %u, gave up %u, retried copies %u\n",
+                 g_snapshots, g_busy, g_set.read_retries);
+    HOST_CHECK(g_torn == 0U);
+    HOST_CHECK(g_snapshots > 0U);
+
+    return dsrtos_host_finish("dsrtos_bench_shardstats");
+}
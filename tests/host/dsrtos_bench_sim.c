@@ -0,0 +1,447 @@
+/*
+ * @file dsrtos_bench_sim.c
+ * @brief Scheduler plugin comparison in the trace-driven simulator (host port)
+ * @date 2024-12-30
+ *
+ * Checks the simulator against schedules worked out by hand: priority
+ * preemption, round robin between equals, a block ended early by IPC, the
+ * switch cost model and the recorded trace format. Then it runs one mixed
+ * workload (periodic tasks, an IPC server and I/O blocks) through three
+ * plugins built on the phase 4 ops table:
+ * - priority: the ready queue as is, run until completion or block
+ * - rr: the same queue with a fixed slice and requeue behind equals
+ * - adaptive: slices from the decision engine's load-dependent quantum
+ * and sweeps the round-robin slice and the context-switch cost. Virtual
+ * time is in microseconds with a 1 ms tick. The simulator has to sustain
+ * a million scheduling events per second of host time.
+ */
+
+#include "dsrtos_host_port.h"
+#include "dsrtos_host_sim.h"
+#include "dsrtos_task_scheduler_interface.h"
+#include "dsrtos_scheduler_decision.h"
+#include "dsrtos_task_manager.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*==============================================================================
+ * CONFIGURATION
+ *============================================================================*/
+
+#define BENCH_TICK_US           (1000U)
+#define BENCH_HORIZON_US        (20000000U)     /* 20 s of virtual time */
+#define BENCH_MAX_EVENTS        (1U << 17)
+#define BENCH_IPC_MEAN_US       (1000U)         /* Mean gap between messages */
+#define BENCH_BLOCK_MEAN_US     (5000U)         /* Mean gap between I/O waits */
+#define BENCH_BLOCK_US          (200U)
+#define BENCH_MIN_EVENT_RATE    (1000000U)      /* Scheduling events per host second */
+
+/* Target-like costs: decision, switch, and cache refill after preemption */
+#define BENCH_COST_DECISION     (1U)
+#define BENCH_COST_SWITCH       (5U)
+#define BENCH_COST_PREEMPT      (10U)
+
+#define BENCH_SERVER            (2U)            /* Task that receives the IPC */
+#define BENCH_BLOCKER           (1U)            /* Task that waits on I/O */
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+/* 88% utilisation; three tasks share priority 2 */
+static const dsrtos_sim_task_t g_workload[] = {
+    { "sensor",     6U,  1000U,  0U,  150U,  0U },
+    { "control",    5U,  2000U,  0U,  300U,  0U },
+    { "comms",      4U,     0U,  0U,   80U,  500U },
+    { "logger",     2U, 20000U,  0U, 3000U,  0U },
+    { "ui",         2U, 20000U, 50U, 3000U,  0U },
+    { "stats",      2U, 40000U,  0U, 4000U,  0U },
+    { "background", 1U, 50000U,  0U, 5000U,  0U },
+};
+
+#define BENCH_TASKS             ((uint32_t)(sizeof(g_workload) / sizeof(g_workload[0])))
+
+static dsrtos_sim_event_t g_events[BENCH_MAX_EVENTS];
+static uint32_t g_event_count;
+static dsrtos_sim_result_t g_result;
+static uint32_t g_rr_slice = 2U;
+
+/*==============================================================================
+ * KERNEL STUBS
+ *============================================================================*/
+
+void dsrtos_panic(const char* reason)
+{
+    dsrtos_host_check_failed(__FILE__, __LINE__, reason);
+}
+
+void dsrtos_assert_failed(const char* expr, const char* file, int line, const char* func)
+{
+    (void)func;
+    dsrtos_host_check_failed(file, line, expr);
+}
+
+/*==============================================================================
+ * PLUGINS
+ *============================================================================*/
+
+static dsrtos_error_t ops_init(void* context)
+{
+    (void)context;
+    return DSRTOS_SUCCESS;
+}
+
+static dsrtos_error_t ops_enqueue(dsrtos_ready_queue_t* queue, dsrtos_tcb_t* task)
+{
+    return dsrtos_ready_queue_insert(queue, task);
+}
+
+static dsrtos_error_t ops_dequeue(dsrtos_ready_queue_t* queue, dsrtos_tcb_t* task)
+{
+    return dsrtos_ready_queue_remove(queue, task);
+}
+
+/* Insertion is FIFO within a level, so this puts the task behind its equals */
+static dsrtos_error_t ops_requeue(dsrtos_ready_queue_t* queue, dsrtos_tcb_t* task)
+{
+    dsrtos_error_t err = dsrtos_ready_queue_remove(queue, task);
+
+    return (err == DSRTOS_SUCCESS) ? dsrtos_ready_queue_insert(queue, task) : err;
+}
+
+static void rr_update_time_slice(dsrtos_tcb_t* task)
+{
+    task->time_slice_remaining = g_rr_slice;
+}
+
+static void adaptive_update_time_slice(dsrtos_tcb_t* task)
+{
+    task->time_slice_remaining = dsrtos_scheduler_calculate_quantum(task);
+}
+
+static const dsrtos_scheduler_ops_t g_priority_ops = {
+    .init = ops_init,
+    .select_next_task = dsrtos_ready_queue_get_highest_priority,
+    .enqueue_task = ops_enqueue,
+    .dequeue_task = ops_dequeue
+};
+
+static const dsrtos_scheduler_ops_t g_rr_ops = {
+    .init = ops_init,
+    .select_next_task = dsrtos_ready_queue_get_highest_priority,
+    .enqueue_task = ops_enqueue,
+    .dequeue_task = ops_dequeue,
+    .requeue_task = ops_requeue,
+    .update_time_slice = rr_update_time_slice
+};
+
+static const dsrtos_scheduler_ops_t g_adaptive_ops = {
+    .init = ops_init,
+    .select_next_task = dsrtos_ready_queue_get_highest_priority,
+    .enqueue_task = ops_enqueue,
+    .dequeue_task = ops_dequeue,
+    .requeue_task = ops_requeue,
+    .update_time_slice = adaptive_update_time_slice
+};
+
+/*==============================================================================
+ * HELPERS
+ *============================================================================*/
+
+static dsrtos_error_t run(const dsrtos_scheduler_ops_t *ops, const dsrtos_sim_task_t *tasks,
+                          uint32_t task_count, const dsrtos_sim_event_t *events,
+                          uint32_t event_count, uint32_t switch_cost)
+{
+    dsrtos_sim_config_t config = {
+        .ops = ops,
+        .tasks = tasks,
+        .task_count = task_count,
+        .events = events,
+        .event_count = event_count,
+        .cost = { 0U, switch_cost, 0U },
+        .slice_unit = 1U,
+        .horizon = 0U
+    };
+
+    return dsrtos_sim_run(&config, &g_result);
+}
+
+static uint32_t parse(const char *text, uint32_t task_count)
+{
+    return dsrtos_sim_parse(text, task_count, g_events, BENCH_MAX_EVENTS);
+}
+
+static int compare_events(const void *a, const void *b)
+{
+    const dsrtos_sim_event_t *x = (const dsrtos_sim_event_t *)a;
+    const dsrtos_sim_event_t *y = (const dsrtos_sim_event_t *)b;
+
+    if (x->time != y->time) {
+        return (x->time > y->time) ? 1 : -1;
+    }
+    return (int)x->task - (int)y->task;
+}
+
+/* Exponential-ish gaps from the host PRNG: uniform over twice the mean */
+static uint32_t random_gap(uint32_t mean)
+{
+    return 1U + (dsrtos_host_rand() % (2U * mean));
+}
+
+static void build_workload(void)
+{
+    uint64_t t;
+
+    g_event_count = dsrtos_sim_model(g_workload, BENCH_TASKS, BENCH_HORIZON_US,
+                                     g_events, BENCH_MAX_EVENTS);
+    HOST_CHECK(g_event_count != 0U);
+
+    /* Messages to the server and I/O waits of the control task, as a
+     * recorded trace of the same system would show them */
+    dsrtos_host_srand(0x51u);
+    for (t = random_gap(BENCH_IPC_MEAN_US); t < BENCH_HORIZON_US; t += random_gap(BENCH_IPC_MEAN_US)) {
+        HOST_CHECK(g_event_count < BENCH_MAX_EVENTS);
+        g_events[g_event_count++] = (dsrtos_sim_event_t){ t, DSRTOS_SIM_IPC, BENCH_SERVER,
+                                                          g_workload[BENCH_SERVER].demand };
+    }
+    for (t = random_gap(BENCH_BLOCK_MEAN_US); t < BENCH_HORIZON_US; t += random_gap(BENCH_BLOCK_MEAN_US)) {
+        HOST_CHECK(g_event_count < BENCH_MAX_EVENTS);
+        g_events[g_event_count++] = (dsrtos_sim_event_t){ t, DSRTOS_SIM_BLOCK, BENCH_BLOCKER,
+                                                          BENCH_BLOCK_US };
+    }
+    qsort(g_events, g_event_count, sizeof(g_events[0]), compare_events);
+}
+
+static uint64_t event_rate(const dsrtos_sim_result_t *result)
+{
+    return (result->wall_ns != 0U) ? ((result->events * 1000000000ULL) / result->wall_ns) : 0U;
+}
+
+/*==============================================================================
+ * FUNCTIONAL CHECKS
+ *============================================================================*/
+
+static void check_preemption(void)
+{
+    static const dsrtos_sim_task_t tasks[] = {
+        { "low",  1U, 0U, 0U, 10U, 0U },
+        { "high", 5U, 0U, 0U,  3U, 0U },
+    };
+    uint32_t count = parse("0 R 0 10\n2 R 1 3\n", 2U);
+
+    HOST_CHECK(count == 2U);
+    HOST_CHECK(run(&g_priority_ops, tasks, 2U, g_events, count, 0U) == DSRTOS_SUCCESS);
+
+    /* low 0-2, high 2-5, low 5-13 */
+    HOST_CHECK(g_result.task[1].response_max == 3U);
+    HOST_CHECK(g_result.task[0].response_max == 13U);
+    HOST_CHECK(g_result.switches == 3U);
+    HOST_CHECK(g_result.preemptions == 1U);
+    HOST_CHECK(g_result.busy_time == 13U);
+    HOST_CHECK(g_result.end_time == 13U);
+    HOST_CHECK(g_result.jobs_completed == 2U);
+}
+
+static void check_round_robin(void)
+{
+    static const dsrtos_sim_task_t tasks[] = {
+        { "a", 3U, 0U, 0U, 10U, 0U },
+        { "b", 3U, 0U, 0U, 10U, 0U },
+    };
+    uint32_t count = parse("0 R 0 10\n0 R 1 10\n", 2U);
+
+    HOST_CHECK(count == 2U);
+
+    /* Without slicing the first arrival runs to completion */
+    HOST_CHECK(run(&g_priority_ops, tasks, 2U, g_events, count, 0U) == DSRTOS_SUCCESS);
+    HOST_CHECK(g_result.task[0].response_max == 10U);
+    HOST_CHECK(g_result.task[1].response_max == 20U);
+    HOST_CHECK(g_result.switches == 2U);
+    HOST_CHECK(g_result.slice_expiries == 0U);
+
+    /* Slices of 2 alternate a and b; a finishes at 18, b at 20 */
+    g_rr_slice = 2U;
+    HOST_CHECK(run(&g_rr_ops, tasks, 2U, g_events, count, 0U) == DSRTOS_SUCCESS);
+    HOST_CHECK(g_result.task[0].response_max == 18U);
+    HOST_CHECK(g_result.task[1].response_max == 20U);
+    HOST_CHECK(g_result.switches == 10U);
+    HOST_CHECK(g_result.slice_expiries == 8U);
+    HOST_CHECK(g_result.fairness_ppm == 1000000U);
+
+    /* Every switch costs 1 and no task progresses meanwhile */
+    HOST_CHECK(run(&g_rr_ops, tasks, 2U, g_events, count, 1U) == DSRTOS_SUCCESS);
+    HOST_CHECK(g_result.overhead_time == g_result.switches);
+    HOST_CHECK(g_result.end_time == 20U + g_result.overhead_time);
+    HOST_CHECK(g_result.busy_time == 20U);
+}
+
+static void check_block_ipc(void)
+{
+    static const dsrtos_sim_task_t tasks[] = {
+        { "server", 5U, 0U, 0U,  5U,  0U },
+        { "worker", 1U, 0U, 0U, 20U, 20U },
+    };
+    uint32_t count = parse("# server waits for a message, worker runs meanwhile\n"
+                           "0 B 0 100\n"
+                           "0 R 0 5\n"
+                           "0 R 1 20\n"
+                           "\n"
+                           "10 I 0 0   # wakes the server long before its timeout\n", 2U);
+
+    HOST_CHECK(count == 4U);
+    HOST_CHECK(run(&g_priority_ops, tasks, 2U, g_events, count, 0U) == DSRTOS_SUCCESS);
+
+    /* worker 0-10, server 10-15, worker 15-25 past its deadline of 20 */
+    HOST_CHECK(g_result.task[0].response_max == 15U);
+    HOST_CHECK(g_result.task[1].response_max == 25U);
+    HOST_CHECK(g_result.task[1].deadline_misses == 1U);
+    HOST_CHECK(g_result.deadline_misses == 1U);
+    HOST_CHECK(g_result.preemptions == 1U);
+    HOST_CHECK(g_result.end_time == 25U);
+    HOST_CHECK(g_result.idle_time == 0U);
+}
+
+static void check_trace(void)
+{
+    /* Malformed lines, unknown types, foreign tasks and time running
+     * backwards reject the whole trace */
+    HOST_CHECK(parse("0 R 0 1\n5 X 0 1\n", 2U) == 0U);
+    HOST_CHECK(parse("0 R 0\n", 2U) == 0U);
+    HOST_CHECK(parse("0 R 0 1 extra\n", 2U) == 0U);
+    HOST_CHECK(parse("0 R 2 1\n", 2U) == 0U);
+    HOST_CHECK(parse("5 R 0 1\n4 R 1 1\n", 2U) == 0U);
+    HOST_CHECK(parse("# nothing\n\n", 2U) == 0U);
+
+    HOST_CHECK(parse("7 I 1 3", 2U) == 1U);
+    HOST_CHECK(g_events[0].time == 7U);
+    HOST_CHECK(g_events[0].type == DSRTOS_SIM_IPC);
+    HOST_CHECK(g_events[0].task == 1U);
+    HOST_CHECK(g_events[0].value == 3U);
+
+    /* The model emits each periodic task's releases in time order */
+    static const dsrtos_sim_task_t tasks[] = {
+        { "a", 1U, 4U, 1U, 1U, 0U },
+        { "b", 2U, 3U, 0U, 1U, 0U },
+        { "c", 3U, 0U, 0U, 1U, 0U },
+    };
+    HOST_CHECK(dsrtos_sim_model(tasks, 3U, 10U, g_events, BENCH_MAX_EVENTS) == 7U);
+    HOST_CHECK((g_events[0].time == 0U) && (g_events[0].task == 1U));
+    HOST_CHECK((g_events[1].time == 1U) && (g_events[1].task == 0U));
+    HOST_CHECK((g_events[5].time == 9U) && (g_events[5].task == 0U));
+    HOST_CHECK((g_events[6].time == 9U) && (g_events[6].task == 1U));
+    HOST_CHECK(dsrtos_sim_model(tasks, 3U, 10U, g_events, 6U) == 0U);
+}
+
+/*==============================================================================
+ * BENCHMARKS
+ *============================================================================*/
+
+static void print_header(const char *label)
+{
+    (void)printf("  %-12s %8s %8s %7s %6s %9s %9s %7s %9s %9s\n", label, "switches", "preempt",
+                 "misses", "drops", "resp avg", "resp max", "fair", "cyc/dec", "Mevt/s");
+}
+
+/* One row: response times in virtual us, worst over all tasks */
+static void print_row(const char *label, const dsrtos_sim_result_t *result)
+{
+    uint32_t worst = 0U;
+    uint32_t drops = 0U;
+
+    for (uint32_t i = 0U; i < BENCH_TASKS; i++) {
+        if (result->task[i].response_max > worst) {
+            worst = result->task[i].response_max;
+        }
+        drops += result->task[i].dropped;
+    }
+
+    (void)printf("  %-12s %8u %8u %7u %6u %9llu %9u %7.4f %9llu %9.2f\n", label,
+                 result->switches, result->preemptions, result->deadline_misses, drops,
+                 (unsigned long long)(result->jobs_completed ?
+                                      (result->response_total / result->jobs_completed) : 0U),
+                 worst, (double)result->fairness_ppm / 1000000.0,
+                 (unsigned long long)(result->decisions ?
+                                      (result->sched_cycles / result->decisions) : 0U),
+                 (double)event_rate(result) / 1000000.0);
+}
+
+static void bench_run(const char *label, const dsrtos_scheduler_ops_t *ops, uint32_t switch_cost)
+{
+    dsrtos_sim_config_t config = {
+        .ops = ops,
+        .tasks = g_workload,
+        .task_count = BENCH_TASKS,
+        .events = g_events,
+        .event_count = g_event_count,
+        .cost = { BENCH_COST_DECISION, switch_cost, BENCH_COST_PREEMPT },
+        .slice_unit = BENCH_TICK_US,
+        .horizon = BENCH_HORIZON_US
+    };
+
+    HOST_CHECK(dsrtos_sim_run(&config, &g_result) == DSRTOS_SUCCESS);
+    HOST_CHECK(g_result.end_time == BENCH_HORIZON_US);
+    HOST_CHECK(g_result.busy_time + g_result.overhead_time + g_result.idle_time == g_result.end_time);
+    HOST_CHECK(event_rate(&g_result) >= BENCH_MIN_EVENT_RATE);
+    print_row(label, &g_result);
+}
+
+static void bench_plugins(void)
+{
+    dsrtos_system_metrics_t metrics;
+    char label[16];
+
+    /* The decision engine sizes slices from the load it was last told */
+    HOST_CHECK(dsrtos_scheduler_decision_init() == DSRTOS_SUCCESS);
+    (void)memset(&metrics, 0, sizeof(metrics));
+    metrics.cpu_load_percent = 88U;
+    dsrtos_scheduler_update_metrics(&metrics);
+
+    print_header("plugin");
+    bench_run("priority", &g_priority_ops, BENCH_COST_SWITCH);
+    for (g_rr_slice = 1U; g_rr_slice <= 4U; g_rr_slice *= 2U) {
+        (void)snprintf(label, sizeof(label), "rr %u ms", g_rr_slice);
+        bench_run(label, &g_rr_ops, BENCH_COST_SWITCH);
+    }
+    bench_run("adaptive", &g_adaptive_ops, BENCH_COST_SWITCH);
+
+    (void)printf("  scheduler time in ops: %llu host cycles over %u decisions (last run)\n",
+                 (unsigned long long)g_result.sched_cycles, g_result.decisions);
+}
+
+static void bench_switch_cost(void)
+{
+    static const uint32_t costs[] = { 0U, 5U, 20U, 50U };
+    char label[16];
+
+    g_rr_slice = 1U;
+    print_header("rr 1 ms, cs");
+    for (uint32_t i = 0U; i < (uint32_t)(sizeof(costs) / sizeof(costs[0])); i++) {
+        (void)snprintf(label, sizeof(label), "%u us", costs[i]);
+        bench_run(label, &g_rr_ops, costs[i]);
+        (void)printf("  %-12s overhead %.2f%% of virtual time\n", "",
+                     (100.0 * (double)g_result.overhead_time) / (double)g_result.end_time);
+    }
+}
+
+/*==============================================================================
+ * MAIN
+ *============================================================================*/
+
+int main(void)
+{
+    check_preemption();
+    check_round_robin();
+    check_block_ipc();
+    check_trace();
+
+    build_workload();
+    (void)printf("Scheduler simulation (%u tasks, %u trace events, %u s virtual)\n",
+                 BENCH_TASKS, g_event_count, BENCH_HORIZON_US / 1000000U);
+    bench_plugins();
+
+    (void)printf("Context switch cost sweep\n");
+    bench_switch_cost();
+
+    return dsrtos_host_finish("dsrtos_bench_sim");
+}
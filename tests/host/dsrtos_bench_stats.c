@@ -0,0 +1,180 @@
+/*
+ * @file dsrtos_bench_stats.c
+ * @brief Statistics update cost: name lookup vs handle (host port)
+ * @date 2024-12-30
+ *
+ * Times dsrtos_stats_update(), which looks the statistic up by category
+ * and name on every call, against dsrtos_stats_add() on a handle from
+ * dsrtos_stats_register_handle(), with 10 and with 200 statistics
+ * registered. Also checks that both paths update the same value and that
+ * handles survive a reset.
+ */
+
+#include "dsrtos_host_port.h"
+#include "dsrtos_stats.h"
+#include "dsrtos_kernel_init.h"
+#include "dsrtos_port.h"
+#include <stdio.h>
+#include <string.h>
+
+/*==============================================================================
+ * CONFIGURATION
+ *============================================================================*/
+
+#define BENCH_UPDATES           (100000U)
+#define BENCH_FEW               (10U)
+#define BENCH_MANY              (200U)
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+static char g_names[BENCH_MANY][16];
+static dsrtos_stats_handle_t g_handles[BENCH_MANY];
+
+/*==============================================================================
+ * KERNEL STUBS
+ *============================================================================*/
+
+/* The statistics engine registers itself and reads uptime from the kernel */
+dsrtos_error_t dsrtos_kernel_register_service(dsrtos_service_id_t service_id, void* service_ptr)
+{
+    (void)service_id;
+    (void)service_ptr;
+    return DSRTOS_SUCCESS;
+}
+
+dsrtos_kernel_t* dsrtos_kernel_get_kcb(void)
+{
+    return NULL;
+}
+
+/*==============================================================================
+ * HELPERS
+ *============================================================================*/
+
+static void register_stats(uint32_t from, uint32_t to)
+{
+    for (uint32_t i = from; i < to; i++) {
+        (void)snprintf(g_names[i], sizeof(g_names[i]), "stat_%03u", i);
+        HOST_CHECK(dsrtos_stats_register_handle(DSRTOS_STATS_CAT_KERNEL, g_names[i],
+                                                DSRTOS_STATS_TYPE_COUNTER,
+                                                &g_handles[i]) == DSRTOS_SUCCESS);
+        HOST_CHECK(g_handles[i] == (dsrtos_stats_handle_t)i);
+    }
+}
+
+/*==============================================================================
+ * FUNCTIONAL CHECKS
+ *============================================================================*/
+
+static void check_handles(void)
+{
+    dsrtos_stats_handle_t handle;
+    dsrtos_stats_handle_t again;
+    dsrtos_stats_handle_t gauge;
+    dsrtos_stats_entry_t entry;
+
+    HOST_CHECK(dsrtos_stats_add(DSRTOS_STATS_HANDLE_INVALID, 1U) == DSRTOS_ERROR_INVALID_PARAM);
+    HOST_CHECK(dsrtos_stats_register_handle(DSRTOS_STATS_CAT_KERNEL, "x",
+                                            DSRTOS_STATS_TYPE_HISTOGRAM,
+                                            &handle) == DSRTOS_ERROR_INVALID_PARAM);
+
+    /* Name shim and handle share one value */
+    HOST_CHECK(dsrtos_stats_update(DSRTOS_STATS_CAT_IPC, "ipc_sent", 5U) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_stats_register_handle(DSRTOS_STATS_CAT_IPC, "ipc_sent",
+                                            DSRTOS_STATS_TYPE_COUNTER, &handle) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_stats_register_handle(DSRTOS_STATS_CAT_IPC, "ipc_sent",
+                                            DSRTOS_STATS_TYPE_COUNTER, &again) == DSRTOS_SUCCESS);
+    HOST_CHECK(handle == again);
+    HOST_CHECK(dsrtos_stats_add(handle, 3U) == DSRTOS_SUCCESS);
+    HOST_CHECK(DSRTOS_STATS_HANDLE_INC(handle) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_stats_read(handle) == 9U);
+    HOST_CHECK(dsrtos_stats_get_entry(DSRTOS_STATS_CAT_IPC, "ipc_sent", &entry) == DSRTOS_SUCCESS);
+    HOST_CHECK(entry.value.counter == 9U);
+    HOST_CHECK(entry.update_count == 1U);     /* Only the shim counts updates */
+
+    /* A name registered as a counter cannot come back as a gauge */
+    HOST_CHECK(dsrtos_stats_register_handle(DSRTOS_STATS_CAT_IPC, "ipc_sent",
+                                            DSRTOS_STATS_TYPE_GAUGE, &again) == DSRTOS_ERROR_INVALID_STATE);
+    HOST_CHECK(again == DSRTOS_STATS_HANDLE_INVALID);
+
+    HOST_CHECK(dsrtos_stats_register_handle(DSRTOS_STATS_CAT_IPC, "ipc_depth",
+                                            DSRTOS_STATS_TYPE_GAUGE, &gauge) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_stats_set(gauge, -7) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_stats_get_entry(DSRTOS_STATS_CAT_IPC, "ipc_depth", &entry) == DSRTOS_SUCCESS);
+    HOST_CHECK(entry.value.gauge == -7);
+    HOST_CHECK(dsrtos_stats_set_gauge(DSRTOS_STATS_CAT_IPC, "ipc_depth", 4) == DSRTOS_SUCCESS);
+    HOST_CHECK((int32_t)dsrtos_stats_read(gauge) == 4);
+
+    /* Reset clears values but keeps names and handles */
+    HOST_CHECK(dsrtos_stats_reset(DSRTOS_STATS_CAT_MAX) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_stats_read(handle) == 0U);
+    HOST_CHECK(dsrtos_stats_update(DSRTOS_STATS_CAT_IPC, "ipc_sent", 2U) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_stats_read(handle) == 2U);
+}
+
+/*==============================================================================
+ * BENCHMARKS
+ *============================================================================*/
+
+static void bench_updates(uint32_t registered)
+{
+    dsrtos_host_sample_t by_name;
+    dsrtos_host_sample_t by_handle;
+    char name_label[48];
+    char handle_label[48];
+    uint32_t before;
+
+    (void)snprintf(name_label, sizeof(name_label), "update by name, %u stats", registered);
+    dsrtos_host_sample_init(&by_name, name_label);
+    dsrtos_host_srand(0x57A70000U);
+    for (uint32_t i = 0U; i < BENCH_UPDATES; i++) {
+        uint32_t index = dsrtos_host_rand() % registered;
+        uint32_t t0 = dsrtos_port_get_cycle_count();
+        dsrtos_error_t err = dsrtos_stats_update(DSRTOS_STATS_CAT_KERNEL, g_names[index], 1U);
+        uint32_t t1 = dsrtos_port_get_cycle_count();
+
+        HOST_CHECK(err == DSRTOS_SUCCESS);
+        dsrtos_host_sample_add(&by_name, t1 - t0);
+    }
+
+    (void)snprintf(handle_label, sizeof(handle_label), "update by handle, %u stats", registered);
+    dsrtos_host_sample_init(&by_handle, handle_label);
+    before = dsrtos_stats_read(g_handles[registered - 1U]);
+    dsrtos_host_srand(0x57A70000U);
+    for (uint32_t i = 0U; i < BENCH_UPDATES; i++) {
+        uint32_t index = dsrtos_host_rand() % registered;
+        uint32_t t0 = dsrtos_port_get_cycle_count();
+        dsrtos_error_t err = dsrtos_stats_add(g_handles[index], 1U);
+        uint32_t t1 = dsrtos_port_get_cycle_count();
+
+        HOST_CHECK(err == DSRTOS_SUCCESS);
+        dsrtos_host_sample_add(&by_handle, t1 - t0);
+    }
+    /* Same random sequence: the last statistic doubled */
+    HOST_CHECK(dsrtos_stats_read(g_handles[registered - 1U]) == (2U * before));
+
+    dsrtos_host_sample_print(&by_name);
+    dsrtos_host_sample_print(&by_handle);
+}
+
+/*==============================================================================
+ * MAIN
+ *============================================================================*/
+
+int main(void)
+{
+    HOST_CHECK(dsrtos_stats_init(NULL) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_stats_add(0U, 1U) == DSRTOS_ERROR_INVALID_PARAM);
+
+    (void)printf("Statistics update benchmark (%u updates, cycles)\n", BENCH_UPDATES);
+    register_stats(0U, BENCH_FEW);
+    bench_updates(BENCH_FEW);
+    register_stats(BENCH_FEW, BENCH_MANY);
+    bench_updates(BENCH_MANY);
+
+    check_handles();
+
+    return dsrtos_host_finish("dsrtos_bench_stats");
+}
@@ -0,0 +1,248 @@
+/*
+ * @file dsrtos_bench_statsstream.c
+ * @brief Streaming statistics export: chunked vs whole-buffer (host port)
+ * @date 2024-12-30
+ *
+ * Exports the system, task, scheduler, context, queue and memory records
+ * as CSV and JSON, once into one large buffer and again through buffers
+ * of 1 to 256 bytes. Checks that every chunked export matches the
+ * whole-buffer export byte for byte, that task names are escaped, and that
+ * the exporter enters one critical section per task record and no more.
+ */
+
+#include "dsrtos_host_port.h"
+#include "dsrtos_stats_stream.h"
+#include "dsrtos_kernel.h"
+#include "dsrtos_memory.h"
+#include "dsrtos_context_switch.h"
+#include "dsrtos_scheduler_stats.h"
+#include "dsrtos_port.h"
+#include <stdio.h>
+#include <string.h>
+
+/*==============================================================================
+ * CONFIGURATION
+ *============================================================================*/
+
+#define BENCH_TASKS             (12U)      /* Every third slot is empty */
+#define BENCH_EXPORT_MAX        (8192U)
+#define BENCH_ROUNDS            (200U)
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+static dsrtos_tcb_t g_tcbs[BENCH_TASKS];
+static char g_whole[BENCH_EXPORT_MAX];
+static char g_chunked[BENCH_EXPORT_MAX];
+
+/*==============================================================================
+ * KERNEL STUBS
+ *============================================================================*/
+
+dsrtos_tcb_t* dsrtos_task_get_by_index(uint32_t index)
+{
+    if ((index >= BENCH_TASKS) || ((index % 3U) == 2U)) {
+        return NULL;
+    }
+    return &g_tcbs[index];
+}
+
+dsrtos_error_t dsrtos_stats_get_system(system_stats_t *stats)
+{
+    (void)memset(stats, 0, sizeof(*stats));
+    stats->system_uptime = 123456789ULL;
+    stats->active_tasks = 1U;
+    stats->ready_tasks = 5U;
+    stats->peak_active_tasks = 2U;
+    stats->total_context_switches = 4242U;
+    stats->cpu_load.cpu_load_ewma = 37.5F;
+    return DSRTOS_SUCCESS;
+}
+
+dsrtos_error_t dsrtos_scheduler_stats_get(dsrtos_scheduler_stats_t* stats)
+{
+    (void)memset(stats, 0, sizeof(*stats));
+    stats->total_schedules = 0xFFFFFFFFFFULL;
+    stats->max_schedule_time_ns = 980U;
+    return DSRTOS_SUCCESS;
+}
+
+dsrtos_error_t dsrtos_context_get_stats(dsrtos_context_stats_t* stats)
+{
+    (void)memset(stats, 0, sizeof(*stats));
+    stats->switch_count = 10U;
+    stats->switch_cycles_min = 90U;
+    stats->switch_cycles_max = 400U;
+    stats->switch_cycles_avg = 150U;
+    return DSRTOS_SUCCESS;
+}
+
+/* Not initialized: the queue record is skipped */
+dsrtos_error_t dsrtos_queue_depth_stats_get(dsrtos_queue_depth_stats_t* stats)
+{
+    (void)stats;
+    return DSRTOS_ERROR_NOT_INITIALIZED;
+}
+
+/*==============================================================================
+ * HELPERS
+ *============================================================================*/
+
+static void make_tasks(void)
+{
+    for (uint32_t i = 0U; i < BENCH_TASKS; i++) {
+        (void)memset(&g_tcbs[i], 0, sizeof(g_tcbs[i]));
+        g_tcbs[i].task_id = i + 1U;
+        (void)snprintf(g_tcbs[i].name, sizeof(g_tcbs[i].name), "worker_%u", i);
+        g_tcbs[i].priority = (dsrtos_task_priority_t)(i * 10U);
+        g_tcbs[i].stats.total_runtime = i * 1000U;
+        g_tcbs[i].stats.context_switches = i * 3U;
+    }
+    /* Names that need escaping, one of them a full-length name */
+    (void)memcpy(g_tcbs[0].name, "say \"hi\"\\", 10U);
+    (void)memcpy(g_tcbs[1].name, "abcdefghijklmnop", DSRTOS_TASK_NAME_MAX_LENGTH);
+}
+
+/* Export through chunk-byte reads; returns total bytes */
+static uint32_t export_chunked(dsrtos_stats_format_t format, uint32_t chunk, char* out)
+{
+    dsrtos_stats_stream_t stream;
+    uint32_t total = 0U;
+    uint32_t written;
+
+    HOST_CHECK(dsrtos_stats_stream_begin(&stream, format) == DSRTOS_SUCCESS);
+    while (!dsrtos_stats_stream_done(&stream)) {
+        HOST_CHECK((total + chunk) <= BENCH_EXPORT_MAX);
+        HOST_CHECK(dsrtos_stats_stream_read(&stream, &out[total], chunk, &written) == DSRTOS_SUCCESS);
+        HOST_CHECK(written <= chunk);
+        total += written;
+    }
+    HOST_CHECK(dsrtos_stats_stream_read(&stream, &out[total], chunk, &written) == DSRTOS_SUCCESS);
+    HOST_CHECK(written == 0U);
+
+    return total;
+}
+
+static uint32_t count_of(const char* text, uint32_t len, const char* needle)
+{
+    uint32_t count = 0U;
+    size_t needle_len = strlen(needle);
+
+    for (uint32_t i = 0U; (i + needle_len) <= len; i++) {
+        if (memcmp(&text[i], needle, needle_len) == 0) {
+            count++;
+        }
+    }
+    return count;
+}
+
+/*==============================================================================
+ * FUNCTIONAL CHECKS
+ *============================================================================*/
+
+static void check_format(dsrtos_stats_format_t format)
+{
+    static const uint32_t chunks[5] = { 1U, 7U, 16U, 64U, 256U };
+    uint32_t whole;
+    uint32_t critical_before;
+    uint32_t memory_criticals;
+    dsrtos_size_t total_size;
+    dsrtos_size_t allocated;
+    dsrtos_size_t peak;
+    uint32_t fragmentation;
+
+    /* The heap takes its own critical sections for the memory record */
+    critical_before = dsrtos_host_critical_count();
+    HOST_CHECK(dsrtos_memory_get_stats(&total_size, &allocated, &peak) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_memory_get_fragmentation(&fragmentation) == DSRTOS_SUCCESS);
+    memory_criticals = dsrtos_host_critical_count() - critical_before;
+
+    critical_before = dsrtos_host_critical_count();
+    whole = export_chunked(format, BENCH_EXPORT_MAX, g_whole);
+    /* One critical section per present task, none for the rest */
+    HOST_CHECK((dsrtos_host_critical_count() - critical_before) == (8U + memory_criticals));
+
+    for (uint32_t i = 0U; i < 5U; i++) {
+        uint32_t len = export_chunked(format, chunks[i], g_chunked);
+
+        HOST_CHECK(len == whole);
+        HOST_CHECK(memcmp(g_chunked, g_whole, whole) == 0);
+    }
+
+    if (format == DSRTOS_STATS_FORMAT_JSON) {
+        HOST_CHECK(memcmp(g_whole, "[\n{\"type\":\"system\"", 18U) == 0);
+        HOST_CHECK(memcmp(&g_whole[whole - 3U], "\n]\n", 3U) == 0);
+        HOST_CHECK(count_of(g_whole, whole, "{\"type\":\"task\"") == 8U);
+        HOST_CHECK(count_of(g_whole, whole, "\"name\":\"say \\\"hi\\\"\\\\\"") == 1U);
+        HOST_CHECK(count_of(g_whole, whole, "\"name\":\"abcdefghijklmnop\"") == 1U);
+        HOST_CHECK(count_of(g_whole, whole, "\"schedules\":1099511627775") == 1U);
+        HOST_CHECK(count_of(g_whole, whole, "\"cpu_load_x100\":3750") == 1U);
+        HOST_CHECK(count_of(g_whole, whole, "\"type\":\"queue\"") == 0U);
+    } else {
+        /* A header line per section with rows: system, task, scheduler, context, memory */
+        HOST_CHECK(count_of(g_whole, whole, "type,id") == 5U);
+        HOST_CHECK(count_of(g_whole, whole, "\ntask,") == 8U);
+        HOST_CHECK(count_of(g_whole, whole, ",\"say \"\"hi\"\"\\\",") == 1U);
+        HOST_CHECK(g_whole[whole - 1U] == '\n');
+    }
+}
+
+static void check_errors(void)
+{
+    dsrtos_stats_stream_t stream;
+    uint32_t written;
+    char byte;
+
+    HOST_CHECK(dsrtos_stats_stream_begin(NULL, DSRTOS_STATS_FORMAT_CSV) == DSRTOS_ERROR_INVALID_PARAM);
+    HOST_CHECK(dsrtos_stats_stream_begin(&stream, DSRTOS_STATS_FORMAT_BINARY) == DSRTOS_ERROR_NOT_SUPPORTED);
+    (void)memset(&stream, 0, sizeof(stream));
+    HOST_CHECK(dsrtos_stats_stream_read(&stream, &byte, 1U, &written) == DSRTOS_ERROR_NOT_INITIALIZED);
+}
+
+/*==============================================================================
+ * BENCHMARKS
+ *============================================================================*/
+
+static void bench_export(dsrtos_stats_format_t format, uint32_t chunk)
+{
+    dsrtos_host_sample_t sample;
+    char label[48];
+    uint32_t bytes = 0U;
+
+    (void)snprintf(label, sizeof(label), "%s export, %u-byte reads",
+                   (format == DSRTOS_STATS_FORMAT_JSON) ? "JSON" : "CSV", chunk);
+    dsrtos_host_sample_init(&sample, label);
+    for (uint32_t i = 0U; i < BENCH_ROUNDS; i++) {
+        uint32_t t0 = dsrtos_port_get_cycle_count();
+        bytes = export_chunked(format, chunk, g_chunked);
+        uint32_t t1 = dsrtos_port_get_cycle_count();
+
+        dsrtos_host_sample_add(&sample, t1 - t0);
+    }
+    dsrtos_host_sample_print(&sample);
+    (void)printf("  %-36s %u bytes, %u-byte cursor\n", "", bytes,
+                 (uint32_t)sizeof(dsrtos_stats_stream_t));
+}
+
+/*==============================================================================
+ * MAIN
+ *============================================================================*/
+
+int main(void)
+{
+    HOST_CHECK(dsrtos_memory_init() == DSRTOS_SUCCESS);
+    make_tasks();
+
+    check_errors();
+    check_format(DSRTOS_STATS_FORMAT_JSON);
+    check_format(DSRTOS_STATS_FORMAT_CSV);
+
+    (void)printf("Statistics export benchmark (%u exports, cycles per export)\n", BENCH_ROUNDS);
+    bench_export(DSRTOS_STATS_FORMAT_JSON, 4096U);
+    bench_export(DSRTOS_STATS_FORMAT_JSON, 32U);
+    bench_export(DSRTOS_STATS_FORMAT_CSV, 4096U);
+    bench_export(DSRTOS_STATS_FORMAT_CSV, 32U);
+
+    return dsrtos_host_finish("dsrtos_bench_statsstream");
+}
@@ -0,0 +1,322 @@
+/*
+ * @file dsrtos_bench_task.c
+ * @brief Task create/delete churn benchmark (host port)
+ * @date 2024-12-30
+ *
+ * Creates and releases tasks through dsrtos_task_create_extended and
+ * dsrtos_task_release while a working set of tasks stays alive, once from
+ * the static TCB/stack pools and once from region memory (a simulated
+ * CCM region in front of the kernel heap). Also checks stack size-class
+ * selection, fallback to CCM when the stack classes run out, that every pool block comes back, that releasing a task
+ * takes it out of its budget server before the pool reuses its TCB, and
+ * that tasks exiting on their own stack are reaped back into the pools.
+ */
+
+#include "dsrtos_host_port.h"
+#include "dsrtos_task_creation.h"
+#include "dsrtos_budget.h"
+#include "dsrtos_memory.h"
+#include "dsrtos_region.h"
+#include "dsrtos_kernel.h"
+#include "dsrtos_port.h"
+#include <string.h>
+
+/*==============================================================================
+ * CONFIGURATION
+ *============================================================================*/
+
+#define BENCH_CYCLES            (10000U)
+#define BENCH_LIVE              (16U)      /* Tasks alive while churning */
+#define BENCH_TCB_POOL          (32U)      /* TASK_POOL_SIZE in task_creation.c */
+#define BENCH_POOL_STACKS       (18U)      /* 8 x 512 + 8 x 1024 + 2 x 2048 */
+#define BENCH_EXITS             (3U * BENCH_TCB_POOL)
+#define BENCH_CCM_SIZE          (16U * 1024U)
+#define BENCH_REGION_CCM        (1U)
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+static dsrtos_tcb_t *g_live[BENCH_LIVE];
+static dsrtos_tcb_t *g_many[BENCH_TCB_POOL + 4U];
+static uint8_t g_ccm[BENCH_CCM_SIZE] __attribute__((aligned(8)));
+
+/*==============================================================================
+ * KERNEL STUBS
+ *============================================================================*/
+
+/* Nothing is scheduled here: budget restrictions only change state */
+void dsrtos_port_yield(void)
+{
+}
+
+/*==============================================================================
+ * HELPERS
+ *============================================================================*/
+
+static void task_entry(void *param)
+{
+    (void)param;
+}
+
+static dsrtos_tcb_t *create(uint32_t stack_size, bool use_pool)
+{
+    dsrtos_task_create_extended_t params;
+
+    (void)memset(&params, 0, sizeof(params));
+    (void)strncpy(params.base.name, "churn", DSRTOS_TASK_NAME_MAX_LENGTH - 1U);
+    params.base.entry_point = task_entry;
+    params.base.priority = DSRTOS_TASK_PRIORITY_NORMAL;
+    params.base.stack_size = stack_size;
+    params.use_pool = use_pool;
+
+    return dsrtos_task_create_extended(&params);
+}
+
+static void destroy(dsrtos_tcb_t *tcb)
+{
+    HOST_CHECK(dsrtos_task_delete(tcb) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_task_release(tcb) == DSRTOS_SUCCESS);
+}
+
+/* Stacks the three pool classes can serve: 512, 1024 and 2048 bytes */
+static uint32_t random_stack_size(void)
+{
+    static const uint32_t sizes[4] = { 512U, 768U, 1024U, 2048U };
+
+    return sizes[dsrtos_host_rand() % 4U];
+}
+
+/*==============================================================================
+ * FUNCTIONAL CHECKS
+ *============================================================================*/
+
+static void check_pools(void)
+{
+    task_creation_stats_t before;
+    task_creation_stats_t after;
+    dsrtos_tcb_t *small;
+    dsrtos_tcb_t *again;
+    dsrtos_tcb_t *large[3];
+    uint32_t count;
+
+    HOST_CHECK(dsrtos_task_release(NULL) == DSRTOS_ERROR_INVALID_PARAM);
+    HOST_CHECK(dsrtos_task_pool_get_stats(&before) == DSRTOS_SUCCESS);
+
+    /* LIFO reuse: the block just freed is the next one handed out */
+    small = create(512U, true);
+    HOST_CHECK(small != NULL);
+    destroy(small);
+    again = create(300U, true);
+    HOST_CHECK(again == small);
+    destroy(again);
+
+    /* Two 2 KB stacks in the large class; the third comes from CCM */
+    for (count = 0U; count < 3U; count++) {
+        large[count] = create(2048U, true);
+        HOST_CHECK(large[count] != NULL);
+    }
+    HOST_CHECK(dsrtos_task_pool_get_stats(&after) == DSRTOS_SUCCESS);
+    HOST_CHECK((after.pool_allocations - before.pool_allocations) == 4U);
+    HOST_CHECK((after.dynamic_allocations - before.dynamic_allocations) == 1U);
+    HOST_CHECK(dsrtos_region_of(large[2]) == BENCH_REGION_CCM);
+    HOST_CHECK(dsrtos_region_of(large[2]->stack_base) == BENCH_REGION_CCM);
+    for (count = 0U; count < 3U; count++) {
+        destroy(large[count]);
+    }
+
+    /* Small stacks spill into the larger classes, then to CCM */
+    for (count = 0U; count < (BENCH_TCB_POOL + 4U); count++) {
+        g_many[count] = create(256U, true);
+        HOST_CHECK(g_many[count] != NULL);
+    }
+    HOST_CHECK(dsrtos_task_pool_get_stats(&before) == DSRTOS_SUCCESS);
+    HOST_CHECK(before.peak_pool_usage == BENCH_POOL_STACKS);
+    for (count = 0U; count < (BENCH_TCB_POOL + 4U); count++) {
+        destroy(g_many[count]);
+    }
+
+    HOST_CHECK(dsrtos_task_pool_get_stats(&after) == DSRTOS_SUCCESS);
+    HOST_CHECK(after.total_deleted == after.total_created);
+    HOST_CHECK(after.create_failures == 0U);
+}
+
+static void check_budget(void)
+{
+    dsrtos_budget_config_t config;
+    dsrtos_budget_stats_t stats;
+    dsrtos_tcb_t *task;
+    dsrtos_tcb_t *again;
+    uint32_t server;
+
+    (void)memset(&config, 0, sizeof(config));
+    config.budget_cycles = 1000000U;
+    config.period_ticks = 10U;
+    config.action = DSRTOS_BUDGET_ACTION_DEMOTE;
+    config.name = "churn";
+    HOST_CHECK(dsrtos_budget_server_create(&config, &server) == DSRTOS_SUCCESS);
+
+    task = create(512U, true);
+    HOST_CHECK(task != NULL);
+    HOST_CHECK(dsrtos_budget_attach(task, server) == DSRTOS_SUCCESS);
+    destroy(task);
+    HOST_CHECK(dsrtos_budget_get_stats(server, &stats) == DSRTOS_SUCCESS);
+    HOST_CHECK(stats.member_count == 0U);
+
+    /* Same pool slot, new task: the server holds it once, not twice */
+    again = create(512U, true);
+    HOST_CHECK(again == task);
+    HOST_CHECK(again->budget == NULL);
+    HOST_CHECK(dsrtos_budget_attach(again, server) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_budget_get_stats(server, &stats) == DSRTOS_SUCCESS);
+    HOST_CHECK(stats.member_count == 1U);
+    destroy(again);
+
+    HOST_CHECK(dsrtos_budget_server_delete(server) == DSRTOS_SUCCESS);
+}
+
+/* More self-exits than TCBs: each exit's blocks must come back */
+static void check_exit(void)
+{
+    task_creation_stats_t before;
+    task_creation_stats_t after;
+    dsrtos_tcb_t *task;
+    dsrtos_tcb_t *first = NULL;
+
+    HOST_CHECK(dsrtos_task_retire(NULL) == DSRTOS_ERROR_INVALID_PARAM);
+    HOST_CHECK(dsrtos_task_pool_get_stats(&before) == DSRTOS_SUCCESS);
+
+    for (uint32_t i = 0U; i < BENCH_EXITS; i++) {
+        task = create(512U, true);
+        HOST_CHECK(task != NULL);
+        if (first == NULL) {
+            first = task;
+        }
+        /* The last exit was reaped first, so its TCB is handed out again */
+        HOST_CHECK(task == first);
+
+        /* The task returns from its entry point while running */
+        dsrtos_host_set_current(task);
+        HOST_CHECK(dsrtos_task_retire(task) == DSRTOS_SUCCESS);
+        HOST_CHECK(dsrtos_task_release(task) == DSRTOS_ERROR_INVALID_PARAM);
+        HOST_CHECK(dsrtos_task_reap() == 0U);
+        dsrtos_host_set_current(NULL);
+    }
+
+    /* The last exit waits for the reaper, which retires its handle */
+    HOST_CHECK(dsrtos_task_get_by_id(first->task_id) == first);
+    HOST_CHECK(dsrtos_task_reap() == 1U);
+    HOST_CHECK(dsrtos_task_reap() == 0U);
+    HOST_CHECK(dsrtos_task_get_by_id(first->task_id) == NULL);
+
+    HOST_CHECK(dsrtos_task_pool_get_stats(&after) == DSRTOS_SUCCESS);
+    HOST_CHECK((after.pool_allocations - before.pool_allocations) == BENCH_EXITS);
+    HOST_CHECK(after.dynamic_allocations == before.dynamic_allocations);
+    HOST_CHECK(after.total_deleted == after.total_created);
+    HOST_CHECK(after.create_failures == before.create_failures);
+}
+
+/*==============================================================================
+ * BENCHMARKS
+ *============================================================================*/
+
+/* BENCH_CYCLES times: release a random live task, create its replacement */
+static void bench_churn(bool use_pool)
+{
+    dsrtos_host_sample_t create_sample;
+    dsrtos_host_sample_t release_sample;
+    task_creation_stats_t before;
+    task_creation_stats_t after;
+    uint64_t t0;
+    uint64_t t1;
+
+    dsrtos_host_sample_init(&create_sample, use_pool ? "pool create" : "region create");
+    dsrtos_host_sample_init(&release_sample, use_pool ? "pool delete+release" : "region delete+release");
+    dsrtos_host_srand(0x7A5C0000U);
+    HOST_CHECK(dsrtos_task_pool_get_stats(&before) == DSRTOS_SUCCESS);
+
+    for (uint32_t i = 0U; i < BENCH_LIVE; i++) {
+        g_live[i] = create(random_stack_size(), use_pool);
+        HOST_CHECK(g_live[i] != NULL);
+    }
+
+    t0 = dsrtos_host_time_ns();
+    for (uint32_t i = 0U; i < BENCH_CYCLES; i++) {
+        uint32_t slot = dsrtos_host_rand() % BENCH_LIVE;
+        uint32_t stack_size = random_stack_size();
+        uint32_t c0;
+        uint32_t c1;
+
+        c0 = dsrtos_port_get_cycle_count();
+        destroy(g_live[slot]);
+        c1 = dsrtos_port_get_cycle_count();
+        dsrtos_host_sample_add(&release_sample, c1 - c0);
+
+        c0 = dsrtos_port_get_cycle_count();
+        g_live[slot] = create(stack_size, use_pool);
+        c1 = dsrtos_port_get_cycle_count();
+        HOST_CHECK(g_live[slot] != NULL);
+        dsrtos_host_sample_add(&create_sample, c1 - c0);
+    }
+    t1 = dsrtos_host_time_ns();
+
+    for (uint32_t i = 0U; i < BENCH_LIVE; i++) {
+        destroy(g_live[i]);
+    }
+    HOST_CHECK(dsrtos_task_pool_get_stats(&after) == DSRTOS_SUCCESS);
+    if (use_pool) {
+        /* 16 live tasks never exhaust the 32 TCBs; stacks may spill */
+        HOST_CHECK((after.pool_allocations - before.pool_allocations) > (BENCH_CYCLES / 2U));
+    } else {
+        HOST_CHECK(after.pool_allocations == before.pool_allocations);
+    }
+
+    dsrtos_host_sample_print(&create_sample);
+    dsrtos_host_sample_print(&release_sample);
+    (void)printf("  %-36s %.0f create+delete/s\n", use_pool ? "pool churn" : "region churn",
+                 (double)BENCH_CYCLES * 1e9 / (double)(t1 - t0));
+}
+
+/*==============================================================================
+ * MAIN
+ *============================================================================*/
+
+int main(void)
+{
+    task_creation_stats_t stats;
+    dsrtos_region_desc_t map[2];
+    dsrtos_region_stats_t region_stats;
+
+    HOST_CHECK(dsrtos_memory_init() == DSRTOS_SUCCESS);
+
+    /* The target map: kernel heap in SRAM, then free CCM */
+    map[0].name = "sram";
+    map[0].base = NULL;
+    map[0].size = 0U;
+    map[0].attrs = DSRTOS_REGION_ATTR_DMA | DSRTOS_REGION_ATTR_HEAP;
+    map[1].name = "ccm";
+    map[1].base = g_ccm;
+    map[1].size = BENCH_CCM_SIZE;
+    map[1].attrs = DSRTOS_REGION_ATTR_FAST;
+    HOST_CHECK(dsrtos_region_init(map, 2U) == DSRTOS_SUCCESS);
+
+    HOST_CHECK(dsrtos_task_creation_init() == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_budget_init(NULL) == DSRTOS_SUCCESS);
+
+    check_pools();
+    check_budget();
+    check_exit();
+
+    (void)printf("Task churn benchmark (%u cycles, %u live tasks, cycles)\n",
+                 BENCH_CYCLES, BENCH_LIVE);
+    bench_churn(true);
+    bench_churn(false);
+
+    HOST_CHECK(dsrtos_task_pool_get_stats(&stats) == DSRTOS_SUCCESS);
+    HOST_CHECK(stats.total_deleted == stats.total_created);
+    HOST_CHECK(dsrtos_region_get_stats(BENCH_REGION_CCM, &region_stats) == DSRTOS_SUCCESS);
+    HOST_CHECK(region_stats.alloc_count > 0U);
+    HOST_CHECK(region_stats.in_use == 0U);
+
+    return dsrtos_host_finish("dsrtos_bench_task");
+}
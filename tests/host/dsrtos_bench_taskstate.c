@@ -0,0 +1,263 @@
+/*
+ * @file dsrtos_bench_taskstate.c
+ * @brief Task state machine: transition table and block/unblock cost (host port)
+ * @date 2024-12-30
+ *
+ * Drives every (from, to) pair of task states through
+ * dsrtos_state_transition and checks the result against the legal
+ * transition list, together with the queue actions each transition must
+ * run. Then times the block/unblock round trip (READY -> BLOCKED -> READY)
+ * without and with a state-change hook.
+ *
+ * The ready, blocked and suspended queues are stubbed with call counters so
+ * the cost measured is the state machine's own.
+ */
+
+#include "dsrtos_host_port.h"
+#include "dsrtos_task_state.h"
+#include "dsrtos_task_queue.h"
+#include "dsrtos_port.h"
+#include <stdio.h>
+#include <string.h>
+
+/*==============================================================================
+ * CONFIGURATION
+ *============================================================================*/
+
+#define BENCH_ROUNDS            (20000U)
+#define BENCH_BATCH             (100U)     /* Round trips per timed sample */
+#define BENCH_STACK_SIZE        (1024U)
+
+/* Queue counters */
+enum {
+    Q_READY_IN = 0,
+    Q_READY_OUT,
+    Q_BLOCKED_IN,
+    Q_BLOCKED_OUT,
+    Q_SUSPENDED_IN,
+    Q_SUSPENDED_OUT,
+    Q_COUNT
+};
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+static dsrtos_tcb_t g_tcb;
+static uint8_t g_stack[BENCH_STACK_SIZE] __attribute__((aligned(8)));
+static uint32_t g_queue_ops[Q_COUNT];
+static uint32_t g_hook_calls;
+static dsrtos_task_state_t g_hook_old;
+static dsrtos_task_state_t g_hook_new;
+
+/* Legal transitions: the table in src/phase3/dsrtos_task_state.c */
+static const struct {
+    dsrtos_task_state_t from;
+    dsrtos_task_state_t to;
+} g_legal[] = {
+    { DSRTOS_TASK_STATE_INVALID,   DSRTOS_TASK_STATE_CREATED },
+    { DSRTOS_TASK_STATE_INVALID,   DSRTOS_TASK_STATE_READY },
+    { DSRTOS_TASK_STATE_INVALID,   DSRTOS_TASK_STATE_DORMANT },
+    { DSRTOS_TASK_STATE_CREATED,   DSRTOS_TASK_STATE_READY },
+    { DSRTOS_TASK_STATE_CREATED,   DSRTOS_TASK_STATE_TERMINATED },
+    { DSRTOS_TASK_STATE_READY,     DSRTOS_TASK_STATE_RUNNING },
+    { DSRTOS_TASK_STATE_READY,     DSRTOS_TASK_STATE_BLOCKED },
+    { DSRTOS_TASK_STATE_READY,     DSRTOS_TASK_STATE_SUSPENDED },
+    { DSRTOS_TASK_STATE_READY,     DSRTOS_TASK_STATE_TERMINATED },
+    { DSRTOS_TASK_STATE_RUNNING,   DSRTOS_TASK_STATE_READY },
+    { DSRTOS_TASK_STATE_RUNNING,   DSRTOS_TASK_STATE_BLOCKED },
+    { DSRTOS_TASK_STATE_RUNNING,   DSRTOS_TASK_STATE_SUSPENDED },
+    { DSRTOS_TASK_STATE_RUNNING,   DSRTOS_TASK_STATE_TERMINATED },
+    { DSRTOS_TASK_STATE_BLOCKED,   DSRTOS_TASK_STATE_READY },
+    { DSRTOS_TASK_STATE_BLOCKED,   DSRTOS_TASK_STATE_SUSPENDED },
+    { DSRTOS_TASK_STATE_BLOCKED,   DSRTOS_TASK_STATE_TERMINATED },
+    { DSRTOS_TASK_STATE_SUSPENDED, DSRTOS_TASK_STATE_READY },
+    { DSRTOS_TASK_STATE_SUSPENDED, DSRTOS_TASK_STATE_TERMINATED },
+    { DSRTOS_TASK_STATE_DORMANT,   DSRTOS_TASK_STATE_READY },
+    { DSRTOS_TASK_STATE_DORMANT,   DSRTOS_TASK_STATE_TERMINATED }
+};
+
+/*==============================================================================
+ * KERNEL STUBS
+ *============================================================================*/
+
+dsrtos_error_t dsrtos_queue_ready_insert(dsrtos_tcb_t *tcb) { (void)tcb; g_queue_ops[Q_READY_IN]++; return DSRTOS_SUCCESS; }
+dsrtos_error_t dsrtos_queue_ready_remove(dsrtos_tcb_t *tcb) { (void)tcb; g_queue_ops[Q_READY_OUT]++; return DSRTOS_SUCCESS; }
+dsrtos_error_t dsrtos_queue_blocked_insert(dsrtos_tcb_t *tcb, uint32_t timeout) { (void)tcb; (void)timeout; g_queue_ops[Q_BLOCKED_IN]++; return DSRTOS_SUCCESS; }
+dsrtos_error_t dsrtos_queue_blocked_remove(dsrtos_tcb_t *tcb) { (void)tcb; g_queue_ops[Q_BLOCKED_OUT]++; return DSRTOS_SUCCESS; }
+dsrtos_error_t dsrtos_queue_suspended_insert(dsrtos_tcb_t *tcb) { (void)tcb; g_queue_ops[Q_SUSPENDED_IN]++; return DSRTOS_SUCCESS; }
+dsrtos_error_t dsrtos_queue_suspended_remove(dsrtos_tcb_t *tcb) { (void)tcb; g_queue_ops[Q_SUSPENDED_OUT]++; return DSRTOS_SUCCESS; }
+
+/*==============================================================================
+ * HELPERS
+ *============================================================================*/
+
+static void count_hook(dsrtos_tcb_t *tcb, dsrtos_task_state_t old_state, dsrtos_task_state_t new_state)
+{
+    (void)tcb;
+    g_hook_calls++;
+    g_hook_old = old_state;
+    g_hook_new = new_state;
+}
+
+static bool is_legal(dsrtos_task_state_t from, dsrtos_task_state_t to)
+{
+    for (uint32_t i = 0U; i < (sizeof(g_legal) / sizeof(g_legal[0])); i++) {
+        if ((g_legal[i].from == from) && (g_legal[i].to == to)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Queue a state is kept on: the ops to expect when entering/leaving it */
+static int queue_in(dsrtos_task_state_t state)
+{
+    switch (state) {
+        case DSRTOS_TASK_STATE_READY:     return Q_READY_IN;
+        case DSRTOS_TASK_STATE_BLOCKED:   return Q_BLOCKED_IN;
+        case DSRTOS_TASK_STATE_SUSPENDED: return Q_SUSPENDED_IN;
+        default:                          return -1;
+    }
+}
+
+/*==============================================================================
+ * FUNCTIONAL CHECKS
+ *============================================================================*/
+
+static void check_matrix(void)
+{
+    uint32_t legal = 0U;
+
+    for (uint32_t from = 0U; from < (uint32_t)DSRTOS_TASK_STATE_MAX; from++) {
+        for (uint32_t to = 0U; to < (uint32_t)DSRTOS_TASK_STATE_MAX; to++) {
+            uint32_t ops_before[Q_COUNT];
+            bool allowed = is_legal((dsrtos_task_state_t)from, (dsrtos_task_state_t)to);
+            int leave = queue_in((dsrtos_task_state_t)from);
+            int enter = queue_in((dsrtos_task_state_t)to);
+            dsrtos_error_t err;
+
+            g_tcb.state = (dsrtos_task_state_t)from;
+            (void)memcpy(ops_before, g_queue_ops, sizeof(ops_before));
+            err = dsrtos_state_transition(&g_tcb, (dsrtos_task_state_t)to);
+
+            HOST_CHECK(err == (allowed ? DSRTOS_SUCCESS : DSRTOS_ERROR_INVALID_STATE));
+            HOST_CHECK(g_tcb.state == (dsrtos_task_state_t)(allowed ? to : from));
+            for (int q = 0; q < Q_COUNT; q++) {
+                uint32_t expected = 0U;
+
+                if (allowed && (leave >= 0) && (q == (leave + 1))) {
+                    expected++;
+                }
+                if (allowed && (enter >= 0) && (q == enter)) {
+                    expected++;
+                }
+                HOST_CHECK((g_queue_ops[q] - ops_before[q]) == expected);
+            }
+            if (allowed) {
+                HOST_CHECK(g_tcb.prev_state == (dsrtos_task_state_t)from);
+                legal++;
+            }
+        }
+    }
+    HOST_CHECK(legal == (sizeof(g_legal) / sizeof(g_legal[0])));
+}
+
+static void check_errors(void)
+{
+    dsrtos_state_stats_t stats;
+    uint32_t magic = g_tcb.magic_number;
+
+    HOST_CHECK(dsrtos_state_transition(NULL, DSRTOS_TASK_STATE_READY) == DSRTOS_ERROR_INVALID_PARAM);
+    g_tcb.state = DSRTOS_TASK_STATE_READY;
+    HOST_CHECK(dsrtos_state_transition(&g_tcb, DSRTOS_TASK_STATE_MAX) == DSRTOS_ERROR_INVALID_PARAM);
+
+    /* A corrupted state has no way out */
+    g_tcb.state = (dsrtos_task_state_t)200;
+    HOST_CHECK(dsrtos_state_transition(&g_tcb, DSRTOS_TASK_STATE_READY) == DSRTOS_ERROR_INVALID_STATE);
+
+    g_tcb.magic_number = 0U;
+    g_tcb.state = DSRTOS_TASK_STATE_READY;
+    HOST_CHECK(dsrtos_state_transition(&g_tcb, DSRTOS_TASK_STATE_BLOCKED) == DSRTOS_ERROR_CORRUPTION);
+    g_tcb.magic_number = magic;
+
+    HOST_CHECK(strcmp(dsrtos_state_get_name(DSRTOS_TASK_STATE_CREATED), "CREATED") == 0);
+    HOST_CHECK(strcmp(dsrtos_state_get_name(DSRTOS_TASK_STATE_DORMANT), "DORMANT") == 0);
+    HOST_CHECK(strcmp(dsrtos_state_get_name(DSRTOS_TASK_STATE_MAX), "UNKNOWN") == 0);
+
+    HOST_CHECK(dsrtos_state_get_stats(&stats) == DSRTOS_SUCCESS);
+    HOST_CHECK(stats.total_transitions == (sizeof(g_legal) / sizeof(g_legal[0])));
+}
+
+static void check_hook(void)
+{
+    g_tcb.state = DSRTOS_TASK_STATE_READY;
+    HOST_CHECK(dsrtos_state_register_hook(count_hook) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_state_transition(&g_tcb, DSRTOS_TASK_STATE_BLOCKED) == DSRTOS_SUCCESS);
+    HOST_CHECK((g_hook_calls == 1U) && (g_hook_old == DSRTOS_TASK_STATE_READY) &&
+               (g_hook_new == DSRTOS_TASK_STATE_BLOCKED));
+
+    /* Refused transitions are not reported */
+    HOST_CHECK(dsrtos_state_transition(&g_tcb, DSRTOS_TASK_STATE_RUNNING) == DSRTOS_ERROR_INVALID_STATE);
+    HOST_CHECK(g_hook_calls == 1U);
+
+    HOST_CHECK(dsrtos_state_register_hook(NULL) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_state_transition(&g_tcb, DSRTOS_TASK_STATE_READY) == DSRTOS_SUCCESS);
+    HOST_CHECK(g_hook_calls == 1U);
+}
+
+/*==============================================================================
+ * BENCHMARKS
+ *============================================================================*/
+
+static void bench_round_trip(const char* label)
+{
+    dsrtos_host_sample_t sample;
+
+    g_tcb.state = DSRTOS_TASK_STATE_READY;
+    dsrtos_host_sample_init(&sample, label);
+    for (uint32_t i = 0U; i < (BENCH_ROUNDS / BENCH_BATCH); i++) {
+        uint32_t t0 = dsrtos_port_get_cycle_count();
+        for (uint32_t j = 0U; j < BENCH_BATCH; j++) {
+            (void)dsrtos_state_transition(&g_tcb, DSRTOS_TASK_STATE_BLOCKED);
+            (void)dsrtos_state_transition(&g_tcb, DSRTOS_TASK_STATE_READY);
+        }
+        uint32_t t1 = dsrtos_port_get_cycle_count();
+
+        dsrtos_host_sample_add(&sample, (t1 - t0) / BENCH_BATCH);
+    }
+    dsrtos_host_sample_print(&sample);
+    HOST_CHECK(g_tcb.state == DSRTOS_TASK_STATE_READY);
+}
+
+/*==============================================================================
+ * MAIN
+ *============================================================================*/
+
+int main(void)
+{
+    dsrtos_task_params_t params;
+    uint32_t hook_before;
+
+    (void)memset(&params, 0, sizeof(params));
+    (void)memcpy(params.name, "state", 6U);
+    params.priority = 10U;
+    params.stack_buffer = g_stack;
+    params.stack_size = BENCH_STACK_SIZE;
+    HOST_CHECK(dsrtos_task_create_static(&g_tcb, &params) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_state_init() == DSRTOS_SUCCESS);
+
+    check_matrix();
+    check_errors();
+    check_hook();
+
+    (void)printf("Task state benchmark (%u block/unblock round trips, cycles per round trip)\n",
+                 BENCH_ROUNDS);
+    bench_round_trip("block/unblock, no hook");
+    HOST_CHECK(dsrtos_state_register_hook(count_hook) == DSRTOS_SUCCESS);
+    hook_before = g_hook_calls;
+    bench_round_trip("block/unblock, state-change hook");
+    HOST_CHECK((g_hook_calls - hook_before) == (2U * BENCH_ROUNDS));
+
+    return dsrtos_host_finish("dsrtos_bench_taskstate");
+}
@@ -0,0 +1,393 @@
+/*
+ * @file dsrtos_bench_tcb.c
+ * @brief Hot/cold TCB layout against the interleaved one it replaces (host port)
+ * @date 2024-12-30
+ *
+ * Checks the TCB layout contract: stack_pointer at offset 0 for PendSV,
+ * every scheduling-hot field inside the first DSRTOS_TCB_HOT_BYTES and
+ * TCBs that start on a line. Then it runs the same ready-queue scan and
+ * single-task select over the current layout and over a copy of the old
+ * one, where the hot fields were spread across the struct. Each reads the
+ * fields a scheduling decision reads: stack pointer and bounds, canary,
+ * magic, state, effective priority, queue node, time slice and budget.
+ *
+ * Both are timed with the TCBs flushed from the cache first. L1D read
+ * misses come from the host PMU where perf_event_open allows it;
+ * otherwise only the lines each layout touches are reported.
+ */
+
+#include "dsrtos_host_port.h"
+#include "dsrtos_config.h"
+#include "dsrtos_task_manager.h"
+#include "dsrtos_port.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*==============================================================================
+ * CONFIGURATION
+ *============================================================================*/
+
+#define BENCH_TASKS             (512U)      /* Well past L1D in either layout */
+#define BENCH_SCANS             (400U)
+#define BENCH_SELECTS           (4000U)
+#define BENCH_CACHE_LINE        (64U)
+#define BENCH_TIME_SLICE        (10U)
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+/* The TCB before the hot/cold split */
+typedef struct legacy_tcb {
+    uint32_t task_id;
+    char name[DSRTOS_TASK_NAME_MAX_LENGTH];
+    dsrtos_task_state_t state;
+    dsrtos_task_priority_t priority;
+    dsrtos_task_priority_t effective_priority;
+    void* stack_base;
+    void* stack_pointer;
+    uint32_t stack_size;
+    uint32_t stack_usage;
+    uint32_t stack_watermark;
+    dsrtos_cpu_context_t cpu_context;
+    dsrtos_task_entry_t entry_point;
+    void* parameter;
+    uint32_t cpu_usage;
+    uint32_t run_count;
+    uint32_t context_switches;
+    struct legacy_tcb* next;
+    struct legacy_tcb* prev;
+    void* task_param;
+    uint32_t static_priority;
+    uint32_t flags;
+    uint32_t sched_class;
+    uint32_t deadline;
+    uint32_t period;
+    uint32_t wcet;
+    uint32_t cpu_affinity;
+    void* exit_handler;
+    dsrtos_task_state_t prev_state;
+    struct {
+        uint32_t total_runtime;
+        uint32_t last_runtime;
+        uint32_t activation_time;
+        uint32_t time_slice_remaining;
+        uint32_t deadline;
+        uint32_t period;
+        uint32_t wcet;
+        uint32_t response_time;
+        uint32_t jitter;
+    } timing;
+    struct {
+        uint32_t resource_mask;
+        uint32_t waiting_on;
+    } resources;
+    struct {
+        uint32_t messages_sent;
+        uint32_t messages_received;
+        uint32_t ipc_blocked_count;
+        uint32_t signals_pending;
+    } ipc;
+    struct {
+        uint32_t total_runtime;
+        uint32_t max_runtime;
+        uint32_t min_runtime;
+        uint32_t context_switches;
+        uint32_t preemptions;
+        uint32_t deadline_misses;
+    } stats;
+    void* queue_node;
+    uint32_t magic_number;
+    uint32_t stack_canary;
+    uint32_t voluntary_yields;
+    void* arena;
+    void* budget;
+} legacy_tcb_t;
+
+typedef struct {
+    const char *name;
+    uint32_t lines_per_task;
+    uint32_t scan_cycles;
+    uint64_t scan_misses;
+    uint32_t select_cycles;
+    uint64_t select_misses;
+} layout_result_t;
+
+static dsrtos_tcb_t g_tasks[BENCH_TASKS];
+static legacy_tcb_t g_legacy[BENCH_TASKS];
+static uint32_t g_order[BENCH_TASKS];
+static uint32_t g_samples[BENCH_SELECTS];
+static uint32_t g_old_samples[BENCH_SELECTS];
+static int g_l1d_fd = -1;
+static volatile uint32_t g_sink;
+
+/*==============================================================================
+ * HELPERS
+ *============================================================================*/
+
+/* One scheduling decision's reads; the same expression for both layouts */
+#define TCB_DECISION_READ(t, slice) \
+    ((((t)->magic_number == DSRTOS_TCB_MAGIC) && \
+      ((t)->state == DSRTOS_TASK_STATE_READY) && \
+      ((t)->stack_canary == DSRTOS_STACK_CANARY) && \
+      ((t)->queue_node != NULL) && \
+      ((uintptr_t)(t)->stack_pointer > (uintptr_t)(t)->stack_base) && \
+      ((uintptr_t)(t)->stack_pointer < ((uintptr_t)(t)->stack_base + (t)->stack_size)) && \
+      ((slice) != 0U) && \
+      ((t)->budget == NULL)) ? (uint32_t)(t)->effective_priority + 1U : 0U)
+
+/* Distinct cache lines the decision reads touch in one TCB */
+#define TCB_HOT_LINES(t, slice_field) \
+    lines_touched((const void *[]){ &(t)->stack_pointer, &(t)->magic_number, &(t)->state, \
+                                    &(t)->effective_priority, &(t)->task_id, &(t)->queue_node, \
+                                    &(t)->stack_base, &(t)->stack_size, &(t)->stack_canary, \
+                                    &(slice_field), &(t)->budget }, 11U)
+
+static uint32_t lines_touched(const void *const *fields, uint32_t count)
+{
+    uintptr_t lines[16];
+    uint32_t distinct = 0U;
+
+    for (uint32_t i = 0U; i < count; i++) {
+        uintptr_t line = (uintptr_t)fields[i] / BENCH_CACHE_LINE;
+        bool seen = false;
+
+        for (uint32_t j = 0U; j < distinct; j++) {
+            seen = seen || (lines[j] == line);
+        }
+        if (!seen) {
+            lines[distinct++] = line;
+        }
+    }
+
+    return distinct;
+}
+
+static void flush(const void *base, size_t size)
+{
+    const uint8_t *bytes = (const uint8_t *)base;
+
+    for (size_t offset = 0U; offset < size; offset += BENCH_CACHE_LINE) {
+        __builtin_ia32_clflush(&bytes[offset]);
+    }
+    __builtin_ia32_clflush(&bytes[size - 1U]);
+    __builtin_ia32_mfence();
+}
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+static uint32_t median(uint32_t *samples, uint32_t count)
+{
+    qsort(samples, count, sizeof(samples[0]), compare_u32);
+    return samples[count / 2U];
+}
+
+static void tasks_setup(void)
+{
+    static uint32_t stacks[BENCH_TASKS][16];
+
+    for (uint32_t i = 0U; i < BENCH_TASKS; i++) {
+        dsrtos_tcb_t *task = &g_tasks[i];
+        legacy_tcb_t *old = &g_legacy[i];
+        uint32_t priority = dsrtos_host_rand() % 32U;
+
+        (void)memset(task, 0, sizeof(*task));
+        task->task_id = i + 1U;
+        task->magic_number = DSRTOS_TCB_MAGIC;
+        task->state = DSRTOS_TASK_STATE_READY;
+        task->effective_priority = (dsrtos_task_priority_t)priority;
+        task->stack_base = stacks[i];
+        task->stack_size = (uint32_t)sizeof(stacks[i]);
+        task->stack_pointer = &stacks[i][8];
+        task->stack_canary = DSRTOS_STACK_CANARY;
+        task->queue_node = task;
+        task->time_slice_remaining = BENCH_TIME_SLICE;
+
+        (void)memset(old, 0, sizeof(*old));
+        old->task_id = task->task_id;
+        old->magic_number = task->magic_number;
+        old->state = task->state;
+        old->effective_priority = task->effective_priority;
+        old->stack_base = task->stack_base;
+        old->stack_size = task->stack_size;
+        old->stack_pointer = task->stack_pointer;
+        old->stack_canary = task->stack_canary;
+        old->queue_node = old;
+        old->timing.time_slice_remaining = task->time_slice_remaining;
+
+        g_order[i] = i;
+    }
+
+    /* Ready order unrelated to memory order, as after many insert/remove */
+    for (uint32_t i = BENCH_TASKS - 1U; i > 0U; i--) {
+        uint32_t j = dsrtos_host_rand() % (i + 1U);
+        uint32_t swap = g_order[i];
+        g_order[i] = g_order[j];
+        g_order[j] = swap;
+    }
+}
+
+/*==============================================================================
+ * CHECKS
+ *============================================================================*/
+
+static void check_layout(void)
+{
+    HOST_CHECK(offsetof(dsrtos_tcb_t, stack_pointer) == 0U);
+    HOST_CHECK((offsetof(dsrtos_tcb_t, budget) + sizeof(void *)) <= DSRTOS_TCB_HOT_BYTES);
+    HOST_CHECK(offsetof(dsrtos_tcb_t, time_slice_remaining) < DSRTOS_TCB_HOT_BYTES);
+    HOST_CHECK(offsetof(dsrtos_tcb_t, queue_node) < DSRTOS_TCB_HOT_BYTES);
+    HOST_CHECK(offsetof(dsrtos_tcb_t, magic_number) < DSRTOS_TCB_HOT_BYTES);
+    HOST_CHECK(_Alignof(dsrtos_tcb_t) == DSRTOS_TCB_ALIGN);
+    HOST_CHECK((sizeof(dsrtos_tcb_t) % DSRTOS_TCB_ALIGN) == 0U);
+    HOST_CHECK(((uintptr_t)&g_tasks[1] % DSRTOS_TCB_ALIGN) == 0U);
+
+    /* Every TCB's decision reads land in one line now, several before */
+    for (uint32_t i = 0U; i < BENCH_TASKS; i++) {
+        HOST_CHECK(TCB_HOT_LINES(&g_tasks[i], g_tasks[i].time_slice_remaining) == 1U);
+        HOST_CHECK(TCB_HOT_LINES(&g_legacy[i], g_legacy[i].timing.time_slice_remaining) > 1U);
+    }
+
+    /* Both layouts make the same decisions */
+    for (uint32_t i = 0U; i < BENCH_TASKS; i++) {
+        const dsrtos_tcb_t *task = &g_tasks[i];
+        const legacy_tcb_t *old = &g_legacy[i];
+
+        HOST_CHECK(TCB_DECISION_READ(task, task->time_slice_remaining) ==
+                   TCB_DECISION_READ(old, old->timing.time_slice_remaining));
+        HOST_CHECK(TCB_DECISION_READ(task, task->time_slice_remaining) != 0U);
+    }
+}
+
+/*==============================================================================
+ * BENCHMARK
+ *============================================================================*/
+
+/* Timestamp once every earlier load has completed */
+static inline uint32_t cycles_after_loads(void)
+{
+    __builtin_ia32_lfence();
+    return dsrtos_port_get_cycle_count();
+}
+
+/*
+ * Per layout: the highest ready priority over the whole ready list, and
+ * one task picked and checked as after a long idle period. Both start
+ * from a cold cache and add their L1D misses to *misses.
+ */
+#define DEFINE_LAYOUT_BENCH(prefix, tasks, slice_member) \
+    static uint32_t prefix##_scan(uint64_t *misses) \
+    { \
+        uint32_t start; \
+        uint32_t cycles; \
+        uint32_t best = 0U; \
+        flush((tasks), sizeof(tasks)); \
+        dsrtos_host_counter_start(g_l1d_fd); \
+        start = cycles_after_loads(); \
+        for (uint32_t i = 0U; i < BENCH_TASKS; i++) { \
+            const __typeof__((tasks)[0]) *t = &(tasks)[g_order[i]]; \
+            uint32_t prio = TCB_DECISION_READ(t, t->slice_member); \
+            best = (prio > best) ? prio : best; \
+        } \
+        g_sink = best; \
+        cycles = cycles_after_loads() - start; \
+        *misses += dsrtos_host_counter_stop(g_l1d_fd); \
+        return cycles; \
+    } \
+    static uint32_t prefix##_select(uint32_t index, uint64_t *misses) \
+    { \
+        const __typeof__((tasks)[0]) *t = &(tasks)[g_order[index % BENCH_TASKS]]; \
+        uint32_t start; \
+        uint32_t cycles; \
+        flush(t, sizeof(*t)); \
+        dsrtos_host_counter_start(g_l1d_fd); \
+        start = cycles_after_loads(); \
+        g_sink = TCB_DECISION_READ(t, t->slice_member); \
+        cycles = cycles_after_loads() - start; \
+        *misses += dsrtos_host_counter_stop(g_l1d_fd); \
+        return cycles; \
+    }
+
+DEFINE_LAYOUT_BENCH(split, g_tasks, time_slice_remaining)
+DEFINE_LAYOUT_BENCH(legacy, g_legacy, timing.time_slice_remaining)
+
+static void bench_layouts(void)
+{
+    layout_result_t results[2];
+    layout_result_t *split = &results[0];
+    layout_result_t *old = &results[1];
+
+    (void)memset(results, 0, sizeof(results));
+    split->name = "hot/cold split";
+    old->name = "interleaved (old)";
+    split->lines_per_task = TCB_HOT_LINES(&g_tasks[0], g_tasks[0].time_slice_remaining);
+    old->lines_per_task = TCB_HOT_LINES(&g_legacy[0], g_legacy[0].timing.time_slice_remaining);
+
+    /* Rounds alternate between the layouts so host noise hits both alike */
+    for (uint32_t round = 0U; round < BENCH_SCANS; round++) {
+        g_samples[round] = split_scan(&split->scan_misses);
+        g_old_samples[round] = legacy_scan(&old->scan_misses);
+    }
+    split->scan_cycles = median(g_samples, BENCH_SCANS);
+    old->scan_cycles = median(g_old_samples, BENCH_SCANS);
+    split->scan_misses /= BENCH_SCANS;
+    old->scan_misses /= BENCH_SCANS;
+
+    for (uint32_t round = 0U; round < BENCH_SELECTS; round++) {
+        g_samples[round] = split_select(round, &split->select_misses);
+        g_old_samples[round] = legacy_select(round, &old->select_misses);
+    }
+    split->select_cycles = median(g_samples, BENCH_SELECTS);
+    old->select_cycles = median(g_old_samples, BENCH_SELECTS);
+
+    (void)printf("  TCB %zu B (was %zu B), hot fields in %u B\n",
+                 sizeof(dsrtos_tcb_t), sizeof(legacy_tcb_t),
+                 (uint32_t)(offsetof(dsrtos_tcb_t, budget) + sizeof(void *)));
+    (void)printf("  %-20s %10s %12s %12s %12s %12s\n", "layout", "lines/TCB",
+                 "scan cycles", "scan L1D", "select cyc", "select L1D");
+    for (uint32_t i = 0U; i < 2U; i++) {
+        if (g_l1d_fd >= 0) {
+            (void)printf("  %-20s %10u %12u %12llu %12u %12.2f\n", results[i].name,
+                         results[i].lines_per_task, results[i].scan_cycles,
+                         (unsigned long long)results[i].scan_misses, results[i].select_cycles,
+                         (double)results[i].select_misses / (double)BENCH_SELECTS);
+        } else {
+            (void)printf("  %-20s %10u %12u %12s %12u %12s\n", results[i].name,
+                         results[i].lines_per_task, results[i].scan_cycles, "n/a",
+                         results[i].select_cycles, "n/a");
+        }
+    }
+    if (g_l1d_fd < 0) {
+        (void)printf("  (no perf L1D counter on this host: lines/TCB is the miss count per task)\n");
+    }
+
+    /* Fewer lines to fill is a cheaper cold scan on any host */
+    HOST_CHECK(split->scan_cycles < old->scan_cycles);
+    HOST_CHECK(split->select_cycles < old->select_cycles);
+    if (g_l1d_fd >= 0) {
+        HOST_CHECK(split->scan_misses < old->scan_misses);
+    }
+}
+
+int main(void)
+{
+    dsrtos_host_srand(0x7CB5A17EU);
+    tasks_setup();
+    check_layout();
+
+    g_l1d_fd = dsrtos_host_l1d_open();
+
+    (void)printf("TCB layout benchmark (%u tasks, %u cold scans, %u cold selects)\n",
+                 BENCH_TASKS, BENCH_SCANS, BENCH_SELECTS);
+    bench_layouts();
+
+    dsrtos_host_counter_close(g_l1d_fd);
+    return dsrtos_host_finish("dsrtos_bench_tcb");
+}
@@ -0,0 +1,339 @@
+/*
+ * @file dsrtos_bench_telemetry.c
+ * @brief Delta-encoded telemetry vs full statistics polling (host port)
+ * @date 2024-12-30
+ *
+ * Records an hour of once-per-second statistics from a modelled system (16
+ * tasks with 1 s to 10 min periods, system, heap and error counters) and
+ * pushes every sample through the telemetry encoder. Checks that the
+ * decoder rebuilds every sample exactly, that the stream is at least 10x
+ * smaller than polling the raw counter block, that a dropped frame is
+ * detected and recovered at the next keyframe, and that corrupt and
+ * foreign frames are rejected.
+ *
+ * Pass a file name to also write the recorded stream for
+ * PY/dsrtos_telemetry_decode.py.
+ */
+
+#include "dsrtos_host_port.h"
+#include "dsrtos_telemetry.h"
+#include "dsrtos_port.h"
+#include <stdio.h>
+#include <string.h>
+
+/*==============================================================================
+ * CONFIGURATION
+ *============================================================================*/
+
+#define BENCH_TASKS             (16U)
+#define BENCH_TASK_COUNTERS     (6U)       /* runtime, switches, preempts, stack, blocks, misses */
+#define BENCH_SYSTEM_COUNTERS   (16U)
+#define BENCH_COUNTERS          (BENCH_SYSTEM_COUNTERS + (BENCH_TASKS * BENCH_TASK_COUNTERS))
+#define BENCH_SAMPLES           (3600U)    /* One hour at 1 Hz */
+#define BENCH_KEYFRAME_INTERVAL (60U)
+#define BENCH_SCHEMA            (0x0101U)
+#define BENCH_FRAME_MAX         DSRTOS_TELEMETRY_FRAME_MAX(BENCH_COUNTERS)
+#define BENCH_STREAM_MAX        (BENCH_SAMPLES * 128U)
+
+/* System counter slots */
+#define SYS_UPTIME_MS           (0U)
+#define SYS_SWITCHES            (1U)
+#define SYS_IDLE_US             (2U)
+#define SYS_IRQS                (3U)
+#define SYS_HEAP_USED           (4U)
+#define SYS_HEAP_PEAK           (5U)
+#define SYS_HEAP_ALLOCS         (6U)
+/* 7..15: error counters, almost always zero */
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+/* Task periods in seconds: a few busy tasks, most rarely scheduled */
+static const uint32_t g_periods[BENCH_TASKS] = {
+    1U, 1U, 2U, 5U, 10U, 10U, 30U, 60U, 60U, 120U, 300U, 300U, 600U, 600U, 600U, 600U
+};
+
+static volatile uint32_t g_live[BENCH_COUNTERS];
+static uint32_t g_recorded[BENCH_SAMPLES][BENCH_COUNTERS];
+static uint8_t g_stream[BENCH_STREAM_MAX];
+static uint32_t g_frame_len[BENCH_SAMPLES];
+static uint32_t g_frame_off[BENCH_SAMPLES];
+static uint32_t g_stream_len;
+
+/*==============================================================================
+ * HELPERS
+ *============================================================================*/
+
+/* Advance the modelled system by one second */
+static void model_step(uint32_t second)
+{
+    uint32_t busy_us = 0U;
+
+    g_live[SYS_UPTIME_MS] += 1000U;
+    g_live[SYS_IRQS] += 1000U + (dsrtos_host_rand() % 8U);   /* 1 kHz tick */
+
+    for (uint32_t t = 0U; t < BENCH_TASKS; t++) {
+        volatile uint32_t* task = &g_live[BENCH_SYSTEM_COUNTERS + (t * BENCH_TASK_COUNTERS)];
+
+        if ((second % g_periods[t]) == 0U) {
+            uint32_t run = 200U + (dsrtos_host_rand() % 5000U);
+
+            task[0] += run;
+            task[1] += 1U + (dsrtos_host_rand() % 3U);
+            if ((dsrtos_host_rand() % 16U) == 0U) {
+                task[2] += 1U;
+            }
+            if ((dsrtos_host_rand() % 64U) == 0U) {
+                task[3] += 4U;                  /* Stack high-water creeps up */
+            }
+            busy_us += run;
+            g_live[SYS_SWITCHES] += 2U;
+        }
+        if ((t < 2U) && ((dsrtos_host_rand() % 4U) == 0U)) {
+            task[4] += 1U;                      /* Busy tasks block on queues */
+        }
+    }
+    g_live[SYS_IDLE_US] += 1000000U - busy_us;
+
+    if ((dsrtos_host_rand() % 8U) == 0U) {
+        uint32_t used = 8192U + (dsrtos_host_rand() % 4096U);
+
+        g_live[SYS_HEAP_USED] = used;
+        g_live[SYS_HEAP_ALLOCS] += 1U;
+        if (used > g_live[SYS_HEAP_PEAK]) {
+            g_live[SYS_HEAP_PEAK] = used;
+        }
+    }
+    if ((dsrtos_host_rand() % 900U) == 0U) {
+        g_live[7U + (dsrtos_host_rand() % 9U)] += 1U;
+    }
+}
+
+/* Record every sample and encode it into g_stream */
+static void record(void)
+{
+    dsrtos_telemetry_encoder_t enc;
+    uint32_t shadow[BENCH_COUNTERS];
+    dsrtos_size_t len;
+
+    (void)memset((void*)g_live, 0, sizeof(g_live));
+    dsrtos_host_srand(86U);
+    HOST_CHECK(dsrtos_telemetry_encoder_init(&enc, BENCH_SCHEMA, shadow, BENCH_COUNTERS,
+                                             BENCH_KEYFRAME_INTERVAL) == DSRTOS_SUCCESS);
+
+    g_stream_len = 0U;
+    for (uint32_t s = 0U; s < BENCH_SAMPLES; s++) {
+        model_step(s);
+        for (uint32_t i = 0U; i < BENCH_COUNTERS; i++) {
+            g_recorded[s][i] = g_live[i];
+        }
+        HOST_CHECK((g_stream_len + BENCH_FRAME_MAX) <= BENCH_STREAM_MAX);
+        HOST_CHECK(dsrtos_telemetry_encode(&enc, g_live, &g_stream[g_stream_len],
+                                           BENCH_FRAME_MAX, &len) == DSRTOS_SUCCESS);
+        g_frame_off[s] = g_stream_len;
+        g_frame_len[s] = (uint32_t)len;
+        g_stream_len += (uint32_t)len;
+    }
+
+    HOST_CHECK(enc.frames == BENCH_SAMPLES);
+    HOST_CHECK(enc.keyframes == (BENCH_SAMPLES / BENCH_KEYFRAME_INTERVAL));
+    HOST_CHECK(enc.bytes == g_stream_len);
+}
+
+/* Decode frame s (a copy: decoding is in place) */
+static dsrtos_error_t decode_frame(dsrtos_telemetry_decoder_t* dec, uint32_t s)
+{
+    uint8_t frame[BENCH_FRAME_MAX];
+    uint32_t len = g_frame_len[s];
+
+    (void)memcpy(frame, &g_stream[g_frame_off[s]], len);
+    HOST_CHECK(frame[len - 1U] == DSRTOS_TELEMETRY_DELIMITER);
+    for (uint32_t i = 0U; i < (len - 1U); i++) {
+        HOST_CHECK(frame[i] != DSRTOS_TELEMETRY_DELIMITER);
+    }
+    return dsrtos_telemetry_decode(dec, frame, len - 1U);
+}
+
+/*==============================================================================
+ * FUNCTIONAL CHECKS
+ *============================================================================*/
+
+static void check_roundtrip(void)
+{
+    dsrtos_telemetry_decoder_t dec;
+    uint32_t values[BENCH_COUNTERS];
+
+    HOST_CHECK(dsrtos_telemetry_decoder_init(&dec, BENCH_SCHEMA, values, BENCH_COUNTERS) == DSRTOS_SUCCESS);
+    for (uint32_t s = 0U; s < BENCH_SAMPLES; s++) {
+        HOST_CHECK(decode_frame(&dec, s) == DSRTOS_SUCCESS);
+        HOST_CHECK(memcmp(values, g_recorded[s], sizeof(values)) == 0);
+    }
+    HOST_CHECK(dec.frames == BENCH_SAMPLES);
+    HOST_CHECK((dec.gaps == 0U) && (dec.crc_errors == 0U) && (dec.unsynced == 0U));
+}
+
+static void check_loss(void)
+{
+    dsrtos_telemetry_decoder_t dec;
+    uint32_t values[BENCH_COUNTERS];
+    const uint32_t lost = 100U;                 /* Delta frame mid-interval */
+    const uint32_t resync = 120U;               /* Next keyframe */
+
+    HOST_CHECK(dsrtos_telemetry_decoder_init(&dec, BENCH_SCHEMA, values, BENCH_COUNTERS) == DSRTOS_SUCCESS);
+
+    /* A delta frame before any keyframe is refused */
+    HOST_CHECK(decode_frame(&dec, 1U) == DSRTOS_ERROR_INVALID_STATE);
+
+    for (uint32_t s = 0U; s < lost; s++) {
+        HOST_CHECK(decode_frame(&dec, s) == DSRTOS_SUCCESS);
+    }
+    for (uint32_t s = lost + 1U; s < resync; s++) {
+        HOST_CHECK(decode_frame(&dec, s) == DSRTOS_ERROR_INVALID_STATE);
+    }
+    HOST_CHECK(decode_frame(&dec, resync) == DSRTOS_SUCCESS);
+    HOST_CHECK(memcmp(values, g_recorded[resync], sizeof(values)) == 0);
+    HOST_CHECK(dec.gaps == 1U);
+    HOST_CHECK(dec.unsynced == ((resync - lost - 1U) + 1U));
+}
+
+static void check_rejects(void)
+{
+    dsrtos_telemetry_encoder_t enc;
+    dsrtos_telemetry_decoder_t dec;
+    uint32_t shadow[BENCH_COUNTERS];
+    uint32_t values[BENCH_COUNTERS];
+    uint8_t frame[BENCH_FRAME_MAX];
+    uint8_t small[16];
+    dsrtos_size_t len;
+    uint32_t flips = 0U;
+
+    /* Every single-bit flip in a frame is caught */
+    HOST_CHECK(dsrtos_telemetry_decoder_init(&dec, BENCH_SCHEMA, values, BENCH_COUNTERS) == DSRTOS_SUCCESS);
+    HOST_CHECK(decode_frame(&dec, 0U) == DSRTOS_SUCCESS);
+    for (uint32_t bit = 0U; bit < ((g_frame_len[1] - 1U) * 8U); bit++) {
+        (void)memcpy(frame, &g_stream[g_frame_off[1]], g_frame_len[1] - 1U);
+        frame[bit / 8U] ^= (uint8_t)(1U << (bit % 8U));
+        if (dsrtos_telemetry_decode(&dec, frame, g_frame_len[1] - 1U) != DSRTOS_SUCCESS) {
+            flips++;
+        }
+    }
+    HOST_CHECK(flips == ((g_frame_len[1] - 1U) * 8U));
+    HOST_CHECK(memcmp(values, g_recorded[0], sizeof(values)) == 0);
+
+    /* Another schema is refused */
+    HOST_CHECK(dsrtos_telemetry_decoder_init(&dec, BENCH_SCHEMA + 1U, values, BENCH_COUNTERS) == DSRTOS_SUCCESS);
+    HOST_CHECK(decode_frame(&dec, 0U) == DSRTOS_ERROR_NOT_SUPPORTED);
+
+    /* A buffer too small fails without advancing, then a keyframe follows */
+    HOST_CHECK(dsrtos_telemetry_encoder_init(&enc, BENCH_SCHEMA, shadow, BENCH_COUNTERS, 60U) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_telemetry_encode(&enc, g_recorded[0], frame, sizeof(frame), &len) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_telemetry_encode(&enc, g_recorded[1], small, sizeof(small), &len) == DSRTOS_ERROR_OVERFLOW);
+    HOST_CHECK(enc.sequence == 1U);
+    HOST_CHECK(dsrtos_telemetry_encode(&enc, g_recorded[1], frame, sizeof(frame), &len) == DSRTOS_SUCCESS);
+    HOST_CHECK(enc.keyframes == 2U);
+
+    /* A keyframe on request */
+    dsrtos_telemetry_request_keyframe(&enc);
+    HOST_CHECK(dsrtos_telemetry_encode(&enc, g_recorded[2], frame, sizeof(frame), &len) == DSRTOS_SUCCESS);
+    HOST_CHECK(enc.keyframes == 3U);
+
+    /* Argument checks */
+    HOST_CHECK(dsrtos_telemetry_encoder_init(NULL, 0U, shadow, 1U, 1U) == DSRTOS_ERROR_NULL_POINTER);
+    HOST_CHECK(dsrtos_telemetry_encoder_init(&enc, 0U, shadow, 0U, 1U) == DSRTOS_ERROR_INVALID_PARAM);
+    HOST_CHECK(dsrtos_telemetry_encoder_init(&enc, 0U, shadow, 1U, 0U) == DSRTOS_ERROR_INVALID_PARAM);
+    (void)memset(&dec, 0, sizeof(dec));
+    HOST_CHECK(dsrtos_telemetry_decode(&dec, frame, len) == DSRTOS_ERROR_NOT_INITIALIZED);
+}
+
+/* Worst case: every counter changes by a 32-bit delta, zeros everywhere */
+static void check_worst_case(void)
+{
+    dsrtos_telemetry_encoder_t enc;
+    dsrtos_telemetry_decoder_t dec;
+    static uint32_t shadow[1000];
+    static uint32_t values[1000];
+    static uint32_t source[1000];
+    static uint8_t frame[DSRTOS_TELEMETRY_FRAME_MAX(1000U)];
+    dsrtos_size_t len;
+
+    HOST_CHECK(dsrtos_telemetry_encoder_init(&enc, 0U, shadow, 1000U, 2U) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_telemetry_decoder_init(&dec, 0U, values, 1000U) == DSRTOS_SUCCESS);
+    for (uint32_t round = 0U; round < 4U; round++) {
+        for (uint32_t i = 0U; i < 1000U; i++) {
+            source[i] = ((round & 1U) != 0U) ? (0x80000000U ^ (i << 20U)) : (i & 0x100U);
+        }
+        HOST_CHECK(dsrtos_telemetry_encode(&enc, source, frame, sizeof(frame), &len) == DSRTOS_SUCCESS);
+        HOST_CHECK(len <= sizeof(frame));
+        HOST_CHECK(dsrtos_telemetry_decode(&dec, frame, len - 1U) == DSRTOS_SUCCESS);
+        HOST_CHECK(memcmp(values, source, sizeof(values)) == 0);
+    }
+}
+
+/*==============================================================================
+ * BENCHMARKS
+ *============================================================================*/
+
+static void bench_encode(void)
+{
+    dsrtos_host_sample_t sample;
+    dsrtos_telemetry_encoder_t enc;
+    uint32_t shadow[BENCH_COUNTERS];
+    uint8_t frame[BENCH_FRAME_MAX];
+    dsrtos_size_t len;
+
+    dsrtos_host_sample_init(&sample, "encode one frame");
+    HOST_CHECK(dsrtos_telemetry_encoder_init(&enc, BENCH_SCHEMA, shadow, BENCH_COUNTERS,
+                                             BENCH_KEYFRAME_INTERVAL) == DSRTOS_SUCCESS);
+    for (uint32_t s = 0U; s < BENCH_SAMPLES; s++) {
+        uint32_t t0 = dsrtos_port_get_cycle_count();
+        (void)dsrtos_telemetry_encode(&enc, g_recorded[s], frame, sizeof(frame), &len);
+        uint32_t t1 = dsrtos_port_get_cycle_count();
+
+        dsrtos_host_sample_add(&sample, t1 - t0);
+    }
+    dsrtos_host_sample_print(&sample);
+}
+
+static void report_bandwidth(void)
+{
+    uint32_t raw = BENCH_SAMPLES * BENCH_COUNTERS * (uint32_t)sizeof(uint32_t);
+    uint32_t ratio_x10 = (raw * 10U) / g_stream_len;
+
+    (void)printf("  %-36s %u bytes (%u counters x %u samples)\n", "full counter block",
+                 raw, BENCH_COUNTERS, BENCH_SAMPLES);
+    (void)printf("  %-36s %u bytes, %u.%ux smaller, %u B/s\n", "telemetry stream",
+                 g_stream_len, ratio_x10 / 10U, ratio_x10 % 10U, g_stream_len / BENCH_SAMPLES);
+    HOST_CHECK(g_stream_len <= (raw / 10U));
+}
+
+/*==============================================================================
+ * MAIN
+ *============================================================================*/
+
+int main(int argc, char* argv[])
+{
+    record();
+
+    check_roundtrip();
+    check_loss();
+    check_rejects();
+    check_worst_case();
+
+    (void)printf("Telemetry benchmark (%u counters, %u samples, keyframe every %u)\n",
+                 BENCH_COUNTERS, BENCH_SAMPLES, BENCH_KEYFRAME_INTERVAL);
+    bench_encode();
+    report_bandwidth();
+
+    if (argc > 1) {
+        FILE* file = fopen(argv[1], "wb");
+
+        HOST_CHECK(file != NULL);
+        if (file != NULL) {
+            HOST_CHECK(fwrite(g_stream, 1U, g_stream_len, file) == g_stream_len);
+            (void)fclose(file);
+        }
+    }
+
+    return dsrtos_host_finish("dsrtos_bench_telemetry");
+}
@@ -0,0 +1,290 @@
+/*
+ * @file dsrtos_bench_workqueue.c
+ * @brief Work queue vs task-per-job benchmark (host port)
+ * @date 2024-12-30
+ *
+ * Compares submission-to-execution latency and throughput of the worker
+ * pool against creating and deleting a task for every job through
+ * dsrtos_task_create_extended. Also checks priority ordering, the
+ * per-queue concurrency limit, delayed release and cancellation.
+ */
+
+#include "dsrtos_host_port.h"
+#include "dsrtos_workqueue.h"
+#include "dsrtos_task_creation.h"
+#include "dsrtos_kernel.h"
+#include "dsrtos_memory.h"
+#include "dsrtos_port.h"
+#include <string.h>
+
+/*==============================================================================
+ * CONFIGURATION
+ *============================================================================*/
+
+#define BENCH_JOBS              (10000U)
+#define BENCH_BATCH             (64U)
+#define BENCH_JOB_STACK         (1024U)
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+static volatile uint32_t g_job_sink;
+static uint32_t g_job_start_cycles;
+static uint32_t g_order[16];
+static uint32_t g_order_count;
+static dsrtos_workqueue_t g_limited_wq;
+static dsrtos_workqueue_t g_other_wq;
+static uint32_t g_nested_runs;
+
+/*==============================================================================
+ * KERNEL STUBS
+ *============================================================================*/
+
+/* Workers never run here: the benchmark drains queues itself */
+void dsrtos_port_yield(void)
+{
+}
+
+/*==============================================================================
+ * JOBS
+ *============================================================================*/
+
+static void job_body(uint32_t value)
+{
+    g_job_sink += value;
+}
+
+static void job_task_entry(void *param)
+{
+    g_job_start_cycles = dsrtos_port_get_cycle_count();
+    job_body((uint32_t)(uintptr_t)param);
+}
+
+static void job_work_handler(dsrtos_work_t *work)
+{
+    g_job_start_cycles = dsrtos_port_get_cycle_count();
+    job_body((uint32_t)(uintptr_t)work->arg);
+}
+
+static void order_handler(dsrtos_work_t *work)
+{
+    g_order[g_order_count++] = (uint32_t)(uintptr_t)work->arg;
+}
+
+static void limited_handler(dsrtos_work_t *work)
+{
+    (void)work;
+
+    /* While this item runs, a second item of the same queue must wait */
+    while (dsrtos_workqueue_run_one()) {
+        g_nested_runs++;
+    }
+}
+
+/*==============================================================================
+ * FUNCTIONAL CHECKS
+ *============================================================================*/
+
+static void check_priority_order(dsrtos_workqueue_t *wq)
+{
+    static dsrtos_work_t items[4];
+    static const uint8_t prio[4] = { 5U, 1U, 5U, 0U };
+
+    g_order_count = 0U;
+    for (uint32_t i = 0U; i < 4U; i++) {
+        dsrtos_work_init(&items[i], order_handler, (void *)(uintptr_t)i);
+        HOST_CHECK(dsrtos_work_submit(wq, &items[i], prio[i]) == DSRTOS_SUCCESS);
+    }
+    HOST_CHECK(dsrtos_work_submit(wq, &items[0], 5U) == DSRTOS_ERROR_ALREADY_EXISTS);
+
+    while (dsrtos_workqueue_run_one()) {
+    }
+
+    /* Most urgent first, FIFO within a level */
+    HOST_CHECK(g_order_count == 4U);
+    HOST_CHECK(g_order[0] == 3U);
+    HOST_CHECK(g_order[1] == 1U);
+    HOST_CHECK(g_order[2] == 0U);
+    HOST_CHECK(g_order[3] == 2U);
+}
+
+static void check_concurrency_limit(void)
+{
+    static dsrtos_work_t a;
+    static dsrtos_work_t b;
+    static dsrtos_work_t c;
+
+    HOST_CHECK(dsrtos_workqueue_create(&g_limited_wq, "limited", 1U) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_workqueue_create(&g_other_wq, "other", 2U) == DSRTOS_SUCCESS);
+
+    dsrtos_work_init(&a, limited_handler, NULL);
+    dsrtos_work_init(&b, order_handler, (void *)(uintptr_t)7U);
+    dsrtos_work_init(&c, order_handler, (void *)(uintptr_t)8U);
+
+    g_order_count = 0U;
+    g_nested_runs = 0U;
+    HOST_CHECK(dsrtos_work_submit(&g_limited_wq, &a, 0U) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_work_submit(&g_limited_wq, &b, 0U) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_work_submit(&g_other_wq, &c, 3U) == DSRTOS_SUCCESS);
+
+    HOST_CHECK(dsrtos_workqueue_run_one());
+
+    /* Only the other queue could run while 'a' held the single slot */
+    HOST_CHECK(g_nested_runs == 1U);
+    HOST_CHECK((g_order_count == 1U) && (g_order[0] == 8U));
+    HOST_CHECK(dsrtos_work_is_pending(&b));
+
+    HOST_CHECK(dsrtos_workqueue_run_one());
+    HOST_CHECK((g_order_count == 2U) && (g_order[1] == 7U));
+}
+
+static void check_delayed_and_cancel(dsrtos_workqueue_t *wq)
+{
+    static dsrtos_work_t late;
+    static dsrtos_work_t early;
+    static dsrtos_work_t dropped;
+
+    dsrtos_work_init(&late, order_handler, (void *)(uintptr_t)20U);
+    dsrtos_work_init(&early, order_handler, (void *)(uintptr_t)10U);
+    dsrtos_work_init(&dropped, order_handler, (void *)(uintptr_t)99U);
+
+    g_order_count = 0U;
+    HOST_CHECK(dsrtos_work_submit_delayed(wq, &late, 2U, 20U) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_work_submit_delayed(wq, &early, 2U, 10U) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_work_submit_delayed(wq, &dropped, 2U, 15U) == DSRTOS_SUCCESS);
+
+    HOST_CHECK(dsrtos_work_cancel(&dropped) == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_work_cancel(&dropped) == DSRTOS_ERROR_NOT_FOUND);
+
+    dsrtos_host_tick_advance(9U);
+    HOST_CHECK(!dsrtos_workqueue_run_one());
+
+    dsrtos_host_tick_advance(1U);
+    HOST_CHECK(dsrtos_workqueue_run_one());
+    HOST_CHECK((g_order_count == 1U) && (g_order[0] == 10U));
+
+    dsrtos_host_tick_advance(10U);
+    HOST_CHECK(dsrtos_workqueue_run_one());
+    HOST_CHECK((g_order_count == 2U) && (g_order[1] == 20U));
+    HOST_CHECK(!dsrtos_workqueue_run_one());
+}
+
+/*==============================================================================
+ * BENCHMARKS
+ *============================================================================*/
+
+static void bench_task_per_job(void)
+{
+    dsrtos_host_sample_t latency;
+    dsrtos_task_create_extended_t params;
+    uint64_t t0;
+    uint64_t t1;
+
+    dsrtos_host_sample_init(&latency, "task-per-job submit->start");
+
+    (void)memset(&params, 0, sizeof(params));
+    (void)strncpy(params.base.name, "job", DSRTOS_TASK_NAME_MAX_LENGTH - 1U);
+    params.base.entry_point = job_task_entry;
+    params.base.priority = DSRTOS_TASK_PRIORITY_NORMAL;
+    params.base.stack_size = BENCH_JOB_STACK;
+    params.use_pool = false;
+
+    t0 = dsrtos_host_time_ns();
+    for (uint32_t i = 0U; i < BENCH_JOBS; i++) {
+        uint32_t submit = dsrtos_port_get_cycle_count();
+        dsrtos_tcb_t *tcb;
+
+        params.base.parameter = (void *)(uintptr_t)i;
+        tcb = dsrtos_task_create_extended(&params);
+        HOST_CHECK(tcb != NULL);
+        if (tcb == NULL) {
+            break;
+        }
+
+        tcb->entry_point(tcb->parameter);
+        dsrtos_host_sample_add(&latency, g_job_start_cycles - submit);
+
+        (void)dsrtos_task_delete(tcb);
+        HOST_CHECK(dsrtos_task_release(tcb) == DSRTOS_SUCCESS);
+    }
+    t1 = dsrtos_host_time_ns();
+
+    dsrtos_host_sample_print(&latency);
+    (void)printf("  %-36s %.0f jobs/s\n", "task-per-job throughput",
+                 (double)BENCH_JOBS * 1e9 / (double)(t1 - t0));
+}
+
+static void bench_workqueue(dsrtos_workqueue_t *wq)
+{
+    static dsrtos_work_t items[BENCH_BATCH];
+    dsrtos_host_sample_t latency;
+    dsrtos_host_sample_t batch_latency;
+    uint64_t t0;
+    uint64_t t1;
+
+    dsrtos_host_sample_init(&latency, "workqueue submit->start");
+    dsrtos_host_sample_init(&batch_latency, "workqueue batch-64 submit->start");
+
+    for (uint32_t i = 0U; i < BENCH_BATCH; i++) {
+        dsrtos_work_init(&items[i], job_work_handler, (void *)(uintptr_t)i);
+    }
+
+    /* One job in flight at a time */
+    t0 = dsrtos_host_time_ns();
+    for (uint32_t i = 0U; i < BENCH_JOBS; i++) {
+        uint32_t submit = dsrtos_port_get_cycle_count();
+        (void)dsrtos_work_submit(wq, &items[0], (uint8_t)(i & 7U));
+        (void)dsrtos_workqueue_run_one();
+        dsrtos_host_sample_add(&latency, g_job_start_cycles - submit);
+    }
+    t1 = dsrtos_host_time_ns();
+
+    dsrtos_host_sample_print(&latency);
+    (void)printf("  %-36s %.0f jobs/s\n", "workqueue throughput",
+                 (double)BENCH_JOBS * 1e9 / (double)(t1 - t0));
+
+    /* Bursts: queueing delay dominates, handler start is what matters */
+    t0 = dsrtos_host_time_ns();
+    for (uint32_t round = 0U; round < (BENCH_JOBS / BENCH_BATCH); round++) {
+        for (uint32_t i = 0U; i < BENCH_BATCH; i++) {
+            (void)dsrtos_work_submit(wq, &items[i], (uint8_t)(i & 7U));
+        }
+        while (dsrtos_workqueue_run_one()) {
+            dsrtos_host_sample_add(&batch_latency, 0U);
+        }
+    }
+    t1 = dsrtos_host_time_ns();
+
+    (void)printf("  %-36s %.0f jobs/s\n", "workqueue batch-64 throughput",
+                 (double)batch_latency.count * 1e9 / (double)(t1 - t0));
+}
+
+/*==============================================================================
+ * MAIN
+ *============================================================================*/
+
+int main(void)
+{
+    static dsrtos_workqueue_t wq;
+    dsrtos_workqueue_stats_t stats;
+
+    HOST_CHECK(dsrtos_memory_init() == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_task_creation_init() == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_workqueue_init() == DSRTOS_SUCCESS);
+    HOST_CHECK(dsrtos_workqueue_create(&wq, "bench", DSRTOS_WORKQUEUE_UNLIMITED) == DSRTOS_SUCCESS);
+
+    check_priority_order(&wq);
+    check_concurrency_limit();
+    check_delayed_and_cancel(&wq);
+
+    (void)printf("Work queue benchmark (%u jobs, cycles)\n", BENCH_JOBS);
+    bench_task_per_job();
+    bench_workqueue(&wq);
+
+    HOST_CHECK(dsrtos_workqueue_get_stats(&wq, &stats) == DSRTOS_SUCCESS);
+    HOST_CHECK(stats.pending == 0U);
+    (void)printf("  %-36s %u cycles\n", "workqueue max latency", stats.max_latency_cycles);
+
+    return dsrtos_host_finish("dsrtos_bench_workqueue");
+}
@@ -0,0 +1,464 @@
+/*
+ * @file dsrtos_host_port.c
+ * @brief DSRTOS Host Port for off-target benchmarks
+ * @date 2024-12-30
+ *
+ * Provides the port, time, critical section, memory and task services
+ * that kernel modules expect from the rest of the system, so a module
+ * can be linked on its own into a host benchmark.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#define _DEFAULT_SOURCE         /* syscall() for perf_event_open */
+
+#include "dsrtos_host_port.h"
+#include "dsrtos_config.h"
+#include "dsrtos_task_manager.h"
+#include "dsrtos_kernel.h"
+#include "dsrtos_critical.h"
+#include "dsrtos_hooks.h"
+#include "dsrtos_port.h"
+#include "stm32f4xx.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/*==============================================================================
+ * CONSTANTS
+ *============================================================================*/
+
+#define HOST_MAX_TICK_HOOKS     (8U)
+#define HOST_TCB_MAGIC          (DSRTOS_TCB_MAGIC)  /* As phase 4 validate_tcb checks */
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+static uint32_t g_host_tick;
+static uint32_t g_host_critical_nesting;
+static uint32_t g_host_critical_count;
+static uint32_t g_host_failures;
+#if !defined(DSRTOS_HOST_TASK_CREATION)
+static uint32_t g_host_next_task_id = 1U;
+#endif
+static uint32_t g_host_rand_state = 0x2545F491U;
+static dsrtos_tcb_t *g_host_current;
+
+/* Core registers that kernel code reads directly (core_cm4.h host build) */
+volatile uint32_t dsrtos_host_primask;
+DWT_Type dsrtos_host_dwt;
+
+#if !defined(DSRTOS_HOST_KERNEL_HOOKS)
+static dsrtos_hook_entry_t g_host_tick_hooks[HOST_MAX_TICK_HOOKS];
+static uint32_t g_host_tick_hook_count;
+#endif
+
+/*==============================================================================
+ * PORT AND TIME
+ *============================================================================*/
+
+uint32_t dsrtos_port_get_cycle_count(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return (uint32_t)__builtin_ia32_rdtsc();
+#else
+    return (uint32_t)dsrtos_host_time_ns();
+#endif
+}
+
+uint64_t dsrtos_host_time_ns(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+uint64_t dsrtos_get_system_time(void)
+{
+    return g_host_tick;
+}
+
+uint32_t dsrtos_get_tick_count(void)
+{
+    return g_host_tick;
+}
+
+void dsrtos_host_tick_advance(uint32_t ticks)
+{
+    for (uint32_t i = 0U; i < ticks; i++) {
+        g_host_tick++;
+        dsrtos_host_run_tick_hooks();
+    }
+}
+
+void dsrtos_host_tick_set(uint32_t tick)
+{
+    g_host_tick = tick;
+}
+
+void* dsrtos_port_init_stack(void *stack_top,
+                             void (*entry)(void *),
+                             void *param,
+                             void (*exit_fn)(void))
+{
+    (void)entry;
+    (void)param;
+    (void)exit_fn;
+
+    /* Reserve a basic exception frame like the Cortex-M4 port */
+    return (uint8_t *)stack_top - (16U * sizeof(uint32_t));
+}
+
+/*==============================================================================
+ * CRITICAL SECTIONS
+ *============================================================================*/
+
+void dsrtos_critical_enter(void)
+{
+    g_host_critical_nesting++;
+    g_host_critical_count++;
+}
+
+void dsrtos_critical_exit(void)
+{
+    if (g_host_critical_nesting > 0U) {
+        g_host_critical_nesting--;
+    }
+}
+
+uint32_t dsrtos_host_critical_count(void)
+{
+    return g_host_critical_count;
+}
+
+/*==============================================================================
+ * MEMORY
+ *============================================================================*/
+
+void* dsrtos_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+void dsrtos_free(void *ptr)
+{
+    free(ptr);
+}
+
+/*==============================================================================
+ * HOOKS
+ *============================================================================*/
+
+#if defined(DSRTOS_HOST_KERNEL_HOOKS)
+
+/* The benchmark links src/phase2/dsrtos_hooks.c itself */
+void dsrtos_host_run_tick_hooks(void)
+{
+    DSRTOS_HOOK_TICK();
+}
+
+#else
+
+void* dsrtos_hook_register(const dsrtos_hook_entry_t* entry)
+{
+    if ((entry == NULL) || (g_host_tick_hook_count >= HOST_MAX_TICK_HOOKS)) {
+        return NULL;
+    }
+
+    if (entry->type != DSRTOS_HOOK_KERNEL_TICK) {
+        /* Only the tick path is simulated on the host */
+        return (void *)entry;
+    }
+
+    g_host_tick_hooks[g_host_tick_hook_count] = *entry;
+    g_host_tick_hook_count++;
+
+    return &g_host_tick_hooks[g_host_tick_hook_count - 1U];
+}
+
+void dsrtos_host_run_tick_hooks(void)
+{
+    for (uint32_t i = 0U; i < g_host_tick_hook_count; i++) {
+        if (g_host_tick_hooks[i].enabled && (g_host_tick_hooks[i].function != NULL)) {
+            (void)g_host_tick_hooks[i].function(DSRTOS_HOOK_KERNEL_TICK,
+                                                g_host_tick_hooks[i].user_data);
+        }
+    }
+}
+
+#endif /* DSRTOS_HOST_KERNEL_HOOKS */
+
+/*==============================================================================
+ * TASKS
+ *============================================================================*/
+
+#if !defined(DSRTOS_HOST_TASK_CREATION)
+
+/* Benchmarks that link src/phase3/dsrtos_task_creation.c use its creation
+ * path, handle table and pools instead */
+dsrtos_error_t dsrtos_task_create_static(dsrtos_tcb_t* tcb, const dsrtos_task_params_t* params)
+{
+    uint32_t *stack;
+
+    if ((tcb == NULL) || (params == NULL) || (params->stack_buffer == NULL)) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+
+    (void)memset(tcb, 0, sizeof(*tcb));
+    (void)memcpy(tcb->name, params->name, sizeof(tcb->name));
+    tcb->task_id = g_host_next_task_id++;
+    tcb->entry_point = params->entry_point;
+    tcb->parameter = params->parameter;
+    tcb->task_param = params->parameter;
+    tcb->priority = params->priority;
+    tcb->effective_priority = params->priority;
+    tcb->static_priority = (uint32_t)params->priority;
+    tcb->flags = params->flags;
+    tcb->stack_base = params->stack_buffer;
+    tcb->stack_size = params->stack_size;
+    tcb->magic_number = HOST_TCB_MAGIC;
+
+    /* Same stack fill the target performs at creation */
+    stack = (uint32_t *)tcb->stack_base;
+    for (uint32_t i = 0U; i < (tcb->stack_size / sizeof(uint32_t)); i++) {
+        stack[i] = 0xA5A5A5A5U;
+    }
+    tcb->stack_pointer = dsrtos_port_init_stack((uint8_t *)tcb->stack_base + tcb->stack_size,
+                                                tcb->entry_point, tcb->task_param, NULL);
+    tcb->state = DSRTOS_TASK_STATE_READY;
+
+    return DSRTOS_SUCCESS;
+}
+
+dsrtos_error_t dsrtos_task_create(dsrtos_tcb_t** tcb, const dsrtos_task_params_t* params)
+{
+    dsrtos_task_params_t local;
+    dsrtos_tcb_t *new_tcb;
+    dsrtos_error_t err;
+
+    if ((tcb == NULL) || (params == NULL)) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+
+    local = *params;
+    new_tcb = (dsrtos_tcb_t *)dsrtos_malloc(sizeof(dsrtos_tcb_t));
+    local.stack_buffer = dsrtos_malloc(local.stack_size);
+    if ((new_tcb == NULL) || (local.stack_buffer == NULL)) {
+        dsrtos_free(new_tcb);
+        dsrtos_free(local.stack_buffer);
+        return DSRTOS_ERROR_NO_MEMORY;
+    }
+
+    err = dsrtos_task_create_static(new_tcb, &local);
+    if (err != DSRTOS_SUCCESS) {
+        dsrtos_free(local.stack_buffer);
+        dsrtos_free(new_tcb);
+        return err;
+    }
+
+    *tcb = new_tcb;
+    return DSRTOS_SUCCESS;
+}
+
+#endif /* DSRTOS_HOST_TASK_CREATION */
+
+dsrtos_error_t dsrtos_task_delete(dsrtos_tcb_t* tcb)
+{
+    if (tcb == NULL) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+
+    tcb->state = DSRTOS_TASK_STATE_TERMINATED;
+    tcb->magic_number = 0U;
+
+    return DSRTOS_SUCCESS;
+}
+
+dsrtos_error_t dsrtos_task_validate_tcb(const dsrtos_tcb_t* tcb)
+{
+    return ((tcb != NULL) && (tcb->magic_number == HOST_TCB_MAGIC)) ?
+           DSRTOS_SUCCESS : DSRTOS_ERROR_INVALID_PARAM;
+}
+
+dsrtos_error_t dsrtos_task_suspend(dsrtos_tcb_t* tcb)
+{
+    if (tcb == NULL) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+
+    tcb->state = DSRTOS_TASK_STATE_SUSPENDED;
+    return DSRTOS_SUCCESS;
+}
+
+dsrtos_error_t dsrtos_task_ready_insert(dsrtos_tcb_t* tcb)
+{
+    if (tcb == NULL) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+
+    tcb->state = DSRTOS_TASK_STATE_READY;
+    return DSRTOS_SUCCESS;
+}
+
+dsrtos_tcb_t* dsrtos_task_get_current(void)
+{
+    return g_host_current;
+}
+
+void dsrtos_host_set_current(dsrtos_tcb_t *tcb)
+{
+    g_host_current = tcb;
+}
+
+dsrtos_error_t dsrtos_task_block(void)
+{
+    if (g_host_current != NULL) {
+        g_host_current->state = DSRTOS_TASK_STATE_BLOCKED;
+    }
+    return DSRTOS_SUCCESS;
+}
+
+dsrtos_error_t dsrtos_task_unblock(uint32_t task_id)
+{
+    (void)task_id;
+    return DSRTOS_SUCCESS;
+}
+
+/*==============================================================================
+ * MEASUREMENT HELPERS
+ *============================================================================*/
+
+void dsrtos_host_sample_init(dsrtos_host_sample_t *sample, const char *name)
+{
+    (void)memset(sample, 0, sizeof(*sample));
+    sample->name = name;
+    sample->min_cycles = UINT32_MAX;
+}
+
+void dsrtos_host_sample_add(dsrtos_host_sample_t *sample, uint32_t cycles)
+{
+    sample->count++;
+    sample->total_cycles += cycles;
+    if (cycles < sample->min_cycles) {
+        sample->min_cycles = cycles;
+    }
+    if (cycles > sample->max_cycles) {
+        sample->max_cycles = cycles;
+    }
+}
+
+void dsrtos_host_sample_print(const dsrtos_host_sample_t *sample)
+{
+    uint64_t avg = (sample->count != 0U) ? (sample->total_cycles / sample->count) : 0U;
+
+    (void)printf("  %-36s n=%-8llu avg=%-8llu min=%-8u max=%u\n",
+                 sample->name,
+                 (unsigned long long)sample->count,
+                 (unsigned long long)avg,
+                 (sample->count != 0U) ? sample->min_cycles : 0U,
+                 sample->max_cycles);
+}
+
+/*==============================================================================
+ * HARDWARE COUNTERS
+ *============================================================================*/
+
+int dsrtos_host_l1d_open(void)
+{
+#if defined(__linux__)
+    struct perf_event_attr attr;
+
+    (void)memset(&attr, 0, sizeof(attr));
+    attr.size = (uint32_t)sizeof(attr);
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = (uint64_t)PERF_COUNT_HW_CACHE_L1D |
+                  ((uint64_t)PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  ((uint64_t)PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1U;
+    attr.exclude_kernel = 1U;
+    attr.exclude_hv = 1U;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0UL);
+#else
+    return -1;
+#endif
+}
+
+void dsrtos_host_counter_start(int fd)
+{
+#if defined(__linux__)
+    if (fd >= 0) {
+        (void)ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        (void)ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#else
+    (void)fd;
+#endif
+}
+
+uint64_t dsrtos_host_counter_stop(int fd)
+{
+    uint64_t value = 0U;
+
+#if defined(__linux__)
+    if (fd >= 0) {
+        (void)ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd, &value, sizeof(value)) != (ssize_t)sizeof(value)) {
+            value = 0U;
+        }
+    }
+#else
+    (void)fd;
+#endif
+
+    return value;
+}
+
+void dsrtos_host_counter_close(int fd)
+{
+#if defined(__linux__)
+    if (fd >= 0) {
+        (void)close(fd);
+    }
+#else
+    (void)fd;
+#endif
+}
+
+void dsrtos_host_srand(uint32_t seed)
+{
+    g_host_rand_state = (seed != 0U) ? seed : 0x2545F491U;
+}
+
+uint32_t dsrtos_host_rand(void)
+{
+    /* xorshift32 */
+    g_host_rand_state ^= g_host_rand_state << 13;
+    g_host_rand_state ^= g_host_rand_state >> 17;
+    g_host_rand_state ^= g_host_rand_state << 5;
+    return g_host_rand_state;
+}
+
+void dsrtos_host_check_failed(const char *file, int line, const char *expr)
+{
+    g_host_failures++;
+    (void)fprintf(stderr, "CHECK FAILED %s:%d: %s\n", file, line, expr);
+}
+
+int dsrtos_host_finish(const char *bench_name)
+{
+    if (g_host_failures != 0U) {
+        (void)printf("%s: %u check(s) FAILED\n", bench_name, g_host_failures);
+        return 1;
+    }
+
+    (void)printf("%s: all checks passed\n", bench_name);
+    return 0;
+}
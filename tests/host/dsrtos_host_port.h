@@ -0,0 +1,92 @@
+/*
+ * @file dsrtos_host_port.h
+ * @brief DSRTOS Host Port for off-target benchmarks
+ * @date 2024-12-30
+ *
+ * Minimal single-threaded stand-in for the Cortex-M4 port so kernel
+ * modules can be compiled with the host compiler and exercised by the
+ * benchmarks in this directory. Time is virtual: the tick only moves
+ * when a benchmark advances it. The cycle counter maps to the host TSC.
+ */
+
+#ifndef DSRTOS_HOST_PORT_H
+#define DSRTOS_HOST_PORT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "dsrtos_types.h"
+#include "dsrtos_error.h"
+
+/*==============================================================================
+ * CHECK AND REPORT HELPERS
+ *============================================================================*/
+
+/* Failing checks are counted and reported, the benchmark exits non-zero */
+#define HOST_CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            dsrtos_host_check_failed(__FILE__, __LINE__, #cond); \
+        } \
+    } while (0)
+
+/* Running statistics for one measured operation */
+typedef struct {
+    const char *name;
+    uint64_t count;
+    uint64_t total_cycles;
+    uint32_t min_cycles;
+    uint32_t max_cycles;
+} dsrtos_host_sample_t;
+
+/*==============================================================================
+ * HOST PORT API
+ *============================================================================*/
+
+/* Virtual time */
+void dsrtos_host_tick_advance(uint32_t ticks);
+void dsrtos_host_tick_set(uint32_t tick);
+
+/* Wall clock for throughput figures */
+uint64_t dsrtos_host_time_ns(void);
+
+/* Kernel tick hook, as registered through dsrtos_hook_register */
+void dsrtos_host_run_tick_hooks(void);
+
+/* Task returned by dsrtos_task_get_current, NULL by default */
+struct dsrtos_tcb;
+void dsrtos_host_set_current(struct dsrtos_tcb *tcb);
+
+/* Critical section accounting */
+uint32_t dsrtos_host_critical_count(void);
+
+/* Measurement helpers */
+void dsrtos_host_sample_init(dsrtos_host_sample_t *sample, const char *name);
+void dsrtos_host_sample_add(dsrtos_host_sample_t *sample, uint32_t cycles);
+void dsrtos_host_sample_print(const dsrtos_host_sample_t *sample);
+
+/* L1 data cache read misses from the host PMU, user space only. Open
+ * returns -1 where perf is unavailable; the others then do nothing and
+ * stop returns 0 */
+int dsrtos_host_l1d_open(void);
+void dsrtos_host_counter_start(int fd);
+uint64_t dsrtos_host_counter_stop(int fd);
+void dsrtos_host_counter_close(int fd);
+
+/* Deterministic pseudo-random source for traces */
+void dsrtos_host_srand(uint32_t seed);
+uint32_t dsrtos_host_rand(void);
+
+/* Check bookkeeping */
+void dsrtos_host_check_failed(const char *file, int line, const char *expr);
+int dsrtos_host_finish(const char *bench_name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DSRTOS_HOST_PORT_H */
@@ -0,0 +1,571 @@
+/*
+ * @file dsrtos_host_sim.c
+ * @brief Trace-driven scheduler simulator for the host port
+ * @date 2024-12-30
+ *
+ * Discrete-event loop over virtual time. Between two events the running
+ * task, if any, consumes its current job; the next event is the earliest
+ * of the next trace event, the next wake of a blocked task, the running
+ * job's completion and the end of its slice. A task sits in the plugin's
+ * ready queue, running or not, while it has pending jobs and is not
+ * blocked, as a ready task does on target.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "dsrtos_host_sim.h"
+#include "dsrtos_host_port.h"
+#include "dsrtos_task_manager.h"
+#include "dsrtos_port.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*==============================================================================
+ * CONSTANTS
+ *============================================================================*/
+
+#define SIM_NONE                (0xFFFFFFFFU)
+#define SIM_NEVER               (UINT64_MAX)
+#define SIM_STACK_WORDS         (64U)       /* Never run, only validated */
+
+/*==============================================================================
+ * TYPES
+ *============================================================================*/
+
+typedef struct {
+    uint64_t release;
+    uint64_t deadline;
+    uint32_t remaining;
+} sim_job_t;
+
+typedef struct {
+    sim_job_t jobs[DSRTOS_SIM_MAX_PENDING];
+    uint32_t head;
+    uint32_t count;
+    uint64_t wake;                  /* While blocked */
+    uint64_t slice_left;            /* Of a preempted slice; 0 starts a new one */
+    bool blocked;
+    bool queued;
+} sim_task_t;
+
+/*==============================================================================
+ * STATIC VARIABLES
+ *============================================================================*/
+
+static dsrtos_scheduler_interface_t g_interface;
+static dsrtos_ready_queue_t *g_queue;
+static dsrtos_tcb_t g_tcbs[DSRTOS_SIM_MAX_TASKS];
+static uint32_t g_stack[SIM_STACK_WORDS] __attribute__((aligned(8)));
+static sim_task_t g_tasks[DSRTOS_SIM_MAX_TASKS];
+
+/* State of the run in progress */
+static const dsrtos_sim_config_t *g_config;
+static dsrtos_sim_result_t *g_result;
+static uint64_t g_now;
+static uint64_t g_next_wake;
+static uint64_t g_slice_end;        /* SIM_NEVER when the running task is not sliced */
+static uint32_t g_current;          /* Running task, SIM_NONE when idle */
+static bool g_need_decision;
+static bool g_new_slice;
+static dsrtos_error_t g_error;
+
+/*==============================================================================
+ * HELPERS
+ *============================================================================*/
+
+static void sim_overhead(uint32_t cost)
+{
+    g_now += cost;
+    g_result->overhead_time += cost;
+}
+
+static void sim_check(dsrtos_error_t err)
+{
+    if ((err != DSRTOS_SUCCESS) && (g_error == DSRTOS_SUCCESS)) {
+        g_error = err;
+    }
+}
+
+/* Ready queue membership follows pending work and blocking */
+static void sim_sync(uint32_t index)
+{
+    sim_task_t *task = &g_tasks[index];
+    bool ready = (task->count > 0U) && !task->blocked;
+    uint32_t start;
+
+    if (ready == task->queued) {
+        return;
+    }
+
+    start = dsrtos_port_get_cycle_count();
+    if (ready) {
+        sim_check(g_config->ops->enqueue_task(g_queue, &g_tcbs[index]));
+    } else {
+        sim_check(g_config->ops->dequeue_task(g_queue, &g_tcbs[index]));
+    }
+    g_result->sched_cycles += dsrtos_port_get_cycle_count() - start;
+
+    task->queued = ready;
+    if (!ready) {
+        /* Back from a block or with a new job, a task starts a new slice */
+        task->slice_left = 0U;
+        if (index == g_current) {
+            g_current = SIM_NONE;
+            g_slice_end = SIM_NEVER;
+        }
+    }
+    g_need_decision = true;
+}
+
+static void sim_release(uint32_t index, uint32_t demand)
+{
+    sim_task_t *task = &g_tasks[index];
+    const dsrtos_sim_task_t *model = &g_config->tasks[index];
+    dsrtos_sim_task_result_t *stats = &g_result->task[index];
+    uint32_t deadline = (model->deadline != 0U) ? model->deadline : model->period;
+    sim_job_t *job;
+
+    if (task->count == DSRTOS_SIM_MAX_PENDING) {
+        stats->dropped++;
+        return;
+    }
+
+    job = &task->jobs[(task->head + task->count) % DSRTOS_SIM_MAX_PENDING];
+    job->release = g_now;
+    job->deadline = (deadline != 0U) ? (g_now + deadline) : SIM_NEVER;
+    job->remaining = demand;
+    task->count++;
+
+    stats->released++;
+    stats->demand += demand;
+    sim_sync(index);
+}
+
+static void sim_complete(uint32_t index)
+{
+    sim_task_t *task = &g_tasks[index];
+    const sim_job_t *job = &task->jobs[task->head];
+    dsrtos_sim_task_result_t *stats = &g_result->task[index];
+    uint64_t response = g_now - job->release;
+
+    stats->completed++;
+    stats->response_total += response;
+    if (response > stats->response_max) {
+        stats->response_max = (uint32_t)response;
+    }
+    if (g_now > job->deadline) {
+        stats->deadline_misses++;
+        g_result->deadline_misses++;
+    }
+    g_result->jobs_completed++;
+    g_result->response_total += response;
+    g_result->events++;
+
+    task->head = (task->head + 1U) % DSRTOS_SIM_MAX_PENDING;
+    task->count--;
+    sim_sync(index);
+}
+
+static void sim_wake_due(void)
+{
+    uint64_t next = SIM_NEVER;
+
+    for (uint32_t i = 0U; i < g_config->task_count; i++) {
+        sim_task_t *task = &g_tasks[i];
+
+        if (!task->blocked) {
+            continue;
+        }
+        if (task->wake <= g_now) {
+            task->blocked = false;
+            g_result->events++;
+            sim_sync(i);
+        } else if (task->wake < next) {
+            next = task->wake;
+        }
+    }
+    g_next_wake = next;
+}
+
+static void sim_apply(const dsrtos_sim_event_t *event)
+{
+    uint32_t index = event->task;
+    sim_task_t *task;
+
+    if (index >= g_config->task_count) {
+        sim_check(DSRTOS_ERROR_INVALID_PARAM);
+        return;
+    }
+    task = &g_tasks[index];
+    g_result->events++;
+
+    switch (event->type) {
+    case DSRTOS_SIM_RELEASE:
+        sim_release(index, (event->value != 0U) ? event->value : g_config->tasks[index].demand);
+        break;
+
+    case DSRTOS_SIM_BLOCK:
+        if (!task->blocked) {
+            task->blocked = true;
+            task->wake = g_now + event->value;
+            if (task->wake < g_next_wake) {
+                g_next_wake = task->wake;
+            }
+            sim_sync(index);
+        }
+        break;
+
+    case DSRTOS_SIM_IPC:
+        /* The message ends the receiver's wait early */
+        if (task->blocked) {
+            task->wake = g_now;
+            sim_wake_due();
+        }
+        if (event->value != 0U) {
+            sim_release(index, event->value);
+        }
+        break;
+
+    default:
+        sim_check(DSRTOS_ERROR_INVALID_PARAM);
+        break;
+    }
+}
+
+/* Let the running task, or idle, have the time up to the next event */
+static void sim_advance(uint64_t to)
+{
+    uint64_t delta = to - g_now;
+
+    if (g_current != SIM_NONE) {
+        sim_task_t *task = &g_tasks[g_current];
+
+        task->jobs[task->head].remaining -= (uint32_t)delta;
+        g_result->task[g_current].service += delta;
+        g_result->busy_time += delta;
+    } else {
+        g_result->idle_time += delta;
+    }
+    g_now = to;
+}
+
+static void sim_expire(void)
+{
+    const dsrtos_scheduler_ops_t *ops = g_config->ops;
+    dsrtos_tcb_t *tcb = &g_tcbs[g_current];
+    uint32_t start = dsrtos_port_get_cycle_count();
+
+    /* Behind its equals; a plugin without requeue gets remove and insert */
+    if (ops->requeue_task != NULL) {
+        sim_check(ops->requeue_task(g_queue, tcb));
+    } else {
+        sim_check(ops->dequeue_task(g_queue, tcb));
+        sim_check(ops->enqueue_task(g_queue, tcb));
+    }
+    g_result->sched_cycles += dsrtos_port_get_cycle_count() - start;
+
+    g_result->slice_expiries++;
+    g_result->events++;
+    g_need_decision = true;
+    g_new_slice = true;
+}
+
+static void sim_decide(void)
+{
+    const dsrtos_scheduler_ops_t *ops = g_config->ops;
+    uint64_t stopped = g_now;
+    bool dispatch = g_new_slice;
+    dsrtos_tcb_t *next;
+    uint32_t index;
+    uint32_t start;
+
+    start = dsrtos_port_get_cycle_count();
+    next = ops->select_next_task(g_queue);
+    g_result->sched_cycles += dsrtos_port_get_cycle_count() - start;
+    g_result->decisions++;
+    sim_overhead(g_config->cost.decision);
+
+    index = (next != NULL) ? (uint32_t)(next - g_tcbs) : SIM_NONE;
+    if ((next != NULL) && (index >= g_config->task_count)) {
+        sim_check(DSRTOS_ERROR_CORRUPTION);
+        return;
+    }
+
+    if (index != g_current) {
+        /* Still queued means it was runnable: a preemption, with the
+         * cache refill that comes with it. The rest of its slice waits
+         * for its next dispatch, as a tick-counted slice does. */
+        if ((g_current != SIM_NONE) && g_tasks[g_current].queued) {
+            if (g_slice_end != SIM_NEVER) {
+                g_tasks[g_current].slice_left = g_slice_end - stopped;
+            }
+            g_result->preemptions++;
+            sim_overhead(g_config->cost.preemption);
+        }
+        if (index != SIM_NONE) {
+            g_result->switches++;
+            g_result->task[index].dispatches++;
+            sim_overhead(g_config->cost.context_switch);
+        }
+        g_current = index;
+        dispatch = true;
+    }
+
+    if (dispatch) {
+        g_slice_end = SIM_NEVER;
+        if (g_current != SIM_NONE) {
+            sim_task_t *task = &g_tasks[g_current];
+
+            if (!g_new_slice && (task->slice_left != 0U)) {
+                g_slice_end = g_now + task->slice_left;
+            } else if (ops->update_time_slice != NULL) {
+                start = dsrtos_port_get_cycle_count();
+                ops->update_time_slice(next);
+                g_result->sched_cycles += dsrtos_port_get_cycle_count() - start;
+                if (next->time_slice_remaining != 0U) {
+                    g_slice_end = g_now + ((uint64_t)next->time_slice_remaining *
+                                           g_config->slice_unit);
+                }
+            }
+            task->slice_left = 0U;
+        }
+        g_new_slice = false;
+    }
+    g_need_decision = false;
+}
+
+static void sim_finish(void)
+{
+    double sum = 0.0;
+    double squares = 0.0;
+    uint32_t n = 0U;
+
+    /* Jain's index over the share of its demand each task received */
+    for (uint32_t i = 0U; i < g_config->task_count; i++) {
+        const dsrtos_sim_task_result_t *stats = &g_result->task[i];
+        double share;
+
+        if (stats->demand == 0U) {
+            continue;
+        }
+        share = (double)stats->service / (double)stats->demand;
+        sum += share;
+        squares += share * share;
+        n++;
+    }
+    g_result->fairness_ppm = (squares > 0.0) ?
+        (uint32_t)(((sum * sum) / ((double)n * squares)) * 1000000.0) : 1000000U;
+    g_result->end_time = g_now;
+}
+
+static int compare_events(const void *a, const void *b)
+{
+    const dsrtos_sim_event_t *x = (const dsrtos_sim_event_t *)a;
+    const dsrtos_sim_event_t *y = (const dsrtos_sim_event_t *)b;
+
+    if (x->time != y->time) {
+        return (x->time > y->time) ? 1 : -1;
+    }
+    return (int)x->task - (int)y->task;
+}
+
+/*==============================================================================
+ * API
+ *============================================================================*/
+
+uint32_t dsrtos_sim_model(const dsrtos_sim_task_t *tasks, uint32_t task_count,
+                          uint64_t horizon, dsrtos_sim_event_t *events, uint32_t max)
+{
+    uint32_t count = 0U;
+
+    if ((tasks == NULL) || (events == NULL)) {
+        return 0U;
+    }
+
+    for (uint32_t i = 0U; i < task_count; i++) {
+        if (tasks[i].period == 0U) {
+            continue;
+        }
+        for (uint64_t t = tasks[i].offset; t < horizon; t += tasks[i].period) {
+            if (count == max) {
+                return 0U;
+            }
+            events[count].time = t;
+            events[count].type = DSRTOS_SIM_RELEASE;
+            events[count].task = (uint16_t)i;
+            events[count].value = tasks[i].demand;
+            count++;
+        }
+    }
+
+    /* Ties go to the lower task index, so a run is reproducible */
+    qsort(events, count, sizeof(events[0]), compare_events);
+    return count;
+}
+
+uint32_t dsrtos_sim_parse(const char *text, uint32_t task_count,
+                          dsrtos_sim_event_t *events, uint32_t max)
+{
+    static const char types[] = "RBI";
+    const char *line = text;
+    uint32_t count = 0U;
+    uint64_t last = 0U;
+
+    if ((text == NULL) || (events == NULL)) {
+        return 0U;
+    }
+
+    while (*line != '\0') {
+        const char *end = strchr(line, '\n');
+        const char *next = (end != NULL) ? (end + 1) : (line + strlen(line));
+        size_t length = (size_t)(next - line);
+        const char *hash = memchr(line, '#', length);
+        unsigned long long time;
+        unsigned int task;
+        unsigned int value;
+        char type = '\0';
+        char tail;
+        char buf[128];
+        int fields;
+
+        if (hash != NULL) {
+            length = (size_t)(hash - line);
+        }
+        if (length >= sizeof(buf)) {
+            return 0U;
+        }
+        (void)memcpy(buf, line, length);
+        buf[length] = '\0';
+
+        /* Blank and comment-only lines match nothing */
+        fields = sscanf(buf, "%llu %c %u %u %c", &time, &type, &task, &value, &tail);
+        if (fields > 0) {
+            const char *kind = (type != '\0') ? strchr(types, type) : NULL;
+
+            if ((fields != 4) || (kind == NULL) || (task >= task_count) ||
+                (time < last) || (count == max)) {
+                return 0U;
+            }
+            events[count].time = time;
+            events[count].type = (uint16_t)(kind - types);
+            events[count].task = (uint16_t)task;
+            events[count].value = value;
+            last = time;
+            count++;
+        }
+        line = next;
+    }
+
+    return count;
+}
+
+dsrtos_error_t dsrtos_sim_run(const dsrtos_sim_config_t *config, dsrtos_sim_result_t *result)
+{
+    const dsrtos_sim_event_t *events;
+    uint64_t wall_start;
+    uint32_t next_event = 0U;
+    dsrtos_error_t err;
+
+    if ((config == NULL) || (result == NULL) || (config->ops == NULL) ||
+        (config->tasks == NULL) || (config->task_count == 0U) ||
+        (config->task_count > DSRTOS_SIM_MAX_TASKS) ||
+        ((config->event_count != 0U) && (config->events == NULL))) {
+        return DSRTOS_ERROR_INVALID_PARAM;
+    }
+    for (uint32_t i = 0U; i < config->task_count; i++) {
+        if (config->tasks[i].priority >= DSRTOS_PRIORITY_LEVELS) {
+            return DSRTOS_ERROR_INVALID_PARAM;
+        }
+    }
+
+    err = dsrtos_scheduler_interface_init(&g_interface, config->ops);
+    if (err != DSRTOS_SUCCESS) {
+        return err;
+    }
+    g_queue = g_interface.ready_queue;
+
+    (void)memset(result, 0, sizeof(*result));
+    (void)memset(g_tasks, 0, sizeof(g_tasks));
+    for (uint32_t i = 0U; i < config->task_count; i++) {
+        dsrtos_tcb_t *tcb = &g_tcbs[i];
+
+        (void)memset(tcb, 0, sizeof(*tcb));
+        tcb->task_id = i + 1U;
+        tcb->magic_number = DSRTOS_TCB_MAGIC;
+        tcb->state = DSRTOS_TASK_STATE_READY;
+        tcb->static_priority = config->tasks[i].priority;
+        tcb->effective_priority = config->tasks[i].priority;
+        tcb->stack_base = g_stack;
+        tcb->stack_size = (uint32_t)sizeof(g_stack);
+    }
+
+    g_config = config;
+    g_result = result;
+    g_now = 0U;
+    g_next_wake = SIM_NEVER;
+    g_slice_end = SIM_NEVER;
+    g_current = SIM_NONE;
+    g_need_decision = false;
+    g_new_slice = false;
+    g_error = DSRTOS_SUCCESS;
+    events = config->events;
+
+    wall_start = dsrtos_host_time_ns();
+    while (g_error == DSRTOS_SUCCESS) {
+        uint64_t next = SIM_NEVER;
+
+        if (next_event < config->event_count) {
+            next = events[next_event].time;
+        }
+        if (g_next_wake < next) {
+            next = g_next_wake;
+        }
+        if (g_current != SIM_NONE) {
+            const sim_task_t *task = &g_tasks[g_current];
+            uint64_t done = g_now + task->jobs[task->head].remaining;
+
+            if (done < next) {
+                next = done;
+            }
+            if (g_slice_end < next) {
+                next = g_slice_end;
+            }
+        }
+
+        /* Drained: idle out to the horizon, if there is one */
+        if ((next == SIM_NEVER) && (config->horizon == 0U)) {
+            break;
+        }
+        /* Anything that fell due during switch overhead is handled late */
+        if (next < g_now) {
+            next = g_now;
+        }
+        if ((config->horizon != 0U) && (next > config->horizon)) {
+            sim_advance((g_now < config->horizon) ? config->horizon : g_now);
+            break;
+        }
+        sim_advance(next);
+
+        if ((g_current != SIM_NONE) && (g_tasks[g_current].jobs[g_tasks[g_current].head].remaining == 0U)) {
+            sim_complete(g_current);
+        }
+        if ((g_current != SIM_NONE) && (g_now >= g_slice_end)) {
+            sim_expire();
+        }
+        if (g_now >= g_next_wake) {
+            sim_wake_due();
+        }
+        while ((next_event < config->event_count) && (events[next_event].time <= g_now)) {
+            sim_apply(&events[next_event]);
+            next_event++;
+        }
+
+        if (g_need_decision && (g_error == DSRTOS_SUCCESS)) {
+            sim_decide();
+        }
+    }
+    result->wall_ns = dsrtos_host_time_ns() - wall_start;
+
+    sim_finish();
+    return g_error;
+}
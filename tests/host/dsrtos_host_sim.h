@@ -0,0 +1,138 @@
+/*
+ * @file dsrtos_host_sim.h
+ * @brief Trace-driven scheduler simulator for the host port
+ * @date 2024-12-30
+ *
+ * Replays a workload through a scheduler plugin's real phase 4 ops table
+ * (dsrtos_scheduler_ops_t) in virtual time, so plugins and their
+ * parameters can be compared offline on identical input. The workload is
+ * a list of timed events: job releases with an execution demand, blocks
+ * for a duration, and IPC messages that wake their receiver and add work.
+ * It comes from a periodic task model or from a recorded text trace.
+ *
+ * The plugin decides everything it would decide on target: which task
+ * runs (select_next_task), queue order (enqueue, dequeue, requeue) and the
+ * slice length (update_time_slice, read back from time_slice_remaining).
+ * The simulator only advances time, charges the context-switch cost model
+ * and measures the outcome. Virtual time has no unit of its own; the cost
+ * model, the trace and slice_unit just have to agree.
+ */
+
+#ifndef DSRTOS_HOST_SIM_H
+#define DSRTOS_HOST_SIM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "dsrtos_types.h"
+#include "dsrtos_error.h"
+#include "dsrtos_task_scheduler_interface.h"
+
+/*==============================================================================
+ * CONSTANTS
+ *============================================================================*/
+
+#define DSRTOS_SIM_MAX_TASKS        (64U)
+#define DSRTOS_SIM_MAX_PENDING      (8U)    /* Jobs queued per task before drops */
+
+/* Trace event types */
+#define DSRTOS_SIM_RELEASE          (0U)    /* Job of task arrives, value = demand */
+#define DSRTOS_SIM_BLOCK            (1U)    /* Task blocks for value time */
+#define DSRTOS_SIM_IPC              (2U)    /* Message to task, value = handling demand */
+
+/*==============================================================================
+ * TYPES
+ *============================================================================*/
+
+typedef struct {
+    uint64_t time;
+    uint16_t type;                  /* DSRTOS_SIM_* */
+    uint16_t task;                  /* Index into the task table */
+    uint32_t value;
+} dsrtos_sim_event_t;
+
+typedef struct {
+    const char *name;
+    uint8_t priority;
+    uint32_t period;                /* 0: releases come from the trace only */
+    uint32_t offset;                /* First release */
+    uint32_t demand;                /* Execution per job */
+    uint32_t deadline;              /* Relative; 0 means the period */
+} dsrtos_sim_task_t;
+
+/* Charged in virtual time, during which no task makes progress */
+typedef struct {
+    uint32_t decision;              /* Every select_next_task */
+    uint32_t context_switch;        /* Dispatching a different task */
+    uint32_t preemption;            /* Extra when the switched-out task had work left */
+} dsrtos_sim_cost_t;
+
+typedef struct {
+    const dsrtos_scheduler_ops_t *ops;  /* Plugin under test */
+    const dsrtos_sim_task_t *tasks;
+    uint32_t task_count;
+    const dsrtos_sim_event_t *events;   /* Sorted by time */
+    uint32_t event_count;
+    dsrtos_sim_cost_t cost;
+    uint32_t slice_unit;            /* Virtual time per time-slice tick */
+    uint64_t horizon;               /* Stop here; 0 runs until the trace drains */
+} dsrtos_sim_config_t;
+
+typedef struct {
+    uint32_t released;
+    uint32_t completed;
+    uint32_t dropped;               /* Released with DSRTOS_SIM_MAX_PENDING queued */
+    uint32_t deadline_misses;
+    uint32_t dispatches;
+    uint32_t response_max;
+    uint64_t response_total;
+    uint64_t demand;                /* Released execution */
+    uint64_t service;               /* Execution received */
+} dsrtos_sim_task_result_t;
+
+typedef struct {
+    dsrtos_sim_task_result_t task[DSRTOS_SIM_MAX_TASKS];
+    uint64_t end_time;
+    uint64_t busy_time;             /* Tasks executing */
+    uint64_t overhead_time;         /* Decision and switch cost */
+    uint64_t idle_time;
+    uint64_t events;                /* Releases, blocks, IPCs, wakes, completions, expiries */
+    uint32_t decisions;
+    uint32_t switches;
+    uint32_t preemptions;
+    uint32_t slice_expiries;
+    uint32_t deadline_misses;
+    uint32_t jobs_completed;
+    uint64_t response_total;
+    uint64_t sched_cycles;          /* Host cycles inside the plugin's ops */
+    uint32_t fairness_ppm;          /* Jain's index of service/demand, parts per million */
+    uint64_t wall_ns;               /* Host time for the whole run */
+} dsrtos_sim_result_t;
+
+/*==============================================================================
+ * API
+ *============================================================================*/
+
+/* Periodic releases of every task with a period, in time order. Returns the
+ * event count, or 0 if max is too small. */
+uint32_t dsrtos_sim_model(const dsrtos_sim_task_t *tasks, uint32_t task_count,
+                          uint64_t horizon, dsrtos_sim_event_t *events, uint32_t max);
+
+/* Parse a recorded trace, one "<time> <R|B|I> <task> <value>" per line;
+ * '#' starts a comment. Returns the event count, or 0 on a malformed line,
+ * a task index past task_count, time going backwards or overflow. */
+uint32_t dsrtos_sim_parse(const char *text, uint32_t task_count,
+                          dsrtos_sim_event_t *events, uint32_t max);
+
+/* Run the workload through config->ops. The ready queue is reinitialised
+ * for every run. */
+dsrtos_error_t dsrtos_sim_run(const dsrtos_sim_config_t *config, dsrtos_sim_result_t *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DSRTOS_HOST_SIM_H */